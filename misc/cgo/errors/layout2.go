@@ -0,0 +1,25 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+/*
+#cgo layout: point=struct_point
+
+struct point {
+	int x;
+	int y;
+};
+*/
+import "C"
+
+type point struct {
+	X int32
+	Y *int32 // ERROR HERE
+}
+
+func main() {
+	var p C.struct_point
+	_ = p
+}
@@ -235,6 +235,31 @@ var ptrTests = []ptrTest{
 		fail:      true,
 		expensive: true,
 	},
+	{
+		// A Go pointer after a long run of words with no
+		// pointers, which the check skips in bulk.
+		name: "barrier-struct-last",
+		c: `#include <stdlib.h>
+                    struct s { char *a[100]; long x[100]; char *b; };
+                    struct s *f1() { return malloc(sizeof(struct s)); }
+                    void f2(struct s *p) {}`,
+		body:      `p := C.f1(); *p = C.struct_s{b: new(C.char)}; C.f2(p)`,
+		fail:      true,
+		expensive: true,
+	},
+	{
+		// The same for a GC program, with a source on the heap.
+		name: "barrier-gcprog-array-heap-last",
+		c: `#include <stdlib.h>
+                    struct s { char *a[32769]; };
+                    struct s *f1() { return malloc(sizeof(struct s)); }
+                    void f2(struct s *p) {}
+                    void f3(void *p) {}`,
+		imports:   []string{"unsafe"},
+		body:      `p := C.f1(); n := &[32769]*C.char{}; n[32768] = new(C.char); p.a = *n; C.f2(p); n[32768] = nil; C.f3(unsafe.Pointer(n))`,
+		fail:      true,
+		expensive: true,
+	},
 	{
 		// Exported functions may not return Go pointers.
 		name: "export1",
@@ -314,6 +339,35 @@ var ptrTests = []ptrTest{
 		body:    `i := 0; p := S{u:uintptr(unsafe.Pointer(&i))}; q := (*S)(C.malloc(C.size_t(unsafe.Sizeof(p)))); *q = p; C.f(unsafe.Pointer(q))`,
 		fail:    false,
 	},
+	{
+		// Passing a pointer to a struct that contains a
+		// pointer to a pinned Go object is OK.
+		name:    "pinned",
+		c:       `typedef struct s { int *p; } s; void f(s *ps) {}`,
+		imports: []string{"runtime"},
+		body:    `var pin runtime.Pinner; p := new(C.int); pin.Pin(p); C.f(&C.s{p}); pin.Unpin()`,
+		fail:    false,
+	},
+	{
+		// Once unpinned, the Go pointer is checked again.
+		name:    "unpinned",
+		c:       `typedef struct s { int *p; } s; void f(s *ps) {}`,
+		imports: []string{"runtime"},
+		body:    `var pin runtime.Pinner; p := new(C.int); pin.Pin(p); pin.Unpin(); C.f(&C.s{p})`,
+		fail:    true,
+	},
+	{
+		// Storing a pointer to a pinned Go object into C
+		// memory is OK.
+		name: "barrier-pinned",
+		c: `#include <stdlib.h>
+                    char **f1() { return malloc(sizeof(char*)); }
+                    void f2(char **p) {}`,
+		imports:   []string{"runtime"},
+		body:      `p := C.f1(); var pin runtime.Pinner; q := new(C.char); pin.Pin(q); *p = q; C.f2(p); *p = nil; pin.Unpin()`,
+		fail:      false,
+		expensive: true,
+	},
 }
 
 func main() {
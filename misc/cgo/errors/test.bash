@@ -43,6 +43,8 @@ check issue11097a.go
 check issue11097b.go
 expect issue13129.go C.ushort
 check issue13423.go
+expect layout1.go layout1.go:17 overflows
+check layout2.go
 expect issue13635.go C.uchar C.schar C.ushort C.uint C.ulong C.longlong C.ulonglong C.complexfloat C.complexdouble
 
 if ! go run ptr.go; then
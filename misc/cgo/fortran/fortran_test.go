@@ -11,3 +11,68 @@ func TestFortran(t *testing.T) {
 		t.Errorf("Unexpected result for The Answer. Got: %d Want: 42", a)
 	}
 }
+
+func testMatrix(m, n int) *Matrix {
+	a := NewMatrix(m, n)
+	for j := 0; j < n; j++ {
+		for i := 0; i < m; i++ {
+			a.Set(i, j, float64(i*100+j))
+		}
+	}
+	return a
+}
+
+func TestMatrixLayout(t *testing.T) {
+	a := testMatrix(3, 5)
+	for j := 0; j < a.N; j++ {
+		for i := 0; i < a.M; i++ {
+			if x := at(a, i, j); x != a.At(i, j) {
+				t.Errorf("Fortran a(%d, %d) = %v, want %v", i+1, j+1, x, a.At(i, j))
+			}
+		}
+	}
+}
+
+func TestScale(t *testing.T) {
+	a := testMatrix(3, 5)
+	b := testMatrix(3, 5)
+	Scale(a, 2)
+	scaleCopy(b, 2)
+	for j := 0; j < a.N; j++ {
+		for i := 0; i < a.M; i++ {
+			want := 2 * float64(i*100+j)
+			if a.At(i, j) != want || b.At(i, j) != want {
+				t.Errorf("element (%d, %d) scaled to %v and, with copying, %v; want %v", i, j, a.At(i, j), b.At(i, j), want)
+			}
+		}
+	}
+}
+
+func TestSum(t *testing.T) {
+	a := testMatrix(3, 5)
+	want := 0.0
+	for _, x := range a.Data {
+		want += x
+	}
+	if s := Sum(a); s != want {
+		t.Errorf("Sum = %v, want %v", s, want)
+	}
+}
+
+const benchDim = 1000
+
+func BenchmarkScale(b *testing.B) {
+	a := testMatrix(benchDim, benchDim)
+	b.SetBytes(int64(len(a.Data) * 8))
+	for i := 0; i < b.N; i++ {
+		Scale(a, 1)
+	}
+}
+
+func BenchmarkScaleCopy(b *testing.B) {
+	a := testMatrix(benchDim, benchDim)
+	b.SetBytes(int64(len(a.Data) * 8))
+	for i := 0; i < b.N; i++ {
+		scaleCopy(a, 1)
+	}
+}
@@ -0,0 +1,31 @@
+! Copyright 2016 The Go Authors. All rights reserved.
+! Use of this source code is governed by a BSD-style
+! license that can be found in the LICENSE file.
+
+! Kernels on arrays that Go passes without copying.
+
+! An explicit-shape array: the caller passes the data and the bounds.
+subroutine scale_grid(m, n, a, s) bind(C)
+  use iso_c_binding, only: c_int, c_double
+  integer(c_int), value :: m, n
+  real(c_double), intent(inout) :: a(m, n)
+  real(c_double), value :: s
+  a = a * s
+end subroutine scale_grid
+
+function grid_at(m, n, a, i, j) result(x) bind(C)
+  use iso_c_binding, only: c_int, c_double
+  integer(c_int), value :: m, n, i, j
+  real(c_double), intent(in) :: a(m, n)
+  real(c_double) :: x
+  x = a(i, j)
+end function grid_at
+
+! An assumed-shape array: the caller passes a descriptor of the array,
+! built with ISO_Fortran_binding.h.
+function sum_grid(a) result(s) bind(C)
+  use iso_c_binding, only: c_double
+  real(c_double), intent(in) :: a(:, :)
+  real(c_double) :: s
+  s = sum(a)
+end function sum_grid
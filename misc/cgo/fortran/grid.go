@@ -0,0 +1,106 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package fortran
+
+/*
+#include <stdlib.h>
+#include <ISO_Fortran_binding.h>
+
+void scale_grid(int m, int n, double *a, double s);
+double grid_at(int m, int n, double *a, int i, int j);
+double sum_grid(CFI_cdesc_t *a);
+
+// sum_grid_c passes the m by n array at a to sum_grid as an
+// assumed-shape array. The descriptor lives only for the call.
+static double sum_grid_c(int m, int n, double *a) {
+	CFI_CDESC_T(2) d;
+	CFI_index_t extent[2];
+
+	extent[0] = m;
+	extent[1] = n;
+	if (CFI_establish((CFI_cdesc_t*)&d, a, CFI_attribute_other, CFI_type_double, sizeof(double), 2, extent) != CFI_SUCCESS) {
+		abort();
+	}
+	return sum_grid((CFI_cdesc_t*)&d);
+}
+*/
+import "C"
+
+import "unsafe"
+
+// A Matrix is an M by N matrix of float64s, stored in column-major
+// order as Fortran stores arrays: element (i, j), counting from 0, is
+// Data[i+j*M]. Fortran kernels work on Data in place. It holds no Go
+// pointers, so cgo lets it be passed to Fortran without a copy in C
+// memory.
+type Matrix struct {
+	M, N int
+	Data []float64
+}
+
+// NewMatrix returns a zeroed m by n Matrix.
+func NewMatrix(m, n int) *Matrix {
+	return &Matrix{M: m, N: n, Data: make([]float64, m*n)}
+}
+
+// At returns element (i, j) of a.
+func (a *Matrix) At(i, j int) float64 {
+	return a.Data[i+j*a.M]
+}
+
+// Set sets element (i, j) of a to x.
+func (a *Matrix) Set(i, j int, x float64) {
+	a.Data[i+j*a.M] = x
+}
+
+// Column returns column j of a, which is contiguous in Data.
+func (a *Matrix) Column(j int) []float64 {
+	return a.Data[j*a.M : (j+1)*a.M]
+}
+
+func (a *Matrix) ptr() *C.double {
+	if len(a.Data) == 0 {
+		return nil
+	}
+	return (*C.double)(unsafe.Pointer(&a.Data[0]))
+}
+
+// Scale multiplies a by s, passing a to Fortran as an explicit-shape
+// array.
+func Scale(a *Matrix, s float64) {
+	if len(a.Data) == 0 {
+		return
+	}
+	C.scale_grid(C.int(a.M), C.int(a.N), a.ptr(), C.double(s))
+}
+
+// Sum returns the sum of the elements of a, passing a to Fortran as
+// an assumed-shape array.
+func Sum(a *Matrix) float64 {
+	if len(a.Data) == 0 {
+		return 0
+	}
+	return float64(C.sum_grid_c(C.int(a.M), C.int(a.N), a.ptr()))
+}
+
+// at returns element (i, j) of a as Fortran sees it.
+func at(a *Matrix, i, j int) float64 {
+	return float64(C.grid_at(C.int(a.M), C.int(a.N), a.ptr(), C.int(i+1), C.int(j+1)))
+}
+
+// scaleCopy is Scale done by copying a to C memory and back, for
+// comparison.
+func scaleCopy(a *Matrix, s float64) {
+	if len(a.Data) == 0 {
+		return
+	}
+	size := C.size_t(len(a.Data)) * C.size_t(unsafe.Sizeof(a.Data[0]))
+	p := (*C.double)(C.malloc(size))
+	c := (*[1 << 30]float64)(unsafe.Pointer(p))[:len(a.Data):len(a.Data)]
+	copy(c, a.Data)
+	C.scale_grid(C.int(a.M), C.int(a.N), p, C.double(s))
+	copy(a.Data, c)
+	C.free(unsafe.Pointer(p))
+}
@@ -29,6 +29,13 @@ if ! $FC helloworld/helloworld.f90 -o main.exe >& /dev/null; then
 fi
 rm -f main.exe
 
+# Passing assumed-shape arrays from C needs ISO_Fortran_binding.h,
+# which GCC has had since version 9.
+if ! echo '#include <ISO_Fortran_binding.h>' | $(go env CC) -E - >& /dev/null; then
+  echo "skipping Fortran test: no ISO_Fortran_binding.h"
+  exit 0
+fi
+
 status=0
 
 if ! go test; then
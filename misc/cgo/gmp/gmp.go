@@ -116,6 +116,7 @@ import "C"
 
 import (
 	"os"
+	"sync"
 	"unsafe"
 )
 
@@ -130,6 +131,18 @@ type Int struct {
 	init bool
 }
 
+// pool holds initialized mpz values, and the memory gmp has allocated
+// for their digits, for reuse by Ints that need initializing. An mpz
+// value holds no pointer to itself, so it can be copied in and out.
+var pool struct {
+	sync.Mutex
+	free []C.__mpz_struct
+}
+
+// maxPool is the number of values that pool keeps. Free clears the
+// values that do not fit.
+const maxPool = 64
+
 // NewInt returns a new Int initialized to x.
 func NewInt(x int64) *Int { return new(Int).SetInt64(x) }
 
@@ -144,27 +157,43 @@ func (z *Int) doinit() {
 		return
 	}
 	z.init = true
-	C.mpz_init(&z.i[0])
+	pool.Lock()
+	if n := len(pool.free); n > 0 {
+		z.i[0] = pool.free[n-1]
+		pool.free = pool.free[:n-1]
+		pool.Unlock()
+		z.i[0]._mp_size = 0 // the value 0
+		return
+	}
+	pool.Unlock()
+	C.mpz_init(z.ptr())
+}
+
+// ptr returns a pointer to z's mpz value, to pass to C. Passing
+// &z.i[0] directly would make cgo check the whole of z.i, which it
+// copies to the heap to do so.
+func (z *Int) ptr() C.mpz_ptr {
+	return &z.i[0]
 }
 
 // Bytes returns z's representation as a big-endian byte array.
 func (z *Int) Bytes() []byte {
 	b := make([]byte, (z.Len()+7)/8)
 	n := C.size_t(len(b))
-	C.mpz_export(unsafe.Pointer(&b[0]), &n, 1, 1, 1, 0, &z.i[0])
+	C.mpz_export(unsafe.Pointer(&b[0]), &n, 1, 1, 1, 0, z.ptr())
 	return b[0:n]
 }
 
 // Len returns the length of z in bits.  0 is considered to have length 1.
 func (z *Int) Len() int {
 	z.doinit()
-	return int(C.mpz_sizeinbase(&z.i[0], 2))
+	return int(C.mpz_sizeinbase(z.ptr(), 2))
 }
 
 // Set sets z = x and returns z.
 func (z *Int) Set(x *Int) *Int {
 	z.doinit()
-	C.mpz_set(&z.i[0], &x.i[0])
+	C.mpz_set(z.ptr(), x.ptr())
 	return z
 }
 
@@ -175,7 +204,7 @@ func (z *Int) SetBytes(b []byte) *Int {
 	if len(b) == 0 {
 		z.SetInt64(0)
 	} else {
-		C.mpz_import(&z.i[0], C.size_t(len(b)), 1, 1, 1, 0, unsafe.Pointer(&b[0]))
+		C.mpz_import(z.ptr(), C.size_t(len(b)), 1, 1, 1, 0, unsafe.Pointer(&b[0]))
 	}
 	return z
 }
@@ -184,7 +213,7 @@ func (z *Int) SetBytes(b []byte) *Int {
 func (z *Int) SetInt64(x int64) *Int {
 	z.doinit()
 	// TODO(rsc): more work on 32-bit platforms
-	C.mpz_set_si(&z.i[0], C.long(x))
+	C.mpz_set_si(z.ptr(), C.long(x))
 	return z
 }
 
@@ -198,7 +227,7 @@ func (z *Int) SetString(s string, base int) error {
 	}
 	p := C.CString(s)
 	defer C.free(unsafe.Pointer(p))
-	if C.mpz_set_str(&z.i[0], p, C.int(base)) < 0 {
+	if C.mpz_set_str(z.ptr(), p, C.int(base)) < 0 {
 		return os.ErrInvalid
 	}
 	return nil
@@ -210,17 +239,32 @@ func (z *Int) String() string {
 		return "nil"
 	}
 	z.doinit()
-	p := C.mpz_get_str(nil, 10, &z.i[0])
+	p := C.mpz_get_str(nil, 10, z.ptr())
 	s := C.GoString(p)
 	C.free(unsafe.Pointer(p))
 	return s
 }
 
-func (z *Int) destroy() {
-	if z.init {
-		C.mpz_clear(&z.i[0])
+// Free sets z to 0 and releases the memory gmp has allocated for it,
+// keeping it for reuse by other Ints. The garbage collector does not
+// see that memory, so a program that makes many short-lived Ints
+// should Free them rather than leave them to be collected, which
+// leaks it. The Ints of a computation done in place, like z.Add(z, x),
+// need no new memory in the first place.
+func (z *Int) Free() {
+	if !z.init {
+		return
 	}
 	z.init = false
+	pool.Lock()
+	if len(pool.free) < maxPool {
+		pool.free = append(pool.free, z.i[0])
+		pool.Unlock()
+		z.i = C.mpz_t{}
+		return
+	}
+	pool.Unlock()
+	C.mpz_clear(z.ptr())
 }
 
 /*
@@ -232,7 +276,7 @@ func (z *Int) Add(x, y *Int) *Int {
 	x.doinit()
 	y.doinit()
 	z.doinit()
-	C.mpz_add(&z.i[0], &x.i[0], &y.i[0])
+	C.mpz_add(z.ptr(), x.ptr(), y.ptr())
 	return z
 }
 
@@ -241,7 +285,7 @@ func (z *Int) Sub(x, y *Int) *Int {
 	x.doinit()
 	y.doinit()
 	z.doinit()
-	C.mpz_sub(&z.i[0], &x.i[0], &y.i[0])
+	C.mpz_sub(z.ptr(), x.ptr(), y.ptr())
 	return z
 }
 
@@ -250,7 +294,7 @@ func (z *Int) Mul(x, y *Int) *Int {
 	x.doinit()
 	y.doinit()
 	z.doinit()
-	C.mpz_mul(&z.i[0], &x.i[0], &y.i[0])
+	C.mpz_mul(z.ptr(), x.ptr(), y.ptr())
 	return z
 }
 
@@ -259,7 +303,7 @@ func (z *Int) Div(x, y *Int) *Int {
 	x.doinit()
 	y.doinit()
 	z.doinit()
-	C.mpz_tdiv_q(&z.i[0], &x.i[0], &y.i[0])
+	C.mpz_tdiv_q(z.ptr(), x.ptr(), y.ptr())
 	return z
 }
 
@@ -269,7 +313,7 @@ func (z *Int) Mod(x, y *Int) *Int {
 	x.doinit()
 	y.doinit()
 	z.doinit()
-	C.mpz_tdiv_r(&z.i[0], &x.i[0], &y.i[0])
+	C.mpz_tdiv_r(z.ptr(), x.ptr(), y.ptr())
 	return z
 }
 
@@ -277,7 +321,7 @@ func (z *Int) Mod(x, y *Int) *Int {
 func (z *Int) Lsh(x *Int, s uint) *Int {
 	x.doinit()
 	z.doinit()
-	C._mpz_mul_2exp(&z.i[0], &x.i[0], C.ulong(s))
+	C._mpz_mul_2exp(z.ptr(), x.ptr(), C.ulong(s))
 	return z
 }
 
@@ -285,7 +329,7 @@ func (z *Int) Lsh(x *Int, s uint) *Int {
 func (z *Int) Rsh(x *Int, s uint) *Int {
 	x.doinit()
 	z.doinit()
-	C._mpz_div_2exp(&z.i[0], &x.i[0], C.ulong(s))
+	C._mpz_div_2exp(z.ptr(), x.ptr(), C.ulong(s))
 	return z
 }
 
@@ -297,9 +341,9 @@ func (z *Int) Exp(x, y, m *Int) *Int {
 	y.doinit()
 	z.doinit()
 	if m == nil {
-		C.mpz_pow_ui(&z.i[0], &x.i[0], C.mpz_get_ui(&y.i[0]))
+		C.mpz_pow_ui(z.ptr(), x.ptr(), C.mpz_get_ui(y.ptr()))
 	} else {
-		C.mpz_powm(&z.i[0], &x.i[0], &y.i[0], &m.i[0])
+		C.mpz_powm(z.ptr(), x.ptr(), y.ptr(), m.ptr())
 	}
 	return z
 }
@@ -308,14 +352,14 @@ func (z *Int) Int64() int64 {
 	if !z.init {
 		return 0
 	}
-	return int64(C.mpz_get_si(&z.i[0]))
+	return int64(C.mpz_get_si(z.ptr()))
 }
 
 // Neg sets z = -x and returns z.
 func (z *Int) Neg(x *Int) *Int {
 	x.doinit()
 	z.doinit()
-	C.mpz_neg(&z.i[0], &x.i[0])
+	C.mpz_neg(z.ptr(), x.ptr())
 	return z
 }
 
@@ -323,7 +367,7 @@ func (z *Int) Neg(x *Int) *Int {
 func (z *Int) Abs(x *Int) *Int {
 	x.doinit()
 	z.doinit()
-	C.mpz_abs(&z.i[0], &x.i[0])
+	C.mpz_abs(z.ptr(), x.ptr())
 	return z
 }
 
@@ -340,7 +384,7 @@ func (z *Int) Abs(x *Int) *Int {
 func CmpInt(x, y *Int) int {
 	x.doinit()
 	y.doinit()
-	switch cmp := C.mpz_cmp(&x.i[0], &y.i[0]); {
+	switch cmp := C.mpz_cmp(x.ptr(), y.ptr()); {
 	case cmp < 0:
 		return -1
 	case cmp == 0:
@@ -355,7 +399,7 @@ func DivModInt(q, r, x, y *Int) {
 	r.doinit()
 	x.doinit()
 	y.doinit()
-	C.mpz_tdiv_qr(&q.i[0], &r.i[0], &x.i[0], &y.i[0])
+	C.mpz_tdiv_qr(q.ptr(), r.ptr(), x.ptr(), y.ptr())
 }
 
 // GcdInt sets d to the greatest common divisor of a and b,
@@ -368,7 +412,7 @@ func GcdInt(d, x, y, a, b *Int) {
 	y.doinit()
 	a.doinit()
 	b.doinit()
-	C.mpz_gcdext(&d.i[0], &x.i[0], &y.i[0], &a.i[0], &b.i[0])
+	C.mpz_gcdext(d.ptr(), x.ptr(), y.ptr(), a.ptr(), b.ptr())
 }
 
 // ProbablyPrime performs n Miller-Rabin tests to check whether z is prime.
@@ -376,5 +420,5 @@ func GcdInt(d, x, y, a, b *Int) {
 // If it returns false, z is not prime.
 func (z *Int) ProbablyPrime(n int) bool {
 	z.doinit()
-	return int(C.mpz_probab_prime_p(&z.i[0], C.int(n))) > 0
+	return int(C.mpz_probab_prime_p(z.ptr(), C.int(n))) > 0
 }
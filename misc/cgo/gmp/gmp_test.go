@@ -0,0 +1,142 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package gmp_test
+
+import (
+	gmp "."
+	"math/big"
+	"testing"
+)
+
+// piGMP and piBig return the first n digits of pi, computed as in
+// pi.go with gmp and with math/big, in place.
+
+func piGMP(n int) []byte {
+	tmp1, tmp2 := gmp.NewInt(0), gmp.NewInt(0)
+	numer, accum, denom := gmp.NewInt(1), gmp.NewInt(0), gmp.NewInt(1)
+	ten := gmp.NewInt(10)
+	defer func() {
+		for _, x := range []*gmp.Int{tmp1, tmp2, numer, accum, denom, ten} {
+			x.Free()
+		}
+	}()
+
+	digits := make([]byte, 0, n)
+	for k := int64(0); len(digits) < n; {
+		d := int64(-1)
+		for d < 0 {
+			k++
+			y2 := k*2 + 1
+			accum.Add(accum, tmp1.Lsh(numer, 1))
+			accum.Mul(accum, tmp1.SetInt64(y2))
+			numer.Mul(numer, tmp1.SetInt64(k))
+			denom.Mul(denom, tmp1.SetInt64(y2))
+
+			if gmp.CmpInt(numer, accum) > 0 {
+				continue
+			}
+			tmp1.Lsh(numer, 1).Add(tmp1, numer).Add(tmp1, accum)
+			gmp.DivModInt(tmp1, tmp2, tmp1, denom)
+			tmp2.Add(tmp2, numer)
+			if gmp.CmpInt(tmp2, denom) < 0 {
+				d = tmp1.Int64()
+			}
+		}
+		accum.Sub(accum, tmp1.Mul(denom, tmp1.SetInt64(d)))
+		accum.Mul(accum, ten)
+		numer.Mul(numer, ten)
+		digits = append(digits, byte(d)+'0')
+	}
+	return digits
+}
+
+func piBig(n int) []byte {
+	tmp1, tmp2 := big.NewInt(0), big.NewInt(0)
+	numer, accum, denom := big.NewInt(1), big.NewInt(0), big.NewInt(1)
+	ten := big.NewInt(10)
+
+	digits := make([]byte, 0, n)
+	for k := int64(0); len(digits) < n; {
+		d := int64(-1)
+		for d < 0 {
+			k++
+			y2 := k*2 + 1
+			accum.Add(accum, tmp1.Lsh(numer, 1))
+			accum.Mul(accum, tmp1.SetInt64(y2))
+			numer.Mul(numer, tmp1.SetInt64(k))
+			denom.Mul(denom, tmp1.SetInt64(y2))
+
+			if numer.Cmp(accum) > 0 {
+				continue
+			}
+			tmp1.Lsh(numer, 1).Add(tmp1, numer).Add(tmp1, accum)
+			tmp1.QuoRem(tmp1, denom, tmp2)
+			tmp2.Add(tmp2, numer)
+			if tmp2.Cmp(denom) < 0 {
+				d = tmp1.Int64()
+			}
+		}
+		accum.Sub(accum, tmp1.Mul(denom, tmp1.SetInt64(d)))
+		accum.Mul(accum, ten)
+		numer.Mul(numer, ten)
+		digits = append(digits, byte(d)+'0')
+	}
+	return digits
+}
+
+func TestPi(t *testing.T) {
+	const n = 500
+	if g, b := string(piGMP(n)), string(piBig(n)); g != b {
+		t.Errorf("digits of pi differ:\ngmp      %s\nmath/big %s", g, b)
+	}
+}
+
+func TestFree(t *testing.T) {
+	x := gmp.NewInt(1)
+	x.Lsh(x, 1000)
+	x.Free()
+	if x.Int64() != 0 {
+		t.Errorf("after Free, x = %v, want 0", x)
+	}
+	// y may reuse x's value, but must start at 0.
+	y := new(gmp.Int)
+	if y.Len() != 1 || y.String() != "0" {
+		t.Errorf("new Int after Free = %v, want 0", y)
+	}
+	y.Free()
+}
+
+func BenchmarkPiGMP(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		piGMP(1000)
+	}
+}
+
+func BenchmarkPiBig(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		piBig(1000)
+	}
+}
+
+// Short-lived values, which Free returns to the pool.
+func BenchmarkNewIntFree(b *testing.B) {
+	x := gmp.NewInt(3)
+	x.Lsh(x, 256)
+	for i := 0; i < b.N; i++ {
+		z := gmp.NewInt(int64(i))
+		z.Mul(z, x)
+		z.Free()
+	}
+	x.Free()
+}
+
+func BenchmarkNewIntBig(b *testing.B) {
+	x := big.NewInt(3)
+	x.Lsh(x, 256)
+	for i := 0; i < b.N; i++ {
+		z := big.NewInt(int64(i))
+		z.Mul(z, x)
+	}
+}
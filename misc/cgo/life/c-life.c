@@ -3,6 +3,8 @@
 // license that can be found in the LICENSE file.
 
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
 #include "life.h"
 #include "_cgo_export.h"
 
@@ -15,19 +17,18 @@ void
 Step(int x, int y, int *a, int *n)
 {
 	struct GoStart_return r;
+	int i, nw;
 
-	// Use Go to start 4 goroutines each of which handles 1/4 of the
-	// board.
-	r = GoStart(0, x, y, 0, x / 2, 0, y / 2, a, n);
-	assert(r.r0 == 0 && r.r1 == 100);	// test multiple returns
-	r = GoStart(1, x, y, x / 2, x, 0, y / 2, a, n);
-	assert(r.r0 == 1 && r.r1 == 101);	// test multiple returns
-	GoStart(2, x, y, 0, x / 2, y / 2, y, a, n);
-	GoStart(3, x, y, x / 2, x, y / 2, y, a, n);
-	GoWait(0);
-	GoWait(1);
-	GoWait(2);
-	GoWait(3);
+	// Use Go to start a goroutine for each of the GOMAXPROCS
+	// threads, each of which starts with a band of the rows of
+	// the board and steals rows from the others once it is done.
+	nw = GoWorkers(x);
+	for(i = 0; i < nw; i++) {
+		r = GoStart(i, x, y, x * i / nw, x * (i + 1) / nw, 0, y, a, n);
+		assert(r.r0 == i && r.r1 == 100 + i);	// test multiple returns
+	}
+	for(i = 0; i < nw; i++)
+		GoWait(i);
 }
 
 // The actual computation.  This is called in parallel.
@@ -54,3 +55,133 @@ DoStep(int xdim, int ydim, int xstart, int xend, int ystart, int yend, int *a, i
 		}
 	}
 }
+
+// The same computation on a bit-packed board, 64 cells to a word.
+// Each row holds a zero guard word at each end and enough words in
+// between to fill whole vectors, and the board holds a zero guard row
+// above and below, so the kernel needs no bounds tests. A cell's
+// neighbor count is kept in bit-sliced form: one word each for the
+// bits of the count of 64 cells, added up with full adders.
+//
+// With GCC or clang the kernel works on vectors of 4 words, which
+// the compiler turns into SSE2 or AVX2 instructions on x86 and NEON
+// on ARM as it can. Elsewhere it works a word at a time.
+
+#ifdef __GNUC__
+typedef uint64_t Vec __attribute__((vector_size(32)));
+#define LOAD(p) ({ Vec v_; memcpy(&v_, (p), sizeof v_); v_; })
+#else
+typedef uint64_t Vec;
+#define LOAD(p) (*(p))
+#endif
+
+enum {
+	VecWords = sizeof(Vec) / sizeof(uint64_t),
+};
+
+// The number of words in a packed row of ydim cells, guards included.
+static int
+packedStride(int ydim)
+{
+	int w;
+
+	w = (ydim + 63) / 64;
+	w = (w + VecWords - 1) / VecWords * VecWords;
+	return w + 2;
+}
+
+int
+PackedWords(int xdim, int ydim)
+{
+	return (xdim + 2) * packedStride(ydim);
+}
+
+void
+PackBoard(int xdim, int ydim, int *a, uint64_t *p)
+{
+	int x, y, stride;
+	uint64_t *row;
+
+	stride = packedStride(ydim);
+	memset(p, 0, PackedWords(xdim, ydim) * sizeof *p);
+	for(x = 0; x < xdim; x++) {
+		row = p + (x + 1)*stride + 1;
+		for(y = 0; y < ydim; y++)
+			if(a[x*ydim + y] != 0)
+				row[y/64] |= (uint64_t)1 << (y%64);
+	}
+}
+
+void
+UnpackBoard(int xdim, int ydim, uint64_t *p, int *a)
+{
+	int x, y, stride;
+	uint64_t *row;
+
+	stride = packedStride(ydim);
+	for(x = 0; x < xdim; x++) {
+		row = p + (x + 1)*stride + 1;
+		for(y = 0; y < ydim; y++)
+			a[x*ydim + y] = (row[y/64] >> (y%64)) & 1;
+	}
+}
+
+// The sum and carry of three one-bit numbers, 64 at a time.
+#define ADD3(s, c, a, b, d) do { \
+	Vec t_ = (a) ^ (b); \
+	s = t_ ^ (d); \
+	c = ((a) & (b)) | (t_ & (d)); \
+} while(0)
+
+// Compute rows [xstart, xend) of the next generation of the packed
+// board a into n. The rows of n outside that range are not touched.
+void
+DoStepPacked(int xdim, int ydim, int xstart, int xend, uint64_t *a, uint64_t *n)
+{
+	int x, k, stride, words, last;
+	uint64_t *u, *c, *d, *o, mask;
+	Vec ul, uc, ur, cl, cc, cr, dl, dc, dr;
+	Vec su, ku, sd, kd, sm, km, s0, k1, p, q;
+
+	(void)xdim;
+	stride = packedStride(ydim);
+	words = stride - 2;
+	last = (ydim - 1) / 64;
+	mask = ~(uint64_t)0 >> (63 - (ydim - 1) % 64);
+	for(x = xstart; x < xend; x++) {
+		c = a + (x + 1)*stride + 1;
+		u = c - stride;
+		d = c + stride;
+		o = n + (x + 1)*stride + 1;
+		for(k = 0; k < words; k += VecWords) {
+			// The west neighbor of bit i is bit i-1, which
+			// for bit 0 is the top bit of the word before.
+			uc = LOAD(u + k);
+			ul = (uc << 1) | (LOAD(u + k - 1) >> 63);
+			ur = (uc >> 1) | (LOAD(u + k + 1) << 63);
+			cc = LOAD(c + k);
+			cl = (cc << 1) | (LOAD(c + k - 1) >> 63);
+			cr = (cc >> 1) | (LOAD(c + k + 1) << 63);
+			dc = LOAD(d + k);
+			dl = (dc << 1) | (LOAD(d + k - 1) >> 63);
+			dr = (dc >> 1) | (LOAD(d + k + 1) << 63);
+
+			// count = s0 + 2*(p + 2*q + k1), and the cell
+			// lives if the count is 3, or 2 and it is alive:
+			// that is, if p + 2*q + k1 is 1 and s0 or cc.
+			ADD3(su, ku, ul, uc, ur);
+			ADD3(sd, kd, dl, dc, dr);
+			sm = cl ^ cr;
+			km = cl & cr;
+			ADD3(s0, k1, su, sd, sm);
+			ADD3(p, q, ku, kd, km);
+			cc = ~q & (p ^ k1) & (s0 | cc);
+			memcpy(o + k, &cc, sizeof cc);
+		}
+		// Clear the cells past the edge that the vectors
+		// brought to life.
+		o[last] &= mask;
+		for(k = last + 1; k < words; k++)
+			o[k] = 0;
+	}
+}
@@ -9,33 +9,185 @@ package life
 // #include "life.h"
 import "C"
 
-import "unsafe"
+import (
+	"runtime"
+	"sync/atomic"
+	"unsafe"
+)
 
 func Run(gen, x, y int, a []int32) {
-	n := make([]int32, x*y)
+	// Step from one board to the other and back, rather than
+	// copying each generation.
+	b := [2][]int32{a, make([]int32, x*y)}
 	for i := 0; i < gen; i++ {
-		C.Step(C.int(x), C.int(y), (*C.int)(unsafe.Pointer(&a[0])), (*C.int)(unsafe.Pointer(&n[0])))
-		copy(a, n)
+		cur, next := b[i%2], b[(i+1)%2]
+		C.Step(C.int(x), C.int(y), (*C.int)(unsafe.Pointer(&cur[0])), (*C.int)(unsafe.Pointer(&next[0])))
 	}
+	if gen%2 != 0 {
+		copy(a, b[1])
+	}
+}
+
+// bandRows is the number of rows that a worker takes at a time.
+const bandRows = 16
+
+// A sched hands out the rows of a board to workers. Each worker
+// starts with a range of rows of its own, which it takes bandRows at a
+// time from the front. Once its range is empty, it steals bandRows at a
+// time from the back of the others' ranges.
+type sched struct {
+	w []worker
+}
+
+type worker struct {
+	rows uint64 // first row << 32 | end row
+	done chan bool
+}
+
+// workers returns the number of workers to use for a board of x rows:
+// one for each GOMAXPROCS, but none without a band of rows to start.
+func workers(x int) int {
+	n := runtime.GOMAXPROCS(0)
+	if max := (x + bandRows - 1) / bandRows; n > max {
+		n = max
+	}
+	if n < 1 {
+		n = 1
+	}
+	return n
+}
+
+// reset makes room for n workers, whose ranges must be empty or set
+// by set before any of them looks for rows.
+func (s *sched) reset(n int) {
+	if cap(s.w) < n {
+		s.w = make([]worker, n)
+	}
+	s.w = s.w[:n]
+}
+
+// set gives worker i rows [lo, hi).
+func (s *sched) set(i, lo, hi int) {
+	atomic.StoreUint64(&s.w[i].rows, uint64(lo)<<32|uint64(hi))
+}
+
+// take takes up to bandRows rows from worker i's range, from the front
+// if front is set and otherwise from the back.
+func (s *sched) take(i int, front bool) (lo, hi int, ok bool) {
+	for {
+		old := atomic.LoadUint64(&s.w[i].rows)
+		lo, hi = int(old>>32), int(uint32(old))
+		if lo >= hi {
+			return 0, 0, false
+		}
+		var rows uint64
+		if front {
+			if hi > lo+bandRows {
+				hi = lo + bandRows
+			}
+			rows = uint64(hi)<<32 | uint64(uint32(old))
+		} else {
+			if lo < hi-bandRows {
+				lo = hi - bandRows
+			}
+			rows = old&^(1<<32-1) | uint64(lo)
+		}
+		if atomic.CompareAndSwapUint64(&s.w[i].rows, old, rows) {
+			return lo, hi, true
+		}
+	}
+}
+
+// next returns the next rows for worker i to compute, its own if it
+// has any left and otherwise another worker's.
+func (s *sched) next(i int) (lo, hi int, ok bool) {
+	if lo, hi, ok = s.take(i, true); ok {
+		return
+	}
+	for j := 1; j < len(s.w); j++ {
+		if lo, hi, ok = s.take((i+j)%len(s.w), false); ok {
+			return
+		}
+	}
+	return 0, 0, false
 }
 
-// Keep the channels visible from Go.
-var chans [4]chan bool
+// The scheduler of Step, and the channels on which its workers signal
+// that they are done. Keep them visible from Go.
+var stepSched sched
+
+//export GoWorkers
+// GoWorkers prepares for a step of a board of x rows, and returns the
+// number of workers to start.
+func GoWorkers(x C.int) C.int {
+	n := workers(int(x))
+	stepSched.reset(n)
+	for i := range stepSched.w {
+		stepSched.set(i, 0, 0)
+	}
+	return C.int(n)
+}
 
 //export GoStart
 // Double return value is just for testing.
 func GoStart(i, xdim, ydim, xstart, xend, ystart, yend C.int, a *C.int, n *C.int) (int, int) {
 	c := make(chan bool, int(C.MYCONST))
+	stepSched.w[i].done = c
+	stepSched.set(int(i), int(xstart), int(xend))
 	go func() {
-		C.DoStep(xdim, ydim, xstart, xend, ystart, yend, a, n)
+		for {
+			lo, hi, ok := stepSched.next(int(i))
+			if !ok {
+				break
+			}
+			C.DoStep(xdim, ydim, C.int(lo), C.int(hi), ystart, yend, a, n)
+		}
 		c <- true
 	}()
-	chans[i] = c
 	return int(i), int(i + 100)
 }
 
 //export GoWait
 func GoWait(i C.int) {
-	<-chans[i]
-	chans[i] = nil
+	<-stepSched.w[i].done
+	stepSched.w[i].done = nil
+}
+
+// RunPacked is like Run, but runs the generations on a bit-packed
+// copy of the board.
+func RunPacked(gen, x, y int, a []int32) {
+	p := make([]uint64, C.PackedWords(C.int(x), C.int(y)))
+	n := make([]uint64, len(p))
+	C.PackBoard(C.int(x), C.int(y), (*C.int)(unsafe.Pointer(&a[0])), (*C.uint64_t)(&p[0]))
+	for i := 0; i < gen; i++ {
+		stepPacked(x, y, p, n)
+		p, n = n, p
+	}
+	C.UnpackBoard(C.int(x), C.int(y), (*C.uint64_t)(&p[0]), (*C.int)(unsafe.Pointer(&a[0])))
+}
+
+// stepPacked computes the next generation of the packed board a into
+// n, in workers scheduled like those of Step.
+func stepPacked(x, y int, a, n []uint64) {
+	var s sched
+	s.reset(workers(x))
+	for i := range s.w {
+		s.set(i, x*i/len(s.w), x*(i+1)/len(s.w))
+	}
+	c := make(chan bool)
+	for i := range s.w {
+		go func(i int) {
+			for {
+				lo, hi, ok := s.next(i)
+				if !ok {
+					break
+				}
+				C.DoStepPacked(C.int(x), C.int(y), C.int(lo), C.int(hi), (*C.uint64_t)(&a[0]), (*C.uint64_t)(&n[0]))
+			}
+			c <- true
+		}(i)
+	}
+	for range s.w {
+		<-c
+	}
 }
@@ -2,6 +2,12 @@
 // Use of this source code is governed by a BSD-style
 // license that can be found in the LICENSE file.
 
+#include <stdint.h>
+
 extern void Step(int, int, int *, int *);
 extern void DoStep(int, int, int, int, int, int, int *, int *);
 extern const int MYCONST;
+extern int PackedWords(int, int);
+extern void PackBoard(int, int, int *, uint64_t *);
+extern void UnpackBoard(int, int, uint64_t *, int *);
+extern void DoStepPacked(int, int, int, int, uint64_t *, uint64_t *);
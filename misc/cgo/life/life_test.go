@@ -0,0 +1,85 @@
+// skip
+
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package life_test
+
+import (
+	"."
+	"math/rand"
+	"reflect"
+	"runtime"
+	"testing"
+)
+
+func randomBoard(dim int) []int32 {
+	a := make([]int32, dim*dim)
+	for i := range a {
+		a[i] = int32(rand.Intn(2))
+	}
+	return a
+}
+
+// step is a plain Go version of a generation of Run.
+func step(dim int, a []int32) []int32 {
+	n := make([]int32, len(a))
+	for x := 0; x < dim; x++ {
+		for y := 0; y < dim; y++ {
+			c := 0
+			for i := x - 1; i <= x+1; i++ {
+				for j := y - 1; j <= y+1; j++ {
+					if i >= 0 && i < dim && j >= 0 && j < dim && (i != x || j != y) && a[i*dim+j] != 0 {
+						c++
+					}
+				}
+			}
+			if c == 3 || c == 2 && a[x*dim+y] != 0 {
+				n[x*dim+y] = 1
+			}
+		}
+	}
+	return n
+}
+
+func TestRun(t *testing.T) {
+	// More workers than CPUs, so that they steal from each other.
+	defer runtime.GOMAXPROCS(runtime.GOMAXPROCS(8))
+	for _, dim := range []int{1, 15, 16, 17, 100, 200} {
+		for gen := 1; gen <= 2; gen++ {
+			a := randomBoard(dim)
+			want := a
+			for i := 0; i < gen; i++ {
+				want = step(dim, want)
+			}
+			life.Run(gen, dim, dim, a)
+			if !reflect.DeepEqual(a, want) {
+				t.Errorf("%dx%d, %d generations: Run differs from step", dim, dim, gen)
+			}
+		}
+	}
+}
+
+func TestRunPacked(t *testing.T) {
+	for _, dim := range []int{1, 3, 63, 64, 65, 100, 257} {
+		a := randomBoard(dim)
+		b := append([]int32(nil), a...)
+		life.Run(5, dim, dim, a)
+		life.RunPacked(5, dim, dim, b)
+		if !reflect.DeepEqual(a, b) {
+			t.Errorf("%dx%d: RunPacked differs from Run", dim, dim)
+		}
+	}
+}
+
+func benchmarkRun(b *testing.B, run func(gen, x, y int, a []int32)) {
+	const dim = 4096
+	a := randomBoard(dim)
+	b.SetBytes(dim * dim)
+	b.ResetTimer()
+	run(b.N, dim, dim, a)
+}
+
+func BenchmarkRun4k(b *testing.B)       { benchmarkRun(b, life.Run) }
+func BenchmarkRunPacked4k(b *testing.B) { benchmarkRun(b, life.RunPacked) }
@@ -0,0 +1,153 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Measures the startup of libstartup, built with -buildmode=c-shared
+// and loaded with dlopen when compiled with -DSHARED, or built with
+// -buildmode=c-archive and linked in otherwise. Prints one line in
+// the format of Go benchmark results; see run.bash.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#endif
+
+#ifdef SHARED
+#include <dlfcn.h>
+#define MODE "c-shared"
+#else
+#include "libstartup.h"
+#define MODE "c-archive"
+#endif
+
+static int64_t now(void) {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000000 + tv.tv_usec * 1000;
+#endif
+}
+
+// Set before any constructor without a priority runs, including the
+// one that starts the Go runtime in a c-archive.
+static int64_t start;
+
+static void __attribute__ ((constructor (101))) recordstart(void) {
+  start = now();
+}
+
+// Returns the number of threads in the process, or -1 if unknown.
+static int nthreads(void) {
+#ifdef __linux__
+  DIR* d;
+  struct dirent* e;
+  int n;
+
+  d = opendir("/proc/self/task");
+  if (d == NULL) {
+    return -1;
+  }
+  n = 0;
+  while ((e = readdir(d)) != NULL) {
+    if (e->d_name[0] != '.') {
+      n++;
+    }
+  }
+  closedir(d);
+  return n;
+#else
+  return -1;
+#endif
+}
+
+// Returns the resident set size of the process in bytes. Where there
+// is no /proc, this is the peak size instead.
+static int64_t rss(void) {
+#ifdef __linux__
+  FILE* f;
+  long size, resident;
+
+  f = fopen("/proc/self/statm", "r");
+  if (f != NULL) {
+    if (fscanf(f, "%ld %ld", &size, &resident) == 2) {
+      fclose(f);
+      return (int64_t)resident * sysconf(_SC_PAGESIZE);
+    }
+    fclose(f);
+  }
+#endif
+  struct rusage ru;
+
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    return -1;
+  }
+#ifdef __APPLE__
+  return ru.ru_maxrss;
+#else
+  return (int64_t)ru.ru_maxrss * 1024;
+#endif
+}
+
+int main(int argc, char** argv) {
+  int64_t t0, t1, t2;
+  int (*ping)(void);
+  int n;
+
+#ifdef SHARED
+  void* handle;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s library\n", argv[0]);
+    return 2;
+  }
+  t0 = now();
+  handle = dlopen(argv[1], RTLD_NOW | RTLD_GLOBAL);
+  t1 = now();
+  if (handle == NULL) {
+    fprintf(stderr, "ERROR: failed to open the shared library: %s\n", dlerror());
+    return 2;
+  }
+  ping = (int (*)(void))dlsym(handle, "Ping");
+  if (ping == NULL) {
+    fprintf(stderr, "ERROR: missing Ping: %s\n", dlerror());
+    return 2;
+  }
+#else
+  t0 = start;
+  t1 = now();
+  ping = Ping;
+#endif
+
+  if (ping() != 1) {
+    fprintf(stderr, "ERROR: Ping did not return 1\n");
+    return 2;
+  }
+  t2 = now();
+
+  // ns/op: from loading (or the start of the program) to the
+  // return of the first call into Go.
+  // ctor-ns/op: the part of that spent before the first call:
+  // the library constructor, which starts the runtime.
+  // call-ns/op: the first call, which waits for the runtime to finish
+  // initializing.
+  printf("BenchmarkStartup/%s\t1\t%lld ns/op\t%lld ctor-ns/op\t%lld call-ns/op",
+	 MODE, (long long)(t2 - t0), (long long)(t1 - t0), (long long)(t2 - t1));
+  n = nthreads();
+  if (n >= 0) {
+    printf("\t%d threads", n);
+  }
+  printf("\t%lld rss-bytes\n", (long long)rss());
+  return 0;
+}
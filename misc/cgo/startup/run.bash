@@ -0,0 +1,77 @@
+#!/usr/bin/env bash
+# Copyright 2016 The Go Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style
+# license that can be found in the LICENSE file.
+
+# Measures the startup of a Go library built with -buildmode=c-shared
+# and with -buildmode=c-archive: the time from loading the library
+# (or starting the program) to the return of the first call into Go,
+# how much of it the library constructor takes, and the threads and
+# resident memory of the process afterwards.
+#
+# Usage: run.bash [count]
+#
+# Each of count runs (default 10) starts a new process and prints a
+# line per build mode in the format of Go benchmark results, so that
+# the output from before and after a runtime change can be compared
+# with benchstat.
+#
+# The library is built for the GOOS and GOARCH of the go command. If
+# they are not those of the host, the programs are run with
+# go_$GOOS_$GOARCH_exec, as go run does.
+
+set -e
+
+if [ ! -f src/libstartup/libstartup.go ]; then
+	cwd=$(pwd)
+	echo "misc/cgo/startup/run.bash is running in $cwd" 1>&2
+	exit 1
+fi
+
+count=${1:-10}
+
+goos=$(go env GOOS)
+goarch=$(go env GOARCH)
+
+exec_wrapper=""
+if [ "$goos" != "$(go env GOHOSTOS)" ] || [ "$goarch" != "$(go env GOHOSTARCH)" ]; then
+	exec_wrapper=go_${goos}_${goarch}_exec
+	if ! type "$exec_wrapper" >/dev/null 2>&1; then
+		echo "misc/cgo/startup/run.bash: cannot run $goos/$goarch programs without $exec_wrapper" 1>&2
+		exit 1
+	fi
+fi
+
+libext="so"
+if [ "$goos" == "darwin" ]; then
+	libext="dylib"
+fi
+
+libdl="-ldl"
+if [ "$goos" != "linux" ] && [ "$goos" != "android" ]; then
+	libdl=""
+fi
+
+archiveflags="-pthread"
+if [ "$goos" == "darwin" ]; then
+	archiveflags="$archiveflags -framework CoreFoundation -framework Foundation"
+fi
+
+function cleanup() {
+	rm -f libstartup.$libext libstartup.a libstartup.h startup-shared startup-archive
+}
+trap cleanup EXIT
+
+GOGCCFLAGS=$(go env GOGCCFLAGS)
+CC=$(go env CC)
+
+GOPATH=$(pwd) go build -buildmode=c-shared -o libstartup.$libext libstartup
+$CC $GOGCCFLAGS -DSHARED -o startup-shared main.c $libdl
+
+GOPATH=$(pwd) go build -buildmode=c-archive -o libstartup.a libstartup
+$CC $GOGCCFLAGS -I . -o startup-archive main.c libstartup.a $archiveflags
+
+for i in $(seq $count); do
+	$exec_wrapper ./startup-shared ./libstartup.$libext
+	$exec_wrapper ./startup-archive
+done
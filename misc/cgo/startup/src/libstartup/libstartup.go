@@ -0,0 +1,16 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// The smallest library worth measuring: one exported function,
+// no package initialization of its own.
+package main
+
+import "C"
+
+//export Ping
+func Ping() C.int {
+	return 1
+}
+
+func main() {}
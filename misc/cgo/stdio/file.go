@@ -21,7 +21,10 @@ package stdio
 char* greeting = "hello, world";
 */
 import "C"
-import "unsafe"
+import (
+	"syscall"
+	"unsafe"
+)
 
 type File C.FILE
 
@@ -40,5 +43,95 @@ func (f *File) Flush() {
 	C.fflush((*C.FILE)(f))
 }
 
+// Open opens the named file with the fopen mode.
+func Open(name, mode string) (*File, error) {
+	n := C.CString(name)
+	m := C.CString(mode)
+	defer C.free(unsafe.Pointer(n))
+	defer C.free(unsafe.Pointer(m))
+	f, err := C.fopen(n, m)
+	if f == nil {
+		return nil, err
+	}
+	return (*File)(f), nil
+}
+
+// Close closes f.
+func (f *File) Close() error {
+	if _, err := C.fclose((*C.FILE)(f)); err != nil {
+		return err
+	}
+	return nil
+}
+
+// Write writes b to f with a single fwrite, which needs no copy of b
+// in C memory. It does not flush f.
+func (f *File) Write(b []byte) (int, error) {
+	if len(b) == 0 {
+		return 0, nil
+	}
+	n, err := C.fwrite(unsafe.Pointer(&b[0]), 1, C.size_t(len(b)), (*C.FILE)(f))
+	if int(n) < len(b) {
+		if err == nil {
+			err = syscall.EIO
+		}
+		return int(n), err
+	}
+	return int(n), nil
+}
+
+// A Writer buffers output to a File on the Go side, so that a program
+// that writes a line at a time calls into C once per buffer rather
+// than once per line.
+type Writer struct {
+	f   *File
+	buf []byte
+}
+
+// NewWriter returns a Writer to f with a buffer of size bytes.
+func NewWriter(f *File, size int) *Writer {
+	return &Writer{f: f, buf: make([]byte, 0, size)}
+}
+
+// Write writes b to w's buffer, first writing out the buffer if b does
+// not fit in what is left of it. A b larger than the buffer is written
+// directly.
+func (w *Writer) Write(b []byte) (int, error) {
+	if len(w.buf)+len(b) > cap(w.buf) {
+		if err := w.flush(); err != nil {
+			return 0, err
+		}
+		if len(b) > cap(w.buf) {
+			return w.f.Write(b)
+		}
+	}
+	w.buf = append(w.buf, b...)
+	return len(b), nil
+}
+
+// WriteString is like Write, but writes a string.
+func (w *Writer) WriteString(s string) (int, error) {
+	if len(w.buf)+len(s) > cap(w.buf) {
+		return w.Write([]byte(s))
+	}
+	w.buf = append(w.buf, s...)
+	return len(s), nil
+}
+
+// Flush writes out w's buffer with a single fwrite and flushes the File.
+func (w *Writer) Flush() error {
+	if err := w.flush(); err != nil {
+		return err
+	}
+	w.f.Flush()
+	return nil
+}
+
+func (w *Writer) flush() error {
+	n, err := w.f.Write(w.buf)
+	w.buf = w.buf[:copy(w.buf, w.buf[n:])]
+	return err
+}
+
 var Greeting = C.GoString(C.greeting)
 var Gbytes = C.GoBytes(unsafe.Pointer(C.greeting), C.int(len(Greeting)))
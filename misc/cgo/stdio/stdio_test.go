@@ -0,0 +1,87 @@
+// skip
+
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package stdio_test
+
+import (
+	"../stdio"
+	"bytes"
+	"io/ioutil"
+	"os"
+	"strconv"
+	"testing"
+)
+
+func TestWriter(t *testing.T) {
+	tmp, err := ioutil.TempFile("", "stdio")
+	if err != nil {
+		t.Fatal(err)
+	}
+	name := tmp.Name()
+	tmp.Close()
+	defer os.Remove(name)
+
+	f, err := stdio.Open(name, "w")
+	if err != nil {
+		t.Fatal(err)
+	}
+	w := stdio.NewWriter(f, 16)
+	var want bytes.Buffer
+	for i := 0; i < 100; i++ {
+		s := strconv.Itoa(i) + "\n"
+		if i%10 == 0 {
+			s = string(bytes.Repeat([]byte{'x'}, 20)) + s // longer than the buffer
+		}
+		w.WriteString(s)
+		want.WriteString(s)
+	}
+	if err := w.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	if err := f.Close(); err != nil {
+		t.Fatal(err)
+	}
+
+	got, err := ioutil.ReadFile(name)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(got, want.Bytes()) {
+		t.Errorf("file holds %q, want %q", got, want.Bytes())
+	}
+}
+
+func openNull(b *testing.B) *stdio.File {
+	f, err := stdio.Open(os.DevNull, "w")
+	if err != nil {
+		b.Fatal(err)
+	}
+	return f
+}
+
+const line = "the quick brown fox jumps over the lazy dog\n"
+
+// A line at a time, as chain.go and fib.go write: a call into C to
+// copy the line to C memory and one each to write and flush it.
+func BenchmarkWriteStringLines(b *testing.B) {
+	f := openNull(b)
+	defer f.Close()
+	b.SetBytes(int64(len(line)))
+	for i := 0; i < b.N; i++ {
+		f.WriteString(line)
+	}
+}
+
+func BenchmarkWriterLines(b *testing.B) {
+	f := openNull(b)
+	defer f.Close()
+	w := stdio.NewWriter(f, 4096)
+	b.SetBytes(int64(len(line)))
+	for i := 0; i < b.N; i++ {
+		w.WriteString(line)
+	}
+	w.Flush()
+}
@@ -0,0 +1,84 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo affinity: functions, whose callers prefer to run on the
+// thread of their last call.
+
+/*
+#cgo affinity: affineSelf
+
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+static uintptr_t affineSelf(void) {
+	return (uintptr_t)pthread_self();
+}
+
+static uintptr_t plainSelf(void) {
+	return (uintptr_t)pthread_self();
+}
+
+static void affinityNap(void) {
+	usleep(200);
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"sync"
+	"testing"
+	"time"
+)
+
+func testAffinity(t *testing.T) {
+	if C.affineSelf() == 0 {
+		t.Fatal("affineSelf returned 0")
+	}
+
+	// Goroutines that block in C and sleep keep the scheduler moving
+	// them between threads. Those calling affineSelf should come back
+	// to the thread of their last call more often than those calling
+	// plainSelf, which is the same C function without the directive.
+	defer runtime.GOMAXPROCS(runtime.GOMAXPROCS(2))
+	plain := affinityRounds(func() C.uintptr_t { return C.plainSelf() })
+	affine := affinityRounds(func() C.uintptr_t { return C.affineSelf() })
+	if affine <= plain {
+		t.Errorf("%d calls to affineSelf and %d to plainSelf ran on the thread of the previous call; want more for affineSelf", affine, plain)
+	}
+}
+
+// affinityRounds calls self from several goroutines, each sleeping
+// between calls, and returns how many calls ran on the same thread as
+// the goroutine's previous call.
+func affinityRounds(self func() C.uintptr_t) int {
+	var wg sync.WaitGroup
+	var mu sync.Mutex
+	same := 0
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			n := 0
+			last := self()
+			for i := 0; i < 100; i++ {
+				C.affinityNap()
+				time.Sleep(100 * time.Microsecond)
+				s := self()
+				if s == last {
+					n++
+				}
+				last = s
+			}
+			mu.Lock()
+			same += n
+			mu.Unlock()
+		}()
+	}
+	wg.Wait()
+	return same
+}
@@ -0,0 +1,142 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test building C data structures in a runtime/cgo Arena.
+
+/*
+#include <stdlib.h>
+#include <string.h>
+
+struct arenaNode {
+	struct arenaNode *next;
+	char *name;
+	double value;
+};
+
+static int arenaListLen(struct arenaNode *n, size_t *namelen) {
+	int len = 0;
+
+	*namelen = 0;
+	for (; n != NULL; n = n->next) {
+		len++;
+		*namelen += strlen(n->name);
+	}
+	return len;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime/cgo"
+	"testing"
+	"unsafe"
+)
+
+func testArena(t *testing.T) {
+	var a cgo.Arena
+	defer a.Free()
+
+	for round := 0; round < 2; round++ {
+		const n = 10000
+		var head *C.struct_arenaNode
+		wantNames := 0
+		for i := 0; i < n; i++ {
+			node := (*C.struct_arenaNode)(a.Alloc(unsafe.Sizeof(C.struct_arenaNode{})))
+			if uintptr(unsafe.Pointer(node))%unsafe.Alignof(C.double(0)) != 0 {
+				t.Fatalf("Alloc returned misaligned pointer %p", node)
+			}
+			if node.next != nil || node.name != nil || node.value != 0 {
+				t.Fatalf("Alloc returned memory that is not zeroed")
+			}
+			name := fmt.Sprint("node", i)
+			wantNames += len(name)
+			node.name = (*C.char)(a.CString(name))
+			node.next = head
+			head = node
+		}
+		var namelen C.size_t
+		if got := C.arenaListLen(head, &namelen); got != n {
+			t.Errorf("round %d: list length %d, want %d", round, got, n)
+		}
+		if int(namelen) != wantNames {
+			t.Errorf("round %d: total name length %d, want %d", round, namelen, wantNames)
+		}
+		if got := C.GoString(head.name); got != fmt.Sprint("node", n-1) {
+			t.Errorf("round %d: head name %q", round, got)
+		}
+		a.Free()
+	}
+
+	// Large allocations, and copies of byte slices.
+	big := make([]byte, 1<<20)
+	for i := range big {
+		big[i] = byte(i)
+	}
+	p := a.CBytes(big)
+	if got := C.GoBytes(p, C.int(len(big))); string(got) != string(big) {
+		t.Error("CBytes copy differs")
+	}
+	// Very large allocations are mapped, and must still be zeroed.
+	q := (*[40 << 20]byte)(a.Alloc(40 << 20))
+	for _, i := range []int{0, 4095, 4096, 40<<20 - 1} {
+		if q[i] != 0 {
+			t.Fatalf("large Alloc returned memory that is not zeroed at %d", i)
+		}
+		q[i] = 1
+	}
+	if a.Alloc(0) == a.Alloc(0) {
+		t.Error("Alloc(0) returned the same pointer twice")
+	}
+
+	// A size that wraps around the address space does not fit in
+	// the current block.
+	func() {
+		defer func() {
+			if recover() == nil {
+				t.Error("Alloc of an impossible size did not panic")
+			}
+		}()
+		a.Alloc(^uintptr(0) - 15)
+	}()
+}
+
+func benchArenaCString(b *testing.B) {
+	b.Run("CString", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			p := C.CString("hello, world")
+			C.free(unsafe.Pointer(p))
+		}
+	})
+	b.Run("Arena", func(b *testing.B) {
+		var a cgo.Arena
+		for i := 0; i < b.N; i++ {
+			a.CString("hello, world")
+			if i%1000 == 999 {
+				a.Free()
+			}
+		}
+		a.Free()
+	})
+}
+
+func benchArenaCBytes(b *testing.B) {
+	buf := make([]byte, 64<<20)
+	b.Run("CBytes", func(b *testing.B) {
+		b.SetBytes(int64(len(buf)))
+		for i := 0; i < b.N; i++ {
+			C.free(C.CBytes(buf))
+		}
+	})
+	b.Run("Arena", func(b *testing.B) {
+		b.SetBytes(int64(len(buf)))
+		var a cgo.Arena
+		for i := 0; i < b.N; i++ {
+			a.CBytes(buf)
+			a.Free()
+		}
+	})
+}
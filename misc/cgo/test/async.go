@@ -0,0 +1,107 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo async: functions, called from Go on the cgo thread pool
+// while the calling goroutine is parked.
+
+/*
+#cgo async: asyncAdd asyncFail asyncFill
+
+#include <errno.h>
+
+static int asyncAdd(int x, int y) {
+	return x + y;
+}
+
+static int asyncFail(int e) {
+	errno = e;
+	return -1;
+}
+
+static long asyncFill(int *p, int n) {
+	long sum = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		p[i] = i;
+		sum += i;
+	}
+	return sum;
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"sync"
+	"syscall"
+	"testing"
+)
+
+func testAsync(t *testing.T) {
+	if got := C.asyncAdd(2, 3); got != 5 {
+		t.Errorf("asyncAdd(2, 3) = %d, want 5", got)
+	}
+
+	_, err := C.asyncFail(C.int(syscall.EINVAL))
+	if err != syscall.EINVAL {
+		t.Errorf("asyncFail(EINVAL) error = %v, want %v", err, syscall.EINVAL)
+	}
+
+	// A locked goroutine makes an ordinary call.
+	runtime.LockOSThread()
+	if got := C.asyncAdd(4, 5); got != 9 {
+		t.Errorf("asyncAdd(4, 5) on locked thread = %d, want 9", got)
+	}
+	runtime.UnlockOSThread()
+
+	// Call from many goroutines while the garbage collector runs
+	// and tries to shrink their stacks, which hold the argument
+	// and result of each call.
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			growStack(64)
+			buf := make([]C.int, 100)
+			for j := 0; j < 200; j++ {
+				if got := C.asyncFill(&buf[0], C.int(len(buf))); got != 4950 {
+					t.Errorf("asyncFill = %d, want 4950", got)
+					return
+				}
+				if buf[99] != 99 {
+					t.Errorf("asyncFill set buf[99] = %d, want 99", buf[99])
+					return
+				}
+				buf[99] = 0
+			}
+		}()
+	}
+	for i := 0; i < 10; i++ {
+		runtime.GC()
+	}
+	wg.Wait()
+}
+
+// growStack uses about n KB of stack, so that stack shrinking
+// later has something to do.
+func growStack(n int) byte {
+	var buf [1024]byte
+	buf[n%len(buf)] = byte(n)
+	if n > 0 {
+		return growStack(n-1) + buf[0]
+	}
+	return buf[0]
+}
+
+func benchCgoAsyncCall(b *testing.B) {
+	const x = C.int(2)
+	const y = C.int(3)
+	for i := 0; i < b.N; i++ {
+		C.asyncAdd(x, y)
+	}
+}
@@ -0,0 +1,42 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Benchmark SSE code in Go after calls to C code that leaves the
+// upper halves of the AVX registers in use.
+
+/*
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("avx")))
+static void avxDirty(void) {
+	__asm__ volatile("vcmpps $15, %%ymm1, %%ymm1, %%ymm1" ::: "xmm1");
+}
+
+static void avxDirtyUpper(void) {
+	if (__builtin_cpu_supports("avx")) {
+		avxDirty();
+	}
+}
+#else
+static void avxDirtyUpper(void) {
+}
+#endif
+*/
+import "C"
+
+import "testing"
+
+var avxSink float64
+
+func benchCgoCallAVX(b *testing.B) {
+	x := 1.0
+	for i := 0; i < b.N; i++ {
+		C.avxDirtyUpper()
+		for j := 0; j < 100; j++ {
+			x = x*1.0000001 + 1e-9
+		}
+	}
+	avxSink = x
+}
@@ -149,6 +149,18 @@ func benchCgoCall(b *testing.B) {
 	}
 }
 
+// benchCgoErrnoCall is benchCgoCall with the two-result form, which
+// clears errno before the call and reads it after.
+func benchCgoErrnoCall(b *testing.B) {
+	const x = C.int(2)
+	const y = C.int(3)
+	for i := 0; i < b.N; i++ {
+		if _, err := C.add(x, y); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
+
 // Issue 2470.
 func testUnsignedInt(t *testing.T) {
 	a := (int64)(C.UINT32VAL)
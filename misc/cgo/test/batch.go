@@ -0,0 +1,113 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo batch: functions, called as C.batch_xxx with slices
+// of arguments and results.
+
+/*
+#cgo batch: batchScale batchStore batchName batchCallGo
+#cgo leaf: batchScale
+
+#include <stdlib.h>
+
+extern int batchScale(int, int);
+extern void batchStore(int*, int);
+extern const char *batchName(int);
+extern int batchCallGo(int);
+*/
+import "C"
+
+import (
+	"testing"
+	"unsafe"
+)
+
+//export batchGoGrow
+func batchGoGrow(x C.int) C.int {
+	// Grow the stack, which moves the argument frame
+	// of the batch call.
+	var buf [16 << 10]byte
+	buf[x] = byte(x)
+	return x + C.int(buf[x])
+}
+
+func testBatch(t *testing.T) {
+	const n = 100
+	xs := make([]C.int, n)
+	ks := make([]C.int, n)
+	rs := make([]C.int, n)
+	for i := range xs {
+		xs[i] = C.int(i)
+		ks[i] = C.int(i % 7)
+	}
+	C.batch_batchScale(xs, ks, rs)
+	for i, r := range rs {
+		if want := C.int(i * (i % 7)); r != want {
+			t.Fatalf("batchScale: rs[%d] = %d, want %d", i, r, want)
+		}
+	}
+
+	// Pointers to C memory may be passed.
+	mem := (*[n]C.int)(C.malloc(n * C.size_t(unsafe.Sizeof(C.int(0)))))
+	defer C.free(unsafe.Pointer(mem))
+	ps := make([]*C.int, n)
+	for i := range ps {
+		ps[i] = &mem[i]
+	}
+	C.batch_batchStore(ps, xs)
+	for i, v := range mem {
+		if v != C.int(i) {
+			t.Fatalf("batchStore: mem[%d] = %d, want %d", i, v, i)
+		}
+	}
+
+	names := make([]*C.char, 4)
+	C.batch_batchName(xs[:4], names)
+	for i, want := range []string{"zero", "one", "two", "zero"} {
+		if got := C.GoString(names[i]); got != want {
+			t.Errorf("batchName: names[%d] = %q, want %q", i, got, want)
+		}
+	}
+
+	// Callbacks may move the goroutine stack between calls.
+	c := make(chan bool)
+	go func() {
+		C.batch_batchCallGo(xs, rs)
+		c <- true
+	}()
+	<-c
+	for i, r := range rs {
+		if r != C.int(2*i) {
+			t.Fatalf("batchCallGo: rs[%d] = %d, want %d", i, r, 2*i)
+		}
+	}
+
+	// An empty batch does nothing.
+	C.batch_batchScale(nil, nil, nil)
+
+	func() {
+		defer func() {
+			if recover() == nil {
+				t.Error("batch call with slices of different lengths did not panic")
+			}
+		}()
+		C.batch_batchScale(xs, ks[:1], rs)
+	}()
+}
+
+func benchCgoBatchCall(b *testing.B) {
+	const batch = 64
+	xs := make([]C.int, batch)
+	ks := make([]C.int, batch)
+	rs := make([]C.int, batch)
+	for i := 0; i < b.N; i += batch {
+		n := batch
+		if b.N-i < n {
+			n = b.N - i
+		}
+		C.batch_batchScale(xs[:n], ks[:n], rs[:n])
+	}
+}
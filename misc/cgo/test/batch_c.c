@@ -0,0 +1,30 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "_cgo_export.h"
+
+int
+batchScale(int x, int k)
+{
+	return x * k;
+}
+
+void
+batchStore(int *p, int v)
+{
+	*p = v;
+}
+
+const char*
+batchName(int i)
+{
+	static const char *names[] = {"zero", "one", "two"};
+	return names[i % 3];
+}
+
+int
+batchCallGo(int x)
+{
+	return batchGoGrow(x);
+}
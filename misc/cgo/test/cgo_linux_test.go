@@ -10,3 +10,6 @@ func TestSetgid(t *testing.T)  { testSetgid(t) }
 func Test6997(t *testing.T)    { test6997(t) }
 func TestBuildID(t *testing.T) { testBuildID(t) }
 func Test9400(t *testing.T)    { test9400(t) }
+func TestIOBatch(t *testing.T) { testIOBatch(t) }
+
+func BenchmarkIOBatch(b *testing.B) { benchIOBatch(b) }
@@ -28,6 +28,7 @@ func TestBlocking(t *testing.T)              { testBlocking(t) }
 func Test1328(t *testing.T)                  { test1328(t) }
 func TestParallelSleep(t *testing.T)         { testParallelSleep(t) }
 func TestSetEnv(t *testing.T)                { testSetEnv(t) }
+func TestSetEnvs(t *testing.T)               { testSetEnvs(t) }
 func TestHelpers(t *testing.T)               { testHelpers(t) }
 func TestLibgcc(t *testing.T)                { testLibgcc(t) }
 func Test1635(t *testing.T)                  { test1635(t) }
@@ -70,5 +71,39 @@ func Test12030(t *testing.T)                 { test12030(t) }
 func TestGCC68255(t *testing.T)              { testGCC68255(t) }
 func TestCallGoWithString(t *testing.T)      { testCallGoWithString(t) }
 func Test14838(t *testing.T)                 { test14838(t) }
+func TestInvokeVector(t *testing.T)          { testInvokeVector(t) }
+func TestInvokeAsync(t *testing.T)           { testInvokeAsync(t) }
+func TestLeaf(t *testing.T)                  { testLeaf(t) }
+func TestBatch(t *testing.T)                 { testBatch(t) }
+func TestPtrCheck(t *testing.T)              { testPtrCheck(t) }
+func TestPinner(t *testing.T)                { testPinner(t) }
+func TestArena(t *testing.T)                 { testArena(t) }
+func TestAsync(t *testing.T)                 { testAsync(t) }
+func TestCMallocStats(t *testing.T)          { testCMallocStats(t) }
+func TestFreeList(t *testing.T)              { testFreeList(t) }
+func TestInlineAccessor(t *testing.T)        { testInlineAccessor(t) }
+func TestExportAlloc(t *testing.T)           { testExportAlloc(t) }
+func TestStackCall(t *testing.T)             { testStackCall(t) }
+func TestSmallMalloc(t *testing.T)           { testSmallMalloc(t) }
+func TestGoBytesInto(t *testing.T)           { testGoBytesInto(t) }
+func TestGoStringIntern(t *testing.T)        { testGoStringIntern(t) }
+func TestAffinity(t *testing.T)              { testAffinity(t) }
+func TestLayout(t *testing.T)                { testLayout(t) }
+func TestNewCallback(t *testing.T)           { testNewCallback(t) }
 
-func BenchmarkCgoCall(b *testing.B) { benchCgoCall(b) }
+func BenchmarkCgoCall(b *testing.B)         { benchCgoCall(b) }
+func BenchmarkCgoErrnoCall(b *testing.B)    { benchCgoErrnoCall(b) }
+func BenchmarkCgoCallAVX(b *testing.B)      { benchCgoCallAVX(b) }
+func BenchmarkCgoLeafCall(b *testing.B)     { benchCgoLeafCall(b) }
+func BenchmarkCgoStackCall(b *testing.B)    { benchCgoStackCall(b) }
+func BenchmarkCgoBatchCall(b *testing.B)    { benchCgoBatchCall(b) }
+func BenchmarkExportAlloc(b *testing.B)     { benchExportAlloc(b) }
+func BenchmarkCgoCallPtrCheck(b *testing.B) { benchCgoCallPtrCheck(b) }
+func BenchmarkPinner(b *testing.B)          { benchPinner(b) }
+func BenchmarkArenaCString(b *testing.B)    { benchArenaCString(b) }
+func BenchmarkArenaCBytes(b *testing.B)     { benchArenaCBytes(b) }
+func BenchmarkFreeList(b *testing.B)        { benchFreeList(b) }
+func BenchmarkSmallMalloc(b *testing.B)     { benchSmallMalloc(b) }
+func BenchmarkCallbackThreads(b *testing.B) { benchCallbackThreads(b) }
+func BenchmarkCgoAsyncCall(b *testing.B)    { benchCgoAsyncCall(b) }
+func BenchmarkNewCallback(b *testing.B)     { benchNewCallback(b) }
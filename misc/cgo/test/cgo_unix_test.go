@@ -8,5 +8,11 @@ package cgotest
 
 import "testing"
 
-func TestSigaltstack(t *testing.T) { testSigaltstack(t) }
-func TestSigprocmask(t *testing.T) { testSigprocmask(t) }
+func TestSigaltstack(t *testing.T)    { testSigaltstack(t) }
+func TestSigprocmask(t *testing.T)    { testSigprocmask(t) }
+func TestRing(t *testing.T)           { testRing(t) }
+func TestRegisterThread(t *testing.T) { testRegisterThread(t) }
+func TestLimit(t *testing.T)          { testLimit(t) }
+
+func BenchmarkCgoTransitions(b *testing.B) { benchCgoTransitions(b) }
+func BenchmarkRing(b *testing.B)           { benchRing(b) }
@@ -0,0 +1,34 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test that C memory allocated from Go is counted in MemStats.
+
+/*
+#include <stdlib.h>
+*/
+import "C"
+
+import (
+	"runtime"
+	"testing"
+	"unsafe"
+)
+
+func testCMallocStats(t *testing.T) {
+	var before, after runtime.MemStats
+	runtime.ReadMemStats(&before)
+	for i := 0; i < 10; i++ {
+		C.free(C.malloc(100))
+		C.free(unsafe.Pointer(C.CString("hello")))
+	}
+	runtime.ReadMemStats(&after)
+	if n := after.CgoMallocs - before.CgoMallocs; n != 20 {
+		t.Errorf("CgoMallocs increased by %d, want 20", n)
+	}
+	if n := after.CgoTotalAlloc - before.CgoTotalAlloc; n != 10*(100+6) {
+		t.Errorf("CgoTotalAlloc increased by %d, want %d", n, 10*(100+6))
+	}
+}
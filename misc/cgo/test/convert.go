@@ -0,0 +1,64 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test C.GoBytesInto and C.GoStringIntern.
+
+/*
+const char *convertPacket = "packet payload";
+const char *convertKeys[] = { "host", "port", "path", "host" };
+*/
+import "C"
+
+import (
+	"testing"
+	"unsafe"
+)
+
+func testGoBytesInto(t *testing.T) {
+	p := unsafe.Pointer(C.convertPacket)
+	buf := make([]byte, 3, 32)
+	b := C.GoBytesInto(buf, p, 6)
+	if string(b) != "packet" {
+		t.Errorf("GoBytesInto = %q, want %q", b, "packet")
+	}
+	if &b[0] != &buf[:1][0] {
+		t.Errorf("GoBytesInto did not reuse the slice")
+	}
+	if b := C.GoBytesInto(b, p, 0); len(b) != 0 {
+		t.Errorf("GoBytesInto with length 0 = %q", b)
+	}
+	if b := C.GoBytesInto(nil, p, 14); string(b) != "packet payload" {
+		t.Errorf("GoBytesInto(nil) = %q, want %q", b, "packet payload")
+	}
+	if n := testing.AllocsPerRun(100, func() {
+		b = C.GoBytesInto(b, p, 14)
+	}); n != 0 {
+		t.Errorf("GoBytesInto into a large enough slice: %v allocations per call, want 0", n)
+	}
+}
+
+func testGoStringIntern(t *testing.T) {
+	keys := (*[4]*C.char)(unsafe.Pointer(&C.convertKeys))
+	for i, k := range keys {
+		if s := C.GoStringIntern(k, 4); s != C.GoString(k) {
+			t.Errorf("GoStringIntern(key %d) = %q, want %q", i, s, C.GoString(k))
+		}
+	}
+	s := C.GoStringIntern(C.convertPacket, 14)
+	if s != "packet payload" {
+		t.Errorf("GoStringIntern = %q, want %q", s, "packet payload")
+	}
+	if s := C.GoStringIntern(C.convertPacket, 0); s != "" {
+		t.Errorf("GoStringIntern with length 0 = %q", s)
+	}
+	// Allocations per call should be close to 0, but on a
+	// different P the first call allocates.
+	if n := testing.AllocsPerRun(100, func() {
+		s = C.GoStringIntern(keys[0], 4)
+	}); n > 0.1 {
+		t.Errorf("GoStringIntern of a recurring string: %v allocations per call", n)
+	}
+}
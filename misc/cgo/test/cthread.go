@@ -4,12 +4,25 @@
 
 package cgotest
 
-// extern void doAdd(int, int);
+/*
+#cgo linux LDFLAGS: -lrt
+
+#include <stdint.h>
+
+// Number of buckets in the latency histogram of benchAdd:
+// bucket i counts calls that took less than 1<<i nanoseconds.
+enum { BenchBuckets = 40 };
+
+extern void doAdd(int, int);
+extern int benchAdd(int, int, uint64_t*);
+*/
 import "C"
 
 import (
+	"fmt"
 	"sync"
 	"testing"
+	"time"
 )
 
 var sum struct {
@@ -38,3 +51,35 @@ func testCthread(t *testing.T) {
 		t.Fatalf("sum=%d, want %d", sum.i, want)
 	}
 }
+
+//export BenchAdd
+func BenchAdd(x int) {
+}
+
+// benchCallbackThreads measures calls into Go from 1 to 1024 threads
+// created by C, reporting the time per call and, with -v, percentiles
+// of the time each call took as seen by its C caller.
+func benchCallbackThreads(b *testing.B) {
+	for _, n := range []int{1, 4, 16, 64, 256, 1024} {
+		b.Run(fmt.Sprintf("threads=%d", n), func(b *testing.B) {
+			ncall := (b.N + n - 1) / n
+			var hist [C.BenchBuckets]C.uint64_t
+			if C.benchAdd(C.int(ncall), C.int(n), &hist[0]) != 0 {
+				b.Fatalf("could not start %d threads", n)
+			}
+			total := uint64(ncall * n)
+			percentile := func(p float64) time.Duration {
+				want := uint64(p * float64(total))
+				var seen uint64
+				for i, c := range hist {
+					seen += uint64(c)
+					if seen > want {
+						return time.Duration(1) << uint(i)
+					}
+				}
+				return time.Duration(1) << uint(len(hist)-1)
+			}
+			b.Logf("%d calls: p50 <%v p90 <%v p99 <%v p99.9 <%v", total, percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999))
+		})
+	}
+}
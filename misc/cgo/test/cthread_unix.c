@@ -5,6 +5,9 @@
 // +build darwin dragonfly freebsd linux netbsd openbsd solaris
 
 #include <pthread.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
 #include "_cgo_export.h"
 
 static void*
@@ -32,3 +35,68 @@ doAdd(int max, int nthread)
 	for(i=0; i<nthread; i++)
 		pthread_join(thread_id[i], 0);		
 }
+
+// benchNow returns the time in nanoseconds.
+static int64_t
+benchNow(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, 0);
+	return (int64_t)tv.tv_sec*1000000000 + tv.tv_usec*1000;
+#endif
+}
+
+typedef struct {
+	int ncall;
+	uint64_t *hist;
+} BenchArg;
+
+static void*
+benchThread(void *p)
+{
+	BenchArg *a;
+	int i, b;
+	int64_t t, d;
+
+	a = p;
+	for(i=0; i<a->ncall; i++) {
+		t = benchNow();
+		BenchAdd(i);
+		d = benchNow() - t;
+		for(b=0; d>0 && b<BenchBuckets-1; b++)
+			d >>= 1;
+		__sync_fetch_and_add(&a->hist[b], 1);
+	}
+	return 0;
+}
+
+// benchAdd makes ncall calls to BenchAdd from each of nthread new
+// threads, counting how long each call took in hist; see cthread.go.
+// It returns -1 if it could not start all the threads.
+int
+benchAdd(int ncall, int nthread, uint64_t *hist)
+{
+	int i, n;
+	pthread_t *thread_id;
+	BenchArg a;
+
+	a.ncall = ncall;
+	a.hist = hist;
+	thread_id = malloc(nthread*sizeof thread_id[0]);
+	if(thread_id == 0)
+		return -1;
+	for(n=0; n<nthread; n++)
+		if(pthread_create(&thread_id[n], 0, benchThread, &a) != 0)
+			break;
+	for(i=0; i<n; i++)
+		pthread_join(thread_id[i], 0);
+	free(thread_id);
+	return n == nthread ? 0 : -1;
+}
@@ -5,6 +5,7 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <process.h>
+#include <stdlib.h>
 #include "_cgo_export.h"
 
 __stdcall
@@ -35,3 +36,69 @@ doAdd(int max, int nthread)
 		CloseHandle((HANDLE)thread_id[i]);
 	}
 }
+
+// benchNow returns the time in nanoseconds.
+static int64_t
+benchNow(void)
+{
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER t;
+
+	if(freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (int64_t)((double)t.QuadPart * 1e9 / freq.QuadPart);
+}
+
+typedef struct {
+	int ncall;
+	uint64_t *hist;
+} BenchArg;
+
+__stdcall
+static unsigned int
+benchThread(void *p)
+{
+	BenchArg *a;
+	int i, b;
+	int64_t t, d;
+
+	a = p;
+	for(i=0; i<a->ncall; i++) {
+		t = benchNow();
+		BenchAdd(i);
+		d = benchNow() - t;
+		for(b=0; d>0 && b<BenchBuckets-1; b++)
+			d >>= 1;
+		__sync_fetch_and_add(&a->hist[b], 1);
+	}
+	return 0;
+}
+
+// benchAdd makes ncall calls to BenchAdd from each of nthread new
+// threads, counting how long each call took in hist; see cthread.go.
+// It returns -1 if it could not start all the threads.
+int
+benchAdd(int ncall, int nthread, uint64_t *hist)
+{
+	int i, n;
+	uintptr_t *thread_id;
+	BenchArg a;
+
+	a.ncall = ncall;
+	a.hist = hist;
+	thread_id = malloc(nthread*sizeof thread_id[0]);
+	if(thread_id == 0)
+		return -1;
+	for(n=0; n<nthread; n++) {
+		thread_id[n] = _beginthreadex(0, 0, benchThread, &a, 0, 0);
+		if(thread_id[n] == 0)
+			break;
+	}
+	for(i=0; i<n; i++) {
+		WaitForSingleObject((HANDLE)thread_id[i], INFINITE);
+		CloseHandle((HANDLE)thread_id[i]);
+	}
+	free(thread_id);
+	return n == nthread ? 0 : -1;
+}
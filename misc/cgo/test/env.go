@@ -39,3 +39,39 @@ func testSetEnv(t *testing.T) {
 		t.Fatalf("getenv() = %q; want %q", vs, val)
 	}
 }
+
+func testSetEnvs(t *testing.T) {
+	if runtime.GOOS == "windows" {
+		// See testSetEnv.
+		t.Logf("skipping test")
+		return
+	}
+	const key1 = "CGO_OS_TEST_KEY1"
+	const key2 = "CGO_OS_TEST_KEY2"
+	os.Setenv(key2, "old")
+	if err := os.Setenvs([]string{key1 + "=a=b", key2}); err != nil {
+		t.Fatal(err)
+	}
+	for _, kv := range []struct {
+		key, val string
+		set      bool
+	}{
+		{key1, "a=b", true},
+		{key2, "", false},
+	} {
+		keyc := C.CString(kv.key)
+		v := C.getenv(keyc)
+		C.free(unsafe.Pointer(keyc))
+		switch {
+		case uintptr(unsafe.Pointer(v)) == 0:
+			if kv.set {
+				t.Errorf("getenv(%q) returned NULL", kv.key)
+			}
+		case !kv.set:
+			t.Errorf("getenv(%q) = %q; want NULL", kv.key, C.GoString(v))
+		case C.GoString(v) != kv.val:
+			t.Errorf("getenv(%q) = %q; want %q", kv.key, C.GoString(v), kv.val)
+		}
+	}
+	os.Unsetenv(key1)
+}
@@ -0,0 +1,52 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test that calls from C to exported Go functions with scalar,
+// string and pointer arguments and results do not allocate.
+
+/*
+extern void exportAllocCall(int);
+*/
+import "C"
+
+import "testing"
+
+//export exportAllocInt
+func exportAllocInt(x C.int) C.int {
+	return x + 1
+}
+
+//export exportAllocString
+func exportAllocString(s string) int {
+	return len(s)
+}
+
+//export exportAllocStringResult
+func exportAllocStringResult(i int) string {
+	return "result"
+}
+
+//export exportAllocPtr
+func exportAllocPtr(p *C.char) *C.char {
+	return p
+}
+
+//export exportAllocMulti
+func exportAllocMulti(s string, x C.int) (string, *C.char, C.int) {
+	return s, nil, x
+}
+
+func testExportAlloc(t *testing.T) {
+	C.exportAllocCall(1)
+	if n := testing.AllocsPerRun(100, func() { C.exportAllocCall(10) }); n != 0 {
+		t.Errorf("got %v allocs per call of exported functions, want 0", n)
+	}
+}
+
+func benchExportAlloc(b *testing.B) {
+	b.ReportAllocs()
+	C.exportAllocCall(C.int(b.N))
+}
@@ -0,0 +1,23 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "_cgo_export.h"
+
+void
+exportAllocCall(int n)
+{
+	static char c;
+	GoString s = {"hello", 5};
+	struct exportAllocMulti_return r;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		exportAllocInt(i);
+		exportAllocString(s);
+		exportAllocStringResult(i);
+		exportAllocPtr(&c);
+		r = exportAllocMulti(s, i);
+		(void)r;
+	}
+}
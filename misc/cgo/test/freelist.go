@@ -0,0 +1,57 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test freeing C memory in bulk with a runtime/cgo FreeList.
+
+/*
+#include <stdlib.h>
+*/
+import "C"
+
+import (
+	"runtime/cgo"
+	"testing"
+	"unsafe"
+)
+
+func testFreeList(t *testing.T) {
+	var l cgo.FreeList
+	l.Free() // an empty list is fine
+
+	for round := 0; round < 2; round++ {
+		const n = 10000
+		for i := 0; i < n; i++ {
+			l.Add(unsafe.Pointer(C.CString("hello")))
+		}
+		l.Add(C.malloc(1 << 20))
+		l.Add(nil)
+		if got := l.Len(); got != n+2 {
+			t.Errorf("round %d: Len = %d, want %d", round, got, n+2)
+		}
+		l.Free()
+		if got := l.Len(); got != 0 {
+			t.Errorf("round %d: Len after Free = %d, want 0", round, got)
+		}
+	}
+}
+
+func benchFreeList(b *testing.B) {
+	b.Run("Free", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			C.free(unsafe.Pointer(C.CString("hello, world")))
+		}
+	})
+	b.Run("FreeList", func(b *testing.B) {
+		var l cgo.FreeList
+		for i := 0; i < b.N; i++ {
+			l.Add(unsafe.Pointer(C.CString("hello, world")))
+			if i%1000 == 999 {
+				l.Free()
+			}
+		}
+		l.Free()
+	})
+}
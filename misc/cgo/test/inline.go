@@ -0,0 +1,66 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test static inline accessors, which cgo writes in Go.
+
+/*
+#include <errno.h>
+
+struct inlinePoint {
+	int x;
+	double y;
+	char c;
+	struct inlinePoint *next;
+};
+
+typedef struct inlinePoint inlinePoint;
+
+static inline int inlineX(struct inlinePoint *p) { return p->x; }
+static inline double inlineY(const inlinePoint *p) { return p->y; }
+static inline long inlineC(struct inlinePoint p) { return p.c; }
+static inline struct inlinePoint *inlineNext(struct inlinePoint *p) { return p->next; }
+static inline int inlineVersion(void) { return 0x1234; }
+
+// Not accessors: called in C.
+static inline int inlineSum(struct inlinePoint *p) { return p->x + p->c; }
+static inline int inlineErrno(struct inlinePoint *p) { errno = p->x; return -1; }
+*/
+import "C"
+
+import (
+	"syscall"
+	"testing"
+)
+
+func testInlineAccessor(t *testing.T) {
+	var q C.struct_inlinePoint
+	q.x = 9
+	// p points to Go memory that holds a Go pointer, which
+	// could not be passed to C.
+	p := &C.inlinePoint{x: 3, y: 1.5, c: 7, next: &q}
+	if got := C.inlineX(p); got != 3 {
+		t.Errorf("inlineX = %d, want 3", got)
+	}
+	if got := C.inlineY(p); got != 1.5 {
+		t.Errorf("inlineY = %v, want 1.5", got)
+	}
+	if got := C.inlineC(*p); got != 7 {
+		t.Errorf("inlineC = %d, want 7", got)
+	}
+	if got := C.inlineNext(p); got != &q {
+		t.Errorf("inlineNext = %p, want %p", got, &q)
+	}
+	if got := C.inlineVersion(); got != 0x1234 {
+		t.Errorf("inlineVersion = %#x, want 0x1234", got)
+	}
+	if got := C.inlineSum(&q); got != 9 {
+		t.Errorf("inlineSum = %d, want 9", got)
+	}
+	q.x = C.int(syscall.EINVAL)
+	if _, err := C.inlineErrno(&q); err != syscall.EINVAL {
+		t.Errorf("inlineErrno error = %v, want %v", err, syscall.EINVAL)
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test GoInvokeAsync and the Name_async functions: calls from C
+// queued for a goroutine, without waiting for them.
+
+/*
+extern void invokeAsync(int id, int n);
+*/
+import "C"
+
+import (
+	"sync"
+	"testing"
+	"time"
+)
+
+type asyncCall struct {
+	id, seq int
+}
+
+var asyncCalls = make(chan asyncCall, 1000)
+
+//export asyncNotify
+func asyncNotify(id, seq C.int) {
+	asyncCalls <- asyncCall{int(id), int(seq)}
+}
+
+func testInvokeAsync(t *testing.T) {
+	const (
+		producers = 4
+		n         = 100
+	)
+	var wg sync.WaitGroup
+	for id := 0; id < producers; id++ {
+		wg.Add(1)
+		go func(id int) {
+			defer wg.Done()
+			C.invokeAsync(C.int(id), n)
+		}(id)
+	}
+	wg.Wait()
+
+	// The calls from each producer run in the order they were queued.
+	var next [producers]int
+	for i := 0; i < producers*n; i++ {
+		select {
+		case c := <-asyncCalls:
+			if c.seq != next[c.id] {
+				t.Fatalf("producer %d: got call %d, want %d", c.id, c.seq, next[c.id])
+			}
+			next[c.id]++
+		case <-time.After(10 * time.Second):
+			t.Fatalf("timed out after %d calls", i)
+		}
+	}
+}
@@ -0,0 +1,23 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "_cgo_export.h"
+
+void
+invokeAsync(int id, int n)
+{
+	GoCall call;
+	struct asyncNotify_frame frame;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (i%2 == 0) {
+			asyncNotify_async(id, i);
+		} else {
+			// The frame is copied, so it can be reused at once.
+			asyncNotify_call(&call, &frame, id, i);
+			GoInvokeAsync(&call);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test GoInvokeVector: a batch of calls from C to exported Go
+// functions made with a single transition into Go.
+
+/*
+extern int invokeVector(int n);
+*/
+import "C"
+
+import "testing"
+
+var vecLog []string
+
+//export vecAdd
+func vecAdd(x, y C.int) C.int {
+	return x + y
+}
+
+//export vecLogString
+func vecLogString(s string) {
+	vecLog = append(vecLog, s)
+}
+
+//export vecDivMod
+func vecDivMod(x, y C.int) (C.int, C.int) {
+	return x / y, x % y
+}
+
+func testInvokeVector(t *testing.T) {
+	vecLog = nil
+	const n = 10
+	got := C.invokeVector(n)
+	// invokeVector sums vecAdd(i, 100) and both results of
+	// vecDivMod(i+7, 3) for i in [0, n).
+	want := 0
+	for i := 0; i < n; i++ {
+		want += i + 100 + (i+7)/3 + (i+7)%3
+	}
+	if int(got) != want {
+		t.Errorf("invokeVector(%d) = %d, want %d", n, got, want)
+	}
+	if len(vecLog) != n {
+		t.Fatalf("vecLogString called %d times, want %d", len(vecLog), n)
+	}
+	for i, s := range vecLog {
+		if want := string('a' + rune(i)); s != want {
+			t.Errorf("call %d logged %q, want %q", i, s, want)
+		}
+	}
+}
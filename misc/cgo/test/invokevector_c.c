@@ -0,0 +1,43 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "_cgo_export.h"
+
+enum {
+	MaxCalls = 16,
+};
+
+// The strings passed to vecLogString, which keeps them after
+// invokeVector returns.
+static char letters[MaxCalls] = "abcdefghijklmnop";
+
+int
+invokeVector(int n)
+{
+	GoCall calls[3*MaxCalls];
+	struct vecAdd_frame add[MaxCalls];
+	struct vecLogString_frame log[MaxCalls];
+	struct vecDivMod_frame divmod[MaxCalls];
+	GoString s;
+	int i, nc, sum;
+
+	if (n > MaxCalls) {
+		n = MaxCalls;
+	}
+	nc = 0;
+	for (i = 0; i < n; i++) {
+		vecAdd_call(&calls[nc++], &add[i], i, 100);
+		s.p = &letters[i];
+		s.n = 1;
+		vecLogString_call(&calls[nc++], &log[i], s);
+		vecDivMod_call(&calls[nc++], &divmod[i], i+7, 3);
+	}
+	GoInvokeVector(calls, nc);
+
+	sum = 0;
+	for (i = 0; i < n; i++) {
+		sum += add[i].r0 + divmod[i].r0 + divmod[i].r1;
+	}
+	return sum;
+}
@@ -0,0 +1,149 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test reads and writes in bulk with runtime/cgo.IOBatch.
+
+import (
+	"bytes"
+	"fmt"
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"runtime/cgo"
+	"syscall"
+	"testing"
+)
+
+// ioBatchFiles creates n small files in a new directory, returning
+// the directory and the open files.
+func ioBatchFiles(tb testing.TB, n, size int) (string, []*os.File) {
+	dir, err := ioutil.TempDir("", "cgotest-iobatch")
+	if err != nil {
+		tb.Fatal(err)
+	}
+	var files []*os.File
+	for i := 0; i < n; i++ {
+		name := filepath.Join(dir, fmt.Sprint(i))
+		data := bytes.Repeat([]byte{byte(i)}, size)
+		if err := ioutil.WriteFile(name, data, 0666); err != nil {
+			tb.Fatal(err)
+		}
+		f, err := os.Open(name)
+		if err != nil {
+			tb.Fatal(err)
+		}
+		files = append(files, f)
+	}
+	return dir, files
+}
+
+func testIOBatch(t *testing.T) {
+	const size = 100
+	dir, files := ioBatchFiles(t, 50, size)
+	defer os.RemoveAll(dir)
+
+	// Smaller than the number of files, so that Submit goes in parts.
+	b := cgo.NewIOBatch(16)
+	if b == nil {
+		t.Fatal("NewIOBatch failed")
+	}
+	defer b.Close()
+
+	ops := make([]cgo.IOOp, len(files))
+	for i, f := range files {
+		ops[i] = cgo.IOOp{Fd: int(f.Fd()), Buf: make([]byte, size+1), Off: 0}
+	}
+	ops[1].Off = 10
+	ops[2].Off = -1
+	b.Submit(ops)
+	for i, op := range ops {
+		want := size
+		if i == 1 {
+			want = size - 10
+		}
+		if op.Errno != 0 || op.N != want {
+			t.Fatalf("op %d: N=%d Errno=%v, want N=%d", i, op.N, syscall.Errno(op.Errno), want)
+		}
+		if !bytes.Equal(op.Buf[:op.N], bytes.Repeat([]byte{byte(i)}, want)) {
+			t.Fatalf("op %d: read wrong data", i)
+		}
+	}
+	// The read at the current offset moved it.
+	if off, _ := files[2].Seek(0, os.SEEK_CUR); off != size {
+		t.Errorf("offset after read at current offset = %d, want %d", off, size)
+	}
+	for _, f := range files {
+		f.Close()
+	}
+
+	// Writes, at given offsets and at the current offset, and a
+	// read from a closed descriptor.
+	w, err := os.Create(filepath.Join(dir, "w"))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer w.Close()
+	ops = []cgo.IOOp{
+		{Fd: int(w.Fd()), Write: true, Buf: []byte("world"), Off: 6},
+		{Fd: int(files[0].Fd()), Buf: make([]byte, 1), Off: 0},
+	}
+	b.Submit(ops)
+	if ops[0].Errno != 0 || ops[0].N != 5 {
+		t.Errorf("write: N=%d Errno=%v", ops[0].N, syscall.Errno(ops[0].Errno))
+	}
+	if syscall.Errno(ops[1].Errno) != syscall.EBADF {
+		t.Errorf("read from closed file: Errno=%v, want EBADF", syscall.Errno(ops[1].Errno))
+	}
+	b.Submit([]cgo.IOOp{{Fd: int(w.Fd()), Write: true, Buf: []byte("hello "), Off: -1}})
+	data, err := ioutil.ReadFile(w.Name())
+	if err != nil {
+		t.Fatal(err)
+	}
+	if string(data) != "hello world" {
+		t.Errorf("file holds %q, want %q", data, "hello world")
+	}
+}
+
+func benchIOBatch(b *testing.B) {
+	const n, size = 64, 512
+	dir, files := ioBatchFiles(b, n, size)
+	defer os.RemoveAll(dir)
+	defer func() {
+		for _, f := range files {
+			f.Close()
+		}
+	}()
+
+	bufs := make([][]byte, n)
+	for i := range bufs {
+		bufs[i] = make([]byte, size)
+	}
+	b.Run("ReadAt", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for j, f := range files {
+				if _, err := f.ReadAt(bufs[j], 0); err != nil {
+					b.Fatal(err)
+				}
+			}
+		}
+	})
+	b.Run("IOBatch", func(b *testing.B) {
+		batch := cgo.NewIOBatch(n)
+		defer batch.Close()
+		ops := make([]cgo.IOOp, n)
+		for i := 0; i < b.N; i++ {
+			for j, f := range files {
+				ops[j] = cgo.IOOp{Fd: int(f.Fd()), Buf: bufs[j]}
+			}
+			batch.Submit(ops)
+			for j := range ops {
+				if ops[j].Errno != 0 {
+					b.Fatal(syscall.Errno(ops[j].Errno))
+				}
+			}
+		}
+	})
+}
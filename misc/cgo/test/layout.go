@@ -0,0 +1,83 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo layout: types, Go structs passed to C as C structs.
+
+/*
+#cgo layout: layoutPoint=struct_layout_point layoutSeg=layout_seg
+
+#include <stdint.h>
+
+struct layout_point {
+	int32_t x;
+	int32_t y;
+	double w;
+};
+
+typedef struct {
+	struct layout_point a, b;
+	char tag[3];
+} layout_seg;
+
+static double layoutSum(struct layout_point *p, int n) {
+	double sum = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		sum += (p[i].x + p[i].y) * p[i].w;
+	}
+	return sum;
+}
+
+static int layoutTag(layout_seg *s) {
+	return s->tag[0] + s->tag[2] + s->b.y;
+}
+*/
+import "C"
+
+import "testing"
+
+type layoutPoint struct {
+	X, Y int32
+	W    float64
+}
+
+type layoutSeg struct {
+	A, B layoutPoint
+	Tag  [3]C.char
+}
+
+func testLayout(t *testing.T) {
+	pts := make([]layoutPoint, 100)
+	want := 0.0
+	for i := range pts {
+		pts[i] = layoutPoint{int32(i), 1, 0.5}
+		want += float64(i+1) * 0.5
+	}
+	if got := C.layoutSum(&pts[0], C.int(len(pts))); float64(got) != want {
+		t.Errorf("layoutSum = %v, want %v", got, want)
+	}
+
+	// C.struct_layout_point is layoutPoint.
+	var p C.struct_layout_point = pts[3]
+	if p.X != 3 {
+		t.Errorf("p.X = %d, want 3", p.X)
+	}
+
+	s := &layoutSeg{B: layoutPoint{Y: 100}, Tag: [3]C.char{1, 2, 3}}
+	if got := C.layoutTag(s); got != 104 {
+		t.Errorf("layoutTag = %d, want 104", got)
+	}
+
+	// The pointers passed to C have no pointer checks, so the calls
+	// do not allocate.
+	n := testing.AllocsPerRun(100, func() {
+		C.layoutSum(&pts[0], C.int(len(pts)))
+	})
+	if n != 0 {
+		t.Errorf("layoutSum allocated %v times per call", n)
+	}
+}
@@ -0,0 +1,90 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo leaf: functions, called from Go without the
+// system call transitions.
+
+/*
+#cgo leaf: leafAdd leafFail leafCRC
+
+#include <errno.h>
+#include <stddef.h>
+
+static int leafAdd(int x, int y) {
+	return x + y;
+}
+
+static int leafFail(int e) {
+	errno = e;
+	return -1;
+}
+
+static unsigned int leafCRC(const unsigned char *p, size_t n) {
+	unsigned int crc = ~0U;
+	size_t i;
+	int k;
+
+	for (i = 0; i < n; i++) {
+		crc ^= p[i];
+		for (k = 0; k < 8; k++) {
+			crc = (crc >> 1) ^ (0xedb88320U & -(crc & 1));
+		}
+	}
+	return ~crc;
+}
+*/
+import "C"
+
+import (
+	"hash/crc32"
+	"runtime"
+	"sync"
+	"syscall"
+	"testing"
+	"unsafe"
+)
+
+func testLeaf(t *testing.T) {
+	if got := C.leafAdd(2, 3); got != 5 {
+		t.Errorf("leafAdd(2, 3) = %d, want 5", got)
+	}
+
+	_, err := C.leafFail(C.int(syscall.EINVAL))
+	if err != syscall.EINVAL {
+		t.Errorf("leafFail(EINVAL) error = %v, want %v", err, syscall.EINVAL)
+	}
+
+	// Call from many goroutines while the garbage collector runs,
+	// which has to wait for the leaf calls to return.
+	buf := []byte("The quick brown fox jumps over the lazy dog")
+	want := crc32.ChecksumIEEE(buf)
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 1000; j++ {
+				p := (*C.uchar)(unsafe.Pointer(&buf[0]))
+				if got := uint32(C.leafCRC(p, C.size_t(len(buf)))); got != want {
+					t.Errorf("leafCRC = %#x, want %#x", got, want)
+					return
+				}
+			}
+		}()
+	}
+	for i := 0; i < 10; i++ {
+		runtime.GC()
+	}
+	wg.Wait()
+}
+
+func benchCgoLeafCall(b *testing.B) {
+	const x = C.int(2)
+	const y = C.int(3)
+	for i := 0; i < b.N; i++ {
+		C.leafAdd(x, y)
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+package cgotest
+
+// Test #cgo limit: functions, of which only so many calls may be in C
+// at once.
+
+/*
+#cgo batch: limitSleep
+#cgo limit: limitSleep,limitSleepErr=3
+
+#include <errno.h>
+#include <unistd.h>
+
+static int limitIn, limitMax;
+
+static int limitSleep(int usec) {
+	int n, max;
+
+	n = __sync_add_and_fetch(&limitIn, 1);
+	do {
+		max = limitMax;
+	} while (n > max && !__sync_bool_compare_and_swap(&limitMax, max, n));
+	usleep(usec);
+	__sync_sub_and_fetch(&limitIn, 1);
+	return n;
+}
+
+static int limitSleepErr(int usec) {
+	limitSleep(usec);
+	errno = EAGAIN;
+	return -1;
+}
+
+static int limitMaxIn(void) {
+	return limitMax;
+}
+*/
+import "C"
+
+import (
+	"sync"
+	"syscall"
+	"testing"
+)
+
+func testLimit(t *testing.T) {
+	var wg sync.WaitGroup
+	for i := 0; i < 20; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			for j := 0; j < 10; j++ {
+				switch (i + j) % 3 {
+				case 0:
+					C.limitSleep(200)
+				case 1:
+					if _, err := C.limitSleepErr(200); err != syscall.EAGAIN {
+						t.Errorf("limitSleepErr: got error %v, want EAGAIN", err)
+					}
+				case 2:
+					C.batch_limitSleep([]C.int{100, 100}, make([]C.int, 2))
+				}
+			}
+		}(i)
+	}
+	wg.Wait()
+	if max := C.limitMaxIn(); max > 3 || max < 1 {
+		t.Errorf("%d calls in C at once, want 1 to 3", max)
+	}
+}
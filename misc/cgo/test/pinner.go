@@ -0,0 +1,86 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test that C code can keep a pointer to a pinned Go buffer.
+
+/*
+#include <stddef.h>
+#include <stdlib.h>
+
+static unsigned char *pinnedBuf;
+static size_t pinnedLen;
+
+static void pinnedKeep(unsigned char *p, size_t n) {
+	pinnedBuf = p;
+	pinnedLen = n;
+}
+
+static unsigned int pinnedSum(void) {
+	unsigned int sum = 0;
+	size_t i;
+
+	for (i = 0; i < pinnedLen; i++) {
+		sum += pinnedBuf[i];
+	}
+	return sum;
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"testing"
+)
+
+func testPinner(t *testing.T) {
+	buf := make([]byte, 1<<16)
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	pinner.Pin(&buf[0])
+
+	C.pinnedKeep((*C.uchar)(&buf[0]), C.size_t(len(buf)))
+	defer C.pinnedKeep(nil, 0)
+
+	// C holds on to the buffer across calls and collections,
+	// and sees Go's writes to it.
+	for i := 0; i < 3; i++ {
+		runtime.GC()
+		for j := range buf {
+			buf[j] = byte(i)
+		}
+		if got, want := C.pinnedSum(), C.uint(i*len(buf)); got != want {
+			t.Errorf("round %d: pinnedSum() = %d, want %d", i, got, want)
+		}
+	}
+}
+
+// benchPinner compares two ways to give C a buffer it can keep using
+// after the call returns: copying it to C memory, and pinning it.
+func benchPinner(b *testing.B) {
+	const size = 1 << 20
+	buf := make([]byte, size)
+	b.Run("CBytes", func(b *testing.B) {
+		b.SetBytes(size)
+		for i := 0; i < b.N; i++ {
+			p := C.CBytes(buf)
+			C.pinnedKeep((*C.uchar)(p), size)
+			C.pinnedSum()
+			C.pinnedKeep(nil, 0)
+			C.free(p)
+		}
+	})
+	b.Run("Pinner", func(b *testing.B) {
+		b.SetBytes(size)
+		for i := 0; i < b.N; i++ {
+			var pinner runtime.Pinner
+			pinner.Pin(&buf[0])
+			C.pinnedKeep((*C.uchar)(&buf[0]), size)
+			C.pinnedSum()
+			C.pinnedKeep(nil, 0)
+			pinner.Unpin()
+		}
+	})
+}
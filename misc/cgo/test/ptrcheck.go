@@ -0,0 +1,79 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test pointer arguments that take the checks cmd/cgo specializes
+// by parameter type.
+
+/*
+#include <stdlib.h>
+
+struct ptrCheckS {
+	char *p;
+	int n;
+};
+
+static int ptrCheckDeref(char **p) {
+	return *p != NULL;
+}
+
+static int ptrCheckStruct(struct ptrCheckS *s) {
+	return s->n;
+}
+
+static int ptrCheckUnsafe(void *p) {
+	return p != NULL;
+}
+*/
+import "C"
+
+import (
+	"testing"
+	"unsafe"
+)
+
+type ptrCheckT struct {
+	s C.struct_ptrCheckS
+	x *int
+}
+
+func testPtrCheck(t *testing.T) {
+	// A C pointer.
+	cp := (**C.char)(C.malloc(C.size_t(unsafe.Sizeof((*C.char)(nil)))))
+	defer C.free(unsafe.Pointer(cp))
+	*cp = nil
+	if C.ptrCheckDeref(cp) != 0 {
+		t.Error("ptrCheckDeref(C pointer) != 0")
+	}
+
+	// A Go pointer to a C pointer.
+	var gp *C.char = (*C.char)(unsafe.Pointer(cp))
+	if C.ptrCheckDeref(&gp) == 0 {
+		t.Error("ptrCheckDeref(Go pointer) == 0")
+	}
+
+	// The address of a field, which only checks that field even
+	// though the enclosing struct has a Go pointer.
+	v := &ptrCheckT{s: C.struct_ptrCheckS{n: 7}, x: new(int)}
+	if got := C.ptrCheckStruct(&v.s); got != 7 {
+		t.Errorf("ptrCheckStruct = %d, want 7", got)
+	}
+
+	if C.ptrCheckUnsafe(unsafe.Pointer(new(int))) == 0 {
+		t.Error("ptrCheckUnsafe(Go pointer) == 0")
+	}
+	if C.ptrCheckUnsafe(nil) != 0 {
+		t.Error("ptrCheckUnsafe(nil) != 0")
+	}
+}
+
+func benchCgoCallPtrCheck(b *testing.B) {
+	cp := (**C.char)(C.malloc(C.size_t(unsafe.Sizeof((*C.char)(nil)))))
+	defer C.free(unsafe.Pointer(cp))
+	*cp = nil
+	for i := 0; i < b.N; i++ {
+		C.ptrCheckDeref(cp)
+	}
+}
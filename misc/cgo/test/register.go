@@ -0,0 +1,48 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+package cgotest
+
+// Test GoRegisterThread: a registered C thread keeps its M, and with it
+// the goroutine that runs its calls into Go, until it unregisters.
+
+/*
+extern int registerThread(int);
+*/
+import "C"
+
+import (
+	"bytes"
+	"runtime"
+	"testing"
+)
+
+var registerGoids []string
+
+//export registerGo
+func registerGo() {
+	var buf [64]byte
+	n := runtime.Stack(buf[:], false)
+	registerGoids = append(registerGoids, string(bytes.Fields(buf[:n])[1]))
+}
+
+func testRegisterThread(t *testing.T) {
+	if runtime.GOOS == "openbsd" {
+		t.Skip("GoRegisterThread not supported on OpenBSD")
+	}
+	registerGoids = nil
+	if r := C.registerThread(10); r != 0 {
+		t.Fatalf("registerThread failed at step %d", r)
+	}
+	if len(registerGoids) != 30 {
+		t.Fatalf("%d calls into Go, want 30", len(registerGoids))
+	}
+	for i, id := range registerGoids[:20] {
+		if id != registerGoids[0] {
+			t.Errorf("call %d of registered thread ran on goroutine %s, want %s", i, id, registerGoids[0])
+		}
+	}
+}
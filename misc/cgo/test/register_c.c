@@ -0,0 +1,48 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+#include <pthread.h>
+#include <stdint.h>
+#include "_cgo_export.h"
+
+static void*
+registerLoop(void *p)
+{
+	int i, n;
+
+	n = (int)(intptr_t)p;
+	if(!GoRegisterThread())
+		return (void*)1;
+	// Registering again is allowed.
+	if(!GoRegisterThread())
+		return (void*)2;
+	for(i=0; i<n; i++)
+		registerGo();
+	// Another C thread's calls into Go take and give back an M
+	// meanwhile, which must not be this thread's.
+	transCallbackThread(1);
+	for(i=0; i<n; i++)
+		registerGo();
+	GoUnregisterThread();
+	GoUnregisterThread();
+	for(i=0; i<n; i++)
+		registerGo();
+	// Exit bound, leaving the M to the thread exit hook.
+	if(!GoRegisterThread())
+		return (void*)3;
+	return 0;
+}
+
+int
+registerThread(int n)
+{
+	pthread_t tid;
+	void *r;
+
+	pthread_create(&tid, 0, registerLoop, (void*)(intptr_t)n);
+	pthread_join(tid, &r);
+	return (int)(intptr_t)r;
+}
@@ -0,0 +1,78 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+package cgotest
+
+// Test runtime/cgo.Ring: C threads push to a ring that a goroutine
+// pops from.
+
+/*
+#include <stdint.h>
+
+typedef struct {
+	int32_t producer;
+	int32_t seq;
+} RingItem;
+
+extern void ringStart(void*, int, int);
+extern void ringWait(void);
+*/
+import "C"
+
+import (
+	"runtime/cgo"
+	"testing"
+	"unsafe"
+)
+
+func testRing(t *testing.T) {
+	const (
+		producers = 4
+		items     = 10000
+	)
+	// A small ring, so that the producers fill it and the
+	// goroutine waits for them.
+	r := cgo.NewRing(int(unsafe.Sizeof(C.RingItem{})), 16)
+	if r == nil {
+		t.Fatal("NewRing failed")
+	}
+	defer r.Close()
+	C.ringStart(r.C(), producers, items)
+	defer C.ringWait()
+
+	var next [producers]int32
+	buf := make([]byte, unsafe.Sizeof(C.RingItem{}))
+	for i := 0; i < producers*items; i++ {
+		r.Pop(buf)
+		item := (*C.RingItem)(unsafe.Pointer(&buf[0]))
+		p, seq := int32(item.producer), int32(item.seq)
+		if p < 0 || p >= producers {
+			t.Fatalf("item %d from producer %d", i, p)
+		}
+		if seq != next[p] {
+			t.Fatalf("item %d from producer %d: seq %d, want %d", i, p, seq, next[p])
+		}
+		next[p]++
+	}
+	if r.TryPop(buf) {
+		t.Errorf("TryPop succeeded after the last item")
+	}
+}
+
+// benchRing measures the time per item streamed from a C thread to a
+// goroutine through a ring, to compare with a call into Go per item,
+// as in BenchmarkCgoTransitions/callback-needm.
+func benchRing(b *testing.B) {
+	r := cgo.NewRing(int(unsafe.Sizeof(C.RingItem{})), 1024)
+	defer r.Close()
+	b.ReportAllocs()
+	C.ringStart(r.C(), 1, C.int(b.N))
+	buf := make([]byte, unsafe.Sizeof(C.RingItem{}))
+	for i := 0; i < b.N; i++ {
+		r.Pop(buf)
+	}
+	C.ringWait()
+}
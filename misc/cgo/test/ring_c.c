@@ -0,0 +1,72 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+#include <pthread.h>
+#include <sched.h>
+#include "_cgo_export.h"
+
+typedef struct {
+	int32_t producer;
+	int32_t seq;
+} RingItem;
+
+enum { MaxProducers = 16 };
+
+static pthread_t ringThreads[MaxProducers];
+static int ringNthread;
+
+typedef struct {
+	GoRing *ring;
+	int producer;
+	int n;
+} RingArg;
+
+static RingArg ringArgs[MaxProducers];
+
+static void*
+ringProduce(void *p)
+{
+	RingArg *a;
+	RingItem item;
+	int i;
+
+	a = p;
+	item.producer = a->producer;
+	for(i=0; i<a->n; i++) {
+		item.seq = i;
+		while(!GoRingPush(a->ring, &item))
+			sched_yield();
+	}
+	return 0;
+}
+
+// ringStart starts nthread threads that each push n items to ring.
+void
+ringStart(void *ring, int nthread, int n)
+{
+	int i;
+
+	if(nthread > MaxProducers)
+		nthread = MaxProducers;
+	for(i=0; i<nthread; i++) {
+		ringArgs[i].ring = ring;
+		ringArgs[i].producer = i;
+		ringArgs[i].n = n;
+		pthread_create(&ringThreads[i], 0, ringProduce, &ringArgs[i]);
+	}
+	ringNthread = nthread;
+}
+
+// ringWait waits for the threads started by ringStart.
+void
+ringWait(void)
+{
+	int i;
+
+	for(i=0; i<ringNthread; i++)
+		pthread_join(ringThreads[i], 0);
+	ringNthread = 0;
+}
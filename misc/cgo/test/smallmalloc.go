@@ -0,0 +1,126 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test small C allocations from the per-P caches of runtime/cgo.Malloc.
+
+/*
+#include <stdlib.h>
+#include <string.h>
+
+struct mallocNode {
+	struct mallocNode *next;
+	double value;
+};
+
+static double mallocListSum(struct mallocNode *n) {
+	double sum = 0;
+
+	for (; n != NULL; n = n->next) {
+		sum += n->value;
+	}
+	return sum;
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"runtime/cgo"
+	"sync"
+	"testing"
+	"unsafe"
+)
+
+func testSmallMalloc(t *testing.T) {
+	for round := 0; round < 2; round++ {
+		const n = 10000
+		var head *C.struct_mallocNode
+		for i := 0; i < n; i++ {
+			node := (*C.struct_mallocNode)(cgo.Malloc(unsafe.Sizeof(C.struct_mallocNode{})))
+			if uintptr(unsafe.Pointer(node))%unsafe.Alignof(C.double(0)) != 0 {
+				t.Fatalf("Malloc returned misaligned pointer %p", node)
+			}
+			node.next = head
+			node.value = 1
+			head = node
+		}
+		if got := C.mallocListSum(head); got != n {
+			t.Errorf("round %d: list sum %v, want %d", round, got, n)
+		}
+		for head != nil {
+			next := head.next
+			cgo.Free(unsafe.Pointer(head))
+			head = next
+		}
+	}
+
+	// Every size class, and sizes past the largest.
+	var ptrs []unsafe.Pointer
+	for size := 0; size <= 1024; size++ {
+		p := cgo.Malloc(uintptr(size))
+		b := (*[1024]byte)(p)[:size:size]
+		for i := range b {
+			b[i] = byte(size)
+		}
+		ptrs = append(ptrs, p)
+	}
+	for size, p := range ptrs {
+		b := (*[1024]byte)(p)[:size:size]
+		for i := range b {
+			if b[i] != byte(size) {
+				t.Fatalf("allocation of %d bytes overwritten at %d", size, i)
+			}
+		}
+		cgo.Free(p)
+	}
+	cgo.Free(nil)
+
+	// Memory freed on one P and allocated on another.
+	defer runtime.GOMAXPROCS(runtime.GOMAXPROCS(4))
+	var wg sync.WaitGroup
+	ch := make(chan unsafe.Pointer, 100)
+	wg.Add(2)
+	go func() {
+		defer wg.Done()
+		for i := 0; i < 10000; i++ {
+			ch <- cgo.Malloc(24)
+		}
+		close(ch)
+	}()
+	go func() {
+		defer wg.Done()
+		for p := range ch {
+			cgo.Free(p)
+		}
+	}()
+	wg.Wait()
+}
+
+func benchSmallMalloc(b *testing.B) {
+	const size = 48
+	b.Run("malloc", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			C.free(C.malloc(size))
+		}
+	})
+	b.Run("Malloc", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			cgo.Free(cgo.Malloc(size))
+		}
+	})
+	// Many live objects, so that the caches are refilled.
+	b.Run("Malloc-batch", func(b *testing.B) {
+		ptrs := make([]unsafe.Pointer, 1000)
+		for i := 0; i < b.N; i += len(ptrs) {
+			for j := range ptrs {
+				ptrs[j] = cgo.Malloc(size)
+			}
+			for _, p := range ptrs {
+				cgo.Free(p)
+			}
+		}
+	})
+}
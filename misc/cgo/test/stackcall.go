@@ -0,0 +1,85 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test #cgo stack: functions, leaf functions that run on the
+// goroutine stack.
+
+/*
+#cgo stack: stackAdd=64 stackFill=8192 stackFail=64
+
+#include <errno.h>
+#include <string.h>
+
+static int stackAdd(int x, int y) {
+	return x + y;
+}
+
+// stackFill uses about 4096 bytes of stack, which a new goroutine
+// does not have, so the runtime must grow the stack first.
+static int stackFill(int c) {
+	volatile char buf[4096];
+	int i, sum;
+
+	memset((char*)buf, c, sizeof buf);
+	sum = 0;
+	for (i = 0; i < sizeof buf; i++) {
+		sum += buf[i];
+	}
+	return sum;
+}
+
+static int stackFail(int e) {
+	errno = e;
+	return -1;
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"sync"
+	"syscall"
+	"testing"
+)
+
+func testStackCall(t *testing.T) {
+	if got := C.stackAdd(2, 3); got != 5 {
+		t.Errorf("stackAdd(2, 3) = %d, want 5", got)
+	}
+
+	_, err := C.stackFail(C.int(syscall.EINVAL))
+	if err != syscall.EINVAL {
+		t.Errorf("stackFail(EINVAL) error = %v, want %v", err, syscall.EINVAL)
+	}
+
+	// Call from new goroutines, whose stacks are too small,
+	// while the garbage collector runs.
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func(c int) {
+			defer wg.Done()
+			for j := 0; j < 100; j++ {
+				if got := C.stackFill(C.int(c)); got != C.int(4096*c) {
+					t.Errorf("stackFill(%d) = %d, want %d", c, got, 4096*c)
+					return
+				}
+			}
+		}(i + 1)
+	}
+	for i := 0; i < 10; i++ {
+		runtime.GC()
+	}
+	wg.Wait()
+}
+
+func benchCgoStackCall(b *testing.B) {
+	const x = C.int(2)
+	const y = C.int(3)
+	for i := 0; i < b.N; i++ {
+		C.stackAdd(x, y)
+	}
+}
@@ -0,0 +1,96 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgotest
+
+// Test C function pointers bound to Go functions by
+// runtime/cgo.NewCallback.
+
+/*
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef int (*trampolineCmp)(const void *, const void *);
+typedef uintptr_t (*trampolineFn)(uintptr_t, uintptr_t);
+
+static void trampolineSort(int *p, int n, void *cmp) {
+	qsort(p, n, sizeof *p, (trampolineCmp)cmp);
+}
+
+static uintptr_t trampolineLoop(void *fn, int n) {
+	uintptr_t sum = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		sum += ((trampolineFn)fn)(i, 1);
+	}
+	return sum;
+}
+*/
+import "C"
+
+import (
+	"runtime/cgo"
+	"testing"
+	"unsafe"
+)
+
+func testNewCallback(t *testing.T) {
+	s := []C.int{5, -3, 8, 0, 2, 2, -7}
+	cmp := cgo.NewCallback(func(a *[cgo.CallbackArgs]uintptr) uintptr {
+		x := *(*C.int)(unsafe.Pointer(a[0]))
+		y := *(*C.int)(unsafe.Pointer(a[1]))
+		switch {
+		case x < y:
+			return ^uintptr(0) // -1
+		case x > y:
+			return 1
+		}
+		return 0
+	})
+	C.trampolineSort(&s[0], C.int(len(s)), cmp)
+	cgo.FreeCallback(cmp)
+	for i := 1; i < len(s); i++ {
+		if s[i-1] > s[i] {
+			t.Errorf("qsort with callback comparator: %v", s)
+			break
+		}
+	}
+
+	// Fill every slot, each with its own closure.
+	var cbs []unsafe.Pointer
+	for i := 0; i < cgo.MaxCallbacks; i++ {
+		i := i
+		cbs = append(cbs, cgo.NewCallback(func(a *[cgo.CallbackArgs]uintptr) uintptr {
+			return a[0] + a[1] + uintptr(i)
+		}))
+	}
+	func() {
+		defer func() {
+			if recover() == nil {
+				t.Error("NewCallback beyond MaxCallbacks did not panic")
+			}
+		}()
+		cgo.NewCallback(func(*[cgo.CallbackArgs]uintptr) uintptr { return 0 })
+	}()
+	for i, p := range cbs {
+		if got, want := C.trampolineLoop(p, 3), C.uintptr_t(0+1+2+3+3*i); got != want {
+			t.Errorf("callback %d: got %d, want %d", i, got, want)
+		}
+	}
+	for _, p := range cbs {
+		cgo.FreeCallback(p)
+	}
+}
+
+func benchNewCallback(b *testing.B) {
+	p := cgo.NewCallback(func(a *[cgo.CallbackArgs]uintptr) uintptr {
+		return a[1]
+	})
+	defer cgo.FreeCallback(p)
+	b.ResetTimer()
+	if got := C.trampolineLoop(p, C.int(b.N)); got != C.uintptr_t(b.N) {
+		b.Fatalf("got %d, want %d", got, b.N)
+	}
+}
@@ -0,0 +1,121 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+package cgotest
+
+// Benchmarks of each kind of transition between Go and C, for
+// comparing the runtime's cgo paths before and after a change:
+//
+//	go test -run=NONE -bench=CgoTransitions -count=10 >old.txt
+//	(change the runtime)
+//	go test -run=NONE -bench=CgoTransitions -count=10 >new.txt
+//	benchstat old.txt new.txt
+//
+// All of them report allocations. Only the pointer checks of Go
+// memory allocate, to pass the checked value to cgoCheckPointer.
+
+/*
+#include <stdlib.h>
+
+extern void transNop(void);
+extern void transPtr(void*);
+extern void transCallback(int);
+extern void transCallbackThread(int);
+extern void transCallbackRegistered(int);
+extern void transThreads(int);
+*/
+import "C"
+
+import (
+	"testing"
+	"unsafe"
+)
+
+//export transGo
+func transGo() {
+}
+
+func benchCgoTransitions(b *testing.B) {
+	// cgocall and back.
+	b.Run("call", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.transNop()
+		}
+	})
+
+	// cgocallbackg on a thread that is already in Go, as for a
+	// callback from C code that Go called.
+	b.Run("callback", func(b *testing.B) {
+		b.ReportAllocs()
+		C.transCallback(C.int(b.N))
+	})
+
+	// cgocallbackg on a thread created by C, which needs an M
+	// from needm for each call and gives it back with dropm.
+	b.Run("callback-needm", func(b *testing.B) {
+		b.ReportAllocs()
+		C.transCallbackThread(C.int(b.N))
+	})
+
+	// cgocallbackg on a thread created by C that has kept its M
+	// with GoRegisterThread, and so skips needm and dropm.
+	b.Run("callback-registered", func(b *testing.B) {
+		b.ReportAllocs()
+		C.transCallbackRegistered(C.int(b.N))
+	})
+
+	// A thread created by C that calls into Go once, as for C
+	// code that starts a thread per request.
+	b.Run("thread", func(b *testing.B) {
+		b.ReportAllocs()
+		C.transThreads(C.int(b.N))
+	})
+
+	// C.malloc, which is _CMalloc, and C.free.
+	b.Run("malloc", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.free(C.malloc(16))
+		}
+	})
+
+	// cgoCheckPointer for each kind of argument that it checks.
+	b.Run("ptrcheck/cmem", func(b *testing.B) {
+		p := C.malloc(16)
+		defer C.free(p)
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.transPtr(p)
+		}
+	})
+	b.Run("ptrcheck/scalar", func(b *testing.B) {
+		x := new(C.int)
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.transPtr(unsafe.Pointer(x))
+		}
+	})
+	b.Run("ptrcheck/array", func(b *testing.B) {
+		// Passing &s[0] checks the whole array.
+		s := make([]*C.int, 64)
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.transPtr(unsafe.Pointer(&s[0]))
+		}
+	})
+	b.Run("ptrcheck/field", func(b *testing.B) {
+		// Passing &v.n checks only the field.
+		v := new(struct {
+			p *C.int
+			n C.int
+		})
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			C.transPtr(unsafe.Pointer(&v.n))
+		}
+	})
+}
@@ -0,0 +1,71 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+#include <pthread.h>
+#include <stdint.h>
+#include "_cgo_export.h"
+
+void
+transNop(void)
+{
+}
+
+void
+transPtr(void *p)
+{
+}
+
+void
+transCallback(int n)
+{
+	int i;
+
+	for(i=0; i<n; i++)
+		transGo();
+}
+
+static void*
+transCallbackLoop(void *p)
+{
+	transCallback((int)(intptr_t)p);
+	return 0;
+}
+
+void
+transCallbackThread(int n)
+{
+	pthread_t tid;
+
+	pthread_create(&tid, 0, transCallbackLoop, (void*)(intptr_t)n);
+	pthread_join(tid, 0);
+}
+
+static void*
+transRegisteredLoop(void *p)
+{
+	GoRegisterThread();
+	transCallback((int)(intptr_t)p);
+	GoUnregisterThread();
+	return 0;
+}
+
+void
+transCallbackRegistered(int n)
+{
+	pthread_t tid;
+
+	pthread_create(&tid, 0, transRegisteredLoop, (void*)(intptr_t)n);
+	pthread_join(tid, 0);
+}
+
+void
+transThreads(int n)
+{
+	int i;
+
+	for(i=0; i<n; i++)
+		transCallbackThread(1);
+}
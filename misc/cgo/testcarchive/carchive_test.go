@@ -440,6 +440,69 @@ func TestSigaltstack(t *testing.T) {
 	}
 }
 
+func TestNetpollHost(t *testing.T) {
+	switch GOOS {
+	case "windows":
+		t.Skip("skipping poll test on Windows")
+	}
+
+	defer func() {
+		os.Remove("libgo7.a")
+		os.Remove("libgo7.h")
+		os.Remove("testp")
+		os.RemoveAll("pkg")
+	}()
+
+	cmd := exec.Command("go", "build", "-buildmode=c-archive", "-o", "libgo7.a", "libgo7")
+	cmd.Env = gopathEnv
+	if out, err := cmd.CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+
+	ccArgs := append(cc, "-I", ".", "-o", "testp"+exeSuffix, "main7.c", "libgo7.a")
+	if out, err := exec.Command(ccArgs[0], ccArgs[1:]...).CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+
+	if out, err := exec.Command(bin[0], bin[1:]...).CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+}
+
+func TestForkRuntime(t *testing.T) {
+	if GOOS != "linux" {
+		t.Skip("GoForkRuntime is only available on Linux")
+	}
+
+	defer func() {
+		os.Remove("libgo8.a")
+		os.Remove("libgo8.h")
+		os.Remove("testp")
+		os.RemoveAll("pkg")
+	}()
+
+	cmd := exec.Command("go", "build", "-buildmode=c-archive", "-o", "libgo8.a", "libgo8")
+	cmd.Env = gopathEnv
+	if out, err := cmd.CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+
+	ccArgs := append(cc, "-I", ".", "-o", "testp"+exeSuffix, "main8.c", "libgo8.a")
+	if out, err := exec.Command(ccArgs[0], ccArgs[1:]...).CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+
+	if out, err := exec.Command(bin[0], bin[1:]...).CombinedOutput(); err != nil {
+		t.Logf("%s", out)
+		t.Fatal(err)
+	}
+}
+
 const testar = `#!/usr/bin/env bash
 while expr $1 : '[-]' >/dev/null; do
   shift
@@ -487,3 +550,136 @@ func TestExtar(t *testing.T) {
 		}
 	}
 }
+
+// BenchmarkCallbackThreads measures calls into Go from 1 to 1024
+// threads created by the C host main6.c, with libgo6 linked in as a
+// c-archive and, where supported, as a c-shared library, and with and
+// without a traceback context function. The time per operation includes
+// starting the host; the host's own report, shown with -v, does not.
+func BenchmarkCallbackThreads(b *testing.B) {
+	switch GOOS {
+	case "windows":
+		b.Skip("skipping pthread benchmark on Windows")
+	}
+	if len(bin) > 1 {
+		b.Skip("skipping benchmark with an exec wrapper")
+	}
+
+	defer func() {
+		os.Remove("libgo6.a")
+		os.Remove("libgo6.so")
+		os.Remove("libgo6.h")
+		os.Remove("testp6")
+		os.Remove("testp6shared")
+		os.RemoveAll("pkg")
+	}()
+
+	var ldflags []string
+	if GOOS == "linux" {
+		ldflags = append(ldflags, "-lrt")
+	}
+
+	hosts := []struct {
+		name, buildmode, lib, exe string
+	}{
+		{"c-archive", "c-archive", "libgo6.a", "testp6"},
+	}
+	switch GOOS + "/" + GOARCH {
+	case "linux/386", "linux/amd64", "linux/arm", "linux/arm64", "darwin/amd64":
+		hosts = append(hosts, struct {
+			name, buildmode, lib, exe string
+		}{"c-shared", "c-shared", "libgo6.so", "testp6shared"})
+	}
+
+	for _, h := range hosts {
+		cmd := exec.Command("go", "build", "-buildmode="+h.buildmode, "-o", h.lib, "libgo6")
+		cmd.Env = gopathEnv
+		if out, err := cmd.CombinedOutput(); err != nil {
+			b.Logf("%s", out)
+			b.Fatal(err)
+		}
+		ccArgs := append(cc, "-I", ".", "-o", h.exe, "main6.c", "./"+h.lib)
+		ccArgs = append(ccArgs, ldflags...)
+		if out, err := exec.Command(ccArgs[0], ccArgs[1:]...).CombinedOutput(); err != nil {
+			b.Logf("%s", out)
+			b.Fatal(err)
+		}
+	}
+
+	for _, h := range hosts {
+		for _, traceback := range []int{0, 1} {
+			for _, n := range []int{1, 4, 16, 64, 256, 1024} {
+				name := fmt.Sprintf("%s/traceback=%d/threads=%d", h.name, traceback, n)
+				b.Run(name, func(b *testing.B) {
+					ncall := (b.N + n - 1) / n
+					cmd := exec.Command("./"+h.exe, fmt.Sprint(n), fmt.Sprint(ncall), fmt.Sprint(traceback))
+					cmd.Env = append(os.Environ(), "LD_LIBRARY_PATH=.", "DYLD_LIBRARY_PATH=.")
+					out, err := cmd.CombinedOutput()
+					if err != nil {
+						b.Logf("%s", out)
+						b.Fatal(err)
+					}
+					b.Logf("%s", strings.TrimSpace(string(out)))
+				})
+			}
+		}
+	}
+}
+
+// BenchmarkThreadScaling measures calls from 1,000 to 10,000 C threads,
+// all alive at once as in a thread-per-connection server, created by
+// the C host main9.c with libgo9 linked in as a c-archive. Each call
+// goes from C to Go and back to C. The host's report, shown with -v,
+// gives the throughput, the latency of each thread's first call, the
+// peak RSS, the context switches per call, which count sleeps on
+// contended locks, and the calls that waited for an extra M. The
+// threads=N/stickym=1 runs keep an M on each thread with
+// GODEBUG=cgostickym=1. The larger runs take minutes on small machines;
+// select them with -bench and give them a -timeout.
+func BenchmarkThreadScaling(b *testing.B) {
+	switch GOOS {
+	case "windows":
+		b.Skip("skipping pthread benchmark on Windows")
+	}
+	if len(bin) > 1 {
+		b.Skip("skipping benchmark with an exec wrapper")
+	}
+
+	defer func() {
+		os.Remove("libgo9.a")
+		os.Remove("libgo9.h")
+		os.Remove("testp9")
+		os.RemoveAll("pkg")
+	}()
+
+	cmd := exec.Command("go", "build", "-buildmode=c-archive", "-o", "libgo9.a", "libgo9")
+	cmd.Env = gopathEnv
+	if out, err := cmd.CombinedOutput(); err != nil {
+		b.Logf("%s", out)
+		b.Fatal(err)
+	}
+	ccArgs := append(cc, "-I", ".", "-o", "testp9", "main9.c", "libgo9.a")
+	if GOOS == "linux" {
+		ccArgs = append(ccArgs, "-lrt")
+	}
+	if out, err := exec.Command(ccArgs[0], ccArgs[1:]...).CombinedOutput(); err != nil {
+		b.Logf("%s", out)
+		b.Fatal(err)
+	}
+
+	for _, n := range []int{1000, 2500, 5000, 10000} {
+		for _, sticky := range []int{0, 1} {
+			b.Run(fmt.Sprintf("threads=%d/stickym=%d", n, sticky), func(b *testing.B) {
+				ncall := (b.N + n - 1) / n
+				cmd := exec.Command("./testp9", fmt.Sprint(n), fmt.Sprint(ncall))
+				cmd.Env = append(os.Environ(), fmt.Sprintf("GODEBUG=cgostickym=%d", sticky))
+				out, err := cmd.CombinedOutput()
+				if err != nil {
+					b.Logf("%s", out)
+					b.Fatal(err)
+				}
+				b.Logf("%s", strings.TrimSpace(string(out)))
+			})
+		}
+	}
+}
@@ -20,6 +20,37 @@ static void die(const char* msg) {
 
 static volatile sig_atomic_t sigioSeen;
 
+// Asynchronous signals for which a Go program installs a handler, but
+// a Go archive should not unless the Go code asks for them.
+static const int asyncSignals[] = {
+	SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGUSR1, SIGUSR2, SIGCHLD,
+	SIGPIPE, SIGALRM, SIGPROF, SIGWINCH, SIGURG, SIGIO,
+};
+
+// checkHandlers checks that the Go runtime has installed a handler
+// for SIGSEGV, a synchronous signal, and for none of asyncSignals.
+static void checkHandlers(void) {
+	struct sigaction sa;
+	size_t i;
+
+	if (sigaction(SIGSEGV, NULL, &sa) < 0) {
+		die("sigaction");
+	}
+	if (sa.sa_handler == SIG_DFL) {
+		fprintf(stderr, "no Go handler for SIGSEGV\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < sizeof asyncSignals / sizeof asyncSignals[0]; i++) {
+		if (sigaction(asyncSignals[i], NULL, &sa) < 0) {
+			die("sigaction");
+		}
+		if (sa.sa_handler != SIG_DFL) {
+			fprintf(stderr, "handler installed for signal %d\n", asyncSignals[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
 static void ioHandler(int signo, siginfo_t* info, void* ctxt) {
 	sigioSeen = 1;
 }
@@ -32,6 +63,18 @@ int main(int argc, char** argv) {
 	verbose = argc > 2;
 	setvbuf(stdout, NULL, _IONBF, 0);
 
+	// Only the synchronous signals should have Go handlers, both
+	// after the runtime starts and after calls into Go, so that
+	// the process's other signals do not go through Go.
+
+	if (verbose) {
+		printf("checking signal handlers\n");
+	}
+
+	checkHandlers();
+	SawSIGIO();
+	checkHandlers();
+
 	if (verbose) {
 		printf("calling sigaction\n");
 	}
@@ -0,0 +1,112 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// A C host for the callback benchmark in carchive_test.go, linked with
+// libgo6 built as either a c-archive or a c-shared library.
+//
+// Usage: testp6 nthread ncall traceback
+//
+// Starts nthread threads that each call BenchCall ncall times, after
+// calling BenchSetTraceback if traceback is not 0, and prints the time
+// per call and percentiles of the time each call took, in nanoseconds.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "libgo6.h"
+
+// Bucket i of hist counts calls that took less than 1<<i nanoseconds.
+enum { Buckets = 40 };
+
+static uint64_t hist[Buckets];
+static int ncall;
+
+static int64_t now(void) {
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (int64_t)tv.tv_sec*1000000000 + tv.tv_usec*1000;
+#endif
+}
+
+static void* thread(void* arg) {
+	int i, b;
+	int64_t t, d;
+
+	for (i = 0; i < ncall; i++) {
+		t = now();
+		BenchCall();
+		d = now() - t;
+		for (b = 0; d > 0 && b < Buckets-1; b++) {
+			d >>= 1;
+		}
+		__sync_fetch_and_add(&hist[b], 1);
+	}
+	return NULL;
+}
+
+static int64_t percentile(double p, uint64_t total) {
+	uint64_t want, seen;
+	int i;
+
+	want = p * total;
+	seen = 0;
+	for (i = 0; i < Buckets; i++) {
+		seen += hist[i];
+		if (seen > want) {
+			break;
+		}
+	}
+	if (i == Buckets) {
+		i = Buckets-1;
+	}
+	return (int64_t)1 << i;
+}
+
+int main(int argc, char** argv) {
+	int nthread, i;
+	pthread_t* threads;
+	int64_t start, elapsed;
+	uint64_t total;
+
+	if (argc != 4) {
+		fprintf(stderr, "usage: testp6 nthread ncall traceback\n");
+		return 2;
+	}
+	nthread = atoi(argv[1]);
+	ncall = atoi(argv[2]);
+	if (atoi(argv[3]) != 0) {
+		BenchSetTraceback();
+	}
+
+	threads = malloc(nthread * sizeof threads[0]);
+	start = now();
+	for (i = 0; i < nthread; i++) {
+		if (pthread_create(&threads[i], NULL, thread, NULL) != 0) {
+			perror("pthread_create");
+			return 2;
+		}
+	}
+	for (i = 0; i < nthread; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	elapsed = now() - start;
+
+	total = (uint64_t)nthread * ncall;
+	printf("%llu calls, %lld ns/call; p50 <%lld p90 <%lld p99 <%lld p99.9 <%lld ns\n",
+		(unsigned long long)total, (long long)(elapsed / total),
+		(long long)percentile(0.5, total), (long long)percentile(0.9, total),
+		(long long)percentile(0.99, total), (long long)percentile(0.999, total));
+	return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Test that a C host can drive the network poller of the Go runtime
+// from its own event loop, with GoNetpollDescriptor and GoNetpoll.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "libgo7.h"
+
+int main(void) {
+  int pfd, port, c, n, ready, i;
+  struct sockaddr_in addr;
+  struct pollfd fds[2];
+  char buf[16];
+
+  pfd = GoNetpollDescriptor();
+  if (pfd < 0) {
+    fprintf(stderr, "ERROR: GoNetpollDescriptor returned %d\n", pfd);
+    return 2;
+  }
+  port = Listen();
+
+  // Give the goroutine that accepts connections time to wait for one.
+  usleep(100000);
+
+  c = socket(AF_INET, SOCK_STREAM, 0);
+  if (c < 0) {
+    perror("socket");
+    return 2;
+  }
+  memset(&addr, 0, sizeof addr);
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(c, (struct sockaddr*)&addr, sizeof addr) < 0) {
+    perror("connect");
+    return 2;
+  }
+  if (write(c, "hello", 5) != 5) {
+    perror("write");
+    return 2;
+  }
+
+  // No runtime thread waits for the poller, so nothing comes back
+  // until this loop calls GoNetpoll.
+  fds[0].fd = c;
+  fds[0].events = POLLIN;
+  if (poll(fds, 1, 100) != 0) {
+    fprintf(stderr, "ERROR: echo arrived before any call to GoNetpoll\n");
+    return 2;
+  }
+
+  fds[0].fd = pfd;
+  fds[0].events = POLLIN;
+  fds[1].fd = c;
+  fds[1].events = POLLIN;
+  ready = 0;
+  for (i = 0; i < 100; i++) {
+    if (poll(fds, 2, 100) < 0) {
+      perror("poll");
+      return 2;
+    }
+    if (fds[0].revents & POLLIN) {
+      ready += GoNetpoll();
+    }
+    if (fds[1].revents & POLLIN) {
+      break;
+    }
+  }
+  if (i == 100) {
+    fprintf(stderr, "ERROR: no echo after 10 seconds\n");
+    return 2;
+  }
+  if (ready == 0) {
+    fprintf(stderr, "ERROR: GoNetpoll made no goroutine ready\n");
+    return 2;
+  }
+  n = read(c, buf, sizeof buf);
+  if (n != 5 || memcmp(buf, "hello", 5) != 0) {
+    fprintf(stderr, "ERROR: read %d bytes, want hello\n", n);
+    return 2;
+  }
+  close(c);
+
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Test that the child of GoForkRuntime can keep using the Go runtime
+// and heap of its parent, and that the parent can too.
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "libgo8.h"
+
+extern pid_t GoForkRuntime(void);
+
+int main(void) {
+  pid_t pid;
+  int i, status;
+
+  Warm();
+  for (i = 0; i < 3; i++) {
+    pid = GoForkRuntime();
+    if (pid < 0) {
+      fprintf(stderr, "ERROR: GoForkRuntime failed: %s\n", strerror(errno));
+      return 2;
+    }
+    if (pid == 0) {
+      // Fork again from the child, whose runtime was forked.
+      if (i == 0) {
+        pid = GoForkRuntime();
+        if (pid < 0) {
+          _exit(3);
+        }
+        if (pid > 0 && (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+          _exit(4);
+        }
+      }
+      _exit(Check() ? 0 : 1);
+    }
+    if (waitpid(pid, &status, 0) != pid) {
+      perror("waitpid");
+      return 2;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "ERROR: child %d failed with status %#x\n", i, status);
+      return 2;
+    }
+    if (!Check()) {
+      fprintf(stderr, "ERROR: parent failed after fork %d\n", i);
+      return 2;
+    }
+  }
+
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,172 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// A C host for the thread scaling benchmark in carchive_test.go,
+// linked with libgo9, modeled on a thread-per-connection C server.
+//
+// Usage: testp9 nthread ncall
+//
+// Starts nthread threads, all alive at once, that each call ScaleCall,
+// which calls back into C, ncall times. Prints the throughput of the
+// calls; the time from pthread_create until each thread first returned
+// from Go, which includes taking an extra M; the peak resident set
+// size; the context switches per call, most of them sleeps on
+// contended runtime locks; and the runtime's counts of the calls that
+// had to wait for an extra M.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "libgo9.h"
+
+// Bucket i of starthist counts threads that started in less than
+// 1<<i nanoseconds.
+enum { Buckets = 40 };
+
+// Small stacks, as servers with many threads use.
+enum { StackSize = 256 << 10 };
+
+typedef struct Thread Thread;
+struct Thread {
+	pthread_t p;
+	int64_t created;
+};
+
+static uint64_t starthist[Buckets];
+static int ncall;
+static pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static int started, go;
+
+static int64_t now(void) {
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (int64_t)tv.tv_sec*1000000000 + tv.tv_usec*1000;
+#endif
+}
+
+static void* thread(void* arg) {
+	Thread* t;
+	int i, b, x;
+	int64_t d;
+
+	t = arg;
+	x = ScaleCall(0);
+	d = now() - t->created;
+	for (b = 0; d > 0 && b < Buckets-1; b++) {
+		d >>= 1;
+	}
+
+	// Wait for every thread to be running, so that the calls
+	// measure the runtime with all of them alive.
+	pthread_mutex_lock(&mu);
+	starthist[b]++;
+	started++;
+	pthread_cond_broadcast(&cond);
+	while (!go) {
+		pthread_cond_wait(&cond, &mu);
+	}
+	pthread_mutex_unlock(&mu);
+	for (i = 0; i < ncall; i++) {
+		x = ScaleCall(x);
+	}
+	return (void*)(uintptr_t)x;
+}
+
+static int64_t percentile(double p, uint64_t total) {
+	uint64_t want, seen;
+	int i;
+
+	want = p * total;
+	seen = 0;
+	for (i = 0; i < Buckets; i++) {
+		seen += starthist[i];
+		if (seen > want) {
+			break;
+		}
+	}
+	if (i == Buckets) {
+		i = Buckets-1;
+	}
+	return (int64_t)1 << i;
+}
+
+int main(int argc, char** argv) {
+	int nthread, i, err;
+	Thread* threads;
+	pthread_attr_t attr;
+	int64_t start, elapsed;
+	uint64_t total;
+	struct rusage before, after;
+	GoCgoStats stats;
+	long maxrss;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: testp9 nthread ncall\n");
+		return 2;
+	}
+	nthread = atoi(argv[1]);
+	ncall = atoi(argv[2]);
+
+	threads = calloc(nthread, sizeof threads[0]);
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, StackSize);
+	for (i = 0; i < nthread; i++) {
+		threads[i].created = now();
+		err = pthread_create(&threads[i].p, &attr, thread, &threads[i]);
+		if (err != 0) {
+			fprintf(stderr, "pthread_create %d: %s\n", i, strerror(err));
+			return 2;
+		}
+	}
+	pthread_attr_destroy(&attr);
+
+	// Wait for every thread to have made its first call.
+	pthread_mutex_lock(&mu);
+	while (started < nthread) {
+		pthread_cond_wait(&cond, &mu);
+	}
+	getrusage(RUSAGE_SELF, &before);
+	start = now();
+	go = 1;
+	pthread_cond_broadcast(&cond);
+	pthread_mutex_unlock(&mu);
+	for (i = 0; i < nthread; i++) {
+		pthread_join(threads[i].p, NULL);
+	}
+	elapsed = now() - start;
+	getrusage(RUSAGE_SELF, &after);
+	GoReadCgoStats(&stats);
+
+	maxrss = after.ru_maxrss;
+#ifdef __APPLE__
+	maxrss /= 1024;
+#endif
+	total = (uint64_t)nthread * ncall;
+	if (total == 0) {
+		total = 1;
+	}
+	printf("%d threads: %llu calls, %lld ns/call, %.0f calls/s; start p50 <%lld p99 <%lld ns; maxrss %ld KB; %.3f csw/call; needm %llu, waits %llu for %llu ns\n",
+		nthread, (unsigned long long)total, (long long)(elapsed / total),
+		(double)total * 1e9 / (elapsed > 0 ? elapsed : 1),
+		(long long)percentile(0.5, nthread), (long long)percentile(0.99, nthread),
+		maxrss,
+		(double)(after.ru_nvcsw - before.ru_nvcsw + after.ru_nivcsw - before.ru_nivcsw) / total,
+		(unsigned long long)stats.NeedM, (unsigned long long)stats.NeedMWaits,
+		(unsigned long long)stats.NeedMWaitNanoseconds);
+	return 0;
+}
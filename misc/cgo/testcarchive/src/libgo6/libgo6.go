@@ -0,0 +1,34 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Exported functions for the callback benchmark in main6.c.
+
+/*
+// Defined in context.c.
+extern void benchContext(void*);
+extern void benchTraceback(void*);
+*/
+import "C"
+
+import (
+	"runtime"
+	"unsafe"
+)
+
+// An empty function, to measure the cost of calling into Go.
+//export BenchCall
+func BenchCall() {
+}
+
+// Install a cheap traceback context function, so that every call
+// into Go pays for recording and releasing a traceback context.
+//export BenchSetTraceback
+func BenchSetTraceback() {
+	runtime.SetCgoTraceback(0, unsafe.Pointer(C.benchTraceback), unsafe.Pointer(C.benchContext), nil)
+}
+
+func main() {
+}
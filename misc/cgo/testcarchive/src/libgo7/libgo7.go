@@ -0,0 +1,37 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import "C"
+
+import (
+	"io"
+	"net"
+)
+
+// Listen starts a goroutine that accepts connections on a local TCP
+// port and echoes what it reads from them, and returns the port.
+//export Listen
+func Listen() C.int {
+	l, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		panic(err)
+	}
+	go func() {
+		for {
+			c, err := l.Accept()
+			if err != nil {
+				panic(err)
+			}
+			go func() {
+				io.Copy(c, c)
+				c.Close()
+			}()
+		}
+	}()
+	return C.int(l.Addr().(*net.TCPAddr).Port)
+}
+
+func main() {}
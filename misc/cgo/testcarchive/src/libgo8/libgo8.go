@@ -0,0 +1,78 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import "C"
+
+import (
+	"os"
+	"os/signal"
+	"runtime"
+	"sync"
+	"syscall"
+	"time"
+)
+
+// warm is the heap built by Warm, which the child of GoForkRuntime
+// should inherit.
+var warm map[int][]byte
+
+var sigs = make(chan os.Signal, 1)
+
+// Warm fills the heap, starts a ticker and waits for SIGUSR1 with
+// os/signal, so that the runtime's timer and signal goroutines are
+// waiting in the kernel, and returns once the garbage collector is
+// done.
+//export Warm
+func Warm() {
+	warm = make(map[int][]byte)
+	for i := 0; i < 1000; i++ {
+		warm[i] = make([]byte, 1000+i)
+		warm[i][0] = byte(i)
+	}
+	signal.Notify(sigs, syscall.SIGUSR1)
+	go func() {
+		t := time.NewTicker(time.Hour)
+		for range t.C {
+		}
+	}()
+	runtime.GC()
+	time.Sleep(10 * time.Millisecond)
+}
+
+// Check reports whether the heap built by Warm is intact and the
+// runtime can still run goroutines in parallel, collect garbage, sleep
+// and deliver a signal.
+//export Check
+func Check() C.int {
+	for i := 0; i < 1000; i++ {
+		if len(warm[i]) != 1000+i || warm[i][0] != byte(i) {
+			return 0
+		}
+	}
+	var wg sync.WaitGroup
+	for i := 0; i < 4*runtime.GOMAXPROCS(0); i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			s := make([][]byte, 100)
+			for j := range s {
+				s[j] = make([]byte, 10000)
+			}
+			time.Sleep(time.Millisecond)
+		}()
+	}
+	wg.Wait()
+	runtime.GC()
+	syscall.Kill(syscall.Getpid(), syscall.SIGUSR1)
+	select {
+	case <-sigs:
+	case <-time.After(10 * time.Second):
+		return 0
+	}
+	return 1
+}
+
+func main() {}
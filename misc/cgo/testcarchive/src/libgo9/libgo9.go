@@ -0,0 +1,24 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Exported functions for the thread scaling benchmark in main9.c.
+
+/*
+static int scaleAdd(int x) {
+	return x + 1;
+}
+*/
+import "C"
+
+// ScaleCall calls back into C, so that each call from a C thread
+// crosses from C to Go and from Go to C.
+//export ScaleCall
+func ScaleCall(x C.int) C.int {
+	return C.scaleAdd(x)
+}
+
+func main() {
+}
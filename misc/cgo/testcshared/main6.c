@@ -0,0 +1,68 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Test that a library linked with -lazyinit starts the Go runtime
+// on the first call into Go, and not when it is loaded.
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <dlfcn.h>
+
+// Returns the number of threads in the process.
+static int nthreads(void) {
+  DIR* d;
+  struct dirent* e;
+  int n;
+
+  d = opendir("/proc/self/task");
+  if (d == NULL) {
+    perror("opendir");
+    return -1;
+  }
+  n = 0;
+  while ((e = readdir(d)) != NULL) {
+    if (e->d_name[0] != '.') {
+      n++;
+    }
+  }
+  closedir(d);
+  return n;
+}
+
+int main(int argc, char** argv) {
+  void* handle = dlopen(argv[1], RTLD_LAZY | RTLD_GLOBAL);
+  if (!handle) {
+    fprintf(stderr, "ERROR: failed to open the shared library: %s\n",
+		    dlerror());
+    return 2;
+  }
+
+  int n = nthreads();
+  if (n != 1) {
+    fprintf(stderr, "ERROR: %d threads after loading, want 1\n", n);
+    return 2;
+  }
+
+  int8_t (*fn)();
+  fn = (int8_t (*)())dlsym(handle, "DidInitRun");
+  if (!fn) {
+    fprintf(stderr, "ERROR: missing DidInitRun: %s\n", dlerror());
+    return 2;
+  }
+  if (fn() != 1) {
+    fprintf(stderr, "ERROR: DidInitRun=0, want 1\n");
+    return 2;
+  }
+
+  n = nthreads();
+  if (n < 2) {
+    fprintf(stderr, "ERROR: %d threads after first call, want at least 2\n", n);
+    return 2;
+  }
+
+  // test.bash looks for "PASS" to ensure this program has reached the end.
+  printf("PASS\n");
+  return 0;
+}
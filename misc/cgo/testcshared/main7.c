@@ -0,0 +1,137 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Test that GoReleaseRuntime stops the threads of the Go runtime,
+// gives its heap back, and restores the signal handlers it replaced.
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Returns the number of threads in the process.
+static int nthreads(void) {
+  DIR* d;
+  struct dirent* e;
+  int n;
+
+  d = opendir("/proc/self/task");
+  if (d == NULL) {
+    perror("opendir");
+    return -1;
+  }
+  n = 0;
+  while ((e = readdir(d)) != NULL) {
+    if (e->d_name[0] != '.') {
+      n++;
+    }
+  }
+  closedir(d);
+  return n;
+}
+
+// Returns the resident set size of the process in bytes.
+static long rss(void) {
+  FILE* f;
+  long size, resident;
+
+  f = fopen("/proc/self/statm", "r");
+  if (f == NULL) {
+    perror("fopen");
+    return -1;
+  }
+  if (fscanf(f, "%ld %ld", &size, &resident) != 2) {
+    resident = -1;
+  }
+  fclose(f);
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+static void segvHandler(int signo, siginfo_t* info, void* context) {
+  _exit(2);
+}
+
+int main(int argc, char** argv) {
+  struct sigaction sa;
+  void* handle;
+  int (*start)(void);
+  int (*release)(void);
+  long before;
+  int i, n, r;
+
+  memset(&sa, 0, sizeof sa);
+  sa.sa_sigaction = segvHandler;
+  sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  if (sigaction(SIGSEGV, &sa, NULL) < 0) {
+    perror("sigaction");
+    return 2;
+  }
+
+  handle = dlopen(argv[1], RTLD_NOW | RTLD_GLOBAL);
+  if (handle == NULL) {
+    fprintf(stderr, "ERROR: failed to open the shared library: %s\n", dlerror());
+    return 2;
+  }
+  start = (int (*)(void))dlsym(handle, "Start");
+  if (start == NULL) {
+    fprintf(stderr, "ERROR: missing Start: %s\n", dlerror());
+    return 2;
+  }
+  release = (int (*)(void))dlsym(handle, "GoReleaseRuntime");
+  if (release == NULL) {
+    fprintf(stderr, "ERROR: missing GoReleaseRuntime: %s\n", dlerror());
+    return 2;
+  }
+
+  if (start() != 1) {
+    fprintf(stderr, "ERROR: Start failed\n");
+    return 2;
+  }
+  before = rss();
+
+  r = release();
+  if (r != 0) {
+    fprintf(stderr, "ERROR: GoReleaseRuntime returned %d (%s)\n", r, strerror(r));
+    return 2;
+  }
+
+  // The runtime threads count themselves out just before they exit.
+  for (i = 0; (n = nthreads()) != 1 && i < 100; i++) {
+    usleep(10000);
+  }
+  if (n != 1) {
+    fprintf(stderr, "ERROR: %d threads after GoReleaseRuntime, want 1\n", n);
+    return 2;
+  }
+
+  if (rss() > before - (48 << 20)) {
+    fprintf(stderr, "ERROR: resident size %ld after GoReleaseRuntime, %ld before\n", rss(), before);
+    return 2;
+  }
+
+  if (sigaction(SIGSEGV, NULL, &sa) < 0) {
+    perror("sigaction");
+    return 2;
+  }
+  if (sa.sa_sigaction != segvHandler) {
+    fprintf(stderr, "ERROR: SIGSEGV handler not restored\n");
+    return 2;
+  }
+
+  if (release() != 0) {
+    fprintf(stderr, "ERROR: second GoReleaseRuntime failed\n");
+    return 2;
+  }
+  if (dlclose(handle) != 0) {
+    fprintf(stderr, "ERROR: dlclose: %s\n", dlerror());
+    return 2;
+  }
+
+  // test.bash looks for "PASS" to ensure this program has reached the end.
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Test calls into exported Go functions whose arguments and results
+// are all scalars, which cgo calls directly, and compare their cost
+// with calls that take the general path.
+//
+// Run with the argument "bench" to print, instead of PASS, the time
+// per call of each kind in the format of Go benchmark results, for
+// benchstat. The count of calls grows until a run takes a second.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "libgo8.h"
+
+static int64_t now(void) {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000000 + tv.tv_usec * 1000;
+#endif
+}
+
+static int sink;
+
+static void benchAdd(int n) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    sink += Add(i, 1);
+  }
+}
+
+static void benchAddPointer(int n) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    sink += AddPointer(i, 1, NULL);
+  }
+}
+
+static void benchMixed(int n) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    sink += Mixed(1, i, 2, 0.5, 0).r0;
+  }
+}
+
+static void benchNop(int n) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    Nop();
+  }
+}
+
+static void bench(const char* name, void (*f)(int)) {
+  int n;
+  int64_t t;
+
+  for (n = 1; ; n *= 2) {
+    t = now();
+    f(n);
+    t = now() - t;
+    if (t >= 1000000000 || n >= 1<<30) {
+      break;
+    }
+  }
+  printf("Benchmark%s\t%d\t%.1f ns/op\n", name, n, (double)t / n);
+}
+
+int main(int argc, char** argv) {
+  struct Mixed_return m;
+  int i;
+
+  if (Add(1, 2) != 3) {
+    fprintf(stderr, "ERROR: Add(1, 2) = %d, want 3\n", Add(1, 2));
+    return 2;
+  }
+  if (AddPointer(1, 2, NULL) != 3) {
+    fprintf(stderr, "ERROR: AddPointer(1, 2, NULL) = %d, want 3\n", AddPointer(1, 2, NULL));
+    return 2;
+  }
+  m = Mixed(1, (GoInt64)1<<40 | 2, 3, 1.25, 1);
+  if (m.r0 != 6 || m.r1 != 2.5 || m.r2 != 0) {
+    fprintf(stderr, "ERROR: Mixed = %d, %g, %d, want 6, 2.5, 0\n", m.r0, m.r1, m.r2);
+    return 2;
+  }
+  for (i = 0; i < 10; i++) {
+    Nop();
+  }
+  if (Nops() != 10) {
+    fprintf(stderr, "ERROR: Nops() = %d, want 10\n", (int)Nops());
+    return 2;
+  }
+
+  if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+    bench("CallDirect/Add", benchAdd);
+    bench("CallDirect/Mixed", benchMixed);
+    bench("CallDirect/Nop", benchNop);
+    bench("CallGeneral/AddPointer", benchAddPointer);
+    return 0;
+  }
+
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,53 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import "C"
+
+import (
+	"net"
+	"os"
+	"os/signal"
+	"syscall"
+	"time"
+)
+
+// The heap that GoReleaseRuntime should give back.
+var keep []byte
+
+// Start leaves the runtime with a large heap and with goroutines
+// waiting in each of the ways that keep its threads around: for
+// network I/O, for a timer, and for a signal.
+//export Start
+func Start() C.int {
+	keep = make([]byte, 64<<20)
+	for i := 0; i < len(keep); i += 4096 {
+		keep[i] = 1
+	}
+
+	l, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		return 0
+	}
+	go l.Accept()
+
+	go func() {
+		for {
+			time.Sleep(time.Hour)
+		}
+	}()
+
+	c := make(chan os.Signal, 1)
+	signal.Notify(c, syscall.SIGUSR1)
+	go func() {
+		<-c
+	}()
+
+	// Let the goroutines block.
+	time.Sleep(10 * time.Millisecond)
+	return 1
+}
+
+func main() {}
@@ -0,0 +1,45 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import "C"
+
+import "unsafe"
+
+// Add takes and returns only scalars, so cgo calls it directly,
+// with no copy of its frame.
+//export Add
+func Add(a, b C.int) C.int {
+	return a + b
+}
+
+// AddPointer does the work of Add, but its unused pointer argument
+// sends it through the general path of calls into Go.
+//export AddPointer
+func AddPointer(a, b C.int, p unsafe.Pointer) C.int {
+	return a + b
+}
+
+// Mixed has arguments and results of sizes that need padding in
+// its frame.
+//export Mixed
+func Mixed(a C.char, b int64, c C.short, d float64, e bool) (C.int, float64, bool) {
+	return C.int(a) + C.int(b) + C.int(c), d * 2, !e
+}
+
+// Nop has no arguments or results.
+//export Nop
+func Nop() {
+	nops++
+}
+
+var nops int
+
+//export Nops
+func Nops() int {
+	return nops
+}
+
+func main() {}
@@ -35,9 +35,9 @@ fi
 androidpath=/data/local/tmp/testcshared-$$
 
 function cleanup() {
-	rm -f libgo.$libext libgo2.$libext libgo4.$libext libgo5.$libext
-	rm -f libgo.h libgo4.h libgo5.h
-	rm -f testp testp2 testp3 testp4 testp5
+	rm -f libgo.$libext libgo2.$libext libgo4.$libext libgo5.$libext libgo6.$libext libgo7.$libext libgo8.$libext libgo9.$libext
+	rm -f libgo.h libgo4.h libgo5.h libgo6.h libgo7.h libgo8.h libgo9.h
+	rm -f testp testp2 testp3 testp4 testp5 testp6 testp7 testp8
 	rm -rf pkg "${goroot}/${installdir}"
 
 	if [ "$goos" == "android" ]; then
@@ -96,6 +96,19 @@ if [ "$goos" == "linux" ] || [ "$goos" == "android" ] ; then
     fi
 fi
 
+# The runtime finds g with the initial-exec TLS model, never through
+# __tls_get_addr; see "go help buildmode".
+if [ "$goos" == "linux" ] && [ "$goarch" == "amd64" ]; then
+    if ! readelf -d libgo.$libext | grep STATIC_TLS >/dev/null; then
+        echo "libgo.$libext does not have STATIC_TLS set"
+        exit 1
+    fi
+    if readelf --dyn-syms libgo.$libext | grep __tls_get_addr >/dev/null; then
+        echo "libgo.$libext calls __tls_get_addr"
+        exit 1
+    fi
+fi
+
 GOGCCFLAGS=$(go env GOGCCFLAGS)
 if [ "$goos" == "android" ]; then
 	GOGCCFLAGS="${GOGCCFLAGS} -pie"
@@ -179,6 +192,59 @@ if test "$output" != "PASS"; then
     status=1
 fi
 
+# test6: tests that -ldflags=-lazyinit defers runtime initialization
+# to the first call into Go.
+if [ "$goos" == "linux" ]; then
+	GOPATH=$(pwd) go build -buildmode=c-shared $suffix -ldflags=-lazyinit -o libgo6.$libext src/libgo/libgo.go
+	$(go env CC) ${GOGCCFLAGS} -o testp6 main6.c -ldl
+	output=$(run ./testp6 ./libgo6.$libext 2>&1)
+	if test "$output" != "PASS"; then
+		echo "FAIL test6 got ${output}"
+		status=1
+	fi
+fi
+
+# test7: tests that GoReleaseRuntime stops the runtime's threads,
+# unmaps its heap and restores signal handlers.
+if [ "$goos" == "linux" ]; then
+	GOPATH=$(pwd) go build -buildmode=c-shared $suffix -o libgo7.$libext libgo7
+	$(go env CC) ${GOGCCFLAGS} -o testp7 main7.c -ldl
+	output=$(run ./testp7 ./libgo7.$libext 2>&1)
+	if test "$output" != "PASS"; then
+		echo "FAIL test7 got ${output}"
+		status=1
+	fi
+fi
+
+# test8: tests exported functions that cgo calls directly, because
+# their arguments and results are all scalars. Run testp8 with the
+# argument bench to compare the cost of such calls with the general
+# path.
+GOPATH=$(pwd) go build -buildmode=c-shared $suffix -o libgo8.$libext libgo8
+binpush libgo8.$libext
+$(go env CC) ${GOGCCFLAGS} -I . -o testp8 main8.c libgo8.$libext
+binpush testp8
+output=$(run LD_LIBRARY_PATH=. ./testp8 2>&1)
+if test "$output" != "PASS"; then
+	echo "FAIL test8 got ${output}"
+	status=1
+fi
+
+# test9: tests that -ldflags=-bindnow marks the library for binding
+# at load time, and that it still works.
+if [ "$goos" == "linux" ]; then
+	GOPATH=$(pwd) go build -buildmode=c-shared $suffix -ldflags=-bindnow -o libgo9.$libext src/libgo/libgo.go
+	if ! readelf -d libgo9.$libext | grep -q 'FLAGS.*BIND_NOW'; then
+		echo "FAIL test9: libgo9.$libext lacks BIND_NOW"
+		status=1
+	fi
+	output=$(run ./testp ./libgo9.$libext 2>&1)
+	if test "$output" != "PASS"; then
+		echo "FAIL test9 got ${output}"
+		status=1
+	fi
+fi
+
 if test $status = 0; then
     echo "ok"
 fi
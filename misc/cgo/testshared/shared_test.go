@@ -383,6 +383,27 @@ func TestCgoExecutable(t *testing.T) {
 	run(t, "cgo executable", "./bin/execgo")
 }
 
+// Build two libraries with -buildmode=c-shared that link against the
+// shared runtime and depBase, and check that a C program that loads
+// both sees one copy of them.
+func TestCSharedLibraries(t *testing.T) {
+	goCmd(t, "install", "-buildmode=shared", "-linkshared", "depBase")
+	for _, name := range []string{"cshared1", "cshared2"} {
+		lib := "lib" + name + ".so"
+		goCmd(t, "build", "-buildmode=c-shared", "-linkshared", "-o="+lib, name)
+		defer os.Remove(lib)
+		AssertIsLinkedTo(t, lib, soname)
+		AssertIsLinkedTo(t, lib, "libdepBase.so")
+	}
+	cc, err := exec.Command("go", "env", "CC").Output()
+	if err != nil {
+		t.Fatalf("go env CC failed: %v", err)
+	}
+	run(t, "build C host", strings.TrimSpace(string(cc)), "-o", "csharedhost", "src/csharedhost/main.c", "-ldl")
+	defer os.Remove("csharedhost")
+	run(t, "C program loading two libraries", "./csharedhost", "./libcshared1.so", "./libcshared2.so")
+}
+
 func checkPIE(t *testing.T, name string) {
 	f, err := elf.Open(name)
 	if err != nil {
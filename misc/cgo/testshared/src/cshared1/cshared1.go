@@ -0,0 +1,12 @@
+package main
+
+import "C"
+
+import "depBase"
+
+//export Set
+func Set(v C.int) {
+	depBase.V = int(v)
+}
+
+func main() {}
@@ -0,0 +1,23 @@
+package main
+
+import "C"
+
+import "depBase"
+
+var initRan bool
+
+func init() {
+	initRan = true
+}
+
+//export Get
+func Get() C.int {
+	return C.int(depBase.F())
+}
+
+//export InitRan
+func InitRan() bool {
+	return initRan
+}
+
+func main() {}
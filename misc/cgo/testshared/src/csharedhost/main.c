@@ -0,0 +1,54 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Loads the libraries built from cshared1 and cshared2, which share
+// the runtime and depBase, and checks that they see the same data.
+
+#include <dlfcn.h>
+#include <stdio.h>
+
+static void* sym(void* handle, const char* name) {
+  void* p = dlsym(handle, name);
+  if (p == NULL) {
+    fprintf(stderr, "ERROR: missing %s: %s\n", name, dlerror());
+  }
+  return p;
+}
+
+int main(int argc, char** argv) {
+  void* h1;
+  void* h2;
+  void (*set)(int);
+  int (*get)(void);
+  unsigned char (*initRan)(void);
+
+  h1 = dlopen(argv[1], RTLD_NOW);
+  if (h1 == NULL) {
+    fprintf(stderr, "ERROR: %s\n", dlerror());
+    return 2;
+  }
+  h2 = dlopen(argv[2], RTLD_NOW);
+  if (h2 == NULL) {
+    fprintf(stderr, "ERROR: %s\n", dlerror());
+    return 2;
+  }
+  set = sym(h1, "Set");
+  get = sym(h2, "Get");
+  initRan = sym(h2, "InitRan");
+  if (set == NULL || get == NULL || initRan == NULL) {
+    return 2;
+  }
+
+  if (!initRan()) {
+    fprintf(stderr, "ERROR: init of second library did not run\n");
+    return 2;
+  }
+  set(42);
+  if (get() != 42) {
+    fprintf(stderr, "ERROR: Get() = %d, want 42\n", get());
+    return 2;
+  }
+  printf("PASS\n");
+  return 0;
+}
@@ -107,6 +107,10 @@ func main() {
 		C.exit(2)
 	}
 
+	// Test that a signal Go has no use for, raised on a thread
+	// that Go does not know about, is handled by C.
+	C.sigioOnThread()
+
 	// Test that the signal originating in C is handled by C.
 	C.sigsegv()
 }
@@ -5,7 +5,9 @@
 // This .cc file will be automatically compiled by the go tool and
 // included in the package.
 
+#include <string.h>
 #include <string>
+#include <vector>
 #include "callback.h"
 
 std::string Caller::call() {
@@ -13,3 +15,30 @@ std::string Caller::call() {
 		return callback_->run();
 	return "";
 }
+
+int Callback::runBuf(void *buf, int n) {
+	std::string s = run();
+	if (s.size() <= (size_t)n)
+		memcpy(buf, s.data(), s.size());
+	return s.size();
+}
+
+int Caller::callBuf() {
+	if (callback_ == 0)
+		return 0;
+	int n = callback_->runBuf(&buf_[0], buf_.size());
+	if ((size_t)n > buf_.size()) {
+		buf_.resize(n);
+		n = callback_->runBuf(&buf_[0], buf_.size());
+	}
+	return n;
+}
+
+int Caller::callArg(const std::string &arg, int n) {
+	int sum = 0;
+	if (callback_ == 0)
+		return 0;
+	for (int i = 0; i < n; i++)
+		sum += callback_->runArg(arg);
+	return sum;
+}
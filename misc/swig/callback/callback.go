@@ -4,8 +4,37 @@
 
 package callback
 
+import "unsafe"
+
 type GoCallback struct{}
 
 func (p *GoCallback) Run() string {
 	return "GoCallback.Run"
 }
+
+// RunBuf overrides Callback::runBuf, writing the result of Run to
+// the C++ caller's buffer with no allocation on either side.
+func (p *GoCallback) RunBuf(buf uintptr, n int) int {
+	return CopyOut(buf, n, "GoCallback.Run")
+}
+
+// RunArg overrides Callback::runArg.
+func (p *GoCallback) RunArg(arg string) int {
+	return len(arg)
+}
+
+// CopyOut copies s to the n bytes of C memory at buf, if it fits, and
+// returns len(s), as an override of Callback::runBuf should.
+func CopyOut(buf uintptr, n int, s string) int {
+	if len(s) <= n {
+		copy((*[1 << 30]byte)(unsafe.Pointer(buf))[:n:n], s)
+	}
+	return len(s)
+}
+
+// CallView calls c's callback through CallBuf and returns a view of
+// the result in c's buffer, which is valid until the next call.
+func CallView(c Caller) []byte {
+	n := c.CallBuf()
+	return (*[1 << 30]byte)(unsafe.Pointer(c.Buf()))[:n:n]
+}
@@ -6,15 +6,37 @@ class Callback {
 public:
 	virtual ~Callback() { }
 	virtual std::string run() { return "Callback::run"; }
+
+	// runBuf is like run, but writes its result to the n bytes
+	// at buf, if it fits, and returns its length. It lets a Go
+	// override return a result with no std::string or Go string
+	// made for it.
+	virtual int runBuf(void *buf, int n);
+
+	// runArg takes an argument, for measuring the cost of passing
+	// one to an override. It returns the argument's length.
+	virtual int runArg(const std::string &arg) { return arg.size(); }
 };
 
 class Caller {
 private:
 	Callback *callback_;
+	std::vector<char> buf_;
 public:
-	Caller(): callback_(0) { }
+	Caller(): callback_(0), buf_(64) { }
 	~Caller() { delCallback(); }
 	void delCallback() { delete callback_; callback_ = 0; }
 	void setCallback(Callback *cb) { delCallback(); callback_ = cb; }
 	std::string call();
+
+	// callBuf is like call, but leaves the result in a buffer
+	// that the Caller owns, at buf(), and returns its length.
+	// The result stays there until the next callBuf.
+	int callBuf();
+	void *buf() { return &buf_[0]; }
+
+	// callArg calls the callback's runArg n times with arg, and
+	// returns the sum of the results. Making the calls from C++
+	// measures the calls into the callback alone.
+	int callArg(const std::string &arg, int n);
 };
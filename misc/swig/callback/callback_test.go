@@ -5,6 +5,9 @@
 package callback
 
 import (
+	"fmt"
+	"strings"
+	"sync"
 	"testing"
 )
 
@@ -31,3 +34,117 @@ func TestCallback(t *testing.T) {
 	c.DelCallback()
 	DeleteDirectorCallback(cb)
 }
+
+func TestCallView(t *testing.T) {
+	c := NewCaller()
+	cb := NewCallback()
+	c.SetCallback(cb)
+	if s := string(CallView(c)); s != "Callback::run" {
+		t.Errorf("unexpected string from CallView: %q", s)
+	}
+	c.DelCallback()
+
+	cb = NewDirectorCallback(&GoCallback{})
+	c.SetCallback(cb)
+	if s := string(CallView(c)); s != "GoCallback.Run" {
+		t.Errorf("unexpected string from CallView with callback: %q", s)
+	}
+	c.DelCallback()
+	DeleteDirectorCallback(cb)
+}
+
+// longCallback returns a result longer than the Caller's first buffer.
+type longCallback struct{}
+
+var long = strings.Repeat("x", 1000)
+
+func (p *longCallback) Run() string { return long }
+
+func (p *longCallback) RunBuf(buf uintptr, n int) int { return CopyOut(buf, n, long) }
+
+func TestCallViewGrow(t *testing.T) {
+	c := NewCaller()
+	cb := NewDirectorCallback(&longCallback{})
+	c.SetCallback(cb)
+	if s := string(CallView(c)); s != long {
+		t.Errorf("CallView returned %d bytes, want %d", len(s), len(long))
+	}
+	c.DelCallback()
+	DeleteDirectorCallback(cb)
+}
+
+func BenchmarkCall(b *testing.B) {
+	c := NewCaller()
+	cb := NewDirectorCallback(&GoCallback{})
+	c.SetCallback(cb)
+	for i := 0; i < b.N; i++ {
+		c.Call()
+	}
+	c.DelCallback()
+	DeleteDirectorCallback(cb)
+}
+
+func BenchmarkCallView(b *testing.B) {
+	c := NewCaller()
+	cb := NewDirectorCallback(&GoCallback{})
+	c.SetCallback(cb)
+	for i := 0; i < b.N; i++ {
+		CallView(c)
+	}
+	c.DelCallback()
+	DeleteDirectorCallback(cb)
+}
+
+func TestCallArg(t *testing.T) {
+	c := NewCaller()
+	cb := NewDirectorCallback(&GoCallback{})
+	c.SetCallback(cb)
+	if n := c.CallArg("abc", 10); n != 30 {
+		t.Errorf("CallArg with callback = %d, want 30", n)
+	}
+	c.DelCallback()
+	DeleteDirectorCallback(cb)
+}
+
+// BenchmarkDirector measures calls from C++ into a Go override of a
+// virtual function, with arguments of several sizes, made on several
+// threads at once. Each op is one call.
+func BenchmarkDirector(b *testing.B) {
+	for _, size := range []int{0, 64, 4096} {
+		for _, threads := range []int{1, 4, 16} {
+			b.Run(fmt.Sprintf("size=%d/threads=%d", size, threads), func(b *testing.B) {
+				benchmarkDirector(b, size, threads)
+			})
+		}
+	}
+}
+
+func benchmarkDirector(b *testing.B, size, threads int) {
+	const batch = 100 // calls per call into C++
+	arg := strings.Repeat("x", size)
+	b.SetBytes(int64(size))
+	var wg sync.WaitGroup
+	for t := 0; t < threads; t++ {
+		n := b.N / threads
+		if t < b.N%threads {
+			n++
+		}
+		wg.Add(1)
+		go func(n int) {
+			defer wg.Done()
+			c := NewCaller()
+			cb := NewDirectorCallback(&GoCallback{})
+			c.SetCallback(cb)
+			for ; n > 0; n -= batch {
+				m := batch
+				if n < m {
+					m = n
+				}
+				c.CallArg(arg, m)
+			}
+			c.DelCallback()
+			DeleteDirectorCallback(cb)
+		}(n)
+	}
+	wg.Wait()
+}
@@ -0,0 +1,257 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Persistent cache of gcc runs, enabled by setting $CGO_CACHEDIR.
+//
+// Translate runs gcc several times per file to learn about the names
+// that the Go code uses from C. For the same program, compiler and
+// flags, the output changes only if a header that the program includes
+// changes. The cache keeps the output of each run under a hash of the
+// command line, the compiler binary, the environment variables gcc
+// reads, the working directory and the program. Each entry also lists
+// the files gcc read, with a hash of each, and is used only if they
+// all still have the same contents.
+
+package main
+
+import (
+	"bufio"
+	"bytes"
+	"crypto/sha256"
+	"encoding/gob"
+	"fmt"
+	"io"
+	"io/ioutil"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+)
+
+var cacheDir = os.Getenv("CGO_CACHEDIR")
+
+// cacheEnv lists the environment variables that change what gcc reads.
+var cacheEnv = []string{
+	"CPATH",
+	"C_INCLUDE_PATH",
+	"GCC_EXEC_PREFIX",
+	"COMPILER_PATH",
+	"LIBRARY_PATH",
+	"SDKROOT",
+}
+
+// A cacheEntry is the recorded result of a gcc run.
+type cacheEntry struct {
+	Deps   []cacheDep // files gcc read
+	Stdout []byte
+	Stderr []byte
+	OK     bool
+	Object []byte // the object file written, if any
+}
+
+type cacheDep struct {
+	Name string
+	Hash [sha256.Size]byte
+}
+
+// runCached is like run, but uses the cache in $CGO_CACHEDIR if set.
+// If obj is not empty, the command writes an object file named obj,
+// which is cached too.
+func runCached(stdin []byte, argv []string, obj string) (stdout, stderr []byte, ok bool) {
+	if cacheDir == "" {
+		return run(stdin, argv)
+	}
+	key, err := cacheKey(stdin, argv, obj)
+	if err != nil {
+		return run(stdin, argv)
+	}
+	file := filepath.Join(cacheDir, key[:2], key)
+	if e := cacheLoad(file); e != nil {
+		if obj == "" || !e.OK || ioutil.WriteFile(obj, e.Object, 0666) == nil {
+			if *debugGcc {
+				fmt.Fprintf(os.Stderr, "(cached in %s)\n", file)
+			}
+			return e.Stdout, e.Stderr, e.OK
+		}
+	}
+
+	// Have gcc list the files it reads. The input must stay last; see run.
+	deps, err := ioutil.TempFile("", "cgo-gcc-deps-")
+	if err != nil {
+		return run(stdin, argv)
+	}
+	deps.Close()
+	defer os.Remove(deps.Name())
+	n := len(argv) - 1
+	args := append(argv[:n:n], "-MD", "-MF", deps.Name(), argv[n])
+
+	stdout, stderr, ok = run(stdin, args)
+	e := &cacheEntry{Stdout: stdout, Stderr: stderr, OK: ok}
+	if obj != "" && ok {
+		if e.Object, err = ioutil.ReadFile(obj); err != nil {
+			return
+		}
+	}
+	if e.Deps, err = readDeps(deps.Name()); err != nil {
+		return
+	}
+	cacheStore(file, e)
+	return
+}
+
+// cacheKey returns the key of the gcc run with stdin and argv.
+func cacheKey(stdin []byte, argv []string, obj string) (string, error) {
+	h := sha256.New()
+	gcc, err := exec.LookPath(argv[0])
+	if err != nil {
+		return "", err
+	}
+	fi, err := os.Stat(gcc)
+	if err != nil {
+		return "", err
+	}
+	fmt.Fprintf(h, "compiler %s %d %d\n", gcc, fi.Size(), fi.ModTime().UnixNano())
+	// The go command runs cgo with a new temporary object directory
+	// for each build, and adds it to the include path. Any header
+	// gcc reads from there is listed in the entry with its full
+	// name, so leaving the directory out of the key is safe.
+	objdir := filepath.Clean(*objDir)
+	for _, arg := range argv {
+		switch {
+		case obj != "" && arg == "-o"+obj:
+			// The object file name varies from run to run.
+			arg = "-o"
+		case filepath.Clean(arg) == objdir:
+			arg = "$OBJDIR"
+		case strings.HasPrefix(arg, "-I") && filepath.Clean(arg[2:]) == objdir:
+			arg = "-I$OBJDIR"
+		}
+		fmt.Fprintf(h, "arg %q\n", arg)
+	}
+	for _, name := range cacheEnv {
+		fmt.Fprintf(h, "env %s=%q\n", name, os.Getenv(name))
+	}
+	wd, err := os.Getwd()
+	if err != nil {
+		return "", err
+	}
+	fmt.Fprintf(h, "dir %s\n", wd)
+	h.Write(stdin)
+	return fmt.Sprintf("%x", h.Sum(nil)), nil
+}
+
+// cacheLoad returns the entry in file,
+// or nil if there is none or the files it lists have changed.
+func cacheLoad(file string) *cacheEntry {
+	f, err := os.Open(file)
+	if err != nil {
+		return nil
+	}
+	defer f.Close()
+	e := new(cacheEntry)
+	if err := gob.NewDecoder(bufio.NewReader(f)).Decode(e); err != nil {
+		return nil
+	}
+	for _, d := range e.Deps {
+		h, err := hashFile(d.Name)
+		if err != nil || h != d.Hash {
+			return nil
+		}
+	}
+	return e
+}
+
+// cacheStore writes e to file. Errors are ignored: the cache
+// only saves time.
+func cacheStore(file string, e *cacheEntry) {
+	var b bytes.Buffer
+	if err := gob.NewEncoder(&b).Encode(e); err != nil {
+		return
+	}
+	dir := filepath.Dir(file)
+	if err := os.MkdirAll(dir, 0777); err != nil {
+		return
+	}
+	// Write and rename, so that concurrent builds
+	// never see a partial entry.
+	f, err := ioutil.TempFile(dir, "tmp-")
+	if err != nil {
+		return
+	}
+	_, err = f.Write(b.Bytes())
+	if err1 := f.Close(); err == nil {
+		err = err1
+	}
+	if err == nil {
+		err = os.Rename(f.Name(), file)
+	}
+	if err != nil {
+		os.Remove(f.Name())
+	}
+}
+
+// readDeps returns the files listed in the make rule that gcc -MD
+// wrote to file, with their hashes. It leaves out files that no
+// longer exist, like the temporary input file written by run.
+func readDeps(file string) ([]cacheDep, error) {
+	data, err := ioutil.ReadFile(file)
+	if err != nil {
+		return nil, err
+	}
+	s := strings.Replace(string(data), "\\\n", " ", -1)
+	if i := strings.Index(s, ": "); i >= 0 {
+		s = s[i+2:]
+	}
+	var deps []cacheDep
+	for _, name := range splitDeps(s) {
+		h, err := hashFile(name)
+		if os.IsNotExist(err) {
+			continue
+		}
+		if err != nil {
+			return nil, err
+		}
+		deps = append(deps, cacheDep{name, h})
+	}
+	return deps, nil
+}
+
+// splitDeps splits the prerequisites of a make rule,
+// which escape spaces in names with a backslash.
+func splitDeps(s string) []string {
+	var names []string
+	var name []byte
+	for i := 0; i < len(s); i++ {
+		switch c := s[i]; {
+		case c == '\\' && i+1 < len(s) && s[i+1] == ' ':
+			name = append(name, ' ')
+			i++
+		case c == ' ' || c == '\t' || c == '\n' || c == '\r':
+			if len(name) > 0 {
+				names = append(names, string(name))
+				name = name[:0]
+			}
+		default:
+			name = append(name, c)
+		}
+	}
+	if len(name) > 0 {
+		names = append(names, string(name))
+	}
+	return names
+}
+
+func hashFile(name string) (h [sha256.Size]byte, err error) {
+	f, err := os.Open(name)
+	if err != nil {
+		return h, err
+	}
+	defer f.Close()
+	d := sha256.New()
+	if _, err := io.Copy(d, f); err != nil {
+		return h, err
+	}
+	copy(h[:], d.Sum(nil))
+	return h, nil
+}
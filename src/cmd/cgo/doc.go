@@ -80,6 +80,175 @@ Will be expanded to:
 
        // #cgo LDFLAGS: -L/go/src/foo/libs -lfoo
 
+A call from Go to C normally tells the scheduler that the goroutine is
+entering a system call, so that other goroutines can run while the C
+function blocks. For very short C functions, such as hashes or small
+math routines, that bookkeeping can cost more than the function itself.
+A '#cgo leaf:' directive followed by C function names marks those
+functions as leaves: calls to them from Go run the function directly on
+the system stack, without the system call transitions. For example:
+
+	// #cgo leaf: crc32_update
+	// #include "crc32.h"
+	import "C"
+
+A leaf function must return quickly, must not block, and must not call
+back into Go; a callback into Go from a leaf function is a fatal error.
+While it runs, the calling goroutine keeps its thread and processor, so
+a long-running leaf function delays garbage collection and other
+goroutines. The directive applies to all the files of the package and
+does not accept GOOS/GOARCH conditions.
+
+A leaf function still runs on the system stack of its thread, and
+switching to it can cost as much as a small function's own work. A
+'#cgo stack:' directive declares, for each C function it names, the
+most stack in bytes that the function uses, and makes the function a
+leaf that runs on the calling goroutine's own stack. Before the call
+the runtime grows the goroutine's stack if it lacks that much room.
+For example:
+
+	// #cgo stack: crc32_update=256
+	// #include "crc32.h"
+	import "C"
+
+The size may be at most 65536 and must cover everything the function
+calls; a function that uses more stack than it declares corrupts
+memory. A stack function is otherwise a leaf function, with the same
+rules, and may not be named in an async directive. On architectures
+other than amd64 it is called as any other leaf function, on the
+system stack.
+
+A '#cgo batch:' directive followed by C function names asks cgo to
+generate a batch form of each of those functions, called as
+C.batch_name. The batch form takes a slice for each parameter of the
+C function and, if the function has a result, a slice to store the
+results in. All the slices must have the same length n; the batch form
+calls the C function n times, once for each index, with a single
+transition from Go to C. For example:
+
+	// #cgo batch: scale
+	// int scale(int x, int k) { return x * k; }
+	import "C"
+
+	C.batch_scale(xs, ks, results) // results[i] = C.scale(xs[i], ks[i])
+
+The slices themselves are passed to C, so the rules for passing
+pointers apply to them: with a batch function that takes pointers,
+each element must be a pointer to C memory. A batch form has no
+two-result form, cannot be used as a function value, and is not
+supported with gccgo. A function may be named in both a batch and a
+leaf directive, in which case its batch form is also called as a leaf.
+
+A call from Go to C holds an operating system thread for as long as the
+C function runs, so a program with many goroutines blocked in C, for
+example in a C DNS resolver or database client, ends up with as many
+threads. A '#cgo async:' directive followed by C function names marks
+those functions as asynchronous: a call to one of them from Go parks
+the calling goroutine, which uses no thread while it waits, and the
+function runs on a thread from a pool kept by the runtime. When the
+function returns, the goroutine becomes runnable again. The pool has
+at most 64 threads, or as many as GODEBUG=cgoasyncthreads=N sets;
+further calls wait for a thread to become free. For example:
+
+	// #cgo async: lookup_host
+	// #include "resolver.h"
+	import "C"
+
+An asynchronous function runs on a different thread from its caller,
+so it must not depend on thread-local state set up by earlier calls;
+calls from a goroutine locked to its thread with runtime.LockOSThread
+are ordinary calls for that reason. A callback into Go from an
+asynchronous function runs as a callback from a thread started by C.
+Each call costs a few microseconds more than an ordinary call, which
+pays off only for functions that may block. The pool is not available
+on Windows, OpenBSD or Plan 9, or with gccgo, where the calls are
+ordinary calls. A function may not be named in both an async and a
+leaf directive.
+
+Some C libraries keep state per thread, such as a cached connection or
+an error context, and run faster when a goroutine's calls keep landing
+on the same thread. runtime.LockOSThread guarantees that, at the cost
+of a thread per goroutine. A '#cgo affinity:' directive followed by C
+function names asks for less: after a call to one of them, when the
+goroutine is next scheduled the runtime moves it to the thread that
+made the call if that thread is idle, and otherwise runs it wherever
+it would have run. For example:
+
+	// #cgo affinity: sess_query
+	// #include "session.h"
+	import "C"
+
+The C function must still work on any thread. GODEBUG=cgoaffinity=1
+does the same for every call to C. The directive is ignored with
+gccgo. A function may not be named in both an affinity directive and
+a leaf, stack or async directive.
+
+A call from Go to C that blocks holds a thread until it returns, so
+when a C library slows down, a program calling it from many goroutines
+can start threads until it reaches the limit set by
+runtime/debug.SetMaxThreads and crashes. A '#cgo limit:' directive
+caps the number of calls to a C function that may be in C at once,
+as name=n; several functions named together, separated by commas,
+share one limit. A goroutine calling the function while n calls are
+in C waits, parked in Go, until one of them returns. For example:
+
+	// #cgo limit: db_query,db_exec=16
+	// #include "db.h"
+	import "C"
+
+The limit covers plain, two-result and batch calls, from every file
+of the package, and is not enforced with gccgo. A function may not be
+named in both a limit and a leaf or async directive.
+
+Passing many structs to C usually means copying each Go value into a C
+array field by field. A '#cgo layout:' directive followed by GoType=ctype
+pairs declares instead that the Go struct type GoType, defined at package
+level, has the layout of the C struct type C.ctype. For example:
+
+	// #cgo layout: Point=struct_point
+	// struct point { int32_t x, y; double w; };
+	// void draw(struct point *p, int n);
+	import "C"
+
+	type Point struct {
+		X, Y int32
+		W    float64
+	}
+
+Each field of the Go type must be of a predeclared numeric type, a C
+type without pointers, another such Go type, or an array of one, and
+the fields must correspond to those of the C struct, in order; bit
+fields are not allowed. cgo checks at compile time that the Go type has
+the size and field offsets of the C struct and at least its alignment.
+It then uses the Go type wherever the C code uses the C type, so that
+C.struct_point is Point and a []Point can be passed to draw as
+&pts[0] with no copying. Since the type holds no Go pointers, such
+calls skip the pointer checks described below.
+
+Some calls do not go through C at all. If the preamble defines a
+static inline function whose body only returns a field of its single
+parameter, a struct or a pointer to a struct, or only returns an
+integer constant, cgo writes that access in Go. For example, calls to
+
+	static inline int point_x(struct point *p) { return p->x; }
+
+read p.x directly. Functions defined inside #if blocks, or that use
+macros defined in the preamble, are called as usual, as is the
+two-result form of any function.
+
+Rather than naming leaf functions by hand, a program can let a profile
+pick them. If the CGO_PROFILE environment variable names a file holding
+a cgo call profile, written by runtime/pprof's "cgocall" profile with
+debug=1 while the program ran a typical load, cgo calls as leaves the
+functions of the package that account for at least 1% of the calls in
+the profile and return within a microsecond on average. Since the
+profile cannot tell whether a function blocks or calls back into Go,
+only functions defined in the preamble whose bodies call no other
+function, through a name, a pointer or a macro, and hold no asm
+statements are chosen; functions named in a leaf, stack, async or
+limit directive keep it. Changing the profile does not make packages
+stale, so rebuild with go build -a after updating it.
+
 When the Go tool sees that one or more Go files use the special import
 "C", it will look for other non-Go files in the directory and compile
 them as part of the Go package.  Any .c, .s, or .S files will be
@@ -106,6 +275,25 @@ the CC environment variable any time you run the go tool.  The
 CXX_FOR_TARGET and CXX environment variables work in a similar way for
 C++ code.
 
+To learn about the C names that Go code uses, cgo runs the C compiler
+over each file's preamble several times. If the CGO_CACHEDIR environment
+variable names a directory, cgo keeps the results of these runs there
+and reuses them as long as the preamble, the compiler, its flags and the
+contents of the headers it read are unchanged, so that rebuilding a
+package whose C headers rarely change skips most compiler runs.
+
+The go command compiles the C code that cgo writes for each Go file
+separately, so a wrapper can inline only the C functions defined in
+its own file's preamble. If the CGO_UNITY environment variable is set
+to 1, cgo also writes the C code for all the files of a package into
+one file, which the go command compiles in a single run instead; if
+the preambles conflict when put together, it compiles the files
+separately as usual. To inline C functions from the package's .c files
+as well, use link-time optimization: with -flto in both CFLAGS and
+LDFLAGS, the go command compiles objects that hold both machine code
+for the Go linker and the compiler's intermediate form, and the
+optimization happens when linking externally (-ldflags=-linkmode=external).
+
 Go references to C
 
 Within the Go file, C's struct field names that are keywords in Go
@@ -154,6 +342,10 @@ function returns void).  For example:
 	_, err := C.voidFunc()
 	var n, err = C.sqrt(1)
 
+Only calls in this form clear errno before the call and read it after;
+a plain call of the same function, elsewhere in the package, does not
+touch errno.
+
 Calling C function pointers is currently not supported, however you can
 declare Go variables which hold C function pointers and pass them
 back and forth between Go and C. C code may call function pointers
@@ -214,6 +406,70 @@ by making copies of the data.  In pseudo-Go definitions:
 	// C data with explicit length to Go []byte
 	func C.GoBytes(unsafe.Pointer, C.int) []byte
 
+	// C data with explicit length to Go []byte, stored in the
+	// Go slice if its capacity is large enough: the result is
+	// the slice resliced to the length, or a new slice
+	func C.GoBytesInto([]byte, unsafe.Pointer, C.int) []byte
+
+	// C data with explicit length to Go string, which may be
+	// one returned earlier with the same contents
+	func C.GoStringIntern(*C.char, C.int) string
+
+C.GoBytesInto and C.GoStringIntern avoid allocating for each piece of
+C data a program converts.  A loop converting C buffers can pass the
+same Go slice to C.GoBytesInto on each iteration, as long as it has
+finished with the previous contents.  C.GoStringIntern keeps a small
+cache of the short strings it has returned and returns one again if
+the C data is the same; it suits data such as names or keys that
+recur.  When built with gccgo, C.GoStringIntern is C.GoStringN.
+
+Each call to C.CString, C.CBytes or C.malloc calls into C to allocate
+memory.  A program that builds many small C objects can instead
+allocate them from a runtime/cgo Arena, which takes large blocks from
+malloc and hands out pieces of them without calling C:
+
+	var a cgo.Arena
+	defer a.Free() // releases everything allocated from a
+	p := (*C.struct_node)(a.Alloc(unsafe.Sizeof(C.struct_node{})))
+	p.name = (*C.char)(a.CString("name"))
+
+Similarly, C memory from C.CString, C.CBytes or C.malloc that is to
+be freed all together can be collected in a runtime/cgo FreeList and
+released with a single call into C:
+
+	var l cgo.FreeList
+	for _, s := range names {
+		cs := C.CString(s)
+		l.Add(unsafe.Pointer(cs))
+		C.lookup(cs)
+	}
+	l.Free() // frees every pointer added to l
+
+Small C objects with lifetimes of their own can come from
+runtime/cgo's Malloc and Free instead, which serve allocations of up
+to 256 bytes from per-P caches refilled a slab at a time, so that
+most of them do not call into C at all:
+
+	p := (*C.struct_node)(cgo.Malloc(unsafe.Sizeof(C.struct_node{})))
+	...
+	cgo.Free(unsafe.Pointer(p)) // not C.free
+
+C.CString, C.CBytes and C.malloc use the C library's malloc unless
+the program registers another allocator, such as one that keeps
+per-thread caches, by calling GoSetCAllocator from C before any of
+them is first called:
+
+	extern int GoSetCAllocator(void *(*malloc)(size_t), void (*free)(void*));
+
+	static int useJemalloc(void) {
+		return GoSetCAllocator(je_malloc, je_free);
+	}
+
+GoSetCAllocator returns 0, and changes nothing, if an allocator has
+already been registered or if C memory has already been allocated.
+Once it succeeds, memory from C.CString, C.CBytes and C.malloc must
+be released with the registered free function rather than C.free.
+
 C references to Go
 
 Go functions can be exported for use by C code in the following way:
@@ -234,6 +490,186 @@ copied from the cgo input files. Functions with multiple
 return values are mapped to functions returning a struct.
 Not all Go types can be mapped to C types in a useful way.
 
+Each call from C to an exported function has to enter and leave
+the Go runtime, which is much more expensive than an ordinary C call.
+C code that has many calls ready at once can instead collect them
+and make them all with a single transition, using the GoCall type
+and the GoInvokeVector function declared in _cgo_export.h, along
+with a Name_call function and Name_frame struct declared for each
+exported function:
+
+	GoCall calls[2];
+	struct MyFunction_frame f0;
+	struct MyFunction2_frame f1;
+
+	MyFunction_call(&calls[0], &f0, 1, 2, s);
+	MyFunction2_call(&calls[1], &f1, 3, 4, s);
+	GoInvokeVector(calls, 2);
+	// The results are in f0.r0, f1.r0, and f1.r1.
+
+The calls are made in order, on the calling thread. Each frame
+must remain valid until GoInvokeVector returns.
+
+C code that only needs to tell Go that something happened, such as a
+completion callback, can queue a call instead of making it, and
+continue without waiting for it. For each exported function without
+results whose parameters are all numbers or other types without
+pointers, _cgo_export.h declares a Name_async function with the same
+parameters, which queues a call to Name. GoInvokeAsync queues a call
+set up with Name_call in the same way:
+
+	MyFunction3_async(1, 2);	// Returns before MyFunction3 runs.
+
+GoInvokeAsync copies the frame, but not memory that the arguments
+point to, such as the bytes of a GoString; that memory must remain
+valid until the call has run.
+
+Queuing a call does not enter the Go scheduler, so it does not wait
+for a Go thread or processor to become free. The calls are run by a
+single goroutine, one at a time, in the order they were queued; a call
+that blocks delays all the calls queued after it. The first call to
+queue a call enters Go once, to start that goroutine.
+
+A C library that takes a function pointer, such as qsort's comparator
+or an event handler, can call a Go function value through a pointer
+from runtime/cgo's NewCallback, with no exported dispatcher and no
+table of Go values to look up on each call:
+
+	cmp := cgo.NewCallback(func(a *[cgo.CallbackArgs]uintptr) uintptr {
+		x, y := *(*C.int)(unsafe.Pointer(a[0])), *(*C.int)(unsafe.Pointer(a[1]))
+		return uintptr(x - y)
+	})
+	C.qsort(unsafe.Pointer(&s[0]), C.size_t(len(s)), 4, (*[0]byte)(cmp))
+	cgo.FreeCallback(cmp)
+
+The C function may take up to six integer or pointer arguments and
+return an integer, a pointer or nothing. Up to cgo.MaxCallbacks such
+pointers may exist at once, and each must be released with
+FreeCallback once C no longer calls it.
+
+On GNU/Linux, a C program that no longer needs a library built with
+-buildmode=c-shared can release the library's Go runtime by calling
+
+	int GoReleaseRuntime(void);
+
+from a thread that is not running Go code, once no calls into Go are
+in progress. It stops every goroutine for good, waits for the
+runtime's threads to exit, gives signals back to the handlers that
+were installed before the Go runtime's, and unmaps the Go heap.
+It returns 0 on success; EBUSY, leaving the runtime running, if a
+goroutine is in a call to C or a call into Go has not returned; and
+ETIMEDOUT if the runtime's threads did not exit within a second, for
+example because a goroutine is blocked in a system call. After a
+successful call the library may be closed with dlclose, although its
+code stays mapped; any later call into Go aborts the program.
+
+A GNU/Linux program that forks worker processes after loading a
+library built with -buildmode=c-archive or c-shared can fork with
+
+	pid_t GoForkRuntime(void);
+
+in place of fork, so that the workers inherit the library's running Go
+runtime, with its heap, goroutines and initialized packages, rather
+than start their own. It is called like fork, from a thread that is
+not running Go code, and returns as fork does. It stops the runtime's
+threads for the fork, and the child starts new ones as it needs them;
+goroutines blocked in the kernel by the runtime itself, such as the one
+that waits for timers, are restarted in the child. It fails with
+errno set to EBUSY, without forking, if a goroutine is in a system
+call, in a call to C or locked to its thread, or if the garbage
+collector, CPU profiling or tracing is running; and with EINVAL if the
+program has used the network poller or GoInvokeAsync, whose state
+cannot be shared with a child.
+
+A C program with its own event loop can wait for the network I/O of
+goroutines in that loop, rather than have a thread of the Go runtime
+wait for it and wake others. The generated header declares
+
+	int GoNetpollDescriptor(void);
+	int GoNetpoll(void);
+
+GoNetpollDescriptor returns the descriptor of the runtime's network
+poller, an epoll descriptor, kqueue or event port, or -1 on systems,
+such as Windows, where there is none. The descriptor is readable when
+network I/O may be ready. From then on the runtime leaves waiting for
+it to the program, which must call GoNetpoll whenever it is readable.
+GoNetpoll makes ready the goroutines whose I/O is ready, without
+blocking, and returns how many there were.
+
+C threads that produce a stream of fixed-size items for a goroutine
+can push them into a runtime/cgo Ring, a bounded queue in C memory,
+rather than call into Go for each one. The goroutine creates the ring
+and passes its C pointer to the C code:
+
+	r := cgo.NewRing(int(unsafe.Sizeof(C.struct_sample{})), 1024)
+	C.start_producers(r.C())
+	buf := make([]byte, unsafe.Sizeof(C.struct_sample{}))
+	for {
+		r.Pop(buf)	// Parks the goroutine while the ring is empty.
+		...
+	}
+
+The C code pushes items with
+
+	int GoRingPush(GoRing *ring, const void *elem);
+
+declared in the generated header, which returns 0 if the ring is full.
+Pushing does not enter Go, and any number of threads may push at once.
+If the goroutine is parked in Pop, the push wakes it through a pipe
+that the runtime's network poller watches. Rings are not available on
+Windows.
+
+A C program whose own threads, such as those of a fixed thread pool,
+call into Go often can register each of them once with
+
+	int GoRegisterThread(void);
+
+declared in the generated header. The thread keeps the runtime M it
+is given, with the M's signal stack, until it exits or calls
+
+	void GoUnregisterThread(void);
+
+so that its later calls into Go neither take an M on entry nor give it
+back on return, as with GODEBUG=cgostickym=1 but for that thread
+alone. GoRegisterThread waits for the Go runtime to be initialized,
+and returns 1 if the thread is registered and 0 if it cannot be, as
+on Windows and OpenBSD. GoUnregisterThread must not be called from C
+code called by Go.
+
+Goroutines that lock their thread with runtime.LockOSThread around
+calls to a C library with per-thread state often exit without
+unlocking it. The thread then goes back to running other goroutines
+with that state still set. A program can clear it by registering
+a function with
+
+	void GoSetThreadReset(void (*fn)(void));
+
+declared in the generated header. The runtime calls fn on the thread
+of each goroutine that exits while locked, before another goroutine
+runs there, so the thread can be reused rather than kept aside. fn
+must return quickly and must not call into Go.
+
+A C program that embeds Go can monitor the calls between C and Go
+with
+
+	void GoReadCgoStats(GoCgoStats *stats);
+
+which fills in a struct with the fields of runtime.CgoStats, as Go
+code can read them with runtime.ReadCgoStats: the calls in C, the
+extra Ms lent to threads not created by Go and the waits for them, the
+waits for the runtime to be initialized, the C memory allocated, and
+the cost of pointer checks.
+
+GoReadCgoStats calls into Go, as a call to an exported function does.
+A monitoring thread that polls often can instead call
+
+	int GoReadStats(GoStats *stats);
+
+which copies, with plain loads and without calling into Go, counters
+that the runtime publishes about every 10 milliseconds: the heap size,
+garbage collections and their pauses, the number of goroutines, and
+the main counters of runtime.CgoStats.
+
 Using //export in a file places a restriction on the preamble:
 since it is copied into two different C output files, it must not
 contain any definitions, only declarations. If a file contains both
@@ -278,6 +714,14 @@ Go code may not store a Go pointer in C memory.  C code may store Go
 pointers in C memory, subject to the rule above: it must stop storing
 the Go pointer when the C function returns.
 
+These rules do not apply to pointers to Go objects pinned with a
+runtime.Pinner.  From the call to its Pin method until the call to its
+Unpin method, a pinned object may be pointed to by Go memory passed to
+C, by C memory, and by pointers that C code keeps after the call
+returns.  If the pinned object itself contains Go pointers, the objects
+they point to must be pinned too before C uses them.  Pinning lets C
+code work on a large Go buffer in place, where C.CBytes would copy it.
+
 These rules are checked dynamically at runtime.  The checking is
 controlled by the cgocheck setting of the GODEBUG environment
 variable.  The default setting is GODEBUG=cgocheck=1, which implements
@@ -21,8 +21,10 @@ import (
 	"go/parser"
 	"go/token"
 	"os"
+	"runtime"
 	"strconv"
 	"strings"
+	"sync"
 	"unicode"
 	"unicode/utf8"
 )
@@ -68,7 +70,10 @@ func cname(s string) string {
 
 // DiscardCgoDirectives processes the import C preamble, and discards
 // all #cgo CFLAGS and LDFLAGS directives, so they don't make their
-// way into _cgo_export.h.
+// way into _cgo_export.h. It records the functions named in #cgo leaf:,
+// batch:, async:, affinity:, stack: and limit: directives, and the types
+// named in #cgo layout: directives, which are for cgo itself rather than
+// for the build system.
 func (f *File) DiscardCgoDirectives() {
 	linesIn := strings.Split(f.Preamble, "\n")
 	linesOut := make([]string, 0, len(linesIn))
@@ -77,12 +82,207 @@ func (f *File) DiscardCgoDirectives() {
 		if len(l) < 5 || l[:4] != "#cgo" || !unicode.IsSpace(rune(l[4])) {
 			linesOut = append(linesOut, line)
 		} else {
+			f.saveFuncDirective(l)
 			linesOut = append(linesOut, "")
 		}
 	}
 	f.Preamble = strings.Join(linesOut, "\n")
 }
 
+// saveFuncDirective records the function names in line if it is a
+//	#cgo leaf: name...
+// or
+//	#cgo batch: name...
+// or
+//	#cgo async: name...
+// or
+//	#cgo affinity: name...
+// or
+//	#cgo stack: name=size...
+// or
+//	#cgo limit: name,...=n...
+// or
+//	#cgo layout: GoType=ctype...
+// directive.
+func (f *File) saveFuncDirective(line string) {
+	line = strings.TrimSpace(line[4:])
+	i := strings.Index(line, ":")
+	if i < 0 {
+		return
+	}
+	verb := strings.Fields(line[:i])
+	if len(verb) == 0 {
+		return
+	}
+	v := verb[len(verb)-1]
+	var list *[]string
+	switch v {
+	case "leaf":
+		list = &f.Leaf
+	case "batch":
+		list = &f.Batch
+	case "async":
+		list = &f.Async
+	case "affinity":
+		list = &f.Affinity
+	case "stack", "limit", "layout":
+	default:
+		return
+	}
+	if len(verb) > 1 {
+		error_(token.NoPos, "#cgo %s: directive does not take GOOS/GOARCH conditions: %s", v, line)
+		return
+	}
+	switch v {
+	case "stack":
+		f.saveStackDirective(line[i+1:])
+		return
+	case "limit":
+		f.saveLimitDirective(line[i+1:])
+		return
+	case "layout":
+		f.saveLayoutDirective(line[i+1:])
+		return
+	}
+	for _, name := range strings.Fields(line[i+1:]) {
+		if !isName(name) {
+			error_(token.NoPos, "#cgo %s: invalid C function name %q", v, name)
+			continue
+		}
+		*list = append(*list, name)
+	}
+}
+
+// maxCgoStack is the largest stack size a #cgo stack: directive may
+// declare. Keep in sync with runtime.cgoStackCallMax.
+const maxCgoStack = 64 << 10
+
+// saveStackDirective records the sizes in the name=size arguments of a
+// #cgo stack: directive.
+func (f *File) saveStackDirective(args string) {
+	for _, arg := range strings.Fields(args) {
+		i := strings.Index(arg, "=")
+		if i < 0 {
+			error_(token.NoPos, "#cgo stack: missing stack size for %q; want name=size", arg)
+			continue
+		}
+		name := arg[:i]
+		if !isName(name) {
+			error_(token.NoPos, "#cgo stack: invalid C function name %q", name)
+			continue
+		}
+		size, err := strconv.ParseInt(arg[i+1:], 0, 64)
+		if err != nil || size <= 0 || size > maxCgoStack {
+			error_(token.NoPos, "#cgo stack: invalid stack size %q for %s; want 1 to %d bytes", arg[i+1:], name, maxCgoStack)
+			continue
+		}
+		if f.Stack == nil {
+			f.Stack = make(map[string]int64)
+		}
+		f.Stack[name] = size
+	}
+}
+
+// maxCgoLimit is the largest limit a #cgo limit: directive may set.
+const maxCgoLimit = 1 << 20
+
+// saveLimitDirective records the limits in the names=n arguments of a
+// #cgo limit: directive, where names is one C function name or several
+// separated by commas.
+func (f *File) saveLimitDirective(args string) {
+	for _, arg := range strings.Fields(args) {
+		i := strings.Index(arg, "=")
+		if i < 0 {
+			error_(token.NoPos, "#cgo limit: missing limit for %q; want name=n", arg)
+			continue
+		}
+		l := &Limit{Funcs: strings.Split(arg[:i], ",")}
+		ok := true
+		for _, name := range l.Funcs {
+			if !isName(name) {
+				error_(token.NoPos, "#cgo limit: invalid C function name %q", name)
+				ok = false
+			}
+		}
+		n, err := strconv.ParseInt(arg[i+1:], 0, 64)
+		if err != nil || n <= 0 || n > maxCgoLimit {
+			error_(token.NoPos, "#cgo limit: invalid limit %q for %s; want 1 to %d calls", arg[i+1:], arg[:i], maxCgoLimit)
+			ok = false
+		}
+		if ok {
+			l.N = n
+			f.Limit = append(f.Limit, l)
+		}
+	}
+}
+
+// RecordFuncDirectives adds the functions named in f's #cgo leaf:,
+// batch:, async:, affinity:, stack: and limit: directives to the package-wide
+// sets. It must be called for every file before any file is translated,
+// since the directives apply to the whole package. A function named in
+// stack: directives of several files gets the largest of the sizes.
+// Several files may repeat a limit: directive, but a function may not
+// be in two different limits. The same holds for layout: directives
+// and Go types.
+func (p *Package) RecordFuncDirectives(f *File) {
+	for _, name := range f.Leaf {
+		if p.LeafFuncs == nil {
+			p.LeafFuncs = make(map[string]bool)
+		}
+		p.LeafFuncs[name] = true
+	}
+	for _, name := range f.Batch {
+		if p.BatchFuncs == nil {
+			p.BatchFuncs = make(map[string]bool)
+		}
+		p.BatchFuncs[name] = true
+	}
+	for _, name := range f.Async {
+		if p.AsyncFuncs == nil {
+			p.AsyncFuncs = make(map[string]bool)
+		}
+		p.AsyncFuncs[name] = true
+	}
+	for _, name := range f.Affinity {
+		if p.AffineFuncs == nil {
+			p.AffineFuncs = make(map[string]bool)
+		}
+		p.AffineFuncs[name] = true
+	}
+	for name, size := range f.Stack {
+		if p.StackFuncs == nil {
+			p.StackFuncs = make(map[string]int64)
+		}
+		if size > p.StackFuncs[name] {
+			p.StackFuncs[name] = size
+		}
+	}
+	for _, l := range f.Limit {
+		for _, name := range l.Funcs {
+			if p.LimitFuncs == nil {
+				p.LimitFuncs = make(map[string]*Limit)
+			}
+			if old := p.LimitFuncs[name]; old != nil {
+				if old.N != l.N || strings.Join(old.Funcs, ",") != strings.Join(l.Funcs, ",") {
+					error_(token.NoPos, "#cgo limit: C function %s is in more than one limit", name)
+				}
+				continue
+			}
+			p.LimitFuncs[name] = l
+		}
+	}
+	for goname, cn := range f.Layout {
+		if p.LayoutTypes == nil {
+			p.LayoutTypes = make(map[string]string)
+		}
+		if old := p.LayoutTypes[goname]; old != "" && old != cn {
+			error_(token.NoPos, "#cgo layout: %s has the layout of both C.%s and C.%s", goname, fixGo(old), fixGo(cn))
+			continue
+		}
+		p.LayoutTypes[goname] = cn
+	}
+}
+
 // addToFlag appends args to flag. All flags are later written out onto the
 // _cgo_flags file for the build system to use.
 func (p *Package) addToFlag(flag string, args []string) {
@@ -154,31 +354,87 @@ func splitQuoted(s string) (r []string, err error) {
 	return args, err
 }
 
-// Translate rewrites f.AST, the original Go input, to remove
-// references to the imported package C, replacing them with
+// Translate rewrites the ASTs of the files fs, the original Go input,
+// to remove references to the imported package C, replacing them with
 // references to the equivalent Go types, functions, and variables.
-func (p *Package) Translate(f *File) {
-	for _, cref := range f.Ref {
-		// Convert C.ulong to C.unsigned long, etc.
-		cref.Name.C = cname(cref.Name.Go)
-	}
-	p.loadDefines(f)
-	needType := p.guessKinds(f)
-	if len(needType) > 0 {
-		p.loadDWARF(f, needType)
-	}
-	p.rewriteCalls(f)
-	p.rewriteRef(f)
+//
+// Each of loadDefines, guessKinds and loadDWARF runs gcc once per file.
+// The runs for different files are independent, so each step starts
+// them together (see gccEach) and then reads their output in file
+// order, which keeps the result independent of scheduling.
+func (p *Package) Translate(fs []*File) {
+	for _, f := range fs {
+		for _, cref := range f.Ref {
+			// Convert C.ulong to C.unsigned long, etc.
+			cref.Name.C = cname(cref.Name.Go)
+
+			// C.batch_foo is the batch form of C.foo, if foo is named
+			// in a #cgo batch: directive.
+			if strings.HasPrefix(cref.Name.Go, "batch_") && p.BatchFuncs[cref.Name.Go[len("batch_"):]] {
+				cref.Name.C = cref.Name.Go[len("batch_"):]
+				cref.Name.Batch = true
+			}
+		}
+	}
+	p.addLayoutNames(fs)
+	p.loadDefines(fs)
+	needType := p.guessKinds(fs)
+	p.loadDWARF(fs, needType)
+	p.applyLayouts(fs)
+	for _, f := range fs {
+		p.findInline(f)
+		p.rewriteCalls(f)
+		p.rewriteRef(f)
+	}
+}
+
+// gccEach calls fn(i) for each i in [0, n), running up to
+// runtime.NumCPU() calls at once. With -debug-gcc it runs them one
+// at a time, so that the printed commands and output do not mix.
+func gccEach(n int, fn func(i int)) {
+	par := runtime.NumCPU()
+	if *debugGcc {
+		par = 1
+	}
+	if par > n {
+		par = n
+	}
+	work := make(chan int, n)
+	for i := 0; i < n; i++ {
+		work <- i
+	}
+	close(work)
+	var wg sync.WaitGroup
+	for j := 0; j < par; j++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := range work {
+				fn(i)
+			}
+		}()
+	}
+	wg.Wait()
 }
 
 // loadDefines coerces gcc into spitting out the #defines in use
-// in the file f and saves relevant renamings in f.Name[name].Define.
-func (p *Package) loadDefines(f *File) {
-	var b bytes.Buffer
-	b.WriteString(f.Preamble)
-	b.WriteString(builtinProlog)
-	stdout := p.gccDefines(b.Bytes())
+// in each file f and saves relevant renamings in f.Name[name].Define.
+func (p *Package) loadDefines(fs []*File) {
+	stdouts := make([]string, len(fs))
+	gccEach(len(fs), func(i int) {
+		var b bytes.Buffer
+		b.WriteString(fs[i].Preamble)
+		b.WriteString(builtinProlog)
+		stdouts[i] = p.gccDefines(b.Bytes())
+	})
+	for i, f := range fs {
+		p.recordDefines(f, stdouts[i])
+	}
+}
 
+// recordDefines saves the renamings for file f
+// from stdout, the output of gccDefines.
+func (p *Package) recordDefines(f *File, stdout string) {
 	for _, line := range strings.Split(stdout, "\n") {
 		if len(line) < 9 || line[0:7] != "#define" {
 			continue
@@ -216,10 +472,39 @@ func (p *Package) loadDefines(f *File) {
 // guessKinds tricks gcc into revealing the kind of each
 // name xxx for the references C.xxx in the Go input.
 // The kind is either a constant, type, or variable.
-func (p *Package) guessKinds(f *File) []*Name {
+// It returns, for each file, the names whose types loadDWARF
+// must look up.
+func (p *Package) guessKinds(fs []*File) [][]*Name {
+	names := make([][]*Name, len(fs))
+	needType := make([][]*Name, len(fs))
+	probes := make([][]byte, len(fs))
+	for i, f := range fs {
+		names[i], needType[i] = p.knownKinds(f)
+		if len(names[i]) > 0 {
+			probes[i] = p.kindProbe(f, names[i])
+		}
+	}
+	stderrs := make([]string, len(fs))
+	gccEach(len(fs), func(i int) {
+		if probes[i] != nil {
+			stderrs[i] = p.gccErrors(probes[i], i)
+		}
+	})
+	for i, f := range fs {
+		if probes[i] != nil {
+			p.sniffKinds(f, names[i], probes[i], stderrs[i])
+			needType[i] = append(needType[i], names[i]...)
+		}
+	}
+	return needType
+}
+
+// knownKinds determines the kinds of the names in file f that
+// do not need gcc, like #defines or 'struct foo'. It returns the
+// names left for gcc and the names whose types need looking up.
+func (p *Package) knownKinds(f *File) (names, needType []*Name) {
 	// Determine kinds for names we already know about,
 	// like #defines or 'struct foo', before bothering with gcc.
-	var names, needType []*Name
 	for _, key := range nameKeys(f.Name) {
 		n := f.Name[key]
 		// If we've already found this name as a #define
@@ -265,11 +550,12 @@ func (p *Package) guessKinds(f *File) []*Name {
 		names = append(names, n)
 	}
 
-	// Bypass gcc if there's nothing left to find out.
-	if len(names) == 0 {
-		return needType
-	}
+	return names, needType
+}
 
+// kindProbe returns the C program that sniffKinds
+// expects gcc to fail to compile.
+func (p *Package) kindProbe(f *File, names []*Name) []byte {
 	// Coerce gcc into telling us whether each name is a type, a value, or undeclared.
 	// For names, find out whether they are integer constants.
 	// We used to look at specific warning or error messages here, but that tied the
@@ -312,10 +598,14 @@ func (p *Package) guessKinds(f *File) []*Name {
 	}
 	fmt.Fprintf(&b, "#line 1 \"completed\"\n"+
 		"int __cgo__1 = __cgo__2;\n")
+	return b.Bytes()
+}
 
-	stderr := p.gccErrors(b.Bytes())
+// sniffKinds sets the kinds of names from stderr, the errors gcc
+// reported for the program b returned by kindProbe.
+func (p *Package) sniffKinds(f *File, names []*Name, b []byte, stderr string) {
 	if stderr == "" {
-		fatalf("%s produced no output\non input:\n%s", p.gccBaseCmd()[0], b.Bytes())
+		fatalf("%s produced no output\non input:\n%s", p.gccBaseCmd()[0], b)
 	}
 
 	completed := false
@@ -367,7 +657,7 @@ func (p *Package) guessKinds(f *File) []*Name {
 	}
 
 	if !completed {
-		fatalf("%s did not produce error at completed:1\non input:\n%s\nfull error output:\n%s", p.gccBaseCmd()[0], b.Bytes(), stderr)
+		fatalf("%s did not produce error at completed:1\non input:\n%s\nfull error output:\n%s", p.gccBaseCmd()[0], b, stderr)
 	}
 
 	for i, n := range names {
@@ -386,22 +676,42 @@ func (p *Package) guessKinds(f *File) []*Name {
 		// Check if compiling the preamble by itself causes any errors,
 		// because the messages we've printed out so far aren't helpful
 		// to users debugging preamble mistakes. See issue 8442.
-		preambleErrors := p.gccErrors([]byte(f.Preamble))
+		preambleErrors := p.gccErrors([]byte(f.Preamble), 0)
 		if len(preambleErrors) > 0 {
 			error_(token.NoPos, "\n%s errors for preamble:\n%s", p.gccBaseCmd()[0], preambleErrors)
 		}
 
 		fatalf("unresolved names")
 	}
-
-	needType = append(needType, names...)
-	return needType
 }
 
 // loadDWARF parses the DWARF debug information generated
 // by gcc to learn the details of the constants, variables, and types
-// being referred to as C.xxx.
-func (p *Package) loadDWARF(f *File, names []*Name) {
+// being referred to as C.xxx. names[i] are the names of file fs[i].
+func (p *Package) loadDWARF(fs []*File, names [][]*Name) {
+	type debug struct {
+		d    *dwarf.Data
+		bo   binary.ByteOrder
+		data []byte
+	}
+	debugs := make([]debug, len(fs))
+	gccEach(len(fs), func(i int) {
+		if len(names[i]) > 0 {
+			d := &debugs[i]
+			d.d, d.bo, d.data = p.gccDebug(p.dwarfProbe(names[i], fs[i]), i)
+		}
+	})
+	for i, f := range fs {
+		if len(names[i]) > 0 {
+			d := debugs[i]
+			p.recordTypes(f, names[i], d.d, d.bo, d.data)
+		}
+	}
+}
+
+// dwarfProbe returns the C program whose debug information
+// describes names, which are in file f.
+func (p *Package) dwarfProbe(names []*Name, f *File) []byte {
 	// Extract the types from the DWARF section of an object
 	// from a well-formed C program. Gcc only generates DWARF info
 	// for symbols in the object file, so it is not enough to print the
@@ -439,8 +749,13 @@ func (p *Package) loadDWARF(f *File, names []*Name) {
 	// this)
 	fmt.Fprintf(&b, "\t1\n")
 	fmt.Fprintf(&b, "};\n")
+	return b.Bytes()
+}
 
-	d, bo, debugData := p.gccDebug(b.Bytes())
+// recordTypes sets the types of names, which are in file f, from the
+// debug information d and the data block debugData that gcc produced
+// for the program returned by dwarfProbe.
+func (p *Package) recordTypes(f *File, names []*Name, d *dwarf.Data, bo binary.ByteOrder, debugData []byte) {
 	enumVal := make([]int64, len(debugData)/8)
 	for i := range enumVal {
 		enumVal[i] = int64(bo.Uint64(debugData[i*8:]))
@@ -585,17 +900,33 @@ func (p *Package) rewriteCalls(f *File) {
 		if goname == "malloc" {
 			continue
 		}
+		if builtinDefs[goname] != "" {
+			// The builtins copy from their arguments and
+			// pass no Go pointer to C.
+			continue
+		}
 		name := f.Name[goname]
 		if name.Kind != "func" {
 			// Probably a type conversion.
 			continue
 		}
+		if name.Batch {
+			// The arguments are slices; the generated
+			// function checks them itself.
+			continue
+		}
+		if name.Inline != "" {
+			// A static inline accessor only reads
+			// through its argument; see inline.go.
+			continue
+		}
 		p.rewriteCall(f, call, name)
 	}
 }
 
 // rewriteCall rewrites one call to add pointer checks. We replace
-// each pointer argument x with _cgoCheckPointer(x).(T).
+// each pointer argument x with _cgoCheckPointer(x).(T), or with a
+// call to a check specialized to T when ptrCheckName permits.
 func (p *Package) rewriteCall(f *File, call *ast.CallExpr, name *Name) {
 	for i, param := range name.FuncType.Params {
 		if len(call.Args) <= i {
@@ -628,6 +959,16 @@ func (p *Package) rewriteCall(f *File, call *ast.CallExpr, name *Name) {
 		// expression.
 		c.Args = p.checkAddrArgs(f, c.Args, call.Args[i])
 
+		// For a pointer parameter we can usually call a check
+		// specialized to the parameter type, which passes nil
+		// and C pointers through without building an interface.
+		if n := p.ptrCheckName(param.Go, c.Args[1:]); n != "" {
+			c.Fun = ast.NewIdent(n)
+			c.Args = c.Args[:1]
+			call.Args[i] = c
+			continue
+		}
+
 		// _cgoCheckPointer returns interface{}.
 		// We need to type assert that to the type we want.
 		// If the Go version of this C type uses
@@ -704,6 +1045,10 @@ func (p *Package) hasPointer(f *File, t ast.Expr, top bool) bool {
 	case *ast.FuncType, *ast.InterfaceType, *ast.MapType, *ast.ChanType:
 		return true
 	case *ast.Ident:
+		if p.LayoutTypes[t.Name] != "" {
+			// Checked by checkLayout.
+			return false
+		}
 		// TODO: Handle types defined within function.
 		for _, d := range p.Decl {
 			gd, ok := d.(*ast.GenDecl)
@@ -898,6 +1243,62 @@ func (p *Package) hasUnsafePointer(t ast.Expr) bool {
 	return false
 }
 
+// A ptrCheck describes a pointer check specialized to one parameter
+// type, as built by ptrCheckName.
+type ptrCheck struct {
+	Type string // Go version of the C parameter type
+	Elem bool   // whether only the pointed-to element needs checking
+}
+
+// ptrCheckName is given the Go version of a C parameter type and the
+// additional arguments that checkAddrArgs chose for _cgoCheckPointer.
+// If t is a pointer type and the additional arguments do not name a
+// slice or array, we arrange to build a function that takes and
+// returns a t and only calls _cgoCheckPointer if the argument is a Go
+// pointer. We return the name of that function, or the empty string
+// if the generic _cgoCheckPointer must be used.
+func (p *Package) ptrCheckName(t ast.Expr, args []ast.Expr) string {
+	if *gccgo {
+		return ""
+	}
+	switch t := t.(type) {
+	case *ast.StarExpr:
+	case *ast.Ident:
+		if t.Name != "unsafe.Pointer" {
+			return ""
+		}
+	default:
+		return ""
+	}
+	var c ptrCheck
+	switch len(args) {
+	case 0:
+	case 1:
+		if id, ok := args[0].(*ast.Ident); !ok || id.Name != "true" {
+			return ""
+		}
+		c.Elem = true
+	default:
+		return ""
+	}
+	var buf bytes.Buffer
+	conf.Fprint(&buf, fset, t)
+	c.Type = buf.String()
+	for i, pc := range p.PtrChecks {
+		if pc == c {
+			return p.ptrCheckNameIndex(i)
+		}
+	}
+	p.PtrChecks = append(p.PtrChecks, c)
+	return p.ptrCheckNameIndex(len(p.PtrChecks) - 1)
+}
+
+// ptrCheckNameIndex returns the name to use for a specialized pointer
+// check based on the index in the PtrChecks slice.
+func (p *Package) ptrCheckNameIndex(i int) string {
+	return fmt.Sprintf("_cgoCheckPtr%d", i)
+}
+
 // unsafeCheckPointerNameIndex returns the name to use for a
 // _cgoCheckPointer variant based on the index in the CgoChecks slice.
 func (p *Package) unsafeCheckPointerNameIndex(i int) string {
@@ -952,11 +1353,19 @@ func (p *Package) rewriteRef(f *File) {
 				break
 			}
 			functions[r.Name.Go] = true
+			if r.Name.Batch && *gccgo {
+				error_(r.Pos(), "C.%s: batch calls are not supported with gccgo", fixGo(r.Name.Go))
+				break
+			}
 			if r.Context == "call2" {
 				if r.Name.Go == "_CMalloc" {
 					error_(r.Pos(), "no two-result form for C.malloc")
 					break
 				}
+				if r.Name.Batch {
+					error_(r.Pos(), "no two-result form for C.%s", fixGo(r.Name.Go))
+					break
+				}
 				// Invent new Name for the two-result function.
 				n := f.Name["2"+r.Name.Go]
 				if n == nil {
@@ -971,6 +1380,10 @@ func (p *Package) rewriteRef(f *File) {
 				break
 			}
 		case "expr":
+			if r.Name.Kind == "func" && r.Name.Batch {
+				error_(r.Pos(), "C.%s can only be called", fixGo(r.Name.Go))
+				break
+			}
 			if r.Name.Kind == "func" {
 				// Function is being used in an expression, to e.g. pass around a C function pointer.
 				// Create a new Name for this Ref which causes the variable to be declared in Go land.
@@ -1095,20 +1508,22 @@ func (p *Package) gccMachine() []string {
 	return nil
 }
 
-func gccTmp() string {
-	return *objDir + "_cgo_.o"
+// gccTmp returns the name of the object file
+// for the gcc run for the i'th input file.
+func gccTmp(i int) string {
+	return *objDir + fmt.Sprintf("_cgo_%d_.o", i)
 }
 
 // gccCmd returns the gcc command line to use for compiling
-// the input.
-func (p *Package) gccCmd() []string {
+// the input into the object file tmp.
+func (p *Package) gccCmd(tmp string) []string {
 	c := append(p.gccBaseCmd(),
-		"-w",          // no warnings
-		"-Wno-error",  // warnings are not errors
-		"-o"+gccTmp(), // write object to tmp
-		"-gdwarf-2",   // generate DWARF v2 debugging symbols
-		"-c",          // do not link
-		"-xc",         // input language is C
+		"-w",         // no warnings
+		"-Wno-error", // warnings are not errors
+		"-o"+tmp,     // write object to tmp
+		"-gdwarf-2",  // generate DWARF v2 debugging symbols
+		"-c",         // do not link
+		"-xc",        // input language is C
 	)
 	if p.GccIsClang {
 		c = append(c,
@@ -1131,26 +1546,37 @@ func (p *Package) gccCmd() []string {
 	}
 
 	c = append(c, p.GccOptions...)
+	for _, opt := range p.GccOptions {
+		if strings.HasPrefix(opt, "-flto") {
+			// We read the DWARF from the object, so it
+			// must not be link-time optimization bytecode.
+			c = append(c, "-fno-lto")
+			break
+		}
+	}
 	c = append(c, p.gccMachine()...)
 	c = append(c, "-") //read input from standard input
 	return c
 }
 
-// gccDebug runs gcc -gdwarf-2 over the C program stdin and
-// returns the corresponding DWARF data and, if present, debug data block.
-func (p *Package) gccDebug(stdin []byte) (*dwarf.Data, binary.ByteOrder, []byte) {
-	runGcc(stdin, p.gccCmd())
+// gccDebug runs gcc -gdwarf-2 over the C program stdin for the i'th
+// input file and returns the corresponding DWARF data and, if present,
+// debug data block.
+func (p *Package) gccDebug(stdin []byte, i int) (*dwarf.Data, binary.ByteOrder, []byte) {
+	tmp := gccTmp(i)
+	runGcc(stdin, p.gccCmd(tmp), tmp)
+	defer os.Remove(tmp)
 
 	isDebugData := func(s string) bool {
 		// Some systems use leading _ to denote non-assembly symbols.
 		return s == "__cgodebug_data" || s == "___cgodebug_data"
 	}
 
-	if f, err := macho.Open(gccTmp()); err == nil {
+	if f, err := macho.Open(tmp); err == nil {
 		defer f.Close()
 		d, err := f.DWARF()
 		if err != nil {
-			fatalf("cannot load DWARF output from %s: %v", gccTmp(), err)
+			fatalf("cannot load DWARF output from %s: %v", tmp, err)
 		}
 		var data []byte
 		if f.Symtab != nil {
@@ -1172,11 +1598,11 @@ func (p *Package) gccDebug(stdin []byte) (*dwarf.Data, binary.ByteOrder, []byte)
 		return d, f.ByteOrder, data
 	}
 
-	if f, err := elf.Open(gccTmp()); err == nil {
+	if f, err := elf.Open(tmp); err == nil {
 		defer f.Close()
 		d, err := f.DWARF()
 		if err != nil {
-			fatalf("cannot load DWARF output from %s: %v", gccTmp(), err)
+			fatalf("cannot load DWARF output from %s: %v", tmp, err)
 		}
 		var data []byte
 		symtab, err := f.Symbols()
@@ -1199,11 +1625,11 @@ func (p *Package) gccDebug(stdin []byte) (*dwarf.Data, binary.ByteOrder, []byte)
 		return d, f.ByteOrder, data
 	}
 
-	if f, err := pe.Open(gccTmp()); err == nil {
+	if f, err := pe.Open(tmp); err == nil {
 		defer f.Close()
 		d, err := f.DWARF()
 		if err != nil {
-			fatalf("cannot load DWARF output from %s: %v", gccTmp(), err)
+			fatalf("cannot load DWARF output from %s: %v", tmp, err)
 		}
 		var data []byte
 		for _, s := range f.Symbols {
@@ -1221,7 +1647,7 @@ func (p *Package) gccDebug(stdin []byte) (*dwarf.Data, binary.ByteOrder, []byte)
 		return d, binary.LittleEndian, data
 	}
 
-	fatalf("cannot parse gcc output %s as ELF, Mach-O, PE object", gccTmp())
+	fatalf("cannot parse gcc output %s as ELF, Mach-O, PE object", tmp)
 	panic("not reached")
 }
 
@@ -1232,23 +1658,25 @@ func (p *Package) gccDebug(stdin []byte) (*dwarf.Data, binary.ByteOrder, []byte)
 func (p *Package) gccDefines(stdin []byte) string {
 	base := append(p.gccBaseCmd(), "-E", "-dM", "-xc")
 	base = append(base, p.gccMachine()...)
-	stdout, _ := runGcc(stdin, append(append(base, p.GccOptions...), "-"))
+	stdout, _ := runGcc(stdin, append(append(base, p.GccOptions...), "-"), "")
 	return stdout
 }
 
-// gccErrors runs gcc over the C program stdin and returns
-// the errors that gcc prints. That is, this function expects
-// gcc to fail.
-func (p *Package) gccErrors(stdin []byte) string {
+// gccErrors runs gcc over the C program stdin for the i'th input
+// file and returns the errors that gcc prints. That is, this function
+// expects gcc to fail.
+func (p *Package) gccErrors(stdin []byte, i int) string {
 	// TODO(rsc): require failure
-	args := p.gccCmd()
+	tmp := gccTmp(i)
+	args := p.gccCmd(tmp)
+	defer os.Remove(tmp)
 
 	if *debugGcc {
 		fmt.Fprintf(os.Stderr, "$ %s <<EOF\n", strings.Join(args, " "))
 		os.Stderr.Write(stdin)
 		fmt.Fprint(os.Stderr, "EOF\n")
 	}
-	stdout, stderr, _ := run(stdin, args)
+	stdout, stderr, _ := runCached(stdin, args, tmp)
 	if *debugGcc {
 		os.Stderr.Write(stdout)
 		os.Stderr.Write(stderr)
@@ -1262,13 +1690,14 @@ func (p *Package) gccErrors(stdin []byte) string {
 // Otherwise runGcc returns the data written to standard output and standard error.
 // Note that for some of the uses we expect useful data back
 // on standard error, but for those uses gcc must still exit 0.
-func runGcc(stdin []byte, args []string) (string, string) {
+// If obj is not empty, the command writes an object file named obj.
+func runGcc(stdin []byte, args []string, obj string) (string, string) {
 	if *debugGcc {
 		fmt.Fprintf(os.Stderr, "$ %s <<EOF\n", strings.Join(args, " "))
 		os.Stderr.Write(stdin)
 		fmt.Fprint(os.Stderr, "EOF\n")
 	}
-	stdout, stderr, ok := run(stdin, args)
+	stdout, stderr, ok := runCached(stdin, args, obj)
 	if *debugGcc {
 		os.Stderr.Write(stdout)
 		os.Stderr.Write(stderr)
@@ -1646,6 +2075,7 @@ func (c *typeConv) Type(dtype dwarf.Type, pos token.Pos) *Type {
 			}
 			tt.Go = g
 			typedef[name.Name] = &tt
+			cstructs[name.Name] = dt
 		}
 
 	case *dwarf.TypedefType:
@@ -0,0 +1,349 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Static inline accessors written in Go.
+//
+// A preamble often defines small static inline functions that only
+// read a field of a struct or return a constant, like
+//
+//	static inline int point_x(struct point *p) { return p->x; }
+//
+// Calling such a function through the usual wrapper costs a full
+// transition from Go to C to do one load. When the body of the
+// function is exactly a return of a field of its only parameter,
+// or of an integer constant, cgo writes the same access in Go.
+
+package main
+
+import (
+	"go/ast"
+	"go/scanner"
+	"go/token"
+	"strconv"
+	"strings"
+)
+
+// An inlineTok is a token of the preamble.
+type inlineTok struct {
+	tok token.Token
+	lit string
+}
+
+// findInline sets the Inline field of the functions referred to by f
+// that are defined in its preamble as simple accessors.
+func (p *Package) findInline(f *File) {
+	bodies := inlineBodies(f.Preamble)
+	for _, n := range f.Name {
+		if n.Kind != "func" || n.Define != "" || n.Batch || n.FuncType == nil {
+			continue
+		}
+		if b := bodies[n.C]; b != nil {
+			n.Inline = p.inlineExpr(n, b)
+		}
+	}
+}
+
+// inlineBodies returns the static inline functions defined in the
+// preamble whose bodies are a single return statement, mapped to
+// the parameter names followed by the tokens of the returned
+// expression. It leaves out functions defined inside #if blocks or
+// more than once, and bodies that use macros the preamble defines.
+func inlineBodies(preamble string) map[string][]inlineTok {
+	toks, macros := preambleTokens(preamble)
+	bodies := make(map[string][]inlineTok)
+	start := 0 // first token of the current top-level declaration
+	depth := 0
+	for i := 0; i < len(toks); i++ {
+		switch toks[i].tok {
+		case token.LBRACE:
+			if depth == 0 {
+				if name, b := inlineFunc(toks[start:], i-start); name != "" {
+					if _, dup := bodies[name]; dup {
+						b = []inlineTok{}
+					}
+					bodies[name] = b
+				}
+			}
+			depth++
+		case token.RBRACE:
+			if depth--; depth == 0 {
+				start = i + 1
+			}
+		case token.SEMICOLON, token.ILLEGAL:
+			if depth == 0 {
+				start = i + 1
+			}
+		}
+	}
+	for name, b := range bodies {
+		for _, t := range b {
+			if macros[t.lit] {
+				b = nil
+				break
+			}
+		}
+		if len(b) == 0 || macros[name] {
+			delete(bodies, name)
+		}
+	}
+	return bodies
+}
+
+// preambleTokens returns the tokens of the preamble outside any
+// preprocessor directive or #if block, and the names of the macros
+// it defines.
+func preambleTokens(preamble string) ([]inlineTok, map[string]bool) {
+	// Drop the preprocessor directives and the lines they may skip.
+	var src []byte
+	macros := make(map[string]bool)
+	cond := 0
+	cont := false
+	for _, line := range strings.Split(preamble, "\n") {
+		d := strings.Fields(strings.Replace(strings.TrimSpace(line), "#", "# ", 1))
+		if cont {
+			// Continuation of a directive.
+			d = []string{"#"}
+		}
+		cont = strings.HasSuffix(line, "\\") && len(d) > 0 && d[0] == "#"
+		if len(d) == 0 || d[0] != "#" {
+			if cond == 0 {
+				src = append(src, line...)
+			}
+			src = append(src, '\n')
+			continue
+		}
+		src = append(src, '\n')
+		if len(d) < 2 {
+			continue
+		}
+		switch d[1] {
+		case "if", "ifdef", "ifndef":
+			cond++
+		case "endif":
+			cond--
+		case "define":
+			if len(d) > 2 {
+				name := d[2]
+				if i := strings.Index(name, "("); i >= 0 {
+					name = name[:i]
+				}
+				macros[name] = true
+			}
+		}
+	}
+
+	var s scanner.Scanner
+	fs := token.NewFileSet()
+	// C is not Go, so there may be errors; they only end up as
+	// ILLEGAL tokens.
+	s.Init(fs.AddFile("", fs.Base(), len(src)), src, nil, scanner.ScanComments)
+	var toks []inlineTok
+	for {
+		_, tok, lit := s.Scan()
+		if tok == token.EOF {
+			break
+		}
+		if tok == token.COMMENT || tok == token.SEMICOLON && lit == "\n" {
+			continue
+		}
+		toks = append(toks, inlineTok{tok, lit})
+	}
+	return toks, macros
+}
+
+// inlineFunc checks whether toks, with the opening brace at index
+// lbrace, starts a static inline function whose body is a single
+// return statement. If so, it returns the name of the function and
+// the name of its parameter, if any, followed by the tokens of the
+// returned expression. Otherwise it returns "" and nil.
+func inlineFunc(toks []inlineTok, lbrace int) (string, []inlineTok) {
+	// The header: static inline ... name ( params )
+	if lbrace < 3 || toks[lbrace-1].tok != token.RPAREN {
+		return "", nil
+	}
+	lparen := -1
+	for i := lbrace - 2; i >= 0; i-- {
+		if toks[i].tok == token.LPAREN {
+			lparen = i
+			break
+		}
+		if toks[i].tok == token.RPAREN {
+			return "", nil
+		}
+	}
+	if lparen < 1 || toks[lparen-1].tok != token.IDENT {
+		return "", nil
+	}
+	name := toks[lparen-1].lit
+	static, inline := false, false
+	for _, t := range toks[:lparen-1] {
+		switch t.lit {
+		case "static":
+			static = true
+		case "inline", "__inline", "__inline__":
+			inline = true
+		}
+	}
+	if !static || !inline {
+		return "", nil
+	}
+	var param []inlineTok
+	switch params := toks[lparen+1 : lbrace-1]; {
+	case len(params) == 0, len(params) == 1 && params[0].lit == "void":
+	default:
+		for _, t := range params {
+			if t.tok == token.COMMA {
+				return "", nil
+			}
+		}
+		last := params[len(params)-1]
+		if last.tok != token.IDENT {
+			return "", nil
+		}
+		param = []inlineTok{last}
+	}
+
+	// The body: { return expr ; }
+	body := toks[lbrace+1:]
+	if len(body) < 4 || body[0].tok != token.RETURN {
+		return "", nil
+	}
+	for i, t := range body[1:] {
+		if t.tok == token.SEMICOLON {
+			if i+2 >= len(body) || body[i+2].tok != token.RBRACE {
+				return "", nil
+			}
+			return name, append(param, body[1:i+1]...)
+		}
+		if t.tok == token.LBRACE || t.tok == token.RBRACE {
+			return "", nil
+		}
+	}
+	return "", nil
+}
+
+// inlineExpr returns the Go expression, in terms of the parameter p0
+// of the Go function for n, that computes the body b found by
+// inlineBodies, or "" if there is none.
+func (p *Package) inlineExpr(n *Name, b []inlineTok) string {
+	ft := n.FuncType
+	if ft.Result == nil {
+		return ""
+	}
+	switch {
+	case len(ft.Params) == 0 && len(b) == 1 && b[0].tok == token.INT:
+		// return constant;
+		v, err := strconv.ParseUint(b[0].lit, 0, 64)
+		if err != nil || !inlineNumeric(ft.Result.Go) {
+			return ""
+		}
+		bits := uint(8 * ft.Result.Size)
+		if inlineSigned(ft.Result.Go) {
+			bits--
+		}
+		if bits < 64 && v>>bits != 0 {
+			return ""
+		}
+		return gofmt(ft.Result.Go) + "(" + b[0].lit + ")"
+
+	case len(ft.Params) == 1 && len(b) >= 4 && b[1].tok == token.IDENT && b[1].lit == b[0].lit:
+		// return param->field; or return param.field;
+		pt := ft.Params[0].Go
+		var field inlineTok
+		switch {
+		case len(b) == 4 && b[2].tok == token.PERIOD:
+			field = b[3]
+		case len(b) == 5 && b[2].tok == token.SUB && b[3].tok == token.GTR:
+			star, ok := pt.(*ast.StarExpr)
+			if !ok {
+				return ""
+			}
+			pt = star.X
+			field = b[4]
+		default:
+			return ""
+		}
+		if field.tok != token.IDENT || token.Lookup(field.lit).IsKeyword() {
+			return ""
+		}
+		st := inlineStruct(pt)
+		if st == nil {
+			return ""
+		}
+		for _, fld := range st.Fields.List {
+			for _, id := range fld.Names {
+				if id.Name != field.lit {
+					continue
+				}
+				x := "p0." + field.lit
+				if gofmt(fld.Type) == gofmt(ft.Result.Go) {
+					return x
+				}
+				if inlineNumeric(fld.Type) && inlineNumeric(ft.Result.Go) {
+					return gofmt(ft.Result.Go) + "(" + x + ")"
+				}
+				return ""
+			}
+		}
+	}
+	return ""
+}
+
+// inlineStruct returns the struct type that t, the Go form of a C type,
+// stands for, or nil if it is not a struct.
+func inlineStruct(t ast.Expr) *ast.StructType {
+	for i := 0; i < 100; i++ {
+		switch x := t.(type) {
+		case *ast.StructType:
+			return x
+		case *ast.Ident:
+			def := typedef[x.Name]
+			if def == nil {
+				return nil
+			}
+			t = def.Go
+		default:
+			return nil
+		}
+	}
+	return nil
+}
+
+// inlineBasic returns the name of the Go basic type that t,
+// the Go form of a C type, stands for, or "".
+func inlineBasic(t ast.Expr) string {
+	for i := 0; i < 100; i++ {
+		id, ok := t.(*ast.Ident)
+		if !ok {
+			return ""
+		}
+		def := typedef[id.Name]
+		if def == nil {
+			return id.Name
+		}
+		t = def.Go
+	}
+	return ""
+}
+
+// inlineNumeric reports whether t stands for a Go integer or
+// floating-point type, so that C's implicit conversions between
+// such types can be written as Go conversions.
+func inlineNumeric(t ast.Expr) bool {
+	switch inlineBasic(t) {
+	case "int8", "int16", "int32", "int64", "uint8", "uint16", "uint32", "uint64",
+		"int", "uint", "uintptr", "float32", "float64":
+		return true
+	}
+	return false
+}
+
+// inlineSigned reports whether t stands for a Go signed integer type.
+func inlineSigned(t ast.Expr) bool {
+	switch inlineBasic(t) {
+	case "int8", "int16", "int32", "int64", "int":
+		return true
+	}
+	return false
+}
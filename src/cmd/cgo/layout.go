@@ -0,0 +1,305 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Go struct types with the layout of a C struct.
+//
+// A directive
+//
+//	#cgo layout: Point=struct_point
+//
+// declares that the Go struct type Point, defined in the package, has
+// the layout of C.struct_point and holds no Go pointers. cgo checks the
+// fields of Point, writes compile-time checks of its size, alignment
+// and field offsets against those of the C struct, and then uses Point
+// wherever the C code uses struct point, so that a []Point built in Go
+// can be passed to C as a struct point * without conversion and
+// without a pointer check.
+
+package main
+
+import (
+	"debug/dwarf"
+	"fmt"
+	"go/ast"
+	"go/token"
+	"io"
+	"sort"
+	"strings"
+)
+
+// cstructs maps the Go names of C struct types, like
+// _Ctype_struct_point, to their DWARF descriptions.
+var cstructs = make(map[string]*dwarf.StructType)
+
+// A Layout is a Go struct type named in a #cgo layout: directive.
+type Layout struct {
+	Go     string        // Go type name
+	C      string        // C type, as in C.xxx
+	Size   int64         // size of the C struct
+	Align  int64         // alignment of the C struct
+	Fields []LayoutField // fields, in order
+	Pos    token.Pos     // declaration of the Go type
+}
+
+// A LayoutField is a field of a Layout, with the offset and size of
+// the C struct field at the same position.
+type LayoutField struct {
+	Name string
+	Off  int64
+	Size int64
+}
+
+// saveLayoutDirective records the Go=C pairs of a #cgo layout:
+// directive.
+func (f *File) saveLayoutDirective(args string) {
+	for _, arg := range strings.Fields(args) {
+		i := strings.Index(arg, "=")
+		if i < 0 {
+			error_(token.NoPos, "#cgo layout: missing C type for %q; want GoType=ctype", arg)
+			continue
+		}
+		goname, cn := arg[:i], arg[i+1:]
+		if !isName(goname) || !isName(cn) {
+			error_(token.NoPos, "#cgo layout: invalid type names in %q", arg)
+			continue
+		}
+		if f.Layout == nil {
+			f.Layout = make(map[string]string)
+		}
+		f.Layout[goname] = cn
+	}
+}
+
+// addLayoutNames makes sure that the C types named in #cgo layout:
+// directives are loaded, from the preamble of the file with the
+// directive, even if the Go code does not mention them.
+func (p *Package) addLayoutNames(fs []*File) {
+	for _, f := range fs {
+		for _, cn := range f.Layout {
+			if f.Name[cn] == nil {
+				f.Name[cn] = &Name{Go: cn, C: cname(cn)}
+			}
+		}
+	}
+}
+
+// applyLayouts checks the Go types named in #cgo layout: directives
+// and makes the C struct types they stand for refer to them.
+func (p *Package) applyLayouts(fs []*File) {
+	if len(p.LayoutTypes) == 0 || *godefs {
+		return
+	}
+	gonames := make([]string, 0, len(p.LayoutTypes))
+	for goname := range p.LayoutTypes {
+		gonames = append(gonames, goname)
+	}
+	sort.Strings(gonames)
+
+	rename := make(map[string]string)
+	for _, goname := range gonames {
+		l := p.checkLayout(fs, goname, p.LayoutTypes[goname])
+		if l == nil {
+			continue
+		}
+		p.Layouts = append(p.Layouts, l)
+		for _, f := range fs {
+			if n := f.Name[l.C]; n != nil {
+				rename[n.Type.Go.(*ast.Ident).Name] = l.Go
+				break
+			}
+		}
+	}
+
+	// The Go form of a C struct type is an identifier shared by the
+	// types that refer to it, but not necessarily a single one, so
+	// rename them all.
+	ren := func(x ast.Node) bool {
+		if id, ok := x.(*ast.Ident); ok && rename[id.Name] != "" {
+			id.Name = rename[id.Name]
+		}
+		return true
+	}
+	for _, f := range fs {
+		for _, n := range f.Name {
+			if n.Type != nil && n.Type.Go != nil {
+				ast.Inspect(n.Type.Go, ren)
+			}
+			if ft := n.FuncType; ft != nil {
+				for _, t := range ft.Params {
+					ast.Inspect(t.Go, ren)
+				}
+				if ft.Result != nil {
+					ast.Inspect(ft.Result.Go, ren)
+				}
+				ast.Inspect(ft.Go, ren)
+			}
+		}
+	}
+	for _, t := range typedef {
+		ast.Inspect(t.Go, ren)
+	}
+}
+
+// checkLayout checks that the Go type goname, declared in one of fs,
+// may have the layout of the C struct type cn, and returns the
+// layout, or nil after reporting an error.
+func (p *Package) checkLayout(fs []*File, goname, cn string) *Layout {
+	var n *Name
+	for _, f := range fs {
+		if n = f.Name[cn]; n != nil {
+			break
+		}
+	}
+	if n == nil || n.Kind != "type" || n.Type == nil {
+		error_(token.NoPos, "#cgo layout: C.%s is not a type", fixGo(cn))
+		return nil
+	}
+	id, ok := n.Type.Go.(*ast.Ident)
+	var dt *dwarf.StructType
+	if ok {
+		dt = cstructs[id.Name]
+	}
+	if dt == nil {
+		error_(token.NoPos, "#cgo layout: C.%s is not a struct type", fixGo(cn))
+		return nil
+	}
+	if p.hasPointer(nil, typedef[id.Name].Go, false) {
+		error_(token.NoPos, "#cgo layout: C.%s contains pointers", fixGo(cn))
+		return nil
+	}
+
+	var f *File
+	var ts *ast.TypeSpec
+	for _, ff := range fs {
+		if ts = findTypeSpec(ff.AST, goname); ts != nil {
+			f = ff
+			break
+		}
+	}
+	var st *ast.StructType
+	if ts != nil {
+		st, _ = ts.Type.(*ast.StructType)
+	}
+	if st == nil {
+		error_(token.NoPos, "#cgo layout: %s is not a struct type declared at package level", goname)
+		return nil
+	}
+
+	l := &Layout{Go: goname, C: cn, Size: n.Type.Size, Align: n.Type.Align, Pos: ts.Pos()}
+	for _, field := range dt.Field {
+		if field.BitSize != 0 || field.Type.Size() < 0 {
+			error_(token.NoPos, "#cgo layout: C.%s has a bit field or flexible array member %s", fixGo(cn), field.Name)
+			return nil
+		}
+		l.Fields = append(l.Fields, LayoutField{Off: field.ByteOffset, Size: field.Type.Size()})
+	}
+	i := 0
+	for _, field := range st.Fields.List {
+		if !p.layoutFieldType(f, field.Type) {
+			error_(field.Pos(), "#cgo layout: field of %s has type %s, which may hold Go pointers or has no C layout", goname, gofmt(field.Type))
+			return nil
+		}
+		names := field.Names
+		if len(names) == 0 {
+			// Embedded field, named by its type.
+			t := field.Type
+			if sel, ok := t.(*ast.SelectorExpr); ok {
+				t = sel.Sel
+			}
+			names = []*ast.Ident{t.(*ast.Ident)}
+		}
+		for _, name := range names {
+			if name.Name == "_" {
+				error_(name.Pos(), "#cgo layout: %s has a blank field", goname)
+				return nil
+			}
+			if i < len(l.Fields) {
+				l.Fields[i].Name = name.Name
+			}
+			i++
+		}
+	}
+	if i != len(l.Fields) {
+		error_(st.Pos(), "#cgo layout: %s has %d fields, C.%s has %d", goname, i, fixGo(cn), len(l.Fields))
+		return nil
+	}
+	return l
+}
+
+// layoutGoTypes are the predeclared types that may appear in a Go
+// struct type named in a #cgo layout: directive.
+var layoutGoTypes = map[string]bool{
+	"bool": true, "byte": true, "rune": true,
+	"int": true, "int8": true, "int16": true, "int32": true, "int64": true,
+	"uint": true, "uint8": true, "uint16": true, "uint32": true, "uint64": true,
+	"uintptr": true, "float32": true, "float64": true,
+	"complex64": true, "complex128": true,
+}
+
+// layoutFieldType reports whether t, the type of a field of a Go
+// struct type named in a #cgo layout: directive in f, is one that cgo
+// knows to hold no pointers: a predeclared numeric type, a C type
+// without pointers, another such Go struct type, or an array of one.
+func (p *Package) layoutFieldType(f *File, t ast.Expr) bool {
+	switch t := t.(type) {
+	case *ast.ParenExpr:
+		return p.layoutFieldType(f, t.X)
+	case *ast.ArrayType:
+		return t.Len != nil && p.layoutFieldType(f, t.Elt)
+	case *ast.Ident:
+		return layoutGoTypes[t.Name] || p.LayoutTypes[t.Name] != ""
+	case *ast.SelectorExpr:
+		if l, ok := t.X.(*ast.Ident); !ok || l.Name != "C" {
+			return false
+		}
+		n := f.Name[t.Sel.Name]
+		return n != nil && n.Kind == "type" && !p.hasPointer(f, t, false)
+	}
+	return false
+}
+
+// findTypeSpec returns the declaration of the package-level type name
+// in file, or nil.
+func findTypeSpec(file *ast.File, name string) *ast.TypeSpec {
+	for _, d := range file.Decls {
+		gd, ok := d.(*ast.GenDecl)
+		if !ok || gd.Tok != token.TYPE {
+			continue
+		}
+		for _, spec := range gd.Specs {
+			if ts, ok := spec.(*ast.TypeSpec); ok && ts.Name.Name == name {
+				return ts
+			}
+		}
+	}
+	return nil
+}
+
+// writeLayoutChecks writes the compile-time checks that the Go types
+// named in #cgo layout: directives have the size and field offsets of
+// their C structs, and at least their alignment. Each check declares
+// two arrays whose lengths are a difference and its negation, so that
+// a mismatch overflows uintptr. The errors point at the declaration
+// of the Go type.
+func (p *Package) writeLayoutChecks(fgo2 io.Writer) {
+	for _, l := range p.Layouts {
+		pos := fset.Position(l.Pos)
+		fmt.Fprintf(fgo2, "// %s must have the layout of C.%s; see its #cgo layout: directive.\n", l.Go, fixGo(l.C))
+		check := func(format string, args ...interface{}) {
+			fmt.Fprintf(fgo2, "//line %s:%d\n", pos.Filename, pos.Line)
+			fmt.Fprintf(fgo2, format, args...)
+		}
+		equal := func(expr string, n int64) {
+			check("var _ [%s - %d]byte\n", expr, n)
+			check("var _ [%d - %s]byte\n", n, expr)
+		}
+		equal(fmt.Sprintf("unsafe.Sizeof(%s{})", l.Go), l.Size)
+		check("var _ [unsafe.Alignof(%s{}) - %d]byte\n", l.Go, l.Align)
+		for _, field := range l.Fields {
+			equal(fmt.Sprintf("unsafe.Offsetof(%s{}.%s)", l.Go, field.Name), field.Off)
+			equal(fmt.Sprintf("unsafe.Sizeof(%s{}.%s)", l.Go, field.Name), field.Size)
+		}
+		fmt.Fprintf(fgo2, "\n")
+	}
+}
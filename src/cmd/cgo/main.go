@@ -39,10 +39,20 @@ type Package struct {
 	Name        map[string]*Name // accumulated Name from Files
 	ExpFunc     []*ExpFunc       // accumulated ExpFunc from Files
 	Decl        []ast.Decl
-	GoFiles     []string // list of Go files
-	GccFiles    []string // list of gcc output files
-	Preamble    string   // collected preamble for _cgo_export.h
-	CgoChecks   []string // see unsafeCheckPointerName
+	GoFiles     []string          // list of Go files
+	GccFiles    []string          // list of gcc output files
+	Unity       *os.File          // _cgo_unity.c, with -unity
+	Preamble    string            // collected preamble for _cgo_export.h
+	CgoChecks   []string          // see unsafeCheckPointerName
+	PtrChecks   []ptrCheck        // see ptrCheckName
+	LeafFuncs   map[string]bool   // C functions named in #cgo leaf: directives
+	BatchFuncs  map[string]bool   // C functions named in #cgo batch: directives
+	AsyncFuncs  map[string]bool   // C functions named in #cgo async: directives
+	AffineFuncs map[string]bool   // C functions named in #cgo affinity: directives
+	StackFuncs  map[string]int64  // stack sizes from #cgo stack: directives
+	LimitFuncs  map[string]*Limit // limits from #cgo limit: directives
+	LayoutTypes map[string]string // C types of Go types in #cgo layout: directives
+	Layouts     []*Layout         // checked #cgo layout: types
 }
 
 // A File collects information about a single Go input file.
@@ -55,6 +65,13 @@ type File struct {
 	Calls    []*ast.CallExpr     // all calls to C.xxx in AST
 	ExpFunc  []*ExpFunc          // exported functions for this file
 	Name     map[string]*Name    // map from Go name to Name
+	Leaf     []string            // C functions named in #cgo leaf: directives
+	Batch    []string            // C functions named in #cgo batch: directives
+	Async    []string            // C functions named in #cgo async: directives
+	Affinity []string            // C functions named in #cgo affinity: directives
+	Stack    map[string]int64    // stack sizes from #cgo stack: directives
+	Limit    []*Limit            // limits from #cgo limit: directives
+	Layout   map[string]string   // C types of Go types in #cgo layout: directives
 }
 
 func nameKeys(m map[string]*Name) []string {
@@ -77,6 +94,19 @@ func (r *Ref) Pos() token.Pos {
 	return (*r.Expr).Pos()
 }
 
+// A Limit is a limit, from a #cgo limit: directive, on the number of
+// calls to a group of C functions that may be in C at once.
+type Limit struct {
+	Funcs []string // C functions sharing the limit
+	N     int64    // maximum number of calls in C
+}
+
+// Var returns the name of the Go variable that holds the runtime's
+// state for l.
+func (l *Limit) Var() string {
+	return "__cgolimit_" + l.Funcs[0]
+}
+
 // A Name collects information about C.xxx.
 type Name struct {
 	Go       string // name used in Go referring to package C
@@ -87,6 +117,8 @@ type Name struct {
 	Type     *Type  // the type of xxx
 	FuncType *FuncType
 	AddError bool
+	Batch    bool   // C.batch_xxx, the batch form of function xxx
+	Inline   string // Go expression for the body of a static inline accessor; see inline.go
 	Const    string // constant definition
 }
 
@@ -177,6 +209,9 @@ var objDir = flag.String("objdir", "", "object directory")
 var importPath = flag.String("importpath", "", "import path of package being built (for comments in generated files)")
 var exportHeader = flag.String("exportheader", "", "where to write export header if any exported functions")
 
+var unity = flag.Bool("unity", false, "also write the C code for all Go files into one file, _cgo_unity.c")
+var profile = flag.String("profile", "", "call as leaves the hot, short C functions of the package shown in this cgo call profile")
+
 var gccgo = flag.Bool("gccgo", false, "generate files for use with gccgo")
 var gccgoprefix = flag.String("gccgoprefix", "", "-fgo-prefix option used with gccgo")
 var gccgopkgpath = flag.String("gccgopkgpath", "", "-fgo-pkgpath option used with gccgo")
@@ -265,8 +300,12 @@ func main() {
 		f := new(File)
 		f.ReadGo(input)
 		f.DiscardCgoDirectives()
+		p.RecordFuncDirectives(f)
 		fs[i] = f
 	}
+	if *profile != "" && !*godefs {
+		p.applyProfile(fs)
+	}
 
 	if *objDir == "" {
 		// make sure that _obj directory exists, so that we can write
@@ -276,9 +315,9 @@ func main() {
 	}
 	*objDir += string(filepath.Separator)
 
+	p.Translate(fs)
 	for i, input := range goFiles {
 		f := fs[i]
-		p.Translate(f)
 		for _, cref := range f.Ref {
 			switch cref.Context {
 			case "call", "call2":
@@ -300,6 +339,9 @@ func main() {
 		}
 	}
 
+	if p.Unity != nil {
+		p.Unity.Close()
+	}
 	if !*godefs {
 		p.writeDefs()
 	}
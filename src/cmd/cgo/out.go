@@ -54,12 +54,38 @@ func (p *Package) writeDefs() {
 		fmt.Fprintf(fm, "__SIZE_TYPE__ _cgo_wait_runtime_init_done() { return 0; }\n")
 		fmt.Fprintf(fm, "void _cgo_release_context(__SIZE_TYPE__ ctxt) { }\n")
 		fmt.Fprintf(fm, "char* _cgo_topofstack(void) { return (char*)0; }\n")
+		fmt.Fprintf(fm, "void GoInvokeVector(void *calls, __SIZE_TYPE__ n) { }\n")
+		fmt.Fprintf(fm, "void GoInvokeAsync(void *call) { }\n")
+		fmt.Fprintf(fm, "int GoSetCAllocator(void *mallocfn, void *freefn) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoReleaseRuntime(void) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoForkRuntime(void) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoNetpollDescriptor(void) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoNetpoll(void) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoRingPush(void *ring, const void *elem) { return 0; }\n")
+		fmt.Fprintf(fm, "int GoRegisterThread(void) { return 0; }\n")
+		fmt.Fprintf(fm, "void GoUnregisterThread(void) { }\n")
+		fmt.Fprintf(fm, "void GoSetThreadReset(void *fn) { }\n")
+		fmt.Fprintf(fm, "void GoReadCgoStats(void *stats) { }\n")
+		fmt.Fprintf(fm, "int GoReadStats(void *stats) { return 0; }\n")
 	} else {
 		// If we're not importing runtime/cgo, we *are* runtime/cgo,
 		// which provides these functions. We just need a prototype.
-		fmt.Fprintf(fm, "void crosscall2(void(*fn)(void*, int, __SIZE_TYPE__), void *a, int c, __SIZE_TYPE__ ctxt);\n")
 		fmt.Fprintf(fm, "__SIZE_TYPE__ _cgo_wait_runtime_init_done();\n")
 		fmt.Fprintf(fm, "void _cgo_release_context(__SIZE_TYPE__);\n")
+		// Except for crosscall2 and the Go functions that the C code
+		// in runtime/cgo calls through it, which are written in Go.
+		fmt.Fprintf(fm, "void crosscall2(void(*fn)(void*, int, __SIZE_TYPE__), void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_invoke_vector(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_release_m(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_register_thread(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_read_stats(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_async_start(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_callpool_done(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_init_modules(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_release(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_fork(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_netpoll(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
+		fmt.Fprintf(fm, "void _cgo_trampoline(void *a, int c, __SIZE_TYPE__ ctxt) { }\n")
 	}
 	fmt.Fprintf(fm, "void _cgo_allocate(void *a, int c) { }\n")
 	fmt.Fprintf(fm, "void _cgo_panic(void *a, int c) { }\n")
@@ -103,6 +129,7 @@ func (p *Package) writeDefs() {
 	} else {
 		fmt.Fprintf(fgo2, "type _Ctype_void [0]byte\n")
 	}
+	p.writeLayoutChecks(fgo2)
 
 	if *gccgo {
 		fmt.Fprint(fgo2, gccgoGoProlog)
@@ -118,6 +145,20 @@ func (p *Package) writeDefs() {
 		fmt.Fprintf(fgo2, "}\n")
 	}
 
+	for i, c := range p.PtrChecks {
+		n := p.ptrCheckNameIndex(i)
+		fmt.Fprintf(fgo2, "\nfunc %s(p %s) %s {\n", n, c.Type, c.Type)
+		fmt.Fprintf(fgo2, "\tif _cgoCheckPointerNeeded(unsafe.Pointer(p)) {\n")
+		if c.Elem {
+			fmt.Fprintf(fgo2, "\t\t_cgoCheckPointer(p, true)\n")
+		} else {
+			fmt.Fprintf(fgo2, "\t\t_cgoCheckPointer(p)\n")
+		}
+		fmt.Fprintf(fgo2, "\t}\n")
+		fmt.Fprintf(fgo2, "\treturn p\n")
+		fmt.Fprintf(fgo2, "}\n")
+	}
+
 	gccgoSymbolPrefix := p.gccgoSymbolPrefix()
 
 	cVars := make(map[string]bool)
@@ -179,7 +220,32 @@ func (p *Package) writeDefs() {
 		n := p.Name[key]
 		if n.FuncType != nil {
 			p.writeDefsFunc(fgo2, n)
+		} else if p.LeafFuncs[n.C] {
+			error_(token.NoPos, "#cgo leaf: C.%s is not a function", fixGo(n.Go))
+		} else if p.AsyncFuncs[n.C] {
+			error_(token.NoPos, "#cgo async: C.%s is not a function", fixGo(n.Go))
+		} else if p.AffineFuncs[n.C] {
+			error_(token.NoPos, "#cgo affinity: C.%s is not a function", fixGo(n.Go))
+		} else if _, ok := p.StackFuncs[n.C]; ok {
+			error_(token.NoPos, "#cgo stack: C.%s is not a function", fixGo(n.Go))
+		} else if p.LimitFuncs[n.C] != nil {
+			error_(token.NoPos, "#cgo limit: C.%s is not a function", fixGo(n.Go))
+		}
+		if p.LeafFuncs[n.C] && p.AsyncFuncs[n.C] {
+			error_(token.NoPos, "C.%s: function is named in both #cgo leaf: and #cgo async: directives", fixGo(n.Go))
+		}
+		if _, ok := p.StackFuncs[n.C]; ok && p.AsyncFuncs[n.C] {
+			error_(token.NoPos, "C.%s: function is named in both #cgo stack: and #cgo async: directives", fixGo(n.Go))
+		}
+		if p.LimitFuncs[n.C] != nil && (p.LeafFuncs[n.C] || p.AsyncFuncs[n.C]) {
+			error_(token.NoPos, "C.%s: function is named in #cgo limit: and in #cgo leaf: or #cgo async: directives", fixGo(n.Go))
 		}
+		if _, ok := p.StackFuncs[n.C]; p.AffineFuncs[n.C] && (ok || p.LeafFuncs[n.C] || p.AsyncFuncs[n.C]) {
+			error_(token.NoPos, "C.%s: function is named in #cgo affinity: and in #cgo leaf:, stack: or async: directives", fixGo(n.Go))
+		}
+	}
+	if !*gccgo {
+		p.writeLimitVars(fgo2)
 	}
 
 	fgcc := creat(*objDir + "_cgo_export.c")
@@ -353,6 +419,11 @@ func (p *Package) structType(n *Name) (string, int64) {
 }
 
 func (p *Package) writeDefsFunc(fgo2 io.Writer, n *Name) {
+	if n.Batch {
+		p.writeDefsBatchFunc(fgo2, n)
+		return
+	}
+
 	name := n.Go
 	gtype := n.FuncType.Go
 	void := gtype.Results == nil || len(gtype.Results.List) == 0
@@ -388,6 +459,15 @@ func (p *Package) writeDefsFunc(fgo2 io.Writer, n *Name) {
 		paramnames = append(paramnames, paramName)
 	}
 
+	if n.Inline != "" && !n.AddError {
+		// A static inline accessor, done in Go.
+		d.Type.Results.List[0].Names = []*ast.Ident{ast.NewIdent("r1")}
+		fmt.Fprint(fgo2, "\n")
+		conf.Fprint(fgo2, fset, d)
+		fmt.Fprintf(fgo2, " {\n\treturn %s\n}\n", n.Inline)
+		return
+	}
+
 	if *gccgo {
 		// Gccgo style hooks.
 		fmt.Fprint(fgo2, "\n")
@@ -472,11 +552,13 @@ func (p *Package) writeDefsFunc(fgo2 io.Writer, n *Name) {
 		arg = "uintptr(unsafe.Pointer(&r1))"
 	}
 
+	p.writeLimitCall(fgo2, n)
 	prefix := ""
 	if n.AddError {
 		prefix = "errno := "
 	}
-	fmt.Fprintf(fgo2, "\t%s_cgo_runtime_cgocall(%s, %s)\n", prefix, cname, arg)
+	call, extra := p.cgocallFunc(n)
+	fmt.Fprintf(fgo2, "\t%s%s(%s, %s%s)\n", prefix, call, cname, arg, extra)
 	if n.AddError {
 		fmt.Fprintf(fgo2, "\tif errno != 0 { r2 = syscall.Errno(errno) }\n")
 	}
@@ -489,6 +571,111 @@ func (p *Package) writeDefsFunc(fgo2 io.Writer, n *Name) {
 	fmt.Fprintf(fgo2, "}\n")
 }
 
+// cgocallFunc returns the runtime function through which the Go side
+// of a call to n enters C, and the arguments, if any, that follow the
+// function and the argument frame in the call.
+func (p *Package) cgocallFunc(n *Name) (call, extra string) {
+	if size, ok := p.StackFuncs[n.C]; ok {
+		return "_cgo_runtime_cgocallstack", fmt.Sprintf(", %d", size)
+	}
+	switch {
+	case p.LeafFuncs[n.C]:
+		return "_cgo_runtime_cgocallleaf", ""
+	case p.AsyncFuncs[n.C]:
+		return "_cgo_runtime_cgocallasync", ""
+	case p.AffineFuncs[n.C]:
+		return "_cgo_runtime_cgocallaffine", ""
+	}
+	return "_cgo_runtime_cgocall", ""
+}
+
+// writeLimitVars writes the variables that hold the runtime's state for
+// the limits of #cgo limit: directives.
+func (p *Package) writeLimitVars(fgo2 io.Writer) {
+	var vars []string
+	seen := make(map[string]bool)
+	for _, l := range p.LimitFuncs {
+		if v := l.Var(); !seen[v] {
+			seen[v] = true
+			vars = append(vars, v)
+		}
+	}
+	sort.Strings(vars)
+	for _, v := range vars {
+		fmt.Fprintf(fgo2, "var %s [2]uint32\n", v)
+	}
+}
+
+// writeLimitCall writes, for a function named in a #cgo limit:
+// directive, the start of the Go side of a call, which waits until
+// fewer calls than the limit are in C. The wait comes before the
+// argument frame's address is taken, as it may move the stack.
+func (p *Package) writeLimitCall(fgo2 io.Writer, n *Name) {
+	l := p.LimitFuncs[n.C]
+	if l == nil {
+		return
+	}
+	fmt.Fprintf(fgo2, "\t_cgo_runtime_cgoLimitAcquire(&%s, %d)\n", l.Var(), l.N)
+	fmt.Fprintf(fgo2, "\tdefer _cgo_runtime_cgoLimitRelease(&%s, %d)\n", l.Var(), l.N)
+}
+
+// writeDefsBatchFunc writes the Go side of C.batch_xxx, the batch form
+// of the C function xxx. It takes one slice for each parameter of xxx
+// and, if xxx has a result, a slice for the results, all of the same
+// length n, and calls xxx n times with a single transition into C.
+// The slices are passed in place; the C side copies out their data
+// pointers and lengths before calling xxx.
+func (p *Package) writeDefsBatchFunc(fgo2 io.Writer, n *Name) {
+	cname := fmt.Sprintf("_cgo%s%s", cPrefix, n.Mangle)
+
+	var names []string
+	var params []string
+	for i, t := range n.FuncType.Params {
+		names = append(names, fmt.Sprintf("p%d", i))
+		params = append(params, fmt.Sprintf("p%d []%s", i, gofmt(t.Go)))
+	}
+	if t := n.FuncType.Result; t != nil {
+		names = append(names, "r")
+		params = append(params, fmt.Sprintf("r []%s", gofmt(t.Go)))
+	}
+	if len(names) == 0 {
+		error_(token.NoPos, "C.%s: C.%s has no parameters or result", fixGo(n.Go), n.C)
+		return
+	}
+
+	fmt.Fprintf(fgo2, "//go:cgo_import_static %s\n", cname)
+	fmt.Fprintf(fgo2, "//go:linkname __cgofn_%s %s\n", cname, cname)
+	fmt.Fprintf(fgo2, "var __cgofn_%s byte\n", cname)
+	fmt.Fprintf(fgo2, "var %s = unsafe.Pointer(&__cgofn_%s)\n", cname, cname)
+	fmt.Fprint(fgo2, "\n")
+	fmt.Fprint(fgo2, "//go:cgo_unsafe_args\n")
+	fmt.Fprintf(fgo2, "func %s(%s) {\n", n.Mangle, strings.Join(params, ", "))
+	for _, name := range names[1:] {
+		fmt.Fprintf(fgo2, "\tif len(%s) != len(%s) {\n", name, names[0])
+		fmt.Fprintf(fgo2, "\t\tpanic(\"C.%s: slices have different lengths\")\n", fixGo(n.Go))
+		fmt.Fprintf(fgo2, "\t}\n")
+	}
+	fmt.Fprintf(fgo2, "\tif len(%s) == 0 {\n", names[0])
+	fmt.Fprintf(fgo2, "\t\treturn\n")
+	fmt.Fprintf(fgo2, "\t}\n")
+	for i, t := range n.FuncType.Params {
+		// The elements are passed to C just as the
+		// arguments of the plain call would be.
+		if p.hasPointer(nil, t.Go, false) {
+			fmt.Fprintf(fgo2, "\t_cgoCheckPointer(p%d)\n", i)
+		}
+	}
+	p.writeLimitCall(fgo2, n)
+	call, extra := p.cgocallFunc(n)
+	fmt.Fprintf(fgo2, "\t%s(%s, uintptr(unsafe.Pointer(&%s))%s)\n", call, cname, names[0], extra)
+	fmt.Fprintf(fgo2, "\tif _Cgo_always_false {\n")
+	for _, name := range names {
+		fmt.Fprintf(fgo2, "\t\t_Cgo_use(%s)\n", name)
+	}
+	fmt.Fprintf(fgo2, "\t}\n")
+	fmt.Fprintf(fgo2, "}\n")
+}
+
 // writeOutput creates stubs for a specific source file to be compiled by gc
 func (p *Package) writeOutput(f *File, srcfile string) {
 	base := srcfile
@@ -512,10 +699,28 @@ func (p *Package) writeOutput(f *File, srcfile string) {
 	fmt.Fprintf(fgcc, "%s\n", gccProlog)
 	fmt.Fprintf(fgcc, "%s\n", tsanProlog)
 
+	// With -unity, the gcc output for all the files also goes into
+	// _cgo_unity.c, so that the C compiler can run once for the
+	// package and see all the preambles and wrappers together.
+	// That works only if the preambles do not conflict, so the
+	// build system falls back to the .cgo2.c files if it fails.
+	var w io.Writer = fgcc
+	if *unity {
+		if p.Unity == nil {
+			p.Unity = creat(*objDir + "_cgo_unity.c")
+			fmt.Fprintf(p.Unity, "%s\n", f.Preamble)
+			fmt.Fprintf(p.Unity, "%s\n", gccProlog)
+			fmt.Fprintf(p.Unity, "%s\n", tsanProlog)
+		} else {
+			fmt.Fprintf(p.Unity, "%s\n", f.Preamble)
+		}
+		w = io.MultiWriter(fgcc, p.Unity)
+	}
+
 	for _, key := range nameKeys(f.Name) {
 		n := f.Name[key]
 		if n.FuncType != nil {
-			p.writeOutputFunc(fgcc, n)
+			p.writeOutputFunc(w, n)
 		}
 	}
 
@@ -540,9 +745,12 @@ var isBuiltin = map[string]bool{
 	"_Cfunc_GoStringN": true,
 	"_Cfunc_GoBytes":   true,
 	"_Cfunc__CMalloc":  true,
+
+	"_Cfunc_GoBytesInto":    true,
+	"_Cfunc_GoStringIntern": true,
 }
 
-func (p *Package) writeOutputFunc(fgcc *os.File, n *Name) {
+func (p *Package) writeOutputFunc(fgcc io.Writer, n *Name) {
 	name := n.Mangle
 	if isBuiltin[name] || p.Written[name] {
 		// The builtins are already defined in the C prolog, and we don't
@@ -551,11 +759,21 @@ func (p *Package) writeOutputFunc(fgcc *os.File, n *Name) {
 	}
 	p.Written[name] = true
 
+	if n.Inline != "" && !n.AddError {
+		// Done in Go; see writeDefsFunc.
+		return
+	}
+
 	if *gccgo {
 		p.writeGccgoOutputFunc(fgcc, n)
 		return
 	}
 
+	if n.Batch {
+		p.writeOutputBatchFunc(fgcc, n)
+		return
+	}
+
 	ctype, _ := p.structType(n)
 
 	// Gcc wrapper unpacks the C argument struct
@@ -575,12 +793,24 @@ func (p *Package) writeOutputFunc(fgcc *os.File, n *Name) {
 	// Use packed attribute to force no padding in this struct in case
 	// gcc has different packing requirements.
 	fmt.Fprintf(fgcc, "\t%s %v *a = v;\n", ctype, p.packedAttribute())
-	if n.FuncType.Result != nil {
+	// A function named in a #cgo async: directive runs on a thread
+	// that is not running Go code, and its caller's stack does not
+	// move during the call, so it has no stack top to adjust for.
+	adjust := n.FuncType.Result != nil && !p.AsyncFuncs[n.C]
+	if adjust {
 		// Save the stack top for use below.
 		fmt.Fprintf(fgcc, "\tchar *stktop = _cgo_topofstack();\n")
 	}
 	tr := n.FuncType.Result
 	if tr != nil {
+		// The result goes through a local, because a callback may
+		// move a during the call. For a large struct this costs a
+		// copy, but so would a->r = f(): gcc must assume that f
+		// reads *a, so it returns into a temporary either way.
+		// Calling f through a pointer to a function that takes the
+		// hidden result pointer as an argument is not safe either,
+		// since gcc may change the calling convention of a static
+		// function in the preamble.
 		fmt.Fprintf(fgcc, "\t__typeof__(a->r) r;\n")
 	}
 	fmt.Fprintf(fgcc, "\t_cgo_tsan_acquire();\n")
@@ -616,10 +846,12 @@ func (p *Package) writeOutputFunc(fgcc *os.File, n *Name) {
 		fmt.Fprintf(fgcc, "\t_cgo_errno = errno;\n")
 	}
 	fmt.Fprintf(fgcc, "\t_cgo_tsan_release();\n")
-	if n.FuncType.Result != nil {
+	if adjust {
 		// The cgo call may have caused a stack copy (via a callback).
 		// Adjust the return value pointer appropriately.
 		fmt.Fprintf(fgcc, "\ta = (void*)((char*)a + (_cgo_topofstack() - stktop));\n")
+	}
+	if n.FuncType.Result != nil {
 		// Save the return value.
 		fmt.Fprintf(fgcc, "\ta->r = r;\n")
 	}
@@ -630,12 +862,77 @@ func (p *Package) writeOutputFunc(fgcc *os.File, n *Name) {
 	fmt.Fprintf(fgcc, "\n")
 }
 
+// writeOutputBatchFunc writes the C side of C.batch_xxx; see
+// writeDefsBatchFunc. The argument frame is a sequence of Go slices.
+// The loop reads only the slices' data, which the Go side keeps off
+// the goroutine stack, so it does not matter if a callback from xxx
+// moves the stack that holds the frame.
+func (p *Package) writeOutputBatchFunc(fgcc io.Writer, n *Name) {
+	intgo := "int"
+	if p.IntSize == 8 {
+		intgo = "__cgo_long_long"
+	}
+
+	fmt.Fprintf(fgcc, "CGO_NO_SANITIZE_THREAD\n")
+	fmt.Fprintf(fgcc, "void\n")
+	fmt.Fprintf(fgcc, "_cgo%s%s(void *v)\n", cPrefix, n.Mangle)
+	fmt.Fprintf(fgcc, "{\n")
+	fmt.Fprintf(fgcc, "\tstruct {\n")
+	var slices []string
+	for i, t := range n.FuncType.Params {
+		c := t.Typedef
+		if c == "" {
+			c = t.C.String()
+		}
+		fmt.Fprintf(fgcc, "\t\tstruct { %s *p; %s n, c; } p%d;\n", c, intgo, i)
+		slices = append(slices, fmt.Sprintf("p%d", i))
+	}
+	tr := n.FuncType.Result
+	if tr != nil {
+		qual := ""
+		if c := tr.C.String(); c[len(c)-1] == '*' {
+			qual = "const "
+		}
+		fmt.Fprintf(fgcc, "\t\tstruct { %s%s *p; %s n, c; } r;\n", qual, tr.C, intgo)
+		slices = append(slices, "r")
+	}
+	fmt.Fprintf(fgcc, "\t} %v *a = v;\n", p.packedAttribute())
+	for _, s := range slices {
+		fmt.Fprintf(fgcc, "\t__typeof__(a->%s.p) %s = a->%s.p;\n", s, s, s)
+	}
+	fmt.Fprintf(fgcc, "\t%s i, n = a->%s.n;\n", intgo, slices[0])
+	fmt.Fprintf(fgcc, "\n")
+	fmt.Fprintf(fgcc, "\t_cgo_tsan_acquire();\n")
+	fmt.Fprintf(fgcc, "\tfor (i = 0; i < n; i++) {\n")
+	fmt.Fprintf(fgcc, "\t\t")
+	if tr != nil {
+		fmt.Fprintf(fgcc, "r[i] = ")
+	}
+	fmt.Fprintf(fgcc, "%s(", n.C)
+	for i, t := range n.FuncType.Params {
+		if i > 0 {
+			fmt.Fprintf(fgcc, ", ")
+		}
+		// As in writeOutputFunc, cast pointers to void*
+		// to silence warnings about const and volatile.
+		if c := t.C.String(); c[len(c)-1] == '*' {
+			fmt.Fprintf(fgcc, "(void*)")
+		}
+		fmt.Fprintf(fgcc, "p%d[i]", i)
+	}
+	fmt.Fprintf(fgcc, ");\n")
+	fmt.Fprintf(fgcc, "\t}\n")
+	fmt.Fprintf(fgcc, "\t_cgo_tsan_release();\n")
+	fmt.Fprintf(fgcc, "}\n")
+	fmt.Fprintf(fgcc, "\n")
+}
+
 // Write out a wrapper for a function when using gccgo. This is a
 // simple wrapper that just calls the real function. We only need a
 // wrapper to support static functions in the prologue--without a
 // wrapper, we can't refer to the function, since the reference is in
 // a different file.
-func (p *Package) writeGccgoOutputFunc(fgcc *os.File, n *Name) {
+func (p *Package) writeGccgoOutputFunc(fgcc io.Writer, n *Name) {
 	fmt.Fprintf(fgcc, "CGO_NO_SANITIZE_THREAD\n")
 	if t := n.FuncType.Result; t != nil {
 		fmt.Fprintf(fgcc, "%s\n", t.C.String())
@@ -719,6 +1016,12 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 	fmt.Fprintf(fgcc, "extern void _cgo_release_context(__SIZE_TYPE__);\n\n")
 	fmt.Fprintf(fgcc, "%s\n", tsanProlog)
 
+	fmt.Fprintf(fgcch, "%s\n", gccExportHeaderCall)
+	fmt.Fprintf(fgcch, "%s\n", gccExportHeaderNetpoll)
+	fmt.Fprintf(fgcch, "%s\n", gccExportHeaderRing)
+	fmt.Fprintf(fgcch, "%s\n", gccExportHeaderThread)
+	fmt.Fprintf(fgcch, "%s\n", gccExportHeaderStats)
+
 	for _, exp := range p.ExpFunc {
 		fn := exp.Func
 
@@ -726,12 +1029,21 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 		// result frame. The gcc struct will be compiled with
 		// __attribute__((packed)) so all padding must be accounted
 		// for explicitly.
+		//
+		// If the receiver, arguments and results are all
+		// scalars, also construct the same frame as a Go struct,
+		// for a wrapper that the runtime calls directly; see
+		// writeExportDirect.
 		ctype := "struct {\n"
+		gotype := "struct {\n"
+		direct := true
 		off := int64(0)
 		npad := 0
 		if fn.Recv != nil {
 			t := p.cgoType(fn.Recv.List[0].Type)
 			ctype += fmt.Sprintf("\t\t%s recv;\n", t.C)
+			gotype += fmt.Sprintf("\t\trecv %s\n", gofmt(fn.Recv.List[0].Type))
+			direct = direct && p.isScalarType(fn.Recv.List[0].Type)
 			off += t.Size
 		}
 		fntype := fn.Type
@@ -741,15 +1053,19 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 				if off%t.Align != 0 {
 					pad := t.Align - off%t.Align
 					ctype += fmt.Sprintf("\t\tchar __pad%d[%d];\n", npad, pad)
+					gotype += fmt.Sprintf("\t\t_ [%d]byte\n", pad)
 					off += pad
 					npad++
 				}
 				ctype += fmt.Sprintf("\t\t%s p%d;\n", t.C, i)
+				gotype += fmt.Sprintf("\t\tp%d %s\n", i, gofmt(atype))
+				direct = direct && p.isScalarType(atype)
 				off += t.Size
 			})
 		if off%p.PtrSize != 0 {
 			pad := p.PtrSize - off%p.PtrSize
 			ctype += fmt.Sprintf("\t\tchar __pad%d[%d];\n", npad, pad)
+			gotype += fmt.Sprintf("\t\t_ [%d]byte\n", pad)
 			off += pad
 			npad++
 		}
@@ -759,18 +1075,23 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 				if off%t.Align != 0 {
 					pad := t.Align - off%t.Align
 					ctype += fmt.Sprintf("\t\tchar __pad%d[%d];\n", npad, pad)
+					gotype += fmt.Sprintf("\t\t_ [%d]byte\n", pad)
 					off += pad
 					npad++
 				}
 				ctype += fmt.Sprintf("\t\t%s r%d;\n", t.C, i)
+				gotype += fmt.Sprintf("\t\tr%d %s\n", i, gofmt(atype))
+				direct = direct && p.isScalarType(atype)
 				off += t.Size
 			})
 		if off%p.PtrSize != 0 {
 			pad := p.PtrSize - off%p.PtrSize
 			ctype += fmt.Sprintf("\t\tchar __pad%d[%d];\n", npad, pad)
+			gotype += fmt.Sprintf("\t\t_ [%d]byte\n", pad)
 			off += pad
 			npad++
 		}
+		gotype += "\t}"
 		if ctype == "struct {\n" {
 			ctype += "\t\tchar unused;\n" // avoid empty struct
 		}
@@ -818,6 +1139,34 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 		}
 		fmt.Fprintf(fgcch, "\nextern %s;\n", s)
 
+		// Declare the frame of the exported function and the
+		// function that fills in a GoCall for GoInvokeVector.
+		frame := "struct " + exp.ExpName + "_frame"
+		params := s[strings.Index(s, "(")+1 : len(s)-1]
+		if params != "" {
+			params = ", " + params
+		}
+		call := fmt.Sprintf("void %s_call(GoCall *call, %s *frame%s)", exp.ExpName, frame, params)
+		fmt.Fprintf(fgcch, "\n/* Arguments and results of %s, for %s_call. */\n", exp.ExpName, exp.ExpName)
+		body := strings.TrimPrefix(ctype, "struct ")
+		body = strings.Replace(body, "\n\t\t", "\n\t", -1)
+		body = strings.Replace(body, "\n\t}", "\n}", 1)
+		fmt.Fprintf(fgcch, "%s %s %v;\n", frame, body, p.packedAttribute())
+		fmt.Fprintf(fgcch, "extern %s;\n", call)
+
+		// Functions without results whose arguments hold no
+		// pointers also get a Name_async function, which queues a
+		// call with GoInvokeAsync. Only the frame is copied, so
+		// memory that pointer arguments refer to could be gone by
+		// the time the call runs. With no results, direct reports
+		// whether the receiver and arguments are all scalars.
+		async := ""
+		if gccResult == "void" && direct {
+			async = fmt.Sprintf("void %s_async(%s)", exp.ExpName, strings.TrimPrefix(params, ", "))
+			fmt.Fprintf(fgcch, "\n/* Queues a call to %s; see GoInvokeAsync. */\n", exp.ExpName)
+			fmt.Fprintf(fgcch, "extern %s;\n", async)
+		}
+
 		fmt.Fprintf(fgcc, "extern void _cgoexp%s_%s(void *, int, __SIZE_TYPE__);\n", cPrefix, exp.ExpName)
 		fmt.Fprintf(fgcc, "\nCGO_NO_SANITIZE_THREAD")
 		fmt.Fprintf(fgcc, "\n%s\n", s)
@@ -851,6 +1200,40 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 		}
 		fmt.Fprintf(fgcc, "}\n")
 
+		// Build the function that sets up a call for GoInvokeVector.
+		fmt.Fprintf(fgcc, "\nextern void *_cgoexpfn%s_%s;\n", cPrefix, exp.ExpName)
+		fmt.Fprintf(fgcc, "\n%s\n", call)
+		fmt.Fprintf(fgcc, "{\n")
+		if fn.Recv != nil {
+			fmt.Fprintf(fgcc, "\tframe->recv = recv;\n")
+		}
+		forFieldList(fntype.Params,
+			func(i int, aname string, atype ast.Expr) {
+				fmt.Fprintf(fgcc, "\tframe->p%d = p%d;\n", i, i)
+			})
+		fmt.Fprintf(fgcc, "\tcall->_fn = _cgoexpfn%s_%s;\n", cPrefix, exp.ExpName)
+		fmt.Fprintf(fgcc, "\tcall->_frame = frame;\n")
+		fmt.Fprintf(fgcc, "\tcall->_size = %d;\n", off)
+		fmt.Fprintf(fgcc, "}\n")
+
+		if async != "" {
+			fmt.Fprintf(fgcc, "\n%s\n", async)
+			fmt.Fprintf(fgcc, "{\n")
+			fmt.Fprintf(fgcc, "\tGoCall call;\n")
+			fmt.Fprintf(fgcc, "\t%s frame;\n\n", frame)
+			fmt.Fprintf(fgcc, "\t%s_call(&call, &frame", exp.ExpName)
+			if fn.Recv != nil {
+				fmt.Fprintf(fgcc, ", recv")
+			}
+			forFieldList(fntype.Params,
+				func(i int, aname string, atype ast.Expr) {
+					fmt.Fprintf(fgcc, ", p%d", i)
+				})
+			fmt.Fprintf(fgcc, ");\n")
+			fmt.Fprintf(fgcc, "\tGoInvokeAsync(&call);\n")
+			fmt.Fprintf(fgcc, "}\n")
+		}
+
 		// Build the wrapper function compiled by cmd/compile.
 		goname := "_cgoexpwrap" + cPrefix + "_"
 		if fn.Recv != nil {
@@ -858,18 +1241,38 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 		}
 		goname += exp.Func.Name.Name
 		fmt.Fprintf(fgo2, "//go:cgo_export_dynamic %s\n", exp.ExpName)
+		fmt.Fprintf(fgo2, "//go:cgo_export_dynamic %s_call\n", exp.ExpName)
+		if async != "" {
+			fmt.Fprintf(fgo2, "//go:cgo_export_dynamic %s_async\n", exp.ExpName)
+		}
 		fmt.Fprintf(fgo2, "//go:linkname _cgoexp%s_%s _cgoexp%s_%s\n", cPrefix, exp.ExpName, cPrefix, exp.ExpName)
 		fmt.Fprintf(fgo2, "//go:cgo_export_static _cgoexp%s_%s\n", cPrefix, exp.ExpName)
 		fmt.Fprintf(fgo2, "//go:nosplit\n") // no split stack, so no use of m or g
 		fmt.Fprintf(fgo2, "//go:norace\n")  // must not have race detector calls inserted
 		fmt.Fprintf(fgo2, "func _cgoexp%s_%s(a unsafe.Pointer, n int32, ctxt uintptr) {\n", cPrefix, exp.ExpName)
-		fmt.Fprintf(fgo2, "\tfn := %s\n", goname)
-		// The indirect here is converting from a Go function pointer to a C function pointer.
-		fmt.Fprintf(fgo2, "\t_cgo_runtime_cgocallback(**(**unsafe.Pointer)(unsafe.Pointer(&fn)), a, uintptr(n), ctxt);\n")
+		if direct {
+			fmt.Fprintf(fgo2, "\tfn := _cgoexpdirect%s_%s\n", cPrefix, exp.ExpName)
+			// The high bit of the frame size is
+			// runtime.cgoCallbackDirect.
+			fmt.Fprintf(fgo2, "\t_cgo_runtime_cgocallback(**(**unsafe.Pointer)(unsafe.Pointer(&fn)), a, uintptr(n)|1<<%d, ctxt);\n", 8*p.PtrSize-1)
+		} else {
+			fmt.Fprintf(fgo2, "\tfn := %s\n", goname)
+			// The indirect here is converting from a Go function pointer to a C function pointer.
+			fmt.Fprintf(fgo2, "\t_cgo_runtime_cgocallback(**(**unsafe.Pointer)(unsafe.Pointer(&fn)), a, uintptr(n), ctxt);\n")
+		}
 		fmt.Fprintf(fgo2, "}\n")
+		if direct {
+			p.writeExportDirect(fgo2, exp, gotype, off)
+		}
 
 		fmt.Fprintf(fm, "int _cgoexp%s_%s;\n", cPrefix, exp.ExpName)
 
+		// The Go function value that GoInvokeVector calls.
+		fmt.Fprintf(fgo2, "//go:linkname _cgoexpfn%s_%s _cgoexpfn%s_%s\n", cPrefix, exp.ExpName, cPrefix, exp.ExpName)
+		fmt.Fprintf(fgo2, "//go:cgo_export_static _cgoexpfn%s_%s\n", cPrefix, exp.ExpName)
+		fmt.Fprintf(fgo2, "var _cgoexpfn%s_%s = %s\n", cPrefix, exp.ExpName, goname)
+		fmt.Fprintf(fm, "void *_cgoexpfn%s_%s;\n", cPrefix, exp.ExpName)
+
 		// This code uses printer.Fprint, not conf.Fprint,
 		// because we don't want //line comments in the middle
 		// of the function types.
@@ -904,27 +1307,16 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 			fmt.Fprint(fgo2, ")")
 		}
 		fmt.Fprint(fgo2, " {\n")
-		if gccResult == "void" {
-			fmt.Fprint(fgo2, "\t")
-		} else {
-			// Verify that any results don't contain any
-			// Go pointers.
-			addedDefer := false
+		fmt.Fprint(fgo2, "\t")
+		if gccResult != "void" {
 			forFieldList(fntype.Results,
 				func(i int, aname string, atype ast.Expr) {
-					if !p.hasPointer(nil, atype, false) {
-						return
-					}
-					if !addedDefer {
-						fmt.Fprint(fgo2, "\tdefer func() {\n")
-						addedDefer = true
+					if i > 0 {
+						fmt.Fprint(fgo2, ", ")
 					}
-					fmt.Fprintf(fgo2, "\t\t_cgoCheckResult(r%d)\n", i)
+					fmt.Fprintf(fgo2, "r%d", i)
 				})
-			if addedDefer {
-				fmt.Fprint(fgo2, "\t}()\n")
-			}
-			fmt.Fprint(fgo2, "\treturn ")
+			fmt.Fprint(fgo2, " = ")
 		}
 		if fn.Recv != nil {
 			fmt.Fprintf(fgo2, "recv.")
@@ -938,12 +1330,130 @@ func (p *Package) writeExports(fgo2, fm, fgcc, fgcch io.Writer) {
 				fmt.Fprintf(fgo2, "p%d", i)
 			})
 		fmt.Fprint(fgo2, ")\n")
+		if gccResult != "void" {
+			// Verify that any results don't contain any
+			// Go pointers. A panic in the function never
+			// returns to C, so there is no need to check
+			// in a deferred call.
+			forFieldList(fntype.Results,
+				func(i int, aname string, atype ast.Expr) {
+					if !p.hasPointer(nil, atype, false) {
+						return
+					}
+					if !resultPointerWord(atype) {
+						fmt.Fprintf(fgo2, "\t_cgoCheckResult(r%d)\n", i)
+						return
+					}
+					// The first word of the result is its only
+					// pointer. Convert the result to an interface,
+					// which may allocate, only if that is a Go
+					// pointer and the check is enabled.
+					fmt.Fprintf(fgo2, "\tif _cgoCheckPointerNeeded(*(*unsafe.Pointer)(unsafe.Pointer(&r%d))) {\n", i)
+					fmt.Fprintf(fgo2, "\t\t_cgoCheckResult(r%d)\n", i)
+					fmt.Fprint(fgo2, "\t}\n")
+				})
+			fmt.Fprint(fgo2, "\treturn\n")
+		}
 		fmt.Fprint(fgo2, "}\n")
 	}
 
 	fmt.Fprintf(fgcch, "%s", gccExportHeaderEpilog)
 }
 
+// writeExportDirect writes the wrapper of an exported function whose
+// receiver, arguments and results are all scalars, which the runtime
+// calls in place of the function itself, with the address of the C
+// frame, frame, a Go struct type with the same layout. The wrapper
+// reads the arguments and writes the results there, saving the
+// runtime the copies of reflectcall, and the results need no checks
+// for Go pointers. The wrapper is go:norace, which also keeps -msan
+// from annotating each field it reads and writes: the runtime marks
+// the whole frame written once the wrapper returns.
+func (p *Package) writeExportDirect(fgo2 io.Writer, exp *ExpFunc, frame string, size int64) {
+	fn := exp.Func
+	fmt.Fprintf(fgo2, "\n")
+	fmt.Fprintf(fgo2, "//go:norace\n")
+	fmt.Fprintf(fgo2, "func _cgoexpdirect%s_%s(a unsafe.Pointer) {\n", cPrefix, exp.ExpName)
+	if size > 0 {
+		fmt.Fprintf(fgo2, "\tf := (*%s)(a)\n", frame)
+	}
+	fmt.Fprint(fgo2, "\t")
+	forFieldList(fn.Type.Results,
+		func(i int, aname string, atype ast.Expr) {
+			if i > 0 {
+				fmt.Fprint(fgo2, ", ")
+			}
+			fmt.Fprintf(fgo2, "f.r%d", i)
+		})
+	if fn.Type.Results != nil && len(fn.Type.Results.List) > 0 {
+		fmt.Fprint(fgo2, " = ")
+	}
+	if fn.Recv != nil {
+		fmt.Fprintf(fgo2, "f.recv.")
+	}
+	fmt.Fprintf(fgo2, "%s(", fn.Name)
+	forFieldList(fn.Type.Params,
+		func(i int, aname string, atype ast.Expr) {
+			if i > 0 {
+				fmt.Fprint(fgo2, ", ")
+			}
+			fmt.Fprintf(fgo2, "f.p%d", i)
+		})
+	fmt.Fprint(fgo2, ")\n")
+	fmt.Fprint(fgo2, "}\n")
+}
+
+// isScalarType reports whether t, the type of an argument or result
+// of an exported function, is a boolean or numeric type, including
+// the C numeric types, so that its values hold no pointers.
+func (p *Package) isScalarType(t ast.Expr) bool {
+	id, ok := t.(*ast.Ident)
+	if !ok {
+		return false
+	}
+	// TODO: Handle types defined within function.
+	for _, d := range p.Decl {
+		gd, ok := d.(*ast.GenDecl)
+		if !ok || gd.Tok != token.TYPE {
+			continue
+		}
+		for _, spec := range gd.Specs {
+			ts, ok := spec.(*ast.TypeSpec)
+			if !ok {
+				continue
+			}
+			if ts.Name.Name == id.Name {
+				return p.isScalarType(ts.Type)
+			}
+		}
+	}
+	if def := typedef[id.Name]; def != nil {
+		return p.isScalarType(def.Go)
+	}
+	if id.Name == "uintptr" {
+		return true
+	}
+	return goTypes[id.Name] != nil
+}
+
+// resultPointerWord reports whether t, the type of a result of an
+// exported function, is a pointer, unsafe.Pointer, string or slice
+// type, whose only pointer is its first word.
+func resultPointerWord(t ast.Expr) bool {
+	switch t := t.(type) {
+	case *ast.StarExpr:
+		return true
+	case *ast.ArrayType:
+		return t.Len == nil
+	case *ast.Ident:
+		return t.Name == "string"
+	case *ast.SelectorExpr:
+		id, ok := t.X.(*ast.Ident)
+		return ok && id.Name == "unsafe" && t.Sel.Name == "Pointer"
+	}
+	return false
+}
+
 // Write out the C header allowing C code to call exported gccgo functions.
 func (p *Package) writeGccgoExports(fgo2, fm, fgcc, fgcch io.Writer) {
 	gccgoSymbolPrefix := p.gccgoSymbolPrefix()
@@ -1343,6 +1853,8 @@ typedef struct { char *p; intgo n; intgo c; } _GoBytes_;
 _GoString_ GoString(char *p);
 _GoString_ GoStringN(char *p, int l);
 _GoBytes_ GoBytes(void *p, int n);
+_GoBytes_ GoBytesInto(_GoBytes_ dst, void *p, int n);
+_GoString_ GoStringIntern(char *p, int l);
 char *CString(_GoString_);
 void *CBytes(_GoBytes_);
 void *_CMalloc(size_t);
@@ -1352,6 +1864,24 @@ const goProlog = `
 //go:linkname _cgo_runtime_cgocall runtime.cgocall
 func _cgo_runtime_cgocall(unsafe.Pointer, uintptr) int32
 
+//go:linkname _cgo_runtime_cgocallleaf runtime.cgocallleaf
+func _cgo_runtime_cgocallleaf(unsafe.Pointer, uintptr) int32
+
+//go:linkname _cgo_runtime_cgocallasync runtime.cgocallasync
+func _cgo_runtime_cgocallasync(unsafe.Pointer, uintptr) int32
+
+//go:linkname _cgo_runtime_cgocallaffine runtime.cgocallaffine
+func _cgo_runtime_cgocallaffine(unsafe.Pointer, uintptr) int32
+
+//go:linkname _cgo_runtime_cgocallstack runtime.cgocallstack
+func _cgo_runtime_cgocallstack(unsafe.Pointer, uintptr, uintptr) int32
+
+//go:linkname _cgo_runtime_cgoLimitAcquire runtime.cgoLimitAcquire
+func _cgo_runtime_cgoLimitAcquire(*[2]uint32, int32)
+
+//go:linkname _cgo_runtime_cgoLimitRelease runtime.cgoLimitRelease
+func _cgo_runtime_cgoLimitRelease(*[2]uint32, int32)
+
 //go:linkname _cgo_runtime_cmalloc runtime.cmalloc
 func _cgo_runtime_cmalloc(uintptr) unsafe.Pointer
 
@@ -1363,6 +1893,9 @@ func _cgoCheckPointer(interface{}, ...interface{}) interface{}
 
 //go:linkname _cgoCheckResult runtime.cgoCheckResult
 func _cgoCheckResult(interface{})
+
+//go:linkname _cgoCheckPointerNeeded runtime.cgoCheckPointerNeeded
+func _cgoCheckPointerNeeded(unsafe.Pointer) bool
 `
 
 const gccgoGoProlog = `
@@ -1398,6 +1931,29 @@ func _Cfunc_GoBytes(p unsafe.Pointer, l _Ctype_int) []byte {
 }
 `
 
+const goBytesIntoDef = `
+func _Cfunc_GoBytesInto(dst []byte, p unsafe.Pointer, l _Ctype_int) []byte {
+	n := int(l)
+	if cap(dst) < n {
+		dst = make([]byte, n)
+	}
+	dst = dst[:n]
+	if n > 0 {
+		copy(dst, (*[1<<30]byte)(p)[:n:n])
+	}
+	return dst
+}
+`
+
+const goStringInternDef = `
+//go:linkname _cgo_runtime_gostringintern runtime.gostringintern
+func _cgo_runtime_gostringintern(*_Ctype_char, int) string
+
+func _Cfunc_GoStringIntern(p *_Ctype_char, l _Ctype_int) string {
+	return _cgo_runtime_gostringintern(p, int(l))
+}
+`
+
 const cStringDef = `
 func _Cfunc_CString(s string) *_Ctype_char {
 	p := _cgo_runtime_cmalloc(uintptr(len(s)+1))
@@ -1430,6 +1986,9 @@ var builtinDefs = map[string]string{
 	"CString":   cStringDef,
 	"CBytes":    cBytesDef,
 	"_CMalloc":  cMallocDef,
+
+	"GoBytesInto":    goBytesIntoDef,
+	"GoStringIntern": goStringInternDef,
 }
 
 func (p *Package) cPrologGccgo() string {
@@ -1486,6 +2045,19 @@ Slice _cgoPREFIX_Cfunc_GoBytes(char *p, int32_t n) {
 	return __go_string_to_byte_array(s);
 }
 
+Slice _cgoPREFIX_Cfunc_GoBytesInto(Slice dst, char *p, int32_t n) {
+	struct __go_string s = { (const unsigned char *)p, n };
+	if(dst.__capacity < n)
+		return __go_string_to_byte_array(s);
+	memmove(dst.__values, p, n);
+	dst.__count = n;
+	return dst;
+}
+
+struct __go_string _cgoPREFIX_Cfunc_GoStringIntern(char *p, int32_t n) {
+	return __go_byte_array_to_string(p, n);
+}
+
 extern void runtime_throw(const char *);
 void *_cgoPREFIX_Cfunc__CMalloc(size_t n) {
         void *p = malloc(n);
@@ -1577,6 +2149,190 @@ extern "C" {
 #endif
 `
 
+// gccExportHeaderCall is written to the generated header file before
+// the exported functions, for batched calls through GoInvokeVector.
+const gccExportHeaderCall = `
+#ifndef GO_CGO_GOCALL_H
+#define GO_CGO_GOCALL_H
+
+/*
+  A call to an exported Go function, set up by the function's
+  Name_call function and run by GoInvokeVector.
+*/
+typedef struct { void *_fn; void *_frame; GoInt32 _size; } GoCall;
+
+/*
+  Runs calls[0] through calls[n-1], in order, entering Go only once
+  for the whole batch. The results of each call are left in its frame.
+*/
+extern void GoInvokeVector(GoCall *calls, GoInt n);
+
+/*
+  Queues a call to be run later on a goroutine, and returns without
+  waiting for it and without entering the Go scheduler. The frame
+  is copied, so it need not remain valid, but any memory that the
+  arguments point to, such as the data of a GoString or GoSlice,
+  must remain valid until the call has run. Queued calls run one
+  at a time, in the order they were queued.
+*/
+extern void GoInvokeAsync(GoCall *call);
+
+#endif
+`
+
+// gccExportHeaderNetpoll is written to the generated header file
+// before the exported functions, for C hosts that drive the runtime's
+// network poller from their own event loop.
+const gccExportHeaderNetpoll = `
+#ifndef GO_CGO_NETPOLL_H
+#define GO_CGO_NETPOLL_H
+
+/*
+  Returns a descriptor that is readable when network I/O that
+  goroutines wait for may be ready, for the caller to wait for in its
+  own event loop, or -1 if the system has none. Once it has returned
+  a descriptor, no runtime thread waits for it any more: the caller
+  must call GoNetpoll whenever it is readable.
+*/
+extern int GoNetpollDescriptor(void);
+
+/*
+  Makes ready the goroutines whose network I/O is ready, without
+  blocking, and returns how many there were.
+*/
+extern int GoNetpoll(void);
+
+#endif
+`
+
+// gccExportHeaderRing is written to the generated header file before
+// the exported functions, for C threads that stream data to a
+// goroutine through a runtime/cgo.Ring.
+const gccExportHeaderRing = `
+#ifndef GO_CGO_RING_H
+#define GO_CGO_RING_H
+
+/*
+  A ring of fixed-size elements that a goroutine takes with the Pop
+  method of a runtime/cgo.Ring, whose C method returns the GoRing*.
+  Not available on Windows.
+*/
+typedef struct GoRing GoRing;
+
+/*
+  Copies an element into the ring and returns 1, or returns 0 if the
+  ring is full. Does not enter Go and does not block, so it may be
+  called from any thread, any number of threads at once. Wakes the
+  goroutine waiting in Pop, if any.
+*/
+extern int GoRingPush(GoRing *ring, const void *elem);
+
+#endif
+`
+
+// gccExportHeaderThread is written to the generated header file
+// before the exported functions, for C hosts whose own threads call
+// into Go often.
+const gccExportHeaderThread = `
+#ifndef GO_CGO_THREAD_H
+#define GO_CGO_THREAD_H
+
+/*
+  Binds the calling thread, which must not have been created by Go,
+  to a Go runtime M until the thread exits or calls
+  GoUnregisterThread, waiting for the runtime to be initialized if
+  need be. Later calls into Go from the thread reuse the M, its signal
+  stack and the thread's Go TLS, instead of taking them on entry and
+  giving them back on return. Returns 1 if the thread is bound, and 0
+  if it cannot be, as on Windows and OpenBSD.
+*/
+extern int GoRegisterThread(void);
+
+/*
+  Gives back the M bound by GoRegisterThread. Must not be called from
+  C code called by Go. A bound thread that exits without calling it
+  gives the M back as it exits.
+*/
+extern void GoUnregisterThread(void);
+
+/*
+  Sets fn as the function that resets a thread's C state when a
+  goroutine that locked the thread with runtime.LockOSThread exits
+  without unlocking it. fn runs on that thread before it runs any
+  other goroutine. It must return quickly and must not call into Go.
+*/
+extern void GoSetThreadReset(void (*fn)(void));
+
+#endif
+`
+
+// gccExportHeaderStats is written to the generated header file before
+// the exported functions, for C hosts that monitor calls between C and
+// Go. Keep in sync with runtime.CgoStats and runtime.cgoStatsPage.
+const gccExportHeaderStats = `
+#ifndef GO_CGO_STATS_H
+#define GO_CGO_STATS_H
+
+/*
+  Counters of calls between C and Go, as documented for
+  runtime.CgoStats, whose fields these are, in order.
+*/
+typedef struct {
+	GoUint64 Created;
+	GoUint64 InC;
+	GoUint64 PeakInC;
+	GoUint64 ExtraM;
+	GoUint64 Calls;
+	GoUint64 ExtraMIdle;
+	GoUint64 NeedM;
+	GoUint64 NeedMWaits;
+	GoUint64 NeedMWaitNanoseconds;
+	GoUint64 InitWaits;
+	GoUint64 InitWaitNanoseconds;
+	GoUint64 CMallocs;
+	GoUint64 CMallocBytes;
+	GoUint64 PointerChecks;
+	GoUint64 PointerCheckNanoseconds;
+} GoCgoStats;
+
+/*
+  Fills *stats with the counters, calling into Go to read them.
+*/
+extern void GoReadCgoStats(GoCgoStats *stats);
+
+/*
+  Counters that the runtime publishes about every 10ms while it runs
+  Go code, and once more before it goes idle.
+*/
+typedef struct {
+	GoUint64 UpdateTime;	/* Unix time of the update, in nanoseconds */
+	GoUint64 HeapAlloc;	/* about runtime.MemStats.HeapAlloc */
+	GoUint64 HeapSys;
+	GoUint64 NextGC;
+	GoUint64 NumGC;
+	GoUint64 PauseTotalNs;
+	GoUint64 LastPauseNs;	/* the pause of the last collection */
+	GoUint64 LastGC;
+	GoUint64 NumGoroutine;
+	GoUint64 NumCgoCall;
+	GoUint64 CgoInC;	/* the fields of runtime.CgoStats */
+	GoUint64 CgoExtraM;
+	GoUint64 CgoExtraMIdle;
+	GoUint64 CgoNeedM;
+	GoUint64 CgoNeedMWaits;
+	GoUint64 CgoMallocBytes;
+} GoStats;
+
+/*
+  Copies the counters last published into *stats with plain loads,
+  without calling into Go, so it neither waits for the runtime nor
+  takes an M. Returns 1, or 0 if none have been published yet.
+*/
+extern int GoReadStats(GoStats *stats);
+
+#endif
+`
+
 // gccExportHeaderEpilog goes at the end of the generated header file.
 const gccExportHeaderEpilog = `
 #ifdef __cplusplus
@@ -0,0 +1,282 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Profile-guided leaf calls.
+//
+// A #cgo leaf: directive takes the scheduler out of the calls to a
+// small C function, but a package may call hundreds of them, and only
+// a handful are hot. With -profile, cgo reads a cgo call profile, as
+// written by runtime/pprof's "cgocall" profile with debug=1, and calls
+// as leaves the functions of the package that the profile shows are
+// called often and return quickly. A leaf must not block or call back
+// into Go, which the profile cannot tell, so cgo does this only for
+// functions defined in the preamble whose bodies call nothing at all.
+
+package main
+
+import (
+	"bufio"
+	"go/token"
+	"os"
+	"strconv"
+	"strings"
+)
+
+const (
+	// profileHot is the share of the calls in the profile, in
+	// percent, that a C function must account for to be called
+	// as a leaf.
+	profileHot = 1
+
+	// profileShort is the longest average duration of a call, in
+	// nanoseconds, of a C function to be called as a leaf.
+	profileShort = 1000
+)
+
+// A profileSite is the calls to one cgo wrapper in a cgo call profile.
+type profileSite struct {
+	count int64 // number of calls
+	ns    int64 // total nanoseconds in C
+}
+
+// readCgoCallProfile reads the cgo call profile in file, written with
+// debug=1, and returns its records keyed by the name of the function
+// each was recorded in, and the total number of calls in the profile.
+func readCgoCallProfile(file string) (map[string]*profileSite, int64) {
+	r, err := os.Open(file)
+	if err != nil {
+		fatalf("%s", err)
+	}
+	defer r.Close()
+	sites := make(map[string]*profileSite)
+	var total int64
+	var cur profileSite // the record whose stack follows
+	named := false
+	s := bufio.NewScanner(r)
+	for s.Scan() {
+		line := s.Text()
+		if strings.HasPrefix(line, "#\t") {
+			// #	pc	name+off	file:line
+			f := strings.Split(line, "\t")
+			if len(f) < 3 || cur.count == 0 {
+				continue
+			}
+			name := f[2]
+			if i := strings.LastIndex(name, "+"); i >= 0 {
+				name = name[:i]
+			}
+			site := sites[name]
+			if site == nil {
+				site = new(profileSite)
+				sites[name] = site
+			}
+			site.count += cur.count
+			site.ns += cur.ns
+			cur = profileSite{}
+			named = true
+			continue
+		}
+		// ns count @ pc
+		f := strings.Fields(line)
+		if len(f) < 3 || f[2] != "@" {
+			continue
+		}
+		ns, err1 := strconv.ParseInt(f[0], 10, 64)
+		count, err2 := strconv.ParseInt(f[1], 10, 64)
+		if err1 != nil || err2 != nil || count <= 0 {
+			continue
+		}
+		cur = profileSite{count: count, ns: ns}
+		total += count
+	}
+	if err := s.Err(); err != nil {
+		fatalf("reading %s: %s", file, err)
+	}
+	if total > 0 && !named {
+		fatalf("cgo call profile %s has no function names; write it with debug=1", file)
+	}
+	return sites, total
+}
+
+// applyProfile adds to the leaf functions of the package the functions
+// that the profile named by -profile shows are hot and short, and
+// that the preambles of fs show cannot block or call back into Go.
+// Functions named in any #cgo directive other than batch: are left
+// as they are.
+func (p *Package) applyProfile(fs []*File) {
+	sites, total := readCgoCallProfile(*profile)
+	if total == 0 || len(fs) == 0 {
+		return
+	}
+
+	// A function defined in several preambles, as a static function
+	// may be, must call nothing in any of them.
+	self := make(map[string]bool)
+	for _, f := range fs {
+		for name, ok := range selfContainedFuncs(f.Preamble) {
+			if old, dup := self[name]; dup {
+				ok = ok && old
+			}
+			self[name] = ok
+		}
+	}
+
+	calls := make(map[string]*profileSite)
+	prefix := profilePrefix(fs[0].Package)
+	for sym, site := range sites {
+		if !strings.HasPrefix(sym, prefix) {
+			continue
+		}
+		var name string
+		switch rest := sym[len(prefix):]; {
+		case strings.HasPrefix(rest, "_Cfunc_"):
+			name = rest[len("_Cfunc_"):]
+		case strings.HasPrefix(rest, "_C2func_"):
+			name = rest[len("_C2func_"):]
+		default:
+			continue
+		}
+		c := calls[name]
+		if c == nil {
+			c = new(profileSite)
+			calls[name] = c
+		}
+		c.count += site.count
+		c.ns += site.ns
+	}
+
+	for name, c := range calls {
+		if !self[name] || c.count*100 < total*profileHot || c.ns > c.count*profileShort {
+			continue
+		}
+		if _, ok := p.StackFuncs[name]; ok || p.LeafFuncs[name] || p.AsyncFuncs[name] || p.LimitFuncs[name] != nil {
+			continue
+		}
+		if p.LeafFuncs == nil {
+			p.LeafFuncs = make(map[string]bool)
+		}
+		p.LeafFuncs[name] = true
+	}
+}
+
+// profilePrefix returns the prefix of the symbols of the functions of
+// the package, named pkg, being translated, as the profile shows them:
+// the import path, with the dots of its last element escaped as the
+// linker does, or "main" for a command.
+func profilePrefix(pkg string) string {
+	path := *importPath
+	if pkg == "main" || path == "" {
+		return pkg + "."
+	}
+	i := strings.LastIndex(path, "/") + 1
+	var b []byte
+	for j := 0; j < len(path); j++ {
+		c := path[j]
+		if c <= ' ' || c == '%' || c == '"' || c >= 0x7f || c == '.' && j >= i {
+			b = append(b, '%', "0123456789abcdef"[c>>4], "0123456789abcdef"[c&0xf])
+			continue
+		}
+		b = append(b, c)
+	}
+	return string(b) + "."
+}
+
+// selfContainedFuncs returns the functions defined in the preamble,
+// outside any #if block, mapped to whether their bodies make no calls:
+// no function calls, including calls through pointers or casts of
+// parenthesized expressions, no asm statements and no macros that the
+// preamble defines. Such a function cannot block or call back into Go.
+func selfContainedFuncs(preamble string) map[string]bool {
+	toks, macros := preambleTokens(preamble)
+	funcs := make(map[string]bool)
+	start := 0 // first token of the current top-level declaration
+	depth := 0
+	lbrace := -1
+	for i := 0; i < len(toks); i++ {
+		switch toks[i].tok {
+		case token.LBRACE:
+			if depth == 0 {
+				lbrace = i
+			}
+			depth++
+		case token.RBRACE:
+			if depth--; depth == 0 {
+				if name := funcDefName(toks[start:lbrace]); name != "" {
+					ok := !macros[name] && selfContained(toks[lbrace+1:i], macros)
+					if _, dup := funcs[name]; dup {
+						ok = false
+					}
+					funcs[name] = ok
+				}
+				start = i + 1
+			}
+		case token.SEMICOLON, token.ILLEGAL:
+			if depth == 0 {
+				start = i + 1
+			}
+		}
+	}
+	return funcs
+}
+
+// funcDefName returns the name of the function whose definition has
+// the header toks, ending before the opening brace of its body, or ""
+// if toks is not a function header.
+func funcDefName(toks []inlineTok) string {
+	n := len(toks)
+	if n < 3 || toks[n-1].tok != token.RPAREN {
+		return ""
+	}
+	depth := 0
+	for i := n - 1; i > 0; i-- {
+		switch toks[i].tok {
+		case token.RPAREN:
+			depth++
+		case token.LPAREN:
+			if depth--; depth == 0 {
+				if i < 2 || toks[i-1].tok != token.IDENT {
+					return ""
+				}
+				return toks[i-1].lit
+			}
+		}
+	}
+	return ""
+}
+
+// selfContained reports whether body, the tokens of a function body
+// between its braces, makes no calls.
+func selfContained(body []inlineTok, macros map[string]bool) bool {
+	for i, t := range body {
+		if macros[t.lit] {
+			return false
+		}
+		switch t.lit {
+		case "asm", "__asm", "__asm__":
+			return false
+		}
+		if i+1 == len(body) || body[i+1].tok != token.LPAREN {
+			continue
+		}
+		// C names that are Go keywords, such as select, scan as
+		// keywords, so only the keywords of C statements are let
+		// through.
+		switch t.tok {
+		case token.IF, token.FOR, token.SWITCH, token.RETURN, token.CASE, token.ELSE:
+		case token.IDENT:
+			switch t.lit {
+			case "sizeof", "while", "_Alignof", "__alignof__":
+			default:
+				return false
+			}
+		case token.RPAREN, token.RBRACK:
+			return false
+		default:
+			if t.tok.IsKeyword() {
+				return false
+			}
+		}
+	}
+	return true
+}
@@ -412,6 +412,9 @@ func buildModeInit() {
 			default:
 				fatalf("-linkshared not supported on %s\n", platform)
 			}
+			if buildBuildmode == "c-shared" && platform != "linux/amd64" {
+				fatalf("-buildmode=c-shared -linkshared not supported on %s\n", platform)
+			}
 			codegenArg = "-dynlink"
 			// TODO(mwhudson): remove -w when that gets fixed in linker.
 			buildLdflags = append(buildLdflags, "-linkshared", "-w")
@@ -3181,7 +3184,23 @@ func (b *builder) cgo(p *Package, cgoExe, obj string, pcCFLAGS, pcLDFLAGS, cgofi
 	}
 	defunC := obj + "_cgo_defun.c"
 
+	// With CGO_UNITY=1, cgo also writes the C side of all the cgo
+	// files as one translation unit, so that the C compiler runs
+	// once and can inline the preamble functions into any wrapper.
+	unity := os.Getenv("CGO_UNITY") == "1" && len(cgofiles) > 1
+
 	cgoflags := []string{}
+	if unity {
+		cgoflags = append(cgoflags, "-unity")
+	}
+	// With CGO_PROFILE set to a cgo call profile, cgo calls the hot,
+	// short C functions it shows as leaves.
+	if prof := os.Getenv("CGO_PROFILE"); prof != "" {
+		if abs, err := filepath.Abs(prof); err == nil {
+			prof = abs
+		}
+		cgoflags = append(cgoflags, "-profile="+prof)
+	}
 	// TODO: make cgo not depend on $GOARCH?
 
 	if p.Standard && p.ImportPath == "runtime/cgo" {
@@ -3288,6 +3307,40 @@ func (b *builder) cgo(p *Package, cgoExe, obj string, pcCFLAGS, pcLDFLAGS, cgofi
 	}
 
 	cflags := stringList(cgoCPPFLAGS, cgoCFLAGS)
+	for _, f := range cgoCFLAGS {
+		if strings.HasPrefix(f, "-flto") {
+			// The objects may be linked by the Go linker, which
+			// needs machine code, not just the compiler's
+			// intermediate form. Link-time optimization happens
+			// when the objects are linked externally with -flto.
+			if b.gccSupportsFlag("-ffat-lto-objects") {
+				cflags = append(cflags, "-ffat-lto-objects")
+			}
+			break
+		}
+	}
+	if unity {
+		// The preambles of the files may conflict when put
+		// together; then compile the files one by one as usual.
+		// Any diagnostic counts as a conflict: a static function
+		// or macro of one file may silently change the meaning
+		// of another, and gcc only warns about it.
+		ofile := obj + "_cgo_unity.o"
+		out, err := b.runOut(p.Dir, p.ImportPath, nil, b.gccCmd(p.Dir), cflags, "-o", ofile, "-c", mkAbs(p.Dir, obj+"_cgo_unity.c"))
+		if err != nil || len(out) > 0 {
+			if buildX {
+				msg := "# compiling cgo files one by one\n"
+				if len(out) > 0 {
+					msg = b.processOutput(out) + msg
+				}
+				b.showOutput(p.Dir, p.ImportPath, msg)
+			}
+		} else {
+			cfiles = cfiles[:2] // _cgo_main.c and _cgo_export.c
+			linkobj = append(linkobj, ofile)
+			outObj = append(outObj, ofile)
+		}
+	}
 	for _, cfile := range cfiles {
 		ofile := obj + cfile[:len(cfile)-1] + "o"
 		if err := b.gcc(p, ofile, cflags, obj+cfile); err != nil {
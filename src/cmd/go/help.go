@@ -464,6 +464,14 @@ Environment variables for use with cgo:
 		C++ code.
 	CGO_LDFLAGS
 		Flags that cgo will pass to the compiler when linking.
+	CGO_PROFILE
+		The file holding a cgo call profile, written by runtime/pprof
+		with debug=1, that cgo uses to make hot C calls faster.
+		See 'go doc cmd/cgo'.
+	CGO_UNITY
+		If set to 1, compile the C code that cgo generates for the
+		files of a package as one unit when their preambles compile
+		together without errors or warnings.
 	CXX
 		The command to use to compile C++ code.
 
@@ -559,6 +567,19 @@ are:
 		import, into C shared libraries. The only callable symbols will
 		be those functions exported using a cgo //export comment.
 		Non-main packages are ignored.
+		With -linkshared (linux/amd64 only), the libraries use the Go
+		shared libraries they import instead of copies of them, and
+		libraries loaded into the same process share a single runtime.
+		On linux/amd64 and linux/386 the libraries find the runtime's
+		per-thread state with the initial-exec TLS model, as
+		executables do, and are marked as needing static TLS. A
+		library loaded at program startup, because the program is
+		linked against it or it is named in LD_PRELOAD, gets its TLS
+		in the initial block. A library loaded later with dlopen uses
+		the space that the C library reserves for such libraries; if
+		that has run out, dlopen fails with "cannot allocate memory in
+		static TLS block", and the library must be loaded at startup
+		instead.
 
 	-buildmode=default
 		Listed main packages are built into executables and listed
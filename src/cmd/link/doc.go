@@ -41,6 +41,12 @@ Flags:
 		Set the value of the string variable in importpath named name to value.
 		Note that before Go 1.5 this option took two separate arguments.
 		Now it takes one argument split on the first = sign.
+	-bindnow
+		Resolve the functions the program imports from shared
+		libraries, such as the C library functions called by cgo code,
+		when the program or library is loaded instead of on the first
+		call of each, so that no later call waits for the dynamic
+		linker. Supported for ELF and, with external linking, Mach-O.
 	-buildmode mode
 		Set build mode (default exe).
 	-cpuprofile file
@@ -66,6 +72,9 @@ Flags:
 	-installsuffix suffix
 		Look for packages in $GOROOT/pkg/$GOOS_$GOARCH_suffix
 		instead of $GOROOT/pkg/$GOOS_$GOARCH.
+	-lazyinit
+		With -buildmode=c-archive or c-shared, start the Go runtime
+		on the first call into Go instead of when the library is loaded.
 	-libgcc file
 		Set name of compiler support library.
 		This is only used in internal link mode.
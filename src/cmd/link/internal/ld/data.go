@@ -1832,6 +1832,13 @@ func dodataSect(symn int, syms []*LSym) (result []*LSym, maxAlign int32) {
 			// we skip size comparison and fall through to the name
 			// comparison (conveniently, .got sorts before .toc).
 			symsSort[i].size = 0
+		case obj.SINITARR:
+			// Register the module with the runtime before the entry
+			// point of a library built with -linkshared runs; see
+			// runtime.libstart.
+			if s.Name == "go.link.addmoduledatainit" {
+				symsSort[i].size = 0
+			}
 		case obj.STYPELINK:
 			// Sort typelinks by the rtype.string field so the reflect
 			// package can binary search type links.
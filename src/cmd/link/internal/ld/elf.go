@@ -283,6 +283,7 @@ const (
 	DT_VERNEED           = 0x6ffffffe
 	DT_VERNEEDNUM        = 0x6fffffff
 	DT_VERSYM            = 0x6ffffff0
+	DT_FLAGS_1           = 0x6ffffffb
 	DT_PPC64_GLINK       = DT_LOPROC + 0
 	DT_PPC64_OPT         = DT_LOPROC + 3
 	DF_ORIGIN            = 0x0001
@@ -290,6 +291,7 @@ const (
 	DF_TEXTREL           = 0x0004
 	DF_BIND_NOW          = 0x0008
 	DF_STATIC_TLS        = 0x0010
+	DF_1_NOW             = 0x00000001
 	NT_PRSTATUS          = 1
 	NT_FPREGSET          = 2
 	NT_PRPSINFO          = 3
@@ -2049,6 +2051,11 @@ func doelf() {
 			Elfwritedynent(s, DT_PPC64_OPT, 0)
 		}
 
+		if flag_bindnow {
+			Elfwritedynent(s, DT_FLAGS, DF_BIND_NOW)
+			Elfwritedynent(s, DT_FLAGS_1, DF_1_NOW)
+		}
+
 		// Solaris dynamic linker can't handle an empty .rela.plt if
 		// DT_JMPREL is emitted so we have to defer generation of DT_PLTREL,
 		// DT_PLTRELSZ, and DT_JMPREL dynamic entries until after we know the
@@ -196,8 +196,10 @@ var (
 	Funcalign          int
 	iscgo              bool
 	elfglobalsymndx    int
+	flag_bindnow       bool
 	flag_dumpdep       bool
 	flag_installsuffix string
+	flag_lazyinit      bool
 	flag_race          int
 	flag_msan          int
 	Buildmode          BuildMode
@@ -496,14 +498,27 @@ func loadinternal(name string) {
 func loadlib() {
 	switch Buildmode {
 	case BuildmodeCShared:
-		s := Linklookup(Ctxt, "runtime.islibrary", 0)
-		s.Attr |= AttrDuplicateOK
-		Adduint8(Ctxt, s, 1)
+		// With -linkshared, runtime.islibrary is in the shared
+		// runtime, which sets it when a library starts it.
+		if !Linkshared {
+			s := Linklookup(Ctxt, "runtime.islibrary", 0)
+			s.Attr |= AttrDuplicateOK
+			Adduint8(Ctxt, s, 1)
+		}
 	case BuildmodeCArchive:
 		s := Linklookup(Ctxt, "runtime.isarchive", 0)
 		s.Attr |= AttrDuplicateOK
 		Adduint8(Ctxt, s, 1)
 	}
+	if flag_lazyinit && Linkshared {
+		Exitf("-lazyinit and -linkshared are incompatible")
+	}
+	if flag_lazyinit && (Buildmode == BuildmodeCShared || Buildmode == BuildmodeCArchive) {
+		// Read by x_cgo_sys_thread_create in runtime/cgo.
+		s := Linklookup(Ctxt, "_cgo_lazy_init", 0)
+		s.Attr |= AttrDuplicateOK
+		Adduint8(Ctxt, s, 1)
+	}
 
 	loadinternal("runtime")
 	if SysArch.Family == sys.ARM {
@@ -1116,11 +1131,18 @@ func hostlink() {
 		argv = append(argv, "-shared")
 	}
 
-	if Iself && DynlinkingGo() {
+	if Iself && (DynlinkingGo() || flag_bindnow) {
 		// We force all symbol resolution to be done at program startup
 		// because lazy PLT resolution can use large amounts of stack at
-		// times we cannot allow it to do so.
+		// times we cannot allow it to do so, and, with -bindnow, so
+		// that no later call pays for it.
 		argv = append(argv, "-Wl,-znow")
+	}
+	if HEADTYPE == obj.Hdarwin && flag_bindnow {
+		argv = append(argv, "-Wl,-bind_at_load")
+	}
+
+	if Iself && DynlinkingGo() {
 
 		// Do not let the host linker generate COPY relocations. These
 		// can move symbols out of sections that rely on stable offsets
@@ -360,7 +360,7 @@ func symtab() {
 	// pseudo-symbols to mark locations of type, string, and go string data.
 	var symtype *LSym
 	var symtyperel *LSym
-	if UseRelro() && (Buildmode == BuildmodeCShared || Buildmode == BuildmodePIE) {
+	if UseRelro() && (Buildmode == BuildmodeCShared || Buildmode == BuildmodePIE) && !DynlinkingGo() {
 		s = Linklookup(Ctxt, "type.*", 0)
 
 		s.Type = obj.STYPE
@@ -535,6 +535,13 @@ func symtab() {
 	Addaddr(Ctxt, moduledata, Linklookup(Ctxt, "runtime.itablink", 0))
 	adduint(Ctxt, moduledata, uint64(nitablinks))
 	adduint(Ctxt, moduledata, uint64(nitablinks))
+	// The init function of a library built with -buildmode=c-shared
+	// that shares the runtime with other libraries; see runtime.libstart.
+	if Buildmode == BuildmodeCShared && Linkshared {
+		Addaddr(Ctxt, moduledata, Linklookup(Ctxt, "main.init", 0))
+	} else {
+		adduint(Ctxt, moduledata, 0)
+	}
 	if len(Ctxt.Shlibs) > 0 {
 		thismodulename := filepath.Base(outfile)
 		switch Buildmode {
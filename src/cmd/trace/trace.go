@@ -387,6 +387,10 @@ func generateTrace(params *traceParams) ViewerData {
 			ctx.emitArrow(ev, "unblock")
 		case trace.EvGoSysCall:
 			ctx.emitInstant(ev, "syscall")
+		case trace.EvCgoCall:
+			ctx.emitInstant(ev, "cgo call")
+		case trace.EvCgoCallback:
+			ctx.emitInstant(ev, "cgo callback")
 		case trace.EvGoSysExit:
 			ctx.grunnable++
 			ctx.emitGoroutineCounters(ev)
@@ -527,11 +531,29 @@ func (ctx *traceContext) emitThreadCounters(ev *trace.Event) {
 
 func (ctx *traceContext) emitInstant(ev *trace.Event, name string) {
 	var arg interface{}
-	if ev.Type == trace.EvProcStart {
+	switch ev.Type {
+	case trace.EvProcStart:
 		type Arg struct {
 			ThreadID uint64
 		}
 		arg = &Arg{ev.Args[0]}
+	case trace.EvCgoCall:
+		if ev.Link != nil {
+			type Arg struct {
+				Duration string
+			}
+			arg = &Arg{time.Duration(ev.Link.Ts - ev.Ts).String()}
+		}
+	case trace.EvCgoCallback:
+		type Arg struct {
+			Duration string
+			NeedM    string
+		}
+		a := &Arg{NeedM: time.Duration(ev.Args[0]).String()}
+		if ev.Link != nil {
+			a.Duration = time.Duration(ev.Link.Ts - ev.Ts).String()
+		}
+		arg = a
 	}
 	ctx.emit(&ViewerEvent{Name: name, Phase: "I", Scope: "t", Time: ctx.time(ev), Tid: ctx.proc(ev), Stack: ctx.stack(ev.Stk), Arg: arg})
 }
@@ -1249,6 +1249,8 @@ func (ctxt *Context) saveCgo(filename string, di *Package, cg *ast.CommentGroup)
 			di.CgoLDFLAGS = append(di.CgoLDFLAGS, args...)
 		case "pkg-config":
 			di.CgoPkgConfig = append(di.CgoPkgConfig, args...)
+		case "affinity", "async", "batch", "layout", "leaf", "limit", "stack":
+			// Handled by cmd/cgo; they do not affect the build.
 		default:
 			return fmt.Errorf("%s: invalid #cgo verb: %s", filename, orig)
 		}
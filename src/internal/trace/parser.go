@@ -39,6 +39,8 @@ type Event struct {
 	// for GoUnblock: the associated GoStart
 	// for blocking GoSysCall: the associated GoSysExit
 	// for GoSysExit: the next GoStart
+	// for CgoCall: the CgoCallDone
+	// for CgoCallback: the CgoCallbackEnd
 	Link *Event
 }
 
@@ -112,7 +114,7 @@ func readTrace(r io.Reader) (ver int, events []rawEvent, strings map[uint64]stri
 		return
 	}
 	switch ver {
-	case 1005, 1007:
+	case 1005, 1007, 1008:
 		break
 	default:
 		err = fmt.Errorf("unsupported trace file version %v.%v (update Go toolchain) %v", ver/1000, ver%1000, ver)
@@ -485,6 +487,7 @@ func postProcessTrace(ver int, events []*Event) error {
 		ev       *Event
 		evStart  *Event
 		evCreate *Event
+		evCgo    []*Event // unfinished EvCgoCall and EvCgoCallback events, innermost last
 	}
 	type pdesc struct {
 		running bool
@@ -674,6 +677,19 @@ func postProcessTrace(ver int, events []*Event) error {
 			g.evStart.Link = ev
 			g.evStart = nil
 			p.g = 0
+		case EvCgoCall, EvCgoCallback:
+			g.evCgo = append(g.evCgo, ev)
+		case EvCgoCallDone, EvCgoCallbackEnd:
+			// Calls between Go and C nest. The start of a call
+			// is missing if tracing started during it.
+			start := byte(EvCgoCall)
+			if ev.Type == EvCgoCallbackEnd {
+				start = EvCgoCallback
+			}
+			if n := len(g.evCgo); n > 0 && g.evCgo[n-1].Type == start {
+				g.evCgo[n-1].Link = ev
+				g.evCgo = g.evCgo[:n-1]
+			}
 		}
 
 		gs[ev.G] = g
@@ -872,7 +888,11 @@ const (
 	EvGoStartLocal   = 38 // goroutine starts running on the same P as the last event [timestamp, goroutine id]
 	EvGoUnblockLocal = 39 // goroutine is unblocked on the same P as the last event [timestamp, goroutine id, stack]
 	EvGoSysExitLocal = 40 // syscall exit on the same P as the last event [timestamp, goroutine id, real timestamp]
-	EvCount          = 41
+	EvCgoCall        = 41 // call from Go to C, before the syscall enter [timestamp, stack]
+	EvCgoCallDone    = 42 // call from Go to C returns [timestamp]
+	EvCgoCallback    = 43 // call from C to Go, after the syscall exit [timestamp, nanoseconds spent acquiring an extra M]
+	EvCgoCallbackEnd = 44 // call from C to Go returns [timestamp]
+	EvCount          = 45
 )
 
 var EventDescriptions = [EvCount]struct {
@@ -922,4 +942,8 @@ var EventDescriptions = [EvCount]struct {
 	EvGoStartLocal:   {"GoStartLocal", 1007, false, []string{"g"}},
 	EvGoUnblockLocal: {"GoUnblockLocal", 1007, true, []string{"g"}},
 	EvGoSysExitLocal: {"GoSysExitLocal", 1007, false, []string{"g", "ts"}},
+	EvCgoCall:        {"CgoCall", 1008, true, []string{}},
+	EvCgoCallDone:    {"CgoCallDone", 1008, false, []string{}},
+	EvCgoCallback:    {"CgoCallback", 1008, false, []string{"needm"}},
+	EvCgoCallbackEnd: {"CgoCallbackEnd", 1008, false, []string{}},
 }
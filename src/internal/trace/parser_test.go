@@ -62,6 +62,7 @@ func TestParseVersion(t *testing.T) {
 	tests := map[string]int{
 		"go 1.5 trace\x00\x00\x00\x00": 1005,
 		"go 1.7 trace\x00\x00\x00\x00": 1007,
+		"go 1.8 trace\x00\x00\x00\x00": 1008,
 		"go 1.10 trace\x00\x00\x00":    1010,
 		"go 1.25 trace\x00\x00\x00":    1025,
 		"go 1.234 trace\x00\x00":       1234,
@@ -100,6 +100,19 @@ func Setenv(key, value string) error {
 	return nil
 }
 
+// Setenvs changes several environment variables at once. Each
+// element of kv is either of the form "key=value", which sets key to
+// value, or a key alone, which unsets it. On Unix systems, if any
+// element is invalid Setenvs changes nothing, and otherwise the
+// changes appear to Getenv all at once.
+func Setenvs(kv []string) error {
+	err := syscall.Setenvs(kv)
+	if err != nil {
+		return NewSyscallError("setenv", err)
+	}
+	return nil
+}
+
 // Unsetenv unsets a single environment variable.
 func Unsetenv(key string) error {
 	return syscall.Unsetenv(key)
@@ -7,6 +7,8 @@ package os_test
 import (
 	. "os"
 	"reflect"
+	"runtime"
+	"strconv"
 	"strings"
 	"testing"
 )
@@ -95,6 +97,75 @@ func TestUnsetenv(t *testing.T) {
 	}
 }
 
+func TestSetenvs(t *testing.T) {
+	const key1 = "GO_TEST_SETENVS1"
+	const key2 = "GO_TEST_SETENVS2"
+	defer Unsetenv(key1)
+	if err := Setenv(key2, "x"); err != nil {
+		t.Fatalf("Setenv: %v", err)
+	}
+	if err := Setenvs([]string{key1 + "=a=b", key2}); err != nil {
+		t.Fatalf("Setenvs: %v", err)
+	}
+	if v, ok := LookupEnv(key1); !ok || v != "a=b" {
+		t.Errorf("LookupEnv(%q) = %q, %v; want %q, true", key1, v, ok, "a=b")
+	}
+	if v, ok := LookupEnv(key2); ok {
+		t.Errorf("LookupEnv(%q) = %q, true; want unset", key2, v)
+	}
+	if runtime.GOOS == "windows" || runtime.GOOS == "plan9" {
+		return
+	}
+	// An invalid element changes nothing.
+	if err := Setenvs([]string{key1 + "=c", "=d"}); err == nil {
+		t.Errorf("Setenvs with an empty key succeeded")
+	}
+	if v := Getenv(key1); v != "a=b" {
+		t.Errorf("after failed Setenvs, Getenv(%q) = %q; want %q", key1, v, "a=b")
+	}
+}
+
+// Readers see each Setenvs whole, whether a change is made in place
+// or to a copy of the environment held by a reader.
+func TestSetenvsConcurrent(t *testing.T) {
+	if runtime.GOOS == "windows" || runtime.GOOS == "plan9" {
+		t.Skipf("Setenvs changes one variable at a time on %s", runtime.GOOS)
+	}
+	const key1 = "GO_TEST_SETENVS_CONCURRENT1"
+	const key2 = "GO_TEST_SETENVS_CONCURRENT2"
+	defer Unsetenv(key1)
+	defer Unsetenv(key2)
+	Setenvs([]string{key1 + "=0", key2 + "=0"})
+
+	done := make(chan bool)
+	go func() {
+		for i := 1; i <= 1000; i++ {
+			v := strconv.Itoa(i)
+			Setenvs([]string{key1 + "=" + v, key2 + "=" + v})
+		}
+		close(done)
+	}()
+	for {
+		select {
+		case <-done:
+			return
+		default:
+		}
+		var v1, v2 string
+		for _, kv := range Environ() {
+			if strings.HasPrefix(kv, key1+"=") {
+				v1 = kv[len(key1)+1:]
+			} else if strings.HasPrefix(kv, key2+"=") {
+				v2 = kv[len(key2)+1:]
+			}
+		}
+		if v1 != v2 {
+			t.Fatalf("Environ has %s=%s and %s=%s", key1, v1, key2, v2)
+		}
+		Getenv(key1)
+	}
+}
+
 func TestLookupEnv(t *testing.T) {
 	const smallpox = "SMALLPOX"      // No one has smallpox.
 	value, ok := LookupEnv(smallpox) // Should not exist.
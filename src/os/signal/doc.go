@@ -158,6 +158,12 @@ SIGILL, SIGTRAP, SIGSTKFLT, SIGCHLD, SIGPROF, SIGCANCEL, and
 SIGSETXID. When the Go function returns, the non-Go signal mask will
 be restored.
 
+If a non-Go handler for an asynchronous signal was installed before
+the Go signal handler, and the Go program has no use for the signal
+(it has not called Notify for it, and, for SIGPROF, is not profiling),
+the Go signal handler passes the signal straight to the non-Go
+handler, on any thread.
+
 If the Go signal handler is invoked on a non-Go thread not running Go
 code, the handler generally forwards the signal to the non-Go code, as
 follows. If the signal is SIGPROF, the Go handler does
@@ -587,6 +587,12 @@ TEXT ·asmcgocall(SB),NOSPLIT,$0-20
 	MOVQ	BX, DI		// DI = first argument in AMD64 ABI
 	MOVQ	BX, CX		// CX = first argument in Win64
 	CALL	AX
+	// C code compiled for AVX may return with the upper halves
+	// of the Y registers in use, which makes the SSE instructions
+	// of Go code slow until they are cleared.
+	CMPB	runtime·support_avx(SB), $1
+	JNE	2(PC)
+	VZEROUPPER
 
 	// Restore registers, g, stack pointer.
 	get_tls(CX)
@@ -617,11 +623,40 @@ nosave:
 	MOVQ	BX, DI		// DI = first argument in AMD64 ABI
 	MOVQ	BX, CX		// CX = first argument in Win64
 	CALL	AX
+	CMPB	runtime·support_avx(SB), $1
+	JNE	2(PC)
+	VZEROUPPER
 	MOVQ	40(SP), SI	// restore original stack pointer
 	MOVQ	SI, SP
 	MOVL	AX, ret+16(FP)
 	RET
 
+// func asmcgocallstack(fn, arg unsafe.Pointer) int32
+// Call fn(arg) on the current goroutine stack, for cgocallstack,
+// which has made sure that the stack has room for fn. Nothing can
+// move the stack while fn runs, so the old SP can be saved as is.
+TEXT ·asmcgocallstack(SB),NOSPLIT,$0-20
+	MOVQ	fn+0(FP), AX
+	MOVQ	arg+8(FP), BX
+	MOVQ	SP, DX
+
+	// Make sure we have enough room for 4 stack-backed fast-call
+	// registers as per windows amd64 calling convention.
+	SUBQ	$64, SP
+	ANDQ	$~15, SP	// alignment for gcc ABI
+	MOVQ	DX, 40(SP)	// save SP
+	MOVQ	BX, DI		// DI = first argument in AMD64 ABI
+	MOVQ	BX, CX		// CX = first argument in Win64
+	CALL	AX
+	CMPB	runtime·support_avx(SB), $1	// as in asmcgocall
+	JNE	2(PC)
+	VZEROUPPER
+
+	MOVQ	40(SP), SI
+	MOVQ	SI, SP
+	MOVL	AX, ret+16(FP)
+	RET
+
 // cgocallback(void (*fn)(void*), void *frame, uintptr framesize, uintptr ctxt)
 // Turn the fn into a Go func (by taking its address) and call
 // cgocallback_gofunc.
@@ -2084,8 +2119,26 @@ TEXT runtime·prefetchnta(SB),NOSPLIT,$0-8
 // This is called from .init_array and follows the platform, not Go, ABI.
 TEXT runtime·addmoduledata(SB),NOSPLIT,$0-0
 	PUSHQ	R15 // The access to global variables below implicitly uses R15, which is callee-save
+	// Once a library has started the runtime, modules loaded later
+	// wait on a list of their own until the runtime takes them;
+	// see libstart.
+	MOVL	runtime·libstarted(SB), AX
+	TESTL	AX, AX
+	JNZ	pending
 	MOVQ	runtime·lastmoduledatap(SB), AX
 	MOVQ	DI, moduledata_next(AX)
 	MOVQ	DI, runtime·lastmoduledatap(SB)
+	JMP	done
+pending:
+	MOVQ	runtime·pendingmoduletail(SB), AX
+	TESTQ	AX, AX
+	JZ	first
+	MOVQ	DI, moduledata_next(AX)
+	JMP	tail
+first:
+	MOVQ	DI, runtime·pendingmodulehead(SB)
+tail:
+	MOVQ	DI, runtime·pendingmoduletail(SB)
+done:
 	POPQ	R15
 	RET
@@ -17,7 +17,23 @@ import "unsafe"
 //go:linkname _cgo_sys_thread_create _cgo_sys_thread_create
 //go:linkname _cgo_notify_runtime_init_done _cgo_notify_runtime_init_done
 //go:linkname _cgo_callers _cgo_callers
+//go:linkname _cgo_callers_max _cgo_callers_max
+//go:linkname _cgo_fp_traceback _cgo_fp_traceback
 //go:linkname _cgo_set_context_function _cgo_set_context_function
+//go:linkname _cgo_thread_pool_init _cgo_thread_pool_init
+//go:linkname _cgo_thread_start_n _cgo_thread_start_n
+//go:linkname _cgo_set_thread_node _cgo_set_thread_node
+//go:linkname _cgo_startup_events _cgo_startup_events
+//go:linkname _cgo_bindm _cgo_bindm
+//go:linkname _cgo_async_wait _cgo_async_wait
+//go:linkname _cgo_set_context_rate _cgo_set_context_rate
+//go:linkname _cgo_callpool_submit _cgo_callpool_submit
+//go:linkname _cgo_init_library _cgo_init_library
+//go:linkname _cgo_thread_exit _cgo_thread_exit
+//go:linkname _cgo_init_wait_stats _cgo_init_wait_stats
+//go:linkname _cgo_stats_page _cgo_stats_page
+//go:linkname _cgo_thread_reset _cgo_thread_reset
+//go:linkname _cgo_getstackbounds _cgo_getstackbounds
 
 var (
 	_cgo_init                     unsafe.Pointer
@@ -27,7 +43,23 @@ var (
 	_cgo_sys_thread_create        unsafe.Pointer
 	_cgo_notify_runtime_init_done unsafe.Pointer
 	_cgo_callers                  unsafe.Pointer
+	_cgo_callers_max              unsafe.Pointer
+	_cgo_fp_traceback             unsafe.Pointer
 	_cgo_set_context_function     unsafe.Pointer
+	_cgo_thread_pool_init         unsafe.Pointer
+	_cgo_thread_start_n           unsafe.Pointer
+	_cgo_set_thread_node          unsafe.Pointer
+	_cgo_startup_events           unsafe.Pointer
+	_cgo_bindm                    unsafe.Pointer
+	_cgo_async_wait               unsafe.Pointer
+	_cgo_set_context_rate         unsafe.Pointer
+	_cgo_callpool_submit          unsafe.Pointer
+	_cgo_init_library             unsafe.Pointer
+	_cgo_thread_exit              unsafe.Pointer
+	_cgo_init_wait_stats          unsafe.Pointer
+	_cgo_stats_page               unsafe.Pointer
+	_cgo_thread_reset             unsafe.Pointer
+	_cgo_getstackbounds           unsafe.Pointer
 )
 
 // iscgo is set to true by the runtime/cgo package
@@ -0,0 +1,170 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+/*
+#include <stdlib.h>
+
+// These functions return void, as runtime/cgo cannot use the
+// generated code for C functions that return a value.
+
+static void cgoArenaBlock(size_t size, void **block) {
+	*block = calloc(1, size);
+}
+
+static void cgoArenaFree(void **blocks, size_t n) {
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		free(blocks[i]);
+	}
+}
+*/
+import "C"
+
+import "unsafe"
+
+const (
+	// arenaBlockSize is the size of the C blocks an Arena
+	// allocates from. Larger allocations get a block of their own.
+	arenaBlockSize = 64 << 10
+
+	// arenaAlign is the alignment of memory returned by Alloc,
+	// the same as C's malloc guarantees on common systems.
+	arenaAlign = 2 * unsafe.Sizeof(uintptr(0))
+
+	// arenaMapSize is the size from which an allocation gets
+	// pages mapped directly from the system rather than a block
+	// from calloc, so that copying a large buffer in takes one
+	// page-populating mmap instead of a fault per page. Smaller
+	// blocks are better left to calloc: glibc raises its own mmap
+	// threshold as high as 32 MB and then reuses freed memory,
+	// which has no faults at all.
+	arenaMapSize = 32 << 20
+
+	// arenaPageSize rounds the size of mapped blocks. It need not
+	// be the system page size, only a multiple of it.
+	arenaPageSize = 64 << 10
+
+	// arenaCopyMax is the most bytes CString and CBytes copy at
+	// once, limited by the largest array type on 32-bit systems.
+	arenaCopyMax = 1 << 30
+)
+
+// An Arena allocates C memory for use by C code, in bulk. It obtains
+// large blocks from C's malloc and hands out pieces of them without
+// calling into C, so a Go program building many small C objects pays
+// for one call from Go to C per block rather than one per object. All
+// the memory an Arena has allocated is released at once by Free.
+// Allocations of 32 megabytes or more are mapped directly from the
+// system where possible, and copies made by CString and CBytes have
+// their pages faulted in by the kernel in one go.
+//
+// Memory from an Arena is C memory: it may hold Go pointers only
+// under the cgo pointer passing rules for C memory, and it must not be
+// passed to C's free.
+//
+// The zero value is an empty Arena ready to use. An Arena must not be
+// used by multiple goroutines at once.
+type Arena struct {
+	blocks []unsafe.Pointer // all calloc'd blocks, for Free
+	maps   []unsafe.Pointer // all mapped blocks, for Free
+	sizes  []uintptr        // sizes of the mapped blocks
+	next   uintptr          // next free byte in the current block
+	end    uintptr          // end of the current block
+}
+
+// Alloc returns a pointer to n bytes of zeroed C memory, aligned for
+// any C type. It panics if C's malloc fails.
+func (a *Arena) Alloc(n uintptr) unsafe.Pointer {
+	return a.alloc(n, arenaAlign, false)
+}
+
+// CString returns a pointer to a NUL-terminated copy of s in C
+// memory, like C.CString but allocated from the arena.
+func (a *Arena) CString(s string) unsafe.Pointer {
+	p := a.alloc(uintptr(len(s))+1, 1, true)
+	for q := p; len(s) > 0; {
+		n := copy((*[arenaCopyMax]byte)(q)[:], s)
+		s = s[n:]
+		q = unsafe.Pointer(uintptr(q) + uintptr(n))
+	}
+	return p
+}
+
+// CBytes returns a pointer to a copy of b in C memory, like C.CBytes
+// but allocated from the arena.
+func (a *Arena) CBytes(b []byte) unsafe.Pointer {
+	p := a.alloc(uintptr(len(b)), 1, true)
+	for q := p; len(b) > 0; {
+		n := copy((*[arenaCopyMax]byte)(q)[:], b)
+		b = b[n:]
+		q = unsafe.Pointer(uintptr(q) + uintptr(n))
+	}
+	return p
+}
+
+// Free releases all the memory allocated from the arena. The arena
+// may be used again afterward.
+func (a *Arena) Free() {
+	if len(a.blocks) > 0 {
+		C.cgoArenaFree(&a.blocks[0], C.size_t(len(a.blocks)))
+	}
+	for i := range a.blocks {
+		a.blocks[i] = nil
+	}
+	a.blocks = a.blocks[:0]
+	if len(a.maps) > 0 {
+		arenaUnmapBlocks(a.maps, a.sizes)
+	}
+	for i := range a.maps {
+		a.maps[i] = nil
+	}
+	a.maps = a.maps[:0]
+	a.sizes = a.sizes[:0]
+	a.next = 0
+	a.end = 0
+}
+
+// alloc returns n bytes aligned to align. If fill is set, the caller
+// is about to write all n bytes.
+func (a *Arena) alloc(n, align uintptr, fill bool) unsafe.Pointer {
+	if n == 0 {
+		// Return a valid, distinct pointer, as malloc(1) would.
+		n = 1
+	}
+	p := (a.next + align - 1) &^ (align - 1)
+	if a.end != 0 && p <= a.end && n <= a.end-p {
+		a.next = p + n
+		return unsafe.Pointer(p)
+	}
+	if n >= arenaMapSize && n <= ^uintptr(0)-arenaPageSize {
+		size := (n + arenaPageSize - 1) &^ (arenaPageSize - 1)
+		if b := arenaMapBlock(size, fill); b != nil {
+			a.maps = append(a.maps, b)
+			a.sizes = append(a.sizes, size)
+			return b
+		}
+	}
+	if n > arenaBlockSize/4 {
+		// Give a large allocation a block of its own, and
+		// keep using the current block for small ones.
+		return a.newBlock(n)
+	}
+	b := uintptr(a.newBlock(arenaBlockSize))
+	a.next = b + n
+	a.end = b + arenaBlockSize
+	return unsafe.Pointer(b)
+}
+
+func (a *Arena) newBlock(size uintptr) unsafe.Pointer {
+	var b unsafe.Pointer
+	C.cgoArenaBlock(C.size_t(size), &b)
+	if b == nil {
+		panic("runtime/cgo: C calloc failed")
+	}
+	a.blocks = append(a.blocks, b)
+	return b
+}
@@ -0,0 +1,62 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build darwin dragonfly freebsd linux netbsd openbsd solaris
+
+package cgo
+
+/*
+#include <stddef.h>
+#include <sys/mman.h>
+
+#ifndef MAP_ANON
+#define MAP_ANON MAP_ANONYMOUS
+#endif
+
+static void cgoArenaMap(size_t size, int populate, void **block) {
+	int flags;
+	void *p;
+
+	flags = MAP_PRIVATE | MAP_ANON;
+#ifdef MAP_POPULATE
+	if (populate) {
+		flags |= MAP_POPULATE;
+	}
+#endif
+	p = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (p == MAP_FAILED) {
+		p = NULL;
+	}
+	*block = p;
+}
+
+static void cgoArenaUnmap(void **blocks, size_t *sizes, size_t n) {
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		munmap(blocks[i], sizes[i]);
+	}
+}
+*/
+import "C"
+
+import "unsafe"
+
+// arenaMapBlock maps size bytes of zeroed pages for an Arena block,
+// faulting them all in at once if populate is set and the system
+// supports it. It returns nil if the mapping fails.
+func arenaMapBlock(size uintptr, populate bool) unsafe.Pointer {
+	var b unsafe.Pointer
+	pop := C.int(0)
+	if populate {
+		pop = 1
+	}
+	C.cgoArenaMap(C.size_t(size), pop, &b)
+	return b
+}
+
+// arenaUnmapBlocks unmaps blocks mapped by arenaMapBlock.
+func arenaUnmapBlocks(blocks []unsafe.Pointer, sizes []uintptr) {
+	C.cgoArenaUnmap(&blocks[0], (*C.size_t)(unsafe.Pointer(&sizes[0])), C.size_t(len(blocks)))
+}
@@ -0,0 +1,19 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !darwin,!dragonfly,!freebsd,!linux,!netbsd,!openbsd,!solaris
+
+package cgo
+
+import "unsafe"
+
+// arenaMapBlock always fails here, so Arena takes every block
+// from C's calloc.
+func arenaMapBlock(size uintptr, populate bool) unsafe.Pointer {
+	return nil
+}
+
+func arenaUnmapBlocks(blocks []unsafe.Pointer, sizes []uintptr) {
+	panic("runtime/cgo: arenaUnmapBlocks without mapped blocks")
+}
@@ -20,6 +20,13 @@ TEXT crosscall2(SB),NOSPLIT,$0
 	MOVQ	R14, 0x38(SP)
 	MOVQ	R15, 0x40(SP)
 
+	// Clear the upper halves of the Y registers that AVX code in
+	// the C caller may have left in use, as runtime·asmcgocall
+	// does when C returns to Go.
+	CMPB	runtime·support_avx(SB), $1
+	JNE	2(PC)
+	VZEROUPPER
+
 #ifdef GOOS_windows
 	// Win64 save RBX, RBP, RDI, RSI, RSP, R12, R13, R14, R15 and XMM6 -- XMM15.
 	MOVQ	DI, 0x48(SP)
@@ -64,6 +64,28 @@ var _cgo_malloc = &x_cgo_malloc
 var x_cgo_free byte
 var _cgo_free = &x_cgo_free
 
+// Lets C code replace the allocator behind x_cgo_malloc and x_cgo_free;
+// see GoSetCAllocator in gcc_util.c.
+
+//go:cgo_export_dynamic GoSetCAllocator
+
+// Let C threads keep an M between calls into Go; see GoRegisterThread
+// in gcc_libinit.c.
+
+//go:cgo_export_dynamic GoRegisterThread
+//go:cgo_export_dynamic GoUnregisterThread
+
+// Resets the C state of a thread whose locked goroutine has exited;
+// see GoSetThreadReset in gcc_threadreset.c.
+
+//go:cgo_export_dynamic GoSetThreadReset
+
+//go:cgo_import_static x_cgo_thread_reset
+//go:linkname x_cgo_thread_reset x_cgo_thread_reset
+//go:linkname _cgo_thread_reset _cgo_thread_reset
+var x_cgo_thread_reset byte
+var _cgo_thread_reset = &x_cgo_thread_reset
+
 //go:cgo_import_static x_cgo_thread_start
 //go:linkname x_cgo_thread_start x_cgo_thread_start
 //go:linkname _cgo_thread_start _cgo_thread_start
@@ -82,6 +104,14 @@ var _cgo_thread_start = &x_cgo_thread_start
 var x_cgo_sys_thread_create byte
 var _cgo_sys_thread_create = &x_cgo_sys_thread_create
 
+// Set to 1 by the linker flag -lazyinit. x_cgo_sys_thread_create
+// then leaves starting the runtime to the first call into Go,
+// in _cgo_wait_runtime_init_done.
+
+//go:cgo_export_static _cgo_lazy_init
+//go:linkname _cgo_lazy_init _cgo_lazy_init
+var _cgo_lazy_init byte
+
 // Notifies that the runtime has been initialized.
 //
 // We currently block at every CGO entry point (via _cgo_wait_runtime_init_done)
@@ -104,5 +134,61 @@ var _cgo_notify_runtime_init_done = &x_cgo_notify_runtime_init_done
 var x_cgo_set_context_function byte
 var _cgo_set_context_function = &x_cgo_set_context_function
 
+// Waits for calls queued by GoInvokeAsync.
+// Called by the runtime goroutine that runs them.
+
+//go:cgo_import_static x_cgo_async_wait
+//go:linkname x_cgo_async_wait x_cgo_async_wait
+//go:linkname _cgo_async_wait _cgo_async_wait
+var x_cgo_async_wait byte
+var _cgo_async_wait = &x_cgo_async_wait
+
+// Sets how often calls from C to Go call the context function.
+// See runtime.SetCgoTracebackContextRate.
+
+//go:cgo_import_static x_cgo_set_context_rate
+//go:linkname x_cgo_set_context_rate x_cgo_set_context_rate
+//go:linkname _cgo_set_context_rate _cgo_set_context_rate
+var x_cgo_set_context_rate byte
+var _cgo_set_context_rate = &x_cgo_set_context_rate
+
+// Copies out the counts of waits for the runtime to be initialized,
+// for runtime.ReadCgoStats.
+
+//go:cgo_import_static x_cgo_init_wait_stats
+//go:linkname x_cgo_init_wait_stats x_cgo_init_wait_stats
+//go:linkname _cgo_init_wait_stats _cgo_init_wait_stats
+var x_cgo_init_wait_stats byte
+var _cgo_init_wait_stats = &x_cgo_init_wait_stats
+
+// Reads runtime.CgoStats for C code; see GoReadCgoStats in gcc_stats.c.
+
+//go:cgo_export_dynamic GoReadCgoStats
+
+// The page of counters that sysmon publishes for GoReadStats.
+
+//go:cgo_export_dynamic GoReadStats
+
+//go:cgo_import_static x_cgo_stats_page
+//go:linkname x_cgo_stats_page x_cgo_stats_page
+//go:linkname _cgo_stats_page _cgo_stats_page
+var x_cgo_stats_page byte
+var _cgo_stats_page = &x_cgo_stats_page
+
+// Called by GoReadCgoStats like this:
+//   struct { GoCgoStats *s; } arg;
+//   crosscall2(_cgo_read_stats, &arg, sizeof arg, ctxt);
+
+//go:linkname _runtime_cgo_read_stats_internal runtime._cgo_read_stats_internal
+var _runtime_cgo_read_stats_internal byte
+
+//go:linkname _cgo_read_stats _cgo_read_stats
+//go:cgo_export_static _cgo_read_stats
+//go:nosplit
+//go:norace
+func _cgo_read_stats(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_read_stats_internal), a, uintptr(n), ctxt)
+}
+
 //go:cgo_export_static _cgo_topofstack
 //go:cgo_export_dynamic _cgo_topofstack
@@ -15,3 +15,19 @@ import _ "unsafe" // for go:linkname
 //go:linkname _cgo_callers _cgo_callers
 var x_cgo_callers byte
 var _cgo_callers = &x_cgo_callers
+
+// Number of PCs the traceback function may store, set by the runtime.
+
+//go:cgo_import_static x_cgo_callers_max
+//go:linkname x_cgo_callers_max x_cgo_callers_max
+//go:linkname _cgo_callers_max _cgo_callers_max
+var x_cgo_callers_max byte
+var _cgo_callers_max = &x_cgo_callers_max
+
+// The built-in frame pointer traceback function, see GODEBUG=cgofpunwind.
+
+//go:cgo_import_static x_cgo_fp_traceback
+//go:linkname x_cgo_fp_traceback x_cgo_fp_traceback
+//go:linkname _cgo_fp_traceback _cgo_fp_traceback
+var x_cgo_fp_traceback byte
+var _cgo_fp_traceback = &x_cgo_fp_traceback
@@ -0,0 +1,34 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build darwin dragonfly freebsd linux netbsd solaris
+
+package cgo
+
+import "unsafe"
+
+// Queues a call to a C function named in a #cgo async: directive on
+// the thread pool in gcc_callpool.c.
+
+//go:cgo_import_static x_cgo_callpool_submit
+//go:linkname x_cgo_callpool_submit x_cgo_callpool_submit
+//go:linkname _cgo_callpool_submit _cgo_callpool_submit
+var x_cgo_callpool_submit byte
+var _cgo_callpool_submit = &x_cgo_callpool_submit
+
+// Makes the goroutine waiting for a call on the thread pool runnable.
+// Called by a pool thread like this:
+//   struct { PoolCall *c; } a;
+//   crosscall2(_cgo_callpool_done, &a, sizeof a, ctxt);
+
+//go:linkname _runtime_cgo_callpool_done_internal runtime._cgo_callpool_done_internal
+var _runtime_cgo_callpool_done_internal byte
+
+//go:linkname _cgo_callpool_done _cgo_callpool_done
+//go:cgo_export_static _cgo_callpool_done
+//go:nosplit
+//go:norace
+func _cgo_callpool_done(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_callpool_done_internal), a, uintptr(n), ctxt)
+}
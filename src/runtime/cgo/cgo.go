@@ -30,6 +30,10 @@ package cgo
 #cgo windows LDFLAGS: -lmsvcrt -lm -mthreads
 
 #cgo CFLAGS: -Wall -Werror
+#cgo linux freebsd netbsd openbsd dragonfly solaris android CFLAGS: -ffunction-sections -fdata-sections
+
+// USDT probes; see libcgo.h.
+#cgo linux,cgo_usdt CPPFLAGS: -DGO_CGO_USDT
 
 #cgo solaris CPPFLAGS: -D_POSIX_PTHREAD_SEMANTICS
 
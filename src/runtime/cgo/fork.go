@@ -0,0 +1,29 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package cgo
+
+import "unsafe"
+
+// Forking the runtime of a library; see GoForkRuntime in gcc_fork.c
+// and runtime._cgo_fork_internal.
+
+//go:cgo_export_dynamic GoForkRuntime
+
+// Called by GoForkRuntime like this:
+//   struct { ForkArgs *a; } arg;
+//   crosscall2(_cgo_fork, &arg, sizeof arg, ctxt);
+
+//go:linkname _runtime_cgo_fork_internal runtime._cgo_fork_internal
+var _runtime_cgo_fork_internal byte
+
+//go:linkname _cgo_fork _cgo_fork
+//go:cgo_export_static _cgo_fork
+//go:nosplit
+//go:norace
+func _cgo_fork(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_fork_internal), a, uintptr(n), ctxt)
+}
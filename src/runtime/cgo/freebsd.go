@@ -20,3 +20,12 @@ import _ "unsafe" // for go:linkname
 
 var _environ uintptr
 var _progname uintptr
+
+// Restricts the calling thread to one NUMA node, or undoes that.
+// See runtime.LockOSThreadNode.
+
+//go:cgo_import_static x_cgo_set_thread_node
+//go:linkname x_cgo_set_thread_node x_cgo_set_thread_node
+//go:linkname _cgo_set_thread_node _cgo_set_thread_node
+var x_cgo_set_thread_node byte
+var _cgo_set_thread_node = &x_cgo_set_thread_node
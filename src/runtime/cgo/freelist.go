@@ -0,0 +1,61 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+/*
+#include <stddef.h>
+#include <stdint.h>
+
+extern void x_cgo_free_n(void*);
+
+static void cgoFreeList(void **ptrs, size_t n) {
+	struct {
+		void **ptrs;
+		uintptr_t n;
+	} a;
+
+	a.ptrs = ptrs;
+	a.n = n;
+	x_cgo_free_n(&a);
+}
+*/
+import "C"
+
+import "unsafe"
+
+// A FreeList collects pointers to C memory and frees them all with a
+// single call from Go to C, rather than one C.free call, each a full
+// transition into C, per pointer. It is meant for memory from
+// C.malloc, C.CString and C.CBytes, which it frees with the function
+// registered by GoSetCAllocator, if any, and C's free otherwise.
+// Memory from an Arena is released by the Arena's Free method instead.
+//
+// The zero value is an empty FreeList ready to use. A FreeList must
+// not be used by multiple goroutines at once.
+type FreeList struct {
+	ptrs []unsafe.Pointer
+}
+
+// Add adds p to the pointers to be freed by the next call to Free.
+func (l *FreeList) Add(p unsafe.Pointer) {
+	l.ptrs = append(l.ptrs, p)
+}
+
+// Len returns the number of pointers waiting to be freed.
+func (l *FreeList) Len() int {
+	return len(l.ptrs)
+}
+
+// Free frees all the pointers added since the last call to Free.
+// The list may be used again afterward.
+func (l *FreeList) Free() {
+	if len(l.ptrs) > 0 {
+		C.cgoFreeList(&l.ptrs[0], C.size_t(len(l.ptrs)))
+	}
+	for i := range l.ptrs {
+		l.ptrs[i] = nil
+	}
+	l.ptrs = l.ptrs[:0]
+}
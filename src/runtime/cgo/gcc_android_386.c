@@ -10,14 +10,45 @@
 static void* threadentry(void*);
 static pthread_key_t k1;
 
+#define tlsgoff 0xf8
 #define magic1 (0x23581321U)
 
+// tlsload returns the word at offset off from %gs.
+static uint32
+tlsload(uintptr off)
+{
+	uint32 x;
+
+	asm volatile("movl %%gs:(%1), %0" : "=r"(x) : "r"(off));
+	return x;
+}
+
+// tlsfind returns the offset from %gs, at most tlsgoff, of the value of
+// key k in the calling thread, or -1 if it is not there.
+static intptr_t
+tlsfind(pthread_key_t k)
+{
+	uintptr off;
+	intptr_t found;
+
+	found = -1;
+	pthread_setspecific(k, (void*)magic1);
+	for(off=0; off<=tlsgoff; off+=sizeof(uint32)) {
+		if(tlsload(off) == magic1) {
+			found = off;
+			break;
+		}
+	}
+	pthread_setspecific(k, 0);
+	return found;
+}
+
 static void
 inittls(void)
 {
-	uint32 x;
-	pthread_key_t tofree[128], k;
-	int i, ntofree;
+	pthread_key_t tofree[128], k, prevk, want;
+	int i, ntofree, havewant;
+	intptr_t off, prev, d;
 
 	/*
 	 * Same logic, code as gcc_android_amd64.c:/inittls.
@@ -34,18 +65,48 @@ inittls(void)
 	 *
 	 * As disgusting as on the darwin/386, darwin/amd64.
 	 */
+
+	/*
+	 * Bionic keeps the values of keys in an array in the thread's
+	 * TLS block, indexed by key. So rather than probe every key
+	 * up to the one whose value is at tlsgoff, find where the
+	 * values of the first two keys we get are, derive from them
+	 * the key we want, and probe only that one. Keys held by
+	 * others in between do not throw this off, as we compare
+	 * each key we get with the one we want rather than count
+	 * them. If the derivation is wrong, go back to probing key by key.
+	 * This keeps cold start short in apps that have already
+	 * created many keys.
+	 */
 	ntofree = 0;
+	prev = -1;
+	prevk = 0;
+	want = 0;
+	havewant = 0;
 	for(;;) {
 		if(pthread_key_create(&k, nil) < 0) {
 			fprintf(stderr, "runtime/cgo: pthread_key_create failed\n");
 			abort();
 		}
-		pthread_setspecific(k, (void*)magic1);
-		asm volatile("movl %%gs:0xf8, %0" : "=r"(x));
-		pthread_setspecific(k, 0);
-		if (x == magic1) {
-			k1 = k;
-			break;
+		if(havewant && (unsigned)k < (unsigned)want) {
+			// Not there yet.
+		} else {
+			off = tlsfind(k);
+			if(off == tlsgoff) {
+				k1 = k;
+				break;
+			}
+			havewant = 0;
+			if(off >= 0 && prev >= 0 && off > prev && (unsigned)k > (unsigned)prevk &&
+			   (off-prev)%((unsigned)k-(unsigned)prevk) == 0) {
+				d = (off-prev)/((unsigned)k-(unsigned)prevk);
+				if((tlsgoff-off)%d == 0) {
+					want = k + (tlsgoff-off)/d;
+					havewant = 1;
+				}
+			}
+			prev = off;
+			prevk = k;
 		}
 		if(ntofree >= nelem(tofree)) {
 			fprintf(stderr, "runtime/cgo: could not obtain pthread_keys\n");
@@ -75,7 +136,7 @@ threadentry(void *v)
 	ThreadStart ts;
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
 	pthread_setspecific(k1, (void*)ts.g);
 
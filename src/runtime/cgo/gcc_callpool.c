@@ -0,0 +1,184 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+// +build darwin dragonfly freebsd linux netbsd solaris
+
+#include <pthread.h>
+#include "libcgo.h"
+
+// The pool of threads that run calls to C functions named in #cgo async:
+// directives. The calling goroutine parks while a pool thread makes the
+// call, and the pool thread calls back into Go to make it runnable
+// again when the call returns. The pool grows, up to a limit set by the
+// runtime, only when every thread is busy; beyond that calls wait in a
+// queue. Threads exit only when the runtime is released.
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_callpool_done(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+extern void x_cgo_sys_thread_create(void* (*func)(void*), void* arg);
+
+/*
+ * A call handed to the pool.
+ * Also known to ../runtime/cgocallback.go as cgoPoolCall.
+ */
+typedef struct PoolCall PoolCall;
+struct PoolCall
+{
+	int32_t (*fn)(void*);
+	void *arg;
+	PoolCall *next;
+	uintptr_t g;		// used by the runtime
+	uintptr_t argoff;	// used by the runtime
+	int32_t err;		// result of fn, errno for calls that want it
+};
+
+static pthread_mutex_t callpool_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t callpool_cond = PTHREAD_COND_INITIALIZER;
+static PoolCall *callpool_head;	// queued calls, oldest first
+static PoolCall *callpool_tail;
+static uintptr_t callpool_nqueued;	// calls in the queue
+static uintptr_t callpool_nidle;	// threads waiting for a call
+static uintptr_t callpool_nthreads;	// threads started
+static int callpool_stopped;		// set by _cgo_callpool_stop
+
+static void*
+callpool_threadentry(void *v)
+{
+	PoolCall *c;
+	struct {
+		PoolCall *c;
+	} a;
+	uintptr_t ctxt;
+
+	for (;;) {
+		pthread_mutex_lock(&callpool_mu);
+		while (callpool_head == nil && !callpool_stopped) {
+			callpool_nidle++;
+			pthread_cond_wait(&callpool_cond, &callpool_mu);
+			callpool_nidle--;
+		}
+		if (callpool_head == nil) {
+			callpool_nthreads--;
+			pthread_mutex_unlock(&callpool_mu);
+			// Nothing joins pool threads.
+			pthread_detach(pthread_self());
+			return nil;
+		}
+		c = callpool_head;
+		callpool_head = c->next;
+		if (callpool_head == nil) {
+			callpool_tail = nil;
+		}
+		callpool_nqueued--;
+		pthread_mutex_unlock(&callpool_mu);
+
+		c->err = c->fn(c->arg);
+
+		// The goroutine may run, and c may be freed,
+		// as soon as the runtime has seen it.
+		a.c = c;
+		ctxt = _cgo_wait_runtime_init_done();
+		crosscall2(_cgo_callpool_done, &a, sizeof a, ctxt);
+		_cgo_release_context(ctxt);
+	}
+	return nil;
+}
+
+/*
+ * Called by the runtime, on the g0 stack of the M whose goroutine just
+ * parked, to queue a call. Starts a new pool thread if no thread is
+ * free to take the call and there are fewer than max threads.
+ */
+void
+x_cgo_callpool_submit(void *arg)
+{
+	struct {
+		PoolCall *c;
+		uintptr_t max;
+	} *a = arg;
+	PoolCall *c;
+	int start;
+
+	c = a->c;
+	c->next = nil;
+	pthread_mutex_lock(&callpool_mu);
+	if (callpool_tail == nil) {
+		callpool_head = c;
+	} else {
+		callpool_tail->next = c;
+	}
+	callpool_tail = c;
+	callpool_nqueued++;
+	start = 0;
+	if (callpool_nqueued > callpool_nidle && callpool_nthreads < a->max) {
+		callpool_nthreads++;
+		start = 1;
+	}
+	pthread_cond_signal(&callpool_cond);
+	pthread_mutex_unlock(&callpool_mu);
+
+	if (start) {
+		// This is _cgo_sys_thread_create. The thread inherits
+		// the signal mask of this M, like any thread that C
+		// code starts.
+		x_cgo_sys_thread_create(callpool_threadentry, nil);
+	}
+}
+
+/*
+ * Reports whether any call is queued or running on the pool.
+ */
+int
+_cgo_callpool_busy(void)
+{
+	int busy;
+
+	pthread_mutex_lock(&callpool_mu);
+	busy = callpool_nqueued > 0 || callpool_nidle < callpool_nthreads;
+	pthread_mutex_unlock(&callpool_mu);
+	return busy;
+}
+
+/*
+ * Called when the runtime is released, with the world stopped for good:
+ * idle pool threads exit.
+ */
+void
+_cgo_callpool_stop(void)
+{
+	pthread_mutex_lock(&callpool_mu);
+	callpool_stopped = 1;
+	pthread_cond_broadcast(&callpool_cond);
+	pthread_mutex_unlock(&callpool_mu);
+}
+
+/*
+ * Called by GoForkRuntime around fork. The child has none of the
+ * pool's threads, so it starts new ones as calls come.
+ */
+int
+_cgo_callpool_fork(int phase)
+{
+	switch (phase) {
+	case ForkPrepare:
+		pthread_mutex_lock(&callpool_mu);
+		if (callpool_nqueued > 0 || callpool_nidle < callpool_nthreads) {
+			pthread_mutex_unlock(&callpool_mu);
+			return 0;
+		}
+		break;
+	case ForkParent:
+		pthread_mutex_unlock(&callpool_mu);
+		break;
+	case ForkChild:
+		callpool_nidle = 0;
+		callpool_nthreads = 0;
+		pthread_mutex_init(&callpool_mu, nil);
+		pthread_cond_init(&callpool_cond, nil);
+		break;
+	}
+	return 1;
+}
@@ -16,6 +16,45 @@ void x_cgo_set_context_function(void (*context)(struct context_arg*)) {
 	x_cgo_context_function = context;
 }
 
+// Which calls from C to Go call the context function.
+// See runtime.SetCgoTracebackContextRate.
+static int32_t context_rate = 1;
+static int32_t context_profiling;
+static uint32_t context_count;
+
+// Sets context_rate and context_profiling.
+// Called from runtime.SetCgoTracebackContextRate and SetCPUProfileRate.
+void x_cgo_set_context_rate(void *arg) {
+	struct {
+		int32_t rate;
+		int32_t profiling;
+	} *a = arg;
+
+	__atomic_store_n(&context_rate, a->rate, __ATOMIC_RELAXED);
+	__atomic_store_n(&context_profiling, a->profiling, __ATOMIC_RELAXED);
+}
+
+// Reports whether the current call from C to Go should call the
+// context function.
+int _cgo_context_sampled(void) {
+	int32_t rate;
+	uint32_t n;
+
+	rate = __atomic_load_n(&context_rate, __ATOMIC_RELAXED);
+	if (rate == 1) {
+		return 1;
+	}
+	if (rate <= 0) {
+		return __atomic_load_n(&context_profiling, __ATOMIC_RELAXED);
+	}
+	// The count is shared by all threads. A plain load and store,
+	// rather than an atomic add, keeps the callers from contending
+	// on it; a lost update only shifts which calls are sampled.
+	n = __atomic_load_n(&context_count, __ATOMIC_RELAXED);
+	__atomic_store_n(&context_count, n + 1, __ATOMIC_RELAXED);
+	return n % rate == 0;
+}
+
 // Releases the cgo traceback context.
 void _cgo_release_context(uintptr_t ctxt) {
 	if (ctxt != 0 && x_cgo_context_function != nil) {
@@ -12,12 +12,40 @@ static pthread_key_t k1;
 
 #define magic1 (0x23581321U)
 
+static void
+newkey(pthread_key_t *k)
+{
+	if(pthread_key_create(k, nil) < 0) {
+		fprintf(stderr, "runtime/cgo: pthread_key_create failed\n");
+		abort();
+	}
+}
+
+/*
+ * Returns the offset from %gs of the first word at or below 0x468
+ * holding v, or 0 if there is none.
+ */
+static uintptr
+tsdoffset(uint32 v)
+{
+	uint32 x;
+	uintptr off;
+
+	for(off = 4; off <= 0x468; off += 4) {
+		asm volatile("movl %%gs:(%1), %0" : "=r"(x) : "r"(off));
+		if(x == v)
+			return off;
+	}
+	return 0;
+}
+
 static void
 inittls(void)
 {
 	uint32 x;
-	pthread_key_t tofree[128], k;
+	pthread_key_t tofree[128], k, want;
 	int i, ntofree;
+	uintptr off;
 
 	/*
 	 * Allocate thread-local storage slot for g.
@@ -61,12 +89,30 @@ inittls(void)
 	 * storage until we find a key that writes to the memory location
 	 * we want.  Then keep that key.
 	 */
+	newkey(&k);
 	ntofree = 0;
-	for(;;) {
-		if(pthread_key_create(&k, nil) < 0) {
-			fprintf(stderr, "runtime/cgo: pthread_key_create failed\n");
-			abort();
+
+	/*
+	 * Probing each key as we create it costs two pthread_setspecific
+	 * calls and a load per key. Instead, find where the first key's
+	 * value lands. Keys are handed out in increasing order and their
+	 * values are laid out in an array of 4-byte words, so that tells
+	 * us which key lands on 0x468. Create keys without probing until we
+	 * reach that one. The loop below then checks it, and falls back
+	 * to probing each key if the guess was wrong.
+	 */
+	pthread_setspecific(k, (void*)magic1);
+	off = tsdoffset(magic1);
+	pthread_setspecific(k, 0);
+	if(off != 0 && (0x468 - off) % 4 == 0) {
+		want = k + (0x468 - off) / 4;
+		while(k < want && ntofree < nelem(tofree)) {
+			tofree[ntofree++] = k;
+			newkey(&k);
 		}
+	}
+
+	for(;;) {
 		pthread_setspecific(k, (void*)magic1);
 		asm volatile("movl %%gs:0x468, %0" : "=r"(x));
 		pthread_setspecific(k, 0);
@@ -83,6 +129,7 @@ inittls(void)
 			abort();
 		}
 		tofree[ntofree++] = k;
+		newkey(&k);
 	}
 
 	/*
@@ -120,6 +167,9 @@ _cgo_sys_thread_start(ThreadStart *ts)
 	pthread_sigmask(SIG_SETMASK, &ign, &oset);
 
 	pthread_attr_init(&attr);
+	if (ts->stacksize != 0) {
+		pthread_attr_setstacksize(&attr, ts->stacksize);
+	}
 	pthread_attr_getstacksize(&attr, &size);
 	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
 	ts->g->stackhi = size;
@@ -139,7 +189,7 @@ threadentry(void *v)
 	ThreadStart ts;
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
 	pthread_setspecific(k1, (void*)ts.g);
 
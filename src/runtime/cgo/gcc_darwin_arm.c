@@ -62,6 +62,9 @@ _cgo_sys_thread_start(ThreadStart *ts)
 
 	pthread_attr_init(&attr);
 	size = 0;
+	if (ts->stacksize != 0) {
+		pthread_attr_setstacksize(&attr, ts->stacksize);
+	}
 	pthread_attr_getstacksize(&attr, &size);
 	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
 	ts->g->stackhi = size;
@@ -82,7 +85,7 @@ threadentry(void *v)
 	ThreadStart ts;
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
 	darwin_arm_init_thread_exception_port();
 
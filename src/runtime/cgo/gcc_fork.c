@@ -0,0 +1,114 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+// +build linux
+
+#include <errno.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_fork(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * The arguments and results of runtime._cgo_fork_internal.
+ * Also known to ../runtime/cgofork_linux.go as cgoFork.
+ */
+typedef struct ForkArgs ForkArgs;
+struct ForkArgs
+{
+	void (*fork)(void*);
+	int32_t result;
+	int32_t pid;
+	int32_t err;
+};
+
+/*
+ * Values of ForkArgs.result.
+ */
+enum {
+	ForkDone,
+	ForkBusy,
+	ForkFailed,
+	ForkUnsupported,
+};
+
+/*
+ * Called by the runtime, with the world stopped and its own locks
+ * held, to fork.
+ */
+static void
+fork_locked(void *arg)
+{
+	ForkArgs *a;
+	pid_t pid;
+	int phase;
+
+	a = arg;
+	if (!_cgo_callpool_fork(ForkPrepare)) {
+		a->result = ForkBusy;
+		return;
+	}
+	_cgo_thread_pool_fork(ForkPrepare);
+	pid = fork();
+	a->err = errno;
+	phase = pid == 0 ? ForkChild : ForkParent;
+	_cgo_thread_pool_fork(phase);
+	_cgo_callpool_fork(phase);
+	if (pid < 0) {
+		a->result = ForkFailed;
+		return;
+	}
+	a->pid = pid;
+	a->result = ForkDone;
+}
+
+/*
+ * Forks a process that embeds a library built with
+ * -buildmode=c-archive or c-shared, with the Go runtime quiesced for
+ * the fork, so that the child can keep using the runtime: its heap,
+ * its goroutines and its initialized packages. The runtime's threads
+ * are stopped around the fork, and the child starts new ones as it
+ * needs them. Must be called from a thread not running Go code, once
+ * no goroutine is in a system call or a call to C other than the
+ * runtime's own. Returns as fork does: the child's process ID in the
+ * parent and 0 in the child, or -1 with errno set to EBUSY if
+ * goroutines were in the kernel or in C, to EINVAL if the program is
+ * not a library or uses the network poller or GoInvokeAsync, or to
+ * the error of fork.
+ */
+pid_t
+GoForkRuntime(void)
+{
+	struct {
+		ForkArgs *a;
+	} arg;
+	ForkArgs a;
+	uintptr_t ctxt;
+
+	ctxt = _cgo_wait_runtime_init_done();
+	a.fork = fork_locked;
+	a.result = ForkBusy;
+	a.pid = -1;
+	a.err = 0;
+	arg.a = &a;
+	crosscall2(_cgo_fork, &arg, sizeof arg, ctxt);
+	_cgo_release_context(ctxt);
+
+	switch (a.result) {
+	case ForkBusy:
+		errno = EBUSY;
+		return -1;
+	case ForkFailed:
+		errno = a.err;
+		return -1;
+	case ForkUnsupported:
+		errno = EINVAL;
+		return -1;
+	}
+	return a.pid;
+}
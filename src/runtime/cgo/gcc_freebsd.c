@@ -0,0 +1,178 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include <sys/param.h>
+#include <sys/cpuset.h>
+#include <sys/sysctl.h>
+#if __FreeBSD_version >= 1200000
+#include <sys/domainset.h>
+#endif
+#include <pthread.h>
+#include <pthread_np.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "libcgo.h"
+
+/*
+ * NUMA placement of threads, for GODEBUG=cgothreadaffinity=1
+ * and runtime.LockOSThreadNode. FreeBSD calls NUMA nodes memory
+ * domains. Systems that cannot list the CPUs of a domain report
+ * no nodes, and ones without sched_getcpu cannot tell the node of
+ * the creating thread, so cgothreadaffinity has no effect there;
+ * threads still inherit the cpuset of the thread that creates them.
+ */
+
+enum {
+	NodeMax = 64,
+};
+
+static pthread_once_t node_once = PTHREAD_ONCE_INIT;
+static int nnode;	// number of nodes found; 0 if the system reports none
+static cpuset_t node_cpus[NodeMax];
+
+// node_init reads the CPUs of each domain.
+static void
+node_init(void)
+{
+#ifdef CPU_WHICH_DOMAIN
+	int ndomains, n;
+	size_t len;
+
+	len = sizeof ndomains;
+	if (sysctlbyname("vm.ndomains", &ndomains, &len, NULL, 0) < 0) {
+		return;
+	}
+	for (n = 0; n < ndomains && n < NodeMax; n++) {
+		if (cpuset_getaffinity(CPU_LEVEL_WHICH, CPU_WHICH_DOMAIN, n, sizeof node_cpus[n], &node_cpus[n]) < 0) {
+			break;
+		}
+		nnode = n + 1;
+	}
+#endif
+}
+
+int
+_cgo_thread_node(void)
+{
+#if __FreeBSD_version >= 1300000
+	int cpu, n;
+
+	pthread_once(&node_once, node_init);
+	cpu = sched_getcpu();
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return -1;
+	}
+	for (n = 0; n < nnode; n++) {
+		if (CPU_ISSET(cpu, &node_cpus[n])) {
+			return n;
+		}
+	}
+#endif
+	return -1;
+}
+
+void
+_cgo_node_affinity(ThreadStart *ts, void *attr)
+{
+	int node;
+
+	if ((ts->flags & ThreadStartNodeAffinity) == 0) {
+		return;
+	}
+	node = _cgo_thread_node();
+	if (node < 0) {
+		return;
+	}
+	pthread_attr_setaffinity_np((pthread_attr_t*)attr, sizeof node_cpus[node], &node_cpus[node]);
+}
+
+int
+_cgo_bind_thread_node(int node)
+{
+	pthread_once(&node_once, node_init);
+	if (node < 0 || node >= nnode) {
+		return 0;
+	}
+	// On FreeBSD, id -1 means the calling thread.
+	if (cpuset_setaffinity(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof node_cpus[node], &node_cpus[node]) < 0) {
+		return 0;
+	}
+#ifdef DOMAINSET_POLICY_PREFER
+	{
+		domainset_t ds;
+
+		// Also prefer the node's memory for the thread's
+		// page faults, so that C per-node pools stay local.
+		// The CPUs are placed either way.
+		DOMAINSET_ZERO(&ds);
+		DOMAINSET_SET(node, &ds);
+		cpuset_setdomain(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof ds, &ds, DOMAINSET_POLICY_PREFER);
+	}
+#endif
+	return 1;
+}
+
+// Saved is the placement of a thread from before LockOSThreadNode
+// placed it, for unplaceOSThread. saved_key holds it per thread.
+typedef struct Saved Saved;
+struct Saved {
+	cpuset_t cpus;
+#ifdef DOMAINSET_POLICY_PREFER
+	domainset_t domains;
+	int policy;
+	int domainsok;
+#endif
+};
+
+static pthread_once_t saved_once = PTHREAD_ONCE_INIT;
+static pthread_key_t saved_key;
+
+static void
+saved_init(void)
+{
+	pthread_key_create(&saved_key, free);
+}
+
+/* Stub for runtime.LockOSThreadNode and runtime.unplaceOSThread */
+void
+x_cgo_set_thread_node(void *arg)
+{
+	struct a {
+		int32_t node;
+		int32_t ok;
+	} *a = arg;
+	Saved *saved;
+
+	pthread_once(&saved_once, saved_init);
+	saved = pthread_getspecific(saved_key);
+	if (a->node < 0) {
+		// Give the thread back its CPUs and memory policy.
+		if (saved != NULL) {
+			a->ok = cpuset_setaffinity(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof saved->cpus, &saved->cpus) == 0;
+#ifdef DOMAINSET_POLICY_PREFER
+			if (saved->domainsok) {
+				cpuset_setdomain(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof saved->domains, &saved->domains, saved->policy);
+			}
+#endif
+			pthread_setspecific(saved_key, NULL);
+			free(saved);
+		}
+		return;
+	}
+	if (saved == NULL) {
+		// Placing a thread again keeps what it had first.
+		saved = malloc(sizeof *saved);
+		if (saved != NULL && cpuset_getaffinity(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof saved->cpus, &saved->cpus) == 0) {
+#ifdef DOMAINSET_POLICY_PREFER
+			saved->domainsok = cpuset_getdomain(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1, sizeof saved->domains, &saved->domains, &saved->policy) == 0;
+#endif
+			pthread_setspecific(saved_key, saved);
+		} else {
+			free(saved);
+		}
+	}
+	a->ok = _cgo_bind_thread_node(a->node);
+}
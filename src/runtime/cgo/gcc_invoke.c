@@ -0,0 +1,130 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include <string.h>
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_invoke_vector(void *, int, uintptr);
+extern void _cgo_async_start(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * Runs calls[0] through calls[n-1] in order, going through
+ * crosscall2 and the runtime's callback entry only once.
+ */
+void
+GoInvokeVector(GoCall *calls, intptr_t n)
+{
+	struct {
+		GoCall *calls;
+		intptr_t n;
+	} a;
+	uintptr_t ctxt;
+
+	if (n <= 0) {
+		return;
+	}
+	ctxt = _cgo_wait_runtime_init_done();
+	a.calls = calls;
+	a.n = n;
+	crosscall2(_cgo_invoke_vector, &a, sizeof a, ctxt);
+	_cgo_release_context(ctxt);
+}
+
+/*
+ * A call queued by GoInvokeAsync, followed by a copy of its frame.
+ * Also known to ../runtime/cgocallback.go.
+ */
+typedef struct AsyncCall AsyncCall;
+struct AsyncCall
+{
+	AsyncCall *next;
+	GoCall call;
+};
+
+// The queued calls, most recent first. GoInvokeAsync pushes calls
+// with a compare-and-swap; x_cgo_async_wait takes them all at once
+// with an exchange, so there is no ABA problem.
+static AsyncCall *async_head;
+
+// Whether the runtime has been asked to start the goroutine
+// that runs queued calls.
+static int32_t async_started;
+
+/*
+ * Queues *call to be run by a goroutine and returns without waiting
+ * for it. The first call enters Go once to start that goroutine.
+ * Only the frame is copied; memory it points to is the caller's.
+ */
+void
+GoInvokeAsync(GoCall *call)
+{
+	AsyncCall *c, *old;
+	uintptr_t ctxt;
+	int32_t zero;
+	int dummy;
+
+	c = malloc(sizeof *c + call->size);
+	if (c == nil) {
+		// Make the call now rather than lose it.
+		GoInvokeVector(call, 1);
+		return;
+	}
+	c->call.fn = call->fn;
+	c->call.frame = c + 1;
+	c->call.size = call->size;
+	memcpy(c + 1, call->frame, call->size);
+
+	old = __atomic_load_n(&async_head, __ATOMIC_RELAXED);
+	do {
+		c->next = old;
+	} while (!__atomic_compare_exchange_n(&async_head, &old, c, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	if (old == nil) {
+		// The queue was empty, so the goroutine may be asleep.
+		_cgo_async_wake();
+	}
+
+	zero = 0;
+	if (__atomic_load_n(&async_started, __ATOMIC_ACQUIRE) == 0 &&
+	    __atomic_compare_exchange_n(&async_started, &zero, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		ctxt = _cgo_wait_runtime_init_done();
+		crosscall2(_cgo_async_start, &dummy, 0, ctxt);
+		_cgo_release_context(ctxt);
+	}
+}
+
+/*
+ * Called by the runtime goroutine that runs queued calls. Frees the
+ * calls it has finished running, waits for more, and takes them all
+ * off the queue, oldest first.
+ */
+void
+x_cgo_async_wait(void *arg)
+{
+	struct {
+		AsyncCall *done;
+		AsyncCall *next;
+	} *a = arg;
+	AsyncCall *c, *next, *list;
+
+	for (c = a->done; c != nil; c = next) {
+		next = c->next;
+		free(c);
+	}
+	a->done = nil;
+
+	_cgo_async_sleep((void**)&async_head);
+	c = __atomic_exchange_n(&async_head, nil, __ATOMIC_ACQUIRE);
+
+	list = nil;
+	for (; c != nil; c = next) {
+		next = c->next;
+		c->next = list;
+		list = c;
+	}
+	a->next = list;
+}
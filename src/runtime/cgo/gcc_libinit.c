@@ -9,16 +9,138 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> // strerror
+#include <sys/time.h>
 #include "libcgo.h"
 
 static pthread_cond_t runtime_init_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t runtime_init_mu = PTHREAD_MUTEX_INITIALIZER;
+
+// runtime_init_done is set once, under runtime_init_mu, with a release
+// store. Readers check it with an acquire load first, so that after
+// initialization every call into Go from C skips the mutex.
+// GoReleaseRuntime sets it to RuntimeReleased, which every later
+// call into Go finds on the slow path.
 static int runtime_init_done;
 
+enum {
+	RuntimeReleased = 2,
+};
+
+// The number of calls into Go that waited for the runtime to be
+// initialized, and the total time they waited, for runtime.CgoStats.
+static uint64_t init_waits;
+static uint64_t init_wait_usec;
+
+// With the linker flag -lazyinit, the thread that initializes the
+// runtime is started by the first call to _cgo_wait_runtime_init_done
+// rather than by the library constructor.
+// The symbol is weak for the link of _cgo_main.c,
+// which does not include the Go code that defines it.
+extern char _cgo_lazy_init __attribute__((weak));
+static pthread_once_t lazy_init_once = PTHREAD_ONCE_INIT;
+static void* (*lazy_init_func)(void*);
+static void* lazy_init_arg;
+static int lazy_init_started;
+
+static int
+lazy_init(void) {
+	return &_cgo_lazy_init != nil && _cgo_lazy_init != 0;
+}
+
+// The key binding a thread to its extra M, for GODEBUG=cgostickym=1
+// and GoRegisterThread.
+static pthread_once_t bindm_once = PTHREAD_ONCE_INIT;
+static pthread_key_t bindm_key;
+static int bindm_key_ok;
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_release_m(void *, int, uintptr);
+extern void _cgo_register_thread(void *, int, uintptr);
+extern void _cgo_init_modules(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+// Startup events, in the order they were recorded.
+// They are read by the runtime after x_cgo_notify_runtime_init_done,
+// by which point every event recorded before it is visible.
+enum {
+	StartupEventMax = 16,
+};
+static StartupEvent startup_events[StartupEventMax];
+static uint32 startup_nevents;
+
+void
+_cgo_startup_event(const char *name)
+{
+	struct timeval tv;
+	uint32 i;
+
+	// gettimeofday rather than clock_gettime, which needs -lrt
+	// on older C libraries. Microseconds are enough here.
+	gettimeofday(&tv, nil);
+	i = __atomic_fetch_add(&startup_nevents, 1, __ATOMIC_RELAXED);
+	if (i < StartupEventMax) {
+		startup_events[i].name = name;
+		startup_events[i].usec = (int64_t)tv.tv_sec*1000000 + tv.tv_usec;
+	}
+}
+
+/*
+ * Called by the runtime (GODEBUG=cgoinittrace=1) to copy out
+ * the startup events.
+ */
+void
+x_cgo_startup_events(void *arg)
+{
+	struct {
+		StartupEvent *ev;
+		uintptr max;
+		uintptr n;
+	} *a = arg;
+	uintptr i, n;
+
+	n = __atomic_load_n(&startup_nevents, __ATOMIC_RELAXED);
+	if (n > StartupEventMax) {
+		n = StartupEventMax;
+	}
+	if (n > a->max) {
+		n = a->max;
+	}
+	for (i = 0; i < n; i++) {
+		a->ev[i] = startup_events[i];
+	}
+	a->n = n;
+}
+
 void
 x_cgo_sys_thread_create(void* (*func)(void*), void* arg) {
 	pthread_t p;
-	int err = pthread_create(&p, NULL, func, arg);
+	int err;
+
+	// For -buildmode=c-archive and c-shared, this is called from
+	// the library constructor to start runtime initialization.
+	// The constructor runs before any other thread can call into
+	// Go, so lazy_init_func needs no lock.
+	if (lazy_init() && lazy_init_func == nil) {
+		lazy_init_func = func;
+		lazy_init_arg = arg;
+		return;
+	}
+	_cgo_startup_event("x_cgo_sys_thread_create");
+	err = pthread_create(&p, NULL, func, arg);
+	if (err != 0) {
+		fprintf(stderr, "pthread_create failed: %s", strerror(err));
+		abort();
+	}
+}
+
+static void
+lazy_init_start(void) {
+	pthread_t p;
+	int err;
+
+	__atomic_store_n(&lazy_init_started, 1, __ATOMIC_RELAXED);
+	_cgo_startup_event("x_cgo_sys_thread_create");
+	err = pthread_create(&p, NULL, lazy_init_func, lazy_init_arg);
 	if (err != 0) {
 		fprintf(stderr, "pthread_create failed: %s", strerror(err));
 		abort();
@@ -27,12 +149,33 @@ x_cgo_sys_thread_create(void* (*func)(void*), void* arg) {
 
 uintptr_t
 _cgo_wait_runtime_init_done() {
-	pthread_mutex_lock(&runtime_init_mu);
-	while (runtime_init_done == 0) {
-		pthread_cond_wait(&runtime_init_cond, &runtime_init_mu);
+	struct timeval start, end;
+	int done;
+
+	if (__atomic_load_n(&runtime_init_done, __ATOMIC_ACQUIRE) != 1) {
+		if (lazy_init() && __atomic_load_n(&runtime_init_done, __ATOMIC_RELAXED) == 0) {
+			pthread_once(&lazy_init_once, lazy_init_start);
+		}
+		_cgo_probe(init__wait__start);
+		pthread_mutex_lock(&runtime_init_mu);
+		if (runtime_init_done == 0) {
+			gettimeofday(&start, nil);
+			while (runtime_init_done == 0) {
+				pthread_cond_wait(&runtime_init_cond, &runtime_init_mu);
+			}
+			gettimeofday(&end, nil);
+			__atomic_fetch_add(&init_waits, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&init_wait_usec, (int64_t)(end.tv_sec - start.tv_sec)*1000000 + (end.tv_usec - start.tv_usec), __ATOMIC_RELAXED);
+		}
+		done = runtime_init_done;
+		pthread_mutex_unlock(&runtime_init_mu);
+		_cgo_probe(init__wait__done);
+		if (done == RuntimeReleased) {
+			fprintf(stderr, "runtime/cgo: call into Go after GoReleaseRuntime\n");
+			abort();
+		}
 	}
-	pthread_mutex_unlock(&runtime_init_mu);
-	if (x_cgo_context_function != nil) {
+	if (x_cgo_context_function != nil && _cgo_context_sampled()) {
 		struct context_arg arg;
 
 		arg.Context = 0;
@@ -42,10 +185,194 @@ _cgo_wait_runtime_init_done() {
 	return 0;
 }
 
+/*
+ * Called by runtime.ReadCgoStats to copy out the counts of waits for
+ * the runtime to be initialized.
+ */
+void
+x_cgo_init_wait_stats(void *arg) {
+	struct {
+		uint64_t n;
+		uint64_t ns;
+	} *a = arg;
+
+	a->n = __atomic_load_n(&init_waits, __ATOMIC_RELAXED);
+	a->ns = __atomic_load_n(&init_wait_usec, __ATOMIC_RELAXED) * 1000;
+}
+
+/*
+ * Called by the runtime, without a g, from the constructor of a library
+ * built with -buildmode=c-shared -linkshared when another library has
+ * already started the runtime they share. Runs the package
+ * initialization of the new library before the constructor returns.
+ */
+void
+x_cgo_init_library(void *dummy) {
+	uintptr_t ctxt;
+
+	ctxt = _cgo_wait_runtime_init_done();
+	crosscall2(_cgo_init_modules, nil, 0, ctxt);
+	_cgo_release_context(ctxt);
+}
+
+/*
+ * Called by GoReleaseRuntime before it enters Go to release the
+ * runtime. Returns 1 if the runtime is running or starting, in which
+ * case the caller must wait for it and release it, and 0 if it was
+ * never started or has already been released.
+ */
+int
+_cgo_libinit_release_begin(void) {
+	int running;
+
+	running = 1;
+	pthread_mutex_lock(&runtime_init_mu);
+	if (runtime_init_done == RuntimeReleased) {
+		running = 0;
+	} else if (runtime_init_done == 0 && lazy_init() && !__atomic_load_n(&lazy_init_started, __ATOMIC_RELAXED)) {
+		// With -lazyinit and no call into Go yet, there is
+		// nothing to release; just keep it from starting.
+		__atomic_store_n(&runtime_init_done, RuntimeReleased, __ATOMIC_RELEASE);
+		pthread_cond_broadcast(&runtime_init_cond);
+		running = 0;
+	}
+	pthread_mutex_unlock(&runtime_init_mu);
+	return running;
+}
+
+static void
+bindm_destructor(void *g0) {
+	// The thread is exiting; give its M back to the runtime.
+	crosscall2(_cgo_release_m, g0, 0, 0);
+}
+
+static void
+bindm_init(void) {
+	bindm_key_ok = pthread_key_create(&bindm_key, bindm_destructor) == 0;
+}
+
+/*
+ * Called by the runtime's needm (GODEBUG=cgostickym=1) to keep
+ * the M whose g0 is a->g0 for the rest of the calling thread's life.
+ * Sets a->ok if the thread exit hook was installed.
+ */
+void
+x_cgo_bindm(void *arg) {
+	struct {
+		void *g0;
+		int32_t ok;
+	} *a = arg;
+
+	pthread_once(&bindm_once, bindm_init);
+	a->ok = bindm_key_ok && pthread_setspecific(bindm_key, a->g0) == 0;
+}
+
+/*
+ * Binds an extra M to the calling thread, which must not have been
+ * created by Go, for the rest of the thread's life, so that its later
+ * calls into Go skip needm and dropm: the M, with its signal stack and
+ * the thread's g, stays installed between calls. Waits for the runtime
+ * to be initialized, so that later calls do not. Returns 1 if the
+ * thread is bound, and 0 if it cannot be, as on a thread created by Go.
+ */
+int
+GoRegisterThread(void) {
+	struct {
+		int32_t *ok;
+	} arg;
+	int32_t ok;
+	uintptr_t ctxt;
+
+	pthread_once(&bindm_once, bindm_init);
+	if (!bindm_key_ok) {
+		return 0;
+	}
+	if (pthread_getspecific(bindm_key) != nil) {
+		return 1;
+	}
+	ctxt = _cgo_wait_runtime_init_done();
+	ok = 0;
+	arg.ok = &ok;
+	crosscall2(_cgo_register_thread, &arg, sizeof arg, ctxt);
+	_cgo_release_context(ctxt);
+	return ok;
+}
+
+/*
+ * Gives the M bound to the calling thread by GoRegisterThread, or by
+ * GODEBUG=cgostickym=1, back to the runtime before the thread exits.
+ * Must not be called from C code called by Go. Does nothing if no M
+ * is bound, or once the runtime has been released.
+ */
+void
+GoUnregisterThread(void) {
+	void *g0;
+
+	pthread_once(&bindm_once, bindm_init);
+	if (!bindm_key_ok || __atomic_load_n(&runtime_init_done, __ATOMIC_ACQUIRE) == RuntimeReleased) {
+		return;
+	}
+	g0 = pthread_getspecific(bindm_key);
+	if (g0 == nil) {
+		return;
+	}
+	pthread_setspecific(bindm_key, nil);
+	crosscall2(_cgo_release_m, g0, 0, 0);
+}
+
 void
 x_cgo_notify_runtime_init_done(void* dummy) {
+	_cgo_startup_event("x_cgo_notify_runtime_init_done");
 	pthread_mutex_lock(&runtime_init_mu);
-	runtime_init_done = 1;
+	__atomic_store_n(&runtime_init_done, 1, __ATOMIC_RELEASE);
 	pthread_cond_broadcast(&runtime_init_cond);
 	pthread_mutex_unlock(&runtime_init_mu);
 }
+
+// The queue of calls made by GoInvokeAsync is empty when the runtime
+// goroutine that runs them goes to sleep; see gcc_invoke.c.
+static pthread_mutex_t async_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static int async_stopped;	// set by _cgo_libinit_stop
+
+void
+_cgo_async_sleep(void **p)
+{
+	pthread_mutex_lock(&async_mu);
+	while (__atomic_load_n(p, __ATOMIC_ACQUIRE) == nil && !async_stopped) {
+		pthread_cond_wait(&async_cond, &async_mu);
+	}
+	pthread_mutex_unlock(&async_mu);
+}
+
+void
+_cgo_async_wake(void)
+{
+	// Taking the mutex orders the wakeup after the check in
+	// _cgo_async_sleep, so that it cannot be missed.
+	pthread_mutex_lock(&async_mu);
+	pthread_cond_signal(&async_cond);
+	pthread_mutex_unlock(&async_mu);
+}
+
+/*
+ * Called by the runtime, with the world stopped for good, to release
+ * the runtime: later calls into Go abort, the goroutine that runs
+ * calls queued by GoInvokeAsync is woken so that its thread can exit,
+ * and threads with a bound M no longer hand it back when they exit.
+ */
+void
+_cgo_libinit_stop(void) {
+	pthread_mutex_lock(&runtime_init_mu);
+	__atomic_store_n(&runtime_init_done, RuntimeReleased, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&runtime_init_mu);
+
+	pthread_mutex_lock(&async_mu);
+	async_stopped = 1;
+	pthread_cond_broadcast(&async_cond);
+	pthread_mutex_unlock(&async_mu);
+
+	if (bindm_key_ok) {
+		pthread_key_delete(bindm_key);
+	}
+}
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style
 // license that can be found in the LICENSE file.
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include "libcgo.h"
@@ -15,7 +16,7 @@ x_cgo_sys_thread_create(void* (*func)(void*), void* arg) {
 uintptr_t
 _cgo_wait_runtime_init_done() {
 	// TODO(spetrovic): implement this method.
-	if (x_cgo_context_function != nil) {
+	if (x_cgo_context_function != nil && _cgo_context_sampled()) {
 		struct context_arg arg;
 
 		arg.Context = 0;
@@ -29,3 +30,55 @@ void
 x_cgo_notify_runtime_init_done(void* dummy) {
 	// TODO(spetrovic): implement this method.
 }
+
+/*
+ * Calls into Go never wait for the runtime here.
+ */
+void
+x_cgo_init_wait_stats(void *arg) {
+	struct {
+		uint64_t n;
+		uint64_t ns;
+	} *a = arg;
+
+	a->n = 0;
+	a->ns = 0;
+}
+
+/*
+ * Threads cannot be bound to an M here; see GoRegisterThread in
+ * gcc_libinit.c.
+ */
+int
+GoRegisterThread(void) {
+	return 0;
+}
+
+void
+GoUnregisterThread(void) {
+}
+
+// The queue of calls made by GoInvokeAsync is empty when the runtime
+// goroutine that runs them goes to sleep; see gcc_invoke.c.
+static pthread_mutex_t async_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+
+void
+_cgo_async_sleep(void **p)
+{
+	pthread_mutex_lock(&async_mu);
+	while (__atomic_load_n(p, __ATOMIC_ACQUIRE) == nil) {
+		pthread_cond_wait(&async_cond, &async_mu);
+	}
+	pthread_mutex_unlock(&async_mu);
+}
+
+void
+_cgo_async_wake(void)
+{
+	// Taking the mutex orders the wakeup after the check in
+	// _cgo_async_sleep, so that it cannot be missed.
+	pthread_mutex_lock(&async_mu);
+	pthread_cond_signal(&async_cond);
+	pthread_mutex_unlock(&async_mu);
+}
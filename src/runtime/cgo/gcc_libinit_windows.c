@@ -12,41 +12,42 @@
 
 #include "libcgo.h"
 
-static volatile long runtime_init_once_gate = 0;
-static volatile long runtime_init_once_done = 0;
-
-static CRITICAL_SECTION runtime_init_cs;
-
-static HANDLE runtime_init_wait;
-static int runtime_init_done;
-
-// Pre-initialize the runtime synchronization objects
-void
-_cgo_preinit_init() {
-	 runtime_init_wait = CreateEvent(NULL, TRUE, FALSE, NULL);
-	 if (runtime_init_wait == NULL) {
+// runtime_init_done is set once with an interlocked exchange.
+// Readers check it with an acquire load, which unlike an interlocked
+// read-modify-write does not bounce the cache line between callers,
+// so once it is set _cgo_wait_runtime_init_done never touches
+// runtime_init_wait.
+static volatile LONG runtime_init_done;
+
+// runtime_init_wait is the manual-reset event signaled when the runtime
+// is initialized. It is created on first use by whichever thread gets
+// there first; see _cgo_get_init_event.
+static HANDLE volatile runtime_init_wait;
+
+// Returns the runtime initialization event, creating it if needed.
+// Racing threads each create an event and try to install it; the losers
+// close theirs and use the winner's. Unlike a spin on a gate, no thread
+// ever waits for another to finish creating the event. This avoids
+// InitOnceExecuteOnce, which is not available on Windows XP.
+static HANDLE
+_cgo_get_init_event() {
+	HANDLE event, old;
+
+	event = InterlockedCompareExchangePointer((PVOID volatile*)&runtime_init_wait, NULL, NULL);
+	if (event != NULL) {
+		return event;
+	}
+	event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (event == NULL) {
 		fprintf(stderr, "runtime: failed to create runtime initialization wait event.\n");
 		abort();
-	 }
-
-	 InitializeCriticalSection(&runtime_init_cs);
-}
-
-// Make sure that the preinit sequence has run.
-void
-_cgo_maybe_run_preinit() {
-	 if (!InterlockedExchangeAdd(&runtime_init_once_done, 0)) {
-			if (InterlockedIncrement(&runtime_init_once_gate) == 1) {
-				 _cgo_preinit_init();
-				 InterlockedIncrement(&runtime_init_once_done);
-			} else {
-				 // Decrement to avoid overflow.
-				 InterlockedDecrement(&runtime_init_once_gate);
-				 while(!InterlockedExchangeAdd(&runtime_init_once_done, 0)) {
-						Sleep(0);
-				 }
-			}
-	 }
+	}
+	old = InterlockedCompareExchangePointer((PVOID volatile*)&runtime_init_wait, event, NULL);
+	if (old != NULL) {
+		CloseHandle(event);
+		return old;
+	}
+	return event;
 }
 
 void
@@ -62,19 +63,26 @@ x_cgo_sys_thread_create(void (*func)(void*), void* arg) {
 
 int
 _cgo_is_runtime_initialized() {
-	 EnterCriticalSection(&runtime_init_cs);
-	 int status = runtime_init_done;
-	 LeaveCriticalSection(&runtime_init_cs);
-	 return status;
+	return __atomic_load_n(&runtime_init_done, __ATOMIC_ACQUIRE) != 0;
 }
 
+// The number of calls into Go that waited for the runtime to be
+// initialized, and the total time they waited, for runtime.CgoStats.
+static uint64_t init_waits;
+static uint64_t init_wait_msec;
+
 uintptr_t
 _cgo_wait_runtime_init_done() {
-	 _cgo_maybe_run_preinit();
-	while (!_cgo_is_runtime_initialized()) {
-			WaitForSingleObject(runtime_init_wait, INFINITE);
+	if (!_cgo_is_runtime_initialized()) {
+		HANDLE event = _cgo_get_init_event();
+		DWORD start = GetTickCount();
+		while (!_cgo_is_runtime_initialized()) {
+			WaitForSingleObject(event, INFINITE);
+		}
+		__atomic_fetch_add(&init_waits, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&init_wait_msec, (DWORD)(GetTickCount() - start), __ATOMIC_RELAXED);
 	}
-	if (x_cgo_context_function != nil) {
+	if (x_cgo_context_function != nil && _cgo_context_sampled()) {
 		struct context_arg arg;
 
 		arg.Context = 0;
@@ -86,15 +94,84 @@ _cgo_wait_runtime_init_done() {
 
 void
 x_cgo_notify_runtime_init_done(void* dummy) {
-	 _cgo_maybe_run_preinit();
-
-	 EnterCriticalSection(&runtime_init_cs);
-	runtime_init_done = 1;
-	 LeaveCriticalSection(&runtime_init_cs);
+	HANDLE event = _cgo_get_init_event();
 
-	 if (!SetEvent(runtime_init_wait)) {
+	InterlockedExchange(&runtime_init_done, 1);
+	if (!SetEvent(event)) {
 		fprintf(stderr, "runtime: failed to signal runtime initialization complete.\n");
 		abort();
 	}
 }
 
+/*
+ * Called by runtime.ReadCgoStats to copy out the counts of waits for
+ * the runtime to be initialized.
+ */
+void
+x_cgo_init_wait_stats(void *arg) {
+	struct {
+		uint64_t n;
+		uint64_t ns;
+	} *a = arg;
+
+	a->n = __atomic_load_n(&init_waits, __ATOMIC_RELAXED);
+	a->ns = __atomic_load_n(&init_wait_msec, __ATOMIC_RELAXED) * 1000000;
+}
+
+/*
+ * Threads cannot be bound to an M here; see GoRegisterThread in
+ * gcc_libinit.c.
+ */
+int
+GoRegisterThread(void) {
+	return 0;
+}
+
+void
+GoUnregisterThread(void) {
+}
+
+// async_event is the auto-reset event that wakes the runtime goroutine
+// running calls made by GoInvokeAsync; see gcc_invoke.c. Like
+// runtime_init_wait, it is created on first use.
+static HANDLE volatile async_event;
+
+static HANDLE
+_cgo_get_async_event() {
+	HANDLE event, old;
+
+	event = InterlockedCompareExchangePointer((PVOID volatile*)&async_event, NULL, NULL);
+	if (event != NULL) {
+		return event;
+	}
+	event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (event == NULL) {
+		fprintf(stderr, "runtime: failed to create async call event.\n");
+		abort();
+	}
+	old = InterlockedCompareExchangePointer((PVOID volatile*)&async_event, event, NULL);
+	if (old != NULL) {
+		CloseHandle(event);
+		return old;
+	}
+	return event;
+}
+
+void
+_cgo_async_sleep(void **p) {
+	HANDLE event = _cgo_get_async_event();
+
+	// The event stays set if _cgo_async_wake runs between
+	// the check and the wait, so the wakeup is not lost.
+	while (__atomic_load_n(p, __ATOMIC_ACQUIRE) == NULL) {
+		WaitForSingleObject(event, INFINITE);
+	}
+}
+
+void
+_cgo_async_wake(void) {
+	if (!SetEvent(_cgo_get_async_event())) {
+		fprintf(stderr, "runtime: failed to signal async call event.\n");
+		abort();
+	}
+}
@@ -0,0 +1,415 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#define _GNU_SOURCE // for CPU_SET, sched_getcpu, pthread_attr_setaffinity_np
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h> // strerror
+#include <unistd.h>
+#include "libcgo.h"
+
+/* Stub for creating a batch of new threads */
+void
+x_cgo_thread_start_n(void *arg)
+{
+	struct a {
+		ThreadStart *ts;
+		uintptr n;
+	} *a = arg;
+	ThreadStart *ts[ThreadStartBatch];
+	uintptr i;
+
+	if(a->n > ThreadStartBatch) {
+		fprintf(stderr, "runtime/cgo: thread_start batch too large\n");
+		abort();
+	}
+	/* Make our own copies that can persist after we return. */
+	for(i = 0; i < a->n; i++) {
+		ts[i] = _cgo_thread_start_alloc();
+		*ts[i] = a->ts[i];
+	}
+
+	_cgo_sys_thread_start_n(ts, a->n);	/* OS-dependent half */
+}
+
+/*
+ * Starting threads, for every architecture. Each gcc_linux_GOARCH.c
+ * supplies x_cgo_init, whose arguments depend on the architecture and
+ * which calls _cgo_linux_init, and _cgo_linux_crosscall, which
+ * installs g on a new thread and calls into Go.
+ */
+
+static void* threadentry(void*);
+static void (*setg_gcc)(void*);
+
+#ifdef PTHREAD_ATTR_NO_SIGMASK_NP
+static const int attr_sigmask = 1;
+#else
+static const int attr_sigmask = 0;
+#endif
+
+// Set in gcc_android_386.c and gcc_android_amd64.c, which start
+// threads their own way.
+void* (*x_cgo_threadentry)(void*);
+
+/*
+ * The stack bounds of each thread, found once by stack_bounds.
+ * The key is created by _cgo_linux_init, before any other thread
+ * can use it.
+ */
+static pthread_key_t bounds_key;
+static int bounds_key_ok;
+
+/*
+ * Sets *lo and *hi to the bounds of the calling thread's stack, or
+ * leaves them alone if the C library cannot tell. glibc finds them
+ * with a system call, and for the main thread by reading
+ * /proc/self/maps, so each thread keeps its answer. Unless lookup
+ * is set, and on the signal stack, where they would be of no use,
+ * the kept answer is only read: pthread_getattr_np and malloc are
+ * not async-signal-safe, and a signal handler may call into Go.
+ */
+static void
+stack_bounds(uintptr *lo, uintptr *hi, int lookup)
+{
+	pthread_attr_t attr;
+	stack_t ss;
+	uintptr *b;
+	void *addr;
+	size_t size;
+
+	if (bounds_key_ok && (b = pthread_getspecific(bounds_key)) != nil) {
+		*lo = b[0];
+		*hi = b[1];
+		return;
+	}
+	if (!lookup) {
+		return;
+	}
+	if (sigaltstack(nil, &ss) == 0 && (ss.ss_flags & SS_ONSTACK) != 0) {
+		return;
+	}
+	if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+		return;
+	}
+	if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+		*lo = (uintptr)addr;
+		*hi = (uintptr)addr + size;
+		b = malloc(2 * sizeof *b);
+		if (b != nil) {
+			b[0] = *lo;
+			b[1] = *hi;
+			if (!bounds_key_ok || pthread_setspecific(bounds_key, b) != 0) {
+				free(b);
+			}
+		}
+	}
+	pthread_attr_destroy(&attr);
+}
+
+/* Stub for the runtime's g0 stack bounds on threads not started by Go */
+void
+x_cgo_getstackbounds(void *arg)
+{
+	struct {
+		uintptr lo;
+		uintptr hi;
+		uintptr lookup;
+	} *a = arg;
+
+	stack_bounds(&a->lo, &a->hi, a->lookup != 0);
+}
+
+void
+_cgo_linux_init(G *g, void (*setg)(void*))
+{
+	pthread_attr_t *attr;
+	uintptr lo, hi;
+	size_t size;
+
+	/* The memory sanitizer distributed with versions of clang
+	   before 3.8 has a bug: if you call mmap before malloc, mmap
+	   may return an address that is later overwritten by the msan
+	   library.  Avoid this problem by forcing a call to malloc
+	   here, before we ever call malloc.
+
+	   This is only required for the memory sanitizer, so it's
+	   unfortunate that we always run it.  It should be possible
+	   to remove this when we no longer care about versions of
+	   clang before 3.8.  The test for this is
+	   misc/cgo/testsanitizers.
+
+	   GCC works hard to eliminate a seemingly unnecessary call to
+	   malloc, so we actually use the memory we allocate.  */
+
+	_cgo_startup_event("x_cgo_init");
+	setg_gcc = setg;
+	attr = (pthread_attr_t*)malloc(sizeof *attr);
+	if (attr == NULL) {
+		fatalf("malloc failed: %s", strerror(errno));
+	}
+	_cgo_startup_event("x_cgo_init: malloc");
+	pthread_attr_init(attr);
+	pthread_attr_getstacksize(attr, &size);
+	g->stacklo = (uintptr)&size - size + 4096;
+	pthread_attr_destroy(attr);
+	free(attr);
+
+	// The default stack size is only a guess at the size of this
+	// thread's stack, which for the main thread follows the stack
+	// ulimit and for a thread started by a C host is whatever the
+	// host chose. Use the real bounds when the C library knows them.
+	bounds_key_ok = pthread_key_create(&bounds_key, free) == 0;
+	lo = 0;
+	hi = 0;
+	stack_bounds(&lo, &hi, 1);
+	if (lo < (uintptr)&size && (uintptr)&size < hi) {
+		g->stacklo = lo;
+	}
+	_cgo_startup_event("x_cgo_init: pthread_attr");
+}
+
+void
+_cgo_sys_thread_start(ThreadStart *ts)
+{
+	_cgo_sys_thread_start_n(&ts, 1);
+}
+
+void
+_cgo_sys_thread_start_n(ThreadStart **tsp, int n)
+{
+	pthread_attr_t attr;
+	sigset_t ign, oset;
+	pthread_t p;
+	size_t size;
+	ThreadStart *ts;
+	int err, i;
+
+	// A new thread must start with all signals blocked; minit
+	// unblocks them once its M is set up. Where the C library can
+	// set the mask through the thread's attributes, as glibc 2.32
+	// and later can, it blocks signals around the clone itself,
+	// so we need not block and restore them in this thread.
+	sigfillset(&ign);
+	if (!attr_sigmask) {
+		pthread_sigmask(SIG_SETMASK, &ign, &oset);
+	}
+
+	err = 0;
+	for (i = 0; i < n && err == 0; i++) {
+		ts = tsp[i];
+		// Not sure why the memset is necessary here,
+		// but without it, we get a bogus stack size
+		// out of pthread_attr_getstacksize on some
+		// architectures.  C'est la Linux.
+		memset(&attr, 0, sizeof attr);
+		pthread_attr_init(&attr);
+#ifdef PTHREAD_ATTR_NO_SIGMASK_NP
+		pthread_attr_setsigmask_np(&attr, &ign);
+#endif
+		size = 0;
+		if (ts->stacksize != 0) {
+			pthread_attr_setstacksize(&attr, ts->stacksize);
+		}
+		pthread_attr_getstacksize(&attr, &size);
+		// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
+		ts->g->stackhi = size;
+		if (!_cgo_thread_pool_start(ts, threadentry)) {
+			_cgo_node_affinity(ts, &attr);
+			err = pthread_create(&p, &attr, threadentry, ts);
+		}
+		pthread_attr_destroy(&attr);
+	}
+
+	if (!attr_sigmask) {
+		pthread_sigmask(SIG_SETMASK, &oset, nil);
+	}
+
+	if (err != 0) {
+		fatalf("pthread_create failed: %s", strerror(err));
+	}
+}
+
+static void*
+threadentry(void *v)
+{
+	ThreadStart ts;
+
+	if (x_cgo_threadentry) {
+		return x_cgo_threadentry(v);
+	}
+
+	ts = *(ThreadStart*)v;
+	_cgo_thread_start_free(v);
+	_cgo_probe1(thread__start, ts.g);
+
+	_cgo_linux_crosscall(ts.fn, setg_gcc, ts.g);
+	return nil;
+}
+
+/*
+ * NUMA placement of threads, for GODEBUG=cgothreadaffinity=1
+ * and runtime.LockOSThreadNode.
+ */
+
+enum {
+	NodeMax = 64,
+};
+
+static pthread_once_t node_once = PTHREAD_ONCE_INIT;
+static int nnode;	// number of nodes found; 0 if the system reports none
+static cpu_set_t node_cpus[NodeMax];
+
+// parse_cpulist parses a list of CPUs like "0-7,16-23" into set.
+static void
+parse_cpulist(const char *s, cpu_set_t *set)
+{
+	long lo, hi;
+	char *end;
+
+	CPU_ZERO(set);
+	while (*s != '\0') {
+		lo = strtol(s, &end, 10);
+		if (end == s) {
+			break;
+		}
+		hi = lo;
+		s = end;
+		if (*s == '-') {
+			hi = strtol(s+1, &end, 10);
+			s = end;
+		}
+		for (; lo <= hi && lo < CPU_SETSIZE; lo++) {
+			CPU_SET(lo, set);
+		}
+		if (*s != ',') {
+			break;
+		}
+		s++;
+	}
+}
+
+// node_init reads the CPUs of each node from sysfs.
+// Nodes are expected to be numbered densely from 0;
+// we stop at the first node that is missing.
+static void
+node_init(void)
+{
+	char path[64], buf[1024];
+	int fd, n;
+	ssize_t len;
+
+	for (n = 0; n < NodeMax; n++) {
+		snprintf(path, sizeof path, "/sys/devices/system/node/node%d/cpulist", n);
+		fd = open(path, O_RDONLY);
+		if (fd < 0) {
+			break;
+		}
+		len = read(fd, buf, sizeof buf - 1);
+		close(fd);
+		if (len <= 0) {
+			break;
+		}
+		buf[len] = '\0';
+		parse_cpulist(buf, &node_cpus[n]);
+		nnode = n + 1;
+	}
+}
+
+int
+_cgo_thread_node(void)
+{
+	int cpu, n;
+
+	pthread_once(&node_once, node_init);
+	cpu = sched_getcpu();
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return -1;
+	}
+	for (n = 0; n < nnode; n++) {
+		if (CPU_ISSET(cpu, &node_cpus[n])) {
+			return n;
+		}
+	}
+	return -1;
+}
+
+void
+_cgo_node_affinity(ThreadStart *ts, void *attr)
+{
+	int node;
+
+	if ((ts->flags & ThreadStartNodeAffinity) == 0) {
+		return;
+	}
+	node = _cgo_thread_node();
+	if (node < 0) {
+		return;
+	}
+#ifndef __ANDROID__
+	// Bionic has no pthread_attr_setaffinity_np.
+	pthread_attr_setaffinity_np((pthread_attr_t*)attr, sizeof node_cpus[node], &node_cpus[node]);
+#endif
+}
+
+int
+_cgo_bind_thread_node(int node)
+{
+	pthread_once(&node_once, node_init);
+	if (node < 0 || node >= nnode) {
+		return 0;
+	}
+	// On Linux, pid 0 means the calling thread.
+	return sched_setaffinity(0, sizeof node_cpus[node], &node_cpus[node]) == 0;
+}
+
+// saved_key holds, for a thread placed by LockOSThreadNode, a
+// malloc'd copy of the CPUs it had before, for unplaceOSThread.
+static pthread_once_t saved_once = PTHREAD_ONCE_INIT;
+static pthread_key_t saved_key;
+
+static void
+saved_init(void)
+{
+	pthread_key_create(&saved_key, free);
+}
+
+/* Stub for runtime.LockOSThreadNode and runtime.unplaceOSThread */
+void
+x_cgo_set_thread_node(void *arg)
+{
+	struct a {
+		int32_t node;
+		int32_t ok;
+	} *a = arg;
+	cpu_set_t *saved;
+
+	pthread_once(&saved_once, saved_init);
+	saved = pthread_getspecific(saved_key);
+	if (a->node < 0) {
+		// Give the thread back its CPUs.
+		if (saved != NULL) {
+			a->ok = sched_setaffinity(0, sizeof *saved, saved) == 0;
+			pthread_setspecific(saved_key, NULL);
+			free(saved);
+		}
+		return;
+	}
+	if (saved == NULL) {
+		// Placing a thread again keeps what it had first.
+		saved = malloc(sizeof *saved);
+		if (saved != NULL && sched_getaffinity(0, sizeof *saved, saved) == 0) {
+			pthread_setspecific(saved_key, saved);
+		} else {
+			free(saved);
+		}
+	}
+	a->ok = _cgo_bind_thread_node(a->node);
+}
@@ -3,71 +3,24 @@
 // license that can be found in the LICENSE file.
 
 #include <pthread.h>
-#include <string.h>
-#include <signal.h>
 #include "libcgo.h"
 
-static void *threadentry(void*);
-
 void (*x_cgo_inittls)(void **tlsg, void **tlsbase);
-void (*setg_gcc)(void*);
 
 void
-_cgo_sys_thread_start(ThreadStart *ts)
+x_cgo_init(G *g, void (*setg)(void*), void **tlsg, void **tlsbase)
 {
-	pthread_attr_t attr;
-	sigset_t ign, oset;
-	pthread_t p;
-	size_t size;
-	int err;
-
-	sigfillset(&ign);
-	pthread_sigmask(SIG_SETMASK, &ign, &oset);
-
-	// Not sure why the memset is necessary here,
-	// but without it, we get a bogus stack size
-	// out of pthread_attr_getstacksize. C'est la Linux.
-	memset(&attr, 0, sizeof attr);
-	pthread_attr_init(&attr);
-	size = 0;
-	pthread_attr_getstacksize(&attr, &size);
-	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
-	ts->g->stackhi = size;
-	err = pthread_create(&p, &attr, threadentry, ts);
-
-	pthread_sigmask(SIG_SETMASK, &oset, nil);
-
-	if (err != 0) {
-		fatalf("pthread_create failed: %s", strerror(err));
+	_cgo_linux_init(g, setg);
+	if (x_cgo_inittls) {
+		x_cgo_inittls(tlsg, tlsbase);
 	}
+	_cgo_startup_event("x_cgo_init: inittls");
 }
 
 extern void crosscall1(void (*fn)(void), void (*setg_gcc)(void*), void *g);
-static void*
-threadentry(void *v)
-{
-	ThreadStart ts;
-
-	ts = *(ThreadStart*)v;
-	free(v);
-
-	crosscall1(ts.fn, setg_gcc, (void*)ts.g);
-	return nil;
-}
 
 void
-x_cgo_init(G *g, void (*setg)(void*), void **tlsg, void **tlsbase)
+_cgo_linux_crosscall(void (*fn)(void), void (*setg)(void*), G *g)
 {
-	pthread_attr_t attr;
-	size_t size;
-
-	setg_gcc = setg;
-	pthread_attr_init(&attr);
-	pthread_attr_getstacksize(&attr, &size);
-	g->stacklo = (uintptr)&attr - size + 4096;
-	pthread_attr_destroy(&attr);
-
-	if (x_cgo_inittls) {
-		x_cgo_inittls(tlsg, tlsbase);
-	}
+	crosscall1(fn, setg, (void*)g);
 }
@@ -3,66 +3,23 @@
 // license that can be found in the LICENSE file.
 
 #include <pthread.h>
-#include <string.h>
-#include <signal.h>
 #include "libcgo.h"
 
-static void *threadentry(void*);
-
 void (*x_cgo_inittls)(void **tlsg, void **tlsbase);
-static void (*setg_gcc)(void*);
 
 void
 x_cgo_init(G *g, void (*setg)(void*), void **tlsbase)
 {
-	pthread_attr_t attr;
-	size_t size;
-
-	setg_gcc = setg;
-	pthread_attr_init(&attr);
-	pthread_attr_getstacksize(&attr, &size);
-	g->stacklo = (uintptr)&attr - size + 4096;
-	pthread_attr_destroy(&attr);
-}
-
-void
-_cgo_sys_thread_start(ThreadStart *ts)
-{
-	pthread_attr_t attr;
-	sigset_t ign, oset;
-	pthread_t p;
-	size_t size;
-	int err;
-
-	sigfillset(&ign);
-	pthread_sigmask(SIG_SETMASK, &ign, &oset);
-
-	pthread_attr_init(&attr);
-	pthread_attr_getstacksize(&attr, &size);
-	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
-	ts->g->stackhi = size;
-	err = pthread_create(&p, &attr, threadentry, ts);
-
-	pthread_sigmask(SIG_SETMASK, &oset, nil);
-
-	if (err != 0) {
-		fatalf("pthread_create failed: %s", strerror(err));
-	}
+	_cgo_linux_init(g, setg);
 }
 
 extern void crosscall_s390x(void (*fn)(void), void *g);
 
-static void*
-threadentry(void *v)
+void
+_cgo_linux_crosscall(void (*fn)(void), void (*setg)(void*), G *g)
 {
-	ThreadStart ts;
-
-	ts = *(ThreadStart*)v;
-	free(v);
-
 	// Save g for this thread in C TLS
-	setg_gcc((void*)ts.g);
+	setg((void*)g);
 
-	crosscall_s390x(ts.fn, (void*)ts.g);
-	return nil;
+	crosscall_s390x(fn, (void*)g);
 }
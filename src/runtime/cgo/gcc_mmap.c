@@ -9,7 +9,7 @@
 #include <sys/mman.h>
 
 void *
-x_cgo_mmap(void *addr, uintptr_t length, int32_t prot, int32_t flags, int32_t fd, uint32_t offset) {
+x_cgo_mmap(void *addr, uintptr_t length, int32_t prot, int32_t flags, int32_t fd, uint64_t offset) {
 	void *p;
 
 	p = mmap(addr, length, prot, flags, fd, offset);
@@ -0,0 +1,33 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+#include <stdint.h>
+#include <sys/mman.h>
+
+/* Called via asmcgocall from runtime.munmap and runtime.madvise.  */
+
+void
+x_cgo_munmap(void *v) {
+	struct {
+		void *addr;
+		uintptr_t n;
+		int32_t ret;
+	} *a = v;
+
+	a->ret = munmap(a->addr, a->n);
+}
+
+void
+x_cgo_madvise(void *v) {
+	struct {
+		void *addr;
+		uintptr_t n;
+		int32_t flags;
+	} *a = v;
+
+	/* Ignore failure, as the system call version does.  */
+	madvise(a->addr, a->n, a->flags);
+}
@@ -38,6 +38,9 @@ _cgo_sys_thread_start(ThreadStart *ts)
 	pthread_sigmask(SIG_SETMASK, &ign, &oset);
 
 	pthread_attr_init(&attr);
+	if (ts->stacksize != 0) {
+		pthread_attr_setstacksize(&attr, ts->stacksize);
+	}
 	pthread_attr_getstacksize(&attr, &size);
 
 	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
@@ -59,7 +62,7 @@ threadentry(void *v)
 	stack_t ss;
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
 	/*
 	 * Set specific keys.
@@ -0,0 +1,72 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_netpoll(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * The arguments and result of runtime._cgo_netpoll_internal.
+ * Also known to ../runtime/netpoll.go as cgoNetpoll.
+ */
+typedef struct NetpollArgs NetpollArgs;
+struct NetpollArgs
+{
+	int32_t op;
+	int32_t result;
+};
+
+/*
+ * Values of NetpollArgs.op.
+ */
+enum {
+	NetpollDescriptor,
+	NetpollRun,
+};
+
+static int
+netpoll(int32_t op)
+{
+	struct {
+		NetpollArgs *a;
+	} arg;
+	NetpollArgs a;
+	uintptr_t ctxt;
+
+	ctxt = _cgo_wait_runtime_init_done();
+	a.op = op;
+	a.result = 0;
+	arg.a = &a;
+	crosscall2(_cgo_netpoll, &arg, sizeof arg, ctxt);
+	_cgo_release_context(ctxt);
+	return a.result;
+}
+
+/*
+ * Returns the descriptor of the runtime's network poller, an epoll
+ * descriptor, kqueue or event port, which is readable when network
+ * I/O that goroutines wait for may be ready, or -1 on systems where
+ * the poller has no such descriptor. Once it has returned a
+ * descriptor, the runtime leaves waiting for it to the caller, which
+ * must call GoNetpoll whenever the descriptor is readable.
+ */
+int
+GoNetpollDescriptor(void)
+{
+	return netpoll(NetpollDescriptor);
+}
+
+/*
+ * Makes ready the goroutines whose network I/O is ready, without
+ * blocking, and returns how many there were.
+ */
+int
+GoNetpoll(void)
+{
+	return netpoll(NetpollRun);
+}
@@ -24,6 +24,10 @@ static void (*setg_gcc)(void*);
 // TLS_SIZE is the size of TLS needed for Go.
 #define TLS_SIZE (2 * sizeof(void *))
 
+// TLS_TCB_WORDS is the number of pointer-sized words needed to hold
+// the Go TLS followed by a copy of the TCB or TIB, whichever is larger.
+#define TLS_TCB_WORDS ((TLS_SIZE + TIB_SIZE + sizeof(void *) - 1) / sizeof(void *))
+
 void *__get_tcb(void);
 void __set_tcb(void *);
 
@@ -37,11 +41,16 @@ struct thread_args {
 
 static int has_tib = 0;
 
+// tcb_fixup installs a new TCB for the calling thread in tls, which must
+// hold TLS_TCB_WORDS words and must stay valid until the thread exits.
+// Threads other than the main thread pass space on their own stack,
+// which keeps malloc off the thread start path and keeps the TLS next
+// to the stack that uses it.
 static void
-tcb_fixup(int mainthread)
+tcb_fixup(void **tls)
 {
-	void *tls, *newtcb, *oldtcb;
-	size_t tls_size, tcb_size;
+	void *newtcb, *oldtcb;
+	size_t tcb_size;
 
 	// TODO(jsing): Remove once OpenBSD 6.1 is released and OpenBSD 5.9 is
 	// no longer supported.
@@ -51,16 +60,12 @@ tcb_fixup(int mainthread)
 	// TCB or TIB that has been setup via librthread.
 
 	tcb_size = has_tib ? TIB_SIZE : TCB_SIZE;
-	tls_size = TLS_SIZE + tcb_size;
-	tls = malloc(tls_size);
-	if(tls == NULL)
-		abort();
 
 	// The signal trampoline expects the TLS slots to be zeroed.
 	bzero(tls, TLS_SIZE);
 
 	oldtcb = __get_tcb();
-	newtcb = tls + TLS_SIZE;
+	newtcb = (char *)tls + TLS_SIZE;
 	bcopy(oldtcb, newtcb, tcb_size);
 	if(has_tib) {
 		 // Fix up self pointer.
@@ -69,19 +74,23 @@ tcb_fixup(int mainthread)
 	__set_tcb(newtcb);
 
 	// NOTE(jsing, minux): we can't free oldtcb without causing double-free
-	// problem. so newtcb will be memory leaks. Get rid of this when OpenBSD
-	// has proper support for PT_TLS.
+	// problem. Get rid of this when OpenBSD has proper support for PT_TLS.
 }
 
 static void *
 thread_start_wrapper(void *arg)
 {
 	struct thread_args args = *(struct thread_args *)arg;
+	void *tls[TLS_TCB_WORDS];
 
 	free(arg);
-	tcb_fixup(0);
+	tcb_fixup(tls);
 
-	return args.func(args.arg);
+	// The TCB lives in this frame, so it must not be popped while
+	// the thread is still running: exit from here rather than
+	// returning to librthread.
+	pthread_exit(args.func(args.arg));
+	return NULL;
 }
 
 static void init_pthread_wrapper(void) {
@@ -137,6 +146,7 @@ x_cgo_init(G *g, void (*setg)(void*))
 {
 	pthread_attr_t attr;
 	size_t size;
+	void **tls;
 
 	setg_gcc = setg;
 	pthread_attr_init(&attr);
@@ -149,7 +159,11 @@ x_cgo_init(G *g, void (*setg)(void*))
 		abort();
 	}
 
-	tcb_fixup(1);
+	// The main thread's TCB must outlive this frame.
+	tls = malloc(TLS_TCB_WORDS * sizeof(void *));
+	if(tls == NULL)
+		abort();
+	tcb_fixup(tls);
 }
 
 
@@ -166,6 +180,9 @@ _cgo_sys_thread_start(ThreadStart *ts)
 	pthread_sigmask(SIG_SETMASK, &ign, &oset);
 
 	pthread_attr_init(&attr);
+	if (ts->stacksize != 0) {
+		pthread_attr_setstacksize(&attr, ts->stacksize);
+	}
 	pthread_attr_getstacksize(&attr, &size);
 
 	// Leave stacklo=0 and set stackhi=size; mstack will do the rest.
@@ -184,11 +201,12 @@ static void*
 threadentry(void *v)
 {
 	ThreadStart ts;
+	void *tls[TLS_TCB_WORDS];	// threadentry never returns
 
-	tcb_fixup(0);
+	tcb_fixup(tls);
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
 	/*
 	 * Set specific keys.
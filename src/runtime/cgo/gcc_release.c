@@ -0,0 +1,137 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+// +build linux
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_release(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * The arguments and results of runtime._cgo_release_internal.
+ * Also known to ../runtime/cgorelease_linux.go as cgoRelease.
+ */
+typedef struct ReleaseArgs ReleaseArgs;
+struct ReleaseArgs
+{
+	void (*stop)(void*);
+	int32_t fd;
+	int32_t result;
+	uintptr_t start;
+	uintptr_t size;
+};
+
+/*
+ * Values of ReleaseArgs.result.
+ */
+enum {
+	ReleaseDone,
+	ReleaseBusy,
+	ReleaseTimeout,
+	ReleaseUnsupported,
+};
+
+static void
+release_stop(void *dummy)
+{
+	_cgo_libinit_stop();
+	_cgo_thread_pool_stop();
+	_cgo_callpool_stop();
+}
+
+/*
+ * Releases the Go runtime of a library built with -buildmode=c-shared
+ * or c-archive: stops every goroutine for good, makes the runtime's
+ * threads exit, gives signals back to the handlers installed before
+ * the runtime's, and unmaps the Go heap. Must be called from a thread
+ * not running Go code, once no calls into Go are in progress; any
+ * later call into Go aborts the process. Returns 0 on success, EBUSY
+ * if Go or C code called by Go is still running, in which case the
+ * runtime keeps running, ETIMEDOUT if runtime threads did not exit in
+ * time, in which case the runtime is stopped but nothing is unmapped,
+ * and EINVAL if the program is not a library.
+ */
+int
+GoReleaseRuntime(void)
+{
+	struct {
+		ReleaseArgs *a;
+	} arg;
+	ReleaseArgs a;
+	stack_t ss;
+	uintptr_t ctxt;
+	int p[2], havepipe;
+
+	if (!_cgo_libinit_release_begin()) {
+		return 0;
+	}
+	if (_cgo_callpool_busy()) {
+		return EBUSY;
+	}
+	ctxt = _cgo_wait_runtime_init_done();
+
+	// A pipe with data in it, which the runtime adds to its epoll
+	// set to wake a thread waiting for network I/O.
+	a.fd = -1;
+	havepipe = pipe(p) == 0;
+	if (havepipe && write(p[1], "x", 1) == 1) {
+		a.fd = p[0];
+	}
+	a.stop = release_stop;
+	a.result = ReleaseBusy;
+	a.start = 0;
+	a.size = 0;
+	arg.a = &a;
+	crosscall2(_cgo_release, &arg, sizeof arg, ctxt);
+	_cgo_release_context(ctxt);
+	if (havepipe) {
+		close(p[0]);
+		close(p[1]);
+	}
+
+	switch (a.result) {
+	case ReleaseBusy:
+		return EBUSY;
+	case ReleaseTimeout:
+		return ETIMEDOUT;
+	case ReleaseUnsupported:
+		return EINVAL;
+	}
+
+	if (a.size != 0) {
+		// An M bound to this thread (GODEBUG=cgostickym=1)
+		// leaves its signal stack, in the Go heap, installed.
+		if (sigaltstack(nil, &ss) == 0 && (ss.ss_flags & SS_DISABLE) == 0 &&
+		    (uintptr_t)ss.ss_sp >= a.start && (uintptr_t)ss.ss_sp < a.start + a.size) {
+			ss.ss_flags = SS_DISABLE;
+			sigaltstack(&ss, nil);
+		}
+		munmap((void*)a.start, a.size);
+	}
+	return 0;
+}
+
+/*
+ * Called by the runtime on the g0 stack of an M that exits because
+ * the runtime has been released. Counts the thread out in *exits,
+ * after which it must not touch Go memory, and exits it. The Go frames
+ * have no unwind information, so pthread_exit's unwinding stops at
+ * this function.
+ */
+void
+x_cgo_thread_exit(void *exits)
+{
+	// Nothing joins runtime threads.
+	pthread_detach(pthread_self());
+	__atomic_fetch_add((uint32_t*)exits, 1, __ATOMIC_RELEASE);
+	pthread_exit(nil);
+}
@@ -0,0 +1,120 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+// +build darwin dragonfly freebsd linux netbsd openbsd solaris
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "libcgo.h"
+
+/*
+ * Allocates a ring of n slots of stride bytes for elements of elemsize
+ * bytes, with its sequence numbers set, and the non-blocking pipe that
+ * wakes its consumer, for NewRing in ring.go. Sets *ring to nil if
+ * either fails.
+ */
+void
+_cgo_ring_new(uint32_t elemsize, uint32_t stride, uint32_t n, GoRing **ring, int *rfd)
+{
+	GoRing *r;
+	int p[2];
+	uint32_t i;
+
+	*ring = nil;
+	if (pipe(p) < 0) {
+		return;
+	}
+	r = calloc(1, sizeof *r + (size_t)n * stride);
+	if (r == nil) {
+		close(p[0]);
+		close(p[1]);
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		*(uint64_t*)((char*)(r + 1) + (size_t)i * stride) = i;
+	}
+	for (i = 0; i < 2; i++) {
+		fcntl(p[i], F_SETFL, fcntl(p[i], F_GETFL) | O_NONBLOCK);
+		fcntl(p[i], F_SETFD, FD_CLOEXEC);
+	}
+	r->wakefd = p[1];
+	r->elemsize = elemsize;
+	r->stride = stride;
+	r->mask = n - 1;
+	*rfd = p[0];
+	*ring = r;
+}
+
+/*
+ * Reads the wakeups that producers have written to the pipe.
+ */
+void
+_cgo_ring_drain(int rfd)
+{
+	char buf[64];
+
+	while (read(rfd, buf, sizeof buf) > 0) {
+	}
+}
+
+/*
+ * Frees a ring from _cgo_ring_new and closes its pipe.
+ */
+void
+_cgo_ring_free(GoRing *r, int rfd)
+{
+	close(r->wakefd);
+	close(rfd);
+	free(r);
+}
+
+/*
+ * Copies *elem into the ring and returns 1, or returns 0 if the ring
+ * is full. Never enters Go and never blocks, so it may be called from
+ * any thread, any number of threads at once. If the consumer is parked
+ * on the empty ring, wakes it by writing to its pipe.
+ */
+int
+GoRingPush(GoRing *r, const void *elem)
+{
+	uint64_t pos, seq;
+	char *slot;
+	int64_t dif;
+	ssize_t n;
+	char b;
+
+	pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = (char*)(r + 1) + (pos & r->mask) * r->stride;
+		seq = __atomic_load_n((uint64_t*)slot, __ATOMIC_ACQUIRE);
+		dif = (int64_t)(seq - pos);
+		if (dif == 0) {
+			if (__atomic_compare_exchange_n(&r->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			return 0;
+		} else {
+			pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+		}
+	}
+	memcpy(slot + sizeof(uint64_t), elem, r->elemsize);
+	__atomic_store_n((uint64_t*)slot, pos + 1, __ATOMIC_RELEASE);
+
+	// Pairs with the consumer setting waiting and then looking
+	// at the slot again: one of the two sees the other's store.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&r->waiting, __ATOMIC_RELAXED) != 0 &&
+	    __atomic_exchange_n(&r->waiting, 0, __ATOMIC_ACQ_REL) != 0) {
+		// The pipe is non-blocking. If it is full, the
+		// consumer has wakeups pending anyway.
+		b = 0;
+		n = write(r->wakefd, &b, 1);
+		(void)n;
+	}
+	return 1;
+}
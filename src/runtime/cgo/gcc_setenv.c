@@ -22,3 +22,16 @@ x_cgo_unsetenv(char *arg)
 {
 	unsetenv(arg);
 }
+
+/* Stub for syscall.Setenvs: pairs of key and value, or NULL to unset */
+void
+x_cgo_setenvs(char **arg)
+{
+	for (; arg[0] != NULL; arg += 2) {
+		if (arg[1] != NULL) {
+			setenv(arg[0], arg[1], 1);
+		} else {
+			unsetenv(arg[0]);
+		}
+	}
+}
@@ -15,6 +15,11 @@
 // chance to resolve exceptions before the task handler, so we can generate
 // the panic and avoid lldb's SIGSEGV handler.
 //
+// Faults on different threads must not wait for each other, so a small
+// pool of threads serves the exception ports, all receiving from one
+// port set. Each new thread adds its port to the set without a lock:
+// the kernel serializes changes to the set.
+//
 // The dist tool enables this by build flag when testing.
 
 // +build lldb
@@ -40,9 +45,11 @@
 
 uintptr_t x_cgo_panicmem;
 
-static pthread_mutex_t mach_exception_handler_port_set_mu;
 static mach_port_t mach_exception_handler_port_set = MACH_PORT_NULL;
 
+// The most threads that serve mach_exception_handler_port_set.
+enum { MaxExceptionHandlers = 8 };
+
 kern_return_t
 catch_exception_raise(
 	mach_port_t exception_port,
@@ -143,11 +150,6 @@ darwin_arm_init_thread_exception_port()
 		abort();
 	}
 
-	ret = pthread_mutex_lock(&mach_exception_handler_port_set_mu);
-	if (ret) {
-		fprintf(stderr, "runtime/cgo: pthread_mutex_lock failed: %d\n", ret);
-		abort();
-	}
 	ret = mach_port_move_member(
 		mach_task_self(),
 		port,
@@ -156,11 +158,6 @@ darwin_arm_init_thread_exception_port()
 		fprintf(stderr, "runtime/cgo: mach_port_move_member failed: %d\n", ret);
 		abort();
 	}
-	ret = pthread_mutex_unlock(&mach_exception_handler_port_set_mu);
-	if (ret) {
-		fprintf(stderr, "runtime/cgo: pthread_mutex_unlock failed: %d\n", ret);
-		abort();
-	}
 }
 
 static void*
@@ -175,11 +172,9 @@ mach_exception_handler(void *port)
 void
 darwin_arm_init_mach_exception_handler()
 {
-	pthread_mutex_init(&mach_exception_handler_port_set_mu, NULL);
-
-	// Called once per process to initialize a mach port server, listening
-	// for EXC_BAD_ACCESS thread exceptions.
-	int ret;
+	// Called once per process to initialize the mach port servers,
+	// listening for EXC_BAD_ACCESS thread exceptions.
+	int ret, i, n;
 	pthread_t thr = NULL;
 	pthread_attr_t attr;
 	sigset_t ign, oset;
@@ -197,17 +192,27 @@ darwin_arm_init_mach_exception_handler()
 	sigfillset(&ign);
 	pthread_sigmask(SIG_SETMASK, &ign, &oset);
 
-	// Start a thread to handle exceptions.
+	// Start a thread per CPU, up to MaxExceptionHandlers, to handle
+	// exceptions. The kernel hands each message on the port set to
+	// one of the threads waiting for it.
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n < 1) {
+		n = 1;
+	}
+	if (n > MaxExceptionHandlers) {
+		n = MaxExceptionHandlers;
+	}
 	uintptr_t port_set = (uintptr_t)mach_exception_handler_port_set;
 	pthread_attr_init(&attr);
 	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-	ret = pthread_create(&thr, &attr, mach_exception_handler, (void*)port_set);
+	for (i = 0; i < n; i++) {
+		ret = pthread_create(&thr, &attr, mach_exception_handler, (void*)port_set);
+		if (ret) {
+			fprintf(stderr, "runtime/cgo: pthread_create failed: %d\n", ret);
+			abort();
+		}
+	}
 
 	pthread_sigmask(SIG_SETMASK, &oset, nil);
-
-	if (ret) {
-		fprintf(stderr, "runtime/cgo: pthread_create failed: %d\n", ret);
-		abort();
-	}
 	pthread_attr_destroy(&attr);
 }
@@ -0,0 +1,63 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include <string.h>
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_read_stats(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * Fills *stats, a GoCgoStats as declared in _cgo_export.h, with the
+ * fields of runtime.CgoStats, calling into Go to read them.
+ */
+void
+GoReadCgoStats(void *stats)
+{
+	struct {
+		void *s;
+	} arg;
+	uintptr_t ctxt;
+
+	ctxt = _cgo_wait_runtime_init_done();
+	arg.s = stats;
+	crosscall2(_cgo_read_stats, &arg, sizeof arg, ctxt);
+	_cgo_release_context(ctxt);
+}
+
+/*
+ * The stats page, written by the runtime's sysmon thread.
+ */
+GoStatsPage x_cgo_stats_page __attribute__((aligned(64)));
+
+/*
+ * Copies the counters last published by the runtime into *stats, a
+ * GoStats as declared in _cgo_export.h, without calling into Go.
+ * Returns 1, or 0 if the runtime has not published any yet, in which
+ * case *stats is all zero.
+ */
+int
+GoReadStats(void *stats)
+{
+	GoStatsPage *p;
+	uint64_t seq;
+
+	p = &x_cgo_stats_page;
+	for (;;) {
+		seq = __atomic_load_n(&p->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1) {
+			// Being written, which takes well under
+			// a microsecond.
+			continue;
+		}
+		memcpy(stats, p->stats, sizeof p->stats);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&p->seq, __ATOMIC_RELAXED) == seq) {
+			return seq != 0;
+		}
+	}
+}
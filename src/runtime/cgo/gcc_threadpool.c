@@ -0,0 +1,244 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+// +build linux
+
+#include <pthread.h>
+#include <signal.h>
+#include <string.h> // strerror
+#include "libcgo.h"
+
+// A pool of parked, pre-created threads used by _cgo_sys_thread_start.
+// When the pool is enabled (GODEBUG=cgothreadpool=N), starting a new M
+// hands the ThreadStart to a parked thread and wakes it, instead of
+// calling pthread_create on the critical path. A thread that leaves the
+// pool creates its own replacement before it starts running Go code,
+// so the cost of the clone is paid by the new thread, not by the
+// thread that asked for it.
+
+enum {
+	// Maximum number of parked threads.
+	PoolMax = 64,
+};
+
+typedef struct PoolWork PoolWork;
+struct PoolWork
+{
+	ThreadStart *ts;
+	void* (*fn)(void*);
+	int node;	// NUMA node to move to, or -1
+};
+
+static pthread_mutex_t pool_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+static int pool_target;		// desired number of parked threads
+static size_t pool_stacksize;	// stack size of parked threads
+static int pool_idle;		// threads parked and not yet claimed
+static int pool_starting;	// threads created but not yet parked
+static PoolWork pool_work[PoolMax];	// pending handoffs, a ring
+static int pool_head;
+static int pool_n;
+static int pool_stopped;	// set by _cgo_thread_pool_stop
+
+static void* pool_threadentry(void*);
+
+// pool_spawn creates a single parked thread.
+// It must be called with all signals blocked,
+// so that the new thread starts with all signals blocked too.
+static void
+pool_spawn(void)
+{
+	pthread_attr_t attr;
+	pthread_t p;
+	int err;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, pool_stacksize);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	err = pthread_create(&p, &attr, pool_threadentry, nil);
+	pthread_attr_destroy(&attr);
+	if (err != 0) {
+		pthread_mutex_lock(&pool_mu);
+		pool_starting--;
+		pthread_mutex_unlock(&pool_mu);
+	}
+}
+
+// pool_refill tops the pool back up to its target size.
+// It must be called with all signals blocked.
+static void
+pool_refill(void)
+{
+	int n;
+
+	pthread_mutex_lock(&pool_mu);
+	n = pool_target - pool_idle - pool_starting;
+	if (n < 0) {
+		n = 0;
+	}
+	pool_starting += n;
+	pthread_mutex_unlock(&pool_mu);
+
+	while (n-- > 0) {
+		pool_spawn();
+	}
+}
+
+static void*
+pool_threadentry(void *v)
+{
+	PoolWork w;
+
+	pthread_mutex_lock(&pool_mu);
+	pool_starting--;
+	pool_idle++;
+	while (pool_n == 0 && !pool_stopped) {
+		pthread_cond_wait(&pool_cond, &pool_mu);
+	}
+	if (pool_n == 0) {
+		pool_idle--;
+		pthread_mutex_unlock(&pool_mu);
+		return nil;
+	}
+	w = pool_work[pool_head];
+	pool_head = (pool_head + 1) % PoolMax;
+	pool_n--;
+	pthread_mutex_unlock(&pool_mu);
+
+	// Signals are still blocked here; they were blocked when we
+	// were created, and minit will unblock them once the M is set up.
+	pool_refill();
+
+	if (w.node >= 0) {
+		_cgo_bind_thread_node(w.node);
+	}
+	return w.fn(w.ts);
+}
+
+/*
+ * Called by the runtime (GODEBUG=cgothreadpool=N) to enable the pool.
+ */
+void
+x_cgo_thread_pool_init(void *arg)
+{
+	struct {
+		int32_t n;
+		uintptr stacksize;
+	} *a = arg;
+	pthread_attr_t attr;
+	sigset_t ign, oset;
+	size_t size;
+	int n;
+
+	n = a->n;
+	if (n <= 0) {
+		return;
+	}
+	if (n > PoolMax) {
+		n = PoolMax;
+	}
+
+	// Record the stack size the parked threads really get,
+	// so that _cgo_thread_pool_start only hands them work
+	// that expects that size.
+	pthread_attr_init(&attr);
+	if (a->stacksize != 0) {
+		pthread_attr_setstacksize(&attr, a->stacksize);
+	}
+	size = 0;
+	pthread_attr_getstacksize(&attr, &size);
+	pthread_attr_destroy(&attr);
+	if (size == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool_mu);
+	pool_stacksize = size;
+	pool_target = n;
+	pthread_mutex_unlock(&pool_mu);
+
+	sigfillset(&ign);
+	pthread_sigmask(SIG_SETMASK, &ign, &oset);
+	pool_refill();
+	pthread_sigmask(SIG_SETMASK, &oset, nil);
+}
+
+int
+_cgo_thread_pool_start(ThreadStart *ts, void* (*fn)(void*))
+{
+	PoolWork *w;
+	int node, ok;
+
+	// The parked threads were created before we knew where they
+	// should run, so they move themselves once claimed. We are
+	// running on the creating thread, so look up its node here.
+	node = -1;
+	if (ts->flags & ThreadStartNodeAffinity) {
+		node = _cgo_thread_node();
+	}
+
+	ok = 0;
+	pthread_mutex_lock(&pool_mu);
+	if (pool_idle > 0 && ts->g->stackhi == pool_stacksize) {
+		w = &pool_work[(pool_head + pool_n) % PoolMax];
+		w->ts = ts;
+		w->fn = fn;
+		w->node = node;
+		pool_n++;
+		pool_idle--;
+		pthread_cond_signal(&pool_cond);
+		ok = 1;
+	}
+	pthread_mutex_unlock(&pool_mu);
+	return ok;
+}
+
+/*
+ * Called when the runtime is released, with the world stopped for good:
+ * parked threads exit, and no more are created.
+ */
+void
+_cgo_thread_pool_stop(void)
+{
+	pthread_mutex_lock(&pool_mu);
+	pool_stopped = 1;
+	pool_target = 0;
+	pthread_cond_broadcast(&pool_cond);
+	pthread_mutex_unlock(&pool_mu);
+}
+
+/*
+ * Called by GoForkRuntime around fork. The child has none of the
+ * parked threads, so it parks new ones.
+ */
+void
+_cgo_thread_pool_fork(int phase)
+{
+	sigset_t ign, oset;
+
+	switch (phase) {
+	case ForkPrepare:
+		pthread_mutex_lock(&pool_mu);
+		break;
+	case ForkParent:
+		pthread_mutex_unlock(&pool_mu);
+		break;
+	case ForkChild:
+		// Work handed to the pool but not yet taken is for Ms,
+		// such as sysmon's, that the runtime drops in the child.
+		pool_n = 0;
+		pool_idle = 0;
+		pool_starting = 0;
+		pthread_mutex_init(&pool_mu, nil);
+		pthread_cond_init(&pool_cond, nil);
+		if (pool_target > 0) {
+			sigfillset(&ign);
+			pthread_sigmask(SIG_SETMASK, &ign, &oset);
+			pool_refill();
+			pthread_sigmask(SIG_SETMASK, &oset, nil);
+		}
+		break;
+	}
+}
@@ -0,0 +1,154 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#include "libcgo.h"
+
+// A pool of parked, pre-created threads used by _cgo_sys_thread_start,
+// as in gcc_threadpool.c. When the pool is enabled
+// (GODEBUG=cgothreadpool=N), starting a new M hands the ThreadStart
+// to a parked thread and releases the semaphore it waits on, instead
+// of calling _beginthreadex on the critical path. A thread that leaves
+// the pool creates its own replacement before it starts running Go
+// code. All threads, parked or not, reserve the same stack size.
+
+enum {
+	// Maximum number of parked threads.
+	PoolMax = 64,
+};
+
+typedef struct PoolWork PoolWork;
+struct PoolWork
+{
+	ThreadStart *ts;
+	unsigned (__stdcall *fn)(void*);
+};
+
+static CRITICAL_SECTION pool_mu;
+static HANDLE pool_sem;		// counts pending handoffs
+static int pool_target;		// desired number of parked threads
+static uintptr_t pool_stacksize;	// stack reserve of parked threads
+static int pool_idle;		// threads parked and not yet claimed
+static int pool_starting;	// threads created but not yet parked
+static PoolWork pool_work[PoolMax];	// pending handoffs, a ring
+static int pool_head;
+static int pool_n;
+
+static unsigned __stdcall pool_threadentry(void*);
+
+// pool_spawn creates a single parked thread.
+static void
+pool_spawn(void)
+{
+	uintptr_t thandle;
+
+	thandle = _beginthreadex(NULL, pool_stacksize, pool_threadentry, NULL, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+	if (thandle == 0) {
+		EnterCriticalSection(&pool_mu);
+		pool_starting--;
+		LeaveCriticalSection(&pool_mu);
+		return;
+	}
+	CloseHandle((HANDLE)thandle);
+}
+
+// pool_refill tops the pool back up to its target size.
+static void
+pool_refill(void)
+{
+	int n;
+
+	EnterCriticalSection(&pool_mu);
+	n = pool_target - pool_idle - pool_starting;
+	if (n < 0) {
+		n = 0;
+	}
+	pool_starting += n;
+	LeaveCriticalSection(&pool_mu);
+
+	while (n-- > 0) {
+		pool_spawn();
+	}
+}
+
+static unsigned __stdcall
+pool_threadentry(void *v)
+{
+	PoolWork w;
+
+	EnterCriticalSection(&pool_mu);
+	pool_starting--;
+	pool_idle++;
+	LeaveCriticalSection(&pool_mu);
+
+	// Each release of the semaphore matches one queued handoff,
+	// so there is work to take once the wait returns.
+	WaitForSingleObject(pool_sem, INFINITE);
+	EnterCriticalSection(&pool_mu);
+	w = pool_work[pool_head];
+	pool_head = (pool_head + 1) % PoolMax;
+	pool_n--;
+	LeaveCriticalSection(&pool_mu);
+
+	pool_refill();
+	return w.fn(w.ts);
+}
+
+/*
+ * Called by the runtime (GODEBUG=cgothreadpool=N) to enable the pool,
+ * before any M but m0 exists.
+ */
+void
+x_cgo_thread_pool_init(void *arg)
+{
+	struct {
+		int32_t n;
+		uintptr stacksize;
+	} *a = arg;
+	int n;
+
+	n = a->n;
+	if (n <= 0) {
+		return;
+	}
+	if (n > PoolMax) {
+		n = PoolMax;
+	}
+	pool_sem = CreateSemaphore(NULL, 0, PoolMax, NULL);
+	if (pool_sem == NULL) {
+		return;
+	}
+	InitializeCriticalSection(&pool_mu);
+	pool_stacksize = _cgo_thread_stacksize(a->stacksize);
+	pool_target = n;
+	pool_refill();
+}
+
+int
+_cgo_thread_pool_start(ThreadStart *ts, unsigned (__stdcall *fn)(void*))
+{
+	PoolWork *w;
+	int ok;
+
+	if (pool_target == 0) {
+		return 0;
+	}
+	ok = 0;
+	EnterCriticalSection(&pool_mu);
+	if (pool_idle > 0 && ts->g->stackhi == pool_stacksize) {
+		w = &pool_work[(pool_head + pool_n) % PoolMax];
+		w->ts = ts;
+		w->fn = fn;
+		pool_n++;
+		pool_idle--;
+		ReleaseSemaphore(pool_sem, 1, NULL);
+		ok = 1;
+	}
+	LeaveCriticalSection(&pool_mu);
+	return ok;
+}
@@ -0,0 +1,27 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include "libcgo.h"
+
+/*
+ * The function set by GoSetThreadReset, or nil. The runtime loads it
+ * through _cgo_thread_reset when a goroutine exits while locked to
+ * its thread; see goexit0 in ../proc.go.
+ */
+void (*x_cgo_thread_reset)(void);
+
+/*
+ * Sets fn as the function that resets the C state of a thread when a
+ * goroutine that locked the thread with runtime.LockOSThread exits
+ * without unlocking it. fn runs on that thread before the thread runs
+ * any other goroutine. It must return quickly and must not call into
+ * Go. A nil fn removes the function.
+ */
+void
+GoSetThreadReset(void (*fn)(void))
+{
+	__atomic_store_n(&x_cgo_thread_reset, fn, __ATOMIC_RELEASE);
+}
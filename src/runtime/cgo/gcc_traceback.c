@@ -5,7 +5,10 @@
 // +build cgo
 // +build linux
 
+#define _GNU_SOURCE
 #include <stdint.h>
+#include <ucontext.h>
+#include "libcgo.h"
 
 struct cgoTracebackArg {
 	uintptr_t  Context;
@@ -13,6 +16,73 @@ struct cgoTracebackArg {
 	uintptr_t  Max;
 };
 
+// Number of PCs that fit in the cgoCallers buffer of an M.
+// Set by the runtime at startup, see setCgoTracebackDepth.
+uintptr_t x_cgo_callers_max = 32;
+
+// Follow the frame pointer chain starting at fp, storing return
+// addresses in buf[n:max]. The runtime stores the bounds of the
+// thread's stack in buf[max] and buf[max+1], or zeros if it does not
+// know them. Every frame must lie between sp and the top of that
+// stack, so a bad frame pointer, as in code compiled without frame
+// pointers, ends the traceback instead of faulting.
+// Returns the new value of n.
+static uintptr_t
+fpunwind(uintptr_t fp, uintptr_t sp, uintptr_t* buf, uintptr_t n, uintptr_t max)
+{
+	uintptr_t lo, hi, ret;
+
+	lo = buf[max];
+	hi = buf[max+1];
+	if (hi == 0 || sp < lo || sp >= hi) {
+		return n;
+	}
+	while (n < max && fp >= sp && fp <= hi - 2*sizeof(uintptr_t) && (fp & (sizeof(uintptr_t)-1)) == 0) {
+		ret = ((uintptr_t*)fp)[1];
+		if (ret == 0) {
+			break;
+		}
+		buf[n++] = ret;
+		sp = fp + 2*sizeof(uintptr_t);
+		fp = ((uintptr_t*)fp)[0];
+	}
+	return n;
+}
+
+// The built-in traceback function, installed by GODEBUG=cgofpunwind=1.
+// x_cgo_callers recognizes it and unwinds from the signal context
+// instead of calling it. Called any other way, as for a context,
+// it returns no PCs.
+void
+x_cgo_fp_traceback(struct cgoTracebackArg* arg)
+{
+	if (arg->Max > 0) {
+		arg->Buf[0] = 0;
+	}
+}
+
+// Unwind the C code interrupted by a signal, using the registers
+// saved in the signal context.
+static void
+fpunwindsig(void *context, uintptr_t* buf, uintptr_t max)
+{
+	uintptr_t n;
+
+	n = 0;
+#if defined(__x86_64__)
+	mcontext_t *mc;
+
+	mc = &((ucontext_t*)context)->uc_mcontext;
+	if (max > 0) {
+		buf[n++] = (uintptr_t)mc->gregs[REG_RIP];
+		n = fpunwind((uintptr_t)mc->gregs[REG_RBP], (uintptr_t)mc->gregs[REG_RSP], buf, n, max);
+	}
+#endif
+	if (n < max) {
+		buf[n] = 0;
+	}
+}
+
 // Call the user's traceback function and then call sigtramp.
 // The runtime signal handler will jump to this code.
 // We do it this way so that the user's traceback function will be called
@@ -21,9 +91,18 @@ void
 x_cgo_callers(uintptr_t sig, void *info, void *context, void (*cgoTraceback)(struct cgoTracebackArg*), uintptr_t* cgoCallers, void (*sigtramp)(uintptr_t, void*, void*)) {
 	struct cgoTracebackArg arg;
 
+	_cgo_probe1(traceback__start, sig);
+	if (cgoTraceback == x_cgo_fp_traceback) {
+		fpunwindsig(context, cgoCallers, x_cgo_callers_max);
+		_cgo_probe1(traceback__done, cgoCallers);
+		sigtramp(sig, info, context);
+		return;
+	}
+
 	arg.Context = 0;
 	arg.Buf = cgoCallers;
-	arg.Max = 32; // must match len(runtime.cgoCallers)
+	arg.Max = x_cgo_callers_max; // len(runtime.m.cgoCallers)
 	(*cgoTraceback)(&arg);
+	_cgo_probe1(traceback__done, cgoCallers);
 	sigtramp(sig, info, context);
 }
@@ -0,0 +1,80 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include "libcgo.h"
+
+extern void crosscall2(void (*fn)(void *, int, uintptr), void *, int, uintptr);
+extern void _cgo_trampoline(void *, int, uintptr);
+extern void _cgo_release_context(uintptr_t);
+
+/*
+ * A call of a callback.
+ * Also known to ../runtime/cgocallback.go as cgoTrampolineCall.
+ */
+typedef struct TrampolineCall TrampolineCall;
+struct TrampolineCall
+{
+	uintptr_t index;
+	uintptr_t args[6];
+	uintptr_t ret;
+};
+
+static uintptr_t
+trampoline(uintptr_t index, uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4, uintptr_t a5)
+{
+	TrampolineCall c;
+	struct {
+		TrampolineCall *c;
+	} a;
+	uintptr_t ctxt;
+
+	c.index = index;
+	c.args[0] = a0;
+	c.args[1] = a1;
+	c.args[2] = a2;
+	c.args[3] = a3;
+	c.args[4] = a4;
+	c.args[5] = a5;
+	c.ret = 0;
+	a.c = &c;
+	ctxt = _cgo_wait_runtime_init_done();
+	crosscall2(_cgo_trampoline, &a, sizeof a, ctxt);
+	_cgo_release_context(ctxt);
+	return c.ret;
+}
+
+/*
+ * The trampolines are named by their index written as four base 4
+ * digits after a 0, which C reads as an octal literal. B4 turns that
+ * literal back into the index.
+ */
+#define B4(x) (((x)&7) | ((x)>>3&7)<<2 | ((x)>>6&7)<<4 | ((x)>>9&7)<<6)
+
+#define T1(i) \
+	static uintptr_t trampoline##i(uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4, uintptr_t a5) \
+	{ return trampoline(B4(i), a0, a1, a2, a3, a4, a5); }
+#define T4(i) T1(i##0) T1(i##1) T1(i##2) T1(i##3)
+#define T16(i) T4(i##0) T4(i##1) T4(i##2) T4(i##3)
+#define T64(i) T16(i##0) T16(i##1) T16(i##2) T16(i##3)
+#define T256(i) T64(i##0) T64(i##1) T64(i##2) T64(i##3)
+
+T256(0)
+
+#define P1(i) trampoline##i,
+#define P4(i) P1(i##0) P1(i##1) P1(i##2) P1(i##3)
+#define P16(i) P4(i##0) P4(i##1) P4(i##2) P4(i##3)
+#define P64(i) P16(i##0) P16(i##1) P16(i##2) P16(i##3)
+#define P256(i) P64(i##0) P64(i##1) P64(i##2) P64(i##3)
+
+/*
+ * The C functions handed out by NewCallback in trampoline.go. Each
+ * calls the Go function in the same slot of the runtime's table,
+ * passing its index, so a call looks up nothing else.
+ * Keep the count in sync with MaxCallbacks.
+ */
+void *x_cgo_trampolines[256] = {
+	P256(0)
+};
@@ -0,0 +1,315 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build cgo
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include "libcgo.h"
+
+/*
+ * io_uring, declared here rather than taken from <linux/io_uring.h>,
+ * which systems older than Linux 5.1 do not have. The system calls
+ * have the same numbers on every architecture.
+ */
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+enum {
+	IoUringOpReadv = 1,
+	IoUringOpWritev = 2,
+
+	IoUringEnterGetEvents = 1<<0,
+
+	// The kernel takes an offset of -1 to mean the file's
+	// current offset (Linux 5.6).
+	IoUringFeatRWCurPos = 1<<3,
+
+	IoUringOffSqRing = 0,
+	IoUringOffCqRing = 0x8000000,
+	IoUringOffSqes = 0x10000000,
+
+	// The most entries in a ring; larger batches go in parts.
+	IoUringMaxEntries = 1024,
+};
+
+typedef struct IoUringParams IoUringParams;
+struct IoUringParams
+{
+	uint32_t sq_entries;
+	uint32_t cq_entries;
+	uint32_t flags;
+	uint32_t sq_thread_cpu;
+	uint32_t sq_thread_idle;
+	uint32_t features;
+	uint32_t resv[4];
+	struct {
+		uint32_t head, tail, ring_mask, ring_entries, flags, dropped, array, resv1;
+		uint64_t resv2;
+	} sq_off;
+	struct {
+		uint32_t head, tail, ring_mask, ring_entries, overflow, cqes, flags, resv1;
+		uint64_t resv2;
+	} cq_off;
+};
+
+typedef struct IoUringSqe IoUringSqe;
+struct IoUringSqe
+{
+	uint8_t opcode;
+	uint8_t flags;
+	uint16_t ioprio;
+	int32_t fd;
+	uint64_t off;
+	uint64_t addr;
+	uint32_t len;
+	uint32_t rw_flags;
+	uint64_t user_data;
+	uint64_t pad[3];
+};
+
+typedef struct IoUringCqe IoUringCqe;
+struct IoUringCqe
+{
+	uint64_t user_data;
+	int32_t res;
+	uint32_t flags;
+};
+
+/*
+ * One read or write of a batch.
+ * Also known to uring_linux.go as ioDesc.
+ */
+typedef struct IODesc IODesc;
+struct IODesc
+{
+	int32_t fd;
+	int32_t write;
+	uint64_t addr;
+	uint64_t len;
+	int64_t off;
+	int64_t res;	// bytes read or written, or -errno
+};
+
+/*
+ * A ring, and the descriptors and iovecs of the batch being
+ * submitted. fd is -1 if the kernel has no io_uring, in which case
+ * the batch is done with one system call per operation.
+ */
+typedef struct URing URing;
+struct URing
+{
+	int fd;
+	uint32_t entries;
+	uint32_t features;
+	void *sq;
+	size_t sqsize;
+	void *cq;
+	size_t cqsize;
+	IoUringSqe *sqes;
+	size_t sqessize;
+	uint32_t *sqtail;
+	uint32_t sqmask;
+	uint32_t *sqarray;
+	uint32_t *cqhead;
+	uint32_t *cqtail;
+	uint32_t cqmask;
+	IoUringCqe *cqes;
+	IODesc *desc;
+	struct iovec *iov;
+};
+
+static void
+uring_unmap(URing *r)
+{
+	if (r->sq != nil && r->sq != MAP_FAILED) {
+		munmap(r->sq, r->sqsize);
+	}
+	if (r->cq != nil && r->cq != MAP_FAILED) {
+		munmap(r->cq, r->cqsize);
+	}
+	if (r->sqes != nil && (void*)r->sqes != MAP_FAILED) {
+		munmap(r->sqes, r->sqessize);
+	}
+	close(r->fd);
+	r->fd = -1;
+}
+
+/*
+ * Sets up the io_uring of r, with at least n entries, leaving r->fd
+ * -1 if that fails.
+ */
+static void
+uring_setup(URing *r, uint32_t n)
+{
+	IoUringParams p;
+	char *sq, *cq;
+
+	memset(&p, 0, sizeof p);
+	r->fd = syscall(__NR_io_uring_setup, n, &p);
+	if (r->fd < 0) {
+		r->fd = -1;
+		return;
+	}
+	r->features = p.features;
+	r->sqsize = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+	r->cqsize = p.cq_off.cqes + p.cq_entries * sizeof(IoUringCqe);
+	r->sqessize = p.sq_entries * sizeof(IoUringSqe);
+	r->sq = mmap(nil, r->sqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IoUringOffSqRing);
+	r->cq = mmap(nil, r->cqsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IoUringOffCqRing);
+	r->sqes = mmap(nil, r->sqessize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IoUringOffSqes);
+	if (r->sq == MAP_FAILED || r->cq == MAP_FAILED || (void*)r->sqes == MAP_FAILED) {
+		uring_unmap(r);
+		return;
+	}
+	sq = r->sq;
+	cq = r->cq;
+	r->sqtail = (uint32_t*)(sq + p.sq_off.tail);
+	r->sqmask = *(uint32_t*)(sq + p.sq_off.ring_mask);
+	r->sqarray = (uint32_t*)(sq + p.sq_off.array);
+	r->cqhead = (uint32_t*)(cq + p.cq_off.head);
+	r->cqtail = (uint32_t*)(cq + p.cq_off.tail);
+	r->cqmask = *(uint32_t*)(cq + p.cq_off.ring_mask);
+	r->cqes = (IoUringCqe*)(cq + p.cq_off.cqes);
+}
+
+/*
+ * Allocates a ring for batches of up to *n operations, for NewIOBatch
+ * in uring_linux.go, and sets *desc to the array of *n descriptors in
+ * which the batches are passed. *n is lowered to IoUringMaxEntries if
+ * it is larger. Sets *ring to nil if the allocation fails.
+ */
+void
+_cgo_uring_new(uint32_t *n, void **ring, IODesc **desc)
+{
+	URing *r;
+
+	*ring = nil;
+	if (*n > IoUringMaxEntries) {
+		*n = IoUringMaxEntries;
+	}
+	r = calloc(1, sizeof *r + *n * (sizeof(IODesc) + sizeof(struct iovec)));
+	if (r == nil) {
+		return;
+	}
+	r->entries = *n;
+	r->desc = (IODesc*)(r + 1);
+	r->iov = (struct iovec*)(r->desc + *n);
+	uring_setup(r, *n);
+	*desc = r->desc;
+	*ring = r;
+}
+
+/*
+ * Does d with one system call.
+ */
+static void
+iosync(IODesc *d)
+{
+	void *p;
+	ssize_t res;
+
+	p = (void*)(uintptr_t)d->addr;
+	do {
+		if (d->write) {
+			res = d->off < 0 ? write(d->fd, p, d->len) : pwrite(d->fd, p, d->len, d->off);
+		} else {
+			res = d->off < 0 ? read(d->fd, p, d->len) : pread(d->fd, p, d->len, d->off);
+		}
+	} while (res < 0 && errno == EINTR);
+	d->res = res < 0 ? -errno : res;
+}
+
+/*
+ * Does the first n descriptors of r, setting their res fields, and
+ * returns once all of them are done. The io_uring is entered once for
+ * the whole batch, or more if a call is interrupted. Operations at the
+ * current offset are done synchronously on kernels whose io_uring
+ * does not support them.
+ */
+void
+_cgo_uring_submit(URing *r, uint32_t n)
+{
+	IODesc *d;
+	IoUringSqe *sqe;
+	IoUringCqe *cqe;
+	uint32_t i, tail, head, queued, submitted, done;
+	int ret;
+
+	if (r->fd < 0) {
+		for (i = 0; i < n; i++) {
+			iosync(&r->desc[i]);
+		}
+		return;
+	}
+
+	tail = *r->sqtail;
+	queued = 0;
+	for (i = 0; i < n; i++) {
+		d = &r->desc[i];
+		if (d->off < 0 && (r->features & IoUringFeatRWCurPos) == 0) {
+			iosync(d);
+			continue;
+		}
+		r->iov[i].iov_base = (void*)(uintptr_t)d->addr;
+		r->iov[i].iov_len = d->len;
+		sqe = &r->sqes[tail & r->sqmask];
+		memset(sqe, 0, sizeof *sqe);
+		sqe->opcode = d->write ? IoUringOpWritev : IoUringOpReadv;
+		sqe->fd = d->fd;
+		sqe->off = d->off;
+		sqe->addr = (uint64_t)(uintptr_t)&r->iov[i];
+		sqe->len = 1;
+		sqe->user_data = i;
+		r->sqarray[tail & r->sqmask] = tail & r->sqmask;
+		tail++;
+		queued++;
+	}
+	if (queued == 0) {
+		return;
+	}
+	__atomic_store_n(r->sqtail, tail, __ATOMIC_RELEASE);
+
+	submitted = 0;
+	done = 0;
+	while (done < queued) {
+		ret = syscall(__NR_io_uring_enter, r->fd, queued - submitted, queued - done, IoUringEnterGetEvents, nil, 0);
+		if (ret < 0) {
+			if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+				fprintf(stderr, "runtime/cgo: io_uring_enter failed: %s\n", strerror(errno));
+				abort();
+			}
+		} else {
+			submitted += ret;
+		}
+		head = *r->cqhead;
+		while (head != __atomic_load_n(r->cqtail, __ATOMIC_ACQUIRE)) {
+			cqe = &r->cqes[head & r->cqmask];
+			r->desc[cqe->user_data].res = cqe->res;
+			head++;
+			done++;
+		}
+		__atomic_store_n(r->cqhead, head, __ATOMIC_RELEASE);
+	}
+}
+
+/*
+ * Frees a ring from _cgo_uring_new.
+ */
+void
+_cgo_uring_free(URing *r)
+{
+	if (r->fd >= 0) {
+		uring_unmap(r);
+	}
+	free(r);
+}
@@ -4,6 +4,65 @@
 
 #include "libcgo.h"
 
+/*
+ * The C allocator used by C.malloc, C.CString and C.CBytes, as set by
+ * GoSetCAllocator. alloc_state is AllocUnset until the first call to
+ * either. GoSetCAllocator moves it through AllocSetting to AllocSet;
+ * the first allocation without a registered allocator moves it to
+ * AllocLibc, after which the allocator can no longer change.
+ */
+enum {
+	AllocUnset,
+	AllocSetting,
+	AllocSet,
+	AllocLibc,
+};
+
+static volatile uint32 alloc_state;
+static void *(*alloc_malloc)(size_t);
+static void (*alloc_free)(void*);
+
+/*
+ * Makes C.malloc, C.CString and C.CBytes allocate with mallocfn
+ * instead of the C library's malloc, for example to use an allocator
+ * with per-thread caches. Memory they return must then be released
+ * with freefn. Returns 1 on success, and 0 if an allocator has already
+ * been registered or C memory has already been allocated from Go.
+ */
+int
+GoSetCAllocator(void *(*mallocfn)(size_t), void (*freefn)(void*))
+{
+	if(mallocfn == nil || freefn == nil)
+		return 0;
+	if(!__sync_bool_compare_and_swap(&alloc_state, AllocUnset, AllocSetting))
+		return 0;
+	alloc_malloc = mallocfn;
+	alloc_free = freefn;
+	__sync_synchronize();
+	alloc_state = AllocSet;
+	return 1;
+}
+
+/* Returns whether a registered allocator is in use, fixing the choice. */
+static int
+alloc_registered(void)
+{
+	uint32 s;
+
+	for(;;) {
+		s = alloc_state;
+		if(s == AllocSet) {
+			__sync_synchronize();
+			return 1;
+		}
+		if(s == AllocLibc)
+			return 0;
+		if(s == AllocUnset && __sync_bool_compare_and_swap(&alloc_state, AllocUnset, AllocLibc))
+			return 0;
+		/* GoSetCAllocator is storing the functions; wait for it. */
+	}
+}
+
 /* Stub for calling malloc from Go */
 void
 x_cgo_malloc(void *p)
@@ -12,10 +71,15 @@ x_cgo_malloc(void *p)
 		long long n;
 		void *ret;
 	} *a = p;
+	void *(*fn)(size_t);
 
-	a->ret = malloc(a->n);
+	fn = malloc;
+	if(alloc_registered())
+		fn = alloc_malloc;
+	a->ret = fn(a->n);
 	if(a->ret == NULL && a->n == 0)
-		a->ret = malloc(1);
+		a->ret = fn(1);
+	_cgo_probe2(malloc, a->n, a->ret);
 }
 
 /* Stub for calling free from Go */
@@ -26,21 +90,94 @@ x_cgo_free(void *p)
 		void *arg;
 	} *a = p;
 
-	free(a->arg);
+	_cgo_probe1(free, a->arg);
+	if(alloc_registered())
+		alloc_free(a->arg);
+	else
+		free(a->arg);
 }
 
-/* Stub for creating a new thread */
+/*
+ * Frees n pointers at once, for runtime/cgo's FreeList.
+ * Called like this:
+ *   struct { void **ptrs; uintptr n; } a;
+ *   x_cgo_free_n(&a);
+ */
 void
-x_cgo_thread_start(ThreadStart *arg)
+x_cgo_free_n(void *p)
+{
+	struct a {
+		void **ptrs;
+		uintptr n;
+	} *a = p;
+	void (*fn)(void*);
+	uintptr i;
+
+	_cgo_probe2(free__n, a->ptrs, a->n);
+	fn = free;
+	if(alloc_registered())
+		fn = alloc_free;
+	for(i = 0; i < a->n; i++)
+		fn(a->ptrs[i]);
+}
+
+/*
+ * ThreadStart records handed from x_cgo_thread_start to the new thread.
+ * They come from a fixed slab so that starting an M does not take the
+ * C allocator's locks. A slot is claimed with a compare-and-swap on its
+ * busy flag, so there is no free list and no ABA problem. If every slot
+ * is in flight, which takes a very large burst of thread starts, we fall
+ * back to malloc.
+ */
+enum {
+	ThreadStartSlab = 64,
+};
+
+static ThreadStart ts_slab[ThreadStartSlab];
+static volatile uint32 ts_busy[ThreadStartSlab];
+static volatile uint32 ts_next;
+
+/* Returns a ThreadStart record to be released by _cgo_thread_start_free. */
+ThreadStart*
+_cgo_thread_start_alloc(void)
 {
+	uint32 i, n;
 	ThreadStart *ts;
 
-	/* Make our own copy that can persist after we return. */
+	n = __sync_fetch_and_add(&ts_next, 1);
+	for(i = 0; i < ThreadStartSlab; i++) {
+		n %= ThreadStartSlab;
+		if(ts_busy[n] == 0 && __sync_bool_compare_and_swap(&ts_busy[n], 0, 1))
+			return &ts_slab[n];
+		n++;
+	}
 	ts = malloc(sizeof *ts);
 	if(ts == nil) {
 		fprintf(stderr, "runtime/cgo: out of memory in thread_start\n");
 		abort();
 	}
+	return ts;
+}
+
+/* Releases a ThreadStart received by a new thread's entry function. */
+void
+_cgo_thread_start_free(ThreadStart *ts)
+{
+	if(ts >= &ts_slab[0] && ts < &ts_slab[ThreadStartSlab]) {
+		__sync_lock_release(&ts_busy[ts - &ts_slab[0]]);
+		return;
+	}
+	free(ts);
+}
+
+/* Stub for creating a new thread */
+void
+x_cgo_thread_start(ThreadStart *arg)
+{
+	ThreadStart *ts;
+
+	/* Make our own copy that can persist after we return. */
+	ts = _cgo_thread_start_alloc();
 	*ts = *arg;
 
 	_cgo_sys_thread_start(ts);	/* OS-dependent half */
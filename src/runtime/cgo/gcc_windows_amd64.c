@@ -9,7 +9,7 @@
 #include <stdio.h>
 #include "libcgo.h"
 
-static void threadentry(void*);
+static unsigned __stdcall threadentry(void*);
 
 /* 2MB is default stack size for 64-bit Windows.
    Allocation granularity on Windows is typically 64 KB.
@@ -24,28 +24,44 @@ x_cgo_init(G *g)
 }
 
 
+uintptr_t
+_cgo_thread_stacksize(uintptr_t size)
+{
+	if(size == 0)
+		return STACKSIZE;
+	// Round up to the allocation granularity.
+	return (size + 0xffff) & ~(uintptr_t)0xffff;
+}
+
 void
 _cgo_sys_thread_start(ThreadStart *ts)
 {
 	uintptr_t thandle;
 
-	thandle = _beginthread(threadentry, 0, ts);
-	if(thandle == -1) {
+	// Pass the stack reserve to threadentry in stackhi.
+	ts->g->stackhi = _cgo_thread_stacksize(ts->stacksize);
+	if(_cgo_thread_pool_start(ts, threadentry))
+		return;
+	thandle = _beginthreadex(NULL, ts->g->stackhi, threadentry, ts, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+	if(thandle == 0) {
 		fprintf(stderr, "runtime: failed to create new OS thread (%d)\n", errno);
 		abort();
 	}
+	CloseHandle((HANDLE)thandle);
 }
 
-static void
+static unsigned __stdcall
 threadentry(void *v)
 {
 	ThreadStart ts;
+	uintptr size;
 
 	ts = *(ThreadStart*)v;
-	free(v);
+	_cgo_thread_start_free(v);
 
+	size = ts.g->stackhi;
 	ts.g->stackhi = (uintptr)&ts;
-	ts.g->stacklo = (uintptr)&ts - STACKSIZE + 8*1024;
+	ts.g->stacklo = (uintptr)&ts - size + 8*1024;
 
 	/*
 	 * Set specific keys in thread local storage.
@@ -58,4 +74,5 @@ threadentry(void *v)
 	);
 
 	crosscall_amd64(ts.fn);
+	return 0;
 }
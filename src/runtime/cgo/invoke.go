@@ -0,0 +1,44 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+import "unsafe"
+
+// Runs a batch of calls to exported Go functions, for GoInvokeVector
+// in gcc_invoke.c. Called like this:
+//   struct { GoCall *calls; intptr_t n; } a;
+//   crosscall2(_cgo_invoke_vector, &a, sizeof a, ctxt);
+
+//go:cgo_export_dynamic GoInvokeVector
+
+//go:linkname _runtime_cgo_invoke_vector_internal runtime._cgo_invoke_vector_internal
+var _runtime_cgo_invoke_vector_internal byte
+
+//go:linkname _cgo_invoke_vector _cgo_invoke_vector
+//go:cgo_export_static _cgo_invoke_vector
+//go:cgo_export_dynamic _cgo_invoke_vector
+//go:nosplit
+//go:norace
+func _cgo_invoke_vector(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_invoke_vector_internal), a, uintptr(n), ctxt)
+}
+
+// Starts the goroutine that runs calls queued by GoInvokeAsync
+// in gcc_invoke.c. Called once, like this:
+//   crosscall2(_cgo_async_start, &dummy, 0, ctxt);
+
+//go:cgo_export_dynamic GoInvokeAsync
+
+//go:linkname _runtime_cgo_async_start_internal runtime._cgo_async_start_internal
+var _runtime_cgo_async_start_internal byte
+
+//go:linkname _cgo_async_start _cgo_async_start
+//go:cgo_export_static _cgo_async_start
+//go:cgo_export_dynamic _cgo_async_start
+//go:nosplit
+//go:norace
+func _cgo_async_start(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_async_start_internal), a, uintptr(n), ctxt)
+}
@@ -35,6 +35,16 @@ struct ThreadStart
 	G *g;
 	uintptr *tls;
 	void (*fn)(void);
+	uintptr stacksize;	// requested g0 stack size; 0 means system default
+	uintptr flags;	// ThreadStart* flags below
+};
+
+/*
+ * ThreadStart flags. Also known to ../runtime/proc.go.
+ */
+enum {
+	// Run the new thread on the NUMA node of the thread creating it.
+	ThreadStartNodeAffinity = 1<<0,
 };
 
 /*
@@ -44,6 +54,33 @@ struct ThreadStart
  */
 extern void (*_cgo_thread_start)(ThreadStart *ts);
 
+/*
+ * Called by the runtime on systems that support it.
+ * Like _cgo_thread_start, but for a batch of new threads;
+ * see x_cgo_thread_start_n.
+ */
+extern void (*_cgo_thread_start_n)(void *arg);
+
+/*
+ * Allocates a ThreadStart record without calling the C allocator
+ * in the common case. Used to make the copy handed to a new thread.
+ */
+ThreadStart *_cgo_thread_start_alloc(void);
+
+/*
+ * Maximum number of threads started by one _cgo_thread_start_n call.
+ * Known to ../runtime/proc.go.
+ */
+enum {
+	ThreadStartBatch = 8,
+};
+
+/*
+ * Releases the copy of the ThreadStart made by _cgo_thread_start.
+ * Called by the new thread once it has copied the record.
+ */
+void _cgo_thread_start_free(ThreadStart *ts);
+
 /*
  * Creates a new operating system thread without updating any Go state
  * (OS dependent).
@@ -55,6 +92,61 @@ extern void (*_cgo_sys_thread_create)(void* (*func)(void*), void* arg);
  */
 void _cgo_sys_thread_start(ThreadStart *ts);
 
+/*
+ * Creates n operating system threads, one for each of ts[0] through
+ * ts[n-1], blocking and restoring signals only once (Linux only).
+ */
+void _cgo_sys_thread_start_n(ThreadStart **ts, int n);
+
+/*
+ * Does the part of x_cgo_init that is the same on every Linux
+ * architecture: saves setg and sets g->stacklo (Linux only).
+ */
+void _cgo_linux_init(G *g, void (*setg)(void*));
+
+/*
+ * Called on a new thread to install g, using setg if the architecture
+ * needs it, and call fn in Go. Defined in gcc_linux_GOARCH.c; the rest
+ * of thread start-up is shared in gcc_linux.c (Linux only).
+ */
+void _cgo_linux_crosscall(void (*fn)(void), void (*setg)(void*), G *g);
+
+/*
+ * Hands ts to a parked thread from the thread pool, which will call
+ * fn(ts). Returns 1 on success and 0 if the pool is disabled or empty,
+ * in which case the caller must create the thread itself (Linux and
+ * Windows). On Windows fn is a _beginthreadex start routine.
+ */
+#ifdef _WIN32
+int _cgo_thread_pool_start(ThreadStart *ts, unsigned (__stdcall *fn)(void*));
+#else
+int _cgo_thread_pool_start(ThreadStart *ts, void* (*fn)(void*));
+#endif
+
+/*
+ * Returns the stack reserve of the threads started for ThreadStarts
+ * asking for size bytes, 0 meaning the default (Windows only).
+ */
+uintptr_t _cgo_thread_stacksize(uintptr_t size);
+
+/*
+ * Returns the NUMA node of the CPU the calling thread is running on,
+ * or -1 if it is not known (Linux and FreeBSD).
+ */
+int _cgo_thread_node(void);
+
+/*
+ * If ts has ThreadStartNodeAffinity set, restricts the pthread_attr_t
+ * attr to the CPUs of the calling thread's NUMA node (Linux and FreeBSD).
+ */
+void _cgo_node_affinity(ThreadStart *ts, void *attr);
+
+/*
+ * Restricts the calling thread to the CPUs of NUMA node node.
+ * Returns 1 on success and 0 on failure (Linux and FreeBSD).
+ */
+int _cgo_bind_thread_node(int node);
+
 /*
  * Waits for the Go runtime to be initialized (OS dependent).
  * If runtime.SetCgoTraceback is used to set a context function,
@@ -62,6 +154,137 @@ void _cgo_sys_thread_start(ThreadStart *ts);
  */
 uintptr_t _cgo_wait_runtime_init_done();
 
+/*
+ * A call to an exported Go function, as filled in by the Name_call
+ * function that cmd/cgo writes to _cgo_export.c for each export.
+ * Declared as GoCall in _cgo_export.h; also known to ../runtime/cgocallback.go.
+ */
+typedef struct {
+	void *fn;
+	void *frame;
+	int32_t size;
+} GoCall;
+
+/*
+ * A ring of fixed-size elements in C memory, which C threads push to
+ * with GoRingPush and the goroutine that owns the runtime/cgo.Ring
+ * pops from. The header is followed by mask+1 slots of stride bytes,
+ * each a sequence number and then an element, as in Dmitry Vyukov's
+ * bounded queue: the slot for position pos is free when its sequence
+ * number is pos, and full when it is pos+1.
+ * Declared as GoRing in _cgo_export.h; also known to ring.go.
+ */
+typedef struct GoRing GoRing;
+struct GoRing
+{
+	uint64_t head;		// next position for a producer to claim
+	char pad0[56];
+	uint32_t waiting;	// whether the consumer is parked, or about to park
+	int32_t wakefd;		// write end of the pipe that wakes the consumer
+	uint32_t elemsize;
+	uint32_t stride;
+	uint32_t mask;
+	char pad1[44];
+};
+
+/*
+ * The counters that sysmon publishes for GoReadStats, under a seqlock:
+ * seq is odd while they are being written.
+ * Also known to the runtime as cgoStatsPage; stats is the GoStats
+ * struct of _cgo_export.h.
+ */
+enum {
+	GoStatsFields = 16,
+};
+typedef struct GoStatsPage GoStatsPage;
+struct GoStatsPage
+{
+	uint64_t seq;
+	uint64_t stats[GoStatsFields];
+};
+
+/*
+ * Blocks until *p is not nil, for the runtime goroutine that runs
+ * calls queued by GoInvokeAsync. Woken by _cgo_async_wake (OS dependent).
+ */
+void _cgo_async_sleep(void **p);
+
+/*
+ * Wakes a thread blocked in _cgo_async_sleep, if any,
+ * after a call is queued (OS dependent).
+ */
+void _cgo_async_wake(void);
+
+/*
+ * Releasing the runtime, for GoReleaseRuntime (Linux only).
+ * _cgo_libinit_release_begin reports whether the runtime is running
+ * or starting and so must be released; the others are called by the
+ * runtime, with the world stopped for good, to make the threads of
+ * this package that wait for work exit.
+ */
+int _cgo_libinit_release_begin(void);
+void _cgo_libinit_stop(void);
+void _cgo_thread_pool_stop(void);
+void _cgo_callpool_stop(void);
+
+/*
+ * Reports whether any call is queued or running on the thread pool
+ * for #cgo async: functions.
+ */
+int _cgo_callpool_busy(void);
+
+/*
+ * Forking the runtime, for GoForkRuntime (Linux only). Each is called
+ * with ForkPrepare before fork, by the thread that forks, with the
+ * world stopped, and with ForkParent or ForkChild after it, to make
+ * the state of the threads of this package that wait for work fit
+ * the process. _cgo_callpool_fork returns 0, and locks nothing, if
+ * calls are queued or running on the thread pool for #cgo async:
+ * functions.
+ */
+enum {
+	ForkPrepare,
+	ForkParent,
+	ForkChild,
+};
+void _cgo_thread_pool_fork(int phase);
+int _cgo_callpool_fork(int phase);
+
+/*
+ * A timestamped startup event, reported by the runtime when
+ * GODEBUG=cgoinittrace=1 is set. Also known to ../runtime/proc.go.
+ */
+typedef struct StartupEvent StartupEvent;
+struct StartupEvent
+{
+	const char *name;
+	int64_t usec;	// microseconds since an arbitrary start
+};
+
+/*
+ * Records the startup event name, which must be a static string
+ * (OS dependent).
+ */
+void _cgo_startup_event(const char *name);
+
+/*
+ * USDT probes in provider go_cgo, for SystemTap and eBPF tools.
+ * They are compiled in only on Linux with the cgo_usdt build tag,
+ * which needs <sys/sdt.h>; each probe is then a single nop until a
+ * tracer attaches. The internal linker drops the probe notes, so the
+ * program must be linked with -ldflags=-linkmode=external.
+ */
+#ifdef GO_CGO_USDT
+#include <sys/sdt.h>
+#define _cgo_probe(name) DTRACE_PROBE(go_cgo, name)
+#define _cgo_probe1(name, a) DTRACE_PROBE1(go_cgo, name, a)
+#define _cgo_probe2(name, a, b) DTRACE_PROBE2(go_cgo, name, a, b)
+#else
+#define _cgo_probe(name) do {} while(0)
+#define _cgo_probe1(name, a) do {} while(0)
+#define _cgo_probe2(name, a, b) do {} while(0)
+#endif
+
 /*
  * Call fn in the 6c world.
  */
@@ -83,7 +306,7 @@ void fatalf(const char* format, ...);
 void darwin_arm_init_thread_exception_port(void);
 
 /*
- * Starts a mach message server processing EXC_BAD_ACCESS.
+ * Starts the mach message servers processing EXC_BAD_ACCESS.
  */
 void darwin_arm_init_mach_exception_handler(void);
 
@@ -94,3 +317,9 @@ struct context_arg {
 	uintptr_t Context;
 };
 extern void (*x_cgo_context_function)(struct context_arg*);
+
+/*
+ * Reports whether the current call from C to Go should call
+ * x_cgo_context_function. See runtime.SetCgoTracebackContextRate.
+ */
+int _cgo_context_sampled(void);
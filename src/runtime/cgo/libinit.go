@@ -0,0 +1,79 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build darwin dragonfly freebsd linux netbsd solaris
+
+package cgo
+
+import "unsafe"
+
+// Copies out the startup events recorded by the C code in this
+// package. See GODEBUG=cgoinittrace in the runtime package documentation.
+
+//go:cgo_import_static x_cgo_startup_events
+//go:linkname x_cgo_startup_events x_cgo_startup_events
+//go:linkname _cgo_startup_events _cgo_startup_events
+var x_cgo_startup_events byte
+var _cgo_startup_events = &x_cgo_startup_events
+
+// Binds an extra M to the current thread, for GODEBUG=cgostickym=1.
+
+//go:cgo_import_static x_cgo_bindm
+//go:linkname x_cgo_bindm x_cgo_bindm
+//go:linkname _cgo_bindm _cgo_bindm
+var x_cgo_bindm byte
+var _cgo_bindm = &x_cgo_bindm
+
+// Releases the M bound by x_cgo_bindm. Called by the pthread key
+// destructor in gcc_libinit.c as the thread exits:
+//   crosscall2(_cgo_release_m, g0, 0, 0);
+
+//go:linkname _runtime_cgounbindm runtime.cgounbindm
+func _runtime_cgounbindm(g0 unsafe.Pointer)
+
+//go:linkname _cgo_release_m _cgo_release_m
+//go:cgo_export_static _cgo_release_m
+//go:nosplit
+//go:norace
+func _cgo_release_m(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgounbindm(a)
+}
+
+// Called by GoRegisterThread like this:
+//   struct { int32_t *ok; } arg;
+//   crosscall2(_cgo_register_thread, &arg, sizeof arg, ctxt);
+
+//go:linkname _runtime_cgo_register_thread_internal runtime._cgo_register_thread_internal
+var _runtime_cgo_register_thread_internal byte
+
+//go:linkname _cgo_register_thread _cgo_register_thread
+//go:cgo_export_static _cgo_register_thread
+//go:nosplit
+//go:norace
+func _cgo_register_thread(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_register_thread_internal), a, uintptr(n), ctxt)
+}
+
+// Runs the package initialization of a library that shares the
+// runtime with libraries loaded before it; see runtime.libstart.
+
+//go:cgo_import_static x_cgo_init_library
+//go:linkname x_cgo_init_library x_cgo_init_library
+//go:linkname _cgo_init_library _cgo_init_library
+var x_cgo_init_library byte
+var _cgo_init_library = &x_cgo_init_library
+
+// Called by x_cgo_init_library like this:
+//   crosscall2(_cgo_init_modules, nil, 0, ctxt);
+
+//go:linkname _runtime_cgo_init_modules_internal runtime._cgo_init_modules_internal
+var _runtime_cgo_init_modules_internal byte
+
+//go:linkname _cgo_init_modules _cgo_init_modules
+//go:cgo_export_static _cgo_init_modules
+//go:nosplit
+//go:norace
+func _cgo_init_modules(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_init_modules_internal), a, uintptr(n), ctxt)
+}
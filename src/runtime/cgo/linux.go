@@ -0,0 +1,45 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package cgo
+
+import _ "unsafe" // for go:linkname
+
+// Enables the pool of pre-created threads used by _cgo_sys_thread_start.
+// See GODEBUG=cgothreadpool in the runtime package documentation.
+
+//go:cgo_import_static x_cgo_thread_pool_init
+//go:linkname x_cgo_thread_pool_init x_cgo_thread_pool_init
+//go:linkname _cgo_thread_pool_init _cgo_thread_pool_init
+var x_cgo_thread_pool_init byte
+var _cgo_thread_pool_init = &x_cgo_thread_pool_init
+
+// Starts a batch of new Ms, blocking and restoring signals once for
+// the whole batch instead of once per thread.
+
+//go:cgo_import_static x_cgo_thread_start_n
+//go:linkname x_cgo_thread_start_n x_cgo_thread_start_n
+//go:linkname _cgo_thread_start_n _cgo_thread_start_n
+var x_cgo_thread_start_n byte
+var _cgo_thread_start_n = &x_cgo_thread_start_n
+
+// Restricts the calling thread to one NUMA node, or undoes that.
+// See runtime.LockOSThreadNode.
+
+//go:cgo_import_static x_cgo_set_thread_node
+//go:linkname x_cgo_set_thread_node x_cgo_set_thread_node
+//go:linkname _cgo_set_thread_node _cgo_set_thread_node
+var x_cgo_set_thread_node byte
+var _cgo_set_thread_node = &x_cgo_set_thread_node
+
+// Finds the bounds of the stack of a thread not started by Go, for
+// the g0 of an extra M.
+
+//go:cgo_import_static x_cgo_getstackbounds
+//go:linkname x_cgo_getstackbounds x_cgo_getstackbounds
+//go:linkname _cgo_getstackbounds _cgo_getstackbounds
+var x_cgo_getstackbounds byte
+var _cgo_getstackbounds = &x_cgo_getstackbounds
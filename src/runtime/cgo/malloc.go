@@ -0,0 +1,36 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+import "unsafe"
+
+// Malloc returns a pointer to n bytes of uninitialized C memory,
+// aligned as C's malloc aligns memory, which must be freed with Free.
+// Allocations of up to 256 bytes come from caches kept by each P
+// and refilled in bulk, so that most calls neither call into C nor
+// take a lock, and a Go program that allocates many small C objects
+// pays for one call into C per few dozen objects rather than one per
+// object. Memory freed with Free is kept in the caches for reuse by
+// Malloc, not returned to C. Larger allocations come from C's malloc,
+// or the allocator registered by GoSetCAllocator. Malloc panics if
+// the allocator fails.
+//
+// Memory from Malloc must not be passed to C's free or C.free. It may
+// hold Go pointers only under the cgo pointer passing rules for C
+// memory.
+func Malloc(n uintptr) unsafe.Pointer {
+	return _runtime_cmallocsmall(n)
+}
+
+// Free frees memory allocated by Malloc. Free(nil) does nothing.
+func Free(p unsafe.Pointer) {
+	_runtime_cfreesmall(p)
+}
+
+//go:linkname _runtime_cmallocsmall runtime.cmallocsmall
+func _runtime_cmallocsmall(n uintptr) unsafe.Pointer
+
+//go:linkname _runtime_cfreesmall runtime.cfreesmall
+func _runtime_cfreesmall(p unsafe.Pointer)
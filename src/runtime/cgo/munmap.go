@@ -0,0 +1,28 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package cgo
+
+// Import "unsafe" because we use go:linkname.
+import _ "unsafe"
+
+// When using cgo, call the C library for munmap and madvise, as we do
+// for mmap on linux/amd64, so that tools that interpose on the C
+// library's memory management, such as allocation trackers loaded
+// with LD_PRELOAD, see the memory that the Go runtime returns to the
+// system as well as the memory it maps.
+
+//go:cgo_import_static x_cgo_munmap
+//go:linkname x_cgo_munmap x_cgo_munmap
+//go:linkname _cgo_munmap _cgo_munmap
+var x_cgo_munmap byte
+var _cgo_munmap = &x_cgo_munmap
+
+//go:cgo_import_static x_cgo_madvise
+//go:linkname x_cgo_madvise x_cgo_madvise
+//go:linkname _cgo_madvise _cgo_madvise
+var x_cgo_madvise byte
+var _cgo_madvise = &x_cgo_madvise
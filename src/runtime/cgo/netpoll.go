@@ -0,0 +1,28 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+import "unsafe"
+
+// Network polling driven by a C host; see GoNetpollDescriptor and
+// GoNetpoll in gcc_netpoll.c and runtime._cgo_netpoll_internal.
+
+//go:cgo_export_dynamic GoNetpollDescriptor
+//go:cgo_export_dynamic GoNetpoll
+
+// Called by GoNetpollDescriptor and GoNetpoll like this:
+//   struct { NetpollArgs *a; } arg;
+//   crosscall2(_cgo_netpoll, &arg, sizeof arg, ctxt);
+
+//go:linkname _runtime_cgo_netpoll_internal runtime._cgo_netpoll_internal
+var _runtime_cgo_netpoll_internal byte
+
+//go:linkname _cgo_netpoll _cgo_netpoll
+//go:cgo_export_static _cgo_netpoll
+//go:nosplit
+//go:norace
+func _cgo_netpoll(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_netpoll_internal), a, uintptr(n), ctxt)
+}
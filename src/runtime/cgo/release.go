@@ -0,0 +1,37 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package cgo
+
+import "unsafe"
+
+// Releasing the runtime of a library; see GoReleaseRuntime in
+// gcc_release.c and runtime._cgo_release_internal.
+
+//go:cgo_export_dynamic GoReleaseRuntime
+
+// Exits the thread of an M once the runtime has been released.
+
+//go:cgo_import_static x_cgo_thread_exit
+//go:linkname x_cgo_thread_exit x_cgo_thread_exit
+//go:linkname _cgo_thread_exit _cgo_thread_exit
+var x_cgo_thread_exit byte
+var _cgo_thread_exit = &x_cgo_thread_exit
+
+// Called by GoReleaseRuntime like this:
+//   struct { ReleaseArgs *a; } arg;
+//   crosscall2(_cgo_release, &arg, sizeof arg, ctxt);
+
+//go:linkname _runtime_cgo_release_internal runtime._cgo_release_internal
+var _runtime_cgo_release_internal byte
+
+//go:linkname _cgo_release _cgo_release
+//go:cgo_export_static _cgo_release
+//go:nosplit
+//go:norace
+func _cgo_release(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_release_internal), a, uintptr(n), ctxt)
+}
@@ -0,0 +1,138 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build darwin dragonfly freebsd linux netbsd openbsd solaris
+
+package cgo
+
+/*
+#include <stdint.h>
+
+extern void _cgo_ring_new(uint32_t, uint32_t, uint32_t, void**, int*);
+extern void _cgo_ring_drain(int);
+extern void _cgo_ring_free(void*, int);
+*/
+import "C"
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+//go:cgo_export_dynamic GoRingPush
+
+// ringHeader is the header of a ring in C memory.
+// Keep in sync with GoRing in libcgo.h.
+type ringHeader struct {
+	head     uint64
+	_        [56]byte
+	waiting  uint32
+	wakefd   int32
+	elemsize uint32
+	stride   uint32
+	mask     uint32
+	_        [44]byte
+}
+
+// A Ring is a bounded queue of fixed-size elements in C memory, for
+// streaming data from C threads to a goroutine without a call into
+// Go per element. C code pushes elements with
+//
+//	int GoRingPush(GoRing *ring, const void *elem);
+//
+// declared in _cgo_export.h, which copies the element into the ring
+// and returns 1, or returns 0 if the ring is full. GoRingPush neither
+// enters Go nor blocks, and any number of C threads may call it at
+// once. The goroutine that owns the Ring takes the elements, in the
+// order their pushes claimed slots, with Pop, which parks the
+// goroutine while the ring is empty.
+//
+// A Ring has a single consumer: Pop, TryPop and Close must not be
+// called by more than one goroutine at once. Rings are not available
+// on Windows.
+type Ring struct {
+	h    *ringHeader
+	tail uint64 // next position to pop
+	size int
+	rfd  C.int   // read end of the wakeup pipe
+	pd   uintptr // *runtime.pollDesc for rfd
+}
+
+// NewRing returns a Ring for elements of elemSize bytes with room for
+// at least n of them, or nil if the C memory or the wakeup pipe cannot
+// be allocated. The ring must be freed with Close.
+func NewRing(elemSize, n int) *Ring {
+	if elemSize <= 0 || n <= 0 || n > 1<<30 {
+		panic("cgo: bad NewRing size")
+	}
+	slots := 1
+	for slots < n {
+		slots <<= 1
+	}
+	stride := (8 + elemSize + 7) &^ 7
+	var h unsafe.Pointer
+	var rfd C.int
+	C._cgo_ring_new(C.uint32_t(elemSize), C.uint32_t(stride), C.uint32_t(slots), &h, &rfd)
+	if h == nil {
+		return nil
+	}
+	r := &Ring{h: (*ringHeader)(h), size: elemSize, rfd: rfd}
+	pd, errno := runtime_pollOpen(uintptr(rfd))
+	if errno != 0 {
+		C._cgo_ring_free(h, rfd)
+		return nil
+	}
+	r.pd = pd
+	return r
+}
+
+// C returns the GoRing* to pass to C code.
+func (r *Ring) C() unsafe.Pointer {
+	return unsafe.Pointer(r.h)
+}
+
+// TryPop copies the oldest element into p, which must hold at least
+// elemSize bytes, and reports whether there was one.
+func (r *Ring) TryPop(p []byte) bool {
+	h := r.h
+	slot := unsafe.Pointer(uintptr(unsafe.Pointer(h)) + unsafe.Sizeof(*h) + uintptr(r.tail&uint64(h.mask))*uintptr(h.stride))
+	seq := (*uint64)(slot)
+	if atomic.Load64(seq) != r.tail+1 {
+		return false
+	}
+	elem := (*[1 << 30]byte)(unsafe.Pointer(uintptr(slot) + 8))[:r.size:r.size]
+	copy(p[:r.size], elem)
+	atomic.Store64(seq, r.tail+uint64(h.mask)+1)
+	r.tail++
+	return true
+}
+
+// Pop copies the oldest element into p, which must hold at least
+// elemSize bytes, parking the goroutine until there is one.
+func (r *Ring) Pop(p []byte) {
+	for !r.TryPop(p) {
+		atomic.Store(&r.h.waiting, 1)
+		if r.TryPop(p) {
+			atomic.Store(&r.h.waiting, 0)
+			return
+		}
+		if runtime_pollWait(r.pd, 'r') != 0 {
+			panic("cgo: Ring wait failed")
+		}
+		C._cgo_ring_drain(r.rfd)
+	}
+}
+
+// Close frees the ring. C code must not push to it once Close has
+// been called.
+func (r *Ring) Close() {
+	runtime_pollClose(r.pd)
+	C._cgo_ring_free(unsafe.Pointer(r.h), r.rfd)
+	r.h = nil
+}
+
+// Provided by the runtime's network poller.
+func runtime_pollOpen(fd uintptr) (uintptr, int)
+func runtime_pollWait(pd uintptr, mode int) int
+func runtime_pollClose(pd uintptr)
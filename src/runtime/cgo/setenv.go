@@ -19,3 +19,9 @@ var _cgo_setenv = &x_cgo_setenv
 //go:linkname _cgo_unsetenv runtime._cgo_unsetenv
 var x_cgo_unsetenv byte
 var _cgo_unsetenv = &x_cgo_unsetenv
+
+//go:cgo_import_static x_cgo_setenvs
+//go:linkname x_cgo_setenvs x_cgo_setenvs
+//go:linkname _cgo_setenvs runtime._cgo_setenvs
+var x_cgo_setenvs byte
+var _cgo_setenvs = &x_cgo_setenvs
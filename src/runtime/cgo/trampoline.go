@@ -0,0 +1,92 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+import "unsafe"
+
+// CallbackArgs is the number of arguments passed to the Go function
+// of a callback made by NewCallback.
+const CallbackArgs = 6
+
+// MaxCallbacks is the number of callbacks made by NewCallback that
+// may exist at once. Keep in sync with gcc_trampoline.c and
+// runtime.maxCgoCallbacks.
+const MaxCallbacks = 256
+
+// NewCallback returns a C function pointer that calls fn. C code may
+// call it as a function of type
+//
+//	uintptr_t (*)(uintptr_t, uintptr_t, uintptr_t, uintptr_t, uintptr_t, uintptr_t)
+//
+// or as one of fewer arguments, each an integer or a pointer, with an
+// integer, pointer or void result, such as a qsort comparator. fn gets
+// the arguments in args, any beyond those the caller passed holding
+// garbage, and its result is returned to C, truncated as the caller's
+// type requires. Floating-point arguments and results are not
+// supported. args points into the stack frame of the C trampoline:
+// fn must not keep args, or a pointer into it, after it returns.
+//
+// Unlike an exported Go function that looks up a Go value in a table
+// of its own, a call through the pointer goes straight to fn, with no
+// lock or map lookup. It costs one call from C into Go.
+//
+// The callback must be released with FreeCallback once C code can no
+// longer call it. At most MaxCallbacks callbacks may exist at once;
+// NewCallback panics beyond that.
+func NewCallback(fn func(args *[CallbackArgs]uintptr) uintptr) unsafe.Pointer {
+	if fn == nil {
+		panic("cgo: NewCallback of nil func")
+	}
+	i := _runtime_cgoNewCallback(fn)
+	if i < 0 {
+		panic("cgo: too many callbacks")
+	}
+	return trampolines()[i]
+}
+
+// FreeCallback releases the callback p made by NewCallback, whose
+// slot NewCallback may then reuse for another Go function. C code must
+// not call p after FreeCallback.
+func FreeCallback(p unsafe.Pointer) {
+	for i, t := range trampolines() {
+		if t == p {
+			_runtime_cgoFreeCallback(i)
+			return
+		}
+	}
+	panic("cgo: FreeCallback of pointer not from NewCallback")
+}
+
+// trampolines returns the C functions of the callbacks, in
+// gcc_trampoline.c.
+func trampolines() *[MaxCallbacks]unsafe.Pointer {
+	return (*[MaxCallbacks]unsafe.Pointer)(unsafe.Pointer(&x_cgo_trampolines))
+}
+
+//go:cgo_import_static x_cgo_trampolines
+//go:linkname x_cgo_trampolines x_cgo_trampolines
+var x_cgo_trampolines byte
+
+//go:linkname _runtime_cgoNewCallback runtime.cgoNewCallback
+func _runtime_cgoNewCallback(fn func(*[CallbackArgs]uintptr) uintptr) int
+
+//go:linkname _runtime_cgoFreeCallback runtime.cgoFreeCallback
+func _runtime_cgoFreeCallback(i int)
+
+// Calls the Go function of a callback made by NewCallback, for the
+// C functions in gcc_trampoline.c. Called like this:
+//   struct { TrampolineCall *c; } a;
+//   crosscall2(_cgo_trampoline, &a, sizeof a, ctxt);
+
+//go:linkname _runtime_cgo_trampoline_internal runtime._cgo_trampoline_internal
+var _runtime_cgo_trampoline_internal byte
+
+//go:linkname _cgo_trampoline _cgo_trampoline
+//go:cgo_export_static _cgo_trampoline
+//go:nosplit
+//go:norace
+func _cgo_trampoline(a unsafe.Pointer, n int32, ctxt uintptr) {
+	_runtime_cgocallback(unsafe.Pointer(&_runtime_cgo_trampoline_internal), a, uintptr(n), ctxt)
+}
@@ -0,0 +1,125 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package cgo
+
+/*
+#include <stdint.h>
+
+extern void _cgo_uring_new(uint32_t*, void**, void**);
+extern void _cgo_uring_submit(void*, uint32_t);
+extern void _cgo_uring_free(void*);
+*/
+import "C"
+
+import "unsafe"
+
+// ioDesc is an IOOp as passed to C.
+// Keep in sync with IODesc in gcc_uring_linux.c.
+type ioDesc struct {
+	fd    int32
+	write int32
+	addr  uint64
+	len   uint64
+	off   int64
+	res   int64
+}
+
+// An IOOp is one read or write of a batch submitted by IOBatch.
+type IOOp struct {
+	Fd    int    // file descriptor, as from os.File.Fd
+	Write bool   // write Buf to Fd, rather than read into it
+	Buf   []byte // the data
+	Off   int64  // file offset, or -1 for the file's current offset
+
+	// N is the number of bytes read or written, and Errno the
+	// error number of the system call if it failed, to be
+	// converted with syscall.Errno. Submit sets both.
+	N     int
+	Errno int
+}
+
+// An IOBatch makes reads and writes in bulk, for programs that do
+// many small ones, such as reading many small files. Submit hands a
+// whole batch of operations to the kernel through an io_uring with one
+// call into C and, usually, one system call, where reading each file
+// with os.File would take a system call per read. On kernels without
+// io_uring, before Linux 5.1 or where it is disabled, the batch is still
+// made with one call into C but one system call per operation.
+// IOBatch is only available on Linux.
+//
+// An IOBatch must not be used by multiple goroutines at once.
+type IOBatch struct {
+	ring unsafe.Pointer
+	desc *[1 << 20]ioDesc // C array of n descriptors
+	n    int
+	ops  []IOOp // the batch being submitted, kept live for C
+}
+
+// NewIOBatch returns an IOBatch that submits up to n operations at a
+// time, or nil if it cannot allocate its C memory. The IOBatch must be
+// freed with Close.
+func NewIOBatch(n int) *IOBatch {
+	if n <= 0 || n > 1<<20 {
+		panic("cgo: bad NewIOBatch size")
+	}
+	cn := C.uint32_t(n)
+	var ring, desc unsafe.Pointer
+	C._cgo_uring_new(&cn, &ring, &desc)
+	if ring == nil {
+		return nil
+	}
+	return &IOBatch{ring: ring, desc: (*[1 << 20]ioDesc)(desc), n: int(cn)}
+}
+
+// Submit makes the operations in ops, in any order and possibly
+// concurrently, and returns when all of them are done, having set
+// their N and Errno fields. The operations go to the kernel in groups
+// of at most the size given to NewIOBatch.
+func (b *IOBatch) Submit(ops []IOOp) {
+	// Keeping ops in b also makes the buffers escape to the heap,
+	// where they cannot move while C has their addresses.
+	b.ops = ops
+	for len(ops) > 0 {
+		n := len(ops)
+		if n > b.n {
+			n = b.n
+		}
+		for i := range ops[:n] {
+			op := &ops[i]
+			d := &b.desc[i]
+			d.fd = int32(op.Fd)
+			d.write = 0
+			if op.Write {
+				d.write = 1
+			}
+			d.addr = 0
+			if len(op.Buf) > 0 {
+				d.addr = uint64(uintptr(unsafe.Pointer(&op.Buf[0])))
+			}
+			d.len = uint64(len(op.Buf))
+			d.off = op.Off
+		}
+		C._cgo_uring_submit(b.ring, C.uint32_t(n))
+		for i := range ops[:n] {
+			res := b.desc[i].res
+			if res < 0 {
+				ops[i].N = 0
+				ops[i].Errno = int(-res)
+			} else {
+				ops[i].N = int(res)
+				ops[i].Errno = 0
+			}
+		}
+		ops = ops[n:]
+	}
+	b.ops = nil
+}
+
+// Close frees the IOBatch.
+func (b *IOBatch) Close() {
+	C._cgo_uring_free(b.ring)
+	b.ring = nil
+	b.desc = nil
+}
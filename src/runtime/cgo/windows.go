@@ -0,0 +1,18 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build windows
+
+package cgo
+
+import _ "unsafe" // for go:linkname
+
+// Enables the pool of pre-created threads used by _cgo_sys_thread_start.
+// See GODEBUG=cgothreadpool in the runtime package documentation.
+
+//go:cgo_import_static x_cgo_thread_pool_init
+//go:linkname x_cgo_thread_pool_init x_cgo_thread_pool_init
+//go:linkname _cgo_thread_pool_init _cgo_thread_pool_init
+var x_cgo_thread_pool_init byte
+var _cgo_thread_pool_init = &x_cgo_thread_pool_init
@@ -15,7 +15,10 @@ import "unsafe"
 //go:linkname _cgo_mmap _cgo_mmap
 var _cgo_mmap unsafe.Pointer
 
-func mmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint32) unsafe.Pointer {
+// mmap is nosplit so that syscall_runtime_mmap can call it between
+// entersyscall and exitsyscall.
+//go:nosplit
+func mmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint64) unsafe.Pointer {
 	if _cgo_mmap != nil {
 		// Make ret a uintptr so that writing to it in the
 		// function literal does not trigger a write barrier.
@@ -33,9 +36,22 @@ func mmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint32) uns
 }
 
 // sysMmap calls the mmap system call. It is implemented in assembly.
-func sysMmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint32) unsafe.Pointer
+func sysMmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint64) unsafe.Pointer
 
-// cgoMmap calls the mmap function in the runtime/cgo package on the
 // callCgoMmap calls the mmap function in the runtime/cgo package
 // using the GCC calling convention. It is implemented in assembly.
-func callCgoMmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint32) uintptr
+func callCgoMmap(addr unsafe.Pointer, n uintptr, prot, flags, fd int32, off uint64) uintptr
+
+// syscall_runtime_mmap is the mmap system call for package syscall,
+// which uses it for Mmap. Mapping files through mmap above means that
+// when using cgo the C library's mmap, and any sanitizer interceptors
+// wrapping it, see file mappings just as they see the heap.
+// The result is the mapped address, or an errno value less than 4096.
+//go:linkname syscall_runtime_mmap syscall.runtime_mmap
+//go:nosplit
+func syscall_runtime_mmap(addr, n uintptr, prot, flags, fd int32, off uint64) uintptr {
+	entersyscall(0)
+	p := uintptr(mmap(unsafe.Pointer(addr), n, prot, flags, fd, off))
+	exitsyscall(0)
+	return p
+}
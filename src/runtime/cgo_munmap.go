@@ -0,0 +1,62 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Support for memory tools that interpose on the C library's memory
+// management functions. See runtime/cgo/munmap.go.
+
+// +build linux
+
+package runtime
+
+import "unsafe"
+
+// _cgo_munmap and _cgo_madvise are filled in by runtime/cgo when it
+// is linked into the program, so they are only non-nil when using cgo.
+//go:linkname _cgo_munmap _cgo_munmap
+var _cgo_munmap unsafe.Pointer
+
+//go:linkname _cgo_madvise _cgo_madvise
+var _cgo_madvise unsafe.Pointer
+
+// munmap and madvise are called on the system stack, or with
+// locks held, so they must not split the stack. When using cgo they
+// call the C library, whose function a tool may have replaced; the
+// arguments are passed in a struct as asmcgocall requires. The fields
+// are uintptrs so that filling them in needs no write barriers.
+
+//go:nosplit
+func munmap(addr unsafe.Pointer, n uintptr) {
+	if _cgo_munmap != nil {
+		args := struct {
+			addr, n uintptr
+			ret     int32
+		}{uintptr(addr), n, 0}
+		asmcgocall(_cgo_munmap, unsafe.Pointer(&args))
+		if args.ret != 0 {
+			throw("runtime: munmap failed")
+		}
+		return
+	}
+	sysMunmap(addr, n)
+}
+
+//go:nosplit
+func madvise(addr unsafe.Pointer, n uintptr, flags int32) {
+	if _cgo_madvise != nil {
+		args := struct {
+			addr, n uintptr
+			flags   int32
+		}{uintptr(addr), n, flags}
+		asmcgocall(_cgo_madvise, unsafe.Pointer(&args))
+		return
+	}
+	sysMadvise(addr, n, flags)
+}
+
+// sysMunmap calls the munmap system call. It is implemented in assembly.
+func sysMunmap(addr unsafe.Pointer, n uintptr)
+
+// sysMadvise calls the madvise system call, ignoring any failure.
+// It is implemented in assembly.
+func sysMadvise(addr unsafe.Pointer, n uintptr, flags int32)
@@ -8,9 +8,9 @@
 // runtime.cgocall(_cgo_Cfunc_f, frame), where _cgo_Cfunc_f is a
 // gcc-compiled function written by cgo.
 //
-// runtime.cgocall (below) locks g to m, calls entersyscall
-// so as not to block other goroutines or the garbage collector,
-// and then calls runtime.asmcgocall(_cgo_Cfunc_f, frame).
+// runtime.cgocall (below) calls entersyscall so as not to block
+// other goroutines or the garbage collector, and then calls
+// runtime.asmcgocall(_cgo_Cfunc_f, frame).
 //
 // runtime.asmcgocall (in asm_$GOARCH.s) switches to the m->g0 stack
 // (assumed to be an operating system-allocated stack, so safe to run
@@ -24,8 +24,7 @@
 // original g (m->curg)'s stack and returns to runtime.cgocall.
 //
 // After it regains control, runtime.cgocall calls exitsyscall, which blocks
-// until this m can run Go code without violating the $GOMAXPROCS limit,
-// and then unlocks g from m.
+// until this m can run Go code without violating the $GOMAXPROCS limit.
 //
 // The above description skipped over the possibility of the gcc-compiled
 // function f calling back into Go. If that happens, we continue down
@@ -48,7 +47,10 @@
 // (The reason for having _cgoexp_GoF instead of writing a crosscall3
 // to make this call directly is that _cgoexp_GoF, because it is compiled
 // with 6c instead of gcc, can refer to dotted names like
-// runtime.cgocallback and p.GoF.)
+// runtime.cgocallback and p.GoF.) If the arguments and results of p.GoF
+// are all scalars, _cgoexp_GoF passes instead of p.GoF a wrapper that
+// reads the arguments from frame and writes the results there itself,
+// and sets cgoCallbackDirect in framesize.
 //
 // runtime.cgocallback (in asm_$GOARCH.s) switches from m->g0's
 // stack to the original g (m->curg)'s stack, on which it calls
@@ -60,15 +62,18 @@
 // m->g0 stack, so that it can be restored later.
 //
 // runtime.cgocallbackg (below) is now running on a real goroutine
-// stack (not an m->g0 stack).  First it calls runtime.exitsyscall, which will
-// block until the $GOMAXPROCS limit allows running this goroutine.
+// stack (not an m->g0 stack).  First it locks g to m, since the C frames
+// below it are on this m's g0 stack, and then it calls runtime.exitsyscall,
+// which will block until the $GOMAXPROCS limit allows running this goroutine.
 // Once exitsyscall has returned, it is safe to do things like call the memory
 // allocator or invoke the Go callback function p.GoF.  runtime.cgocallbackg
 // first defers a function to unwind m->g0.sched.sp, so that if p.GoF
 // panics, m->g0.sched.sp will be restored to its old value: the m->g0 stack
 // and the m->curg stack will be unwound in lock step.
 // Then it calls p.GoF.  Finally it pops but does not execute the deferred
-// function, calls runtime.entersyscall, and returns to runtime.cgocallback.
+// function, unlocks g from m, calls runtime.entersyscall, and returns to
+// runtime.cgocallback. Locking g to m only here, rather than in
+// runtime.cgocall, keeps the many C calls that never call back cheap.
 //
 // After it regains control, runtime.cgocallback switches back to
 // m->g0's stack (the pointer is still in m->g0.sched.sp), restores the old
@@ -80,13 +85,77 @@
 package runtime
 
 import (
+	"runtime/internal/atomic"
 	"runtime/internal/sys"
 	"unsafe"
 )
 
 // Addresses collected in a cgo backtrace when crashing.
-// Length must match arg.Max in x_cgo_callers in runtime/cgo/gcc_traceback.c.
-type cgoCallers [32]uintptr
+// The slice is allocated for each M when it is created. Its length is
+// the traceback depth, which is also stored in x_cgo_callers_max in
+// runtime/cgo/gcc_traceback.c and passed to the traceback function
+// as arg.Max. The signal handler uses only the data pointer, which is
+// the first word of the slice.
+//
+// The two words after the end of the slice hold the bounds of the
+// M's g0 stack, for the frame pointer unwinder in gcc_traceback.c.
+// See setCgoCallersStack.
+type cgoCallers []uintptr
+
+// newCgoCallers allocates a cgoCallers buffer of depth n.
+func newCgoCallers(n int) cgoCallers {
+	return make(cgoCallers, n, n+2)
+}
+
+// setCgoCallersStack records the bounds of the g0 stack of mp after
+// the end of its cgoCallers buffer. It is called on Ms started by the
+// runtime, whose g0 stack bounds are exact. Extra Ms, used by threads
+// not created by Go, leave them zero, and the frame pointer unwinder
+// collects only the interrupted PC.
+func setCgoCallersStack(mp *m) {
+	if mp.cgoCallers == nil {
+		return
+	}
+	n := len(mp.cgoCallers)
+	b := mp.cgoCallers[:n+2]
+	b[n] = mp.g0.stack.lo
+	b[n+1] = mp.g0.stack.hi
+}
+
+// Default and maximum cgo traceback depth. GODEBUG=cgotracebackdepth=N
+// selects a depth in between.
+const (
+	defaultCgoTracebackDepth = 32
+	maxCgoTracebackDepth     = 1024
+)
+
+// cgoTracebackDepth returns the number of PCs to collect in a cgo
+// traceback.
+func cgoTracebackDepth() int {
+	n := int(debug.cgotracebackdepth)
+	if n <= 0 {
+		return defaultCgoTracebackDepth
+	}
+	if n > maxCgoTracebackDepth {
+		n = maxCgoTracebackDepth
+	}
+	return n
+}
+
+// setCgoTracebackDepth tells x_cgo_callers how many PCs fit in the
+// buffer and resizes the buffer of m0, which was allocated before
+// GODEBUG was parsed. It is called from schedinit, before any other M
+// exists.
+func setCgoTracebackDepth() {
+	n := cgoTracebackDepth()
+	mp := getg().m
+	if mp.cgoCallers != nil && len(mp.cgoCallers) != n {
+		mp.cgoCallers = newCgoCallers(n)
+	}
+	if _cgo_callers_max != nil {
+		*(*uintptr)(_cgo_callers_max) = uintptr(n)
+	}
+}
 
 // Call from Go to C.
 //go:nosplit
@@ -100,18 +169,18 @@ func cgocall(fn, arg unsafe.Pointer) int32 {
 	}
 
 	if raceenabled {
-		racereleasemerge(unsafe.Pointer(&racecgosync))
+		racereleasemerge(racecgosyncaddr(uintptr(fn)))
 	}
 
-	/*
-	 * Lock g to m to ensure we stay on the same stack if we do a
-	 * cgo callback. Add entry to defer stack in case of panic.
-	 */
-	lockOSThread()
+	// There is no need to lock g to m here, nor to defer
+	// endcgo in case of a panic: only a callback into Go can
+	// move g or panic, and cgocallbackg handles both.
 	mp := getg().m
 	mp.ncgocall++
 	mp.ncgo++
-	defer endcgo(mp)
+	if debug.cgoaffinity != 0 {
+		getg().cgoAffinity.set(mp)
+	}
 
 	// Reset traceback.
 	mp.cgoCallers[0] = 0
@@ -127,26 +196,356 @@ func cgocall(fn, arg unsafe.Pointer) int32 {
 	 * so it is safe to call while "in a system call", outside
 	 * the $GOMAXPROCS accounting.
 	 */
+	// Time one call in cgoCallSampleRate at each call site, so that
+	// sysmon can tell short calls from ones that block (see retake),
+	// and the calls sampled for the cgo call profile.
+	sample := mp.ncgocall%cgoCallSampleRate == 0
+	profrate := cgoCallProfSampled(mp.ncgocall)
+	prof := profrate != 0
+	var start int64
+	if sample || prof {
+		start = nanotime()
+	}
+	var t0 int64
+	if atomic.Load64(&cgoblockprofilerate) > 0 {
+		t0 = cputicks()
+	}
+	if trace.enabled {
+		traceCgoCall()
+	}
+	mp.cgocallfn = uintptr(fn)
+	// Tell retake which function the call is in. The P loses its
+	// m back-link in entersyscall, so the function is recorded on
+	// the P itself, for the system call that is about to start;
+	// a later system call on the P has a different syscalltick.
+	if pp := mp.p.ptr(); pp != nil {
+		pp.cgocallfn = uintptr(fn)
+		pp.cgocalltick = pp.syscalltick
+	}
+	mp.ncgoinc++
+	cgoFlight(mp, cgoFlightCall, getcallerpc(unsafe.Pointer(&fn)))
 	entersyscall(0)
 	errno := asmcgocall(fn, arg)
 	exitsyscall(0)
+	cgoFlight(mp, cgoFlightReturn, getcallerpc(unsafe.Pointer(&fn)))
+	mp.ncgoinc--
+	if trace.enabled {
+		traceCgoCallDone()
+	}
+	if t0 != 0 {
+		cgoblockevent(cputicks()-t0, 2)
+	}
+	if sample || prof {
+		d := nanotime() - start
+		if sample {
+			cgoCallRecord(uintptr(fn), d)
+		}
+		if prof {
+			cgoCallProfRecord(uintptr(fn), getcallerpc(unsafe.Pointer(&fn)), d, profrate)
+		}
+	}
 
+	endcgo(mp)
 	return errno
 }
 
+// Call from Go to a C function marked with a #cgo affinity: directive.
+// Such a function keeps state in thread-local storage, so it works best
+// when a goroutine's calls run on the same thread. Locking the goroutine
+// to the thread would cost a thread per goroutine; instead the goroutine
+// remembers the M that made the call, and schedule hands its P to that
+// M when the goroutine next runs, if the M is idle (see startaffinem).
+// A busy M does not hold the goroutine back, so the affinity is only a
+// preference.
+func cgocallaffine(fn, arg unsafe.Pointer) int32 {
+	gp := getg()
+	gp.cgoAffinity.set(gp.m)
+	return cgocall(fn, arg)
+}
+
+// cgoCallSites keeps a running average of the duration of the C calls
+// made through each cgo function wrapper, keyed by its address. retake
+// uses it to leave the P alone for a little longer when the call that
+// is holding it usually returns quickly, rather than handing the P
+// to another M, often a new thread, just before the call returns.
+// Like cgoStackHints, the table is direct-mapped and unlocked; a racing
+// update only makes one average less accurate.
+var cgoCallSites [64]cgoCallSite
+
+type cgoCallSite struct {
+	fn  uintptr
+	avg uint32 // nanoseconds, times 8
+}
+
+const (
+	// Sample one call in cgoCallSampleRate on each M.
+	cgoCallSampleRate = 8
+
+	// cgoCallShort is the longest average duration of a call for
+	// which retake waits; calls longer than that lose their P
+	// as usual. retake waits at most twice the average.
+	cgoCallShort = 500 * 1000 // 0.5ms
+)
+
+func cgoCallSiteSlot(fn uintptr) *cgoCallSite {
+	return &cgoCallSites[(fn/sys.PtrSize)%uintptr(len(cgoCallSites))]
+}
+
+// cgoCallRecord records that a call through fn took d nanoseconds.
+func cgoCallRecord(fn uintptr, d int64) {
+	if d > 1<<28 {
+		d = 1 << 28
+	}
+	c := cgoCallSiteSlot(fn)
+	if atomic.Loaduintptr(&c.fn) != fn {
+		atomic.Storeuintptr(&c.fn, fn)
+		atomic.Store(&c.avg, uint32(d)*8)
+		return
+	}
+	// Exponentially weighted, with weight 1/8 for the new sample.
+	avg := atomic.Load(&c.avg)
+	atomic.Store(&c.avg, avg-avg/8+uint32(d))
+}
+
+// cgoCallExpected returns how long retake should let _p_, in a
+// system call, stay with its M, or 0 if the system call is not a C
+// call through a function known to be short.
+func cgoCallExpected(_p_ *p) int64 {
+	fn := _p_.cgocallfn
+	if fn == 0 || _p_.cgocalltick != _p_.syscalltick {
+		return 0
+	}
+	c := cgoCallSiteSlot(fn)
+	if atomic.Loaduintptr(&c.fn) != fn {
+		return 0
+	}
+	avg := int64(atomic.Load(&c.avg) / 8)
+	if avg > cgoCallShort {
+		return 0
+	}
+	return 2 * avg
+}
+
+// Call from Go to a C function marked with a #cgo leaf: directive.
+// Such a function promises to return quickly, without blocking and
+// without calling back into Go, so we run it on the g0 stack without
+// telling the scheduler: no lockOSThread, no defer, and no
+// entersyscall/exitsyscall. The goroutine keeps its P and stays
+// Grunning for the whole call, so a garbage collection that needs
+// to stop the world waits for the C function to return.
 //go:nosplit
-func endcgo(mp *m) {
+func cgocallleaf(fn, arg unsafe.Pointer) int32 {
+	return cgocallleaf1(fn, arg, 0, getcallerpc(unsafe.Pointer(&fn)))
+}
+
+// Call from Go to a C function marked with a #cgo stack: directive,
+// a leaf function that also promises to use at most size bytes of
+// stack. Where asmcgocallstack is implemented, the function runs on
+// the goroutine's own stack, grown first if it lacks the room, which
+// saves the switch to the g0 stack and the cache misses on it in
+// tight loops of calls. Otherwise it is called as any leaf function.
+func cgocallstack(fn, arg unsafe.Pointer, size uintptr) int32 {
+	callerpc := getcallerpc(unsafe.Pointer(&fn))
+	if !cgoStackCalls || size > cgoStackCallMax {
+		return cgocallleaf1(fn, arg, 0, callerpc)
+	}
+	// Room for fn, the C wrapper that calls it, this frame,
+	// alignment and the red zone.
+	need := size + cgoStackCallSlack
+	gp := getg()
+	if sp := uintptr(unsafe.Pointer(&need)); sp < gp.stack.lo+need {
+		used := gp.stack.hi - sp
+		newsize := gp.stackAlloc
+		for newsize < used+need {
+			newsize *= 2
+		}
+		growstackto(newsize)
+		if sp := uintptr(unsafe.Pointer(&need)); sp < gp.stack.lo+need {
+			// Too big for a goroutine stack.
+			return cgocallleaf1(fn, arg, 0, callerpc)
+		}
+	}
+	return cgocallleaf1(fn, arg, need, callerpc)
+}
+
+const (
+	// cgoStackCallMax is the largest stack size that cmd/cgo
+	// accepts in a #cgo stack: directive.
+	cgoStackCallMax = 64 << 10
+
+	// cgoStackCallSlack is the goroutine stack that
+	// cgocallstack leaves free beyond the function's own use.
+	cgoStackCallSlack = 1024
+)
+
+// cgocallleaf1 makes a leaf call, for cgocallleaf and cgocallstack,
+// whose caller is at callerpc. If need is not zero, the call runs on
+// the goroutine stack if that still has need bytes free, and on the g0
+// stack otherwise.
+//go:nosplit
+func cgocallleaf1(fn, arg unsafe.Pointer, need, callerpc uintptr) int32 {
+	if !iscgo && GOOS != "solaris" && GOOS != "windows" {
+		throw("cgocall unavailable")
+	}
+
+	if fn == nil {
+		throw("cgocall nil")
+	}
+
+	if raceenabled {
+		racereleasemerge(racecgosyncaddr(uintptr(fn)))
+	}
+
+	mp := getg().m
+	mp.ncgocall++
+	mp.ncgo++
+	mp.cgoleaf = true
+
+	// Reset traceback.
+	mp.cgoCallers[0] = 0
+
+	profrate := cgoCallProfSampled(mp.ncgocall)
+	prof := profrate != 0
+	var start int64
+	if prof {
+		start = nanotime()
+	}
+
+	// The calls above may have been preempted, and the garbage
+	// collector may have shrunk the stack that cgocallstack grew,
+	// so check for room here, where nothing can move the stack
+	// before fn returns.
+	var errno int32
+	if need != 0 && uintptr(unsafe.Pointer(&errno)) >= getg().stack.lo+need {
+		errno = asmcgocallstack(fn, arg)
+	} else {
+		errno = asmcgocall(fn, arg)
+	}
+
+	mp.cgoleaf = false
 	mp.ncgo--
 
+	if prof {
+		cgoCallProfRecord(uintptr(fn), callerpc, nanotime()-start, profrate)
+	}
+
 	if raceenabled {
-		raceacquire(unsafe.Pointer(&racecgosync))
+		raceacquire(racecgosyncaddr(uintptr(fn)))
+	}
+
+	return errno
+}
+
+// A cgoLimit is the state of a limit set by a #cgo limit: directive on
+// the number of calls to a group of C functions that may be in C at
+// once. cmd/cgo declares one as a [2]uint32 for each limit and calls
+// cgoLimitAcquire before each call to the functions in the group and
+// cgoLimitRelease after it. A call beyond the limit parks its
+// goroutine on sema until another call returns, rather than taking a
+// thread of its own that would block in C as well.
+type cgoLimit struct {
+	calls uint32 // calls in C or waiting to enter it
+	sema  uint32
+}
+
+func cgoLimitAcquire(l *cgoLimit, n int32) {
+	if atomic.Xadd(&l.calls, 1) > uint32(n) {
+		semacquire(&l.sema, false)
 	}
+}
 
-	unlockOSThread() // invalidates mp
+func cgoLimitRelease(l *cgoLimit, n int32) {
+	// If more calls than the limit are counted, some are
+	// waiting: hand this one's place to one of them.
+	if atomic.Xadd(&l.calls, -1) >= uint32(n) {
+		semrelease(&l.sema)
+	}
+}
+
+// Call from Go to a C function marked with a #cgo async: directive.
+// Such a function may block for a long time, so instead of holding an
+// M for the whole call, as entersyscall does, the goroutine parks and
+// a thread from a bounded pool kept by runtime/cgo makes the call.
+// When the C function returns, the pool thread calls back into Go to
+// make the goroutine runnable again. The argument frame stays where
+// the caller put it, on the goroutine stack, which therefore must not
+// move until the goroutine runs again.
+//
+// A goroutine locked to its thread expects C to run on that thread,
+// so it makes an ordinary cgocall, as do all goroutines on systems
+// without the pool.
+func cgocallasync(fn, arg unsafe.Pointer) int32 {
+	gp := getg()
+	if _cgo_callpool_submit == nil || gp.lockedm != 0 {
+		return cgocall(fn, arg)
+	}
+
+	if fn == nil {
+		throw("cgocall nil")
+	}
+
+	if raceenabled {
+		racereleasemerge(racecgosyncaddr(uintptr(fn)))
+	}
+
+	gp.m.ncgocall++
+
+	c := new(cgoPoolCall)
+	c.fn = uintptr(fn)
+	c.arg = uintptr(arg)
+	if gp.stack.lo <= c.arg && c.arg < gp.stack.hi {
+		// The stack may still move before the goroutine
+		// parks; cgoPoolSubmit finds the frame again.
+		c.argoff = gp.stack.hi - c.arg
+	}
+	c.g.set(gp)
+	gp.cgoasync = true
+	gopark(cgoPoolSubmit, unsafe.Pointer(c), "cgo async call", traceEvGoBlock, 1)
+	gp.cgoasync = false
+
+	if raceenabled {
+		raceacquire(racecgosyncaddr(uintptr(fn)))
+	}
+
+	return c.errno
+}
+
+// cgoPoolSubmit hands c to the thread pool once gp has parked.
+// From here until c is done, both gp and c belong to the pool.
+func cgoPoolSubmit(gp *g, p unsafe.Pointer) bool {
+	c := (*cgoPoolCall)(p)
+	if c.argoff != 0 {
+		c.arg = gp.stack.hi - c.argoff
+	}
+	max := debug.cgoasyncthreads
+	if max <= 0 {
+		max = cgoPoolMaxThreads
+	}
+	args := struct {
+		c   *cgoPoolCall
+		max uintptr
+	}{c, uintptr(max)}
+	asmcgocall(_cgo_callpool_submit, unsafe.Pointer(&args))
+	return true
+}
+
+//go:nosplit
+func endcgo(mp *m) {
+	mp.ncgo--
+	fn := mp.cgocallfn
+	mp.cgocallfn = 0
+
+	if raceenabled {
+		raceacquire(racecgosyncaddr(fn))
+	}
 }
 
 // Helper functions for cgo code.
 
+// cmalloc allocates C memory for C.malloc, C.CString and C.CBytes.
+// It is an ordinary cgo call, not a leaf call: malloc, or an allocator
+// registered with GoSetCAllocator, may block on locks or in the kernel,
+// and must not hold up a stop-the-world while it does.
 func cmalloc(n uintptr) unsafe.Pointer {
 	var args struct {
 		n   uint64
@@ -157,13 +556,48 @@ func cmalloc(n uintptr) unsafe.Pointer {
 	if args.ret == nil {
 		throw("C malloc failed")
 	}
+	// Count the allocation in the P's mcache, like the heap's own
+	// stats, so that allocating C memory touches no shared state,
+	// and sample it for the C allocation profile as mallocgc
+	// samples the heap.
+	if c := getg().m.mcache; c != nil {
+		c.local_cmalloc += n
+		c.local_ncmalloc++
+		if rate := MemProfileRate; rate > 0 {
+			if n < uintptr(rate) && int32(n) < c.next_csample {
+				c.next_csample -= int32(n)
+			} else {
+				c.next_csample = nextSample()
+				mProf_CMalloc(n)
+			}
+		}
+	}
 	return args.ret
 }
 
+// cfree frees C memory from cmalloc. Like cmalloc, it is an ordinary
+// cgo call.
 func cfree(p unsafe.Pointer) {
-	cgocall(_cgo_free, p)
+	args := struct {
+		p unsafe.Pointer
+	}{p}
+	cgocall(_cgo_free, unsafe.Pointer(&args))
 }
 
+// cgoCallbackDirect is set in the frame size passed to cgocallback
+// for an exported function whose arguments and results are all
+// scalars. cmd/cgo then passes, instead of the function itself, a
+// wrapper that takes the address of the C frame as its only argument,
+// and cgocallbackg1 calls it without copying the frame with
+// reflectcall. Known to cmd/cgo.
+const cgoCallbackDirect = 1 << (8*sys.PtrSize - 1)
+
+// cgoCallbackSignal is set in the frame size passed to cgocallback by
+// badsignal, whose callback runs in a signal handler. cgocallbackg1
+// then leaves the g0 stack bounds that needm guessed alone, rather
+// than calling the C library to find them.
+const cgoCallbackSignal = 1 << (8*sys.PtrSize - 2)
+
 // Call from C back to Go.
 //go:nosplit
 func cgocallbackg(ctxt uintptr) {
@@ -172,6 +606,9 @@ func cgocallbackg(ctxt uintptr) {
 		println("runtime: bad g in cgocallback")
 		exit(2)
 	}
+	if gp.m.cgoleaf {
+		throw("cgo callback from a C function marked #cgo leaf:")
+	}
 
 	// Save current syscall parameters, so m.syscall can be
 	// used again if callback decide to make syscall.
@@ -183,13 +620,59 @@ func cgocallbackg(ctxt uintptr) {
 	// save syscall* and let reentersyscall restore them.
 	savedsp := unsafe.Pointer(gp.syscallsp)
 	savedpc := gp.syscallpc
+
+	if gp.m.cgobound && gp.m.ncgo == 0 {
+		// A C thread with a bound m calls in at whatever depth
+		// it likes, so the g0 stack bounds set by an earlier
+		// callback may not cover this one. Reset them the way
+		// needm does, around the g0 SP saved by cgocallback_gofunc.
+		g0 := gp.m.g0
+		setg0stack(g0, g0.sched.sp, true)
+	}
+
+	var start int64
+	timed := debug.cgocallbackstats > 0
+	if timed {
+		start = nanotime()
+	}
+
+	// The C frames that called us are on this m's g0 stack, so
+	// we must stay on this m. Lock g to m before exitsyscall,
+	// which would otherwise be free to move us to another m.
+	// unwindm undoes this, whether or not the callback panics.
+	lockOSThread()
+
 	exitsyscall(0) // coming out of cgo call
 
+	if timed {
+		cgoCallbackTime(&cgoCallbackStats.AcquireP, start)
+		start = nanotime()
+	}
+	if trace.enabled {
+		traceCgoCallback(gp.m.cgoneedmtime)
+	}
+	gp.m.cgoneedmtime = 0
+
 	cgocallbackg1(ctxt)
 
+	// At this point unlockOSThread has been called, but the C
+	// frames we return to are still on this m's g0 stack. Until
+	// reentersyscall, the code below must not split the stack or
+	// call anything that can, since that could reach the scheduler
+	// and move us to another m.
+
+	if timed {
+		cgoCallbackTime(&cgoCallbackStats.Func, start)
+		start = nanotime()
+	}
+
 	// going back to cgo call
 	reentersyscall(savedpc, uintptr(savedsp))
 
+	if timed {
+		cgoCallbackUnwind(gp.m, start)
+	}
+
 	gp.m.syscall = syscall
 }
 
@@ -221,7 +704,7 @@ func cgocallbackg1(ctxt uintptr) {
 		}(gp)
 	}
 
-	if gp.m.ncgo == 0 {
+	if gp.m.ncgo == 0 && atomic.Load(&mainInitDone) == 0 {
 		// The C call to Go came from a thread not currently running
 		// any Go. In the case of -buildmode=c-archive or c-shared,
 		// this call may be coming in before package initialization
@@ -234,7 +717,7 @@ func cgocallbackg1(ctxt uintptr) {
 	defer unwindm(&restore)
 
 	if raceenabled {
-		raceacquire(unsafe.Pointer(&racecgosync))
+		raceacquire(racecgosyncaddr(gp.m.cgocallfn))
 	}
 
 	type args struct {
@@ -292,23 +775,57 @@ func cgocallbackg1(ctxt uintptr) {
 		cb = (*args)(unsafe.Pointer(sp + 4*sys.PtrSize))
 	}
 
+	if gp.m.g0stackguess && _cgo_getstackbounds != nil && cb.argsize&cgoCallbackSignal == 0 {
+		// needm could only guess the g0 stack bounds; now that
+		// we know we are not in a signal handler, find them.
+		g0 := gp.m.g0
+		setg0stack(g0, g0.sched.sp, true)
+	}
+
+	// Give the goroutine the stack that this function needed last
+	// time, so that it does not grow it one doubling at a time.
+	fn := cb.fn.fn
+	if size := cgoStackHint(fn); size > gp.stackAlloc {
+		growstackto(size)
+	}
+
 	// Invoke callback.
 	// NOTE(rsc): passing nil for argtype means that the copying of the
 	// results back into cb.arg happens without any corresponding write barriers.
 	// For cgo, cb.arg points into a C stack frame and therefore doesn't
 	// hold any pointers that the GC can find anyway - the write barrier
 	// would be a no-op.
-	reflectcall(nil, unsafe.Pointer(cb.fn), cb.arg, uint32(cb.argsize), 0)
+	argsize := cb.argsize &^ (cgoCallbackDirect | cgoCallbackSignal)
+	cgoFlight(gp.m, cgoFlightCallback, fn)
+	if cb.argsize&cgoCallbackDirect != 0 {
+		// The function reads its arguments from the frame and
+		// writes its results there itself, so there is no frame
+		// to copy.
+		direct := *(*func(unsafe.Pointer))(unsafe.Pointer(&cb.fn))
+		direct(cb.arg)
+	} else {
+		reflectcall(nil, unsafe.Pointer(cb.fn), cb.arg, uint32(argsize), 0)
+	}
+	cgoFlight(gp.m, cgoFlightCallbackDone, fn)
+
+	cgoStackRecord(fn, gp.stackAlloc)
 
 	if raceenabled {
-		racereleasemerge(unsafe.Pointer(&racecgosync))
+		racereleasemerge(racecgosyncaddr(gp.m.cgocallfn))
 	}
 	if msanenabled {
 		// Tell msan that we wrote to the entire argument block.
 		// This tells msan that we set the results.
 		// Since we have already called the function it doesn't
 		// matter that we are writing to the non-result parameters.
-		msanwrite(cb.arg, cb.argsize)
+		msanwrite(cb.arg, argsize)
+	}
+
+	// End the callback in the trace while g is still locked to
+	// this m; once unwindm unlocks it, a stack split could move
+	// it to another m before cgocallbackg reenters the syscall.
+	if trace.enabled {
+		traceCgoCallbackEnd()
 	}
 
 	// Do not unwind m->g0->sched.sp.
@@ -316,23 +833,76 @@ func cgocallbackg1(ctxt uintptr) {
 	restore = false
 }
 
-func unwindm(restore *bool) {
-	if !*restore {
+// cgoStackHints remembers, for the Go functions exported to C, the
+// size that their goroutine's stack had grown to when they last
+// returned. Callbacks run on the goroutine of whatever M they get,
+// and each extra M's goroutine starts with a minimum-sized stack,
+// so without the hint every new M pays for each doubling again.
+// The table is direct-mapped on the function's address; when two
+// functions collide, the most recent one wins. The entries are
+// read and written without a lock, so a racing update can pair a
+// function with another one's size. That only affects the hint.
+var cgoStackHints [64]cgoStackHintEntry
+
+type cgoStackHintEntry struct {
+	fn   uintptr
+	size uintptr
+}
+
+func cgoStackHintSlot(fn uintptr) *cgoStackHintEntry {
+	return &cgoStackHints[(fn/sys.PtrSize)%uintptr(len(cgoStackHints))]
+}
+
+// cgoStackHint returns the stack size to use for calling fn from C,
+// or 0 if there is none.
+func cgoStackHint(fn uintptr) uintptr {
+	h := cgoStackHintSlot(fn)
+	if atomic.Loaduintptr(&h.fn) != fn {
+		return 0
+	}
+	return atomic.Loaduintptr(&h.size)
+}
+
+// cgoStackRecord records that fn returned with a stack of size bytes.
+func cgoStackRecord(fn, size uintptr) {
+	if size <= _FixedStack {
 		return
 	}
-	// Restore sp saved by cgocallback during
-	// unwind of g's stack (see comment at top of file).
-	mp := acquirem()
-	sched := &mp.g0.sched
-	switch GOARCH {
-	default:
-		throw("unwindm not implemented")
-	case "386", "amd64", "arm", "ppc64", "ppc64le", "mips64", "mips64le", "s390x":
-		sched.sp = *(*uintptr)(unsafe.Pointer(sched.sp + sys.MinFrameSize))
-	case "arm64":
-		sched.sp = *(*uintptr)(unsafe.Pointer(sched.sp + 16))
+	h := cgoStackHintSlot(fn)
+	if atomic.Loaduintptr(&h.fn) == fn && atomic.Loaduintptr(&h.size) >= size {
+		return
 	}
-	releasem(mp)
+	atomic.Storeuintptr(&h.fn, fn)
+	atomic.Storeuintptr(&h.size, size)
+}
+
+func unwindm(restore *bool) {
+	if *restore {
+		// Restore sp saved by cgocallback during
+		// unwind of g's stack (see comment at top of file).
+		mp := acquirem()
+		sched := &mp.g0.sched
+		switch GOARCH {
+		default:
+			throw("unwindm not implemented")
+		case "386", "amd64", "arm", "ppc64", "ppc64le", "mips64", "mips64le", "s390x":
+			sched.sp = *(*uintptr)(unsafe.Pointer(sched.sp + sys.MinFrameSize))
+		case "arm64":
+			sched.sp = *(*uintptr)(unsafe.Pointer(sched.sp + 16))
+		}
+
+		// We are unwinding past the cgocall that made the C
+		// call, which will not get to call endcgo itself.
+		// If the call to Go came from C code not called from
+		// Go, ncgo is 0 and there is no cgocall to end.
+		if mp.ncgo > 0 {
+			endcgo(mp)
+		}
+		releasem(mp)
+	}
+
+	// Undo the call to lockOSThread in cgocallbackg.
+	unlockOSThread()
 }
 
 // called from assembly
@@ -345,7 +915,27 @@ func cgounimpl() {
 	throw("cgo not implemented")
 }
 
-var racecgosync uint64 // represents possible synchronization in C code
+// racecgosync represents possible synchronization in C code. Each call
+// into C releases it as it starts and acquires it as it returns, and
+// each callback into Go the other way around. With
+// GODEBUG=cgoracesync=1, calls and their callbacks use instead the
+// slot of racecgosyncs for the C function called, so that threads
+// calling different C functions do not contend for one object in the
+// race runtime. Callbacks on threads not in a call from Go still use
+// racecgosync.
+var racecgosync uint64
+
+var racecgosyncs [256]uint64
+
+// racecgosyncaddr returns the sync object for the race detector of a
+// call to the C function fn, or of a callback from it; see racecgosync.
+//go:nosplit
+func racecgosyncaddr(fn uintptr) unsafe.Pointer {
+	if debug.cgoracesync == 0 || fn == 0 {
+		return unsafe.Pointer(&racecgosync)
+	}
+	return unsafe.Pointer(&racecgosyncs[(fn>>4^fn>>12)%uintptr(len(racecgosyncs))])
+}
 
 // Pointer checking for cgo code.
 
@@ -380,10 +970,21 @@ var racecgosync uint64 // represents possible synchronization in C code
 // cgoCheckPointer checks if the argument contains a Go pointer that
 // points to a Go pointer, and panics if it does. It returns the pointer.
 func cgoCheckPointer(ptr interface{}, args ...interface{}) interface{} {
-	if debug.cgocheck == 0 {
+	if debug.cgocheck == 0 || !cgoCheckSampled() {
 		return ptr
 	}
+	if debug.cgocallbackstats > 0 {
+		start := nanotime()
+		cgoCheckPointer1(ptr, args)
+		cgoCheckTime(start)
+		return ptr
+	}
+	cgoCheckPointer1(ptr, args)
+	return ptr
+}
 
+// cgoCheckPointer1 is the body of cgoCheckPointer.
+func cgoCheckPointer1(ptr interface{}, args []interface{}) {
 	ep := (*eface)(unsafe.Pointer(&ptr))
 	t := ep._type
 
@@ -394,7 +995,7 @@ func cgoCheckPointer(ptr interface{}, args ...interface{}) interface{} {
 			p = *(*unsafe.Pointer)(p)
 		}
 		if !cgoIsGoPointer(p) {
-			return ptr
+			return
 		}
 		aep := (*eface)(unsafe.Pointer(&args[0]))
 		switch aep._type.kind & kindMask {
@@ -405,7 +1006,7 @@ func cgoCheckPointer(ptr interface{}, args ...interface{}) interface{} {
 			}
 			pt := (*ptrtype)(unsafe.Pointer(t))
 			cgoCheckArg(pt.elem, p, true, false, cgoCheckPointerFail)
-			return ptr
+			return
 		case kindSlice:
 			// Check the slice rather than the pointer.
 			ep = aep
@@ -423,7 +1024,6 @@ func cgoCheckPointer(ptr interface{}, args ...interface{}) interface{} {
 	}
 
 	cgoCheckArg(t, ep.data, t.kind&kindDirectIface == 0, top, cgoCheckPointerFail)
-	return ptr
 }
 
 const cgoCheckPointerFail = "cgo argument has Go pointer to Go pointer"
@@ -483,7 +1083,7 @@ func cgoCheckArg(t *_type, p unsafe.Pointer, indir, top bool, msg string) {
 		if !cgoIsGoPointer(p) {
 			return
 		}
-		if !top {
+		if !top && !isPinned(p) {
 			panic(errorString(msg))
 		}
 		cgoCheckArg(it, p, it.kind&kindDirectIface == 0, false, msg)
@@ -494,7 +1094,7 @@ func cgoCheckArg(t *_type, p unsafe.Pointer, indir, top bool, msg string) {
 		if !cgoIsGoPointer(p) {
 			return
 		}
-		if !top {
+		if !top && !isPinned(p) {
 			panic(errorString(msg))
 		}
 		if st.elem.kind&kindNoPointers != 0 {
@@ -509,7 +1109,7 @@ func cgoCheckArg(t *_type, p unsafe.Pointer, indir, top bool, msg string) {
 		if !cgoIsGoPointer(ss.str) {
 			return
 		}
-		if !top {
+		if !top && !isPinned(ss.str) {
 			panic(errorString(msg))
 		}
 	case kindStruct:
@@ -532,7 +1132,7 @@ func cgoCheckArg(t *_type, p unsafe.Pointer, indir, top bool, msg string) {
 		if !cgoIsGoPointer(p) {
 			return
 		}
-		if !top {
+		if !top && !isPinned(p) {
 			panic(errorString(msg))
 		}
 
@@ -568,7 +1168,8 @@ func cgoCheckUnknownPointer(p unsafe.Pointer, msg string) (base, i uintptr) {
 				break
 			}
 			if hbits.isPointer() {
-				if cgoIsGoPointer(*(*unsafe.Pointer)(unsafe.Pointer(base + i))) {
+				pp := *(*unsafe.Pointer)(unsafe.Pointer(base + i))
+				if cgoIsGoPointer(pp) && !isPinned(pp) {
 					panic(errorString(msg))
 				}
 			}
@@ -578,15 +1179,13 @@ func cgoCheckUnknownPointer(p unsafe.Pointer, msg string) (base, i uintptr) {
 		return
 	}
 
-	for datap := &firstmoduledata; datap != nil; datap = datap.next {
-		if cgoInRange(p, datap.data, datap.edata) || cgoInRange(p, datap.bss, datap.ebss) {
-			// We have no way to know the size of the object.
-			// We have to assume that it might contain a pointer.
-			panic(errorString(msg))
-		}
-		// In the text or noptr sections, we know that the
-		// pointer does not point to a Go pointer.
+	if cgoInModuleData(p) {
+		// We have no way to know the size of the object.
+		// We have to assume that it might contain a pointer.
+		panic(errorString(msg))
 	}
+	// In the text or noptr sections, we know that the
+	// pointer does not point to a Go pointer.
 
 	return
 }
@@ -605,13 +1204,113 @@ func cgoIsGoPointer(p unsafe.Pointer) bool {
 		return true
 	}
 
+	return cgoInModuleData(p)
+}
+
+// cgoDataRange is a range of module memory that may hold pointers: a
+// data or BSS section, or adjacent ones merged.
+type cgoDataRange struct {
+	start, end uintptr
+}
+
+// cgoDataIndex is the data and BSS sections of all modules, sorted by
+// address and merged where adjacent, for cgoInModuleData. min and max
+// bound all of them, so that the common case of a C pointer outside
+// them is one comparison.
+type cgoDataIndex struct {
+	min, max uintptr
+	n        int
+	ranges   *[1 << 20]cgoDataRange
+}
+
+// cgoDataIndexp is the current cgoDataIndex, replaced as a whole when
+// modules are added, as readers do not lock. Indexes are allocated
+// with persistentalloc, so a reader may keep using a replaced one.
+var cgoDataIndexp *cgoDataIndex
+
+// cgoDataIndexInit builds cgoDataIndexp from the module list. It is
+// called from schedinit and addmodules, which do not run
+// concurrently with one another.
+func cgoDataIndexInit() {
+	n := 0
+	for datap := &firstmoduledata; datap != nil; datap = datap.next {
+		n += 2
+	}
+	x := (*cgoDataIndex)(persistentalloc(unsafe.Sizeof(cgoDataIndex{})+uintptr(n)*unsafe.Sizeof(cgoDataRange{}), sys.PtrSize, &memstats.other_sys))
+	x.ranges = (*[1 << 20]cgoDataRange)(add(unsafe.Pointer(x), unsafe.Sizeof(cgoDataIndex{})))
+	r := x.ranges[:0:n]
+	insert := func(start, end uintptr) {
+		if start == end {
+			return
+		}
+		// Insertion sort: there are few modules.
+		r = r[:len(r)+1]
+		i := len(r) - 1
+		for ; i > 0 && r[i-1].start > start; i-- {
+			r[i] = r[i-1]
+		}
+		r[i] = cgoDataRange{start, end}
+	}
 	for datap := &firstmoduledata; datap != nil; datap = datap.next {
-		if cgoInRange(p, datap.data, datap.edata) || cgoInRange(p, datap.bss, datap.ebss) {
-			return true
+		insert(datap.data, datap.edata)
+		insert(datap.bss, datap.ebss)
+	}
+	k := 0
+	for i := range r {
+		if k > 0 && r[k-1].end >= r[i].start {
+			if r[i].end > r[k-1].end {
+				r[k-1].end = r[i].end
+			}
+			continue
+		}
+		r[k] = r[i]
+		k++
+	}
+	x.n = k
+	if k > 0 {
+		x.min, x.max = r[0].start, r[k-1].end
+	}
+	atomic.StorepNoWB(unsafe.Pointer(&cgoDataIndexp), unsafe.Pointer(x))
+}
+
+// cgoInModuleData returns whether p points into the data or BSS
+// section of a module.
+//go:nosplit
+//go:nowritebarrierrec
+func cgoInModuleData(p unsafe.Pointer) bool {
+	x := (*cgoDataIndex)(atomic.Loadp(unsafe.Pointer(&cgoDataIndexp)))
+	if x == nil {
+		// Before schedinit.
+		for datap := &firstmoduledata; datap != nil; datap = datap.next {
+			if cgoInRange(p, datap.data, datap.edata) || cgoInRange(p, datap.bss, datap.ebss) {
+				return true
+			}
+		}
+		return false
+	}
+	if !cgoInRange(p, x.min, x.max) {
+		return false
+	}
+	// Find the last range starting at or before p.
+	i, j := 0, x.n
+	for i < j {
+		h := int(uint(i+j) >> 1)
+		if x.ranges[h].start <= uintptr(p) {
+			i = h + 1
+		} else {
+			j = h
 		}
 	}
+	return i > 0 && uintptr(p) < x.ranges[i-1].end
+}
 
-	return false
+// cgoCheckPointerNeeded reports whether a pointer argument of a cgo
+// call must be passed to cgoCheckPointer: whether checking is enabled
+// and p is a Go pointer. cmd/cgo calls it from the pointer checks it
+// specializes by argument type, so that the common case of passing a
+// nil or C pointer avoids converting the argument to an interface.
+func cgoCheckPointerNeeded(p unsafe.Pointer) bool {
+	return debug.cgocheck != 0 && cgoIsGoPointer(p)
 }
 
 // cgoInRange returns whether p is between start and end.
@@ -625,11 +1324,18 @@ func cgoInRange(p unsafe.Pointer, start, end uintptr) bool {
 // exported Go function. It panics if the result is or contains a Go
 // pointer.
 func cgoCheckResult(val interface{}) {
-	if debug.cgocheck == 0 {
+	if debug.cgocheck == 0 || !cgoCheckSampled() {
 		return
 	}
+	var start int64
+	if debug.cgocallbackstats > 0 {
+		start = nanotime()
+	}
 
 	ep := (*eface)(unsafe.Pointer(&val))
 	t := ep._type
 	cgoCheckArg(t, ep.data, t.kind&kindDirectIface == 0, false, cgoResultFail)
+	if start != 0 {
+		cgoCheckTime(start)
+	}
 }
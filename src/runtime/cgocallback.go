@@ -4,6 +4,11 @@
 
 package runtime
 
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
 // These functions are called from C code via cgo/callbacks.go.
 
 // Panic.
@@ -11,3 +16,202 @@ package runtime
 func _cgo_panic_internal(p *byte) {
 	panic(gostringnocopy(p))
 }
+
+// Batched calls, for GoInvokeVector.
+
+// cgoCall is a call to an exported Go function, as set up by the
+// Name_call function that cmd/cgo writes for each export.
+// Known to cmd/cgo and runtime/cgo as GoCall.
+type cgoCall struct {
+	fn    *funcval
+	frame unsafe.Pointer
+	size  int32
+}
+
+func _cgo_invoke_vector_internal(calls *cgoCall, n int) {
+	// With msan, the frames written by the calls are marked
+	// written a run of adjacent frames at a time, as C code that
+	// fills in an array of frames passes them, rather than one
+	// frame at a time.
+	var msanlo, msanhi uintptr
+	for i := 0; i < n; i++ {
+		c := (*cgoCall)(add(unsafe.Pointer(calls), uintptr(i)*unsafe.Sizeof(*calls)))
+		// As in cgocallbackg1, the frame is in C memory, so the
+		// results are copied back without write barriers.
+		reflectcall(nil, unsafe.Pointer(c.fn), c.frame, uint32(c.size), 0)
+		if msanenabled {
+			lo := uintptr(c.frame)
+			if lo != msanhi {
+				if msanhi != msanlo {
+					msanwrite(unsafe.Pointer(msanlo), msanhi-msanlo)
+				}
+				msanlo = lo
+			}
+			msanhi = lo + uintptr(c.size)
+		}
+	}
+	if msanenabled && msanhi != msanlo {
+		msanwrite(unsafe.Pointer(msanlo), msanhi-msanlo)
+	}
+}
+
+// Asynchronous calls, for GoInvokeAsync.
+
+// cgoAsyncCall is a call queued by GoInvokeAsync, in C memory.
+// Known to runtime/cgo as AsyncCall.
+type cgoAsyncCall struct {
+	next *cgoAsyncCall
+	call cgoCall
+}
+
+var cgoAsyncStarted uint32
+
+// cgoAsyncG is the goroutine running cgoAsyncLoop. It waits in C
+// without being busy there; see _cgo_release_internal.
+var cgoAsyncG guintptr
+
+// _cgo_async_start_internal is called once, on the first call to
+// GoInvokeAsync, to start the goroutine that runs queued calls.
+func _cgo_async_start_internal() {
+	if atomic.Cas(&cgoAsyncStarted, 0, 1) {
+		go cgoAsyncLoop()
+	}
+}
+
+// cgoAsyncLoop runs the calls queued by GoInvokeAsync, in order.
+// While the queue is empty it waits in C, holding an M but no P.
+func cgoAsyncLoop() {
+	var args struct {
+		done *cgoAsyncCall
+		next *cgoAsyncCall
+	}
+	cgoAsyncG.set(getg())
+	for {
+		cgocall(_cgo_async_wait, unsafe.Pointer(&args))
+		for c := args.next; c != nil; c = c.next {
+			reflectcall(nil, unsafe.Pointer(c.call.fn), c.call.frame, uint32(c.call.size), 0)
+		}
+		// Give the calls back to C to free on the next wait.
+		args.done = args.next
+		args.next = nil
+	}
+}
+
+// Calls on the cgo thread pool, for cgocallasync.
+
+// cgoPoolMaxThreads is the default limit on the number of threads
+// in the pool, which GODEBUG=cgoasyncthreads=N overrides.
+const cgoPoolMaxThreads = 64
+
+// cgoPoolCall is a call that a pool thread makes for a parked
+// goroutine. It is kept in the Go heap by that goroutine, and the C
+// code sees it only as a uintptr. Known to runtime/cgo as PoolCall.
+type cgoPoolCall struct {
+	fn     uintptr
+	arg    uintptr
+	next   uintptr // used by runtime/cgo
+	g      guintptr
+	argoff uintptr // offset of arg from the top of g's stack, or 0
+	errno  int32
+}
+
+// _cgo_callpool_done_internal is called by a pool thread when the
+// C function of the call c has returned. The pool thread drops its M
+// right after, and the P it borrowed for the callback goes with the
+// goroutine, instead of staying idle in a system call.
+func _cgo_callpool_done_internal(c uintptr) {
+	getg().m.cgohandoffp = true
+	goready((*cgoPoolCall)(unsafe.Pointer(c)).g.ptr(), 0)
+}
+
+// Registration of C threads.
+
+// _cgo_register_thread_internal is called by GoRegisterThread to bind
+// the extra M lent to the calling C thread to it until the thread
+// exits or calls GoUnregisterThread; see cgobindm. It sets *ok if the
+// M is bound.
+func _cgo_register_thread_internal(ok *int32) {
+	mp := getg().m
+	if mp.extranode == nil || _cgo_bindm == nil {
+		return
+	}
+	if !mp.cgobound {
+		cgobindm(mp)
+	}
+	if mp.cgobound {
+		*ok = 1
+	}
+}
+
+// Package initialization of libraries sharing the runtime.
+
+// _cgo_init_modules_internal is called from the constructor of each
+// library built with -buildmode=c-shared -linkshared but the first,
+// once the runtime is running; see libstart.
+func _cgo_init_modules_internal() {
+	addmodules()
+}
+
+// Callbacks, for runtime/cgo.NewCallback.
+
+// Number of arguments and slots of the callbacks. Keep in sync with
+// runtime/cgo.CallbackArgs and runtime/cgo.MaxCallbacks.
+const (
+	cgoCallbackArgs = 6
+	maxCgoCallbacks = 256
+)
+
+// cgoCallbacks holds the Go functions of the callbacks, in the slots
+// of the C functions in runtime/cgo/gcc_trampoline.c that call them.
+// The lock serializes making and freeing callbacks; calls read a slot
+// without it, since C code gets the function pointer of a slot only
+// after the slot is set, and must stop calling it before it is freed.
+var cgoCallbacks struct {
+	lock mutex
+	fn   [maxCgoCallbacks]func(*[cgoCallbackArgs]uintptr) uintptr
+}
+
+// cgoNewCallback puts fn in a free slot of cgoCallbacks and returns
+// its index, or -1 if there is none.
+func cgoNewCallback(fn func(*[cgoCallbackArgs]uintptr) uintptr) int {
+	lock(&cgoCallbacks.lock)
+	for i := range cgoCallbacks.fn {
+		if cgoCallbacks.fn[i] == nil {
+			cgoCallbacks.fn[i] = fn
+			unlock(&cgoCallbacks.lock)
+			return i
+		}
+	}
+	unlock(&cgoCallbacks.lock)
+	return -1
+}
+
+// cgoFreeCallback frees slot i of cgoCallbacks.
+func cgoFreeCallback(i int) {
+	lock(&cgoCallbacks.lock)
+	if cgoCallbacks.fn[i] == nil {
+		unlock(&cgoCallbacks.lock)
+		panic("cgo: FreeCallback of freed callback")
+	}
+	cgoCallbacks.fn[i] = nil
+	unlock(&cgoCallbacks.lock)
+}
+
+// cgoTrampolineCall is a call of a callback, on the C stack of the
+// C function of slot index. Known to runtime/cgo as TrampolineCall.
+type cgoTrampolineCall struct {
+	index uintptr
+	args  [cgoCallbackArgs]uintptr
+	ret   uintptr
+}
+
+// _cgo_trampoline_internal runs the call c of a callback. The
+// arguments are passed to the Go function where they are, in C
+// memory, so that they do not escape to the heap.
+func _cgo_trampoline_internal(c *cgoTrampolineCall) {
+	fn := cgoCallbacks.fn[c.index]
+	if fn == nil {
+		throw("cgo: call of freed callback")
+	}
+	c.ret = fn(&c.args)
+}
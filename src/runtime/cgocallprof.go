@@ -0,0 +1,149 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Profile of calls from Go to C, by cgo call site.
+
+package runtime
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+// cgoCallProfileRate is the fraction of calls from Go to C that are
+// recorded: one in cgoCallProfileRate calls on each M, or none if 0.
+var cgoCallProfileRate uint32
+
+// SetCgoCallProfileRate controls the fraction of calls from Go to C
+// that are reported in the cgo call profile. The profiler records,
+// on each thread, one call in rate, and counts it as rate calls of
+// rate times its duration, so that the profile estimates the total
+// number of calls and the total time spent in C for each call site.
+//
+// To include every call in the profile, pass rate = 1.
+// To turn off profiling entirely, pass rate <= 0.
+// Turning profiling off keeps the calls recorded so far.
+func SetCgoCallProfileRate(rate int) {
+	if rate < 0 {
+		rate = 0
+	}
+	if rate > 1<<30 {
+		rate = 1 << 30
+	}
+	atomic.Store(&cgoCallProfileRate, uint32(rate))
+}
+
+// CgoCallProfileRecord describes the calls from Go to C made
+// at a particular call site.
+type CgoCallProfileRecord struct {
+	Count       int64 // number of calls
+	Nanoseconds int64 // total wall time spent in C
+	StackRecord       // the cgo-generated Go wrapper of the C function
+}
+
+// CgoCallProfile returns n, the number of records in the current cgo
+// call profile. If len(p) >= n, CgoCallProfile copies the profile into
+// p and returns n, true. If len(p) < n, CgoCallProfile does not change
+// p and returns n, false.
+//
+// Each record's stack holds a single PC, in the function that cgo
+// generated to call the C function, named _Cfunc_ followed by the
+// name of the C function; on Windows and Solaris, system calls made
+// with the syscall package are reported as well.
+//
+// Most clients should use the runtime/pprof package instead
+// of calling CgoCallProfile directly.
+func CgoCallProfile(p []CgoCallProfileRecord) (n int, ok bool) {
+	for i := range cgoCallProf {
+		if atomic.Loaduintptr(&cgoCallProf[i].pc) != 0 {
+			n++
+		}
+	}
+	if n > len(p) {
+		return n, false
+	}
+	j := 0
+	for i := range cgoCallProf {
+		b := &cgoCallProf[i]
+		pc := atomic.Loaduintptr(&b.pc)
+		if pc == 0 {
+			continue
+		}
+		if j == n {
+			// A site was added while we were counting.
+			break
+		}
+		r := &p[j]
+		r.Count = int64(atomic.Load64(&b.count))
+		r.Nanoseconds = int64(atomic.Load64(&b.ns))
+		r.Stack0 = [len(r.Stack0)]uintptr{pc}
+		j++
+	}
+	return j, true
+}
+
+// cgoCallProf is the cgo call profile, an open-addressed hash table
+// keyed by the C function wrapper passed to cgocall. It is a fixed-size
+// table of counters updated with atomic operations, so that recording
+// a call takes no locks; once it fills up, further call sites are
+// counted in the last bucket, recorded with the stack of cgoCallProfOther.
+var cgoCallProf [512]cgoCallProfBucket
+
+type cgoCallProfBucket struct {
+	count uint64 // must be 64-bit aligned
+	ns    uint64
+	fn    uintptr
+	pc    uintptr // set after fn, once the bucket is ready
+}
+
+// cgoCallProfSampled returns the profiling rate if the n'th cgo call
+// made on an M should be recorded in the cgo call profile, or else 0.
+// It is kept out of cgocall, which is nosplit and so cannot
+// divide on systems that do division in software.
+func cgoCallProfSampled(n uint64) uint32 {
+	rate := atomic.Load(&cgoCallProfileRate)
+	if rate == 0 || uint32(n)%rate != 0 {
+		return 0
+	}
+	return rate
+}
+
+// cgoCallProfRecord records a call through the C function wrapper fn,
+// made by the Go function containing pc, that took d nanoseconds and
+// stands for rate calls.
+func cgoCallProfRecord(fn, pc uintptr, d int64, rate uint32) {
+	const nsite = uintptr(len(cgoCallProf) - 1)
+	h := (fn / unsafe.Sizeof(uintptr(0))) % nsite
+	for i := uintptr(0); i < nsite; i++ {
+		b := &cgoCallProf[h]
+		f := atomic.Loaduintptr(&b.fn)
+		if f == 0 && atomic.Casuintptr(&b.fn, 0, fn) {
+			atomic.Storeuintptr(&b.pc, pc)
+			f = fn
+		}
+		if f == fn {
+			cgoCallProfAdd(b, d, rate)
+			return
+		}
+		h++
+		if h == nsite {
+			h = 0
+		}
+	}
+	b := &cgoCallProf[len(cgoCallProf)-1]
+	if atomic.Loaduintptr(&b.pc) == 0 {
+		atomic.Casuintptr(&b.fn, 0, ^uintptr(0))
+		atomic.Storeuintptr(&b.pc, funcPC(cgoCallProfOther)+1)
+	}
+	cgoCallProfAdd(b, d, rate)
+}
+
+func cgoCallProfAdd(b *cgoCallProfBucket, d int64, rate uint32) {
+	atomic.Xadd64(&b.count, int64(rate))
+	atomic.Xadd64(&b.ns, d*int64(rate))
+}
+
+// cgoCallProfOther is never called; it names the bucket that counts
+// the calls made at sites for which the profile had no room.
+func cgoCallProfOther() {}
@@ -0,0 +1,16 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime
+
+import "unsafe"
+
+// cgoStackCalls reports whether asmcgocallstack runs C functions on
+// the goroutine stack; see cgocallstack.
+const cgoStackCalls = true
+
+// asmcgocallstack calls fn(arg) on the current goroutine stack,
+// which the caller has made sure has room for fn.
+//go:noescape
+func asmcgocallstack(fn, arg unsafe.Pointer) int32
@@ -0,0 +1,18 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !amd64
+
+package runtime
+
+import "unsafe"
+
+// cgoStackCalls reports whether asmcgocallstack runs C functions on
+// the goroutine stack; see cgocallstack.
+const cgoStackCalls = false
+
+//go:nosplit
+func asmcgocallstack(fn, arg unsafe.Pointer) int32 {
+	return asmcgocall(fn, arg)
+}
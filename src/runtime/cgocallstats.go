@@ -0,0 +1,80 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Latency histograms for calls from C to Go, for GODEBUG=cgocallbackstats=1.
+
+package runtime
+
+import "runtime/internal/atomic"
+
+// CgoCallbackBuckets is the number of buckets in each histogram
+// of CgoCallbackStats.
+const CgoCallbackBuckets = 40
+
+// CgoCallbackStats records how long the phases of calls from C to Go
+// take. It is filled in by ReadCgoCallbackStats.
+//
+// Each histogram counts phases by duration: bucket 0 counts phases that
+// took no measurable time, bucket i, for 0 < i < CgoCallbackBuckets-1,
+// counts phases that took at least 1<<(i-1) and less than 1<<i
+// nanoseconds, and the last bucket counts all longer phases.
+type CgoCallbackStats struct {
+	// NeedM is the time a thread not created by Go spends
+	// getting an M to run the call on, and setting it up.
+	NeedM [CgoCallbackBuckets]uint64
+
+	// AcquireP is the time spent waiting for a P
+	// before the Go function can run.
+	AcquireP [CgoCallbackBuckets]uint64
+
+	// Func is the time spent running the Go function,
+	// including any wait for package initialization in
+	// -buildmode=c-archive or c-shared programs.
+	Func [CgoCallbackBuckets]uint64
+
+	// Unwind is the time from the return of the Go function until
+	// control returns to C, including releasing the P and, for a
+	// thread not created by Go, returning the M.
+	Unwind [CgoCallbackBuckets]uint64
+}
+
+var cgoCallbackStats CgoCallbackStats
+
+// ReadCgoCallbackStats fills stats with the latency histograms of the
+// calls from C to Go made so far. The histograms are recorded only if
+// the program runs with GODEBUG=cgocallbackstats=1; otherwise they are
+// all zero.
+func ReadCgoCallbackStats(stats *CgoCallbackStats) {
+	for i := range stats.NeedM {
+		stats.NeedM[i] = atomic.Load64(&cgoCallbackStats.NeedM[i])
+		stats.AcquireP[i] = atomic.Load64(&cgoCallbackStats.AcquireP[i])
+		stats.Func[i] = atomic.Load64(&cgoCallbackStats.Func[i])
+		stats.Unwind[i] = atomic.Load64(&cgoCallbackStats.Unwind[i])
+	}
+}
+
+// cgoCallbackTime adds the phase that started at start
+// to the histogram h. It may run without an m or g.
+//go:nosplit
+func cgoCallbackTime(h *[CgoCallbackBuckets]uint64, start int64) {
+	d := nanotime() - start
+	i := 0
+	for d > 0 && i < CgoCallbackBuckets-1 {
+		d >>= 1
+		i++
+	}
+	atomic.Xadd64(&h[i], 1)
+}
+
+// cgoCallbackUnwind records the unwind phase of a callback on mp,
+// which started at start. If the callback is about to give up mp,
+// dropm records the phase once mp is back on the extra list.
+//go:nosplit
+func cgoCallbackUnwind(mp *m, start int64) {
+	if mp.extranode != nil && !mp.cgobound && mp.ncgo == 0 {
+		mp.cgounwind = start
+		return
+	}
+	cgoCallbackTime(&cgoCallbackStats.Unwind, start)
+}
@@ -14,12 +14,24 @@ import (
 
 const cgoWriteBarrierFail = "Go pointer stored into non-Go memory"
 
+// cgoCheckSampled reports whether to make a check that cgocheck
+// enables: always, unless GODEBUG=cgochecksample=N samples one check
+// in about N.
+//go:nosplit
+func cgoCheckSampled() bool {
+	n := debug.cgochecksample
+	// fastrand1()*n < 1<<32 holds with probability 1/n, and unlike
+	// fastrand1()%n it needs no division, which is not allowed in a
+	// nosplit function on systems that divide in software.
+	return n <= 1 || uint64(fastrand1())*uint64(n) < 1<<32
+}
+
 // cgoCheckWriteBarrier is called whenever a pointer is stored into memory.
 // It throws if the program is storing a Go pointer into non-Go memory.
 //go:nosplit
 //go:nowritebarrier
 func cgoCheckWriteBarrier(dst *uintptr, src uintptr) {
-	if !cgoIsGoPointer(unsafe.Pointer(src)) {
+	if !cgoCheckSampled() || !cgoIsGoPointer(unsafe.Pointer(src)) {
 		return
 	}
 	if cgoIsGoPointer(unsafe.Pointer(dst)) {
@@ -40,6 +52,10 @@ func cgoCheckWriteBarrier(dst *uintptr, src uintptr) {
 	}
 
 	systemstack(func() {
+		// A pointer to a pinned object may be stored anywhere.
+		if isPinned(unsafe.Pointer(src)) {
+			return
+		}
 		println("write of Go pointer", hex(src), "to non-Go memory", hex(uintptr(unsafe.Pointer(dst))))
 		throw(cgoWriteBarrierFail)
 	})
@@ -53,7 +69,7 @@ func cgoCheckWriteBarrier(dst *uintptr, src uintptr) {
 //go:nosplit
 //go:nowritebarrier
 func cgoCheckMemmove(typ *_type, dst, src unsafe.Pointer, off, size uintptr) {
-	if typ.kind&kindNoPointers != 0 {
+	if typ.kind&kindNoPointers != 0 || !cgoCheckSampled() {
 		return
 	}
 	if !cgoIsGoPointer(src) {
@@ -72,7 +88,7 @@ func cgoCheckMemmove(typ *_type, dst, src unsafe.Pointer, off, size uintptr) {
 //go:nosplit
 //go:nowritebarrier
 func cgoCheckSliceCopy(typ *_type, dst, src slice, n int) {
-	if typ.kind&kindNoPointers != 0 {
+	if typ.kind&kindNoPointers != 0 || !cgoCheckSampled() {
 		return
 	}
 	if !cgoIsGoPointer(src.array) {
@@ -140,18 +156,28 @@ func cgoCheckTypedBlock(typ *_type, src unsafe.Pointer, off, size uintptr) {
 
 	// src must be in the regular heap.
 
-	hbits := heapBitsForAddr(uintptr(src))
-	for i := uintptr(0); i < off+size; i += sys.PtrSize {
-		bits := hbits.bits()
-		if i >= off && bits&bitPointer != 0 {
-			v := *(*unsafe.Pointer)(add(src, i))
-			if cgoIsGoPointer(v) {
-				systemstack(func() {
-					throw(cgoWriteBarrierFail)
-				})
+	// Where the words start a bitmap byte, check the pointer bits
+	// of the byte, for 4 words, at once.
+	hbits := heapBitsForAddr(uintptr(src) + off)
+	end := off + size
+	for i := off; i < end; {
+		if hbits.shift == 0 && end-i >= 4*sys.PtrSize {
+			bits := uint32(*hbits.bitp) & bitPointerAll
+			for j := i; bits != 0; j += sys.PtrSize {
+				if bits&1 != 0 && *(*uintptr)(add(src, j)) != 0 {
+					cgoCheckWord(add(src, j))
+				}
+				bits >>= 1
 			}
+			hbits.bitp = subtract1(hbits.bitp)
+			i += 4 * sys.PtrSize
+			continue
+		}
+		if hbits.bits()&bitPointer != 0 && *(*uintptr)(add(src, i)) != 0 {
+			cgoCheckWord(add(src, i))
 		}
 		hbits = hbits.next()
+		i += sys.PtrSize
 	}
 }
 
@@ -161,32 +187,51 @@ func cgoCheckTypedBlock(typ *_type, src unsafe.Pointer, off, size uintptr) {
 //go:nosplit
 //go:nowritebarrier
 func cgoCheckBits(src unsafe.Pointer, gcbits *byte, off, size uintptr) {
-	skipMask := off / sys.PtrSize / 8
-	skipBytes := skipMask * sys.PtrSize * 8
-	ptrmask := addb(gcbits, skipMask)
-	src = add(src, skipBytes)
-	off -= skipBytes
-	size += off
-	var bits uint32
-	for i := uintptr(0); i < size; i += sys.PtrSize {
-		if i&(sys.PtrSize*8-1) == 0 {
-			bits = uint32(*ptrmask)
-			ptrmask = addb(ptrmask, 1)
-		} else {
-			bits >>= 1
+	// A byte of gcbits covers 8 words. Start at the byte covering
+	// off, skip runs of 8 bytes with no pointer bits at once, and
+	// check only the words whose bits are set.
+	const maskBytes = 8 * sys.PtrSize // memory covered by a gcbits byte
+	base := off &^ (maskBytes - 1)
+	ptrmask := addb(gcbits, base/maskBytes)
+	end := off + size
+	for base < end {
+		if end-base >= 8*maskBytes && readUnaligned64(unsafe.Pointer(ptrmask)) == 0 {
+			ptrmask = addb(ptrmask, 8)
+			base += 8 * maskBytes
+			continue
 		}
-		if off > 0 {
-			off -= sys.PtrSize
-		} else {
-			if bits&1 != 0 {
-				v := *(*unsafe.Pointer)(add(src, i))
-				if cgoIsGoPointer(v) {
-					systemstack(func() {
-						throw(cgoWriteBarrierFail)
-					})
-				}
+		bits := uint32(*ptrmask)
+		if base < off {
+			// Drop the words before off.
+			bits &^= 1<<((off-base)/sys.PtrSize) - 1
+		}
+		if end-base < maskBytes {
+			// Drop the words from end on.
+			bits &= 1<<((end-base+sys.PtrSize-1)/sys.PtrSize) - 1
+		}
+		for i := base; bits != 0; i += sys.PtrSize {
+			if bits&1 != 0 && *(*uintptr)(add(src, i)) != 0 {
+				cgoCheckWord(add(src, i))
 			}
+			bits >>= 1
 		}
+		ptrmask = addb(ptrmask, 1)
+		base += maskBytes
+	}
+}
+
+// cgoCheckWord throws if the word at p is a Go pointer that is not
+// pinned.
+//go:nosplit
+//go:nowritebarrier
+func cgoCheckWord(p unsafe.Pointer) {
+	v := *(*unsafe.Pointer)(p)
+	if cgoIsGoPointer(v) {
+		systemstack(func() {
+			if !isPinned(v) {
+				throw(cgoWriteBarrierFail)
+			}
+		})
 	}
 }
 
@@ -0,0 +1,43 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime_test
+
+import (
+	"reflect"
+	"runtime"
+	"testing"
+)
+
+type cgoCheckSparse struct {
+	p *byte
+	x [15]uintptr
+}
+
+// Benchmarks of the check that cgocheck=2 makes of a typed copy of a
+// large value into C memory. The values' pointers are nil, so the
+// benchmarks measure the walk of the pointer bitmap. The gcprog
+// values are large enough for their types to use a GC program, so the
+// walk uses the heap bitmap instead of the type's.
+func BenchmarkCgoCheckTyped(b *testing.B) {
+	b.Run("dense", func(b *testing.B) {
+		benchCgoCheckTyped(b, new([4096]*byte))
+	})
+	b.Run("sparse", func(b *testing.B) {
+		benchCgoCheckTyped(b, new([256]cgoCheckSparse))
+	})
+	b.Run("gcprog-dense", func(b *testing.B) {
+		benchCgoCheckTyped(b, new([1<<15 + 1]*byte))
+	})
+	b.Run("gcprog-sparse", func(b *testing.B) {
+		benchCgoCheckTyped(b, new([2049]cgoCheckSparse))
+	})
+}
+
+func benchCgoCheckTyped(b *testing.B, p interface{}) {
+	b.SetBytes(int64(reflect.TypeOf(p).Elem().Size()))
+	for i := 0; i < b.N; i++ {
+		runtime.CgoCheckTypedBlock(p)
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Flight recorder of cgo transitions, for GODEBUG=cgoflight=N.
+//
+// Each M keeps a ring of its last N calls between Go and C, which
+// crash tracebacks print. Only the M writes its ring, so recording
+// an event is a read of the time stamp counter and a few stores.
+
+package runtime
+
+const maxCgoFlight = 4096
+
+// Kinds of cgoFlightEvent.
+const (
+	cgoFlightCall         = 1 + iota // Go calls C
+	cgoFlightReturn                  // C returns to Go
+	cgoFlightCallback                // C calls Go
+	cgoFlightCallbackDone            // Go returns to C
+)
+
+var cgoFlightKinds = [...]string{
+	cgoFlightCall:         "call",
+	cgoFlightReturn:       "return",
+	cgoFlightCallback:     "callback",
+	cgoFlightCallbackDone: "callback done",
+}
+
+type cgoFlightEvent struct {
+	ticks int64
+	pc    uintptr // the _Cfunc_ wrapper, or the Go function called back
+	kind  uint8
+}
+
+type cgoFlightRecorder struct {
+	n  uint32 // events recorded
+	i  uint32 // next slot in ev, n%len(ev) without dividing in cgoFlight
+	ev []cgoFlightEvent
+}
+
+// newCgoFlightRecorder returns the ring for a new M,
+// or nil if GODEBUG=cgoflight is not set.
+func newCgoFlightRecorder() *cgoFlightRecorder {
+	n := debug.cgoflight
+	if n <= 0 {
+		return nil
+	}
+	if n > maxCgoFlight {
+		n = maxCgoFlight
+	}
+	return &cgoFlightRecorder{ev: make([]cgoFlightEvent, n)}
+}
+
+// cgoFlight records a transition of kind on mp.
+//go:nosplit
+func cgoFlight(mp *m, kind uint8, pc uintptr) {
+	r := mp.cgoflight
+	if r == nil {
+		return
+	}
+	e := &r.ev[r.i]
+	e.ticks = cputicks()
+	e.pc = pc
+	e.kind = kind
+	r.n++
+	if r.i++; r.i == uint32(len(r.ev)) {
+		r.i = 0
+	}
+}
+
+// printCgoFlight prints the rings of all Ms, oldest event first,
+// with the time of each event before now. It is called while
+// crashing, so other Ms may be writing to their rings.
+func printCgoFlight() {
+	now := cputicks()
+	tps := tickspersecond()
+	for mp := allm; mp != nil; mp = mp.alllink {
+		r := mp.cgoflight
+		if r == nil || r.n == 0 {
+			continue
+		}
+		print("\ncgo transitions on m", mp.id, ", oldest first:\n")
+		n := r.n
+		i := uint32(0)
+		if n > uint32(len(r.ev)) {
+			i = n - uint32(len(r.ev))
+		}
+		for ; i < n; i++ {
+			e := r.ev[i%uint32(len(r.ev))]
+			if e.kind == 0 || int(e.kind) >= len(cgoFlightKinds) {
+				continue
+			}
+			// Divide first: ticks since an event long ago
+			// times 1e6 overflows int64.
+			d := now - e.ticks
+			ago := d/tps*1e6 + d%tps*1e6/tps
+			print("\t-", ago, "us ", cgoFlightKinds[e.kind])
+			if f := findfunc(e.pc); f != nil {
+				print(" ", funcname(f))
+			}
+			print("\n")
+		}
+	}
+}
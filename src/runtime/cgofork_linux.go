@@ -0,0 +1,220 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Forking the runtime of a library, for GoForkRuntime in
+// runtime/cgo/gcc_fork.c.
+
+package runtime
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+// cgoFork holds the arguments and results of _cgo_fork_internal,
+// in C memory. Known to runtime/cgo as ForkArgs.
+type cgoFork struct {
+	fork   unsafe.Pointer // locks runtime/cgo's state and forks
+	result int32
+	pid    int32 // from fork
+	err    int32 // errno from fork
+}
+
+// Values of cgoFork.result.
+const (
+	cgoForkDone = iota
+	cgoForkBusy
+	cgoForkFailed
+	cgoForkUnsupported
+)
+
+// _cgo_fork_internal forks the process with the runtime quiesced, so
+// that the child gets a runtime it can keep running: the heap, the
+// goroutines and the state of the initialized packages, but only the
+// calling thread. It stops the world, checks that no goroutine other
+// than the runtime's timer and signal goroutines is in a system call
+// or a call to C, where it would be left without its thread in the
+// child, and forks holding the locks that Ms without a P may take. The
+// child then forgets the other Ms, whose threads it does not have,
+// restarts sysmon and the goroutines that were sleeping in the kernel,
+// and starts the world, which starts new Ms as they are needed. The
+// calling M must be an extra M.
+func _cgo_fork_internal(r *cgoFork) {
+	if !isarchive && !islibrary || netpollinited() || atomic.Load(&cgoAsyncStarted) != 0 {
+		// The network poller's epoll descriptor would be shared
+		// with the parent, and the goroutine that runs
+		// GoInvokeAsync calls waits in C for good.
+		r.result = cgoForkUnsupported
+		return
+	}
+	_g_ := getg()
+	if _g_.m.extranode == nil {
+		// Called from C code called by Go.
+		r.result = cgoForkBusy
+		return
+	}
+
+	stopTheWorld("GoForkRuntime")
+	var timerg, sigg *g
+	var locked [4]*g
+	nlocked := 0
+	busy := gcphase != _GCoff || prof.hz != 0 || trace.enabled
+	lock(&allglock)
+	for i := 0; i < len(allgs) && !busy; i++ {
+		gp := allgs[i]
+		status := readgstatus(gp) &^ _Gscan
+		if gp.lockedm != 0 && gp.lockedm.ptr().extranode == nil {
+			// Locked to a thread that the child will not have.
+			// The runtime's own, such as the one ensureSigM
+			// starts, get a new thread there; the program's
+			// may have left state on theirs.
+			if !hasprefix(funcname(findfunc(gp.startpc)), "runtime.") || status == _Gsyscall || nlocked == len(locked) {
+				busy = true
+				continue
+			}
+			locked[nlocked] = gp
+			nlocked++
+			continue
+		}
+		if status != _Gsyscall {
+			continue
+		}
+		switch {
+		case gp.m != nil && gp.m.extranode != nil:
+			// An extra M parked between calls into Go. A C
+			// thread running Go code has a running goroutine,
+			// which has kept the world from stopping.
+		case gp == timers.gp:
+			timerg = gp
+		case atomic.Load(&sig.state) == sigReceiving && funcname(findfunc(gp.startpc)) == "os/signal.loop":
+			sigg = gp
+		default:
+			busy = true
+		}
+	}
+	unlock(&allglock)
+	if busy {
+		startTheWorld()
+		r.result = cgoForkBusy
+		return
+	}
+
+	// sysmon runs without a P, and needm takes a signal stack
+	// without one.
+	lock(&sched.lock)
+	lock(&mheap_.lock)
+	lock(&sigstackfree.lock)
+	asmcgocall(r.fork, unsafe.Pointer(r))
+	unlock(&sigstackfree.lock)
+	unlock(&mheap_.lock)
+	unlock(&sched.lock)
+	if r.result == cgoForkDone && r.pid == 0 {
+		forkchild(timerg, sigg, locked[:nlocked])
+	}
+	startTheWorld()
+}
+
+// forkchild sets up the runtime of the child of _cgo_fork_internal,
+// with the world stopped. timerg and sigg are the timer and signal
+// goroutines, if they were waiting in the kernel, and locked the
+// runtime goroutines locked to their threads.
+func forkchild(timerg, sigg *g, locked []*g) {
+	_g_ := getg()
+	_g_.m.procid = uint64(gettid())
+
+	// Only the extra Ms, which are not tied to a thread while
+	// parked, and this one survive.
+	lock(&sched.lock)
+	var last *m
+	for mp := allm; mp != nil; mp = mp.alllink {
+		if mp == _g_.m || mp.extranode != nil {
+			if last == nil {
+				allm = mp
+			} else {
+				last.alllink = mp
+			}
+			last = mp
+			continue
+		}
+		if mp.newSigstack {
+			sigstackput(mp.sigstack)
+		}
+		// Goroutines may still name mp in cgoAffinity.
+		mp.idle = false
+		sched.mcount--
+	}
+	last.alllink = nil
+	sched.midle = 0
+	sched.nmidle = 0
+	sched.nmidlelocked = 0
+	atomic.Store(&sched.nmspinning, 0)
+	atomic.Store(&sched.sysmonwait, 0)
+	noteclear(&sched.sysmonnote)
+	unlock(&sched.lock)
+	systemstack(func() {
+		newm(sysmon, nil)
+		for _, gp := range locked {
+			mp := allocm(nil, forklockedm)
+			mp.locked = gp.lockedm.ptr().locked
+			mp.lockedg.set(gp)
+			gp.lockedm.set(mp)
+			newm1(mp)
+		}
+	})
+
+	if timerg != nil {
+		forkgdead(timerg)
+		lock(&timers.lock)
+		timers.gp = nil
+		timers.sleeping = false
+		noteclear(&timers.waitnote)
+		unlock(&timers.lock)
+		go timerproc()
+	}
+	if sigg != nil {
+		fn := &funcval{sigg.startpc}
+		pc := sigg.gopc
+		forkgdead(sigg)
+		noteclear(&sig.note)
+		// A signal that arrived as the parent forked is in
+		// sig.mask, without a receiver to take it.
+		state := uint32(sigIdle)
+		for i := range sig.mask {
+			if atomic.Load(&sig.mask[i]) != 0 {
+				state = sigSending
+			}
+		}
+		atomic.Store(&sig.state, state)
+		systemstack(func() {
+			newproc1(fn, nil, 0, 0, pc)
+		})
+	}
+}
+
+// forkgdead frees gp, which was waiting in the kernel on an M that the
+// child of _cgo_fork_internal does not have, as goexit0 would.
+func forkgdead(gp *g) {
+	casgstatus(gp, _Gsyscall, _Gdead)
+	if isSystemGoroutine(gp) {
+		atomic.Xadd(&sched.ngsys, -1)
+	}
+	gp.m = nil
+	gp.lockedm = 0
+	gp.cgoAffinity = 0
+	gp.syscallsp = 0
+	gp.syscallpc = 0
+	gp.waitreason = ""
+	gp.param = nil
+	gp.gcscanvalid = true
+	gfput(getg().m.p.ptr(), gp)
+}
+
+// forklockedm is the start function of an M that the child of
+// _cgo_fork_internal starts for a goroutine locked to an M it does
+// not have. It waits for the goroutine to be scheduled, as the old M
+// did.
+func forklockedm() {
+	stoplockedm()
+	execute(getg().m.lockedg.ptr(), false)
+}
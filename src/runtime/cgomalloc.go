@@ -0,0 +1,168 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime
+
+import "unsafe"
+
+// Small C allocations, for runtime/cgo.Malloc and Free.
+//
+// cmallocsmall serves allocations of up to cSmallMax bytes from
+// per-P free lists, kept in the mcache, with one list per size class
+// of cSmallAlign bytes. An empty list is refilled with a slab of
+// cSmallSlab bytes from cmalloc, one call into C for dozens of
+// objects, carved into objects of the class. cfreesmall puts objects
+// back on the list of the P that frees them. Slabs are never returned
+// to C; the lists of a P that is destroyed move to csmallfree.
+//
+// Each object is preceded by a header of cSmallHeader bytes, which
+// holds its class and, while the object is free, the link to the next
+// free object, so that a free object's own memory is never written.
+// The header also keeps the object aligned as malloc aligns memory.
+// Allocations larger than cSmallMax get their own cmalloc block, with
+// a header of class cSmallLarge, and go back to C when freed.
+
+const (
+	cSmallMax     = 256
+	cSmallAlign   = 16
+	cSmallClasses = cSmallMax / cSmallAlign
+	cSmallHeader  = 16
+	cSmallSlab    = 16 << 10
+	cSmallLarge   = ^uintptr(0)
+)
+
+// A csmallhdr is the header of an object. next is set only while the
+// object is on a free list.
+type csmallhdr struct {
+	class uintptr
+	next  gclinkptr
+}
+
+// csmallfree holds the free lists of destroyed Ps.
+var csmallfree struct {
+	lock mutex
+	list [cSmallClasses]gclinkptr
+}
+
+// cmallocsmall returns n bytes of uninitialized C memory, for
+// runtime/cgo.Malloc. It panics if C's malloc fails.
+func cmallocsmall(n uintptr) unsafe.Pointer {
+	var p unsafe.Pointer
+	if n > cSmallMax {
+		h := (*csmallhdr)(cmalloc(cSmallHeader + n))
+		h.class = cSmallLarge
+		p = add(unsafe.Pointer(h), cSmallHeader)
+	} else {
+		class := uintptr(0)
+		if n > 0 {
+			class = (n - 1) / cSmallAlign
+		}
+		mp := acquirem()
+		c := mp.mcache
+		h := (*csmallhdr)(unsafe.Pointer(c.csmall[class]))
+		if h != nil {
+			c.csmall[class] = h.next
+			releasem(mp)
+		} else {
+			// Refill with the M released: cmalloc is a cgo
+			// call, and it panics if C's malloc fails. The
+			// goroutine may come back on another P, whose list
+			// may have been refilled meanwhile.
+			releasem(mp)
+			h = (*csmallhdr)(unsafe.Pointer(csmallrefill(class)))
+			rest := h.next
+			mp = acquirem()
+			c = mp.mcache
+			if c.csmall[class] == 0 {
+				c.csmall[class] = rest
+				rest = 0
+			}
+			releasem(mp)
+			if rest != 0 {
+				csmallgive(class, rest)
+			}
+		}
+		h.next = 0
+		p = add(unsafe.Pointer(h), cSmallHeader)
+	}
+	if msanenabled {
+		msanmalloc(p, n)
+	}
+	return p
+}
+
+// cfreesmall frees memory from cmallocsmall.
+func cfreesmall(p unsafe.Pointer) {
+	if p == nil {
+		return
+	}
+	h := (*csmallhdr)(unsafe.Pointer(uintptr(p) - cSmallHeader))
+	if h.class == cSmallLarge {
+		cfree(unsafe.Pointer(h))
+		return
+	}
+	if h.class >= cSmallClasses || h.next != 0 {
+		throw("runtime/cgo: Free of memory not from Malloc, or freed twice")
+	}
+	if msanenabled {
+		msanfree(p, (h.class+1)*cSmallAlign)
+	}
+	mp := acquirem()
+	c := mp.mcache
+	h.next = c.csmall[h.class]
+	c.csmall[h.class] = gclinkptr(unsafe.Pointer(h))
+	releasem(mp)
+}
+
+// csmallrefill returns a list of free objects of the given class,
+// taken from csmallfree if it has any and carved from a new slab
+// otherwise.
+func csmallrefill(class uintptr) gclinkptr {
+	if csmallfree.list[class] != 0 {
+		lock(&csmallfree.lock)
+		list := csmallfree.list[class]
+		csmallfree.list[class] = 0
+		unlock(&csmallfree.lock)
+		if list != 0 {
+			return list
+		}
+	}
+	stride := cSmallHeader + (class+1)*cSmallAlign
+	slab := uintptr(cmalloc(cSmallSlab))
+	var list gclinkptr
+	for off := cSmallSlab/stride*stride - stride; ; off -= stride {
+		h := (*csmallhdr)(unsafe.Pointer(slab + off))
+		h.class = class
+		h.next = list
+		list = gclinkptr(unsafe.Pointer(h))
+		if off == 0 {
+			break
+		}
+	}
+	return list
+}
+
+// csmallflush moves the free lists of c to csmallfree, when c's P is
+// destroyed.
+func csmallflush(c *mcache) {
+	for class := range c.csmall {
+		if list := c.csmall[class]; list != 0 {
+			csmallgive(uintptr(class), list)
+			c.csmall[class] = 0
+		}
+	}
+}
+
+// csmallgive adds list, a non-empty list of free objects of the given
+// class, to csmallfree.
+func csmallgive(class uintptr, list gclinkptr) {
+	tail := (*csmallhdr)(unsafe.Pointer(list))
+	for tail.next != 0 {
+		tail = (*csmallhdr)(unsafe.Pointer(tail.next))
+	}
+	lock(&csmallfree.lock)
+	tail.next = csmallfree.list[class]
+	csmallfree.list[class] = list
+	unlock(&csmallfree.lock)
+}
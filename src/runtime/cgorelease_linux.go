@@ -0,0 +1,151 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Releasing the runtime of a library, for GoReleaseRuntime in
+// runtime/cgo/gcc_release.c.
+
+package runtime
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+// libreleased is set once the runtime has been released. An M that
+// sees it, in stopm, stoplockedm or sysmon, exits its thread.
+var libreleased uint32
+
+// libreleaseexits counts the Ms that have exited.
+var libreleaseexits uint32
+
+// cgoRelease holds the arguments and results of _cgo_release_internal,
+// in C memory. Known to runtime/cgo as ReleaseArgs.
+type cgoRelease struct {
+	stop   unsafe.Pointer // stops the threads of runtime/cgo
+	fd     int32          // readable descriptor, to wake netpoll
+	result int32
+	start  uintptr // memory to unmap, once back in C
+	size   uintptr
+}
+
+// Values of cgoRelease.result.
+const (
+	cgoReleaseDone = iota
+	cgoReleaseBusy
+	cgoReleaseTimeout
+	cgoReleaseUnsupported
+)
+
+// _cgo_release_internal releases the runtime. It stops the world and
+// never starts it again, gives signals back to the handlers that were
+// installed before the runtime's, and waits for every M but the
+// calling one, which must be an extra M, to exit its thread. It then
+// leaves the bounds of the heap reservation in r for the C code to
+// unmap once it no longer runs Go code.
+func _cgo_release_internal(r *cgoRelease) {
+	if !isarchive && !islibrary {
+		r.result = cgoReleaseUnsupported
+		return
+	}
+	_g_ := getg()
+	if _g_.m.extranode == nil {
+		// Called from C code called by Go.
+		r.result = cgoReleaseBusy
+		return
+	}
+
+	stopTheWorld("GoReleaseRuntime")
+	for mp := allm; mp != nil; mp = mp.alllink {
+		if mp == _g_.m {
+			continue
+		}
+		// An M in a cgo call would not exit until the call
+		// returns, and an extra M not parked in a system call
+		// is running a call into Go from C.
+		if mp.ncgo > 0 && mp.curg != cgoAsyncG.ptr() ||
+			mp.extranode != nil && readgstatus(mp.curg)&^_Gscan != _Gsyscall {
+			startTheWorld()
+			r.result = cgoReleaseBusy
+			return
+		}
+	}
+
+	atomic.Store(&libreleased, 1)
+	if prof.hz != 0 {
+		var it itimerval
+		setitimer(_ITIMER_PROF, &it, nil)
+		for mp := allm; mp != nil; mp = mp.alllink {
+			setcputimer(mp, 0)
+		}
+	}
+	for i := int32(0); i < _NSIG; i++ {
+		t := &sigtable[i]
+		if t.flags&_SigHandling != 0 && getsig(i) == funcPC(sighandler) {
+			t.flags &^= _SigHandling
+			atomic.Storeuintptr(&sigfwdonly[i], 0)
+			setsig(i, fwdSig[i], true)
+		}
+	}
+	asmcgocall(r.stop, nil)
+
+	// Wake every M that may be waiting. The Ms that are not waiting
+	// will find libreleased set the next time they stop.
+	n := uint32(0)
+	lock(&sched.lock)
+	for mp := allm; mp != nil; mp = mp.alllink {
+		if mp != _g_.m && mp.extranode == nil {
+			n++
+			notetrywakeup(&mp.park)
+		}
+	}
+	if atomic.Load(&sched.sysmonwait) != 0 {
+		atomic.Store(&sched.sysmonwait, 0)
+		notewakeup(&sched.sysmonnote)
+	}
+	unlock(&sched.lock)
+	lock(&timers.lock)
+	if timers.sleeping {
+		timers.sleeping = false
+		notewakeup(&timers.waitnote)
+	}
+	unlock(&timers.lock)
+	if atomic.Cas(&sig.state, sigReceiving, sigIdle) {
+		notewakeup(&sig.note)
+	}
+	if epfd >= 0 && r.fd >= 0 {
+		netpollbreak(r.fd)
+	}
+
+	// Wait for up to a second.
+	for i := 0; atomic.Load(&libreleaseexits) < n; i++ {
+		if i == 10000 {
+			r.result = cgoReleaseTimeout
+			return
+		}
+		usleep(100)
+	}
+	if epfd >= 0 {
+		closefd(epfd)
+	}
+
+	// On 64-bit systems the spans array, the heap bitmap and the
+	// arena are a single reservation made by mallocinit.
+	if mheap_.arena_end-mheap_.arena_start > _MaxArena32 {
+		r.start = uintptr(unsafe.Pointer(mheap_.spans))
+		r.size = mheap_.arena_end - r.start
+	}
+	r.result = cgoReleaseDone
+}
+
+// mexit exits the thread of the current M, which is on its g0 stack
+// without a P, once the runtime has been released. Like dropm, it
+// calls unminit, so that the M gives back its signal stack and CPU
+// timer rather than leak them with the thread.
+//go:nowritebarrierrec
+func mexit() {
+	sigblock()
+	unminit()
+	asmcgocall(_cgo_thread_exit, unsafe.Pointer(&libreleaseexits))
+	throw("mexit: thread did not exit")
+}
@@ -0,0 +1,16 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !linux
+
+package runtime
+
+// The runtime can be released only on Linux; see cgorelease_linux.go.
+
+var libreleased uint32
+
+//go:nowritebarrierrec
+func mexit() {
+	throw("mexit")
+}
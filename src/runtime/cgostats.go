@@ -0,0 +1,134 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Counters of the boundary between Go and C, for ReadCgoStats and
+// runtime/cgo's GoReadCgoStats.
+
+package runtime
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+// CgoStats records how calls cross between Go and C. It is filled in
+// by ReadCgoStats, and by GoReadCgoStats, declared in _cgo_export.h,
+// for C programs that embed Go. All the fields are uint64, in this
+// order, in the GoCgoStats struct of _cgo_export.h.
+type CgoStats struct {
+	CgoThreadStats
+
+	// Calls is the number of calls from Go to C, as NumCgoCall
+	// reports.
+	Calls uint64
+
+	// ExtraMIdle is the number of extra Ms not in use, ready for
+	// calls from C to Go on threads not created by Go.
+	ExtraMIdle uint64
+
+	// NeedM is the number of calls from C to Go that took an
+	// extra M. Calls from a thread that keeps its M, registered
+	// with GoRegisterThread or under GODEBUG=cgostickym=1, take
+	// one only the first time.
+	NeedM uint64
+
+	// NeedMWaits is the number of those calls that found no idle
+	// extra M and waited for one to be created or returned, and
+	// NeedMWaitNanoseconds the total time they waited.
+	NeedMWaits           uint64
+	NeedMWaitNanoseconds uint64
+
+	// InitWaits is the number of calls from C to Go that waited
+	// for the runtime of a -buildmode=c-archive or c-shared
+	// program to be initialized, and InitWaitNanoseconds the total
+	// time they waited, to the microsecond on Unix systems and the
+	// millisecond on Windows. Both are zero on OpenBSD.
+	InitWaits           uint64
+	InitWaitNanoseconds uint64
+
+	// CMallocs and CMallocBytes count the C allocations made by
+	// C.malloc, C.CString and C.CBytes and for the caches of
+	// runtime/cgo.Malloc, like MemStats.CgoMallocs and
+	// CgoTotalAlloc but including the allocations that have not
+	// been added to MemStats yet.
+	CMallocs     uint64
+	CMallocBytes uint64
+
+	// PointerChecks is the number of checks of Go pointers passed
+	// to or returned from C (see GODEBUG=cgocheck), and
+	// PointerCheckNanoseconds the total time they took. They are
+	// recorded only under GODEBUG=cgocallbackstats=1.
+	PointerChecks           uint64
+	PointerCheckNanoseconds uint64
+}
+
+// cgoStats holds the counters of CgoStats kept by the runtime itself.
+var cgoStats struct {
+	extraMIdle              uint64
+	needM                   uint64
+	needMWaits              uint64
+	needMWaitNanoseconds    uint64
+	pointerChecks           uint64
+	pointerCheckNanoseconds uint64
+}
+
+// ReadCgoStats fills stats with the counters of calls between Go and
+// C made so far. They are all zero in a program that does not use cgo.
+// The counters are read one at a time, so they need not be consistent
+// with each other.
+func ReadCgoStats(stats *CgoStats) {
+	ReadCgoThreadStats(&stats.CgoThreadStats)
+	stats.Calls = uint64(NumCgoCall())
+	stats.ExtraMIdle = atomic.Load64(&cgoStats.extraMIdle)
+	stats.NeedM = atomic.Load64(&cgoStats.needM)
+	stats.NeedMWaits = atomic.Load64(&cgoStats.needMWaits)
+	stats.NeedMWaitNanoseconds = atomic.Load64(&cgoStats.needMWaitNanoseconds)
+	stats.PointerChecks = atomic.Load64(&cgoStats.pointerChecks)
+	stats.PointerCheckNanoseconds = atomic.Load64(&cgoStats.pointerCheckNanoseconds)
+
+	stats.InitWaits = 0
+	stats.InitWaitNanoseconds = 0
+	if _cgo_init_wait_stats != nil {
+		var args struct {
+			n  uint64
+			ns uint64
+		}
+		cgocallleaf(_cgo_init_wait_stats, unsafe.Pointer(&args))
+		stats.InitWaits = args.n
+		stats.InitWaitNanoseconds = args.ns
+	}
+
+	stats.CMallocs, stats.CMallocBytes = cmallocTotals()
+}
+
+// cmallocTotals returns the number of cmalloc calls and the bytes they
+// allocated. The counts of each P are added to memstats only by the
+// garbage collector; add the ones not added yet. They are read without
+// stopping the Ps, so they may be slightly stale.
+func cmallocTotals() (n, bytes uint64) {
+	n = memstats.cmalloc
+	bytes = memstats.cmalloc_size
+	for _, p := range &allp {
+		if p == nil {
+			break
+		}
+		if c := p.mcache; c != nil {
+			n += uint64(atomic.Loaduintptr(&c.local_ncmalloc))
+			bytes += uint64(atomic.Loaduintptr(&c.local_cmalloc))
+		}
+	}
+	return
+}
+
+// _cgo_read_stats_internal is called by GoReadCgoStats in runtime/cgo,
+// with s pointing to a GoCgoStats in C memory.
+func _cgo_read_stats_internal(s *CgoStats) {
+	ReadCgoStats(s)
+}
+
+// cgoCheckTime counts a pointer check that started at start.
+func cgoCheckTime(start int64) {
+	atomic.Xadd64(&cgoStats.pointerChecks, 1)
+	atomic.Xadd64(&cgoStats.pointerCheckNanoseconds, nanotime()-start)
+}
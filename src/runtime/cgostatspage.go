@@ -0,0 +1,82 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime
+
+import "runtime/internal/atomic"
+
+// The stats page, for C hosts.
+//
+// sysmon copies a few counters into a page of C memory owned by
+// runtime/cgo, every cgoStatsPeriod while Go code runs and once more
+// before it sleeps while every P is idle, so that a C thread can read
+// them with GoReadStats without calling into Go, and so without an M
+// and without waiting for a garbage collection. The page is a seqlock:
+// sysmon, its only writer, makes seq odd while it writes the counters
+// and even again after, and readers retry until they see the same
+// even seq before and after copying them.
+
+// cgoStatsPeriod is how often sysmon publishes the stats page.
+const cgoStatsPeriod = 10 * 1000 * 1000
+
+// cgoStatsPage is the layout of the page.
+// Known to runtime/cgo/libcgo.h as GoStatsPage, whose stats array is
+// the GoStats struct of _cgo_export.h: keep all three in sync.
+type cgoStatsPage struct {
+	seq uint64
+
+	updateTime    uint64 // Unix time of this update, in nanoseconds
+	heapAlloc     uint64 // heap_live, close to MemStats.HeapAlloc
+	heapSys       uint64
+	nextGC        uint64
+	numGC         uint64
+	pauseTotalNs  uint64
+	lastPauseNs   uint64
+	lastGC        uint64
+	numGoroutine  uint64
+	numCgoCall    uint64
+	cgoInC        uint64
+	cgoExtraM     uint64
+	cgoExtraMIdle uint64
+	cgoNeedM      uint64
+	cgoNeedMWaits uint64
+	cmallocBytes  uint64
+}
+
+// cgoStatsPublish writes the stats page, if runtime/cgo provides one.
+// It is called only by sysmon, which has no P.
+//go:nowritebarrierrec
+func cgoStatsPublish() {
+	page := (*cgoStatsPage)(_cgo_stats_page)
+	if page == nil {
+		return
+	}
+	seq := page.seq
+	atomic.Store64(&page.seq, seq+1)
+
+	atomic.Store64(&page.updateTime, uint64(unixnanotime()))
+	atomic.Store64(&page.heapAlloc, atomic.Load64(&memstats.heap_live))
+	atomic.Store64(&page.heapSys, memstats.heap_sys)
+	atomic.Store64(&page.nextGC, memstats.next_gc)
+	numgc := atomic.Load(&memstats.numgc)
+	atomic.Store64(&page.numGC, uint64(numgc))
+	atomic.Store64(&page.pauseTotalNs, memstats.pause_total_ns)
+	var pause uint64
+	if numgc > 0 {
+		pause = memstats.pause_ns[(numgc-1)%uint32(len(memstats.pause_ns))]
+	}
+	atomic.Store64(&page.lastPauseNs, pause)
+	atomic.Store64(&page.lastGC, atomic.Load64(&memstats.last_gc))
+	atomic.Store64(&page.numGoroutine, uint64(gcount()))
+	atomic.Store64(&page.numCgoCall, uint64(NumCgoCall()))
+	atomic.Store64(&page.cgoInC, cgoThreadInC())
+	atomic.Store64(&page.cgoExtraM, atomic.Load64(&cgoThreadStats.ExtraM))
+	atomic.Store64(&page.cgoExtraMIdle, atomic.Load64(&cgoStats.extraMIdle))
+	atomic.Store64(&page.cgoNeedM, atomic.Load64(&cgoStats.needM))
+	atomic.Store64(&page.cgoNeedMWaits, atomic.Load64(&cgoStats.needMWaits))
+	_, bytes := cmallocTotals()
+	atomic.Store64(&page.cmallocBytes, bytes)
+
+	atomic.Store64(&page.seq, seq+2)
+}
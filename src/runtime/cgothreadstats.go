@@ -0,0 +1,73 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Counters for the threads of programs that use cgo.
+
+package runtime
+
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
+
+// CgoThreadStats records how a program that uses cgo uses threads.
+// It is filled in by ReadCgoThreadStats.
+//
+// The Go stacks that caused the runtime to create threads are in the
+// "threadcreate" profile; see ThreadCreateProfile.
+type CgoThreadStats struct {
+	// Created is the number of threads the runtime has started
+	// through runtime/cgo (x_cgo_thread_start) to run Ms.
+	Created uint64
+
+	// InC is the number of calls from Go to C in progress,
+	// including those that have called back into Go, but not
+	// calls to functions marked with a #cgo leaf: directive.
+	// Each is holding a thread.
+	InC uint64
+
+	// PeakInC is the largest value InC has had, as sampled by
+	// the runtime every few milliseconds and by each call to
+	// ReadCgoThreadStats.
+	PeakInC uint64
+
+	// ExtraM is the number of extra Ms created for calls from C
+	// to Go on threads not created by Go. Extra Ms are never freed.
+	ExtraM uint64
+}
+
+var cgoThreadStats CgoThreadStats
+
+// ReadCgoThreadStats fills stats with the thread counters of the
+// program. They are all zero in a program that does not use cgo.
+func ReadCgoThreadStats(stats *CgoThreadStats) {
+	stats.Created = atomic.Load64(&cgoThreadStats.Created)
+	stats.InC = cgoThreadSamplePeak()
+	stats.PeakInC = atomic.Load64(&cgoThreadStats.PeakInC)
+	stats.ExtraM = atomic.Load64(&cgoThreadStats.ExtraM)
+}
+
+// cgoThreadInC returns the number of calls from Go to C in progress.
+// Each M counts its own calls in m.ncgoinc, so that cgocall pays for
+// no atomic operation on shared memory; the sum may be slightly stale.
+func cgoThreadInC() uint64 {
+	var n uint64
+	for mp := (*m)(atomic.Loadp(unsafe.Pointer(&allm))); mp != nil; mp = mp.alllink {
+		n += uint64(atomic.Load(&mp.ncgoinc))
+	}
+	return n
+}
+
+// cgoThreadSamplePeak raises PeakInC to the number of calls in C now,
+// and returns that number. sysmon calls it on every tick, so the peak
+// misses only calls that came and went between two ticks.
+func cgoThreadSamplePeak() uint64 {
+	n := cgoThreadInC()
+	for {
+		peak := atomic.Load64(&cgoThreadStats.PeakInC)
+		if n <= peak || atomic.Cas64(&cgoThreadStats.PeakInC, peak, n) {
+			return n
+		}
+	}
+}
@@ -24,6 +24,15 @@ func neginf() float64 {
 }
 
 func complex128div(n complex128, d complex128) complex128 {
+	// Fast path for finite operands and a nonzero divisor, which
+	// is what loops over arrays of samples nearly always see.
+	// x-x is 0 for finite x and NaN for an infinity or a NaN, so
+	// one comparison of the sum checks all four parts.
+	if real(n)-real(n)+(imag(n)-imag(n))+(real(d)-real(d))+(imag(d)-imag(d)) == 0 &&
+		(real(d) != 0 || imag(d) != 0) {
+		return complex128divfinite(n, d)
+	}
+
 	// Special cases as in C99.
 	ninf := isposinf(real(n)) || isneginf(real(n)) ||
 		isposinf(imag(n)) || isneginf(imag(n))
@@ -47,25 +56,29 @@ func complex128div(n complex128, d complex128) complex128 {
 			return complex(posinf(), posinf())
 		}
 	default:
-		// Standard complex arithmetic, factored to avoid unnecessary overflow.
-		a := real(d)
-		if a < 0 {
-			a = -a
-		}
-		b := imag(d)
-		if b < 0 {
-			b = -b
-		}
-		if a <= b {
-			ratio := real(d) / imag(d)
-			denom := real(d)*ratio + imag(d)
-			return complex((real(n)*ratio+imag(n))/denom,
-				(imag(n)*ratio-real(n))/denom)
-		} else {
-			ratio := imag(d) / real(d)
-			denom := imag(d)*ratio + real(d)
-			return complex((imag(n)*ratio+real(n))/denom,
-				(imag(n)-real(n)*ratio)/denom)
-		}
+		return complex128divfinite(n, d)
+	}
+}
+
+// complex128divfinite returns n/d for d neither zero nor infinite.
+func complex128divfinite(n complex128, d complex128) complex128 {
+	// Standard complex arithmetic, factored to avoid unnecessary overflow.
+	a := real(d)
+	if a < 0 {
+		a = -a
+	}
+	b := imag(d)
+	if b < 0 {
+		b = -b
+	}
+	if a <= b {
+		ratio := real(d) / imag(d)
+		denom := real(d)*ratio + imag(d)
+		return complex((real(n)*ratio+imag(n))/denom,
+			(imag(n)*ratio-real(n))/denom)
 	}
+	ratio := imag(d) / real(d)
+	denom := imag(d)*ratio + real(d)
+	return complex((imag(n)*ratio+real(n))/denom,
+		(imag(n)-real(n)*ratio)/denom)
 }
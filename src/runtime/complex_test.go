@@ -65,3 +65,22 @@ func BenchmarkComplex128DivDisInf(b *testing.B) {
 	}
 	result = res
 }
+
+// BenchmarkComplex128DivSlice divides arrays of finite values, as
+// signal processing code does. "a.out bench", with a.out built from
+// test/cmplxdivide.c, times C99 division of the same values.
+func BenchmarkComplex128DivSlice(b *testing.B) {
+	const size = 1024
+	var n, d, q [size]complex128
+	for i := range n {
+		n[i] = complex(float64(i%7+1), float64(i%5-2))
+		d[i] = complex(float64(i%3+1), -float64(i%11)/2)
+	}
+	b.SetBytes(size * 16)
+	for i := 0; i < b.N; i++ {
+		for j := range q {
+			q[j] = n[j] / d[j]
+		}
+	}
+	result = q[size-1]
+}
@@ -185,7 +185,17 @@ func SetCPUProfileRate(hz int) {
 			}
 		}
 	}
+	on := cpuprof != nil && cpuprof.on
 	unlock(&cpuprofLock)
+
+	if atomic.Load(&cgoContextProfiling) != 0 != on {
+		if on {
+			atomic.Store(&cgoContextProfiling, 1)
+		} else {
+			atomic.Store(&cgoContextProfiling, 0)
+		}
+		setcgocontextrate()
+	}
 }
 
 // add adds the stack trace to the profile.
@@ -0,0 +1,116 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build 386 amd64 arm arm64
+
+package runtime
+
+import "runtime/internal/sys"
+
+// Per-thread CPU profiling timers.
+//
+// The process-wide ITIMER_PROF timer counts the CPU time of all
+// threads together and signals whichever thread is running when it
+// expires. The kernel checks it only at the tick, so with many busy
+// threads it expires at most once a tick, and the samples are capped
+// at about 250 a second however many threads there are, and skewed
+// towards the threads that happen to be running at the tick. So each
+// M that runs Go code has a timer of its own that counts the CPU time
+// of its thread alone, including the time in cgo calls, and signals
+// that thread. Such an M drops the signals of the process-wide timer,
+// which is then needed only for threads that have no timer of their
+// own: those of C code, in a program that uses cgo, and any M whose
+// timer could not be created.
+
+const (
+	_CLOCK_THREAD_CPUTIME_ID = 0x3
+	_SIGEV_THREAD_ID         = 0x4
+	_SI_KERNEL               = 0x80
+	_SI_TIMER                = -0x2
+)
+
+type sigevent struct {
+	value  uintptr
+	signo  int32
+	notify int32
+	tid    int32
+	_      [64 - sys.PtrSize - 3*4]byte // the kernel's sigevent is 64 bytes
+}
+
+type itimerspec struct {
+	it_interval timespec
+	it_value    timespec
+}
+
+//go:noescape
+func timer_create(clockid int32, sevp *sigevent, timerid *int32) int32
+
+//go:noescape
+func timer_settime(timerid int32, flags int32, new, old *itimerspec) int32
+
+func timer_delete(timerid int32) int32
+
+// setcputimer sets the CPU profiling timer of mp, which must be the
+// current M or one that is stopped, to hz samples a second, deleting
+// it if hz is 0. It reports whether mp has a timer.
+func setcputimer(mp *m, hz int32) bool {
+	delcputimer(mp)
+	if hz == 0 {
+		return false
+	}
+
+	var sevp sigevent
+	sevp.notify = _SIGEV_THREAD_ID
+	sevp.signo = _SIGPROF
+	sevp.tid = int32(mp.procid)
+	var id int32
+	if timer_create(_CLOCK_THREAD_CPUTIME_ID, &sevp, &id) != 0 {
+		return false
+	}
+
+	// Start at a random point in the first period, so that
+	// threads that start together do not take their samples
+	// in step.
+	period := 1000000000 / int64(hz)
+	first := 1 + int64(fastrand1())%period
+	var spec itimerspec
+	spec.it_interval.set_sec(period / 1000000000)
+	spec.it_interval.set_nsec(int32(period % 1000000000))
+	spec.it_value.set_sec(first / 1000000000)
+	spec.it_value.set_nsec(int32(first % 1000000000))
+	if timer_settime(id, 0, &spec, nil) != 0 {
+		timer_delete(id)
+		return false
+	}
+	mp.cputimer = id
+	mp.cputimerOK = true
+	return true
+}
+
+// delcputimer deletes the CPU profiling timer of mp, if it has one.
+// It reports whether it did. The timer signals the thread that mp ran
+// on when it was created, so an extra M must delete it before it
+// leaves that thread, and an M before its thread exits.
+//go:nosplit
+func delcputimer(mp *m) bool {
+	if !mp.cputimerOK {
+		return false
+	}
+	mp.cputimerOK = false
+	timer_delete(mp.cputimer)
+	return true
+}
+
+// validSIGPROF reports whether a SIGPROF with context c on mp is a
+// sample to record: one from mp's own timer if it has one, or else
+// one from anything but a thread timer, which may still be pending
+// after setcputimer has deleted it.
+//go:nosplit
+func validSIGPROF(mp *m, c *sigctxt) bool {
+	code := int32(c.sigcode())
+	if mp.cputimerOK {
+		return code != _SI_KERNEL
+	}
+	return code != _SI_TIMER
+}
@@ -0,0 +1,23 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build darwin dragonfly freebsd netbsd openbsd solaris linux,!386,!amd64,!arm,!arm64
+
+package runtime
+
+// setcputimer sets the CPU profiling timer of mp. There are no
+// per-thread timers here; see cputimer_linux.go.
+func setcputimer(mp *m, hz int32) bool {
+	return false
+}
+
+//go:nosplit
+func delcputimer(mp *m) bool {
+	return false
+}
+
+//go:nosplit
+func validSIGPROF(mp *m, c *sigctxt) bool {
+	return true
+}
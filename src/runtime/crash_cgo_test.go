@@ -10,6 +10,8 @@ import (
 	"bytes"
 	"fmt"
 	"internal/testenv"
+	trace "internal/trace"
+	"io/ioutil"
 	"os"
 	"os/exec"
 	"runtime"
@@ -155,6 +157,183 @@ func TestEnsureDropM(t *testing.T) {
 	}
 }
 
+func TestCgoStickyM(t *testing.T) {
+	switch runtime.GOOS {
+	case "openbsd", "plan9", "windows":
+		t.Skipf("no sticky Ms on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, prog := range []string{"CgoStickyM", "EnsureDropM"} {
+		cmd := testEnv(exec.Command(exe, prog))
+		cmd.Env = append(cmd.Env, "GODEBUG=cgostickym=1")
+		got, _ := cmd.CombinedOutput()
+		if want := "OK\n"; string(got) != want {
+			t.Errorf("%s: expected %q, got %v", prog, want, string(got))
+		}
+	}
+}
+
+func TestCgoAsync(t *testing.T) {
+	switch runtime.GOOS {
+	case "openbsd", "plan9", "windows":
+		t.Skipf("no cgo thread pool on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CgoAsync"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgoasyncthreads=4")
+	got, _ := cmd.CombinedOutput()
+	if want := "OK\n"; string(got) != want {
+		t.Errorf("expected %q, got %v", want, string(got))
+	}
+}
+
+func TestCgoCallbackStack(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoCallbackStack")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoCallProfile(t *testing.T) {
+	got := runTestProg(t, "testprogcgo", "CgoCallProfile")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCMallocProfile(t *testing.T) {
+	got := runTestProg(t, "testprogcgo", "CMallocProfile")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoBlockProfile(t *testing.T) {
+	if runtime.GOOS == "windows" {
+		t.Skip("no usleep on windows")
+	}
+	got := runTestProg(t, "testprogcgo", "CgoBlockProfile")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoMadvise(t *testing.T) {
+	if runtime.GOOS != "linux" {
+		t.Skipf("the madvise hook is only used on linux")
+	}
+	got := runTestProg(t, "testprogcgo", "CgoMadvise")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoAllocator(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoAllocator")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoExtraM(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CgoExtraM"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgoextram=16")
+	got, _ := cmd.CombinedOutput()
+	if want := "OK\n"; string(got) != want {
+		t.Errorf("expected %q, got %v", want, string(got))
+	}
+}
+
+func TestCgoSigStack(t *testing.T) {
+	if runtime.GOOS != "linux" {
+		t.Skipf("signal stacks are only pooled on linux")
+	}
+	got := runTestProg(t, "testprogcgo", "CgoSigStack")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoCPUTimer(t *testing.T) {
+	if runtime.GOOS != "linux" {
+		t.Skipf("threads have CPU timers of their own only on linux")
+	}
+	got := runTestProg(t, "testprogcgo", "CgoCPUTimer")
+	if want := "OK\n"; got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoCallbackStats(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	// 100 calls come from 4 C threads, and 50 from a Go thread.
+	type test struct {
+		godebug string
+		want    string
+	}
+	tests := []test{
+		{"", "needm=0 acquirep=0 func=0 unwind=0\n"},
+		{"cgocallbackstats=1", "needm=100 acquirep=150 func=150 unwind=150\n"},
+	}
+	if runtime.GOOS != "openbsd" {
+		// Each C thread gets an m only once.
+		tests = append(tests, test{"cgocallbackstats=1,cgostickym=1", "needm=4 acquirep=150 func=150 unwind=150\n"})
+	}
+	for _, tt := range tests {
+		cmd := testEnv(exec.Command(exe, "CgoCallbackStats"))
+		cmd.Env = append(cmd.Env, "GODEBUG="+tt.godebug)
+		got, _ := cmd.CombinedOutput()
+		if string(got) != tt.want {
+			t.Errorf("GODEBUG=%s: expected %q, got %v", tt.godebug, tt.want, string(got))
+		}
+	}
+}
+
+func TestCgoLatencyCritical(t *testing.T) {
+	switch runtime.GOOS {
+	case "openbsd", "plan9", "windows":
+		t.Skipf("no latency-critical C threads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoLatencyCritical")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q got %v", want, got)
+	}
+}
+
 // Test for issue 14387.
 // Test that the program that doesn't need any cgo pointer checking
 // takes about the same amount of time with it as without it.
@@ -226,6 +405,66 @@ func TestCgoCrashTraceback(t *testing.T) {
 	}
 }
 
+func TestCgoCrashTracebackDepth(t *testing.T) {
+	if runtime.GOOS != "linux" || runtime.GOARCH != "amd64" {
+		t.Skipf("not yet supported on %s/%s", runtime.GOOS, runtime.GOARCH)
+	}
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, tt := range []struct {
+		godebug string
+		depth   int
+	}{
+		{"", 32},
+		{"GODEBUG=cgotracebackdepth=100", 100},
+		{"GODEBUG=cgotracebackdepth=5000", 1024},
+	} {
+		cmd := testEnv(exec.Command(exe, "CrashTracebackDepth"))
+		if tt.godebug != "" {
+			cmd.Env = append(cmd.Env, tt.godebug)
+		}
+		got, _ := cmd.CombinedOutput()
+		if !strings.Contains(string(got), fmt.Sprintf("cgo depth:%d ", tt.depth)) {
+			t.Errorf("%q: missing cgo depth:%d", tt.godebug, tt.depth)
+		}
+		if strings.Contains(string(got), fmt.Sprintf("cgo depth:%d ", tt.depth+1)) {
+			t.Errorf("%q: unexpected cgo depth:%d", tt.godebug, tt.depth+1)
+		}
+	}
+}
+
+func TestCgoFPUnwind(t *testing.T) {
+	if runtime.GOOS != "linux" || runtime.GOARCH != "amd64" {
+		t.Skipf("not yet supported on %s/%s", runtime.GOOS, runtime.GOARCH)
+	}
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CrashFPUnwind"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgofpunwind=1")
+	got, _ := cmd.CombinedOutput()
+
+	var fpA, fpB uintptr
+	if _, err := fmt.Sscanf(string(got), "fpA=%v fpB=%v", &fpA, &fpB); err != nil {
+		t.Fatalf("reading function addresses: %v\n%s", err, got)
+	}
+	var inA, inB bool
+	for _, line := range strings.Split(string(got), "\n") {
+		var pc uintptr
+		if _, err := fmt.Sscanf(line, "non-Go function at pc=%v", &pc); err != nil {
+			continue
+		}
+		inA = inA || pc > fpA && pc < fpA+256
+		inB = inB || pc > fpB && pc < fpB+256
+	}
+	if !inA || !inB {
+		t.Errorf("C traceback missing fpA (%v) or fpB (%v):\n%s", inA, inB, got)
+	}
+}
+
 func TestCgoTracebackContext(t *testing.T) {
 	got := runTestProg(t, "testprogcgo", "TracebackContext")
 	want := "OK\n"
@@ -234,6 +473,22 @@ func TestCgoTracebackContext(t *testing.T) {
 	}
 }
 
+func TestCgoSymbolizerCache(t *testing.T) {
+	got := runTestProg(t, "testprogcgo", "SymbolizerCache")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q got %v", want, got)
+	}
+}
+
+func TestCgoTracebackContextRate(t *testing.T) {
+	got := runTestProg(t, "testprogcgo", "TracebackContextRate")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q got %v", want, got)
+	}
+}
+
 func TestCgoPprof(t *testing.T) {
 	if runtime.GOOS != "linux" || runtime.GOARCH != "amd64" {
 		t.Skipf("not yet supported on %s/%s", runtime.GOOS, runtime.GOARCH)
@@ -263,3 +518,277 @@ func TestCgoPprof(t *testing.T) {
 		t.Error("missing cpuHog in pprof output")
 	}
 }
+
+func TestCgoThreadPool(t *testing.T) {
+	if runtime.GOOS != "linux" && runtime.GOOS != "windows" {
+		t.Skipf("no cgo thread pool on %s", runtime.GOOS)
+	}
+	testCgoThreadStartBurst(t, "GODEBUG=cgothreadpool=1", "GODEBUG=cgothreadpool=8", "GODEBUG=cgothreadpool=1000")
+}
+
+func TestCgoThreadStack(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "solaris":
+		t.Skipf("no cgo thread stack size on %s", runtime.GOOS)
+	}
+	testCgoThreadStartBurst(t, "GODEBUG=cgothreadstack=262144", "GODEBUG=cgothreadstack=1", "GODEBUG=cgothreadstack=262144,cgothreadpool=4")
+}
+
+func TestCgoThreadStartBatch(t *testing.T) {
+	if runtime.GOOS == "plan9" || runtime.GOOS == "windows" {
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	// With many Ps blocked in C at once, sysmon retakes several
+	// of them in one pass and starts their Ms as a batch.
+	testCgoThreadStartBurst(t, "GOMAXPROCS=16", "GOMAXPROCS=16 GODEBUG=cgothreadpool=4")
+}
+
+func TestCgoThreadAffinity(t *testing.T) {
+	if runtime.GOOS != "linux" && runtime.GOOS != "freebsd" {
+		t.Skipf("no NUMA placement on %s", runtime.GOOS)
+	}
+	testCgoThreadStartBurst(t, "GODEBUG=cgothreadaffinity=1", "GODEBUG=cgothreadaffinity=1,cgothreadpool=4")
+	got := runTestProg(t, "testprogcgo", "LockOSThreadNode")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q got %v", want, got)
+	}
+}
+
+// testCgoThreadStartBurst runs CgoThreadStartBurst once for each
+// space-separated list of environment settings.
+func testCgoThreadStartBurst(t *testing.T, envs ...string) {
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, env := range envs {
+		cmd := testEnv(exec.Command(exe, "CgoThreadStartBurst"))
+		cmd.Env = append(cmd.Env, strings.Fields(env)...)
+		got, _ := cmd.CombinedOutput()
+		if want := "OK\n"; string(got) != want {
+			t.Errorf("%s: expected %q, got %v", env, want, string(got))
+		}
+	}
+}
+
+func TestCgoInitTrace(t *testing.T) {
+	switch runtime.GOOS {
+	case "openbsd", "plan9", "windows":
+		t.Skipf("no cgo startup events on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CgoStartup"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgoinittrace=1")
+	got, err := cmd.CombinedOutput()
+	if err != nil {
+		t.Fatalf("%v\n%s", err, got)
+	}
+	want := []string{"cgoinit: x_cgo_notify_runtime_init_done @"}
+	if runtime.GOOS == "linux" {
+		want = append(want, "cgoinit: x_cgo_init @0us +0us\n")
+		switch runtime.GOARCH {
+		case "ppc64", "ppc64le", "s390x":
+			// x_cgo_init has no x_cgo_inittls phase.
+		default:
+			want = append(want, "cgoinit: x_cgo_init: inittls @")
+		}
+	}
+	for _, w := range want {
+		if !strings.Contains(string(got), w) {
+			t.Errorf("output does not contain %q:\n%s", w, got)
+		}
+	}
+}
+
+// BenchmarkCgoStartup measures the time to start and exit a small
+// program that uses cgo, including runtime/cgo's x_cgo_init.
+func BenchmarkCgoStartup(b *testing.B) {
+	testenv.MustHaveGoBuild(b)
+	exe, err := buildTestProg(b, "testprogcgo")
+	if err != nil {
+		b.Fatal(err)
+	}
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if out, err := testEnv(exec.Command(exe, "CgoStartup")).CombinedOutput(); err != nil {
+			b.Fatalf("%v\n%s", err, out)
+		}
+	}
+}
+
+func TestCgoTrace(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	f, err := ioutil.TempFile("", "tracecgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	f.Close()
+	defer os.Remove(f.Name())
+	cmd := testEnv(exec.Command(exe, "TraceCgo"))
+	cmd.Env = append(cmd.Env, "GO_TRACECGO_FILE="+f.Name())
+	got, err := cmd.CombinedOutput()
+	if err != nil || string(got) != "OK\n" {
+		t.Fatalf("%v\n%s", err, got)
+	}
+	f, err = os.Open(f.Name())
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	events, err := trace.Parse(f, exe)
+	if err == trace.ErrTimeOrder {
+		t.Skipf("skipping trace: %v", err)
+	}
+	if err != nil {
+		t.Fatalf("failed to parse trace: %v", err)
+	}
+	var call, callback, needm bool
+	for _, ev := range events {
+		switch ev.Type {
+		case trace.EvCgoCall:
+			if ev.Link != nil && len(ev.Stk) > 0 && strings.Contains(ev.Stk[0].Fn, "_Cfunc_traceCgo") {
+				call = true
+			}
+		case trace.EvCgoCallback:
+			if ev.Link != nil {
+				callback = true
+				if ev.Args[0] > 0 {
+					needm = true
+				}
+			}
+		}
+	}
+	if !call {
+		t.Errorf("no linked cgo call event with a _Cfunc_ stack")
+	}
+	if !callback {
+		t.Errorf("no linked cgo callback event")
+	}
+	if !needm {
+		t.Errorf("no cgo callback event recording needm time")
+	}
+}
+
+func TestCgoThreadStats(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoThreadStats")
+	want := "inc=0 peak=true created=true extram=true\n"
+	if got != want {
+		t.Errorf("got %q, want %q", got, want)
+	}
+}
+
+func TestCgoStats(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CgoStats"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgocallbackstats=1")
+	got, err := cmd.CombinedOutput()
+	if err != nil {
+		t.Fatalf("%s\n\n%v", got, err)
+	}
+	want := "needm=true waits=true idle=true calls=true cmalloc=true checks=true c=true\n"
+	if string(got) != want {
+		t.Errorf("got %q, want %q", got, want)
+	}
+}
+
+func TestCgoStatsPage(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoStatsPage")
+	want := "update=true heap=true numgc=true goroutines=true needm=true\n"
+	if got != want {
+		t.Errorf("got %q, want %q", got, want)
+	}
+}
+
+func TestCgoThreadReset(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoThreadReset")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoCallbackSmallStack(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoCallbackSmallStack")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoSIGPROFMalloc(t *testing.T) {
+	switch runtime.GOOS {
+	case "plan9", "windows":
+		t.Skipf("no pthreads on %s", runtime.GOOS)
+	}
+	got := runTestProg(t, "testprogcgo", "CgoSIGPROFMalloc")
+	want := "OK\n"
+	if got != want {
+		t.Errorf("expected %q, got %v", want, got)
+	}
+}
+
+func TestCgoFlight(t *testing.T) {
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprogcgo")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "CgoFlight"))
+	cmd.Env = append(cmd.Env, "GODEBUG=cgoflight=4")
+	got, _ := cmd.CombinedOutput()
+	// The ring keeps only the last 4 events, those of the call
+	// that calls back into Go.
+	want := []string{
+		"cgo transitions on m",
+		" call main._Cfunc_cgoFlightCallback\n",
+		" callback main._cgoexpdirect_",
+		" callback done main._cgoexpdirect_",
+		" return main._Cfunc_cgoFlightCallback\n",
+	}
+	for _, w := range want {
+		if !strings.Contains(string(got), w) {
+			t.Errorf("output does not contain %q:\n%s", w, got)
+		}
+	}
+	if strings.Contains(string(got), "main._Cfunc_cgoFlightNop\n") {
+		t.Errorf("ring of 4 events kept older events:\n%s", got)
+	}
+}
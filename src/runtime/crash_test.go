@@ -69,7 +69,7 @@ func runTestProg(t *testing.T, binary, name string) string {
 	return string(got)
 }
 
-func buildTestProg(t *testing.T, binary string) (string, error) {
+func buildTestProg(t testing.TB, binary string) (string, error) {
 	checkStaleRuntime(t)
 
 	testprog.Lock()
@@ -111,7 +111,7 @@ var (
 	staleRuntimeErr  error
 )
 
-func checkStaleRuntime(t *testing.T) {
+func checkStaleRuntime(t testing.TB) {
 	staleRuntimeOnce.Do(func() {
 		// 'go run' uses the installed copy of runtime.a, which may be out of date.
 		out, err := testEnv(exec.Command("go", "list", "-f", "{{.Stale}}", "runtime")).CombinedOutput()
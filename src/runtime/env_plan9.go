@@ -48,3 +48,4 @@ func gogetenv(key string) string {
 
 var _cgo_setenv unsafe.Pointer   // pointer to C function
 var _cgo_unsetenv unsafe.Pointer // pointer to C function
+var _cgo_setenvs unsafe.Pointer  // pointer to C function
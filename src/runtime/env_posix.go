@@ -23,6 +23,7 @@ func gogetenv(key string) string {
 
 var _cgo_setenv unsafe.Pointer   // pointer to C function
 var _cgo_unsetenv unsafe.Pointer // pointer to C function
+var _cgo_setenvs unsafe.Pointer  // pointer to C function
 
 // Update the C environment if cgo is loaded.
 // Called from syscall.Setenv.
@@ -46,6 +47,27 @@ func syscall_unsetenv_c(k string) {
 	asmcgocall(_cgo_unsetenv, unsafe.Pointer(&arg))
 }
 
+// Update the C environment if cgo is loaded, with one call into C.
+// Called from syscall.Setenvs.
+//go:linkname syscall_setenvs_c syscall.setenvs_c
+func syscall_setenvs_c(kv []string) {
+	if _cgo_setenvs == nil {
+		return
+	}
+	// A key and a value, or nil to unset the key, for each
+	// element of kv, then a nil key.
+	arg := make([]unsafe.Pointer, 0, 2*len(kv)+1)
+	for _, s := range kv {
+		if i := index(s, "="); i >= 0 {
+			arg = append(arg, cstring(s[:i]), cstring(s[i+1:]))
+		} else {
+			arg = append(arg, cstring(s), nil)
+		}
+	}
+	arg = append(arg, nil)
+	asmcgocall(_cgo_setenvs, unsafe.Pointer(&arg[0]))
+}
+
 func cstring(s string) unsafe.Pointer {
 	p := make([]byte, len(s)+1)
 	copy(p, s)
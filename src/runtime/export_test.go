@@ -32,6 +32,8 @@ var FuncPC = funcPC
 
 var Fastlog2 = fastlog2
 
+var Findnull = findnull
+
 type LFNode struct {
 	Next    uint64
 	Pushcnt uintptr
@@ -74,6 +76,24 @@ func RunSchedLocalQueueTest() {
 	}
 }
 
+// CgoRetakeHold records calls through the cgo function wrapper fn
+// that took d nanoseconds each, and returns how long retake then
+// leaves a P in a call through fn with its M. If returned, the call
+// has already returned and the P is in another system call.
+func CgoRetakeHold(fn uintptr, d int64, returned bool) int64 {
+	for i := 0; i < 16; i++ {
+		cgoCallRecord(fn, d)
+	}
+	_p_ := new(p)
+	_p_.syscalltick = 7
+	_p_.cgocallfn = fn
+	_p_.cgocalltick = _p_.syscalltick
+	if returned {
+		_p_.syscalltick++
+	}
+	return cgoCallExpected(_p_)
+}
+
 func RunSchedLocalQueueStealTest() {
 	p1 := new(p)
 	p2 := new(p)
@@ -244,3 +264,17 @@ func CountPagesInUse() (pagesInUse, counted uintptr) {
 
 	return
 }
+
+var PinnerLeakPanic = &pinnerLeakPanic
+
+func IsPinned(p unsafe.Pointer) bool { return isPinned(p) }
+
+func CgoIsGoPointer(p unsafe.Pointer) bool { return cgoIsGoPointer(p) }
+
+// CgoCheckTypedBlock makes the check that cgocheck=2 makes of a copy
+// into C memory of the value p points to.
+func CgoCheckTypedBlock(p interface{}) {
+	e := efaceOf(&p)
+	t := (*ptrtype)(unsafe.Pointer(e._type)).elem
+	cgoCheckTypedBlock(t, e.data, 0, t.size)
+}
@@ -27,6 +27,24 @@ It is a comma-separated list of name=val pairs setting these named variables:
 	allocfreetrace: setting allocfreetrace=1 causes every allocation to be
 	profiled and a stack trace printed on each object's allocation and free.
 
+	cgoaffinity: setting cgoaffinity=1 makes the scheduler prefer to run a
+	goroutine that has called C on the OS thread that ran its last call,
+	when that thread is idle, as it does after calls to C functions named
+	in #cgo affinity: directives. Calls to #cgo leaf: functions do not
+	count. This helps C libraries that keep state per thread, without
+	locking goroutines to threads.
+
+	cgoasyncthreads: setting cgoasyncthreads=N limits to N the number of
+	OS threads in the pool that runs calls to C functions named in #cgo async:
+	directives. The default is 64. Calls made while all the threads are busy
+	wait until one of them is free; their goroutines stay parked meanwhile.
+
+	cgocallbackstats: setting cgocallbackstats=1 causes the runtime to time
+	the phases of each call from C to Go: getting an M, waiting for a P,
+	running the Go function, and returning to C. The histograms can be
+	read with ReadCgoCallbackStats. It also makes the runtime time the
+	checks of Go pointers passed to C, for ReadCgoStats.
+
 	cgocheck: setting cgocheck=0 disables all checks for packages
 	using cgo to incorrectly pass Go pointers to non-Go code.
 	Setting cgocheck=1 (the default) enables relatively cheap
@@ -34,6 +52,89 @@ It is a comma-separated list of name=val pairs setting these named variables:
 	expensive checks that should not miss any errors, but will
 	cause your program to run slower.
 
+	cgochecksample: setting cgochecksample=N, with N > 1, makes the checks
+	enabled by cgocheck run about once in N times, chosen at random: the
+	checks of the pointers passed in each call to C or returned from Go
+	to C, and, with cgocheck=2, the checks of each pointer write. Errors
+	are then caught in a sample of a program's calls and writes at about
+	1/N of the cost of the checks. With cgocheck=2 every pointer write
+	still goes through the write barrier to be sampled.
+
+	cgoextram: setting cgoextram=N makes a program using cgo create N (at
+	most 1024) extra Ms, with their goroutine and signal stacks, during
+	runtime start-up, instead of one. Threads not created by Go borrow an
+	extra M on each call into Go; when the list of free extra Ms is empty
+	they wait while a new one is created. Setting N to the number of C
+	threads that call into Go at once avoids that wait, at the cost of the
+	memory for the Ms.
+
+	cgoflight: setting cgoflight=N makes each M record its last N (at most
+	4096) transitions between Go and C: calls to C, their returns, calls
+	back into Go and their returns. Crash tracebacks, including the one
+	printed on SIGQUIT, then end with these events for every M, with the
+	Go function involved and how long before the crash each happened.
+
+	cgofpunwind: setting cgofpunwind=1 on linux/amd64 makes the runtime
+	collect tracebacks of C code, for CPU profiles and crash tracebacks, by
+	following frame pointers, as if a traceback function had been
+	registered with SetCgoTraceback. Only C code compiled with frame
+	pointers (-fno-omit-frame-pointer) and running on threads started by
+	the runtime gets more than the interrupted PC. A later call to
+	SetCgoTraceback replaces the built-in unwinder.
+
+	cgoinittrace: setting cgoinittrace=1 causes the runtime to print the
+	startup events recorded by the C side of cgo once runtime initialization
+	is done: the library constructor starting initialization (c-archive and
+	c-shared only), the phases of x_cgo_init, and the runtime reporting that
+	it is ready. Each line gives the time since the first event and since
+	the previous one, in microseconds. Supported on Unix systems other than
+	OpenBSD; each phase of x_cgo_init is recorded on Linux only, and there
+	is no x_cgo_inittls phase on linux/ppc64, linux/ppc64le and linux/s390x.
+
+	cgoracesync: setting cgoracesync=1 in a program built with -race makes
+	each cgo call, and each call back into Go during it, synchronize for
+	the race detector only with calls to the same C function, rather than
+	with all calls into C and back. This removes contention in the race
+	runtime in programs that call C from many threads at once, but Go
+	code that only synchronization in C between different C functions
+	orders, as with separate lock and unlock functions, may be reported
+	as racing.
+
+	cgostickym: setting cgostickym=1 lets a thread not created by Go keep
+	the M it borrows for its first call into Go until the thread exits,
+	instead of borrowing and returning one on every call. This makes
+	repeated calls into Go from the same C threads cheaper. It uses a
+	pthread key destructor and has no effect on Windows or OpenBSD.
+	C code can do the same for chosen threads with GoRegisterThread;
+	see the cgo command documentation.
+
+	cgothreadaffinity: setting cgothreadaffinity=1 makes each OS thread that
+	the runtime creates through cgo on Linux or FreeBSD run only on the CPUs
+	of the NUMA node where the thread that created it was running. This keeps
+	C libraries with per-node memory pools on their node. FreeBSD before 13,
+	which cannot tell the CPU a thread runs on, leaves threads unplaced.
+	See also LockOSThreadNode.
+
+	cgothreadpool: setting cgothreadpool=N keeps up to N (at most 64)
+	pre-created, parked OS threads when using cgo on Linux and Windows. Starting
+	a new M then wakes a parked thread instead of creating one, which
+	makes bursts of thread creation, as when many goroutines block in
+	C calls at once, cheaper for the thread asking for the new M.
+
+	cgothreadstack: setting cgothreadstack=N sets the stack size, in bytes,
+	of the OS threads that the runtime creates through pthreads when using
+	cgo. These stacks are used by the scheduler and by C code called from
+	Go. The default is the system's default pthread stack size; values the
+	C library rejects, such as ones below PTHREAD_STACK_MIN, are ignored.
+	On Windows N is the stack reserve, rounded up to a multiple of 64 KB;
+	the default is 2 MB, or 1 MB on 386.
+
+	cgotracebackdepth: setting cgotracebackdepth=N sets the number of PCs
+	that the runtime asks the traceback function registered with
+	SetCgoTraceback to collect, in crash tracebacks and in CPU profiles
+	of C code. The default is 32 and the maximum is 1024. A CPU profile
+	records at most 64 PCs, C and Go frames together.
+
 	efence: setting efence=1 causes the allocator to run in a mode
 	where each object is allocated on a unique page and addresses are
 	never recycled.
@@ -82,6 +183,33 @@ It is a comma-separated list of name=val pairs setting these named variables:
 	If the line ends with "(forced)", this GC was forced by a
 	runtime.GC() call and all phases are STW.
 
+	heaphugepages: setting heaphugepages=1 makes the runtime ask Linux for
+	transparent huge pages for the heap with madvise(MADV_HUGEPAGE) as it
+	maps it, which matters when /sys/kernel/mm/transparent_hugepage/enabled
+	is "madvise". Setting heaphugepages=2 first tries to map the heap with
+	explicit huge pages (MAP_HUGETLB), which needs huge pages set aside in
+	/proc/sys/vm/nr_hugepages and keeps them resident for the life of the
+	program, and falls back to heaphugepages=1 when none are left. Both
+	settings grow the heap in whole huge pages, which reduces TLB misses for
+	programs with large heaps at the cost of a coarser heap. The results
+	can be read with ReadHeapHugePageStats.
+
+	heapnuma: setting heapnuma=1 makes the runtime ask Linux to place each
+	new part of the heap on the NUMA node of the CPU where the heap grew,
+	with mbind(MPOL_PREFERRED), rather than leaving it to the default
+	policy or one inherited from numactl. On multi-socket systems this
+	keeps heap memory near the threads that allocated it. The results can
+	be read with ReadHeapNUMAStats.
+
+	heapprefault: setting heapprefault=1 makes the runtime on Linux fault in
+	the pages of the heap when it grows the heap, or reuses heap memory it
+	had returned to the operating system, instead of when the program first
+	touches them. The faults are taken together, by whichever allocation
+	grows the heap, which suits programs that grow the heap ahead of time,
+	such as with a large allocation at startup, and must not take page
+	faults later on a latency-critical path. It makes the heap resident
+	as soon as it is mapped.
+
 	memprofilerate: setting memprofilerate=X will update the value of runtime.MemProfileRate.
 	When set to 0 memory profiling is disabled.  Refer to the description of
 	MemProfileRate for the default value.
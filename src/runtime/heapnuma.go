@@ -0,0 +1,40 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// NUMA statistics, for GODEBUG=heapnuma=1.
+
+package runtime
+
+import "runtime/internal/atomic"
+
+// HeapNUMANodes is the number of NUMA nodes for which HeapNUMAStats
+// keeps statistics. Heap memory grown on higher-numbered nodes is
+// left without a node policy.
+const HeapNUMANodes = 64
+
+// HeapNUMAStats records how the runtime has placed the heap on the
+// NUMA nodes of the system. It is filled in by ReadHeapNUMAStats.
+type HeapNUMAStats struct {
+	// Bound[i] is the number of bytes of heap that the runtime has
+	// asked the operating system to place on node i, because the
+	// heap grew while running on node i.
+	Bound [HeapNUMANodes]uint64
+
+	// Failed is the number of bytes of heap that could not be
+	// given a node, because the system does not support it or
+	// the node was out of range.
+	Failed uint64
+}
+
+var heapNUMAStats HeapNUMAStats
+
+// ReadHeapNUMAStats fills stats with the NUMA statistics of the heap.
+// The runtime places the heap only on Linux, if the program runs with
+// GODEBUG=heapnuma=1; otherwise the statistics are all zero.
+func ReadHeapNUMAStats(stats *HeapNUMAStats) {
+	for i := range stats.Bound {
+		stats.Bound[i] = atomic.Load64(&heapNUMAStats.Bound[i])
+	}
+	stats.Failed = atomic.Load64(&heapNUMAStats.Failed)
+}
@@ -0,0 +1,44 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// Huge page statistics, for GODEBUG=heaphugepages=N.
+
+package runtime
+
+import "runtime/internal/atomic"
+
+// HeapHugePageStats records how much of the heap the runtime has asked
+// the operating system to back with huge pages. It is filled in by
+// ReadHeapHugePageStats.
+type HeapHugePageStats struct {
+	// HugeTLB is the number of bytes of heap mapped with explicit
+	// huge pages (MAP_HUGETLB on Linux). These bytes are always
+	// backed by huge pages and are never returned to the
+	// operating system.
+	HugeTLB uint64
+
+	// Advised is the number of bytes of heap for which the runtime
+	// asked for transparent huge pages (MADV_HUGEPAGE on Linux).
+	// Whether they are backed by huge pages is up to the kernel;
+	// on Linux, see AnonHugePages in /proc/self/smaps.
+	Advised uint64
+
+	// Fallbacks is the number of times mapping heap with explicit
+	// huge pages failed, so that the runtime asked for transparent
+	// huge pages instead. After the first failure, the runtime
+	// stops trying explicit huge pages.
+	Fallbacks uint64
+}
+
+var heapHugePageStats HeapHugePageStats
+
+// ReadHeapHugePageStats fills stats with the huge page statistics of
+// the heap. The runtime asks for huge pages only on Linux, if the
+// program runs with GODEBUG=heaphugepages=N; otherwise the statistics
+// are all zero.
+func ReadHeapHugePageStats(stats *HeapHugePageStats) {
+	stats.HugeTLB = atomic.Load64(&heapHugePageStats.HugeTLB)
+	stats.Advised = atomic.Load64(&heapHugePageStats.Advised)
+	stats.Fallbacks = atomic.Load64(&heapHugePageStats.Fallbacks)
+}
@@ -6,7 +6,8 @@
 // Initialize head to 0, compare with 0 to test for emptiness.
 // The stack does not keep pointers to nodes,
 // so they can be garbage collected if there are no other pointers to nodes.
-// The following code runs only on g0 stack.
+// The following code runs only on g0 stack, or,
+// for the cgo extra m list, on a thread with no g at all.
 
 package runtime
 
@@ -15,6 +16,7 @@ import (
 	"unsafe"
 )
 
+//go:nosplit
 func lfstackpush(head *uint64, node *lfnode) {
 	node.pushcnt++
 	new := lfstackPack(node, node.pushcnt)
@@ -31,6 +33,7 @@ func lfstackpush(head *uint64, node *lfnode) {
 	}
 }
 
+//go:nosplit
 func lfstackpop(head *uint64) unsafe.Pointer {
 	for {
 		old := atomic.Load64(head)
@@ -10,10 +10,12 @@ import "unsafe"
 
 // On 32-bit systems, the stored uint64 has a 32-bit pointer and 32-bit count.
 
+//go:nosplit
 func lfstackPack(node *lfnode, cnt uintptr) uint64 {
 	return uint64(uintptr(unsafe.Pointer(node)))<<32 | uint64(cnt)
 }
 
+//go:nosplit
 func lfstackUnpack(val uint64) *lfnode {
 	return (*lfnode)(unsafe.Pointer(uintptr(val >> 32)))
 }
@@ -34,10 +34,12 @@ const (
 	cntBits = 64 - addrBits + 3
 )
 
+//go:nosplit
 func lfstackPack(node *lfnode, cnt uintptr) uint64 {
 	return uint64(uintptr(unsafe.Pointer(node)))<<(64-addrBits) | uint64(cnt&(1<<cntBits-1))
 }
 
+//go:nosplit
 func lfstackUnpack(val uint64) *lfnode {
 	if GOARCH == "amd64" {
 		// amd64 systems can place the stack above the VA hole, so we need to sign extend
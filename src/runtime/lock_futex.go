@@ -135,6 +135,13 @@ func notewakeup(n *note) {
 	futexwakeup(key32(&n.key), 1)
 }
 
+// notetrywakeup wakes n if it has not been woken already.
+func notetrywakeup(n *note) {
+	if atomic.Cas(key32(&n.key), 0, 1) {
+		futexwakeup(key32(&n.key), 1)
+	}
+}
+
 func notesleep(n *note) {
 	gp := getg()
 	if gp != gp.m.g0 {
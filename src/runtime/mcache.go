@@ -40,6 +40,12 @@ type mcache struct {
 	local_largefree  uintptr                  // bytes freed for large objects (>maxsmallsize)
 	local_nlargefree uintptr                  // number of frees for large objects (>maxsmallsize)
 	local_nsmallfree [_NumSizeClasses]uintptr // number of frees for small objects (<=maxsmallsize)
+	local_cmalloc    uintptr                  // bytes of C memory allocated by cmalloc
+	local_ncmalloc   uintptr                  // number of cmalloc calls
+
+	next_csample int32 // trigger C allocation sample after allocating this many bytes
+
+	csmall [cSmallClasses]gclinkptr // free lists of small C objects; see cgomalloc.go
 }
 
 // A gclink is a node in a linked list of blocks, like mlink,
@@ -80,6 +86,7 @@ func allocmcache() *mcache {
 		c.alloc[i] = &emptymspan
 	}
 	c.next_sample = nextSample()
+	c.next_csample = nextSample()
 	return c
 }
 
@@ -87,6 +94,7 @@ func freemcache(c *mcache) {
 	systemstack(func() {
 		c.releaseAll()
 		stackcache_clear(c)
+		csmallflush(c)
 
 		// NOTE(rsc,rlh): If gcworkbuffree comes back, we need to coordinate
 		// with the stealing of gcworkbufs during garbage collection to avoid
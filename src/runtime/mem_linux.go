@@ -5,6 +5,7 @@
 package runtime
 
 import (
+	"runtime/internal/atomic"
 	"runtime/internal/sys"
 	"unsafe"
 )
@@ -12,6 +13,8 @@ import (
 const (
 	_PAGE_SIZE = sys.PhysPageSize
 	_EACCES    = 13
+
+	_MPOL_PREFERRED = 1
 )
 
 // NOTE: vec must be just 1 byte long here.
@@ -38,15 +41,15 @@ func addrspace_free(v unsafe.Pointer, n uintptr) bool {
 	return true
 }
 
-func mmap_fixed(v unsafe.Pointer, n uintptr, prot, flags, fd int32, offset uint32) unsafe.Pointer {
-	p := mmap(v, n, prot, flags, fd, offset)
+func mmap_fixed(v unsafe.Pointer, n uintptr, prot, flags, fd int32) unsafe.Pointer {
+	p := mmap(v, n, prot, flags, fd, 0)
 	// On some systems, mmap ignores v without
 	// MAP_FIXED, so retry if the address space is free.
 	if p != v && addrspace_free(v, n) {
 		if uintptr(p) > 4096 {
 			munmap(p, n)
 		}
-		p = mmap(v, n, prot, flags|_MAP_FIXED, fd, offset)
+		p = mmap(v, n, prot, flags|_MAP_FIXED, fd, 0)
 	}
 	return p
 }
@@ -72,6 +75,17 @@ func sysAlloc(n uintptr, sysStat *uint64) unsafe.Pointer {
 }
 
 func sysUnused(v unsafe.Pointer, n uintptr) {
+	if start, end := heapHugeTLBStart, heapHugeTLBEnd; uintptr(v) < end && uintptr(v)+n > start {
+		// Explicit huge pages stay resident; see sysHugePages.
+		if uintptr(v) < start {
+			sysUnused(v, start-uintptr(v))
+		}
+		if uintptr(v)+n > end {
+			sysUnused(unsafe.Pointer(end), uintptr(v)+n-end)
+		}
+		return
+	}
+
 	// By default, Linux's "transparent huge page" support will
 	// merge pages into a huge page if there's even a single
 	// present regular page, undoing the effects of the DONTNEED
@@ -163,6 +177,11 @@ func sysUsed(v unsafe.Pointer, n uintptr) {
 			madvise(unsafe.Pointer(beg), end-beg, _MADV_HUGEPAGE)
 		}
 	}
+
+	// sysUsed is only called for the heap.
+	if debug.heapprefault > 0 {
+		sysPrefault(v, n)
+	}
 }
 
 // Don't split the stack as this function may be invoked without a valid G,
@@ -183,7 +202,7 @@ func sysReserve(v unsafe.Pointer, n uintptr, reserved *bool) unsafe.Pointer {
 	// if we can reserve at least 64K and check the assumption in SysMap.
 	// Only user-mode Linux (UML) rejects these requests.
 	if sys.PtrSize == 8 && uint64(n) > 1<<32 {
-		p := mmap_fixed(v, 64<<10, _PROT_NONE, _MAP_ANON|_MAP_PRIVATE, -1, 0)
+		p := mmap_fixed(v, 64<<10, _PROT_NONE, _MAP_ANON|_MAP_PRIVATE, -1)
 		if p != v {
 			if uintptr(p) >= 4096 {
 				munmap(p, 64<<10)
@@ -208,7 +227,7 @@ func sysMap(v unsafe.Pointer, n uintptr, reserved bool, sysStat *uint64) {
 
 	// On 64-bit, we don't actually have v reserved, so tread carefully.
 	if !reserved {
-		p := mmap_fixed(v, n, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_PRIVATE, -1, 0)
+		p := mmap_fixed(v, n, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_PRIVATE, -1)
 		if uintptr(p) == _ENOMEM {
 			throw("runtime: out of memory")
 		}
@@ -216,14 +235,114 @@ func sysMap(v unsafe.Pointer, n uintptr, reserved bool, sysStat *uint64) {
 			print("runtime: address space conflict: map(", v, ") = ", p, "\n")
 			throw("runtime: address space conflict")
 		}
+	} else {
+		p := mmap(v, n, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_FIXED|_MAP_PRIVATE, -1, 0)
+		if uintptr(p) == _ENOMEM {
+			throw("runtime: out of memory")
+		}
+		if p != v {
+			throw("runtime: cannot map pages in arena address space")
+		}
+	}
+
+	if sysStat == &memstats.heap_sys && debug.heaphugepages > 0 {
+		sysHugePages(v, n)
+	}
+	if sysStat == &memstats.heap_sys && debug.heapnuma > 0 {
+		sysNUMABind(v, n)
+	}
+	if sysStat == &memstats.heap_sys && debug.heapprefault > 0 {
+		sysPrefault(v, n)
+	}
+}
+
+// sysPrefault faults in every page of [v, v+n), a part of the heap
+// that is mapped but not yet in use, by writing a zero to each.
+// The heap lock is held and the pages belong to no span the allocator
+// can hand out, so the writes cannot race with the program; and free
+// heap memory is either zero already or marked as needing zeroing.
+// Prefaulting here, after any huge page and NUMA setup, means the
+// pages are faulted in once, where the heap grows, rather than one
+// at a time wherever the program first touches them.
+func sysPrefault(v unsafe.Pointer, n uintptr) {
+	for p := uintptr(v); p < uintptr(v)+n; p += _PAGE_SIZE {
+		*(*uint8)(unsafe.Pointer(p)) = 0
+	}
+}
+
+// sysNUMABind asks Linux to place the pages of [v, v+n), a part of
+// the heap arena that sysMap has just mapped, on the NUMA node of the
+// CPU the heap is growing on. The policy is MPOL_PREFERRED, so pages
+// still come from other nodes when that node is out of memory. Pages
+// are placed when first touched, usually by the goroutine whose
+// allocation grew the heap and by the others on its P, so they start
+// out near the code that uses them.
+func sysNUMABind(v unsafe.Pointer, n uintptr) {
+	var cpu, node uint32
+	if getcpu(&cpu, &node, nil) != 0 || node >= HeapNUMANodes {
+		atomic.Xadd64(&heapNUMAStats.Failed, int64(n))
 		return
 	}
+	mask := uint64(1) << node
+	// The kernel reads maxnode-1 bits of the mask.
+	if mbind(v, n, _MPOL_PREFERRED, &mask, HeapNUMANodes+1, 0) != 0 {
+		atomic.Xadd64(&heapNUMAStats.Failed, int64(n))
+		return
+	}
+	atomic.Xadd64(&heapNUMAStats.Bound[node], int64(n))
+}
+
+// [heapHugeTLBStart, heapHugeTLBEnd) is the part of the heap mapped
+// with MAP_HUGETLB. heapHugeTLBFailed is set once mapping with
+// MAP_HUGETLB has failed. All are protected by mheap_.lock.
+var (
+	heapHugeTLBStart  uintptr
+	heapHugeTLBEnd    uintptr
+	heapHugeTLBFailed bool
+)
 
-	p := mmap(v, n, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_FIXED|_MAP_PRIVATE, -1, 0)
-	if uintptr(p) == _ENOMEM {
-		throw("runtime: out of memory")
+// sysHugePages asks for huge pages to back the huge pages wholly
+// inside [v, v+n), a part of the heap arena that sysMap has just
+// mapped. With GODEBUG=heaphugepages=2 it first tries to map the
+// range again with MAP_HUGETLB, which succeeds only if the system has
+// enough huge pages set aside (see /proc/sys/vm/nr_hugepages); mheap
+// keeps the end of the arena aligned to huge pages so that the whole
+// range qualifies. Otherwise, or if that fails, it asks for
+// transparent huge pages with MADV_HUGEPAGE.
+func sysHugePages(v unsafe.Pointer, n uintptr) {
+	if sys.HugePageSize == 0 {
+		return
 	}
-	if p != v {
-		throw("runtime: cannot map pages in arena address space")
+	var s uintptr = sys.HugePageSize // division by constant 0 is a compile-time error :(
+	beg := (uintptr(v) + (s - 1)) &^ (s - 1)
+	end := (uintptr(v) + n) &^ (s - 1)
+	if beg >= end {
+		return
 	}
+
+	// The explicit huge pages must stay contiguous, so that
+	// sysUnused can tell them apart cheaply; so only try on 64-bit
+	// systems, where the arena grows contiguously.
+	if debug.heaphugepages >= 2 && sys.PtrSize == 8 && !heapHugeTLBFailed && (heapHugeTLBEnd == 0 || heapHugeTLBEnd == beg) {
+		p := mmap(unsafe.Pointer(beg), end-beg, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_FIXED|_MAP_PRIVATE|_MAP_HUGETLB, -1, 0)
+		if uintptr(p) == beg {
+			if heapHugeTLBStart == 0 {
+				heapHugeTLBStart = beg
+			}
+			heapHugeTLBEnd = end
+			atomic.Xadd64(&heapHugePageStats.HugeTLB, int64(end-beg))
+			return
+		}
+		// A failed mmap with MAP_FIXED may have unmapped the
+		// range already, so map it again the ordinary way.
+		p = mmap(unsafe.Pointer(beg), end-beg, _PROT_READ|_PROT_WRITE, _MAP_ANON|_MAP_FIXED|_MAP_PRIVATE, -1, 0)
+		if uintptr(p) != beg {
+			throw("runtime: cannot map pages in arena address space")
+		}
+		heapHugeTLBFailed = true
+		atomic.Xadd64(&heapHugePageStats.Fallbacks, 1)
+	}
+
+	madvise(unsafe.Pointer(beg), end-beg, _MADV_HUGEPAGE)
+	atomic.Xadd64(&heapHugePageStats.Advised, int64(end-beg))
 }
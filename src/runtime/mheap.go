@@ -66,6 +66,7 @@ type mheap struct {
 	cachealloc            fixalloc // allocator for mcache*
 	specialfinalizeralloc fixalloc // allocator for specialfinalizer*
 	specialprofilealloc   fixalloc // allocator for specialprofile*
+	specialpinnedalloc    fixalloc // allocator for specialpinned*
 	speciallock           mutex    // lock for special record allocators.
 }
 
@@ -364,6 +365,7 @@ func (h *mheap) init(spans_size uintptr) {
 	h.cachealloc.init(unsafe.Sizeof(mcache{}), nil, nil, &memstats.mcache_sys)
 	h.specialfinalizeralloc.init(unsafe.Sizeof(specialfinalizer{}), nil, nil, &memstats.other_sys)
 	h.specialprofilealloc.init(unsafe.Sizeof(specialprofile{}), nil, nil, &memstats.other_sys)
+	h.specialpinnedalloc.init(unsafe.Sizeof(specialpinned{}), nil, nil, &memstats.other_sys)
 
 	// h->mapcache needs no init
 	for i := range h.free {
@@ -717,6 +719,12 @@ func (h *mheap) grow(npage uintptr) bool {
 	if ask < _HeapAllocChunk {
 		ask = _HeapAllocChunk
 	}
+	if debug.heaphugepages > 0 && sys.HugePageSize != 0 {
+		// Keep the end of the arena aligned to huge pages,
+		// so that all of it can be backed by them; see
+		// sysHugePages.
+		ask = round(h.arena_used+ask, sys.HugePageSize) - h.arena_used
+	}
 
 	v := h.sysAlloc(ask)
 	if v == nil {
@@ -1041,6 +1049,7 @@ func (list *mSpanList) insertBack(span *mspan) {
 const (
 	_KindSpecialFinalizer = 1
 	_KindSpecialProfile   = 2
+	_KindSpecialPinned    = 3 // see pinner.go
 	// Note: The finalizer special must be first because if we're freeing
 	// an object, a finalizer special will cause the freeing operation
 	// to abort, and we want to keep the other special records around
@@ -1237,6 +1246,12 @@ func freespecial(s *special, p unsafe.Pointer, size uintptr) {
 		lock(&mheap_.speciallock)
 		mheap_.specialprofilealloc.free(unsafe.Pointer(sp))
 		unlock(&mheap_.speciallock)
+	case _KindSpecialPinned:
+		// The object was pinned by a Pinner that has been
+		// dropped without calling Unpin.
+		lock(&mheap_.speciallock)
+		mheap_.specialpinnedalloc.free(unsafe.Pointer(s))
+		unlock(&mheap_.speciallock)
 	default:
 		throw("bad special kind")
 		panic("not reached")
@@ -22,6 +22,8 @@ const (
 	// profile types
 	memProfile bucketType = 1 + iota
 	blockProfile
+	cmallocProfile
+	cgoBlockProfile
 
 	// size of bucket hash table
 	buckHashSize = 179999
@@ -43,14 +45,16 @@ type bucketType int
 type bucket struct {
 	next    *bucket
 	allnext *bucket
-	typ     bucketType // memBucket or blockBucket
+	typ     bucketType // memProfile, blockProfile, cmallocProfile or cgoBlockProfile
 	hash    uintptr
 	size    uintptr
 	nstk    uintptr
 }
 
 // A memRecord is the bucket data for a bucket of type memProfile,
-// part of the memory profile.
+// part of the memory profile, or of type cmallocProfile, part of the
+// C allocation profile. C allocations are counted in allocs and
+// alloc_bytes directly, since there are no frees to wait for.
 type memRecord struct {
 	// The following complex 3-stage scheme of stats accumulation
 	// is required to obtain a consistent picture of mallocs and frees
@@ -83,7 +87,8 @@ type memRecord struct {
 }
 
 // A blockRecord is the bucket data for a bucket of type blockProfile,
-// part of the blocking profile.
+// part of the blocking profile, or of type cgoBlockProfile, part of the
+// cgo blocking profile.
 type blockRecord struct {
 	count  int64
 	cycles int64
@@ -92,6 +97,8 @@ type blockRecord struct {
 var (
 	mbuckets  *bucket // memory profile buckets
 	bbuckets  *bucket // blocking profile buckets
+	cbuckets  *bucket // C allocation profile buckets
+	gbuckets  *bucket // cgo blocking profile buckets
 	buckhash  *[179999]*bucket
 	bucketmem uintptr
 )
@@ -102,9 +109,9 @@ func newBucket(typ bucketType, nstk int) *bucket {
 	switch typ {
 	default:
 		throw("invalid profile bucket type")
-	case memProfile:
+	case memProfile, cmallocProfile:
 		size += unsafe.Sizeof(memRecord{})
-	case blockProfile:
+	case blockProfile, cgoBlockProfile:
 		size += unsafe.Sizeof(blockRecord{})
 	}
 
@@ -121,18 +128,20 @@ func (b *bucket) stk() []uintptr {
 	return stk[:b.nstk:b.nstk]
 }
 
-// mp returns the memRecord associated with the memProfile bucket b.
+// mp returns the memRecord associated with the memProfile or
+// cmallocProfile bucket b.
 func (b *bucket) mp() *memRecord {
-	if b.typ != memProfile {
+	if b.typ != memProfile && b.typ != cmallocProfile {
 		throw("bad use of bucket.mp")
 	}
 	data := add(unsafe.Pointer(b), unsafe.Sizeof(*b)+b.nstk*unsafe.Sizeof(uintptr(0)))
 	return (*memRecord)(data)
 }
 
-// bp returns the blockRecord associated with the blockProfile bucket b.
+// bp returns the blockRecord associated with the blockProfile or
+// cgoBlockProfile bucket b.
 func (b *bucket) bp() *blockRecord {
-	if b.typ != blockProfile {
+	if b.typ != blockProfile && b.typ != cgoBlockProfile {
 		throw("bad use of bucket.bp")
 	}
 	data := add(unsafe.Pointer(b), unsafe.Sizeof(*b)+b.nstk*unsafe.Sizeof(uintptr(0)))
@@ -181,10 +190,17 @@ func stkbucket(typ bucketType, size uintptr, stk []uintptr, alloc bool) *bucket
 	b.size = size
 	b.next = buckhash[i]
 	buckhash[i] = b
-	if typ == memProfile {
+	switch typ {
+	case memProfile:
 		b.allnext = mbuckets
 		mbuckets = b
-	} else {
+	case cmallocProfile:
+		b.allnext = cbuckets
+		cbuckets = b
+	case cgoBlockProfile:
+		b.allnext = gbuckets
+		gbuckets = b
+	default:
 		b.allnext = bbuckets
 		bbuckets = b
 	}
@@ -250,6 +266,18 @@ func mProf_Malloc(p unsafe.Pointer, size uintptr) {
 	})
 }
 
+// Called by cmalloc to record a profiled C allocation.
+func mProf_CMalloc(size uintptr) {
+	var stk [maxStack]uintptr
+	nstk := callers(3, stk[:])
+	lock(&proflock)
+	b := stkbucket(cmallocProfile, size, stk[:nstk], true)
+	mp := b.mp()
+	mp.allocs++
+	mp.alloc_bytes += size
+	unlock(&proflock)
+}
+
 // Called when freeing a profiled block.
 func mProf_Free(b *bucket, size uintptr) {
 	lock(&proflock)
@@ -268,6 +296,12 @@ var blockprofilerate uint64 // in CPU ticks
 // To include every blocking event in the profile, pass rate = 1.
 // To turn off profiling entirely, pass rate <= 0.
 func SetBlockProfileRate(rate int) {
+	atomic.Store64(&blockprofilerate, uint64(blockProfileTicks(rate)))
+}
+
+// blockProfileTicks converts a profiling rate in nanoseconds, as
+// passed to SetBlockProfileRate, to CPU ticks.
+func blockProfileTicks(rate int) int64 {
 	var r int64
 	if rate <= 0 {
 		r = 0 // disable profiling
@@ -280,15 +314,39 @@ func SetBlockProfileRate(rate int) {
 			r = 1
 		}
 	}
+	return r
+}
+
+var cgoblockprofilerate uint64 // in CPU ticks
 
-	atomic.Store64(&blockprofilerate, uint64(r))
+// SetCgoBlockProfileRate controls the fraction of calls from Go to C
+// that are reported in the cgo blocking profile, which records the
+// wall-clock time goroutines spend in C calls, from entering the call
+// to getting a P back, whether the thread is running or blocked in
+// the kernel. The profiler aims to sample an average of one call per
+// rate nanoseconds spent in C, so long calls are always recorded.
+//
+// To include every call in the profile, pass rate = 1.
+// To turn off profiling entirely, pass rate <= 0.
+func SetCgoBlockProfileRate(rate int) {
+	atomic.Store64(&cgoblockprofilerate, uint64(blockProfileTicks(rate)))
 }
 
 func blockevent(cycles int64, skip int) {
+	saveblockevent(cycles, skip+1, blockProfile, &blockprofilerate)
+}
+
+// cgoblockevent records a call from Go to C that took cycles CPU
+// ticks in the cgo blocking profile.
+func cgoblockevent(cycles int64, skip int) {
+	saveblockevent(cycles, skip+1, cgoBlockProfile, &cgoblockprofilerate)
+}
+
+func saveblockevent(cycles int64, skip int, which bucketType, ratep *uint64) {
 	if cycles <= 0 {
 		cycles = 1
 	}
-	rate := int64(atomic.Load64(&blockprofilerate))
+	rate := int64(atomic.Load64(ratep))
 	if rate <= 0 || (rate > cycles && int64(fastrand1())%rate > cycles) {
 		return
 	}
@@ -301,7 +359,7 @@ func blockevent(cycles int64, skip int) {
 		nstk = gcallers(gp.m.curg, skip, stk[:])
 	}
 	lock(&proflock)
-	b := stkbucket(blockProfile, 0, stk[:nstk], true)
+	b := stkbucket(which, 0, stk[:nstk], true)
 	b.bp().count++
 	b.bp().cycles += cycles
 	unlock(&proflock)
@@ -431,6 +489,36 @@ func MemProfile(p []MemProfileRecord, inuseZero bool) (n int, ok bool) {
 	return
 }
 
+// CMallocProfile returns n, the number of records in the current C
+// allocation profile, which samples the C memory allocated from Go by
+// C.malloc, C.CString and C.CBytes at the rate set by MemProfileRate.
+// If len(p) >= n, CMallocProfile copies the profile into p and returns
+// n, true. If len(p) < n, CMallocProfile does not change p and returns
+// n, false.
+//
+// The runtime does not see C memory freed, since C code frees it, so
+// the records count no frees. A site whose allocations keep growing
+// between two profiles is a candidate for a leak.
+//
+// Most clients should use the runtime/pprof package instead
+// of calling CMallocProfile directly.
+func CMallocProfile(p []MemProfileRecord) (n int, ok bool) {
+	lock(&proflock)
+	for b := cbuckets; b != nil; b = b.allnext {
+		n++
+	}
+	if n <= len(p) {
+		ok = true
+		idx := 0
+		for b := cbuckets; b != nil; b = b.allnext {
+			record(&p[idx], b)
+			idx++
+		}
+	}
+	unlock(&proflock)
+	return
+}
+
 // Write b's data to r.
 func record(r *MemProfileRecord, b *bucket) {
 	mp := b.mp()
@@ -470,12 +558,39 @@ type BlockProfileRecord struct {
 // of calling BlockProfile directly.
 func BlockProfile(p []BlockProfileRecord) (n int, ok bool) {
 	lock(&proflock)
-	for b := bbuckets; b != nil; b = b.allnext {
+	n, ok = copyBlockProfile(bbuckets, p)
+	unlock(&proflock)
+	return
+}
+
+// CgoBlockProfile returns n, the number of records in the current cgo
+// blocking profile. If len(p) >= n, CgoBlockProfile copies the profile
+// into p and returns n, true. If len(p) < n, CgoBlockProfile does not
+// change p and returns n, false.
+//
+// Each record's stack starts at the function that cgo generated to
+// call the C function, named _Cfunc_ followed by the name of the C
+// function, and its Cycles are the CPU ticks spent in the calls.
+//
+// Most clients should use the runtime/pprof package instead
+// of calling CgoBlockProfile directly.
+func CgoBlockProfile(p []BlockProfileRecord) (n int, ok bool) {
+	lock(&proflock)
+	n, ok = copyBlockProfile(gbuckets, p)
+	unlock(&proflock)
+	return
+}
+
+// copyBlockProfile copies the records of the bucket list starting at
+// list into p for BlockProfile and CgoBlockProfile.
+// proflock must be held.
+func copyBlockProfile(list *bucket, p []BlockProfileRecord) (n int, ok bool) {
+	for b := list; b != nil; b = b.allnext {
 		n++
 	}
 	if n <= len(p) {
 		ok = true
-		for b := bbuckets; b != nil; b = b.allnext {
+		for b := list; b != nil; b = b.allnext {
 			bp := b.bp()
 			r := &p[0]
 			r.Count = bp.count
@@ -487,7 +602,6 @@ func BlockProfile(p []BlockProfileRecord) (n int, ok bool) {
 			p = p[1:]
 		}
 	}
-	unlock(&proflock)
 	return
 }
 
@@ -68,6 +68,11 @@ type mstats struct {
 
 	tinyallocs uint64 // number of tiny allocations that didn't cause actual allocation; not exported to go directly
 
+	// Statistics about C memory allocated through cmalloc,
+	// copied to MemStats by readmemstats_m.
+	cmalloc      uint64 // number of C allocations
+	cmalloc_size uint64 // bytes of C memory allocated
+
 	// heap_live is the number of bytes considered live by the GC.
 	// That is: retained by the most recent GC plus allocated
 	// since then. heap_live <= heap_alloc, since heap_alloc
@@ -161,18 +166,26 @@ type MemStats struct {
 		Mallocs uint64
 		Frees   uint64
 	}
+
+	// C allocation statistics.
+	// These count only memory allocated from Go, by C.malloc,
+	// C.CString and C.CBytes. The runtime does not see that memory
+	// freed, since C code frees it, so there are no matching frees.
+	CgoMallocs    uint64 // number of C allocations
+	CgoTotalAlloc uint64 // bytes of C memory allocated
 }
 
 // Size of the trailing by_size array differs between Go and C,
 // and all data after by_size is local to runtime, not exported.
 // NumSizeClasses was changed, but we cannot change Go struct because of backward compatibility.
 // sizeof_C_MStats is what C thinks about size of Go struct.
+// The fields of MemStats after BySize are filled in separately.
 var sizeof_C_MStats = unsafe.Offsetof(memstats.by_size) + 61*unsafe.Sizeof(memstats.by_size[0])
 
 func init() {
 	var memStats MemStats
-	if sizeof_C_MStats != unsafe.Sizeof(memStats) {
-		println(sizeof_C_MStats, unsafe.Sizeof(memStats))
+	if sizeof_C_MStats != unsafe.Offsetof(memStats.BySize)+unsafe.Sizeof(memStats.BySize) {
+		println(sizeof_C_MStats, unsafe.Offsetof(memStats.BySize)+unsafe.Sizeof(memStats.BySize))
 		throw("MStats vs MemStatsType size mismatch")
 	}
 }
@@ -194,6 +207,8 @@ func readmemstats_m(stats *MemStats) {
 	// Size of the trailing by_size array differs between Go and C,
 	// NumSizeClasses was changed, but we cannot change Go struct because of backward compatibility.
 	memmove(unsafe.Pointer(stats), unsafe.Pointer(&memstats), sizeof_C_MStats)
+	stats.CgoMallocs = memstats.cmalloc
+	stats.CgoTotalAlloc = memstats.cmalloc_size
 
 	// Stack numbers are part of the heap numbers, separate those out for user consumption
 	stats.StackSys += stats.StackInuse
@@ -361,6 +376,10 @@ func purgecachedstats(c *mcache) {
 	c.local_tinyallocs = 0
 	memstats.nlookup += uint64(c.local_nlookup)
 	c.local_nlookup = 0
+	memstats.cmalloc += uint64(c.local_ncmalloc)
+	c.local_ncmalloc = 0
+	memstats.cmalloc_size += uint64(c.local_cmalloc)
+	c.local_cmalloc = 0
 	h.largefree += uint64(c.local_largefree)
 	c.local_largefree = 0
 	h.nlargefree += uint64(c.local_nlargefree)
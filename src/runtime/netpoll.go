@@ -73,14 +73,33 @@ type pollCache struct {
 }
 
 var (
-	netpollInited uint32
-	pollcache     pollCache
+	netpollInitLock mutex
+	netpollInited   uint32
+	pollcache       pollCache
 )
 
+// netpollHosted is set once a C host has taken the descriptor of the
+// poller with GoNetpollDescriptor, to wait for it in its own event
+// loop. The host calls GoNetpoll when the descriptor is readable, so
+// findrunnable no longer blocks an M in netpoll.
+var netpollHosted uint32
+
 //go:linkname net_runtime_pollServerInit net.runtime_pollServerInit
 func net_runtime_pollServerInit() {
-	netpollinit()
-	atomic.Store(&netpollInited, 1)
+	netpollGenericInit()
+}
+
+// netpollGenericInit initializes the poller, once. Both the net
+// package and GoNetpollDescriptor may ask for it.
+func netpollGenericInit() {
+	if atomic.Load(&netpollInited) == 0 {
+		lock(&netpollInitLock)
+		if netpollInited == 0 {
+			netpollinit()
+			atomic.Store(&netpollInited, 1)
+		}
+		unlock(&netpollInitLock)
+	}
 }
 
 func netpollinited() bool {
@@ -276,6 +295,27 @@ func net_runtime_pollUnblock(pd *pollDesc) {
 	}
 }
 
+// Waiting for a runtime/cgo.Ring, whose consumer parks until the C
+// producers write to a pipe. The poller may not have been started
+// by the net package.
+
+//go:linkname cgo_runtime_pollOpen runtime/cgo.runtime_pollOpen
+func cgo_runtime_pollOpen(fd uintptr) (*pollDesc, int) {
+	netpollGenericInit()
+	return net_runtime_pollOpen(fd)
+}
+
+//go:linkname cgo_runtime_pollWait runtime/cgo.runtime_pollWait
+func cgo_runtime_pollWait(pd *pollDesc, mode int) int {
+	return net_runtime_pollWait(pd, mode)
+}
+
+//go:linkname cgo_runtime_pollClose runtime/cgo.runtime_pollClose
+func cgo_runtime_pollClose(pd *pollDesc) {
+	net_runtime_pollUnblock(pd)
+	net_runtime_pollClose(pd)
+}
+
 // make pd ready, newly runnable goroutines (if any) are returned in rg/wg
 // May run during STW, so write barriers are not allowed.
 //go:nowritebarrier
@@ -447,3 +487,44 @@ func (c *pollCache) alloc() *pollDesc {
 	unlock(&c.lock)
 	return pd
 }
+
+// cgoNetpoll holds the arguments and result of _cgo_netpoll_internal,
+// in C memory. Known to runtime/cgo as NetpollArgs.
+type cgoNetpoll struct {
+	op     int32
+	result int32
+}
+
+// Values of cgoNetpoll.op.
+const (
+	cgoNetpollDescriptor = iota
+	cgoNetpollRun
+)
+
+// _cgo_netpoll_internal implements GoNetpollDescriptor and GoNetpoll
+// in runtime/cgo/gcc_netpoll.c.
+func _cgo_netpoll_internal(a *cgoNetpoll) {
+	switch a.op {
+	case cgoNetpollDescriptor:
+		netpollGenericInit()
+		a.result = netpolldescriptor()
+		if a.result >= 0 {
+			atomic.Store(&netpollHosted, 1)
+		}
+	case cgoNetpollRun:
+		a.result = 0
+		if !netpollinited() {
+			return
+		}
+		gp := netpoll(false) // non-blocking
+		atomic.Store64(&sched.lastpoll, uint64(nanotime()))
+		for p := gp; p != nil; p = p.schedlink.ptr() {
+			a.result++
+		}
+		if gp != nil {
+			systemstack(func() {
+				injectglist(gp)
+			})
+		}
+	}
+}
@@ -36,6 +36,11 @@ func netpollinit() {
 	throw("netpollinit: failed to create descriptor")
 }
 
+// netpolldescriptor returns the epoll descriptor, for GoNetpollDescriptor.
+func netpolldescriptor() int32 {
+	return epfd
+}
+
 func netpollopen(fd uintptr, pd *pollDesc) int32 {
 	var ev epollevent
 	ev.events = _EPOLLIN | _EPOLLOUT | _EPOLLRDHUP | _EPOLLET
@@ -48,6 +53,15 @@ func netpollclose(fd uintptr) int32 {
 	return -epollctl(epfd, _EPOLL_CTL_DEL, int32(fd), &ev)
 }
 
+// netpollbreak makes netpoll return, now and from then on, by adding
+// fd, which must stay readable, with no pollDesc. Used only when the
+// runtime is released; see _cgo_release_internal.
+func netpollbreak(fd int32) {
+	var ev epollevent
+	ev.events = _EPOLLIN
+	epollctl(epfd, _EPOLL_CTL_ADD, fd, &ev)
+}
+
 func netpollarm(pd *pollDesc, mode int) {
 	throw("unused")
 }
@@ -87,7 +101,10 @@ retry:
 		}
 		if mode != 0 {
 			pd := *(**pollDesc)(unsafe.Pointer(&ev.data))
-
+			if pd == nil {
+				// See netpollbreak.
+				return gp.ptr()
+			}
 			netpollready(&gp, pd, mode)
 		}
 	}
@@ -29,6 +29,11 @@ func netpollinit() {
 	closeonexec(kq)
 }
 
+// netpolldescriptor returns the kqueue descriptor, for GoNetpollDescriptor.
+func netpolldescriptor() int32 {
+	return kq
+}
+
 func netpollopen(fd uintptr, pd *pollDesc) int32 {
 	// Arm both EVFILT_READ and EVFILT_WRITE in edge-triggered mode (EV_CLEAR)
 	// for the whole fd lifetime. The notifications are automatically unregistered
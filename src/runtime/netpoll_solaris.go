@@ -121,6 +121,11 @@ func netpollinit() {
 	throw("netpollinit: failed to create port")
 }
 
+// netpolldescriptor returns the event port, for GoNetpollDescriptor.
+func netpolldescriptor() int32 {
+	return portfd
+}
+
 func netpollopen(fd uintptr, pd *pollDesc) int32 {
 	lock(&pd.lock)
 	// We don't register for any specific type of events yet, that's
@@ -17,3 +17,6 @@ func netpoll(block bool) (gp *g) {
 func netpollinited() bool {
 	return false
 }
+
+// netpollHosted is never set: there is no poller for a C host to drive.
+var netpollHosted uint32
@@ -40,6 +40,12 @@ func netpollinit() {
 	}
 }
 
+// netpolldescriptor returns -1: a completion port cannot be waited
+// for along with the handles of an event loop.
+func netpolldescriptor() int32 {
+	return -1
+}
+
 func netpollopen(fd uintptr, pd *pollDesc) int32 {
 	if stdcall4(_CreateIoCompletionPort, fd, iocphandle, 0, 0) == 0 {
 		return -int32(getlasterror())
@@ -255,7 +255,7 @@ func libpreinit() {
 // Called to initialize a new m (including the bootstrap m).
 // Called on the parent thread (main thread in case of bootstrap), can allocate memory.
 func mpreinit(mp *m) {
-	mp.gsignal = malg(32 * 1024) // Linux wants >= 2K
+	mp.gsignal = malg(-1) // minit gives it a stack; see sigstack_linux.go
 	mp.gsignal.m = mp
 }
 
@@ -286,16 +286,14 @@ func minit() {
 	var st sigaltstackt
 	sigaltstack(nil, &st)
 	if st.ss_flags&_SS_DISABLE != 0 {
-		signalstack(&_g_.m.gsignal.stack)
+		_g_.m.sigstack = sigstackget()
+		setGsignalStack(_g_.m, _g_.m.sigstack)
+		signalstack(&_g_.m.sigstack)
 		_g_.m.newSigstack = true
 	} else {
 		// Use existing signal stack.
 		stsp := uintptr(unsafe.Pointer(st.ss_sp))
-		_g_.m.gsignal.stack.lo = stsp
-		_g_.m.gsignal.stack.hi = stsp + st.ss_size
-		_g_.m.gsignal.stackguard0 = stsp + _StackGuard
-		_g_.m.gsignal.stackguard1 = stsp + _StackGuard
-		_g_.m.gsignal.stackAlloc = st.ss_size
+		setGsignalStack(_g_.m, stack{stsp, stsp + st.ss_size})
 		_g_.m.newSigstack = false
 	}
 
@@ -315,8 +313,18 @@ func minit() {
 // Called from dropm to undo the effect of an minit.
 //go:nosplit
 func unminit() {
-	if getg().m.newSigstack {
+	_g_ := getg()
+	if _g_.m.newSigstack {
 		signalstack(nil)
+		sigstackput(_g_.m.sigstack)
+		_g_.m.sigstack = stack{}
+	}
+	setGsignalStack(_g_.m, stack{})
+
+	// The next thread to use this M needs a timer of its own,
+	// which execute will create once profilehz differs.
+	if delcputimer(_g_.m) {
+		_g_.m.profilehz = 0
 	}
 }
 
@@ -379,6 +387,12 @@ func raiseproc(sig int32)
 
 //go:noescape
 func sched_getaffinity(pid, len uintptr, buf *uintptr) int32
+
+//go:noescape
+func getcpu(cpu, node *uint32, cache unsafe.Pointer) int32
+
+//go:noescape
+func mbind(addr unsafe.Pointer, n, mode uintptr, nodemask *uint64, maxnode, flags uintptr) int32
 func osyield()
 
 //go:nosplit
@@ -637,6 +637,7 @@ func startpanic_m() {
 }
 
 var didothers bool
+var didcgoflight bool
 var deadlock mutex
 
 func dopanic_m(gp *g, pc, sp uintptr) {
@@ -668,6 +669,10 @@ func dopanic_m(gp *g, pc, sp uintptr) {
 			didothers = true
 			tracebackothers(gp)
 		}
+		if debug.cgoflight > 0 && !didcgoflight {
+			didcgoflight = true
+			printCgoFlight()
+		}
 	}
 	unlock(&paniclk)
 
@@ -704,6 +709,11 @@ func canpanic(gp *g) bool {
 	if _m_.locks-_m_.softfloat != 0 || _m_.mallocing != 0 || _m_.throwing != 0 || _m_.preemptoff != "" || _m_.dying != 0 {
 		return false
 	}
+	// A C function called by cgocallstack runs on gp's stack,
+	// but the fault is in C.
+	if _m_.cgoleaf {
+		return false
+	}
 	status := readgstatus(gp)
 	if status&^_Gscan != _Grunning || gp.syscallsp != 0 {
 		return false
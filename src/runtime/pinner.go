@@ -0,0 +1,206 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime
+
+import "unsafe"
+
+// A Pinner is a set of pinned Go objects. An object can be pinned with
+// the Pin method and all pinned objects of a Pinner can be unpinned with
+// the Unpin method.
+//
+// The cgo pointer passing rules normally forbid C code from keeping a
+// Go pointer after a call returns, and forbid passing C memory, or Go
+// memory passed to C, that holds Go pointers. Those rules do not apply
+// to pointers to pinned objects: C may keep them, and they may be
+// stored anywhere C can see them, until the object is unpinned. This
+// lets C use a large Go buffer in place instead of working on a copy
+// made by C.CBytes or C.CString.
+type Pinner struct {
+	*pinner
+}
+
+// Pin pins a Go object, preventing it from being freed by the garbage
+// collector and exempting pointers to it from the cgo pointer checks,
+// until the Unpin method has been called. The garbage collector does
+// not move heap objects, so a pinned object also stays at the same
+// address.
+//
+// A pointer to a pinned object can be directly stored in C memory or
+// can be contained in Go memory passed to C functions. If the pinned
+// object itself contains pointers to Go objects, these objects must be
+// pinned separately if they are going to be accessed from C code.
+//
+// The argument must be a pointer of any type or an unsafe.Pointer.
+// Any pointer into the object pins the whole object. Pointers to
+// objects not allocated in the Go heap, such as global variables and
+// C memory, are accepted and need no pinning.
+//
+// Every Pin must be followed by an Unpin before the Pinner becomes
+// unreachable; the program panics if it finds a Pinner that still
+// has objects pinned.
+func (p *Pinner) Pin(pointer interface{}) {
+	if p.pinner == nil {
+		p.pinner = new(pinner)
+		SetFinalizer(p.pinner, func(i *pinner) {
+			if len(i.refs) != 0 {
+				i.unpin() // only required to make the test idempotent
+				pinnerLeakPanic()
+			}
+		})
+	}
+	ptr := pinnerGetPtr(&pointer)
+	if setPinned(ptr, true) {
+		p.refs = append(p.refs, ptr)
+	}
+}
+
+// Unpin unpins all pinned objects of the Pinner.
+func (p *Pinner) Unpin() {
+	p.pinner.unpin()
+}
+
+type pinner struct {
+	refs []unsafe.Pointer
+}
+
+func (p *pinner) unpin() {
+	if p == nil {
+		return
+	}
+	for i := range p.refs {
+		setPinned(p.refs[i], false)
+		p.refs[i] = nil
+	}
+	p.refs = p.refs[:0]
+}
+
+func pinnerGetPtr(i *interface{}) unsafe.Pointer {
+	e := efaceOf(i)
+	etyp := e._type
+	if etyp == nil {
+		panic(errorString("runtime.Pinner: argument is nil"))
+	}
+	if kind := etyp.kind & kindMask; kind != kindPtr && kind != kindUnsafePointer {
+		panic(errorString("runtime.Pinner: argument is not a pointer: " + etyp.string()))
+	}
+	// Pointer types are stored directly in the interface.
+	return e.data
+}
+
+// pinnerLeakPanic is a variable so that tests can replace it.
+var pinnerLeakPanic = func() {
+	panic(errorString("runtime.Pinner: found leaking pinned pointer; forgot to call Unpin()?"))
+}
+
+// The described object is pinned count times.
+type specialpinned struct {
+	special special
+	count   uintptr
+}
+
+// setPinned pins the heap object containing ptr once more if pin is
+// true, or undoes one pin if it is false. An object stays pinned until
+// each of its pins is undone. setPinned reports whether ptr points
+// into the heap; other pointers are left alone.
+func setPinned(ptr unsafe.Pointer, pin bool) bool {
+	span := mheap_.lookupMaybe(ptr)
+	if span == nil {
+		return false
+	}
+
+	// Allocate the record up front, so that we do not take
+	// mheap_.speciallock while holding span.speciallock.
+	var s *specialpinned
+	if pin {
+		lock(&mheap_.speciallock)
+		s = (*specialpinned)(mheap_.specialpinnedalloc.alloc())
+		unlock(&mheap_.speciallock)
+		s.special.kind = _KindSpecialPinned
+		s.count = 1
+	}
+
+	// Ensure that the span is swept, as addspecial does.
+	mp := acquirem()
+	span.ensureSwept()
+
+	offset := (uintptr(ptr) - span.base()) / span.elemsize * span.elemsize
+
+	lock(&span.speciallock)
+	t, found := span.specialFindSplicePoint(offset, _KindSpecialPinned)
+	var free *specialpinned
+	if pin {
+		if found {
+			(*specialpinned)(unsafe.Pointer(*t)).count++
+			free = s
+		} else {
+			s.special.offset = uint16(offset)
+			s.special.next = *t
+			*t = &s.special
+		}
+	} else {
+		if !found {
+			unlock(&span.speciallock)
+			releasem(mp)
+			throw("runtime.Pinner: object already unpinned")
+		}
+		x := (*specialpinned)(unsafe.Pointer(*t))
+		x.count--
+		if x.count == 0 {
+			*t = x.special.next
+			free = x
+		}
+	}
+	unlock(&span.speciallock)
+	releasem(mp)
+
+	if free != nil {
+		lock(&mheap_.speciallock)
+		mheap_.specialpinnedalloc.free(unsafe.Pointer(free))
+		unlock(&mheap_.speciallock)
+	}
+	return true
+}
+
+// isPinned reports whether ptr points into a pinned heap object.
+// The cgo pointer checks use it to allow such pointers.
+func isPinned(ptr unsafe.Pointer) bool {
+	span := mheap_.lookupMaybe(ptr)
+	if span == nil {
+		return false
+	}
+	// Checking without the lock may race with pinning the first
+	// object in the span, but then that object is not yet pinned
+	// as far as the caller can tell.
+	if span.specials == nil {
+		return false
+	}
+	offset := (uintptr(ptr) - span.base()) / span.elemsize * span.elemsize
+	lock(&span.speciallock)
+	_, found := span.specialFindSplicePoint(offset, _KindSpecialPinned)
+	unlock(&span.speciallock)
+	return found
+}
+
+// specialFindSplicePoint finds where a special record of the given kind
+// for the object at offset is, or would be inserted, in the span's
+// sorted list, and whether a record is already there.
+// The caller must hold span.speciallock.
+func (span *mspan) specialFindSplicePoint(offset uintptr, kind byte) (**special, bool) {
+	t := &span.specials
+	for {
+		x := *t
+		if x == nil {
+			break
+		}
+		if offset == uintptr(x.offset) && kind == x.kind {
+			return t, true
+		}
+		if offset < uintptr(x.offset) || (offset == uintptr(x.offset) && kind < x.kind) {
+			break
+		}
+		t = &x.next
+	}
+	return t, false
+}
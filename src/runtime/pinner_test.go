@@ -0,0 +1,140 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime_test
+
+import (
+	"runtime"
+	"testing"
+	"time"
+	"unsafe"
+)
+
+type obj struct {
+	x int64
+	y int64
+	z int64
+}
+
+var globalPinned int
+
+func assertPanic(t *testing.T, what string) {
+	if recover() == nil {
+		t.Errorf("%s did not panic", what)
+	}
+}
+
+func TestPinnerSimple(t *testing.T) {
+	var pinner runtime.Pinner
+	p := new(obj)
+	addr := unsafe.Pointer(p)
+	if runtime.IsPinned(addr) {
+		t.Fatal("already marked as pinned")
+	}
+	pinner.Pin(p)
+	if !runtime.IsPinned(addr) {
+		t.Fatal("not marked as pinned")
+	}
+	if !runtime.IsPinned(unsafe.Pointer(&p.z)) {
+		t.Fatal("interior pointer not marked as pinned")
+	}
+	pinner.Unpin()
+	if runtime.IsPinned(addr) {
+		t.Fatal("still marked as pinned")
+	}
+}
+
+func TestPinnerPinKeepsAlive(t *testing.T) {
+	var pinner runtime.Pinner
+	p := new(obj)
+	done := make(chan struct{})
+	runtime.SetFinalizer(p, func(any *obj) {
+		close(done)
+	})
+	pinner.Pin(p)
+	p = nil
+	runtime.GC()
+	runtime.GC()
+	select {
+	case <-done:
+		t.Fatal("Pin() didn't keep object alive")
+	case <-time.After(100 * time.Millisecond):
+	}
+	pinner.Unpin()
+}
+
+func TestPinnerMultiplePinned(t *testing.T) {
+	var pinner1, pinner2 runtime.Pinner
+	p := new(obj)
+	addr := unsafe.Pointer(p)
+	pinner1.Pin(p)
+	pinner1.Pin(p)
+	pinner2.Pin(p)
+	pinner1.Unpin()
+	if !runtime.IsPinned(addr) {
+		t.Fatal("not marked as pinned after unpinning one pinner")
+	}
+	pinner2.Unpin()
+	if runtime.IsPinned(addr) {
+		t.Fatal("still marked as pinned")
+	}
+}
+
+func TestPinnerPinNonHeap(t *testing.T) {
+	var pinner runtime.Pinner
+	pinner.Pin(&globalPinned)
+	pinner.Pin(unsafe.Pointer(&globalPinned))
+	pinner.Pin(new(struct{}))
+	if runtime.IsPinned(unsafe.Pointer(&globalPinned)) {
+		t.Error("global variable marked as pinned")
+	}
+	pinner.Unpin()
+}
+
+func TestPinnerPinNonPointer(t *testing.T) {
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	defer assertPanic(t, "Pin(int)")
+	pinner.Pin(42)
+}
+
+func TestPinnerPinNil(t *testing.T) {
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	defer assertPanic(t, "Pin(nil)")
+	pinner.Pin(nil)
+}
+
+func TestPinnerLeakPanic(t *testing.T) {
+	old := *runtime.PinnerLeakPanic
+	defer func() {
+		*runtime.PinnerLeakPanic = old
+	}()
+	done := make(chan struct{})
+	*runtime.PinnerLeakPanic = func() {
+		close(done)
+	}
+	func() {
+		var pinner runtime.Pinner
+		pinner.Pin(new(obj))
+	}()
+	for i := 0; i < 10; i++ {
+		runtime.GC()
+		select {
+		case <-done:
+			return
+		case <-time.After(100 * time.Millisecond):
+		}
+	}
+	t.Fatal("leaked pinner was not reported")
+}
+
+func BenchmarkPinnerPinUnpin(b *testing.B) {
+	var pinner runtime.Pinner
+	p := new(obj)
+	for i := 0; i < b.N; i++ {
+		pinner.Pin(p)
+		pinner.Unpin()
+	}
+}
@@ -42,6 +42,9 @@ import (
 //	heap         - a sampling of all heap allocations
 //	threadcreate - stack traces that led to the creation of new OS threads
 //	block        - stack traces that led to blocking on synchronization primitives
+//	cgocall      - calls from Go to C, and the time spent in C, by call site
+//	cmalloc      - a sampling of C memory allocated by C.malloc, C.CString and C.CBytes
+//	cgoblock     - stack traces of calls from Go to C, with the wall-clock time spent in them
 //
 // These predefined profiles maintain themselves and panic on an explicit
 // Add or Remove method call.
@@ -69,6 +72,9 @@ import (
 //	heap         - 所有堆分配的采样
 //	threadcreate - 引导新OS的线程创建的栈跟踪
 //	block        - 引导同步原语中阻塞的栈跟踪
+//	cgocall      - 按调用点统计的从 Go 到 C 的调用次数及在 C 中花费的时间
+//	cmalloc      - 由 C.malloc、C.CString 和 C.CBytes 分配的 C 内存的采样
+//	cgoblock     - 从 Go 到 C 的调用的栈跟踪，及其在 C 中花费的挂钟时间
 //
 // 这些预声明分析并不能作为 Profile 使用。它有专门的API，即 StartCPUProfile 和
 // StopCPUProfile 函数，因为它在分析时是以流的形式输出到写入器的。
@@ -113,6 +119,24 @@ var blockProfile = &Profile{
 	write: writeBlock,
 }
 
+var cgocallProfile = &Profile{
+	name:  "cgocall",
+	count: countCgoCall,
+	write: writeCgoCall,
+}
+
+var cmallocProfile = &Profile{
+	name:  "cmalloc",
+	count: countCMalloc,
+	write: writeCMalloc,
+}
+
+var cgoblockProfile = &Profile{
+	name:  "cgoblock",
+	count: countCgoBlock,
+	write: writeCgoBlock,
+}
+
 func lockProfiles() {
 	profiles.mu.Lock()
 	if profiles.m == nil {
@@ -122,6 +146,9 @@ func lockProfiles() {
 			"threadcreate": threadcreateProfile,
 			"heap":         heapProfile,
 			"block":        blockProfile,
+			"cgocall":      cgocallProfile,
+			"cmalloc":      cmallocProfile,
+			"cgoblock":     cgoblockProfile,
 		}
 	}
 }
@@ -571,6 +598,9 @@ func writeHeap(w io.Writer, debug int) error {
 	fmt.Fprintf(w, "# HeapReleased = %d\n", s.HeapReleased)
 	fmt.Fprintf(w, "# HeapObjects = %d\n", s.HeapObjects)
 
+	fmt.Fprintf(w, "# CgoMallocs = %d\n", s.CgoMallocs)
+	fmt.Fprintf(w, "# CgoTotalAlloc = %d\n", s.CgoTotalAlloc)
+
 	fmt.Fprintf(w, "# Stack = %d / %d\n", s.StackInuse, s.StackSys)
 	fmt.Fprintf(w, "# MSpan = %d / %d\n", s.MSpanInuse, s.MSpanSys)
 	fmt.Fprintf(w, "# MCache = %d / %d\n", s.MCacheInuse, s.MCacheSys)
@@ -784,11 +814,28 @@ func countBlock() int {
 
 // writeBlock 将当前阻塞分析写入 w 中。
 func writeBlock(w io.Writer, debug int) error {
+	return writeBlockProfile(w, debug, runtime.BlockProfile)
+}
+
+// countCgoBlock returns the number of records in the cgo blocking profile.
+func countCgoBlock() int {
+	n, _ := runtime.CgoBlockProfile(nil)
+	return n
+}
+
+// writeCgoBlock writes the current cgo blocking profile to w,
+// in the format of the blocking profile.
+func writeCgoBlock(w io.Writer, debug int) error {
+	return writeBlockProfile(w, debug, runtime.CgoBlockProfile)
+}
+
+// writeBlockProfile writes the blocking profile returned by fetch to w.
+func writeBlockProfile(w io.Writer, debug int, fetch func([]runtime.BlockProfileRecord) (int, bool)) error {
 	var p []runtime.BlockProfileRecord
-	n, ok := runtime.BlockProfile(nil)
+	n, ok := fetch(nil)
 	for {
 		p = make([]runtime.BlockProfileRecord, n+50)
-		n, ok = runtime.BlockProfile(p)
+		n, ok = fetch(p)
 		if ok {
 			p = p[:n]
 			break
@@ -826,3 +873,122 @@ func writeBlock(w io.Writer, debug int) error {
 }
 
 func runtime_cyclesPerSecond() int64
+
+type byNanoseconds []runtime.CgoCallProfileRecord
+
+func (x byNanoseconds) Len() int           { return len(x) }
+func (x byNanoseconds) Swap(i, j int)      { x[i], x[j] = x[j], x[i] }
+func (x byNanoseconds) Less(i, j int) bool { return x[i].Nanoseconds > x[j].Nanoseconds }
+
+// countCgoCall returns the number of records in the cgo call profile.
+func countCgoCall() int {
+	n, _ := runtime.CgoCallProfile(nil)
+	return n
+}
+
+// writeCgoCall writes the current cgo call profile to w.
+// It uses the format of the block profile, with a clock of
+// one cycle per nanosecond, so that pprof reports the time
+// spent in C at each call site as its delay.
+func writeCgoCall(w io.Writer, debug int) error {
+	var p []runtime.CgoCallProfileRecord
+	n, ok := runtime.CgoCallProfile(nil)
+	for {
+		p = make([]runtime.CgoCallProfileRecord, n+50)
+		n, ok = runtime.CgoCallProfile(p)
+		if ok {
+			p = p[:n]
+			break
+		}
+	}
+
+	sort.Sort(byNanoseconds(p))
+
+	b := bufio.NewWriter(w)
+	var tw *tabwriter.Writer
+	w = b
+	if debug > 0 {
+		tw = tabwriter.NewWriter(w, 1, 8, 1, '\t', 0)
+		w = tw
+	}
+
+	fmt.Fprintf(w, "--- contention:\n")
+	fmt.Fprintf(w, "cycles/second=%v\n", int64(1e9))
+	for i := range p {
+		r := &p[i]
+		fmt.Fprintf(w, "%v %v @", r.Nanoseconds, r.Count)
+		for _, pc := range r.Stack() {
+			fmt.Fprintf(w, " %#x", pc)
+		}
+		fmt.Fprint(w, "\n")
+		if debug > 0 {
+			printStackRecord(w, r.Stack(), true)
+		}
+	}
+
+	if tw != nil {
+		tw.Flush()
+	}
+	return b.Flush()
+}
+
+// countCMalloc returns the number of records in the C allocation profile.
+func countCMalloc() int {
+	n, _ := runtime.CMallocProfile(nil)
+	return n
+}
+
+// writeCMalloc writes the current C allocation profile to w.
+// It uses the format of the heap profile. Since the runtime does
+// not see C memory freed, every sampled allocation is reported as
+// in use; comparing two profiles shows which sites keep allocating.
+func writeCMalloc(w io.Writer, debug int) error {
+	var p []runtime.MemProfileRecord
+	n, ok := runtime.CMallocProfile(nil)
+	for {
+		p = make([]runtime.MemProfileRecord, n+50)
+		n, ok = runtime.CMallocProfile(p)
+		if ok {
+			p = p[:n]
+			break
+		}
+	}
+
+	sort.Sort(byInUseBytes(p))
+
+	b := bufio.NewWriter(w)
+	var tw *tabwriter.Writer
+	w = b
+	if debug > 0 {
+		tw = tabwriter.NewWriter(w, 1, 8, 1, '\t', 0)
+		w = tw
+	}
+
+	var total runtime.MemProfileRecord
+	for i := range p {
+		total.AllocBytes += p[i].AllocBytes
+		total.AllocObjects += p[i].AllocObjects
+	}
+	fmt.Fprintf(w, "heap profile: %d: %d [%d: %d] @ heap/%d\n",
+		total.InUseObjects(), total.InUseBytes(),
+		total.AllocObjects, total.AllocBytes,
+		2*runtime.MemProfileRate)
+	for i := range p {
+		r := &p[i]
+		fmt.Fprintf(w, "%d: %d [%d: %d] @",
+			r.InUseObjects(), r.InUseBytes(),
+			r.AllocObjects, r.AllocBytes)
+		for _, pc := range r.Stack() {
+			fmt.Fprintf(w, " %#x", pc)
+		}
+		fmt.Fprintf(w, "\n")
+		if debug > 0 {
+			printStackRecord(w, r.Stack(), false)
+		}
+	}
+
+	if tw != nil {
+		tw.Flush()
+	}
+	return b.Flush()
+}
@@ -0,0 +1,61 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package pprof_test
+
+import (
+	"bytes"
+	"runtime"
+	. "runtime/pprof"
+	"syscall"
+	"testing"
+	"time"
+)
+
+func cpuTime(t *testing.T) time.Duration {
+	var ru syscall.Rusage
+	if err := syscall.Getrusage(syscall.RUSAGE_SELF, &ru); err != nil {
+		t.Fatal(err)
+	}
+	return time.Duration(ru.Utime.Nano() + ru.Stime.Nano())
+}
+
+// Check that the samples keep up with the CPU time of several busy
+// threads, which a single timer for the whole process fails to do
+// past a few hundred samples a second.
+func TestCPUProfileSampleCount(t *testing.T) {
+	if testing.Short() {
+		t.Skip("skipping in short mode")
+	}
+	n := runtime.GOMAXPROCS(0)
+	var prof bytes.Buffer
+	if err := StartCPUProfile(&prof); err != nil {
+		t.Fatal(err)
+	}
+	start := cpuTime(t)
+	c := make(chan int)
+	for i := 0; i < n; i++ {
+		go func() {
+			cpuHogger(cpuHog1, time.Second)
+			c <- 1
+		}()
+	}
+	for i := 0; i < n; i++ {
+		<-c
+	}
+	used := cpuTime(t) - start
+	StopCPUProfile()
+
+	var samples uintptr
+	parseProfile(t, prof.Bytes(), func(count uintptr, stk []uintptr) {
+		samples += count
+	})
+	// 100 samples a second of CPU time, with room for the
+	// samples lost to the start and end of each thread's timer.
+	want := uintptr(used / (10 * time.Millisecond) / 2)
+	t.Logf("%d samples in %v of CPU time on %d threads", samples, used, n)
+	if samples < want {
+		t.Errorf("got %d samples for %v of CPU time, want at least %d", samples, used, want)
+	}
+}
@@ -93,6 +93,10 @@ func main_init()
 // it is closed, meaning cgocallbackg can reliably receive from it.
 var main_init_done chan bool
 
+// mainInitDone is set once main_init_done is closed, so that
+// cgocallbackg can skip the receive.
+var mainInitDone uint32
+
 //go:linkname main_main main.main
 func main_main()
 
@@ -168,15 +172,22 @@ func main() {
 			if _cgo_unsetenv == nil {
 				throw("_cgo_unsetenv missing")
 			}
+			if _cgo_setenvs == nil {
+				throw("_cgo_setenvs missing")
+			}
 		}
 		if _cgo_notify_runtime_init_done == nil {
 			throw("_cgo_notify_runtime_init_done missing")
 		}
 		cgocall(_cgo_notify_runtime_init_done, nil)
+		if debug.cgoinittrace > 0 {
+			cgoinittrace()
+		}
 	}
 
 	main_init()
 	close(main_init_done)
+	atomic.Store(&mainInitDone, 1)
 
 	needUnlock = false
 	unlockOSThread()
@@ -206,6 +217,65 @@ func main() {
 	}
 }
 
+// libstarted is set by the first library that starts the runtime.
+// After that, addmoduledata leaves new modules to addmodules.
+var libstarted uint32
+
+// libstart is called by the entry point of a library built with
+// -buildmode=c-archive or c-shared before libpreinit, and reports
+// whether the library should start the runtime. Libraries built with
+// -buildmode=c-shared -linkshared share the runtime in the shared
+// library they link against: only the first one starts it. Each of
+// the others waits for the runtime, then adds its modules and runs its
+// package initialization before its constructor returns.
+// None of the Go runtime may be initialized.
+//go:nosplit
+//go:nowritebarrierrec
+func libstart() bool {
+	if atomic.Cas(&libstarted, 0, 1) {
+		if !isarchive {
+			// With -linkshared, the linker cannot set this.
+			islibrary = true
+		}
+		return true
+	}
+	if _cgo_init_library == nil {
+		throw("another library has already started the runtime")
+	}
+	asmcgocall(_cgo_init_library, nil)
+	return false
+}
+
+// cgoStartupEvent is a startup event recorded by runtime/cgo.
+// Known to runtime/cgo/libcgo.h as StartupEvent.
+type cgoStartupEvent struct {
+	name *byte
+	usec int64
+}
+
+// cgoinittrace prints the startup events recorded by runtime/cgo,
+// for GODEBUG=cgoinittrace=1.
+func cgoinittrace() {
+	if _cgo_startup_events == nil {
+		return
+	}
+	var ev [16]cgoStartupEvent
+	args := struct {
+		ev  *cgoStartupEvent
+		max uintptr
+		n   uintptr
+	}{&ev[0], uintptr(len(ev)), 0}
+	cgocall(_cgo_startup_events, unsafe.Pointer(&args))
+	for i := uintptr(0); i < args.n; i++ {
+		e := &ev[i]
+		prev := e
+		if i > 0 {
+			prev = &ev[i-1]
+		}
+		print("cgoinit: ", gostringnocopy(e.name), " @", e.usec-ev[0].usec, "us +", e.usec-prev.usec, "us\n")
+	}
+}
+
 // os_beforeExit is called from os.Exit(0).
 //go:linkname os_beforeExit os.runtime_beforeExit
 func os_beforeExit() {
@@ -387,7 +457,7 @@ func badreflectcall() {
 
 func lockedOSThread() bool {
 	gp := getg()
-	return gp.lockedm != nil && gp.m.lockedg != nil
+	return gp.lockedm != 0 && gp.m.lockedg != 0
 }
 
 var (
@@ -449,6 +519,7 @@ func schedinit() {
 	mallocinit()
 	mcommoninit(_g_.m)
 	typelinksinit()
+	cgoDataIndexInit()
 	itabsinit()
 
 	msigsave(_g_.m)
@@ -458,6 +529,28 @@ func schedinit() {
 	goenvs()
 	parsedebugvars()
 	gcinit()
+	setCgoTracebackDepth()
+	if iscgo || GOOS == "solaris" || GOOS == "windows" {
+		// m0 was initialized before GODEBUG was parsed.
+		_g_.m.cgoflight = newCgoFlightRecorder()
+	}
+	if debug.cgofpunwind > 0 && _cgo_fp_traceback != nil {
+		// Until SetCgoTraceback replaces it, use the frame
+		// pointer unwinder in runtime/cgo.
+		cgoTraceback = _cgo_fp_traceback
+	}
+
+	// Start the pool of parked cgo threads before any M other
+	// than m0 exists. Only some systems provide it.
+	if iscgo && debug.cgothreadpool > 0 && _cgo_thread_pool_init != nil {
+		var args struct {
+			n         int32
+			stacksize uintptr
+		}
+		args.n = debug.cgothreadpool
+		args.stacksize = uintptr(debug.cgothreadstack)
+		asmcgocall(_cgo_thread_pool_init, unsafe.Pointer(&args))
+	}
 
 	sched.lastpoll = uint64(nanotime())
 	procs := int(ncpu)
@@ -528,7 +621,8 @@ func mcommoninit(mp *m) {
 
 	// Allocate memory to hold a cgo traceback if the cgo call crashes.
 	if iscgo || GOOS == "solaris" || GOOS == "windows" {
-		mp.cgoCallers = new(cgoCallers)
+		mp.cgoCallers = newCgoCallers(cgoTracebackDepth())
+		mp.cgoflight = newCgoFlightRecorder()
 	}
 }
 
@@ -1118,14 +1212,24 @@ func mstart1() {
 	_g_.m.g0.sched.pc = ^uintptr(0) // make sure it is never used
 	asminit()
 	minit()
+	setCgoCallersStack(_g_.m)
 
 	// Install signal handlers; after minit so that minit can
 	// prepare the thread to be able to handle the signals.
 	if _g_.m == &m0 {
-		// Create an extra M for callbacks on threads not created by Go.
+		// Create the extra Ms for callbacks on threads not created by Go.
+		// GODEBUG=cgoextram=N creates N of them up front, so that many
+		// threads calling into Go at once do not each wait for one.
 		if iscgo && !cgoHasExtraM {
 			cgoHasExtraM = true
 			newextram()
+			n := debug.cgoextram
+			if n > maxCgoExtraM {
+				n = maxCgoExtraM
+			}
+			for i := int32(1); i < n; i++ {
+				newextram()
+			}
 		}
 		initsig(false)
 	}
@@ -1272,9 +1376,88 @@ func runSafePointFn() {
 var cgoThreadStart unsafe.Pointer
 
 type cgothreadstart struct {
-	g   guintptr
-	tls *uint64
-	fn  unsafe.Pointer
+	g         guintptr
+	tls       *uint64
+	fn        unsafe.Pointer
+	stacksize uintptr
+	flags     uintptr
+}
+
+// cgothreadstart flags. Known to runtime/cgo (libcgo.h).
+const (
+	cgoThreadStartNodeAffinity = 1 << 0 // run on the creating thread's NUMA node
+)
+
+// cgoThreadStartBatch is the largest number of threads started by
+// one call to _cgo_thread_start_n. Known to runtime/cgo (libcgo.h).
+const cgoThreadStartBatch = 8
+
+// A cgothreadbatch collects Ms created by newm so that runtime/cgo
+// can start their OS threads with a single call, blocking and
+// restoring signals once for the whole batch.
+type cgothreadbatch struct {
+	n  int
+	ms [cgoThreadStartBatch]muintptr
+}
+
+// sysmonthreadbatch collects the Ms started by sysmon's retake.
+// Only sysmon uses it.
+var sysmonthreadbatch cgothreadbatch
+
+// beginthreadbatch makes newm on the current M collect new Ms in b
+// instead of starting their threads at once. The caller must call
+// endthreadbatch(b), and b must not move in between.
+// It does nothing if runtime/cgo does not support batches.
+//go:nowritebarrier
+func beginthreadbatch(b *cgothreadbatch) {
+	if iscgo && _cgo_thread_start_n != nil {
+		getg().m.threadbatch = uintptr(unsafe.Pointer(b))
+	}
+}
+
+// endthreadbatch starts the threads collected since beginthreadbatch(b).
+//go:nowritebarrier
+func endthreadbatch(b *cgothreadbatch) {
+	getg().m.threadbatch = 0
+	startthreadbatch(b)
+}
+
+// startthreadbatch starts the OS threads for the Ms collected in b
+// and empties b.
+//go:nowritebarrier
+func startthreadbatch(b *cgothreadbatch) {
+	if b.n == 0 {
+		return
+	}
+	var ts [cgoThreadStartBatch]cgothreadstart
+	for i := 0; i < b.n; i++ {
+		ts[i] = newmthreadstart(b.ms[i].ptr())
+	}
+	args := struct {
+		ts *cgothreadstart
+		n  uintptr
+	}{&ts[0], uintptr(b.n)}
+	if msanenabled {
+		msanwrite(unsafe.Pointer(&ts), unsafe.Sizeof(ts))
+	}
+	asmcgocall(_cgo_thread_start_n, unsafe.Pointer(&args))
+	b.n = 0
+}
+
+// newmthreadstart returns the arguments that start mp's thread
+// through runtime/cgo.
+//go:nowritebarrier
+func newmthreadstart(mp *m) cgothreadstart {
+	atomic.Xadd64(&cgoThreadStats.Created, 1)
+	var ts cgothreadstart
+	ts.g.set(mp.g0)
+	ts.tls = (*uint64)(unsafe.Pointer(&mp.tls[0]))
+	ts.fn = unsafe.Pointer(funcPC(mstart))
+	ts.stacksize = uintptr(debug.cgothreadstack)
+	if debug.cgothreadaffinity > 0 {
+		ts.flags |= cgoThreadStartNodeAffinity
+	}
+	return ts
 }
 
 // Allocate a new m unassociated with any thread.
@@ -1324,13 +1507,12 @@ func allocm(_p_ *p, fn func()) *m {
 //
 // In order to avoid needing heavy lifting here, we adopt
 // the following strategy: there is a stack of available m's
-// that can be stolen. Using compare-and-swap
-// to pop from the stack has ABA races, so we simulate
-// a lock by doing an exchange (via casp) to steal the stack
-// head and replace the top pointer with MLOCKED (1).
-// This serves as a simple spin lock that we can use even
-// without an m. The thread that locks the stack in this way
-// unlocks the stack by storing a valid stack head pointer.
+// that can be stolen. The stack is a lock-free stack (see lfstack.go),
+// which avoids the ABA races of a plain compare-and-swap by
+// counting pushes in the head word, and which we can use even
+// without an m. Many C threads can call into Go at once, so
+// it is important that needm and dropm do not serialize on
+// the list.
 //
 // In order to make sure that there is always an m structure
 // available to be stolen, we maintain the invariant that there
@@ -1355,11 +1537,16 @@ func needm(x byte) {
 		exit(1)
 	}
 
-	// Lock extra list, take head, unlock popped list.
-	// nilokay=false is safe here because of the invariant above,
-	// that the extra list always contains or will soon contain
-	// at least one m.
-	mp := lockextra(false)
+	var start int64
+	if debug.cgocallbackstats > 0 || trace.enabled {
+		start = nanotime()
+	}
+
+	// Pop an m from the extra list.
+	// Waiting for the list to be non-empty is safe here because
+	// of the invariant above, that the extra list always contains
+	// or will soon contain at least one m.
+	mp := popextra()
 
 	// Set needextram when we've just emptied the list,
 	// so that the eventual call into cgocallbackg will
@@ -1368,8 +1555,9 @@ func needm(x byte) {
 	// after exitsyscall makes sure it is okay to be
 	// running at all (that is, there's no garbage collection
 	// running right now).
-	mp.needextram = mp.schedlink == 0
-	unlockextra(mp.schedlink.ptr())
+	// If several threads empty the list at once, each of them
+	// may add an m, which only leaves extra spares.
+	mp.needextram = atomic.Load64(&extram) == 0
 
 	// Save and block signals before installing g.
 	// Once g is installed, any incoming signals will try to execute,
@@ -1381,23 +1569,93 @@ func needm(x byte) {
 	sigblock()
 
 	// Install g (= m->g0) and set the stack bounds
-	// to match the current stack. We don't actually know
-	// how big the stack is, like we don't know how big any
-	// scheduling stack is, but we assume there's at least 32 kB,
-	// which is more than enough for us.
+	// to match the current stack. needm may be running in a
+	// signal handler, via badsignal, so it only takes bounds
+	// runtime/cgo already knows; cgocallbackg1 looks them up.
 	setg(mp.g0)
-	_g_ := getg()
-	_g_.stack.hi = uintptr(noescape(unsafe.Pointer(&x))) + 1024
-	_g_.stack.lo = uintptr(noescape(unsafe.Pointer(&x))) - 32*1024
-	_g_.stackguard0 = _g_.stack.lo + _StackGuard
+	setg0stack(getg(), uintptr(noescape(unsafe.Pointer(&x))), false)
 
 	// Initialize this thread to use the m.
 	asminit()
 	minit()
+
+	if debug.cgostickym > 0 && _cgo_bindm != nil {
+		cgobindm(mp)
+	}
+
+	if start != 0 {
+		if debug.cgocallbackstats > 0 {
+			cgoCallbackTime(&cgoCallbackStats.NeedM, start)
+		}
+		mp.cgoneedmtime = nanotime() - start
+	}
+}
+
+// setg0stack sets the stack bounds of g0, the g0 of an extra m
+// installed on a thread not started by Go, around sp. They are the
+// bounds of the thread's stack if runtime/cgo can find them, as it
+// can on Linux, and they hold sp; they do not on the signal stack.
+// Unless lookup is set, runtime/cgo only reports bounds it found
+// earlier for the thread, without calling the C library, so that
+// setg0stack is safe in a signal handler.
+// Otherwise we don't actually know how big the stack is, like we
+// don't know how big any scheduling stack is, but we assume there's
+// at least 32 kB, which is more than enough for us. g0.m.g0stackguess
+// records which it is.
+//go:nosplit
+func setg0stack(g0 *g, sp uintptr, lookup bool) {
+	g0.stack.hi = sp + 1024
+	g0.stack.lo = sp - 32*1024
+	g0.m.g0stackguess = true
+	if _cgo_getstackbounds != nil {
+		var b struct{ lo, hi, lookup uintptr }
+		if lookup {
+			b.lookup = 1
+		}
+		asmcgocall(_cgo_getstackbounds, unsafe.Pointer(&b))
+		if b.lo < sp && sp < b.hi {
+			g0.stack.lo = b.lo
+			g0.stack.hi = b.hi
+			g0.m.g0stackguess = false
+		}
+	}
+	g0.stackguard0 = g0.stack.lo + _StackGuard
+}
+
+// cgobindm binds mp to the current C thread, so that dropm leaves it
+// in place and later callbacks from the thread reuse it, for
+// GODEBUG=cgostickym=1. runtime/cgo records mp.g0 in a pthread key
+// whose destructor calls cgounbindm as the thread exits.
+//go:nosplit
+func cgobindm(mp *m) {
+	args := struct {
+		g0 *g
+		ok int32
+	}{mp.g0, 0}
+	asmcgocall(_cgo_bindm, unsafe.Pointer(&args))
+	mp.cgobound = args.ok != 0
+}
+
+// cgounbindm puts the m bound by cgobindm back onto the extra list.
+// It is called via runtime/cgo's pthread key destructor as the C thread
+// exits, on the thread's own stack, with g0 set to the m's g0.
+// The C library may already have cleared the thread's g, so reinstall it.
+//go:nosplit
+func cgounbindm(g0 unsafe.Pointer) {
+	setg((*g)(g0))
+	_g_ := getg()
+	setg0stack(_g_, uintptr(noescape(unsafe.Pointer(&g0))), true)
+	_g_.m.cgobound = false
+	_g_.m.cgoprio = false
+	dropm()
 }
 
 var earlycgocallback = []byte("fatal error: cgo callback before cgo call\n")
 
+// maxCgoExtraM is the most extra Ms that GODEBUG=cgoextram creates
+// at start-up.
+const maxCgoExtraM = 1024
+
 // newextram allocates an m and puts it on the extra list.
 // It is called with a working local m, so that it can do things
 // like call schedlock and allocate.
@@ -1419,25 +1677,34 @@ func newextram() {
 	gp.stktopsp = gp.sched.sp
 	gp.gcscanvalid = true // fresh G, so no dequeueRescan necessary
 	gp.gcRescan = -1
+	// The goroutine is in a syscall for the tracer too, so that the
+	// first callback's exitsyscall emits GoSysExit (see execute).
+	gp.sysblocktraced = true
 	// malg returns status as Gidle, change to Gsyscall before adding to allg
 	// where GC will see it.
 	casgstatus(gp, _Gidle, _Gsyscall)
 	gp.m = mp
 	mp.curg = gp
 	mp.locked = _LockInternal
-	mp.lockedg = gp
-	gp.lockedm = mp
+	mp.lockedg.set(gp)
+	gp.lockedm.set(mp)
 	gp.goid = int64(atomic.Xadd64(&sched.goidgen, 1))
 	if raceenabled {
 		gp.racectx = racegostart(funcPC(newextram))
 	}
 	// put on allg for garbage collector
 	allgadd(gp)
+	atomic.Xadd64(&cgoThreadStats.ExtraM, 1)
+	if trace.enabled {
+		// StartTrace has not seen this goroutine.
+		traceGoCreateExtra(gp)
+	}
 
 	// Add m to the extra list.
-	mnext := lockextra(true)
-	mp.schedlink.set(mnext)
-	unlockextra(mp)
+	node := (*extraM)(persistentalloc(unsafe.Sizeof(extraM{}), sys.CacheLineSize, &memstats.other_sys))
+	node.mp.set(mp)
+	mp.extranode = node
+	pushextra(mp)
 }
 
 // dropm is called when a cgo callback has called needm but is now
@@ -1454,38 +1721,61 @@ func newextram() {
 // call. These should typically not be scheduling operations, just a few
 // atomics, so the cost should be small.
 //
-// TODO(rsc): An alternative would be to allocate a dummy pthread per-thread
-// variable using pthread_key_create. Unlike the pthread keys we already use
-// on OS X, this dummy key would never be read by Go code. It would exist
-// only so that we could register at thread-exit-time destructor.
-// That destructor would put the m back onto the extra list.
-// This is purely a performance optimization. The current version,
-// in which dropm happens on each cgo call, is still correct too.
-// We may have to keep the current version on systems with cgo
-// but without pthreads, like Windows.
+// With GODEBUG=cgostickym=1, on systems with pthreads, needm instead
+// binds the m to the thread with cgobindm, dropm leaves it in place,
+// and the m is put back onto the extra list by a pthread key destructor
+// in runtime/cgo when the thread exits (see cgounbindm).
+// Systems with cgo but without pthreads, like Windows, always use
+// the per-call version.
 func dropm() {
 	// Clear m and g, and return m to the extra list.
 	// After the call to setg we can only call nosplit functions
 	// with no pointer manipulation.
 	mp := getg().m
 
+	// A callback that readied a goroutine it knows to be waiting
+	// asks to hand off the p it used now, rather than leave it in
+	// a system call for sysmon to retake, so that the goroutine
+	// does not wait for sysmon.
+	if mp.cgohandoffp {
+		mp.cgohandoffp = false
+		if pp := mp.p.ptr(); pp != nil && atomic.Cas(&pp.status, _Psyscall, _Pidle) {
+			if trace.enabled {
+				traceGoSysBlock(pp)
+				traceProcStop(pp)
+			}
+			pp.syscalltick++
+			mp.p = 0
+			handoffp(pp)
+		}
+	}
+
+	if mp.cgobound {
+		// Keep g and m installed; the next callback from this
+		// thread will find them and skip needm.
+		return
+	}
+
 	// Block signals before unminit.
 	// Unminit unregisters the signal handling stack (but needs g on some systems).
 	// Setg(nil) clears g, which is the signal handler's cue not to run Go handlers.
 	// It's important not to try to handle a signal between those two steps.
 	sigmask := mp.sigmask
+	unwind := mp.cgounwind
+	mp.cgounwind = 0
 	sigblock()
 	unminit()
 
-	mnext := lockextra(true)
-	mp.schedlink.set(mnext)
-
 	setg(nil)
 
 	// Commit the release of mp.
-	unlockextra(mp)
+	pushextra(mp)
 
 	msigrestore(sigmask)
+
+	if unwind != 0 {
+		cgoCallbackTime(&cgoCallbackStats.Unwind, unwind)
+	}
 }
 
 // A helper function for EnsureDropM.
@@ -1493,40 +1783,49 @@ func getm() uintptr {
 	return uintptr(unsafe.Pointer(getg().m))
 }
 
-var extram uintptr
+// extram is the lock-free stack of extra m's, for cgo callbacks
+// on threads not created by Go. See needm.
+var extram uint64
 
-// lockextra locks the extra list and returns the list head.
-// The caller must unlock the list by storing a new list head
-// to extram. If nilokay is true, then lockextra will
-// return a nil list head if that's what it finds. If nilokay is false,
-// lockextra will keep waiting until the list head is no longer nil.
-//go:nosplit
-func lockextra(nilokay bool) *m {
-	const locked = 1
+// An extraM is an extra m's node in extram.
+// Nodes are allocated with persistentalloc, aligned to a cache line,
+// so that the 64-bit lfnode.next is suitably aligned for atomic
+// operations on 32-bit systems and so that threads pushing and
+// popping different m's do not share cache lines. Every m is also
+// on allm, so the mp link does not need to keep the m alive.
+type extraM struct {
+	node lfnode // must be first
+	mp   muintptr
+}
 
+// popextra pops an m from the extra list,
+// waiting until the list is not empty.
+//go:nosplit
+func popextra() *m {
+	atomic.Xadd64(&cgoStats.needM, 1)
+	var start int64
 	for {
-		old := atomic.Loaduintptr(&extram)
-		if old == locked {
-			yield := osyield
-			yield()
-			continue
-		}
-		if old == 0 && !nilokay {
-			usleep(1)
-			continue
+		if node := (*extraM)(lfstackpop(&extram)); node != nil {
+			atomic.Xadd64(&cgoStats.extraMIdle, -1)
+			if start != 0 {
+				atomic.Xadd64(&cgoStats.needMWaits, 1)
+				atomic.Xadd64(&cgoStats.needMWaitNanoseconds, nanotime()-start)
+			}
+			return node.mp.ptr()
 		}
-		if atomic.Casuintptr(&extram, old, locked) {
-			return (*m)(unsafe.Pointer(old))
+		if start == 0 {
+			start = nanotime()
 		}
-		yield := osyield
-		yield()
-		continue
+		usleep(1)
 	}
 }
 
+// pushextra puts mp on the extra list.
+// It may run without an m or g.
 //go:nosplit
-func unlockextra(mp *m) {
-	atomic.Storeuintptr(&extram, uintptr(unsafe.Pointer(mp)))
+func pushextra(mp *m) {
+	lfstackpush(&extram, &mp.extranode.node)
+	atomic.Xadd64(&cgoStats.extraMIdle, 1)
 }
 
 // Create a new m. It will start off with a call to fn, or else the scheduler.
@@ -1536,15 +1835,26 @@ func unlockextra(mp *m) {
 func newm(fn func(), _p_ *p) {
 	mp := allocm(_p_, fn)
 	mp.nextp.set(_p_)
+	newm1(mp)
+}
+
+// newm1 starts the thread of mp, from allocm.
+//go:nowritebarrier
+func newm1(mp *m) {
 	mp.sigmask = initSigmask
 	if iscgo {
-		var ts cgothreadstart
 		if _cgo_thread_start == nil {
 			throw("_cgo_thread_start missing")
 		}
-		ts.g.set(mp.g0)
-		ts.tls = (*uint64)(unsafe.Pointer(&mp.tls[0]))
-		ts.fn = unsafe.Pointer(funcPC(mstart))
+		if b := (*cgothreadbatch)(unsafe.Pointer(getg().m.threadbatch)); b != nil {
+			b.ms[b.n].set(mp)
+			b.n++
+			if b.n == len(b.ms) {
+				startthreadbatch(b)
+			}
+			return
+		}
+		ts := newmthreadstart(mp)
 		if msanenabled {
 			msanwrite(unsafe.Pointer(&ts), unsafe.Sizeof(ts))
 		}
@@ -1575,6 +1885,9 @@ retry:
 	unlock(&sched.lock)
 	notesleep(&_g_.m.park)
 	noteclear(&_g_.m.park)
+	if atomic.Load(&libreleased) != 0 {
+		mexit()
+	}
 	if _g_.m.helpgc != 0 {
 		gchelper()
 		_g_.m.helpgc = 0
@@ -1710,7 +2023,7 @@ func wakep() {
 func stoplockedm() {
 	_g_ := getg()
 
-	if _g_.m.lockedg == nil || _g_.m.lockedg.lockedm != _g_.m {
+	if _g_.m.lockedg == 0 || _g_.m.lockedg.ptr().lockedm.ptr() != _g_.m {
 		throw("stoplockedm: inconsistent locking")
 	}
 	if _g_.m.p != 0 {
@@ -1722,7 +2035,10 @@ func stoplockedm() {
 	// Wait until another thread schedules lockedg again.
 	notesleep(&_g_.m.park)
 	noteclear(&_g_.m.park)
-	status := readgstatus(_g_.m.lockedg)
+	if atomic.Load(&libreleased) != 0 {
+		mexit()
+	}
+	status := readgstatus(_g_.m.lockedg.ptr())
 	if status&^_Gscan != _Grunnable {
 		print("runtime:stoplockedm: g is not Grunnable or Gscanrunnable\n")
 		dumpgstatus(_g_)
@@ -1738,7 +2054,7 @@ func stoplockedm() {
 func startlockedm(gp *g) {
 	_g_ := getg()
 
-	mp := gp.lockedm
+	mp := gp.lockedm.ptr()
 	if mp == _g_.m {
 		throw("startlockedm: locked to me")
 	}
@@ -1753,6 +2069,29 @@ func startlockedm(gp *g) {
 	stopm()
 }
 
+// Schedules gp, which last called C on mp, to run on mp if it is
+// idle, handing it the current P with gp in runnext, and blocks
+// waiting for a new P. Reports whether it did.
+// May run during STW, so write barriers are not allowed.
+//go:nowritebarrier
+func startaffinem(gp *g, mp *m) bool {
+	lock(&sched.lock)
+	ok := mgetm(mp)
+	unlock(&sched.lock)
+	if !ok {
+		return false
+	}
+	if mp.nextp != 0 {
+		throw("startaffinem: m has p")
+	}
+	_p_ := releasep()
+	runqput(_p_, gp, true)
+	mp.nextp.set(_p_)
+	notewakeup(&mp.park)
+	stopm()
+	return true
+}
+
 // Stops the current m for stopTheWorld.
 // Returns when the world is restarted.
 func gcstopm() {
@@ -1975,7 +2314,7 @@ stop:
 	}
 
 	// poll network
-	if netpollinited() && atomic.Xchg64(&sched.lastpoll, 0) != 0 {
+	if netpollinited() && atomic.Load(&netpollHosted) == 0 && atomic.Xchg64(&sched.lastpoll, 0) != 0 {
 		if _g_.m.p != 0 {
 			throw("findrunnable: netpoll with p")
 		}
@@ -2056,9 +2395,9 @@ func schedule() {
 		throw("schedule: holding locks")
 	}
 
-	if _g_.m.lockedg != nil {
+	if _g_.m.lockedg != 0 {
 		stoplockedm()
-		execute(_g_.m.lockedg, false) // Never returns.
+		execute(_g_.m.lockedg.ptr(), false) // Never returns.
 	}
 
 top:
@@ -2086,7 +2425,16 @@ top:
 		// Check the global runnable queue once in a while to ensure fairness.
 		// Otherwise two goroutines can completely occupy the local runqueue
 		// by constantly respawning each other.
-		if _g_.m.p.ptr().schedtick%61 == 0 && sched.runqsize > 0 {
+		// Callbacks from latency-critical C threads are at the
+		// head of the queue and should run right away.
+		if atomic.Load(&sched.nprio) != 0 {
+			lock(&sched.lock)
+			if sched.nprio != 0 {
+				sched.nprio--
+			}
+			gp = globrunqget(_g_.m.p.ptr(), 1)
+			unlock(&sched.lock)
+		} else if _g_.m.p.ptr().schedtick%61 == 0 && sched.runqsize > 0 {
 			lock(&sched.lock)
 			gp = globrunqget(_g_.m.p.ptr(), 1)
 			unlock(&sched.lock)
@@ -2109,13 +2457,23 @@ top:
 		resetspinning()
 	}
 
-	if gp.lockedm != nil {
+	if gp.lockedm != 0 {
 		// Hands off own p to the locked m,
 		// then blocks waiting for a new p.
 		startlockedm(gp)
 		goto top
 	}
 
+	if gp.cgoAffinity != 0 {
+		// The affinity is tried once: the next affine call
+		// sets it again.
+		mp := gp.cgoAffinity.ptr()
+		gp.cgoAffinity = 0
+		if mp != _g_.m && startaffinem(gp, mp) {
+			goto top
+		}
+	}
+
 	execute(gp, inheritTime)
 }
 
@@ -2214,9 +2572,11 @@ func goexit0(gp *g) {
 	if isSystemGoroutine(gp) {
 		atomic.Xadd(&sched.ngsys, -1)
 	}
+	locked := _g_.m.locked&_LockExternal != 0
 	gp.m = nil
-	gp.lockedm = nil
-	_g_.m.lockedg = nil
+	gp.lockedm = 0
+	gp.cgoAffinity = 0
+	_g_.m.lockedg = 0
 	gp.paniconfault = false
 	gp._defer = nil // should be true already but just in case.
 	gp._panic = nil // non-nil for Goexit during panic. points at stack-allocated data.
@@ -2236,6 +2596,17 @@ func goexit0(gp *g) {
 	}
 	_g_.m.locked = 0
 	gfput(_g_.m.p.ptr(), gp)
+	if locked && _g_.m.cgonode {
+		unplaceOSThread(_g_.m)
+	}
+	if locked && _cgo_thread_reset != nil {
+		// The goroutine may have left C state on the thread,
+		// which it had to itself. Let the program clean it up
+		// before another goroutine runs here.
+		if fn := atomic.Loadp(_cgo_thread_reset); fn != nil {
+			asmcgocall(fn, nil)
+		}
+	}
 	schedule()
 }
 
@@ -2599,10 +2970,25 @@ func exitsyscall0(gp *g) {
 
 	casgstatus(gp, _Gsyscall, _Grunnable)
 	dropg()
+	var _p_ *p
+	prio := _g_.m.cgoprio
+	if prio && sched.pidle == 0 {
+		// A latency-critical C thread does not wait for sysmon
+		// to retake a P from a thread blocked in a system call.
+		_p_ = cgoprioTakeP()
+	}
 	lock(&sched.lock)
-	_p_ := pidleget()
 	if _p_ == nil {
-		globrunqput(gp)
+		_p_ = pidleget()
+	}
+	if _p_ == nil {
+		if prio {
+			// Run gp before any other queued goroutine.
+			globrunqputhead(gp)
+			sched.nprio++
+		} else {
+			globrunqput(gp)
+		}
 	} else if atomic.Load(&sched.sysmonwait) != 0 {
 		atomic.Store(&sched.sysmonwait, 0)
 		notewakeup(&sched.sysmonnote)
@@ -2612,7 +2998,11 @@ func exitsyscall0(gp *g) {
 		acquirep(_p_)
 		execute(gp, false) // Never returns.
 	}
-	if _g_.m.lockedg != nil {
+	if prio {
+		// Make some P look at the run queue soon.
+		cgoprioPreempt()
+	}
+	if _g_.m.lockedg != 0 {
 		// Wait until another thread schedules gp and so m again.
 		stoplockedm()
 		execute(gp, false) // Never returns.
@@ -2621,6 +3011,43 @@ func exitsyscall0(gp *g) {
 	schedule() // Never returns.
 }
 
+// cgoprioTakeP takes the P of a thread blocked in a system call
+// or C call, as sysmon's retake would, for a callback from a
+// latency-critical C thread. It returns nil if there is none
+// or if the world is stopping.
+func cgoprioTakeP() *p {
+	if sched.gcwaiting != 0 {
+		return nil
+	}
+	for i := int32(0); i < gomaxprocs; i++ {
+		_p_ := allp[i]
+		if _p_ == nil || _p_.status != _Psyscall {
+			continue
+		}
+		if atomic.Cas(&_p_.status, _Psyscall, _Pidle) {
+			if trace.enabled {
+				traceGoSysBlock(_p_)
+				traceProcStop(_p_)
+			}
+			_p_.syscalltick++
+			return _p_
+		}
+	}
+	return nil
+}
+
+// cgoprioPreempt asks the goroutine running on one P to stop, so that
+// the P schedules the callback that a latency-critical C thread has
+// just put at the head of the global run queue.
+func cgoprioPreempt() {
+	for i := int32(0); i < gomaxprocs; i++ {
+		_p_ := allp[i]
+		if _p_ != nil && _p_.status == _Prunning && preemptone(_p_) {
+			return
+		}
+	}
+}
+
 func beforefork() {
 	gp := getg().m.curg
 
@@ -2921,8 +3348,8 @@ func Breakpoint() {
 //go:nosplit
 func dolockOSThread() {
 	_g_ := getg()
-	_g_.m.lockedg = _g_
-	_g_.lockedm = _g_.m
+	_g_.m.lockedg.set(_g_)
+	_g_.lockedm.set(_g_.m)
 }
 
 //go:nosplit
@@ -2930,6 +3357,9 @@ func dolockOSThread() {
 // LockOSThread wires the calling goroutine to its current operating system thread.
 // Until the calling goroutine exits or calls UnlockOSThread, it will always
 // execute in that thread, and no other goroutine can.
+// In a program that uses cgo, a C function set with GoSetThreadReset
+// (see cmd/cgo) runs on the thread if the goroutine exits while locked,
+// before the thread is used for other goroutines.
 func LockOSThread() {
 	getg().m.locked |= _LockExternal
 	dolockOSThread()
@@ -2950,8 +3380,8 @@ func dounlockOSThread() {
 	if _g_.m.locked != 0 {
 		return
 	}
-	_g_.m.lockedg = nil
-	_g_.lockedm = nil
+	_g_.m.lockedg = 0
+	_g_.lockedm = 0
 }
 
 //go:nosplit
@@ -2959,10 +3389,91 @@ func dounlockOSThread() {
 // UnlockOSThread unwires the calling goroutine from its fixed operating system thread.
 // If the calling goroutine has not called LockOSThread, UnlockOSThread is a no-op.
 func UnlockOSThread() {
-	getg().m.locked &^= _LockExternal
+	_g_ := getg()
+	if _g_.m.cgonode && _g_.m.locked&_LockExternal != 0 {
+		// Still wired to the thread, so a stack split here
+		// cannot move us off it.
+		unplaceOSThread(_g_.m)
+	}
+	_g_.m.locked &^= _LockExternal
 	dounlockOSThread()
 }
 
+// LockOSThreadNode wires the calling goroutine to its current operating
+// system thread, as LockOSThread does, and then asks the operating system
+// to run that thread only on the CPUs of NUMA node node. A goroutine can
+// use it to place itself before calling C code that keeps per-node state.
+// UnlockOSThread, or the goroutine exiting while still wired to the thread,
+// gives the thread back the CPUs it had before it was placed.
+//
+// LockOSThreadNode reports whether the thread was placed. It is only
+// supported on Linux and FreeBSD in programs that use cgo. On FreeBSD,
+// where NUMA nodes are memory domains, the thread also prefers the
+// node's memory.
+func LockOSThreadNode(node int) bool {
+	LockOSThread()
+	if !iscgo || _cgo_set_thread_node == nil || node < 0 || int(int32(node)) != node {
+		return false
+	}
+	args := struct {
+		node int32
+		ok   int32
+	}{int32(node), 0}
+	getg().m.cgonode = true
+	cgocall(_cgo_set_thread_node, unsafe.Pointer(&args))
+	return args.ok != 0
+}
+
+// unplaceOSThread undoes LockOSThreadNode on mp's thread, which must be
+// the current one, so that the goroutines that run on the thread next
+// are not confined to the node. It is called on g0 by goexit0, or by
+// UnlockOSThread while the goroutine is still wired to the thread, and
+// makes a C call without entering a system call, as the C code only
+// asks the operating system to change the thread's CPU set.
+func unplaceOSThread(mp *m) {
+	mp.cgonode = false
+	args := struct {
+		node int32 // -1 to restore the thread's CPUs from before
+		ok   int32
+	}{-1, 0}
+	asmcgocall(_cgo_set_thread_node, unsafe.Pointer(&args))
+}
+
+// SetCgoLatencyCritical marks the C thread that made the current call
+// from C to Go as latency-critical, or, if on is false, clears the mark.
+// It must be called by an exported Go function running on a thread
+// that was not created by Go, such as an audio thread of a C library.
+//
+// Later calls into Go from a latency-critical thread reuse the M that
+// the runtime lends the thread, as with GODEBUG=cgostickym=1, until
+// the thread exits. When no P is idle on entry, such a call takes the
+// P of a thread blocked in a system call or C call without waiting
+// for the runtime to retake it, or else is put ahead of all other
+// runnable goroutines and a running goroutine is asked to yield.
+// A call can still wait for a garbage collection to stop the world.
+//
+// SetCgoLatencyCritical reports whether the setting took effect. It
+// returns false when called on a thread created by Go, and on Windows
+// and OpenBSD.
+func SetCgoLatencyCritical(on bool) bool {
+	_g_ := getg()
+	mp := _g_.m
+	if !iscgo || mp.extranode == nil || _g_ != mp.curg {
+		return false
+	}
+	if on && !mp.cgobound {
+		if _cgo_bindm == nil {
+			return false
+		}
+		cgobindm(mp)
+		if !mp.cgobound {
+			return false
+		}
+	}
+	mp.cgoprio = on
+	return true
+}
+
 //go:nosplit
 func unlockOSThread() {
 	_g_ := getg()
@@ -3097,7 +3608,7 @@ func sigprof(pc, sp, lr uintptr, gp *g, mp *m) {
 		// with all signals blocked, so we don't have to worry
 		// about any other code interrupting us.
 		if atomic.Load(&mp.cgoCallersUse) == 0 && mp.cgoCallers != nil && mp.cgoCallers[0] != 0 {
-			for cgoOff < len(mp.cgoCallers) && mp.cgoCallers[cgoOff] != 0 {
+			for cgoOff < len(mp.cgoCallers) && cgoOff < len(stk) && mp.cgoCallers[cgoOff] != 0 {
 				cgoOff++
 			}
 			copy(stk[:], mp.cgoCallers[:cgoOff])
@@ -3219,9 +3730,9 @@ func setcpuprofilerate_m(hz int32) {
 	sched.profilehz = hz
 	unlock(&sched.lock)
 
-	if hz != 0 {
-		resetcpuprofiler(hz)
-	}
+	// Even when stopping, so that the signal code
+	// sees the new rate; see sigfwdonly.
+	resetcpuprofiler(hz)
 
 	_g_.m.locks--
 }
@@ -3542,6 +4053,7 @@ func sysmon() {
 	nscavenge := 0
 
 	lasttrace := int64(0)
+	laststats := int64(0)
 	idle := 0 // how many cycles in succession we had not wokeup somebody
 	delay := uint32(0)
 	for {
@@ -3556,9 +4068,15 @@ func sysmon() {
 		usleep(delay)
 		if debug.schedtrace <= 0 && (sched.gcwaiting != 0 || atomic.Load(&sched.npidle) == uint32(gomaxprocs)) { // TODO: fast atomic
 			lock(&sched.lock)
-			if atomic.Load(&sched.gcwaiting) != 0 || atomic.Load(&sched.npidle) == uint32(gomaxprocs) {
+			// Checking libreleased under sched.lock orders it
+			// with the wakeup in _cgo_release_internal.
+			if (atomic.Load(&sched.gcwaiting) != 0 || atomic.Load(&sched.npidle) == uint32(gomaxprocs)) && atomic.Load(&libreleased) == 0 {
 				atomic.Store(&sched.sysmonwait, 1)
 				unlock(&sched.lock)
+				// Leave the stats page up to date
+				// for as long as sysmon sleeps.
+				cgoStatsPublish()
+				laststats = nanotime()
 				// Make wake-up period small enough
 				// for the sampling to be correct.
 				maxsleep := forcegcperiod / 2
@@ -3574,11 +4092,15 @@ func sysmon() {
 			}
 			unlock(&sched.lock)
 		}
-		// poll network if not polled for more than 10ms
+		if atomic.Load(&libreleased) != 0 {
+			mexit()
+		}
+		// poll network if not polled for more than 10ms,
+		// unless a C host polls it; see GoNetpollDescriptor.
 		lastpoll := int64(atomic.Load64(&sched.lastpoll))
 		now := nanotime()
 		unixnow := unixnanotime()
-		if lastpoll != 0 && lastpoll+10*1000*1000 < now {
+		if lastpoll != 0 && lastpoll+10*1000*1000 < now && atomic.Load(&netpollHosted) == 0 {
 			atomic.Cas64(&sched.lastpoll, uint64(lastpoll), uint64(now))
 			gp := netpoll(false) // non-blocking - returns list of goroutines
 			if gp != nil {
@@ -3595,8 +4117,17 @@ func sysmon() {
 			}
 		}
 		// retake P's blocked in syscalls
-		// and preempt long running G's
-		if retake(now) != 0 {
+		// and preempt long running G's.
+		// When many Ps are blocked in cgo calls at once,
+		// starting the Ms that take them over as a batch
+		// is cheaper than starting them one at a time.
+		beginthreadbatch(&sysmonthreadbatch)
+		nretake := retake(now)
+		endthreadbatch(&sysmonthreadbatch)
+		if iscgo {
+			cgoThreadSamplePeak()
+		}
+		if nretake != 0 {
 			idle = 0
 		} else {
 			idle++
@@ -3620,6 +4151,10 @@ func sysmon() {
 			lasttrace = now
 			schedtrace(debug.scheddetail > 0)
 		}
+		if laststats+cgoStatsPeriod <= now {
+			laststats = now
+			cgoStatsPublish()
+		}
 	}
 }
 
@@ -3657,6 +4192,12 @@ func retake(now int64) uint32 {
 			if runqempty(_p_) && atomic.Load(&sched.nmspinning)+atomic.Load(&sched.npidle) > 0 && pd.syscallwhen+10*1000*1000 > now {
 				continue
 			}
+			// Leave the P with an M in a cgo call that usually
+			// returns soon, until it has taken twice as long as
+			// usual, so that short calls do not churn Ms.
+			if pd.syscallwhen+cgoCallExpected(_p_) > now {
+				continue
+			}
 			// Need to decrement number of idle locked M's
 			// (pretending that one more is running) before the CAS.
 			// Otherwise the M from which we retake can exit the syscall,
@@ -3790,7 +4331,7 @@ func schedtrace(detailed bool) {
 	for mp := allm; mp != nil; mp = mp.alllink {
 		_p_ := mp.p.ptr()
 		gp := mp.curg
-		lockedg := mp.lockedg
+		lockedg := mp.lockedg.ptr()
 		id1 := int32(-1)
 		if _p_ != nil {
 			id1 = _p_.id
@@ -3810,7 +4351,7 @@ func schedtrace(detailed bool) {
 	for gi := 0; gi < len(allgs); gi++ {
 		gp := allgs[gi]
 		mp := gp.m
-		lockedm := gp.lockedm
+		lockedm := gp.lockedm.ptr()
 		id1 := int32(-1)
 		if mp != nil {
 			id1 = mp.id
@@ -3831,6 +4372,11 @@ func schedtrace(detailed bool) {
 //go:nowritebarrier
 func mput(mp *m) {
 	mp.schedlink = sched.midle
+	mp.idleprev = 0
+	mp.idle = true
+	if head := sched.midle.ptr(); head != nil {
+		head.idleprev.set(mp)
+	}
 	sched.midle.set(mp)
 	sched.nmidle++
 	checkdead()
@@ -3843,12 +4389,35 @@ func mput(mp *m) {
 func mget() *m {
 	mp := sched.midle.ptr()
 	if mp != nil {
-		sched.midle = mp.schedlink
-		sched.nmidle--
+		mgetm(mp)
 	}
 	return mp
 }
 
+// Try to take mp off the midle list.
+// Sched must be locked.
+// May run during STW, so write barriers are not allowed.
+//go:nowritebarrier
+func mgetm(mp *m) bool {
+	if !mp.idle {
+		return false
+	}
+	next := mp.schedlink.ptr()
+	if prev := mp.idleprev.ptr(); prev != nil {
+		prev.schedlink = mp.schedlink
+	} else {
+		sched.midle = mp.schedlink
+	}
+	if next != nil {
+		next.idleprev = mp.idleprev
+	}
+	mp.schedlink = 0
+	mp.idleprev = 0
+	mp.idle = false
+	sched.nmidle--
+	return true
+}
+
 // Put gp on the global runnable queue.
 // Sched must be locked.
 // May run during STW, so write barriers are not allowed.
@@ -561,6 +561,24 @@ func TestSchedLocalQueueSteal(t *testing.T) {
 	runtime.RunSchedLocalQueueStealTest()
 }
 
+func TestCgoRetake(t *testing.T) {
+	// A P in a short C call that is made over and over stays with
+	// its M for twice the usual duration of the call.
+	const short = 100 * 1000
+	if got := runtime.CgoRetakeHold(0x1000, short, false); got != 2*short {
+		t.Errorf("P in short cgo call held %dns, want %dns", got, 2*short)
+	}
+	// Once that call has returned, another system call on the P
+	// gets no extra time.
+	if got := runtime.CgoRetakeHold(0x1000, short, true); got != 0 {
+		t.Errorf("P in system call after short cgo call held %dns, want 0", got)
+	}
+	// A P in a long C call is retaken as usual.
+	if got := runtime.CgoRetakeHold(0x2000, 10*1000*1000, false); got != 0 {
+		t.Errorf("P in long cgo call held %dns, want 0", got)
+	}
+}
+
 func TestSchedLocalQueueEmpty(t *testing.T) {
 	if runtime.NumCPU() == 1 {
 		// Takes too long and does not trigger the race.
@@ -18,3 +18,13 @@ func TestNoRaceCgoSync(t *testing.T) {
 		t.Fatalf("program exited with error: %v\n", err)
 	}
 }
+
+func TestNoRaceCgoSyncFunc(t *testing.T) {
+	cmd := exec.Command("go", "run", "-race", "cgo_test_main2.go")
+	cmd.Env = append(os.Environ(), "GODEBUG=cgoracesync=1")
+	cmd.Stdout = os.Stdout
+	cmd.Stderr = os.Stderr
+	if err := cmd.Run(); err != nil {
+		t.Fatalf("program exited with error: %v\n", err)
+	}
+}
@@ -0,0 +1,32 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Like cgo_test_main.go, but the notification and the wait are calls
+// to the same C function, as GODEBUG=cgoracesync=1 needs.
+
+/*
+int sync;
+
+void Sync(int notify)
+{
+	if(notify) {
+		__sync_fetch_and_add(&sync, 1);
+		return;
+	}
+	while(__sync_fetch_and_add(&sync, 0) == 0) {}
+}
+*/
+import "C"
+
+func main() {
+	data := 0
+	go func() {
+		data = 1
+		C.Sync(1)
+	}()
+	C.Sync(0)
+	_ = data
+}
@@ -23,6 +23,13 @@ TEXT _rt0_amd64_linux_lib(SB),NOSPLIT,$0x48
 	MOVQ	DI, _rt0_amd64_linux_lib_argc<>(SB)
 	MOVQ	SI, _rt0_amd64_linux_lib_argv<>(SB)
 
+	// Libraries built with -linkshared share the runtime;
+	// only the first one starts it.
+	MOVQ	$runtime·libstart(SB), AX
+	CALL	AX
+	CMPB	0(SP), $0
+	JEQ	restore
+
 	// Synchronous initialization.
 	MOVQ	$runtime·libpreinit(SB), AX
 	CALL	AX
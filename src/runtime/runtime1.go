@@ -315,7 +315,21 @@ type dbgVar struct {
 // already have an initial value.
 var debug struct {
 	allocfreetrace    int32
+	cgoaffinity       int32
+	cgoasyncthreads   int32
+	cgocallbackstats  int32
 	cgocheck          int32
+	cgochecksample    int32
+	cgoextram         int32
+	cgoflight         int32
+	cgofpunwind       int32
+	cgoinittrace      int32
+	cgoracesync       int32
+	cgostickym        int32
+	cgothreadaffinity int32
+	cgothreadpool     int32
+	cgothreadstack    int32
+	cgotracebackdepth int32
 	efence            int32
 	gccheckmark       int32
 	gcpacertrace      int32
@@ -324,6 +338,9 @@ var debug struct {
 	gcstackbarrierall int32
 	gcstoptheworld    int32
 	gctrace           int32
+	heaphugepages     int32
+	heapnuma          int32
+	heapprefault      int32
 	invalidptr        int32
 	sbrk              int32
 	scavenge          int32
@@ -334,7 +351,21 @@ var debug struct {
 
 var dbgvars = []dbgVar{
 	{"allocfreetrace", &debug.allocfreetrace},
+	{"cgoaffinity", &debug.cgoaffinity},
+	{"cgoasyncthreads", &debug.cgoasyncthreads},
+	{"cgocallbackstats", &debug.cgocallbackstats},
 	{"cgocheck", &debug.cgocheck},
+	{"cgochecksample", &debug.cgochecksample},
+	{"cgoextram", &debug.cgoextram},
+	{"cgoflight", &debug.cgoflight},
+	{"cgofpunwind", &debug.cgofpunwind},
+	{"cgoinittrace", &debug.cgoinittrace},
+	{"cgoracesync", &debug.cgoracesync},
+	{"cgostickym", &debug.cgostickym},
+	{"cgothreadaffinity", &debug.cgothreadaffinity},
+	{"cgothreadpool", &debug.cgothreadpool},
+	{"cgothreadstack", &debug.cgothreadstack},
+	{"cgotracebackdepth", &debug.cgotracebackdepth},
 	{"efence", &debug.efence},
 	{"gccheckmark", &debug.gccheckmark},
 	{"gcpacertrace", &debug.gcpacertrace},
@@ -343,6 +374,9 @@ var dbgvars = []dbgVar{
 	{"gcstackbarrierall", &debug.gcstackbarrierall},
 	{"gcstoptheworld", &debug.gcstoptheworld},
 	{"gctrace", &debug.gctrace},
+	{"heaphugepages", &debug.heaphugepages},
+	{"heapnuma", &debug.heapnuma},
+	{"heapprefault", &debug.heapprefault},
 	{"invalidptr", &debug.invalidptr},
 	{"sbrk", &debug.sbrk},
 	{"scavenge", &debug.scavenge},
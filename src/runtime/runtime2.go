@@ -338,12 +338,14 @@ type g struct {
 	gcscandone     bool     // g has scanned stack; protected by _Gscan bit in status
 	gcscanvalid    bool     // false at start of gc cycle, true if G has not run since last scan; transition from true to false by calling queueRescan and false to true by calling dequeueRescan
 	throwsplit     bool     // must not split stack
+	cgoasync       bool     // parked in cgocallasync; a C thread is using its stack
 	raceignore     int8     // ignore race detection events
 	sysblocktraced bool     // StartTrace has emitted EvGoInSyscall about this goroutine
 	sysexitticks   int64    // cputicks when syscall has returned (for tracing)
 	traceseq       uint64   // trace event sequencer
 	tracelastp     puintptr // last P emitted an event for this goroutine
-	lockedm        *m
+	lockedm        muintptr
+	cgoAffinity    muintptr // m that made its last affine C call, until schedule tries it; see startaffinem
 	sig            uint32
 	writebuf       []byte
 	sigcode0       uintptr
@@ -397,22 +399,28 @@ type m struct {
 	softfloat     int32
 	dying         int32
 	profilehz     int32
+	cputimer      int32 // thread's CPU profiling timer, if cputimerOK; on Linux
+	cputimerOK    bool
 	helpgc        int32
-	spinning      bool // m is out of work and is actively looking for work
-	blocked       bool // m is blocked on a note
-	inwb          bool // m is executing a write barrier
-	newSigstack   bool // minit on C thread called sigaltstack
+	spinning      bool  // m is out of work and is actively looking for work
+	blocked       bool  // m is blocked on a note
+	inwb          bool  // m is executing a write barrier
+	newSigstack   bool  // minit on C thread called sigaltstack
+	sigstack      stack // signal stack from sigstackget, on Linux
 	printlock     int8
 	fastrand      uint32
-	ncgocall      uint64      // number of cgo calls in total
-	ncgo          int32       // number of cgo calls currently in progress
-	cgoCallersUse uint32      // if non-zero, cgoCallers in use temporarily
-	cgoCallers    *cgoCallers // cgo traceback if crashing in cgo call
+	ncgocall      uint64     // number of cgo calls in total
+	ncgo          int32      // number of cgo calls currently in progress
+	ncgoinc       uint32     // number of cgo calls in C, for ReadCgoThreadStats
+	cgoCallersUse uint32     // if non-zero, cgoCallers in use temporarily
+	cgoCallers    cgoCallers // cgo traceback if crashing in cgo call
 	park          note
 	alllink       *m // on allm
 	schedlink     muintptr
+	idleprev      muintptr // previous m on sched.midle, if idle
+	idle          bool     // m is on sched.midle
 	mcache        *mcache
-	lockedg       *g
+	lockedg       guintptr
 	createstack   [32]uintptr // stack that created this thread.
 	freglo        [16]uint32  // d[i] lsb and f[i]
 	freghi        [16]uint32  // d[i] msb and f[i+16]
@@ -421,6 +429,17 @@ type m struct {
 	nextwaitm     uintptr     // next m waiting for lock
 	gcstats       gcstats
 	needextram    bool
+	extranode     *extraM            // node for the extra list, if this is an extra m
+	cgobound      bool               // extra m kept by its C thread until the thread exits; see cgobindm
+	cgounwind     int64              // nanotime when the unwind phase of a callback started; see cgocallbackstats
+	cgoprio       bool               // callbacks on this bound m are latency-critical; see SetCgoLatencyCritical
+	cgoleaf       bool               // running a #cgo leaf: C function; see cgocallleaf
+	cgonode       bool               // thread placed by LockOSThreadNode; see unplaceOSThread
+	cgohandoffp   bool               // dropm hands off the p right away; see _cgo_callpool_done_internal
+	cgocallfn     uintptr            // C function of the cgo call in progress; see racecgosyncaddr
+	cgoneedmtime  int64              // nanoseconds needm spent acquiring this extra m, for the tracer
+	g0stackguess  bool               // g0 stack bounds of this extra m are a guess; see setg0stack
+	cgoflight     *cgoFlightRecorder // recent cgo transitions, for GODEBUG=cgoflight
 	traceback     uint8
 	waitunlockf   unsafe.Pointer // todo go func(*g, unsafe.pointer) bool
 	waitlock      unsafe.Pointer
@@ -429,6 +448,7 @@ type m struct {
 	startingtrace bool
 	syscalltick   uint32
 	thread        uintptr // thread handle
+	threadbatch   uintptr // *cgothreadbatch collecting newm thread starts, if non-zero
 
 	// these are here because they are too large to be on the stack
 	// of low-level NOSPLIT functions.
@@ -449,6 +469,8 @@ type p struct {
 	link        puintptr
 	schedtick   uint32   // incremented on every scheduler call
 	syscalltick uint32   // incremented on every system call
+	cgocallfn   uintptr  // C function of the cgo call in system call cgocalltick, for retake
+	cgocalltick uint32   // syscalltick of the cgo call to cgocallfn
 	m           muintptr // back-link to associated m (nil if idle)
 	mcache      *mcache
 	racectx     uintptr
@@ -486,6 +508,8 @@ type p struct {
 
 	palloc persistentAlloc // per-P to avoid mutex
 
+	internCache *[internCacheSize]string // see gostringintern
+
 	// Per-P GC state
 	gcAssistTime     int64 // Nanoseconds in assistAlloc
 	gcBgMarkWorker   guintptr
@@ -531,6 +555,11 @@ type schedt struct {
 	runqtail guintptr
 	runqsize int32
 
+	// Number of callbacks from latency-critical C threads put at the
+	// head of the global run queue and not yet looked for by schedule.
+	// Updated with sched.lock held; read atomically without it.
+	nprio uint32
+
 	// Global cache of dead G's.
 	gflock       mutex
 	gfreeStack   *g
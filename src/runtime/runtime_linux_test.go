@@ -5,6 +5,8 @@
 package runtime_test
 
 import (
+	"internal/testenv"
+	"os/exec"
 	. "runtime"
 	"syscall"
 	"testing"
@@ -40,3 +42,53 @@ func TestMincoreErrorSign(t *testing.T) {
 		t.Errorf("mincore = %v, want %v", v, -EINVAL)
 	}
 }
+
+func TestHeapHugePages(t *testing.T) {
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprog")
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, env := range []string{"", "GODEBUG=heaphugepages=1", "GODEBUG=heaphugepages=2"} {
+		cmd := testEnv(exec.Command(exe, "HeapHugePages"))
+		if env != "" {
+			cmd.Env = append(cmd.Env, env)
+		}
+		got, _ := cmd.CombinedOutput()
+		if want := "OK\n"; string(got) != want {
+			t.Errorf("%s: expected %q, got %v", env, want, string(got))
+		}
+	}
+}
+
+func TestHeapNUMA(t *testing.T) {
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprog")
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, env := range []string{"", "GODEBUG=heapnuma=1"} {
+		cmd := testEnv(exec.Command(exe, "HeapNUMA"))
+		if env != "" {
+			cmd.Env = append(cmd.Env, env)
+		}
+		got, _ := cmd.CombinedOutput()
+		if want := "OK\n"; string(got) != want {
+			t.Errorf("%s: expected %q, got %v", env, want, string(got))
+		}
+	}
+}
+
+func TestHeapPrefault(t *testing.T) {
+	testenv.MustHaveGoBuild(t)
+	exe, err := buildTestProg(t, "testprog")
+	if err != nil {
+		t.Fatal(err)
+	}
+	cmd := testEnv(exec.Command(exe, "HeapPrefault"))
+	cmd.Env = append(cmd.Env, "GODEBUG=heapprefault=1")
+	got, _ := cmd.CombinedOutput()
+	if want := "OK\n"; string(got) != want {
+		t.Errorf("expected %q, got %v", want, string(got))
+	}
+}
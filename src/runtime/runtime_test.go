@@ -329,3 +329,29 @@ func TestGoroutineProfileTrivial(t *testing.T) {
 		}
 	}
 }
+
+var (
+	cgoPointerData    = &cgoPointerBSS
+	cgoPointerBSS     *int
+	cgoPointerNoptr   [64]byte
+	cgoPointerHeapPtr *int
+)
+
+func TestCgoIsGoPointer(t *testing.T) {
+	cgoPointerHeapPtr = new(int)
+	for _, tt := range []struct {
+		name string
+		p    unsafe.Pointer
+		want bool
+	}{
+		{"nil", nil, false},
+		{"data", unsafe.Pointer(&cgoPointerData), true},
+		{"bss", unsafe.Pointer(&cgoPointerBSS), true},
+		{"heap", unsafe.Pointer(cgoPointerHeapPtr), true},
+		{"noptrbss", unsafe.Pointer(&cgoPointerNoptr[8]), false},
+	} {
+		if got := CgoIsGoPointer(tt.p); got != tt.want {
+			t.Errorf("CgoIsGoPointer(%s %p) = %v, want %v", tt.name, tt.p, got, tt.want)
+		}
+	}
+}
@@ -7,6 +7,7 @@
 package runtime
 
 import (
+	"runtime/internal/atomic"
 	"runtime/internal/sys"
 	"unsafe"
 )
@@ -24,6 +25,14 @@ const (
 // Signal forwarding is currently available only on Darwin and Linux.
 var fwdSig [_NSIG]uintptr
 
+// For each signal that Go installed its handler for but has no use
+// for, sigfwdonly holds the handler that was installed before Go's.
+// Such a signal does not need the runtime at all: the signal
+// trampoline (on linux/amd64) and sigfwdgo pass it straight to that
+// handler, without finding or creating an m. Zero means that the
+// runtime must look at the signal.
+var sigfwdonly [_NSIG]uintptr
+
 // sigmask represents a general signal mask compatible with the GOOS
 // specific sigset types: the signal numbered x is represented by bit x-1
 // to match the representation expected by sigprocmask.
@@ -82,9 +91,28 @@ func initsig(preinit bool) {
 
 		t.flags |= _SigHandling
 		setsig(i, funcPC(sighandler), true)
+		updatesigfwdonly(uint32(i))
 	}
 }
 
+// updatesigfwdonly sets the sigfwdonly entry for sig. It must be
+// called after anything that decides whether Go wants sig changes.
+//go:nosplit
+//go:nowritebarrierrec
+func updatesigfwdonly(sig uint32) {
+	t := &sigtable[sig]
+	fn := fwdSig[sig]
+	switch {
+	case t.flags&_SigHandling == 0,
+		t.flags&(_SigKill|_SigThrow|_SigPanic) != 0,
+		fn == _SIG_DFL, fn == _SIG_IGN,
+		sigwanted(sig),
+		sig == _SIGPROF && prof.hz != 0:
+		fn = 0
+	}
+	atomic.Storeuintptr(&sigfwdonly[sig], fn)
+}
+
 //go:nosplit
 //go:nowritebarrierrec
 func sigInstallGoHandler(sig int32) bool {
@@ -127,6 +155,7 @@ func sigenable(sig uint32) {
 			fwdSig[sig] = getsig(int32(sig))
 			setsig(int32(sig), funcPC(sighandler), true)
 		}
+		updatesigfwdonly(sig)
 	}
 }
 
@@ -148,6 +177,7 @@ func sigdisable(sig uint32) {
 			t.flags &^= _SigHandling
 			setsig(int32(sig), fwdSig[sig], true)
 		}
+		updatesigfwdonly(sig)
 	}
 }
 
@@ -159,22 +189,28 @@ func sigignore(sig uint32) {
 	t := &sigtable[sig]
 	if t.flags&_SigNotify != 0 {
 		t.flags &^= _SigHandling
+		atomic.Storeuintptr(&sigfwdonly[sig], 0)
 		setsig(int32(sig), _SIG_IGN, true)
 	}
 }
 
 func resetcpuprofiler(hz int32) {
-	var it itimerval
-	if hz == 0 {
-		setitimer(_ITIMER_PROF, &it, nil)
-	} else {
-		it.it_interval.tv_sec = 0
-		it.it_interval.set_usec(1000000 / hz)
-		it.it_value = it.it_interval
-		setitimer(_ITIMER_PROF, &it, nil)
-	}
 	_g_ := getg()
+	// An M with a CPU timer of its own needs the process's timer
+	// only for the threads of C code; see cputimer_linux.go.
+	if !setcputimer(_g_.m, hz) || iscgo {
+		var it itimerval
+		if hz == 0 {
+			setitimer(_ITIMER_PROF, &it, nil)
+		} else {
+			it.it_interval.tv_sec = 0
+			it.it_interval.set_usec(1000000 / hz)
+			it.it_value = it.it_interval
+			setitimer(_ITIMER_PROF, &it, nil)
+		}
+	}
 	_g_.m.profilehz = hz
+	updatesigfwdonly(_SIGPROF)
 }
 
 func sigpipe() {
@@ -338,7 +374,7 @@ func sigNotOnStack(sig uint32) {
 //go:norace
 //go:nowritebarrierrec
 func badsignal(sig uintptr, c *sigctxt) {
-	cgocallback(unsafe.Pointer(funcPC(badsignalgo)), noescape(unsafe.Pointer(&sig)), unsafe.Sizeof(sig)+unsafe.Sizeof(c))
+	cgocallback(unsafe.Pointer(funcPC(badsignalgo)), noescape(unsafe.Pointer(&sig)), (unsafe.Sizeof(sig)+unsafe.Sizeof(c))|cgoCallbackSignal)
 }
 
 func badsignalgo(sig uintptr, c *sigctxt) {
@@ -6,7 +6,10 @@
 
 package runtime
 
-import "unsafe"
+import (
+	"runtime/internal/atomic"
+	"unsafe"
+)
 
 //go:noescape
 func sigfwd(fn uintptr, sig uint32, info *siginfo, ctx unsafe.Pointer)
@@ -21,6 +24,11 @@ func sigfwdgo(sig uint32, info *siginfo, ctx unsafe.Pointer) bool {
 	if sig >= uint32(len(sigtable)) {
 		return false
 	}
+	// Go has no use for the signal; see sigfwdonly.
+	if fn := atomic.Loaduintptr(&sigfwdonly[sig]); fn != 0 {
+		sigfwd(fn, sig, info, ctx)
+		return true
+	}
 	fwdFn := fwdSig[sig]
 
 	if !signalsOK {
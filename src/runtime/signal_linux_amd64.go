@@ -9,6 +9,10 @@ import (
 	"unsafe"
 )
 
+// gosigtramp is sigtramp without the check for signals
+// that Go has no use for.
+func gosigtramp()
+
 type sigctxt struct {
 	info *siginfo
 	ctxt unsafe.Pointer
@@ -21,6 +21,9 @@ func sigtrampgo(sig uint32, info *siginfo, ctx unsafe.Pointer) {
 		badsignal(uintptr(sig), &sigctxt{info, ctx})
 		return
 	}
+	if sig == _SIGPROF && !validSIGPROF(g.m, &sigctxt{info, ctx}) {
+		return
+	}
 
 	// If some non-Go code called sigaltstack, adjust.
 	sp := uintptr(unsafe.Pointer(&sig))
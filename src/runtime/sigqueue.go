@@ -172,6 +172,12 @@ func signal_ignore(s uint32) {
 	sigignore(s)
 }
 
+// sigwanted reports whether os/signal wants signal s.
+//go:nosplit
+func sigwanted(s uint32) bool {
+	return sig.wanted[s/32]&(1<<(s&31)) != 0
+}
+
 // Checked by signal handlers.
 func signal_ignored(s uint32) bool {
 	return sig.ignored[s/32]&(1<<(s&31)) != 0
@@ -0,0 +1,66 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime
+
+import "unsafe"
+
+// Signal stacks.
+//
+// An M does not own a signal stack. minit gives it one for as long as
+// it runs on its thread: the thread's own, if the thread already has
+// one, as a C thread that called sigaltstack before calling into Go
+// does, or else one from sigstackfree. unminit, which dropm calls as a
+// callback returns to C, gives a stack from sigstackfree back. So the
+// extra Ms, of which there are as many as C threads that have been in
+// Go at once, hold no signal stacks while parked, and C threads that
+// come and go reuse the same few stacks rather than each taking one.
+//
+// The stacks come from sysAlloc and are never freed. minit may run
+// without a P, in needm, so it cannot allocate from the heap.
+
+const _SigStackSize = 32 * 1024 // Linux wants >= 2K
+
+// sigstackfree is the list of free signal stacks. Each free stack
+// holds the lo of the next in its first word.
+var sigstackfree struct {
+	lock mutex
+	head uintptr
+}
+
+// sigstackget returns a free signal stack, allocating one if there is
+// none.
+func sigstackget() stack {
+	lock(&sigstackfree.lock)
+	lo := sigstackfree.head
+	if lo != 0 {
+		sigstackfree.head = *(*uintptr)(unsafe.Pointer(lo))
+	}
+	unlock(&sigstackfree.lock)
+	if lo == 0 {
+		p := sysAlloc(_SigStackSize, &memstats.stacks_sys)
+		if p == nil {
+			throw("runtime: cannot allocate signal stack")
+		}
+		lo = uintptr(p)
+	}
+	return stack{lo, lo + _SigStackSize}
+}
+
+// sigstackput puts a stack from sigstackget back on the free list.
+func sigstackput(s stack) {
+	lock(&sigstackfree.lock)
+	*(*uintptr)(unsafe.Pointer(s.lo)) = sigstackfree.head
+	sigstackfree.head = s.lo
+	unlock(&sigstackfree.lock)
+}
+
+// setGsignalStack makes s the stack of mp's gsignal.
+//go:nosplit
+func setGsignalStack(mp *m, s stack) {
+	mp.gsignal.stack = s
+	mp.gsignal.stackguard0 = s.lo + _StackGuard
+	mp.gsignal.stackguard1 = s.lo + _StackGuard
+	mp.gsignal.stackAlloc = s.hi - s.lo
+}
@@ -1049,6 +1049,30 @@ func newstack() {
 	gogo(&gp.sched)
 }
 
+// growstackto grows the stack of the calling goroutine to newsize bytes,
+// a power of two, in a single copy, as newstack would after that many
+// doublings. It does nothing if the stack is already at least that big.
+// It is used to give a goroutine the stack it is known to need up front.
+func growstackto(newsize uintptr) {
+	gp := getg()
+	if newsize <= gp.stackAlloc || newsize > maxstacksize {
+		return
+	}
+	systemstack(func() {
+		growstackto_m(gp, newsize)
+	})
+}
+
+// growstackto_m does the copy for growstackto. gp's state was saved in
+// gp.sched by systemstack, so copystack can find and adjust all of its
+// frames. The closure that called us lives on the old stack, so it is
+// not safe to look at it once the copy is done.
+func growstackto_m(gp *g, newsize uintptr) {
+	casgstatus(gp, _Grunning, _Gcopystack)
+	copystack(gp, newsize, true)
+	casgstatus(gp, _Gcopystack, _Grunning)
+}
+
 //go:nosplit
 func nilfunc() {
 	*(*uint8)(nil) = 0
@@ -1119,6 +1143,11 @@ func shrinkstack(gp *g) {
 	if sys.GoosWindows != 0 && gp.m != nil && gp.m.libcallsp != 0 {
 		return
 	}
+	// Nor while a C call on the cgo thread pool has pointers
+	// into the stack of the goroutine waiting for it.
+	if gp.cgoasync {
+		return
+	}
 
 	if stackDebug > 0 {
 		print("shrinking stack ", oldsize, "->", newsize, "\n")
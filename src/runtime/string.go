@@ -357,6 +357,44 @@ func gostringn(p *byte, l int) string {
 	return s
 }
 
+// Sizes of the per-P cache of gostringintern: the number of entries,
+// and the length of the longest string cached.
+const (
+	internCacheSize = 128
+	internMaxLen    = 64
+)
+
+// gostringintern is gostringn for C.GoStringIntern. A short string
+// equal to one it returned recently on the same P is returned again
+// instead of allocated, so that converting C data that recurs, such
+// as names or keys, does not allocate each time.
+func gostringintern(p *byte, l int) string {
+	if l == 0 || l > internMaxLen {
+		return gostringn(p, l)
+	}
+	h := memhash(unsafe.Pointer(p), 0, uintptr(l)) % internCacheSize
+
+	// Stay on the P while using its cache.
+	mp := acquirem()
+	if c := mp.p.ptr().internCache; c != nil {
+		if s := c[h]; len(s) == l && memequal(stringStructOf(&s).str, unsafe.Pointer(p), uintptr(l)) {
+			releasem(mp)
+			return s
+		}
+	}
+	releasem(mp)
+
+	s := gostringn(p, l)
+	mp = acquirem()
+	pp := mp.p.ptr()
+	if pp.internCache == nil {
+		pp.internCache = new([internCacheSize]string)
+	}
+	pp.internCache[h] = s
+	releasem(mp)
+	return s
+}
+
 func index(s, t string) int {
 	if len(t) == 0 {
 		return 0
@@ -391,14 +429,43 @@ func findnull(s *byte) int {
 	if s == nil {
 		return 0
 	}
-	p := (*[_MaxMem/2 - 1]byte)(unsafe.Pointer(s))
+
+	// On Plan 9 findnull runs in note handlers, where the SSE
+	// instructions that indexbyte uses on x86 are not allowed.
+	if GOOS == "plan9" {
+		p := (*[_MaxMem/2 - 1]byte)(unsafe.Pointer(s))
+		l := 0
+		for p[l] != 0 {
+			l++
+		}
+		return l
+	}
+
+	// indexbyte reads whole words or vectors at a time, so it must
+	// not be given bytes past the end of the page holding the
+	// terminator. pageSize is the smallest page size of any system
+	// Go runs on; a larger actual page size just means more calls.
+	const pageSize = 4096
+	ptr := unsafe.Pointer(s)
 	l := 0
-	for p[l] != 0 {
-		l++
+	n := int(pageSize - uintptr(ptr)%pageSize)
+	for {
+		t := *(*string)(unsafe.Pointer(&stringStruct{ptr, n}))
+		if i := indexbyte(t, 0); i >= 0 {
+			return l + i
+		}
+		ptr = add(ptr, uintptr(n))
+		l += n
+		n = pageSize
 	}
-	return l
 }
 
+// indexbyte is strings.IndexByte, which is written in assembly
+// in this package for each architecture.
+//go:linkname indexbyte strings.IndexByte
+//go:noescape
+func indexbyte(s string, c byte) int
+
 func findnullw(s *uint16) int {
 	if s == nil {
 		return 0
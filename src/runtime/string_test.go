@@ -161,6 +161,42 @@ func TestGostringnocopy(t *testing.T) {
 	}
 }
 
+func TestFindnull(t *testing.T) {
+	// Put terminators at every offset around page boundaries,
+	// scanning from starts before and after them.
+	b := make([]byte, 3*4096)
+	for i := range b {
+		b[i] = 'a'
+	}
+	for _, start := range []int{0, 1, 15, 4080, 4095, 4096, 4097} {
+		for end := start; end < len(b) && end < start+4200; end++ {
+			b[end] = 0
+			if got, want := runtime.Findnull(&b[start]), end-start; got != want {
+				t.Fatalf("Findnull from %d with NUL at %d = %d, want %d", start, end, got, want)
+			}
+			b[end] = 'a'
+		}
+	}
+	if got := runtime.Findnull(nil); got != 0 {
+		t.Errorf("Findnull(nil) = %d, want 0", got)
+	}
+}
+
+func benchmarkFindnull(b *testing.B, n int) {
+	buf := make([]byte, n+1)
+	for i := 0; i < n; i++ {
+		buf[i] = 'a'
+	}
+	b.SetBytes(int64(n))
+	for i := 0; i < b.N; i++ {
+		runtime.Findnull(&buf[0])
+	}
+}
+
+func BenchmarkFindnull16(b *testing.B)   { benchmarkFindnull(b, 16) }
+func BenchmarkFindnull256(b *testing.B)  { benchmarkFindnull(b, 256) }
+func BenchmarkFindnull4096(b *testing.B) { benchmarkFindnull(b, 4096) }
+
 func TestCompareTempString(t *testing.T) {
 	s := strings.Repeat("x", sizeNoStack)
 	b := []byte(s)
@@ -0,0 +1,17 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9
+// +build !solaris
+// +build !windows
+// +build !nacl
+// +build !linux
+
+package runtime
+
+import "unsafe"
+
+func munmap(addr unsafe.Pointer, n uintptr)
+
+func madvise(addr unsafe.Pointer, n uintptr, flags int32)
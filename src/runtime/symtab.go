@@ -5,6 +5,7 @@
 package runtime
 
 import (
+	"runtime/internal/atomic"
 	"runtime/internal/sys"
 	"unsafe"
 )
@@ -108,12 +109,73 @@ func (ci *Frames) Next() (frame Frame, more bool) {
 // cgoNext returns frame information for pc, known to be a non-Go function,
 // using the cgoSymbolizer hook.
 func (ci *Frames) cgoNext(pc uintptr, more bool) (Frame, bool) {
+	frames, ok := cgoSymbolizerCacheLookup(pc)
+	if !ok {
+		frames = cgoSymbolize(pc)
+		cgoSymbolizerCacheAdd(pc, frames)
+	}
+	if len(frames) == 0 {
+		// No useful information from symbolizer.
+		return Frame{}, more
+	}
+
+	if len(frames) == 1 {
+		// Return a single frame.
+		return frames[0], more
+	}
+
+	// Return the first frame we saw and store the rest to be
+	// returned by later calls to Next. Next only reslices
+	// *ci.frames, so it may share the cached slice.
+	ci.frames = new([]Frame)
+	*ci.frames = frames[1:]
+	return frames[0], true
+}
+
+// cgoSymbolizerCache holds the frames the cgoSymbolizer returned for
+// each PC. Writing a profile with many samples in C code asks for the
+// same PCs over and over, and the symbolizer can be slow.
+// SetCgoTraceback empties it when the symbolizer changes.
+var cgoSymbolizerCache struct {
+	lock   mutex
+	frames map[uintptr][]Frame
+}
+
+// cgoSymbolizerCacheMax is the number of PCs after which the cache
+// is emptied, bounding its memory for programs with very many C PCs.
+const cgoSymbolizerCacheMax = 1 << 16
+
+func cgoSymbolizerCacheLookup(pc uintptr) ([]Frame, bool) {
+	lock(&cgoSymbolizerCache.lock)
+	frames, ok := cgoSymbolizerCache.frames[pc]
+	unlock(&cgoSymbolizerCache.lock)
+	return frames, ok
+}
+
+func cgoSymbolizerCacheAdd(pc uintptr, frames []Frame) {
+	lock(&cgoSymbolizerCache.lock)
+	if cgoSymbolizerCache.frames == nil || len(cgoSymbolizerCache.frames) >= cgoSymbolizerCacheMax {
+		cgoSymbolizerCache.frames = make(map[uintptr][]Frame)
+	}
+	cgoSymbolizerCache.frames[pc] = frames
+	unlock(&cgoSymbolizerCache.lock)
+}
+
+func cgoSymbolizerCacheFlush() {
+	lock(&cgoSymbolizerCache.lock)
+	cgoSymbolizerCache.frames = nil
+	unlock(&cgoSymbolizerCache.lock)
+}
+
+// cgoSymbolize calls the cgoSymbolizer hook for pc and returns the
+// frames it reports, or nil if it has no useful information.
+func cgoSymbolize(pc uintptr) []Frame {
 	arg := cgoSymbolizerArg{pc: pc}
 	callCgoSymbolizer(&arg)
 
 	if arg.file == nil && arg.funcName == nil {
 		// No useful information from symbolizer.
-		return Frame{}, more
+		return nil
 	}
 
 	var frames []Frame
@@ -138,19 +200,7 @@ func (ci *Frames) cgoNext(pc uintptr, more bool) (Frame, bool) {
 	// the symbolizer when we are done.
 	arg.pc = 0
 	callCgoSymbolizer(&arg)
-
-	if len(frames) == 1 {
-		// Return a single frame.
-		return frames[0], more
-	}
-
-	// Return the first frame we saw and store the rest to be
-	// returned by later calls to Next.
-	rf := frames[0]
-	frames = frames[1:]
-	ci.frames = new([]Frame)
-	*ci.frames = frames
-	return rf, true
+	return frames
 }
 
 // NOTE: Func does not expose the actual unexported fields, because we return *Func
@@ -198,6 +248,8 @@ type moduledata struct {
 	typelinks []int32 // offsets from types
 	itablinks []*itab
 
+	libinit uintptr // main.init of a library sharing the runtime; see libstart
+
 	modulename   string
 	modulehashes []modulehash
 
@@ -221,6 +273,10 @@ type modulehash struct {
 var firstmoduledata moduledata  // linker symbol
 var lastmoduledatap *moduledata // linker symbol
 
+// Modules loaded after a library started the runtime, in the order
+// they were loaded. Set by addmoduledata and taken by addmodules.
+var pendingmodulehead, pendingmoduletail *moduledata
+
 type functab struct {
 	entry   uintptr
 	funcoff uintptr
@@ -248,6 +304,46 @@ func moduledataverify() {
 	}
 }
 
+// addmodules makes the runtime use the modules loaded after
+// a library started it, and runs the init functions of the libraries
+// among them. The caller must hold the dynamic loader lock, as a
+// library constructor does, so that no module is added meanwhile.
+func addmodules() {
+	var added []*moduledata
+	for md := pendingmodulehead; md != nil; {
+		next := md.next
+		md.next = nil
+		md.gcdatamask = progToPointerMask((*byte)(unsafe.Pointer(md.gcdata)), md.edata-md.data)
+		md.gcbssmask = progToPointerMask((*byte)(unsafe.Pointer(md.gcbss)), md.ebss-md.bss)
+		// Code running elsewhere walks the module list without
+		// a lock, so the GC must be able to scan md before it is
+		// linked in. Nothing uses its code or types until it is
+		// initialized below.
+		atomic.StorepNoWB(unsafe.Pointer(&lastmoduledatap.next), unsafe.Pointer(md))
+		lastmoduledatap = md
+		typelinksadd(md)
+		moduledataverify1(md)
+		lock(&ifaceLock)
+		for _, i := range md.itablinks {
+			additab(i, true, false)
+		}
+		unlock(&ifaceLock)
+		added = append(added, md)
+		md = next
+	}
+	pendingmodulehead, pendingmoduletail = nil, nil
+	cgoDataIndexInit()
+
+	for _, md := range added {
+		if md.libinit == 0 {
+			continue
+		}
+		f := &funcval{md.libinit}
+		fn := *(*func())(unsafe.Pointer(&f))
+		fn()
+	}
+}
+
 const debugPcln = false
 
 func moduledataverify1(datap *moduledata) {
@@ -142,6 +142,32 @@ TEXT runtime·setitimer(SB),NOSPLIT,$0-12
 	INVOKE_SYSCALL
 	RET
 
+TEXT runtime·timer_create(SB),NOSPLIT,$0-16
+	MOVL	$259, AX			// syscall - timer_create
+	MOVL	clockid+0(FP), BX
+	MOVL	sevp+4(FP), CX
+	MOVL	timerid+8(FP), DX
+	INVOKE_SYSCALL
+	MOVL	AX, ret+12(FP)
+	RET
+
+TEXT runtime·timer_settime(SB),NOSPLIT,$0-20
+	MOVL	$260, AX			// syscall - timer_settime
+	MOVL	timerid+0(FP), BX
+	MOVL	flags+4(FP), CX
+	MOVL	new+8(FP), DX
+	MOVL	old+12(FP), SI
+	INVOKE_SYSCALL
+	MOVL	AX, ret+16(FP)
+	RET
+
+TEXT runtime·timer_delete(SB),NOSPLIT,$0-8
+	MOVL	$263, AX			// syscall - timer_delete
+	MOVL	timerid+0(FP), BX
+	INVOKE_SYSCALL
+	MOVL	AX, ret+4(FP)
+	RET
+
 TEXT runtime·mincore(SB),NOSPLIT,$0-16
 	MOVL	$218, AX			// syscall - mincore
 	MOVL	addr+0(FP), BX
@@ -260,7 +286,7 @@ TEXT runtime·mmap(SB),NOSPLIT,$0
 	MOVL	AX, ret+24(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT,$0
+TEXT runtime·sysMunmap(SB),NOSPLIT,$0
 	MOVL	$91, AX	// munmap
 	MOVL	addr+0(FP), BX
 	MOVL	n+4(FP), CX
@@ -270,7 +296,7 @@ TEXT runtime·munmap(SB),NOSPLIT,$0
 	INT $3
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT,$0
+TEXT runtime·sysMadvise(SB),NOSPLIT,$0
 	MOVL	$219, AX	// madvise
 	MOVL	addr+0(FP), BX
 	MOVL	n+4(FP), CX
@@ -500,6 +526,27 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT,$0
 	MOVL	AX, ret+12(FP)
 	RET
 
+TEXT runtime·getcpu(SB),NOSPLIT,$0
+	MOVL	$318, AX		// syscall - getcpu
+	MOVL	cpu+0(FP), BX
+	MOVL	node+4(FP), CX
+	MOVL	cache+8(FP), DX
+	INVOKE_SYSCALL
+	MOVL	AX, ret+12(FP)
+	RET
+
+TEXT runtime·mbind(SB),NOSPLIT,$0
+	MOVL	$274, AX		// syscall - mbind
+	MOVL	addr+0(FP), BX
+	MOVL	n+4(FP), CX
+	MOVL	mode+8(FP), DX
+	MOVL	nodemask+12(FP), SI
+	MOVL	maxnode+16(FP), DI
+	MOVL	flags+20(FP), BP
+	INVOKE_SYSCALL
+	MOVL	AX, ret+24(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT,$0
 	MOVL    $254, AX
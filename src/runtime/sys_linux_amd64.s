@@ -126,6 +126,32 @@ TEXT runtime·setitimer(SB),NOSPLIT,$0-24
 	SYSCALL
 	RET
 
+TEXT runtime·timer_create(SB),NOSPLIT,$0-28
+	MOVL	clockid+0(FP), DI
+	MOVQ	sevp+8(FP), SI
+	MOVQ	timerid+16(FP), DX
+	MOVL	$222, AX			// syscall entry
+	SYSCALL
+	MOVL	AX, ret+24(FP)
+	RET
+
+TEXT runtime·timer_settime(SB),NOSPLIT,$0-28
+	MOVL	timerid+0(FP), DI
+	MOVL	flags+4(FP), SI
+	MOVQ	new+8(FP), DX
+	MOVQ	old+16(FP), R10
+	MOVL	$223, AX			// syscall entry
+	SYSCALL
+	MOVL	AX, ret+24(FP)
+	RET
+
+TEXT runtime·timer_delete(SB),NOSPLIT,$0-12
+	MOVL	timerid+0(FP), DI
+	MOVL	$226, AX			// syscall entry
+	SYSCALL
+	MOVL	AX, ret+8(FP)
+	RET
+
 TEXT runtime·mincore(SB),NOSPLIT,$0-28
 	MOVQ	addr+0(FP), DI
 	MOVQ	n+8(FP), SI
@@ -226,7 +252,23 @@ TEXT runtime·sigfwd(SB),NOSPLIT,$0-32
 	CALL	AX
 	RET
 
-TEXT runtime·sigtramp(SB),NOSPLIT,$24
+// Signals that Go has no use for go straight to the handler
+// installed before Go's, without entering Go; see sigfwdonly.
+// The arguments from the kernel are in DI, SI, DX, as the
+// handler expects them.
+TEXT runtime·sigtramp(SB),NOSPLIT,$0
+	MOVL	DI, CX
+	CMPQ	CX, $const__NSIG
+	JAE	gosigtramp
+	LEAQ	runtime·sigfwdonly(SB), AX
+	MOVQ	(AX)(CX*8), AX
+	TESTQ	AX, AX
+	JZ	gosigtramp
+	JMP	AX
+gosigtramp:
+	JMP	runtime·gosigtramp(SB)
+
+TEXT runtime·gosigtramp(SB),NOSPLIT,$24
 	MOVQ	DI, 0(SP)   // signum
 	MOVQ	SI, 8(SP)   // info
 	MOVQ	DX, 16(SP)  // ctx
@@ -237,6 +279,17 @@ TEXT runtime·sigtramp(SB),NOSPLIT,$24
 // Used instead of sigtramp in programs that use cgo.
 // Arguments from kernel are in DI, SI, DX.
 TEXT runtime·cgoSigtramp(SB),NOSPLIT,$0
+	// If Go has no use for the signal, forward it as sigtramp does.
+	MOVL	DI, CX
+	CMPQ	CX, $const__NSIG
+	JAE	checktraceback
+	LEAQ	runtime·sigfwdonly(SB), AX
+	MOVQ	(AX)(CX*8), AX
+	TESTQ	AX, AX
+	JZ	checktraceback
+	JMP	AX
+
+checktraceback:
 	// If no traceback function, do usual sigtramp.
 	MOVQ	runtime·cgoTraceback(SB), AX
 	TESTQ	AX, AX
@@ -279,12 +332,12 @@ TEXT runtime·cgoSigtramp(SB),NOSPLIT,$0
 	// The first three arguments are already in registers.
 	// Set the last three arguments now.
 	MOVQ	runtime·cgoTraceback(SB), CX
-	MOVQ	$runtime·sigtramp(SB), R9
+	MOVQ	$runtime·gosigtramp(SB), R9
 	MOVQ	_cgo_callers(SB), AX
 	JMP	AX
 
 sigtramp:
-	JMP	runtime·sigtramp(SB)
+	JMP	runtime·gosigtramp(SB)
 
 // For cgo unwinding to work, this function must look precisely like
 // the one in glibc.  The glibc source code is:
@@ -302,7 +355,7 @@ TEXT runtime·sysMmap(SB),NOSPLIT,$0
 	MOVL	prot+16(FP), DX
 	MOVL	flags+20(FP), R10
 	MOVL	fd+24(FP), R8
-	MOVL	off+28(FP), R9
+	MOVQ	off+32(FP), R9
 
 	MOVL	$9, AX			// mmap
 	SYSCALL
@@ -310,7 +363,7 @@ TEXT runtime·sysMmap(SB),NOSPLIT,$0
 	JLS	3(PC)
 	NOTQ	AX
 	INCQ	AX
-	MOVQ	AX, ret+32(FP)
+	MOVQ	AX, ret+40(FP)
 	RET
 
 // Call the function stored in _cgo_mmap using the GCC calling convention.
@@ -321,17 +374,17 @@ TEXT runtime·callCgoMmap(SB),NOSPLIT,$16
 	MOVL	prot+16(FP), DX
 	MOVL	flags+20(FP), CX
 	MOVL	fd+24(FP), R8
-	MOVL	off+28(FP), R9
+	MOVQ	off+32(FP), R9
 	MOVQ	_cgo_mmap(SB), AX
 	MOVQ	SP, BX
 	ANDQ	$~15, SP	// alignment as per amd64 psABI
 	MOVQ	BX, 0(SP)
 	CALL	AX
 	MOVQ	0(SP), SP
-	MOVQ	AX, ret+32(FP)
+	MOVQ	AX, ret+40(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT,$0
+TEXT runtime·sysMunmap(SB),NOSPLIT,$0
 	MOVQ	addr+0(FP), DI
 	MOVQ	n+8(FP), SI
 	MOVQ	$11, AX	// munmap
@@ -341,7 +394,7 @@ TEXT runtime·munmap(SB),NOSPLIT,$0
 	MOVL	$0xf1, 0xf1  // crash
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT,$0
+TEXT runtime·sysMadvise(SB),NOSPLIT,$0
 	MOVQ	addr+0(FP), DI
 	MOVQ	n+8(FP), SI
 	MOVL	flags+16(FP), DX
@@ -463,6 +516,29 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT,$0
 	MOVL	AX, ret+24(FP)
 	RET
 
+// int32 runtime·getcpu(uint32 *cpu, uint32 *node, void *cache);
+TEXT runtime·getcpu(SB),NOSPLIT,$0
+	MOVQ	cpu+0(FP), DI
+	MOVQ	node+8(FP), SI
+	MOVQ	cache+16(FP), DX
+	MOVL	$309, AX			// syscall entry
+	SYSCALL
+	MOVL	AX, ret+24(FP)
+	RET
+
+// int32 runtime·mbind(void *addr, uintptr n, uintptr mode, uint64 *nodemask, uintptr maxnode, uintptr flags);
+TEXT runtime·mbind(SB),NOSPLIT,$0
+	MOVQ	addr+0(FP), DI
+	MOVQ	n+8(FP), SI
+	MOVQ	mode+16(FP), DX
+	MOVQ	nodemask+24(FP), R10
+	MOVQ	maxnode+32(FP), R8
+	MOVQ	flags+40(FP), R9
+	MOVL	$237, AX			// syscall entry
+	SYSCALL
+	MOVL	AX, ret+48(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT,$0
 	MOVL    size+0(FP), DI
@@ -23,6 +23,9 @@
 #define SYS_mmap		222
 #define SYS_munmap		215
 #define SYS_setitimer		103
+#define SYS_timer_create	107
+#define SYS_timer_settime	110
+#define SYS_timer_delete	111
 #define SYS_clone		220
 #define SYS_sched_yield		124
 #define SYS_rt_sigreturn	139
@@ -38,6 +41,8 @@
 #define SYS_tkill		130
 #define SYS_futex		98
 #define SYS_sched_getaffinity	123
+#define SYS_getcpu		168
+#define SYS_mbind		235
 #define SYS_exit_group		94
 #define SYS_epoll_create1	20
 #define SYS_epoll_ctl		21
@@ -173,6 +178,32 @@ TEXT runtime·setitimer(SB),NOSPLIT,$-8-24
 	SVC
 	RET
 
+TEXT runtime·timer_create(SB),NOSPLIT,$-8-28
+	MOVW	clockid+0(FP), R0
+	MOVD	sevp+8(FP), R1
+	MOVD	timerid+16(FP), R2
+	MOVD	$SYS_timer_create, R8
+	SVC
+	MOVW	R0, ret+24(FP)
+	RET
+
+TEXT runtime·timer_settime(SB),NOSPLIT,$-8-28
+	MOVW	timerid+0(FP), R0
+	MOVW	flags+4(FP), R1
+	MOVD	new+8(FP), R2
+	MOVD	old+16(FP), R3
+	MOVD	$SYS_timer_settime, R8
+	SVC
+	MOVW	R0, ret+24(FP)
+	RET
+
+TEXT runtime·timer_delete(SB),NOSPLIT,$-8-12
+	MOVW	timerid+0(FP), R0
+	MOVD	$SYS_timer_delete, R8
+	SVC
+	MOVW	R0, ret+8(FP)
+	RET
+
 TEXT runtime·mincore(SB),NOSPLIT,$-8-28
 	MOVD	addr+0(FP), R0
 	MOVD	n+8(FP), R1
@@ -279,7 +310,7 @@ TEXT runtime·mmap(SB),NOSPLIT,$-8
 	MOVD	R0, ret+32(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT,$-8
+TEXT runtime·sysMunmap(SB),NOSPLIT,$-8
 	MOVD	addr+0(FP), R0
 	MOVD	n+8(FP), R1
 	MOVD	$SYS_munmap, R8
@@ -290,7 +321,7 @@ TEXT runtime·munmap(SB),NOSPLIT,$-8
 cool:
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT,$-8
+TEXT runtime·sysMadvise(SB),NOSPLIT,$-8
 	MOVD	addr+0(FP), R0
 	MOVD	n+8(FP), R1
 	MOVW	flags+16(FP), R2
@@ -408,6 +439,27 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT,$-8
 	MOVW	R0, ret+24(FP)
 	RET
 
+TEXT runtime·getcpu(SB),NOSPLIT,$-8
+	MOVD	cpu+0(FP), R0
+	MOVD	node+8(FP), R1
+	MOVD	cache+16(FP), R2
+	MOVD	$SYS_getcpu, R8
+	SVC
+	MOVW	R0, ret+24(FP)
+	RET
+
+TEXT runtime·mbind(SB),NOSPLIT,$-8
+	MOVD	addr+0(FP), R0
+	MOVD	n+8(FP), R1
+	MOVD	mode+16(FP), R2
+	MOVD	nodemask+24(FP), R3
+	MOVD	maxnode+32(FP), R4
+	MOVD	flags+40(FP), R5
+	MOVD	$SYS_mbind, R8
+	SVC
+	MOVW	R0, ret+48(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT,$-8
 	MOVW	$0, R0
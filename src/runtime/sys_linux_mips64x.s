@@ -39,6 +39,8 @@
 #define SYS_tkill		5192
 #define SYS_futex		5194
 #define SYS_sched_getaffinity	5196
+#define SYS_mbind		5227
+#define SYS_getcpu		5271
 #define SYS_exit_group		5205
 #define SYS_epoll_create	5207
 #define SYS_epoll_ctl		5208
@@ -270,7 +272,7 @@ TEXT runtime·mmap(SB),NOSPLIT,$-8
 	MOVV	R2, ret+32(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT,$-8
+TEXT runtime·sysMunmap(SB),NOSPLIT,$-8
 	MOVV	addr+0(FP), R4
 	MOVV	n+8(FP), R5
 	MOVV	$SYS_munmap, R2
@@ -279,7 +281,7 @@ TEXT runtime·munmap(SB),NOSPLIT,$-8
 	MOVV	R0, 0xf3(R0)	// crash
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT,$-8
+TEXT runtime·sysMadvise(SB),NOSPLIT,$-8
 	MOVV	addr+0(FP), R4
 	MOVV	n+8(FP), R5
 	MOVW	flags+16(FP), R6
@@ -388,6 +390,27 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT,$-8
 	MOVW	R2, ret+24(FP)
 	RET
 
+TEXT runtime·getcpu(SB),NOSPLIT,$-8
+	MOVV	cpu+0(FP), R4
+	MOVV	node+8(FP), R5
+	MOVV	cache+16(FP), R6
+	MOVV	$SYS_getcpu, R2
+	SYSCALL
+	MOVW	R2, ret+24(FP)
+	RET
+
+TEXT runtime·mbind(SB),NOSPLIT,$-8
+	MOVV	addr+0(FP), R4
+	MOVV	n+8(FP), R5
+	MOVV	mode+16(FP), R6
+	MOVV	nodemask+24(FP), R7
+	MOVV	maxnode+32(FP), R8
+	MOVV	flags+40(FP), R9
+	MOVV	$SYS_mbind, R2
+	SYSCALL
+	MOVW	R2, ret+48(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT,$-8
 	MOVW    size+0(FP), R4
@@ -41,6 +41,8 @@
 #define SYS_tkill		208
 #define SYS_futex		221
 #define SYS_sched_getaffinity	223
+#define SYS_mbind		259
+#define SYS_getcpu		302
 #define SYS_exit_group		234
 #define SYS_epoll_create	236
 #define SYS_epoll_ctl		237
@@ -270,7 +272,7 @@ TEXT runtime·mmap(SB),NOSPLIT|NOFRAME,$0
 	MOVD	R3, ret+32(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT|NOFRAME,$0
+TEXT runtime·sysMunmap(SB),NOSPLIT|NOFRAME,$0
 	MOVD	addr+0(FP), R3
 	MOVD	n+8(FP), R4
 	SYSCALL	$SYS_munmap
@@ -278,7 +280,7 @@ TEXT runtime·munmap(SB),NOSPLIT|NOFRAME,$0
 	MOVD	R0, 0xf3(R0)
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT|NOFRAME,$0
+TEXT runtime·sysMadvise(SB),NOSPLIT|NOFRAME,$0
 	MOVD	addr+0(FP), R3
 	MOVD	n+8(FP), R4
 	MOVW	flags+16(FP), R5
@@ -383,6 +385,25 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT|NOFRAME,$0
 	MOVW	R3, ret+24(FP)
 	RET
 
+TEXT runtime·getcpu(SB),NOSPLIT|NOFRAME,$0
+	MOVD	cpu+0(FP), R3
+	MOVD	node+8(FP), R4
+	MOVD	cache+16(FP), R5
+	SYSCALL	$SYS_getcpu
+	MOVW	R3, ret+24(FP)
+	RET
+
+TEXT runtime·mbind(SB),NOSPLIT|NOFRAME,$0
+	MOVD	addr+0(FP), R3
+	MOVD	n+8(FP), R4
+	MOVD	mode+16(FP), R5
+	MOVD	nodemask+24(FP), R6
+	MOVD	maxnode+32(FP), R7
+	MOVD	flags+40(FP), R8
+	SYSCALL	$SYS_mbind
+	MOVW	R3, ret+48(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT|NOFRAME,$0
 	MOVW    size+0(FP), R3
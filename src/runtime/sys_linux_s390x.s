@@ -35,6 +35,8 @@
 #define SYS_tkill               237
 #define SYS_futex               238
 #define SYS_sched_getaffinity   240
+#define SYS_mbind               268
+#define SYS_getcpu              311
 #define SYS_exit_group          248
 #define SYS_epoll_create        249
 #define SYS_epoll_ctl           250
@@ -275,7 +277,7 @@ TEXT runtime·mmap(SB),NOSPLIT,$48-40
 	MOVD	R2, ret+32(FP)
 	RET
 
-TEXT runtime·munmap(SB),NOSPLIT|NOFRAME,$0
+TEXT runtime·sysMunmap(SB),NOSPLIT|NOFRAME,$0
 	MOVD	addr+0(FP), R2
 	MOVD	n+8(FP), R3
 	MOVW	$SYS_munmap, R1
@@ -285,7 +287,7 @@ TEXT runtime·munmap(SB),NOSPLIT|NOFRAME,$0
 	MOVD	R0, 0(R0) // crash
 	RET
 
-TEXT runtime·madvise(SB),NOSPLIT|NOFRAME,$0
+TEXT runtime·sysMadvise(SB),NOSPLIT|NOFRAME,$0
 	MOVD	addr+0(FP), R2
 	MOVD	n+8(FP), R3
 	MOVW	flags+16(FP), R4
@@ -392,6 +394,27 @@ TEXT runtime·sched_getaffinity(SB),NOSPLIT|NOFRAME,$0
 	MOVW	R2, ret+24(FP)
 	RET
 
+TEXT runtime·getcpu(SB),NOSPLIT|NOFRAME,$0
+	MOVD	cpu+0(FP), R2
+	MOVD	node+8(FP), R3
+	MOVD	cache+16(FP), R4
+	MOVW	$SYS_getcpu, R1
+	SYSCALL
+	MOVW	R2, ret+24(FP)
+	RET
+
+TEXT runtime·mbind(SB),NOSPLIT|NOFRAME,$0
+	MOVD	addr+0(FP), R2
+	MOVD	n+8(FP), R3
+	MOVD	mode+16(FP), R4
+	MOVD	nodemask+24(FP), R5
+	MOVD	maxnode+32(FP), R6
+	MOVD	flags+40(FP), R7
+	MOVW	$SYS_mbind, R1
+	SYSCALL
+	MOVW	R2, ret+48(FP)
+	RET
+
 // int32 runtime·epollcreate(int32 size);
 TEXT runtime·epollcreate(SB),NOSPLIT|NOFRAME,$0
 	MOVW    size+0(FP), R2
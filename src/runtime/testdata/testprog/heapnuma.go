@@ -0,0 +1,45 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+)
+
+func init() {
+	register("HeapNUMA", HeapNUMA)
+}
+
+var numaSink [][]byte
+
+// Run on Linux with GODEBUG unset or set to heapnuma=1.
+// Grow the heap and check that the NUMA statistics account for it.
+func HeapNUMA() {
+	for i := 0; i < 64; i++ {
+		numaSink = append(numaSink, make([]byte, 1<<20))
+	}
+	var st runtime.HeapNUMAStats
+	runtime.ReadHeapNUMAStats(&st)
+	total := st.Failed
+	for _, n := range st.Bound {
+		total += n
+	}
+	switch os.Getenv("GODEBUG") {
+	case "":
+		if total != 0 {
+			fmt.Printf("NUMA placement without GODEBUG: %+v\n", st)
+			os.Exit(1)
+		}
+	case "heapnuma=1":
+		// Systems without NUMA support count the heap as Failed.
+		if total < 64<<20 {
+			fmt.Printf("heapnuma=1: only %d bytes accounted for\n", total)
+			os.Exit(1)
+		}
+	}
+	fmt.Println("OK")
+}
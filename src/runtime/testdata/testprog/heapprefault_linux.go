@@ -0,0 +1,38 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import (
+	"fmt"
+	"os"
+	"syscall"
+)
+
+func init() {
+	register("HeapPrefault", HeapPrefault)
+}
+
+var prefaultSink []byte
+
+// Run on Linux with GODEBUG=heapprefault=1.
+// Grow the heap and check that touching the new memory
+// takes almost no page faults.
+func HeapPrefault() {
+	const n = 64 << 20
+	prefaultSink = make([]byte, n)
+	var before, after syscall.Rusage
+	syscall.Getrusage(syscall.RUSAGE_SELF, &before)
+	for i := 0; i < n; i += 4096 {
+		prefaultSink[i] = 1
+	}
+	syscall.Getrusage(syscall.RUSAGE_SELF, &after)
+	// Without prefaulting, this takes one fault for each of the
+	// 16384 pages. Allow for heap mapped before GODEBUG was read.
+	if faults := after.Minflt - before.Minflt; faults > 1024 {
+		fmt.Printf("%d page faults touching prefaulted heap\n", faults)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,55 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+	"runtime/debug"
+)
+
+func init() {
+	register("HeapHugePages", HeapHugePages)
+}
+
+var hugeSink [][]byte
+
+// Run on Linux with GODEBUG unset, or set to heaphugepages=1 or 2.
+// Grow the heap and check that the huge page statistics account for it.
+func HeapHugePages() {
+	for i := 0; i < 64; i++ {
+		hugeSink = append(hugeSink, make([]byte, 1<<20))
+	}
+	var st runtime.HeapHugePageStats
+	runtime.ReadHeapHugePageStats(&st)
+	switch os.Getenv("GODEBUG") {
+	case "":
+		if st != (runtime.HeapHugePageStats{}) {
+			fmt.Printf("huge pages without GODEBUG: %+v\n", st)
+			os.Exit(1)
+		}
+	case "heaphugepages=1":
+		if st.HugeTLB != 0 || st.Fallbacks != 0 || st.Advised < 64<<20 {
+			fmt.Printf("heaphugepages=1: %+v\n", st)
+			os.Exit(1)
+		}
+	case "heaphugepages=2":
+		// Without huge pages set aside, every mapping after the
+		// first failure uses transparent huge pages.
+		if st.HugeTLB+st.Advised < 64<<20 || st.Fallbacks > 1 || st.Advised != 0 && st.Fallbacks == 0 {
+			fmt.Printf("heaphugepages=2: %+v\n", st)
+			os.Exit(1)
+		}
+	}
+
+	// Return the heap to the system, which must leave
+	// explicit huge pages in place.
+	hugeSink = nil
+	debug.FreeOSMemory()
+	hugeSink = append(hugeSink, make([]byte, 1<<20))
+	hugeSink[0][0] = 1
+	fmt.Println("OK")
+}
@@ -0,0 +1,82 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// C threads call a Go function that needs a large stack, more of them
+// at once in each round, so that later rounds run on new extra Ms whose
+// stacks are grown up front from the size recorded by earlier calls.
+// Check that pointers into the goroutine stack survive that.
+
+package main
+
+/*
+#include <pthread.h>
+
+extern void GoCallbackStack(int);
+
+static void* callbackStackThread(void* arg) {
+	GoCallbackStack((int)(long)arg);
+	return NULL;
+}
+
+static void CallbackStackThreads(int n) {
+	pthread_t tid[32];
+	long i;
+
+	for (i = 0; i < n; i++) {
+		pthread_create(&tid[i], NULL, callbackStackThread, (void*)i);
+	}
+	for (i = 0; i < n; i++) {
+		pthread_join(tid[i], NULL);
+	}
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"sync"
+)
+
+func init() {
+	register("CgoCallbackStack", CgoCallbackStack)
+}
+
+var callbackStackWait sync.WaitGroup
+
+//export GoCallbackStack
+func GoCallbackStack(id C.int) {
+	x := int(id)
+	p := &x
+	if got := callbackStackDeep(p, 64); got != int(id)*64 {
+		fmt.Printf("thread %d: got %d, want %d\n", id, got, id*64)
+		os.Exit(1)
+	}
+	// Hold on to the M until every thread in the round has one.
+	callbackStackWait.Done()
+	callbackStackWait.Wait()
+	if *p != int(id) {
+		fmt.Printf("thread %d: *p == %d\n", id, *p)
+		os.Exit(1)
+	}
+}
+
+func callbackStackDeep(p *int, depth int) int {
+	var buf [1024]byte
+	buf[depth] = byte(depth)
+	if depth == 0 {
+		return int(buf[0])
+	}
+	return *p + callbackStackDeep(p, depth-1) + int(buf[depth]) - depth
+}
+
+func CgoCallbackStack() {
+	for n := 2; n <= 32; n *= 2 {
+		callbackStackWait.Add(n)
+		C.CallbackStackThreads(C.int(n))
+	}
+	fmt.Println("OK")
+}
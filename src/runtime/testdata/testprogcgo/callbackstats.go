@@ -0,0 +1,74 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Run with GODEBUG=cgocallbackstats=1: make calls into Go from C
+// threads and from Go-created threads, and print how many phases
+// of each kind were timed.
+
+package main
+
+/*
+#include <pthread.h>
+
+extern void GoCallbackStats(void);
+
+static void* statsThread(void* arg) {
+	int i;
+
+	for (i = 0; i < 25; i++) {
+		GoCallbackStats();
+	}
+	return NULL;
+}
+
+static void statsThreads(void) {
+	pthread_t t[4];
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		pthread_create(&t[i], NULL, statsThread, NULL);
+	}
+	for (i = 0; i < 4; i++) {
+		pthread_join(t[i], NULL);
+	}
+}
+
+static void statsCall(void) {
+	GoCallbackStats();
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+)
+
+func init() {
+	register("CgoCallbackStats", CgoCallbackStats)
+}
+
+//export GoCallbackStats
+func GoCallbackStats() {
+}
+
+func CgoCallbackStats() {
+	C.statsThreads()
+	for i := 0; i < 50; i++ {
+		C.statsCall()
+	}
+
+	var stats runtime.CgoCallbackStats
+	runtime.ReadCgoCallbackStats(&stats)
+	sum := func(h [runtime.CgoCallbackBuckets]uint64) uint64 {
+		var n uint64
+		for _, c := range h {
+			n += c
+		}
+		return n
+	}
+	fmt.Printf("needm=%d acquirep=%d func=%d unwind=%d\n", sum(stats.NeedM), sum(stats.AcquireP), sum(stats.Func), sum(stats.Unwind))
+}
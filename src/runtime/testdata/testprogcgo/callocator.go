@@ -0,0 +1,62 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// This program registers its own C allocator and checks that
+// C.CString and C.malloc use it.
+
+/*
+#include <stdlib.h>
+
+extern int GoSetCAllocator(void *(*)(size_t), void (*)(void*));
+
+static volatile int mallocCalls;
+
+static void *countingMalloc(size_t n) {
+	__sync_fetch_and_add(&mallocCalls, 1);
+	return malloc(n);
+}
+
+static int setAllocator(void) {
+	return GoSetCAllocator(countingMalloc, free);
+}
+
+static int getMallocCalls(void) {
+	return mallocCalls;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"unsafe"
+)
+
+func init() {
+	register("CgoAllocator", CgoAllocator)
+}
+
+func CgoAllocator() {
+	if C.setAllocator() != 1 {
+		fmt.Println("GoSetCAllocator failed")
+		os.Exit(1)
+	}
+	if C.setAllocator() != 0 {
+		fmt.Println("second GoSetCAllocator succeeded")
+		os.Exit(1)
+	}
+	s := C.CString("hello")
+	C.free(unsafe.Pointer(s))
+	p := C.malloc(16)
+	C.free(p)
+	if n := C.getMallocCalls(); n != 2 {
+		fmt.Printf("registered malloc called %d times, want 2\n", n)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,75 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Run with GODEBUG=cgoasyncthreads=4: many goroutines make blocking
+// #cgo async: calls at once. Check that at most 4 of the calls run at
+// a time and that the runtime does not start an M for each call.
+
+package main
+
+/*
+#cgo async: asyncBlock
+
+#include <unistd.h>
+
+static int asyncRunning;
+static int asyncMaxRunning;
+
+static int asyncBlock(int id) {
+	int n, max;
+
+	n = __sync_add_and_fetch(&asyncRunning, 1);
+	do {
+		max = asyncMaxRunning;
+	} while (n > max && !__sync_bool_compare_and_swap(&asyncMaxRunning, max, n));
+	usleep(5000);
+	__sync_sub_and_fetch(&asyncRunning, 1);
+	return id;
+}
+
+static int asyncMax(void) {
+	return __sync_fetch_and_add(&asyncMaxRunning, 0);
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime/pprof"
+	"sync"
+)
+
+func init() {
+	register("CgoAsync", CgoAsync)
+}
+
+func CgoAsync() {
+	const calls = 100
+	before := pprof.Lookup("threadcreate").Count()
+	var wg sync.WaitGroup
+	for i := 0; i < calls; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			if got := C.asyncBlock(C.int(i)); got != C.int(i) {
+				fmt.Printf("asyncBlock(%d) = %d\n", i, got)
+				os.Exit(1)
+			}
+		}(i)
+	}
+	wg.Wait()
+	if max := C.asyncMax(); max > 4 {
+		fmt.Printf("%d calls ran at once, want at most 4\n", max)
+		os.Exit(1)
+	}
+	// Blocking in ordinary cgo calls would need an M for each call.
+	if n := pprof.Lookup("threadcreate").Count() - before; n >= calls/4 {
+		fmt.Printf("%d Ms started for %d calls\n", n, calls)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
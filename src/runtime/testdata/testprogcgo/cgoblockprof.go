@@ -0,0 +1,79 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !windows
+
+package main
+
+// Make C calls that block in the kernel, and check that the cgo
+// blocking profile reports the time spent in them.
+
+/*
+#include <unistd.h>
+
+static void cgoBlockSleep(void) {
+	usleep(20000);
+}
+*/
+import "C"
+
+import (
+	"bytes"
+	"fmt"
+	"os"
+	"runtime"
+	"runtime/pprof"
+	"strings"
+	"time"
+)
+
+func init() {
+	register("CgoBlockProfile", CgoBlockProfile)
+}
+
+func cgoBlockSleeper() {
+	for i := 0; i < 5; i++ {
+		C.cgoBlockSleep()
+	}
+}
+
+func CgoBlockProfile() {
+	runtime.SetCgoBlockProfileRate(1)
+	start := time.Now()
+	cgoBlockSleeper()
+	elapsed := time.Since(start)
+	runtime.SetCgoBlockProfileRate(0)
+
+	var count, cycles int64
+	p := make([]runtime.BlockProfileRecord, 100)
+	n, ok := runtime.CgoBlockProfile(p)
+	if !ok {
+		fmt.Printf("CgoBlockProfile: %d records\n", n)
+		os.Exit(1)
+	}
+	for _, r := range p[:n] {
+		for _, pc := range r.Stack() {
+			if f := runtime.FuncForPC(pc - 1); f != nil && f.Name() == "main.cgoBlockSleeper" {
+				count += r.Count
+				cycles += r.Cycles
+			}
+		}
+	}
+	if count != 5 {
+		fmt.Printf("cgoBlockSleeper: %d calls, want 5\n", count)
+		os.Exit(1)
+	}
+	if cycles <= 0 {
+		fmt.Printf("cgoBlockSleeper: %d cycles, want > 0 for %v\n", cycles, elapsed)
+		os.Exit(1)
+	}
+
+	var buf bytes.Buffer
+	pprof.Lookup("cgoblock").WriteTo(&buf, 1)
+	if !strings.Contains(buf.String(), "main._Cfunc_cgoBlockSleep") {
+		fmt.Printf("cgoblock profile missing _Cfunc_cgoBlockSleep:\n%s", buf.String())
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,75 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Make calls to two C functions with the cgo call profile enabled,
+// and check that each call site is reported with its count.
+
+/*
+static int cgoProfHot(int x) { return x + 1; }
+static void cgoProfCold(void) {}
+*/
+import "C"
+
+import (
+	"bytes"
+	"fmt"
+	"os"
+	"runtime"
+	"runtime/pprof"
+	"strings"
+)
+
+func init() {
+	register("CgoCallProfile", CgoCallProfile)
+}
+
+func CgoCallProfile() {
+	runtime.SetCgoCallProfileRate(1)
+	for i := 0; i < 1000; i++ {
+		C.cgoProfHot(C.int(i))
+	}
+	for i := 0; i < 10; i++ {
+		C.cgoProfCold()
+	}
+	runtime.SetCgoCallProfileRate(0)
+	C.cgoProfCold()
+
+	counts := make(map[string]int64)
+	p := make([]runtime.CgoCallProfileRecord, 100)
+	n, ok := runtime.CgoCallProfile(p)
+	if !ok {
+		fmt.Printf("CgoCallProfile: %d records\n", n)
+		os.Exit(1)
+	}
+	for _, r := range p[:n] {
+		f := runtime.FuncForPC(r.Stack0[0] - 1)
+		if f == nil {
+			fmt.Printf("no function for %#x\n", r.Stack0[0])
+			os.Exit(1)
+		}
+		if r.Nanoseconds <= 0 {
+			fmt.Printf("%s: %d ns\n", f.Name(), r.Nanoseconds)
+			os.Exit(1)
+		}
+		counts[f.Name()] += r.Count
+	}
+	if c := counts["main._Cfunc_cgoProfHot"]; c != 1000 {
+		fmt.Printf("cgoProfHot: %d calls, want 1000\n", c)
+		os.Exit(1)
+	}
+	if c := counts["main._Cfunc_cgoProfCold"]; c != 10 {
+		fmt.Printf("cgoProfCold: %d calls, want 10\n", c)
+		os.Exit(1)
+	}
+
+	var buf bytes.Buffer
+	pprof.Lookup("cgocall").WriteTo(&buf, 1)
+	if !strings.Contains(buf.String(), "main._Cfunc_cgoProfHot") {
+		fmt.Printf("cgocall profile missing cgoProfHot:\n%s", buf.String())
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,33 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Crash after some cgo calls and a callback, for GODEBUG=cgoflight.
+
+/*
+extern void goCgoFlight(void);
+
+static void cgoFlightNop(void) {}
+
+static void cgoFlightCallback(void) {
+	goCgoFlight();
+}
+*/
+import "C"
+
+func init() {
+	register("CgoFlight", CgoFlight)
+}
+
+//export goCgoFlight
+func goCgoFlight() {}
+
+func CgoFlight() {
+	for i := 0; i < 3; i++ {
+		C.cgoFlightNop()
+	}
+	C.cgoFlightCallback()
+	panic("cgo flight")
+}
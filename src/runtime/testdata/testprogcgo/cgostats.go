@@ -0,0 +1,58 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Run with GODEBUG=cgocallbackstats=1: call into Go from a C thread,
+// allocate C memory and pass Go pointers to C, and check the counters
+// read by runtime.ReadCgoStats and by GoReadCgoStats from C.
+
+package main
+
+/*
+#include <stdint.h>
+#include <stdlib.h>
+
+extern void cgoStatsThread(int);
+extern void cgoStatsRead(uint64_t*, uint64_t*);
+
+static void cgoStatsPtr(void *p) {}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"unsafe"
+)
+
+func init() {
+	register("CgoStats", CgoStats)
+}
+
+//export GoCgoStatsNop
+func GoCgoStatsNop() {
+}
+
+func CgoStats() {
+	const n = 10
+	C.cgoStatsThread(n)
+	for i := 0; i < n; i++ {
+		C.free(C.malloc(100))
+		x := new(int)
+		C.cgoStatsPtr(unsafe.Pointer(x))
+	}
+	var stats runtime.CgoStats
+	runtime.ReadCgoStats(&stats)
+	var cneedm, ccalls C.uint64_t
+	C.cgoStatsRead(&cneedm, &ccalls)
+	fmt.Printf("needm=%v waits=%v idle=%v calls=%v cmalloc=%v checks=%v c=%v\n",
+		stats.NeedM >= n,
+		stats.NeedMWaits <= stats.NeedM,
+		stats.ExtraMIdle >= 1,
+		stats.Calls >= 2*n,
+		stats.CMallocs >= n && stats.CMallocBytes >= 100*n,
+		stats.PointerChecks >= n,
+		uint64(cneedm) >= stats.NeedM && uint64(ccalls) > stats.Calls)
+}
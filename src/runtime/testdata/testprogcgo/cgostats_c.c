@@ -0,0 +1,35 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// The C definitions for cgostats.go.
+
+#include <pthread.h>
+#include <stdint.h>
+#include "_cgo_export.h"
+
+static void* cgoStatsLoop(void* arg) {
+	int i;
+
+	for (i = 0; i < (int)(intptr_t)arg; i++) {
+		GoCgoStatsNop();
+	}
+	return NULL;
+}
+
+void cgoStatsThread(int n) {
+	pthread_t tid;
+
+	pthread_create(&tid, NULL, cgoStatsLoop, (void*)(intptr_t)n);
+	pthread_join(tid, NULL);
+}
+
+void cgoStatsRead(uint64_t *needm, uint64_t *calls) {
+	GoCgoStats stats;
+
+	GoReadCgoStats(&stats);
+	*needm = stats.NeedM;
+	*calls = stats.Calls;
+}
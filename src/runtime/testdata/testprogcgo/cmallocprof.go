@@ -0,0 +1,82 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Allocate C memory from two Go functions with every allocation
+// sampled, and check that the C allocation profile reports both.
+
+/*
+#include <stdlib.h>
+*/
+import "C"
+
+import (
+	"bytes"
+	"fmt"
+	"os"
+	"runtime"
+	"runtime/pprof"
+	"strings"
+	"unsafe"
+)
+
+func init() {
+	register("CMallocProfile", CMallocProfile)
+}
+
+var cmallocLeak []unsafe.Pointer
+
+func cmallocLeaker() {
+	for i := 0; i < 100; i++ {
+		cmallocLeak = append(cmallocLeak, C.malloc(1000))
+	}
+}
+
+func cstringLeaker() {
+	for i := 0; i < 10; i++ {
+		cmallocLeak = append(cmallocLeak, unsafe.Pointer(C.CString("hello")))
+	}
+}
+
+func CMallocProfile() {
+	runtime.MemProfileRate = 1
+	cmallocLeaker()
+	cstringLeaker()
+
+	type site struct{ objects, bytes int64 }
+	sites := make(map[string]site)
+	p := make([]runtime.MemProfileRecord, 100)
+	n, ok := runtime.CMallocProfile(p)
+	if !ok {
+		fmt.Printf("CMallocProfile: %d records\n", n)
+		os.Exit(1)
+	}
+	for _, r := range p[:n] {
+		for _, pc := range r.Stack() {
+			if f := runtime.FuncForPC(pc - 1); f != nil && strings.HasSuffix(f.Name(), "Leaker") {
+				s := sites[f.Name()]
+				s.objects += r.AllocObjects
+				s.bytes += r.AllocBytes
+				sites[f.Name()] = s
+			}
+		}
+	}
+	if s := sites["main.cmallocLeaker"]; s != (site{100, 100 * 1000}) {
+		fmt.Printf("cmallocLeaker: %+v, want 100 objects and 100000 bytes\n", s)
+		os.Exit(1)
+	}
+	if s := sites["main.cstringLeaker"]; s != (site{10, 10 * 6}) {
+		fmt.Printf("cstringLeaker: %+v, want 10 objects and 60 bytes\n", s)
+		os.Exit(1)
+	}
+
+	var buf bytes.Buffer
+	pprof.Lookup("cmalloc").WriteTo(&buf, 1)
+	if !strings.Contains(buf.String(), "main.cmallocLeaker") {
+		fmt.Printf("cmalloc profile missing cmallocLeaker:\n%s", buf.String())
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
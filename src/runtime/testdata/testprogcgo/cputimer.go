@@ -0,0 +1,90 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package main
+
+// This program makes callbacks from short-lived C threads while the
+// CPU profiler runs, and checks that no thread CPU timer is left
+// behind on a thread that has exited. An extra M used by a callback
+// may create a timer for the C thread it runs on, and must delete it
+// when the callback returns the M.
+
+/*
+#include <pthread.h>
+
+extern void cpuTimerCallback(void);
+
+static void* cpuTimerThread(void* arg __attribute__ ((unused))) {
+	cpuTimerCallback();
+	cpuTimerCallback();
+	return NULL;
+}
+
+static void cpuTimerThreads(int n) {
+	int i;
+	pthread_t tid;
+
+	for (i = 0; i < n; i++) {
+		pthread_create(&tid, NULL, cpuTimerThread, NULL);
+		pthread_join(tid, NULL);
+	}
+}
+*/
+import "C"
+
+import (
+	"bytes"
+	"fmt"
+	"io/ioutil"
+	"os"
+	"runtime"
+	"runtime/pprof"
+	"strings"
+)
+
+func init() {
+	register("CgoCPUTimer", CgoCPUTimer)
+}
+
+//export cpuTimerCallback
+func cpuTimerCallback() {
+	// Go through the scheduler, which sets up the profiling
+	// timer of an M that does not have one at the current rate.
+	runtime.Gosched()
+}
+
+func CgoCPUTimer() {
+	var buf bytes.Buffer
+	if err := pprof.StartCPUProfile(&buf); err != nil {
+		fmt.Println(err)
+		os.Exit(2)
+	}
+	C.cpuTimerThreads(50)
+	timers, err := ioutil.ReadFile("/proc/self/timers")
+	pprof.StopCPUProfile()
+	if err != nil {
+		// Kernels built without CONFIG_CHECKPOINT_RESTORE do
+		// not list the timers of a process.
+		fmt.Println("OK")
+		return
+	}
+
+	for _, line := range strings.Split(string(timers), "\n") {
+		if !strings.HasPrefix(line, "notify:") {
+			continue
+		}
+		i := strings.Index(line, "/tid.")
+		if i < 0 {
+			continue
+		}
+		tid := strings.TrimSpace(line[i+len("/tid."):])
+		if _, err := os.Stat("/proc/self/task/" + tid); err != nil {
+			fmt.Printf("CPU timer left for exited thread %s\n", tid)
+			os.Exit(1)
+		}
+	}
+	fmt.Println("OK")
+}
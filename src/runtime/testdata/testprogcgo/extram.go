@@ -0,0 +1,79 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Run with GODEBUG=cgoextram=16: check that the extra Ms exist before
+// the first callback and that 15 C threads can then be in Go at once.
+
+package main
+
+/*
+#include <pthread.h>
+
+extern void GoExtraM(void);
+
+static void* extraMThread(void* arg) {
+	GoExtraM();
+	return NULL;
+}
+
+static void ExtraMThreads(int n) {
+	pthread_t tid[16];
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pthread_create(&tid[i], NULL, extraMThread, NULL);
+	}
+	for (i = 0; i < n; i++) {
+		pthread_join(tid[i], NULL);
+	}
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime/pprof"
+	"sync"
+)
+
+func init() {
+	register("CgoExtraM", CgoExtraM)
+}
+
+const extraMThreads = 15
+
+var (
+	extraMWait sync.WaitGroup
+	extraMMu   sync.Mutex
+	extraMs    = make(map[uintptr]bool)
+)
+
+//export GoExtraM
+func GoExtraM() {
+	extraMMu.Lock()
+	extraMs[runtime_getm_for_test()] = true
+	extraMMu.Unlock()
+
+	// Hold on to the extra M until every thread has one.
+	extraMWait.Done()
+	extraMWait.Wait()
+}
+
+func CgoExtraM() {
+	before := pprof.Lookup("threadcreate").Count()
+	if before < extraMThreads+1 {
+		fmt.Printf("%d Ms at start-up, want at least %d\n", before, extraMThreads+1)
+		os.Exit(1)
+	}
+	extraMWait.Add(extraMThreads)
+	C.ExtraMThreads(extraMThreads)
+	if len(extraMs) != extraMThreads {
+		fmt.Printf("%d Ms used by %d threads\n", len(extraMs), extraMThreads)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
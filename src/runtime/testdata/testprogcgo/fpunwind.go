@@ -0,0 +1,45 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// This program will crash in C code.
+// Run with GODEBUG=cgofpunwind=1, the crash traceback should list
+// the C callers found by following frame pointers.
+
+/*
+#cgo CFLAGS: -g -O0 -fno-omit-frame-pointer
+
+#include <stdint.h>
+
+char *fpunwindp;
+
+static __attribute__((noinline)) int fpC() {
+	*fpunwindp = 0;
+	return 0;
+}
+
+static __attribute__((noinline)) int fpB() {
+	return fpC() + 1;
+}
+
+static __attribute__((noinline)) int fpA() {
+	return fpB() + 1;
+}
+
+static uintptr_t fpAddrA() { return (uintptr_t)fpA; }
+static uintptr_t fpAddrB() { return (uintptr_t)fpB; }
+*/
+import "C"
+
+import "fmt"
+
+func init() {
+	register("CrashFPUnwind", CrashFPUnwind)
+}
+
+func CrashFPUnwind() {
+	fmt.Printf("fpA=%#x fpB=%#x\n", uintptr(C.fpAddrA()), uintptr(C.fpAddrB()))
+	C.fpA()
+}
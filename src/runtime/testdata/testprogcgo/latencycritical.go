@@ -0,0 +1,143 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !openbsd,!plan9,!windows
+
+// A C thread calls into Go while the only P is busy, first as an
+// ordinary thread and then as a latency-critical one. Check that
+// SetCgoLatencyCritical takes effect and makes the calls wait less.
+
+package main
+
+/*
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+extern int GoLatencySet(int);
+extern void GoLatencyCall(void);
+
+enum { LatencyCalls = 20 };
+
+// Microseconds each call took, without and with the thread
+// marked as latency-critical.
+static long latencyNormal[LatencyCalls];
+static long latencyCritical[LatencyCalls];
+static int latencySet;
+
+static long latencyNow(void) {
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec*1000000L + tv.tv_usec;
+}
+
+static void latencyMeasure(long *out) {
+	int i;
+	long t;
+
+	for (i = 0; i < LatencyCalls; i++) {
+		usleep(20000);
+		t = latencyNow();
+		GoLatencyCall();
+		out[i] = latencyNow() - t;
+	}
+}
+
+static void* latencyThread(void* arg) {
+	latencyMeasure(latencyNormal);
+	latencySet = GoLatencySet(1);
+	latencyMeasure(latencyCritical);
+	return NULL;
+}
+
+static int latencyRun(void) {
+	pthread_t t;
+
+	if (pthread_create(&t, NULL, latencyThread, NULL) != 0) {
+		return -1;
+	}
+	pthread_join(t, NULL);
+	return latencySet;
+}
+
+static long latencyNormalAt(int i) { return latencyNormal[i]; }
+static long latencyCriticalAt(int i) { return latencyCritical[i]; }
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"sort"
+	"sync/atomic"
+)
+
+func init() {
+	register("CgoLatencyCritical", CgoLatencyCritical)
+}
+
+//export GoLatencySet
+func GoLatencySet(on C.int) C.int {
+	if runtime.SetCgoLatencyCritical(on != 0) {
+		return 1
+	}
+	return 0
+}
+
+//export GoLatencyCall
+func GoLatencyCall() {
+}
+
+var latencyStop uint32
+
+// latencySpin has a frame large enough to need a stack check, and is
+// called through latencySpinFunc so that it is not inlined, so that
+// the goroutine calling it in a loop can be preempted.
+var latencySpinFunc = latencySpin
+
+func latencySpin(n int) int {
+	var buf [256]byte
+	buf[n%len(buf)] = byte(n)
+	return n + int(buf[(n+1)%len(buf)]) + 1
+}
+
+func CgoLatencyCritical() {
+	if runtime.SetCgoLatencyCritical(true) {
+		fmt.Println("SetCgoLatencyCritical succeeded on a Go thread")
+		return
+	}
+
+	runtime.GOMAXPROCS(1)
+	done := make(chan bool)
+	go func() {
+		n := 0
+		for atomic.LoadUint32(&latencyStop) == 0 {
+			n = latencySpinFunc(n)
+		}
+		done <- true
+	}()
+	runtime.Gosched()
+	set := C.latencyRun()
+	atomic.StoreUint32(&latencyStop, 1)
+	<-done
+
+	if set != 1 {
+		fmt.Printf("SetCgoLatencyCritical on a C thread returned %d\n", set)
+		return
+	}
+	var normal, critical []int
+	for i := 0; i < C.LatencyCalls; i++ {
+		normal = append(normal, int(C.latencyNormalAt(C.int(i))))
+		critical = append(critical, int(C.latencyCriticalAt(C.int(i))))
+	}
+	sort.Ints(normal)
+	sort.Ints(critical)
+	n, c := normal[len(normal)/2], critical[len(critical)/2]
+	if c >= n {
+		fmt.Printf("median latency %dus for a latency-critical thread, %dus for an ordinary one\n", c, n)
+		return
+	}
+	fmt.Println("OK")
+}
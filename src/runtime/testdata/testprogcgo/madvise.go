@@ -0,0 +1,55 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+package main
+
+// This program replaces the C library's madvise, as a tool loaded
+// with LD_PRELOAD might, and checks that the runtime calls it when it
+// returns memory to the system.
+
+/*
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+static volatile int madviseCalls;
+
+int madvise(void *addr, size_t len, int advice) {
+	__sync_fetch_and_add(&madviseCalls, 1);
+	return syscall(SYS_madvise, addr, len, advice);
+}
+
+static int getMadviseCalls(void) {
+	return madviseCalls;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime/debug"
+)
+
+func init() {
+	register("CgoMadvise", CgoMadvise)
+}
+
+var madviseSink []byte
+
+func CgoMadvise() {
+	before := C.getMadviseCalls()
+	madviseSink = make([]byte, 64<<20)
+	madviseSink[0] = 1
+	madviseSink = nil
+	debug.FreeOSMemory()
+	if C.getMadviseCalls() == before {
+		fmt.Println("FreeOSMemory did not call the C library's madvise")
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
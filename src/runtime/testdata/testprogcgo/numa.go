@@ -0,0 +1,92 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build freebsd linux
+
+package main
+
+/*
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static long threadID(void) {
+	return syscall(SYS_gettid);
+}
+
+// narrowThread restricts the thread to the first CPU it may run on.
+static void narrowThread(void) {
+	cpu_set_t set, one;
+	int i;
+
+	if (sched_getaffinity(0, sizeof set, &set) != 0) {
+		return;
+	}
+	for (i = 0; i < CPU_SETSIZE; i++) {
+		if (CPU_ISSET(i, &set)) {
+			CPU_ZERO(&one);
+			CPU_SET(i, &one);
+			sched_setaffinity(0, sizeof one, &one);
+			return;
+		}
+	}
+}
+
+static int threadCPUs(void) {
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof set, &set) != 0) {
+		return -1;
+	}
+	return CPU_COUNT(&set);
+}
+#else
+static long threadID(void) { return 0; }
+static void narrowThread(void) {}
+static int threadCPUs(void) { return -1; }
+#endif
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+)
+
+func init() {
+	register("LockOSThreadNode", LockOSThreadNode)
+}
+
+func LockOSThreadNode() {
+	if runtime.LockOSThreadNode(-1) || runtime.LockOSThreadNode(1<<20) {
+		fmt.Println("LockOSThreadNode succeeded for a node that does not exist")
+		os.Exit(1)
+	}
+	runtime.UnlockOSThread()
+	if runtime.GOOS == "linux" {
+		// Place a thread narrowed to one CPU, which widens it
+		// to node 0, and check that unlocking narrows it again.
+		runtime.LockOSThread()
+		tid := C.threadID()
+		C.narrowThread()
+		_, err := os.Stat("/sys/devices/system/node/node0")
+		if ok := runtime.LockOSThreadNode(0); ok != (err == nil) {
+			fmt.Printf("LockOSThreadNode(0) = %v, want %v\n", ok, err == nil)
+			os.Exit(1)
+		}
+		runtime.UnlockOSThread()
+		runtime.LockOSThread()
+		if C.threadID() == tid {
+			if n := C.threadCPUs(); n != 1 {
+				fmt.Printf("thread runs on %d CPUs after UnlockOSThread, want 1\n", n)
+				os.Exit(1)
+			}
+		}
+		runtime.UnlockOSThread()
+	}
+	fmt.Println("OK")
+}
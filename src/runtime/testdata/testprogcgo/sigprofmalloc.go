@@ -0,0 +1,108 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// This program sends SIGPROF to threads started by C that are busy in
+// malloc. The Go signal handler calls into Go on such a thread, and
+// must not call malloc, or anything else that is not async-signal-safe,
+// to set up the g0 stack: the thread may hold malloc's locks.
+// Each round starts new threads, whose stack bounds runtime/cgo has
+// not seen yet.
+
+/*
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+	sigprofMallocThreads = 4,
+	sigprofMallocRounds = 16,
+	sigprofMallocSignals = 100,
+};
+
+static volatile int sigprofMallocDone;
+
+static void* sigprofMallocThread(void *arg) {
+	void *p[16];
+	unsigned i, n;
+
+	memset(p, 0, sizeof p);
+	for (n = 0; !sigprofMallocDone; n++) {
+		i = n % 16;
+		free(p[i]);
+		p[i] = malloc(16 << (n % 12));
+		if (p[i] != NULL) {
+			memset(p[i], 1, 16);
+		}
+	}
+	for (i = 0; i < 16; i++) {
+		free(p[i]);
+	}
+	return NULL;
+}
+
+static int runSIGPROFMalloc(void) {
+	pthread_t t[sigprofMallocThreads];
+	int round, i, j, n;
+
+	for (round = 0; round < sigprofMallocRounds; round++) {
+		sigprofMallocDone = 0;
+		n = 0;
+		for (i = 0; i < sigprofMallocThreads; i++) {
+			if (pthread_create(&t[i], NULL, sigprofMallocThread, NULL) != 0) {
+				break;
+			}
+			n++;
+		}
+		for (j = 0; j < sigprofMallocSignals; j++) {
+			for (i = 0; i < n; i++) {
+				pthread_kill(t[i], SIGPROF);
+			}
+			usleep(100);
+		}
+		sigprofMallocDone = 1;
+		for (i = 0; i < n; i++) {
+			pthread_join(t[i], NULL);
+		}
+		if (n < sigprofMallocThreads) {
+			return -1;
+		}
+	}
+	return 0;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"time"
+)
+
+func init() {
+	register("CgoSIGPROFMalloc", CgoSIGPROFMalloc)
+}
+
+func CgoSIGPROFMalloc() {
+	done := make(chan C.int)
+	go func() {
+		done <- C.runSIGPROFMalloc()
+	}()
+	select {
+	case r := <-done:
+		if r != 0 {
+			fmt.Println("could not start threads")
+			return
+		}
+	case <-time.After(60 * time.Second):
+		fmt.Println("signal handler deadlocked")
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,108 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build linux
+
+// Check that C threads that call into Go one after another, some with
+// a signal stack of their own and some without, handle signals in Go
+// on the right stacks: their own, or a single stack that the extra Ms
+// pass between them. The threads with their own stacks unmap them as
+// they exit, so that an extra M that kept using one would crash.
+
+package main
+
+/*
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+extern void GoSigStack(uintptr_t);
+
+#define SIGSTACK_SIZE (64 * 1024)
+
+static void* sigStackThread(void* arg) {
+	stack_t ss;
+	void* p;
+
+	p = NULL;
+	if (arg != NULL) {
+		p = mmap(NULL, SIGSTACK_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) {
+			return NULL;
+		}
+		ss.ss_sp = p;
+		ss.ss_size = SIGSTACK_SIZE;
+		ss.ss_flags = 0;
+		sigaltstack(&ss, NULL);
+	}
+	GoSigStack((uintptr_t)p);
+	if (p != NULL) {
+		ss.ss_sp = NULL;
+		ss.ss_size = 0;
+		ss.ss_flags = SS_DISABLE;
+		sigaltstack(&ss, NULL);
+		munmap(p, SIGSTACK_SIZE);
+	}
+	return NULL;
+}
+
+static void SigStackThreads(int n) {
+	pthread_t tid;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pthread_create(&tid, NULL, sigStackThread, i%2 == 0 ? (void*)1 : NULL);
+		pthread_join(tid, NULL);
+	}
+}
+
+static uintptr_t sigStackRaise(void) {
+	stack_t ss;
+
+	raise(SIGURG);
+	sigaltstack(NULL, &ss);
+	if (ss.ss_flags & SS_DISABLE) {
+		return 0;
+	}
+	return (uintptr_t)ss.ss_sp;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+)
+
+func init() {
+	register("CgoSigStack", CgoSigStack)
+}
+
+var goSigStacks = make(map[C.uintptr_t]bool)
+
+//export GoSigStack
+func GoSigStack(own C.uintptr_t) {
+	sp := C.sigStackRaise()
+	switch {
+	case sp == 0:
+		fmt.Println("no signal stack in Go")
+		os.Exit(1)
+	case own != 0 && sp != own:
+		fmt.Printf("signal stack %#x in Go, want the thread's own %#x\n", sp, own)
+		os.Exit(1)
+	case own == 0:
+		goSigStacks[sp] = true
+	}
+}
+
+func CgoSigStack() {
+	C.SigStackThreads(20)
+	if len(goSigStacks) != 1 {
+		fmt.Printf("%d signal stacks used by threads one at a time, want 1\n", len(goSigStacks))
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
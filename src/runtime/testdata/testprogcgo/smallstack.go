@@ -0,0 +1,111 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// This program checks that threads started by C with small stacks of
+// their own can call into Go, at the top of their stacks and deep in
+// them, while the garbage collector runs.
+
+/*
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern void goSmallStack(int);
+
+enum { smallStackSize = 128 << 10 };
+
+static int deep(int n) {
+	volatile char buf[1024];
+
+	memset((char*)buf, n, sizeof buf);
+	if (n == 0) {
+		goSmallStack(1);
+		return buf[0];
+	}
+	return deep(n-1) + buf[n % sizeof buf];
+}
+
+static void* smallStackThread(void *arg) {
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		goSmallStack(0);
+		deep(64);
+	}
+	return NULL;
+}
+
+static int runSmallStacks(int n) {
+	pthread_attr_t attr;
+	pthread_t *t;
+	void **stacks;
+	int i, ok;
+
+	t = malloc(n * sizeof *t);
+	stacks = malloc(n * sizeof *stacks);
+	ok = 1;
+	for (i = 0; i < n; i++) {
+		stacks[i] = malloc(smallStackSize);
+		pthread_attr_init(&attr);
+		pthread_attr_setstack(&attr, stacks[i], smallStackSize);
+		if (pthread_create(&t[i], &attr, smallStackThread, NULL) != 0) {
+			ok = 0;
+		}
+		pthread_attr_destroy(&attr);
+	}
+	for (i = 0; i < n; i++) {
+		pthread_join(t[i], NULL);
+		free(stacks[i]);
+	}
+	free(stacks);
+	free(t);
+	return ok;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+)
+
+func init() {
+	register("CgoCallbackSmallStack", CgoCallbackSmallStack)
+}
+
+var smallStackSink []byte
+
+//export goSmallStack
+func goSmallStack(deep C.int) {
+	smallStackSink = make([]byte, 64<<10)
+	if deep != 0 {
+		runtime.GC()
+	}
+}
+
+func CgoCallbackSmallStack() {
+	done := make(chan bool)
+	go func() {
+		for {
+			select {
+			case <-done:
+				return
+			default:
+				runtime.GC()
+			}
+		}
+	}()
+	ok := C.runSmallStacks(8)
+	close(done)
+	if ok == 0 {
+		fmt.Println("pthread_create failed")
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,13 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+func init() {
+	register("CgoStartup", CgoStartup)
+}
+
+// CgoStartup does nothing. It is used to time the startup
+// of a program that uses cgo.
+func CgoStartup() {}
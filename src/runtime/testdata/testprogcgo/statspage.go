@@ -0,0 +1,53 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Read the stats page from a C thread that has never called into Go,
+// and check that doing so does not call into Go.
+
+package main
+
+/*
+#include <stdint.h>
+
+extern int statsPageRead(uint64_t*);
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"time"
+)
+
+func init() {
+	register("CgoStatsPage", CgoStatsPage)
+}
+
+func CgoStatsPage() {
+	runtime.GC()
+	start := time.Now()
+	var before, after runtime.CgoStats
+	var s [16]C.uint64_t
+	for {
+		runtime.ReadCgoStats(&before)
+		if C.statsPageRead(&s[0]) != 0 && s[4] >= 1 {
+			break
+		}
+		if time.Since(start) > 10*time.Second {
+			fmt.Println("no stats published after a GC")
+			return
+		}
+		time.Sleep(10 * time.Millisecond)
+	}
+	runtime.ReadCgoStats(&after)
+	update := time.Unix(0, int64(s[0]))
+	fmt.Printf("update=%v heap=%v numgc=%v goroutines=%v needm=%v\n",
+		!update.Before(start.Add(-time.Second)) && update.Before(time.Now().Add(time.Second)),
+		s[1] > 0 && s[2] >= s[1],
+		s[4] >= 1 && s[5] >= s[6],
+		s[8] >= 1,
+		after.NeedM == before.NeedM)
+}
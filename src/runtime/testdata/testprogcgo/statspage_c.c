@@ -0,0 +1,34 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// The C definitions for statspage.go.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include "_cgo_export.h"
+
+struct statsPageArg {
+	GoStats stats;
+	int ok;
+};
+
+static void* statsPageThread(void* arg) {
+	struct statsPageArg *a = arg;
+
+	a->ok = GoReadStats(&a->stats);
+	return NULL;
+}
+
+int statsPageRead(uint64_t *out) {
+	struct statsPageArg a;
+	pthread_t tid;
+
+	pthread_create(&tid, NULL, statsPageThread, &a);
+	pthread_join(tid, NULL);
+	memcpy(out, &a.stats, sizeof a.stats);
+	return a.ok;
+}
@@ -0,0 +1,101 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+// Run with GODEBUG=cgostickym=1: C threads call into Go many times,
+// from varying stack depths, and exit. Check that every call on a
+// thread gets the same m and that the ms are reused once the threads
+// are gone.
+
+package main
+
+/*
+#include <pthread.h>
+#include <string.h>
+
+extern int GoStickyM(int);
+
+static int stickyDeep(int id, int depth) {
+	char buf[1024];
+
+	if (depth == 0) {
+		return GoStickyM(id);
+	}
+	memset(buf, depth, sizeof buf);
+	return stickyDeep(id, depth - 1) + buf[depth % sizeof buf];
+}
+
+static void* stickyThread(void* arg) {
+	int i;
+
+	for (i = 0; i < 200; i++) {
+		stickyDeep((int)(long)arg, (i * 7) % 64);
+	}
+	return NULL;
+}
+
+static void StickyThreads(int n) {
+	pthread_t tid[16];
+	long i;
+
+	for (i = 0; i < n; i++) {
+		pthread_create(&tid[i], NULL, stickyThread, (void*)i);
+	}
+	for (i = 0; i < n; i++) {
+		pthread_join(tid[i], NULL);
+	}
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+	"runtime/pprof"
+	"sync"
+)
+
+func init() {
+	register("CgoStickyM", CgoStickyM)
+}
+
+var (
+	stickyMu sync.Mutex
+	stickyMs [16]uintptr
+)
+
+//export GoStickyM
+func GoStickyM(id C.int) C.int {
+	m := runtime_getm_for_test()
+	stickyMu.Lock()
+	if stickyMs[id] == 0 {
+		stickyMs[id] = m
+	} else if stickyMs[id] != m {
+		fmt.Printf("thread %d: m == %x want %x\n", id, m, stickyMs[id])
+		os.Exit(1)
+	}
+	stickyMu.Unlock()
+
+	// Use the g0 stack, which must cover the current C stack depth.
+	runtime.Gosched()
+	_ = make([]byte, 64<<10)
+	return 0
+}
+
+func CgoStickyM() {
+	const threads, rounds = 8, 20
+	for i := 0; i < rounds; i++ {
+		stickyMs = [16]uintptr{}
+		C.StickyThreads(threads)
+		runtime.GC()
+	}
+	// Without reuse there would be an extra M for every thread started.
+	if n := pprof.Lookup("threadcreate").Count(); n >= threads*rounds/2 {
+		fmt.Printf("%d Ms after %d threads exited\n", n, threads*rounds)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
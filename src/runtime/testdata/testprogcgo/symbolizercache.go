@@ -0,0 +1,92 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Test that CallersFrames calls the cgo symbolizer once per PC.
+// Use a fake symbolizer that counts its calls; PC 2 has two frames.
+
+/*
+#include <stdint.h>
+
+struct cgoSymbolizerArg {
+	uintptr_t   pc;
+	const char* file;
+	uintptr_t   lineno;
+	const char* func;
+	uintptr_t   entry;
+	uintptr_t   more;
+	uintptr_t   data;
+};
+
+static int scCalls;
+
+void scSymbolizer(void* parg) {
+	struct cgoSymbolizerArg* arg = (struct cgoSymbolizerArg*)(parg);
+
+	scCalls++;
+	if (arg->pc == 0) {
+		return;
+	}
+	arg->func = "cFunction";
+	arg->lineno = arg->pc*100 + arg->data;
+	arg->more = arg->pc == 2 && arg->data == 0;
+	arg->data++;
+}
+
+static int scGetCalls() {
+	return scCalls;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"unsafe"
+)
+
+func init() {
+	register("SymbolizerCache", SymbolizerCache)
+}
+
+func symbolizerCacheLines() []int {
+	var lines []int
+	cf := runtime.CallersFrames([]uintptr{1, 2, 1, 2})
+	for {
+		frame, more := cf.Next()
+		lines = append(lines, frame.Line)
+		if !more {
+			break
+		}
+	}
+	return lines
+}
+
+func SymbolizerCache() {
+	runtime.SetCgoTraceback(0, nil, nil, unsafe.Pointer(C.scSymbolizer))
+
+	want := fmt.Sprint([]int{100, 200, 201, 100, 200, 201})
+	for i := 0; i < 3; i++ {
+		if got := fmt.Sprint(symbolizerCacheLines()); got != want {
+			fmt.Printf("pass %d: got lines %s, want %s\n", i, got, want)
+			return
+		}
+	}
+	// PC 1 takes one call and PC 2 two, each followed by a call
+	// with PC 0. Later lookups hit the cache.
+	if got := C.scGetCalls(); got != 5 {
+		fmt.Printf("symbolizer called %d times, want 5\n", got)
+		return
+	}
+
+	// Setting the symbolizer again empties the cache.
+	runtime.SetCgoTraceback(0, nil, nil, unsafe.Pointer(C.scSymbolizer))
+	symbolizerCacheLines()
+	if got := C.scGetCalls(); got != 10 {
+		fmt.Printf("symbolizer called %d times after SetCgoTraceback, want 10\n", got)
+		return
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,53 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9
+
+package main
+
+/*
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+static void blockInC(void) {
+#ifdef _WIN32
+	Sleep(10);
+#else
+	usleep(10000);
+#endif
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+)
+
+func init() {
+	register("CgoThreadStartBurst", CgoThreadStartBurst)
+}
+
+// CgoThreadStartBurst blocks many goroutines in C at once,
+// forcing the scheduler to start a burst of new Ms.
+func CgoThreadStartBurst() {
+	const goCount = 32
+	var wg sync.WaitGroup
+	for round := 0; round < 3; round++ {
+		wg.Add(goCount)
+		for i := 0; i < goCount; i++ {
+			go func() {
+				defer wg.Done()
+				C.blockInC()
+				runtime.Gosched()
+			}()
+		}
+		wg.Wait()
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,77 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// This program checks that a function set with GoSetThreadReset
+// clears the C state of threads whose locked goroutines exit.
+
+/*
+extern void GoSetThreadReset(void (*)(void));
+
+static __thread int threadDirty;
+static volatile int resets;
+
+static void resetThread(void) {
+	threadDirty = 0;
+	__sync_fetch_and_add(&resets, 1);
+}
+
+static void setReset(void) {
+	GoSetThreadReset(resetThread);
+}
+
+static int dirty(void) {
+	return threadDirty;
+}
+
+static void setDirty(void) {
+	threadDirty = 1;
+}
+
+static int getResets(void) {
+	return resets;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+	"time"
+)
+
+func init() {
+	register("CgoThreadReset", CgoThreadReset)
+}
+
+func CgoThreadReset() {
+	C.setReset()
+	const n = 100
+	done := make(chan bool)
+	for i := 0; i < n; i++ {
+		go func() {
+			runtime.LockOSThread()
+			d := C.dirty() != 0
+			C.setDirty()
+			done <- d
+		}()
+		if <-done {
+			fmt.Println("goroutine found its thread dirty")
+			os.Exit(1)
+		}
+	}
+	// The last resets run after the goroutines have sent on done.
+	for start := time.Now(); C.getResets() < n; {
+		if time.Since(start) > 10*time.Second {
+			fmt.Printf("%d resets, want %d\n", C.getResets(), n)
+			os.Exit(1)
+		}
+		time.Sleep(time.Millisecond)
+	}
+	fmt.Println("OK")
+}
@@ -0,0 +1,66 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// Hold threadStatsN calls in C at once, so that the runtime has to
+// start a thread for each of them, until the stats have seen them all.
+
+/*
+#include <unistd.h>
+
+static int threadStatsDone;
+
+static void threadStatsWait(void) {
+	while (__sync_fetch_and_add(&threadStatsDone, 0) == 0)
+		usleep(1000);
+}
+
+static void threadStatsRelease(void) {
+	__sync_fetch_and_add(&threadStatsDone, 1);
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"time"
+)
+
+const threadStatsN = 8
+
+func init() {
+	register("CgoThreadStats", CgoThreadStats)
+}
+
+func CgoThreadStats() {
+	var wg sync.WaitGroup
+	for i := 0; i < threadStatsN; i++ {
+		wg.Add(1)
+		go func() {
+			C.threadStatsWait()
+			wg.Done()
+		}()
+	}
+	var stats runtime.CgoThreadStats
+	for start := time.Now(); time.Since(start) < 10*time.Second; {
+		runtime.ReadCgoThreadStats(&stats)
+		if stats.InC >= threadStatsN {
+			break
+		}
+		time.Sleep(time.Millisecond)
+	}
+	C.threadStatsRelease()
+	wg.Wait()
+	runtime.ReadCgoThreadStats(&stats)
+	fmt.Printf("inc=%d peak=%v created=%v extram=%v\n",
+		stats.InC,
+		stats.PeakInC >= threadStatsN,
+		stats.Created >= threadStatsN-1,
+		stats.ExtraM >= 1)
+}
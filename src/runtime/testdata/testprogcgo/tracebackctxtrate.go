@@ -0,0 +1,76 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// Test SetCgoTracebackContextRate.
+
+/*
+// Defined in tracebackctxtrate_c.c.
+extern void tcrCall(int);
+extern void tcrContext(void*);
+extern void tcrTraceback(void*);
+extern int tcrGetContextCalls(void);
+*/
+import "C"
+
+import (
+	"bytes"
+	"fmt"
+	"runtime"
+	"runtime/pprof"
+	"unsafe"
+)
+
+func init() {
+	register("TracebackContextRate", TracebackContextRate)
+}
+
+//export tcrGo
+func tcrGo() {
+}
+
+// tcrCount returns the number of new contexts created
+// for n calls from C to Go.
+func tcrCount(n int) int {
+	before := C.tcrGetContextCalls()
+	C.tcrCall(C.int(n))
+	return int(C.tcrGetContextCalls() - before)
+}
+
+func TracebackContextRate() {
+	runtime.SetCgoTraceback(0, unsafe.Pointer(C.tcrTraceback), unsafe.Pointer(C.tcrContext), nil)
+
+	ok := true
+	check := func(what string, got, want int) {
+		if got != want {
+			fmt.Printf("%s: got %d contexts, want %d\n", what, got, want)
+			ok = false
+		}
+	}
+
+	check("default rate", tcrCount(100), 100)
+
+	runtime.SetCgoTracebackContextRate(4)
+	check("rate 4", tcrCount(100), 25)
+
+	runtime.SetCgoTracebackContextRate(0)
+	check("rate 0", tcrCount(100), 0)
+
+	var buf bytes.Buffer
+	if err := pprof.StartCPUProfile(&buf); err != nil {
+		fmt.Println(err)
+		return
+	}
+	check("rate 0 while profiling", tcrCount(100), 100)
+	pprof.StopCPUProfile()
+	check("rate 0 after profiling", tcrCount(100), 0)
+
+	runtime.SetCgoTracebackContextRate(1)
+	check("rate 1", tcrCount(100), 100)
+
+	if ok {
+		fmt.Println("OK")
+	}
+}
@@ -0,0 +1,48 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// The C definitions for tracebackctxtrate.go.
+
+#include <stdint.h>
+
+// Functions exported from Go.
+extern void tcrGo(void);
+
+struct cgoContextArg {
+	uintptr_t context;
+};
+
+struct cgoTracebackArg {
+	uintptr_t  context;
+	uintptr_t* buf;
+	uintptr_t  max;
+};
+
+static int contextCalls;
+
+void tcrCall(int n) {
+	int i;
+
+	for (i = 0; i < n; i++) {
+		tcrGo();
+	}
+}
+
+int tcrGetContextCalls() {
+	return __sync_add_and_fetch(&contextCalls, 0);
+}
+
+void tcrContext(void* parg) {
+	struct cgoContextArg* arg = (struct cgoContextArg*)(parg);
+	if (arg->context == 0) {
+		arg->context = __sync_add_and_fetch(&contextCalls, 1);
+	}
+}
+
+void tcrTraceback(void* parg) {
+	struct cgoTracebackArg* arg = (struct cgoTracebackArg*)(parg);
+	if (arg->max > 0) {
+		arg->buf[0] = 0;
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package main
+
+// This program will crash.
+// The fake traceback fills every slot the runtime offers, so the
+// number of symbolized frames shows the cgo traceback depth.
+
+/*
+#cgo CFLAGS: -g -O0
+
+#include <stdint.h>
+
+char *depthp;
+
+static int depthCrash() {
+	*depthp = 0;
+	return 0;
+}
+
+struct cgoTracebackArg {
+	uintptr_t  context;
+	uintptr_t* buf;
+	uintptr_t  max;
+};
+
+struct cgoSymbolizerArg {
+	uintptr_t   pc;
+	const char* file;
+	uintptr_t   lineno;
+	const char* func;
+	uintptr_t   entry;
+	uintptr_t   more;
+	uintptr_t   data;
+};
+
+void depthTraceback(void* parg) {
+	struct cgoTracebackArg* arg = (struct cgoTracebackArg*)(parg);
+	uintptr_t i;
+
+	for (i = 0; i < arg->max; i++) {
+		arg->buf[i] = i + 1;
+	}
+}
+
+void depthSymbolizer(void* parg) {
+	struct cgoSymbolizerArg* arg = (struct cgoSymbolizerArg*)(parg);
+	arg->file = "cgo depth";
+	arg->lineno = arg->pc;
+}
+*/
+import "C"
+
+import (
+	"runtime"
+	"unsafe"
+)
+
+func init() {
+	register("CrashTracebackDepth", CrashTracebackDepth)
+}
+
+func CrashTracebackDepth() {
+	runtime.SetCgoTraceback(0, unsafe.Pointer(C.depthTraceback), nil, unsafe.Pointer(C.depthSymbolizer))
+	C.depthCrash()
+}
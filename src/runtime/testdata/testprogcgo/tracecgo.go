@@ -0,0 +1,67 @@
+// Copyright 2016 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+// +build !plan9,!windows
+
+package main
+
+// Trace a call from Go to C that calls back into Go, and a callback
+// from a thread created in C, which must acquire an extra M.
+// The trace is written to the file named by GO_TRACECGO_FILE.
+
+/*
+#include <pthread.h>
+
+extern void GoTraceCgo(void);
+
+static void traceCgoCall(void) {
+	GoTraceCgo();
+}
+
+static void* traceCgoThread1(void* arg) {
+	GoTraceCgo();
+	return NULL;
+}
+
+static void traceCgoThread(void) {
+	pthread_t tid;
+
+	pthread_create(&tid, NULL, traceCgoThread1, NULL);
+	pthread_join(tid, NULL);
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"os"
+	"runtime/trace"
+)
+
+func init() {
+	register("TraceCgo", TraceCgo)
+}
+
+//export GoTraceCgo
+func GoTraceCgo() {}
+
+func TraceCgo() {
+	f, err := os.Create(os.Getenv("GO_TRACECGO_FILE"))
+	if err != nil {
+		fmt.Println(err)
+		os.Exit(1)
+	}
+	if err := trace.Start(f); err != nil {
+		fmt.Println(err)
+		os.Exit(1)
+	}
+	C.traceCgoCall()
+	C.traceCgoThread()
+	trace.Stop()
+	if err := f.Close(); err != nil {
+		fmt.Println(err)
+		os.Exit(1)
+	}
+	fmt.Println("OK")
+}
@@ -60,7 +60,11 @@ const (
 	traceEvGoStartLocal   = 38 // goroutine starts running on the same P as the last event [timestamp, goroutine id]
 	traceEvGoUnblockLocal = 39 // goroutine is unblocked on the same P as the last event [timestamp, goroutine id, stack]
 	traceEvGoSysExitLocal = 40 // syscall exit on the same P as the last event [timestamp, goroutine id, real timestamp]
-	traceEvCount          = 41
+	traceEvCgoCall        = 41 // call from Go to C, before the syscall enter [timestamp, stack]
+	traceEvCgoCallDone    = 42 // call from Go to C returns [timestamp]
+	traceEvCgoCallback    = 43 // call from C to Go, after the syscall exit [timestamp, nanoseconds spent acquiring an extra M]
+	traceEvCgoCallbackEnd = 44 // call from C to Go returns [timestamp]
+	traceEvCount          = 45
 )
 
 const (
@@ -344,7 +348,7 @@ func ReadTrace() []byte {
 		trace.headerWritten = true
 		trace.lockOwner = nil
 		unlock(&trace.lock)
-		return []byte("go 1.7 trace\x00\x00\x00\x00")
+		return []byte("go 1.8 trace\x00\x00\x00\x00")
 	}
 	// Wait for new data.
 	if trace.fullHead == 0 && !trace.shutdown {
@@ -904,6 +908,15 @@ func traceGoCreate(newg *g, pc uintptr) {
 	traceEvent(traceEvGoCreate, 2, uint64(newg.goid), uint64(id))
 }
 
+// traceGoCreateExtra is called by newextram when it creates an extra
+// M while tracing is on. It describes the M's goroutine, which is in a
+// syscall, the same way StartTrace does.
+func traceGoCreateExtra(gp *g) {
+	traceGoCreate(gp, gp.startpc)
+	gp.traceseq++
+	traceEvent(traceEvGoInSyscall, -1, uint64(gp.goid))
+}
+
 func traceGoStart() {
 	_g_ := getg().m.curg
 	_p_ := _g_.m.p
@@ -954,6 +967,29 @@ func traceGoSysCall() {
 	traceEvent(traceEvGoSysCall, 1)
 }
 
+// traceCgoCall is called by cgocall. The stack starts at the
+// cgo-generated _Cfunc_ wrapper, which names the C function.
+func traceCgoCall() {
+	traceEvent(traceEvCgoCall, 3)
+}
+
+func traceCgoCallDone() {
+	traceEvent(traceEvCgoCallDone, -1)
+}
+
+// traceCgoCallback is called by cgocallbackg. needm is the time the
+// C thread spent acquiring an extra M for the call, or 0 if it ran on
+// an M it already had.
+func traceCgoCallback(needm int64) {
+	traceEvent(traceEvCgoCallback, -1, uint64(needm))
+}
+
+// traceCgoCallbackEnd is called by cgocallbackg1 before it unlocks g
+// from its m, so that the event is recorded on the m that made the call.
+func traceCgoCallbackEnd() {
+	traceEvent(traceEvCgoCallbackEnd, -1)
+}
+
 func traceGoSysExit(ts int64) {
 	if ts != 0 && ts < trace.ticksStart {
 		// There is a race between the code that initializes sysexitticks
@@ -636,17 +636,16 @@ func traceback1(pc, sp, lr uintptr, gp *g, flags uint) {
 	// If the goroutine is in cgo, and we have a cgo traceback, print that.
 	if iscgo && gp.m != nil && gp.m.ncgo > 0 && gp.syscallsp != 0 && gp.m.cgoCallers != nil && gp.m.cgoCallers[0] != 0 {
 		// Lock cgoCallers so that a signal handler won't
-		// change it, copy the array, reset it, unlock it.
+		// change it, print it, reset it, unlock it.
 		// We are locked to the thread and are not running
 		// concurrently with a signal handler.
 		// We just have to stop a signal handler from interrupting
-		// in the middle of our copy.
+		// in the middle of our print. The buffer can be large,
+		// so we don't copy it to the stack.
 		atomic.Store(&gp.m.cgoCallersUse, 1)
-		cgoCallers := *gp.m.cgoCallers
+		printCgoTraceback(gp.m.cgoCallers)
 		gp.m.cgoCallers[0] = 0
 		atomic.Store(&gp.m.cgoCallersUse, 0)
-
-		printCgoTraceback(&cgoCallers)
 	}
 
 	var n int
@@ -749,7 +748,7 @@ func goroutineheader(gp *g) {
 	if waitfor >= 1 {
 		print(", ", waitfor, " minutes")
 	}
-	if gp.lockedm != nil {
+	if gp.lockedm != 0 {
 		print(", locked to thread")
 	}
 	print("]:\n")
@@ -942,6 +941,11 @@ func isSystemGoroutine(gp *g) bool {
 // return, except for the PC field when the More field is zero. The
 // function must not keep a copy of the struct pointer between calls.
 //
+// The runtime caches the information the symbolizer returns for each
+// PC looked up through CallersFrames, so that function may not call
+// the symbolizer again for a PC it has seen. The cache is emptied by
+// each call to SetCgoTraceback.
+//
 // When calling SetCgoTraceback, the version argument is the version
 // number of the structs that the functions expect to receive.
 // Currently this must be zero.
@@ -960,6 +964,7 @@ func SetCgoTraceback(version int, traceback, context, symbolizer unsafe.Pointer)
 
 	cgoTraceback = traceback
 	cgoSymbolizer = symbolizer
+	cgoSymbolizerCacheFlush()
 
 	// The context function is called when a C function calls a Go
 	// function. As such it is only called by C code in runtime/cgo.
@@ -968,6 +973,46 @@ func SetCgoTraceback(version int, traceback, context, symbolizer unsafe.Pointer)
 	}
 }
 
+// SetCgoTracebackContextRate sets how often calls from C to Go call
+// the context function registered with SetCgoTraceback. Calling the
+// context function on every call, and again when the call returns,
+// can be a large part of the cost of a call from C to Go when the
+// function is expensive, such as one that unwinds the C stack.
+//
+// If rate is 1, the default, the context function is called for every
+// call. If rate is greater than 1, it is called for about one call in
+// rate. If rate is 0, it is called only while CPU profiling is enabled
+// (see SetCPUProfileRate). A call for which the context function is
+// not called shows no traceback for the C portion of the call stack.
+func SetCgoTracebackContextRate(rate int) {
+	if rate < 0 {
+		rate = 0
+	}
+	if rate > 1<<30 {
+		rate = 1 << 30
+	}
+	atomic.Store(&cgoContextRate, uint32(rate))
+	setcgocontextrate()
+}
+
+var (
+	cgoContextRate      uint32 = 1 // see SetCgoTracebackContextRate
+	cgoContextProfiling uint32     // CPU profiling is on
+)
+
+// setcgocontextrate tells runtime/cgo which calls from C to Go
+// should call the context function.
+func setcgocontextrate() {
+	if _cgo_set_context_rate == nil {
+		return
+	}
+	args := struct {
+		rate      int32
+		profiling int32
+	}{int32(atomic.Load(&cgoContextRate)), int32(atomic.Load(&cgoContextProfiling))}
+	cgocall(_cgo_set_context_rate, unsafe.Pointer(&args))
+}
+
 var cgoTraceback unsafe.Pointer
 var cgoSymbolizer unsafe.Pointer
 
@@ -995,7 +1040,7 @@ type cgoSymbolizerArg struct {
 }
 
 // cgoTraceback prints a traceback of callers.
-func printCgoTraceback(callers *cgoCallers) {
+func printCgoTraceback(callers cgoCallers) {
 	if cgoSymbolizer == nil {
 		for _, c := range callers {
 			if c == 0 {
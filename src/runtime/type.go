@@ -486,7 +486,7 @@ func typelinksinit() {
 		for _, tl := range md.typelinks {
 			t := (*_type)(unsafe.Pointer(md.types + uintptr(tl)))
 			for _, candidate := range typehash[t.hash] {
-				if typesEqual(t, candidate) {
+				if typesEqual(t, candidate, nil) {
 					t = candidate
 					break
 				}
@@ -498,6 +498,50 @@ func typelinksinit() {
 	}
 }
 
+// typelinksadd sets up the typemap of md, a module added after
+// typelinksinit ran, to prefer the types of the modules already in use.
+func typelinksadd(md *moduledata) {
+	typehash := make(map[uint32][]*_type)
+	for prev := &firstmoduledata; prev != md; prev = prev.next {
+	collect:
+		for _, tl := range prev.typelinks {
+			// As in resolveTypeOff, a type missing from the
+			// typemap is the module's own.
+			t := prev.typemap[typeOff(tl)]
+			if t == nil {
+				t = (*_type)(unsafe.Pointer(prev.types + uintptr(tl)))
+			}
+			tlist := typehash[t.hash]
+			for _, tcur := range tlist {
+				if tcur == t {
+					continue collect
+				}
+			}
+			typehash[t.hash] = append(tlist, t)
+		}
+	}
+
+	md.typemap = make(map[typeOff]*_type, len(md.typelinks))
+	for _, tl := range md.typelinks {
+		t := (*_type)(unsafe.Pointer(md.types + uintptr(tl)))
+		for _, candidate := range typehash[t.hash] {
+			if typesEqual(t, candidate, nil) {
+				t = candidate
+				break
+			}
+		}
+		md.typemap[typeOff(tl)] = t
+	}
+}
+
+// A _typePair is a pair of types being compared by typesEqual, in
+// its frame, linked to the pair compared by its caller.
+type _typePair struct {
+	t1 *_type
+	t2 *_type
+	up *_typePair
+}
+
 // typesEqual reports whether two types are equal.
 //
 // Everywhere in the runtime and reflect packages, it is assumed that
@@ -509,11 +553,23 @@ func typelinksinit() {
 // typelinksinit. It uses typesEqual to map types from later modules
 // back into earlier ones.
 //
-// Only typelinksinit needs this function.
-func typesEqual(t, v *_type) bool {
+// Only typelinksinit and typelinksadd need this function.
+//
+// seen lists the pairs of types being compared further up the stack.
+// They are taken to be equal, so that comparing recursive types that
+// come from different modules terminates. The list lives in the
+// frames of the callers, so comparing types allocates nothing; it is
+// as long as the types are deeply nested.
+func typesEqual(t, v *_type, seen *_typePair) bool {
 	if t == v {
 		return true
 	}
+	for tp := seen; tp != nil; tp = tp.up {
+		if tp.t1 == t && tp.t2 == v {
+			return true
+		}
+	}
+	seen = &_typePair{t, v, seen}
 	kind := t.kind & kindMask
 	if kind != v.kind&kindMask {
 		return false
@@ -542,11 +598,11 @@ func typesEqual(t, v *_type) bool {
 	case kindArray:
 		at := (*arraytype)(unsafe.Pointer(t))
 		av := (*arraytype)(unsafe.Pointer(v))
-		return typesEqual(at.elem, av.elem) && at.len == av.len
+		return typesEqual(at.elem, av.elem, seen) && at.len == av.len
 	case kindChan:
 		ct := (*chantype)(unsafe.Pointer(t))
 		cv := (*chantype)(unsafe.Pointer(v))
-		return ct.dir == cv.dir && typesEqual(ct.elem, cv.elem)
+		return ct.dir == cv.dir && typesEqual(ct.elem, cv.elem, seen)
 	case kindFunc:
 		ft := (*functype)(unsafe.Pointer(t))
 		fv := (*functype)(unsafe.Pointer(v))
@@ -555,13 +611,13 @@ func typesEqual(t, v *_type) bool {
 		}
 		tin, vin := ft.in(), fv.in()
 		for i := 0; i < len(tin); i++ {
-			if !typesEqual(tin[i], vin[i]) {
+			if !typesEqual(tin[i], vin[i], seen) {
 				return false
 			}
 		}
 		tout, vout := ft.out(), fv.out()
 		for i := 0; i < len(tout); i++ {
-			if !typesEqual(tout[i], vout[i]) {
+			if !typesEqual(tout[i], vout[i], seen) {
 				return false
 			}
 		}
@@ -586,7 +642,7 @@ func typesEqual(t, v *_type) bool {
 			if tname.pkgPath() != vname.pkgPath() {
 				return false
 			}
-			if !typesEqual(it.typ.typeOff(tm.ityp), iv.typ.typeOff(vm.ityp)) {
+			if !typesEqual(it.typ.typeOff(tm.ityp), iv.typ.typeOff(vm.ityp), seen) {
 				return false
 			}
 		}
@@ -594,15 +650,15 @@ func typesEqual(t, v *_type) bool {
 	case kindMap:
 		mt := (*maptype)(unsafe.Pointer(t))
 		mv := (*maptype)(unsafe.Pointer(v))
-		return typesEqual(mt.key, mv.key) && typesEqual(mt.elem, mv.elem)
+		return typesEqual(mt.key, mv.key, seen) && typesEqual(mt.elem, mv.elem, seen)
 	case kindPtr:
 		pt := (*ptrtype)(unsafe.Pointer(t))
 		pv := (*ptrtype)(unsafe.Pointer(v))
-		return typesEqual(pt.elem, pv.elem)
+		return typesEqual(pt.elem, pv.elem, seen)
 	case kindSlice:
 		st := (*slicetype)(unsafe.Pointer(t))
 		sv := (*slicetype)(unsafe.Pointer(v))
-		return typesEqual(st.elem, sv.elem)
+		return typesEqual(st.elem, sv.elem, seen)
 	case kindStruct:
 		st := (*structtype)(unsafe.Pointer(t))
 		sv := (*structtype)(unsafe.Pointer(v))
@@ -618,7 +674,7 @@ func typesEqual(t, v *_type) bool {
 			if tf.name.pkgPath() != vf.name.pkgPath() {
 				return false
 			}
-			if !typesEqual(tf.typ, vf.typ) {
+			if !typesEqual(tf.typ, vf.typ, seen) {
 				return false
 			}
 			if tf.name.tag() != vf.name.tag() {
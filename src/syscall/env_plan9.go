@@ -73,6 +73,32 @@ func Setenv(key, value string) error {
 	return nil
 }
 
+// Setenvs changes several environment variables at once. Each
+// element of kv is either of the form "key=value", which sets key to
+// value, or a key alone, which unsets it. Setenvs stops at the first
+// error.
+func Setenvs(kv []string) error {
+	for _, s := range kv {
+		key, value, set := s, "", false
+		for j := 0; j < len(s); j++ {
+			if s[j] == '=' {
+				key, value, set = s[:j], s[j+1:], true
+				break
+			}
+		}
+		var err error
+		if set {
+			err = Setenv(key, value)
+		} else {
+			err = Unsetenv(key)
+		}
+		if err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
 func Clearenv() {
 	RawSyscall(SYS_RFORK, RFCENVG, 0, 0)
 }
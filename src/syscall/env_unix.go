@@ -8,80 +8,211 @@
 
 package syscall
 
-import "sync"
+import (
+	"sync"
+	"sync/atomic"
+)
 
 var (
-	// envOnce guards initialization by copyenv, which populates env.
+	// envOnce guards initialization by copyenv, which publishes
+	// the first envState.
 	envOnce sync.Once
 
-	// envLock guards env and envs.
-	envLock sync.RWMutex
+	// envLock serializes changes to the environment, and to the C
+	// environment with them.
+	envLock sync.Mutex
 
-	// env maps from an environment variable to its first occurrence in envs.
-	env map[string]int
+	// envCur holds the current *envState. Readers load it without
+	// locking; see holdenv.
+	envCur atomic.Value
 
 	// envs is provided by the runtime. elements are expected to
-	// be of the form "key=value". An empty string means deleted
-	// (or a duplicate to be ignored).
+	// be of the form "key=value".
 	envs []string = runtime_envs()
 )
 
+// An envState is a snapshot of the environment. A change is made to
+// the current envState in place if no reader holds it, and otherwise
+// to a copy, which then replaces it in envCur. An envState that has
+// been replaced is not changed again.
+type envState struct {
+	// env maps from an environment variable to its first occurrence in envs.
+	env map[string]int
+
+	// envs has elements of the form "key=value". An empty string
+	// means deleted (or a duplicate to be ignored).
+	envs []string
+
+	// readers is the number of readers holding the envState, or
+	// -1 while a writer changes it in place.
+	readers int32
+}
+
 func runtime_envs() []string // in package runtime
 
-// setenv_c and unsetenv_c are provided by the runtime but are no-ops
-// if cgo isn't loaded.
+// setenv_c, unsetenv_c and setenvs_c are provided by the runtime but
+// are no-ops if cgo isn't loaded.
 func setenv_c(k, v string)
 func unsetenv_c(k string)
+func setenvs_c(kv []string)
 
 func copyenv() {
-	env = make(map[string]int)
-	for i, s := range envs {
+	st := &envState{env: make(map[string]int), envs: envs}
+	for i, s := range st.envs {
 		for j := 0; j < len(s); j++ {
 			if s[j] == '=' {
 				key := s[:j]
-				if _, ok := env[key]; !ok {
-					env[key] = i // first mention of key
+				if _, ok := st.env[key]; !ok {
+					st.env[key] = i // first mention of key
 				} else {
 					// Clear duplicate keys. This permits Unsetenv to
 					// safely delete only the first item without
 					// worrying about unshadowing a later one,
 					// which might be a security problem.
-					envs[i] = ""
+					st.envs[i] = ""
 				}
 				break
 			}
 		}
 	}
+	envCur.Store(st)
 }
 
-func Unsetenv(key string) error {
+// loadenv returns the current envState.
+func loadenv() *envState {
 	envOnce.Do(copyenv)
+	return envCur.Load().(*envState)
+}
+
+// holdenv returns the current envState, held so that it is not
+// changed until releaseenv. It takes envLock only if a writer is
+// changing the envState in place, and reports whether it did.
+func holdenv() (*envState, bool) {
+	for {
+		st := loadenv()
+		n := atomic.LoadInt32(&st.readers)
+		if n < 0 {
+			envLock.Lock()
+			return loadenv(), true
+		}
+		if atomic.CompareAndSwapInt32(&st.readers, n, n+1) {
+			return st, false
+		}
+	}
+}
+
+// releaseenv releases an envState returned by holdenv.
+func releaseenv(st *envState, locked bool) {
+	if locked {
+		envLock.Unlock()
+		return
+	}
+	atomic.AddInt32(&st.readers, -1)
+}
+
+// modifyenv returns an envState for a writer, which holds envLock, to
+// change: the current one if no reader holds it, or else a copy with
+// room for n more variables. The writer passes it to publishenv.
+func modifyenv(n int) *envState {
+	st := loadenv()
+	if atomic.CompareAndSwapInt32(&st.readers, 0, -1) {
+		return st
+	}
+	return st.clone(n)
+}
+
+// publishenv makes the changes to an envState from modifyenv visible
+// to readers.
+func publishenv(st *envState) {
+	if atomic.LoadInt32(&st.readers) < 0 {
+		atomic.StoreInt32(&st.readers, 0)
+		return
+	}
+	envCur.Store(st)
+}
+
+// clone returns a copy of st with room for n more variables.
+func (st *envState) clone(n int) *envState {
+	c := &envState{
+		env:  make(map[string]int, len(st.env)+n),
+		envs: make([]string, len(st.envs), len(st.envs)+n),
+	}
+	for k, i := range st.env {
+		c.env[k] = i
+	}
+	copy(c.envs, st.envs)
+	return c
+}
+
+func (st *envState) set(key, value string) {
+	kv := key + "=" + value
+	if i, ok := st.env[key]; ok {
+		st.envs[i] = kv
+		return
+	}
+	st.env[key] = len(st.envs)
+	st.envs = append(st.envs, kv)
+}
+
+func (st *envState) unset(key string) {
+	if i, ok := st.env[key]; ok {
+		st.envs[i] = ""
+		delete(st.env, key)
+	}
+}
+
+func checkenv(key, value string) error {
+	if len(key) == 0 {
+		return EINVAL
+	}
+	for i := 0; i < len(key); i++ {
+		if key[i] == '=' || key[i] == 0 {
+			return EINVAL
+		}
+	}
+	for i := 0; i < len(value); i++ {
+		if value[i] == 0 {
+			return EINVAL
+		}
+	}
+	return nil
+}
+
+// splitenv splits an element of the argument to Setenvs into a key
+// and a value, reporting whether it sets the key.
+func splitenv(s string) (key, value string, set bool) {
+	for i := 0; i < len(s); i++ {
+		if s[i] == '=' {
+			return s[:i], s[i+1:], true
+		}
+	}
+	return s, "", false
+}
 
+func Unsetenv(key string) error {
 	envLock.Lock()
 	defer envLock.Unlock()
 
-	if i, ok := env[key]; ok {
-		envs[i] = ""
-		delete(env, key)
-	}
+	st := modifyenv(0)
+	st.unset(key)
+	publishenv(st)
 	unsetenv_c(key)
 	return nil
 }
 
 func Getenv(key string) (value string, found bool) {
-	envOnce.Do(copyenv)
 	if len(key) == 0 {
 		return "", false
 	}
 
-	envLock.RLock()
-	defer envLock.RUnlock()
-
-	i, ok := env[key]
+	st, locked := holdenv()
+	i, ok := st.env[key]
 	if !ok {
+		releaseenv(st, locked)
 		return "", false
 	}
-	s := envs[i]
+	s := st.envs[i]
+	releaseenv(st, locked)
 	for i := 0; i < len(s); i++ {
 		if s[i] == '=' {
 			return s[i+1:], true
@@ -91,59 +222,68 @@ func Getenv(key string) (value string, found bool) {
 }
 
 func Setenv(key, value string) error {
-	envOnce.Do(copyenv)
-	if len(key) == 0 {
-		return EINVAL
+	if err := checkenv(key, value); err != nil {
+		return err
 	}
-	for i := 0; i < len(key); i++ {
-		if key[i] == '=' || key[i] == 0 {
-			return EINVAL
-		}
-	}
-	for i := 0; i < len(value); i++ {
-		if value[i] == 0 {
-			return EINVAL
+
+	envLock.Lock()
+	defer envLock.Unlock()
+
+	st := modifyenv(1)
+	st.set(key, value)
+	publishenv(st)
+	setenv_c(key, value)
+	return nil
+}
+
+// Setenvs changes several environment variables at once. Each
+// element of kv is either of the form "key=value", which sets key to
+// value, or a key alone, which unsets it. If any element is invalid,
+// Setenvs changes nothing. Getenv sees either none of the changes or
+// all of them, and a program that uses cgo updates the C environment
+// with a single call into C.
+func Setenvs(kv []string) error {
+	for _, s := range kv {
+		key, value, _ := splitenv(s)
+		if err := checkenv(key, value); err != nil {
+			return err
 		}
 	}
 
 	envLock.Lock()
 	defer envLock.Unlock()
 
-	i, ok := env[key]
-	kv := key + "=" + value
-	if ok {
-		envs[i] = kv
-	} else {
-		i = len(envs)
-		envs = append(envs, kv)
+	st := modifyenv(len(kv))
+	for _, s := range kv {
+		if key, value, set := splitenv(s); set {
+			st.set(key, value)
+		} else {
+			st.unset(key)
+		}
 	}
-	env[key] = i
-	setenv_c(key, value)
+	publishenv(st)
+	setenvs_c(kv)
 	return nil
 }
 
 func Clearenv() {
-	envOnce.Do(copyenv) // prevent copyenv in Getenv/Setenv
-
 	envLock.Lock()
 	defer envLock.Unlock()
 
-	for k := range env {
+	for k := range loadenv().env {
 		unsetenv_c(k)
 	}
-	env = make(map[string]int)
-	envs = []string{}
+	envCur.Store(&envState{env: make(map[string]int)})
 }
 
 func Environ() []string {
-	envOnce.Do(copyenv)
-	envLock.RLock()
-	defer envLock.RUnlock()
-	a := make([]string, 0, len(envs))
-	for _, env := range envs {
+	st, locked := holdenv()
+	a := make([]string, 0, len(st.envs))
+	for _, env := range st.envs {
 		if env != "" {
 			a = append(a, env)
 		}
 	}
+	releaseenv(st, locked)
 	return a
 }
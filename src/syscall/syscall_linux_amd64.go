@@ -59,7 +59,19 @@ const (
 //sys	sendto(s int, buf []byte, flags int, to unsafe.Pointer, addrlen _Socklen) (err error)
 //sys	recvmsg(s int, msg *Msghdr, flags int) (n int, err error)
 //sys	sendmsg(s int, msg *Msghdr, flags int) (n int, err error)
-//sys	mmap(addr uintptr, length uintptr, prot int, flags int, fd int, offset int64) (xaddr uintptr, err error)
+
+func runtime_mmap(addr uintptr, length uintptr, prot, flags, fd int32, offset uint64) uintptr // in package runtime
+
+// mmap goes through the runtime, which calls the C library's mmap
+// when using cgo, so that file mappings are seen by the same
+// interceptors as the runtime's own memory.
+func mmap(addr uintptr, length uintptr, prot int, flags int, fd int, offset int64) (xaddr uintptr, err error) {
+	xaddr = runtime_mmap(addr, length, int32(prot), int32(flags), int32(fd), uint64(offset))
+	if xaddr < 4096 {
+		return 0, errnoErr(Errno(xaddr))
+	}
+	return xaddr, nil
+}
 
 //go:noescape
 func gettimeofday(tv *Timeval) (err Errno)
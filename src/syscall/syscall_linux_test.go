@@ -138,3 +138,38 @@ func deathSignalChild() {
 	fmt.Println("not ok")
 	os.Exit(1)
 }
+
+// Test mapping a file at an offset that does not fit in 32 bits.
+func TestMmapLargeOffset(t *testing.T) {
+	f, err := ioutil.TempFile("", "TestMmapLargeOffset")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.Remove(f.Name())
+	defer f.Close()
+
+	const off = 5 << 30
+	if err := f.Truncate(off + 1<<20); err != nil {
+		t.Skipf("cannot create sparse file: %v", err)
+	}
+	want := []byte("beyond 4GB")
+	if _, err := f.WriteAt(want, off+100); err != nil {
+		t.Skipf("cannot write sparse file: %v", err)
+	}
+
+	b, err := syscall.Mmap(int(f.Fd()), off, 1<<20, syscall.PROT_READ, syscall.MAP_SHARED)
+	if err != nil {
+		t.Fatalf("Mmap: %v", err)
+	}
+	if got := b[100 : 100+len(want)]; string(got) != string(want) {
+		t.Errorf("mapped data = %q, want %q", got, want)
+	}
+	if err := syscall.Munmap(b); err != nil {
+		t.Fatalf("Munmap: %v", err)
+	}
+
+	// A bad file descriptor is reported as an error.
+	if _, err := syscall.Mmap(-1, off, 1<<20, syscall.PROT_READ, syscall.MAP_SHARED); err != syscall.EBADF {
+		t.Errorf("Mmap of bad descriptor: got error %v, want %v", err, syscall.EBADF)
+	}
+}
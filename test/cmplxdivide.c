@@ -14,11 +14,18 @@
 // if it needs to be regenerated, compile and run this C program
 // like this:
 //	gcc '-std=c99' cmplxdivide.c && a.out >cmplxdivide1.go
+//
+// Run with the argument "bench", it instead times C99 division of
+// arrays of finite values and prints the result in the format of Go
+// benchmark results, to compare with the runtime benchmark
+// BenchmarkComplex128DivSlice, which divides the same values:
+//	gcc '-std=c99' -O2 cmplxdivide.c && a.out bench
 
 #include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #define nelem(x) (sizeof(x)/sizeof((x)[0]))
 
@@ -56,12 +63,55 @@ iscnan(double complex d)
 
 double complex zero;	// attempt to hide zero division from gcc
 
+enum {
+	BenchSize = 1024,
+};
+
+double complex benchn[BenchSize], benchd[BenchSize], benchq[BenchSize];
+
+// now returns the processor time used, in nanoseconds. C99 has
+// no clock_gettime.
+double
+now(void)
+{
+	return (double)clock()/CLOCKS_PER_SEC*1e9;
+}
+
+// bench times the division of benchn by benchd, growing the count
+// of passes until a run takes a second.
+int
+bench(void)
+{
+	int i, j, npass;
+	double t;
+
+	for(i=0; i<BenchSize; i++) {
+		benchn[i] = (i%7+1) + (i%5-2)*I;
+		benchd[i] = (i%3+1) - (i%11)/2.0*I;
+	}
+	for(npass=1;; npass*=2) {
+		t = now();
+		for(j=0; j<npass; j++)
+		for(i=0; i<BenchSize; i++)
+			benchq[i] = benchn[i]/benchd[i];
+		t = now() - t;
+		if(t >= 1e9)
+			break;
+	}
+	printf("BenchmarkComplex128DivSlice\t%d\t%.0f ns/op\t%.2f MB/s\n",
+		npass, t/npass, (double)npass*BenchSize*16/t*1e3);
+	return 0;
+}
+
 int
-main(void)
+main(int argc, char **argv)
 {
 	int i, j, k, l;
 	double complex n, d, q;
 	
+	if(argc > 1 && strcmp(argv[1], "bench") == 0)
+		return bench();
+
 	printf("// skip\n");
 	printf("// # generated by cmplxdivide.c\n");
 	printf("\n");